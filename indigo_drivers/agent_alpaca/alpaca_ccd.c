@@ -557,7 +557,7 @@ static indigo_alpaca_error alpaca_get_readoutmode(indigo_alpaca_device *device,
 	return indigo_alpaca_error_OK;
 }
 
-static indigo_alpaca_error alpaca_get_readoutmodes(indigo_alpaca_device *device, int version, char ***value) {
+static indigo_alpaca_error alpaca_get_readoutmodes(indigo_alpaca_device *device, int version, const char ***value) {
 	pthread_mutex_lock(&device->mutex);
 	if (!device->connected) {
 		pthread_mutex_unlock(&device->mutex);
@@ -1172,7 +1172,7 @@ long indigo_alpaca_ccd_get_command(indigo_alpaca_device *alpaca_device, int vers
 		return indigo_alpaca_append_value_int(buffer, buffer_length, value, result);
 	}
 	if (!strcmp(command, "readoutmodes")) {
-		char **value = NULL;
+		const char **value = NULL;
 		indigo_alpaca_error result = alpaca_get_readoutmodes(alpaca_device, version, &value);
 		if (result == indigo_alpaca_error_OK) {
 			long index = snprintf(buffer, buffer_length, "\"Value\": [ ");
@@ -98,7 +98,7 @@ typedef struct indigo_alpaca_device_struct {
 			uint32_t offsetmax;
 			uint32_t offset;
 			char *readoutmodes_names[ALPACA_MAX_ITEMS];
-			char *readoutmodes_labels[ALPACA_MAX_ITEMS];
+			const char *readoutmodes_labels[ALPACA_MAX_ITEMS];
 			int readoutmode;
 		} ccd;
 		struct {
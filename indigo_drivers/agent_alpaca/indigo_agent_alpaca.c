@@ -396,7 +396,7 @@ static indigo_result agent_device_attach(indigo_device *device) {
 			return INDIGO_FAILED;
 		for (int i = 0; i < ALPACA_MAX_ITEMS; i++) {
 			sprintf(AGENT_DEVICES_PROPERTY->items[i].name, "%d", i);
-			sprintf(AGENT_DEVICES_PROPERTY->items[i].label, "Device #%d", i);
+			indigo_set_string_printf(&AGENT_DEVICES_PROPERTY->items[i].label, "Device #%d", i);
 		}
 		AGENT_DEVICES_PROPERTY->count = 0;
 		// --------------------------------------------------------------------------------
@@ -156,7 +156,7 @@ static void load_configuration(indigo_device *device) {
 		pthread_mutex_lock(&DEVICE_PRIVATE_DATA->data_mutex);
 		indigo_property *agent = DEVICE_PRIVATE_DATA->agents[i];
 		if (agent) {
-			indigo_property *copy = indigo_safe_malloc_copy(sizeof(indigo_property) + agent->count * sizeof(indigo_item), agent);
+			indigo_property *copy = indigo_copy_property(NULL, agent);
 			pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->data_mutex);
 			char *device_name = copy->name + 13;
 			for (int j = 0; j < copy->count; j++) {
@@ -176,6 +176,7 @@ static void load_configuration(indigo_device *device) {
 					}
 				}
 			}
+			indigo_release_property(copy);
 		} else {
 			pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->data_mutex);
 		}
@@ -272,7 +273,7 @@ static void process_configuration_property(indigo_device *device) {
 		if (property) {
 			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Restoring '%s'", property->name);
 			if (!strcmp(property->name, AGENT_CONFIG_DRIVERS_PROPERTY_NAME)) {
-				indigo_property *copy = indigo_safe_malloc_copy(sizeof(indigo_property) + property->count * sizeof(indigo_item), property);
+				indigo_property *copy = indigo_copy_property(NULL, property);
 				strcpy(copy->name, SERVER_DRIVERS_PROPERTY_NAME);
 				strcpy(copy->device, DEVICE_PRIVATE_DATA->server);
 				if (!AGENT_CONFIG_SETUP_UNLOAD_DRIVERS_ITEM->sw.value) {
@@ -290,7 +291,7 @@ static void process_configuration_property(indigo_device *device) {
 					}
 				}
 				indigo_change_property(agent_client, copy); // it expects this call is actually synchronous on a local bus
-				indigo_safe_free(copy);
+				indigo_release_property(copy);
 			} else if (!strcmp(property->name, AGENT_CONFIG_PROFILES_PROPERTY_NAME)) {
 				for (int j = 0; j < property->count; j++) {
 					indigo_item *item = property->items + j;
@@ -581,7 +582,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		return INDIGO_OK;
 	} else if (!strncmp(property->name, "AGENT_CONFIG", 12)) {
 		pthread_mutex_lock(&DEVICE_PRIVATE_DATA->data_mutex);
-		DEVICE_PRIVATE_DATA->restore_properties[DEVICE_PRIVATE_DATA->restore_count++] = indigo_safe_malloc_copy(sizeof(indigo_property) + property->count * sizeof(indigo_item), property);
+		DEVICE_PRIVATE_DATA->restore_properties[DEVICE_PRIVATE_DATA->restore_count++] = indigo_copy_property(NULL, property);
 		pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->data_mutex);
 		indigo_set_timer(device, 0, process_configuration_property, NULL);
 	}
@@ -611,7 +612,7 @@ static void update_drivers(indigo_device *device, indigo_property *property) {
 	pthread_mutex_lock(&DEVICE_PRIVATE_DATA->data_mutex);
 	indigo_delete_property(device, AGENT_CONFIG_DRIVERS_PROPERTY, NULL);
 	AGENT_CONFIG_DRIVERS_PROPERTY = indigo_resize_property(AGENT_CONFIG_DRIVERS_PROPERTY, property->count);
-	memcpy(AGENT_CONFIG_DRIVERS_PROPERTY->items, property->items, property->count * sizeof(indigo_item));
+	indigo_copy_items(AGENT_CONFIG_DRIVERS_PROPERTY, property);
 	strcpy(DEVICE_PRIVATE_DATA->server, property->device);
 	indigo_define_property(device, AGENT_CONFIG_DRIVERS_PROPERTY, NULL);
 	AGENT_CONFIG_LAST_CONFIG_PROPERTY->state = INDIGO_IDLE_STATE;
@@ -743,7 +744,7 @@ static indigo_result agent_delete_property(indigo_client *client, indigo_device
 		if (!strcmp(property->name, SERVER_DRIVERS_PROPERTY_NAME)) {
 			pthread_mutex_lock(&DEVICE_PRIVATE_DATA->data_mutex);
 			indigo_delete_property(agent_device, AGENT_CONFIG_DRIVERS_PROPERTY, NULL);
-			AGENT_CONFIG_DRIVERS_PROPERTY->count = 0;
+			AGENT_CONFIG_DRIVERS_PROPERTY = indigo_resize_property(AGENT_CONFIG_DRIVERS_PROPERTY, 0);
 			indigo_define_property(agent_device, AGENT_CONFIG_DRIVERS_PROPERTY, NULL);
 			pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->data_mutex);
 		}
@@ -753,10 +754,7 @@ static indigo_result agent_delete_property(indigo_client *client, indigo_device
 			for (int i = 0; i < AGENT_CONFIG_PROFILES_PROPERTY->count; i++) {
 				indigo_item *item = AGENT_CONFIG_PROFILES_PROPERTY->items + i;
 				if (!strcmp(item->name, property->device)) {
-					int count = AGENT_CONFIG_PROFILES_PROPERTY->count - i - 1;
-					if (count > 0)
-						memmove(AGENT_CONFIG_PROFILES_PROPERTY->items + i, AGENT_CONFIG_PROFILES_PROPERTY->items + i + 1, count * sizeof(indigo_item));
-					AGENT_CONFIG_PROFILES_PROPERTY->count--;
+					indigo_remove_item(AGENT_CONFIG_PROFILES_PROPERTY, i);
 					break;
 				}
 			}
@@ -777,10 +775,7 @@ static indigo_result agent_delete_property(indigo_client *client, indigo_device
 						for (int j = 0; j < agent->count; j++) {
 							indigo_item *item = agent->items + j;
 							if (!strcmp(item->name, property->name)) {
-								int count = agent->count - j - 1;
-								if (count > 0)
-									memmove(agent->items + j, agent->items + j + 1, count * sizeof(indigo_item));
-								agent->count--;
+								indigo_remove_item(agent, j);
 								break;
 							}
 						}
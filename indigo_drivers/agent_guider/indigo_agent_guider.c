@@ -175,6 +175,7 @@
 #define NOT_DITHERING (AGENT_GUIDER_STATS_DITHERING_ITEM->number.value == 0)
 
 #define BUSY_TIMEOUT 5
+#define IMAGE_TIMEOUT 60
 
 #define DIGEST_CONVERGE_ITERATIONS 3
 
@@ -482,6 +483,16 @@ static void do_dither(indigo_device *device) {
 	return;
 }
 
+static bool exposure_started(indigo_device *device, void *data) {
+	indigo_property *property = data;
+	return FILTER_DEVICE_CONTEXT->property_removed || property->state == INDIGO_BUSY_STATE || AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE;
+}
+
+static bool exposure_finished(indigo_device *device, void *data) {
+	indigo_property *property = data;
+	return FILTER_DEVICE_CONTEXT->property_removed || property->state != INDIGO_BUSY_STATE || AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE;
+}
+
 static indigo_property_state capture_raw_frame(indigo_device *device) {
 	char *ccd_name = FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX];
 	indigo_property_state state = INDIGO_ALERT_STATE;
@@ -503,8 +514,8 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
 			return INDIGO_ALERT_STATE;
 		indigo_change_number_property_1(FILTER_DEVICE_CONTEXT->client, ccd_name, CCD_EXPOSURE_PROPERTY_NAME, CCD_EXPOSURE_ITEM_NAME, AGENT_GUIDER_SETTINGS_EXPOSURE_ITEM->number.value);
-		for (int i = 0; i < BUSY_TIMEOUT * 1000 && !FILTER_DEVICE_CONTEXT->property_removed && (state = agent_exposure_property->state) != INDIGO_BUSY_STATE && AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE; i++)
-			indigo_usleep(1000);
+		indigo_filter_wait(device, exposure_started, agent_exposure_property, BUSY_TIMEOUT);
+		state = agent_exposure_property->state;
 		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
 			return INDIGO_ALERT_STATE;
 		if (FILTER_DEVICE_CONTEXT->property_removed || state != INDIGO_BUSY_STATE) {
@@ -512,15 +523,10 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 			indigo_usleep(ONE_SECOND_DELAY);
 			continue;
 		}
-		double reported_exposure_time = agent_exposure_property->items[0].number.value;
 		while (!FILTER_DEVICE_CONTEXT->property_removed && (state = agent_exposure_property->state) == INDIGO_BUSY_STATE) {
 			if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
 				return INDIGO_ALERT_STATE;
-			if (reported_exposure_time > 1) {
-				indigo_usleep(200000);
-			} else {
-				indigo_usleep(10000);
-			}
+			indigo_filter_wait(device, exposure_finished, agent_exposure_property, 1);
 		}
 		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
 			return INDIGO_ALERT_STATE;
@@ -535,6 +541,10 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 		}
 		if (AGENT_GUIDER_STATS_PHASE_ITEM->number.value == INDIGO_GUIDER_PHASE_IGNORE)
 			return agent_exposure_property->state;
+		// with asynchronous image pipeline CCD_EXPOSURE becomes OK before CCD_IMAGE is updated
+		indigo_property *agent_image_property;
+		if (indigo_filter_cached_property(device, INDIGO_FILTER_CCD_INDEX, CCD_IMAGE_PROPERTY_NAME, NULL, &agent_image_property))
+			indigo_filter_wait(device, exposure_finished, agent_image_property, IMAGE_TIMEOUT);
 		indigo_raw_header *header = (indigo_raw_header *)(DEVICE_PRIVATE_DATA->last_image);
 		if (header == NULL || (header->signature != INDIGO_RAW_MONO8 && header->signature != INDIGO_RAW_MONO16 && header->signature != INDIGO_RAW_RGB24 && header->signature != INDIGO_RAW_RGB48)) {
 			indigo_send_message(device, "Error: No RAW image received");
@@ -570,6 +580,9 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 				(indigo_star_detection *)&stars,
 				&star_count
 			);
+			// labels of previously detected stars are released before the items are reused
+			AGENT_GUIDER_STARS_PROPERTY = indigo_resize_property(AGENT_GUIDER_STARS_PROPERTY, 1);
+			AGENT_GUIDER_STARS_PROPERTY = indigo_resize_property(AGENT_GUIDER_STARS_PROPERTY, star_count + 1);
 			for (int i = 0; i < star_count; i++) {
 				DEVICE_PRIVATE_DATA->stars[i] = stars[i];
 				char name[8];
@@ -578,7 +591,6 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 				snprintf(label, sizeof(label), "[%d, %d]", (int)DEVICE_PRIVATE_DATA->stars[i].x, (int)DEVICE_PRIVATE_DATA->stars[i].y);
 				indigo_init_switch_item(AGENT_GUIDER_STARS_PROPERTY->items + i + 1, name, label, false);
 			}
-			AGENT_GUIDER_STARS_PROPERTY->count = star_count + 1;
 			AGENT_GUIDER_STARS_PROPERTY->state = INDIGO_OK_STATE;
 			indigo_define_property(device, AGENT_GUIDER_STARS_PROPERTY, NULL);
 			if (star_count == 0 && (!AGENT_GUIDER_START_PREVIEW_ITEM->sw.value || AGENT_GUIDER_STATS_FRAME_ITEM->number.value == 0)) {
@@ -938,8 +950,7 @@ static void select_subframe(indigo_device *device) {
 				frame_width += GRID;
 			if (frame_height - selection_y < AGENT_GUIDER_SELECTION_RADIUS_ITEM->number.value)
 				frame_height += GRID;
-			int size = sizeof(indigo_property) + device_ccd_frame_property->count * sizeof(indigo_item);
-			DEVICE_PRIVATE_DATA->saved_frame = indigo_safe_malloc_copy(size, agent_ccd_frame_property);
+			DEVICE_PRIVATE_DATA->saved_frame = indigo_copy_property(NULL, agent_ccd_frame_property);
 			strcpy(DEVICE_PRIVATE_DATA->saved_frame->device, device_ccd_frame_property->device);
 			char *names[] = { CCD_FRAME_LEFT_ITEM_NAME, CCD_FRAME_TOP_ITEM_NAME, CCD_FRAME_WIDTH_ITEM_NAME, CCD_FRAME_HEIGHT_ITEM_NAME };
 			double values[] = { frame_left * bin_x, frame_top * bin_y,  frame_width * bin_x, frame_height * bin_y };
@@ -2259,6 +2270,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		}
 		AGENT_ABORT_PROCESS_ITEM->sw.value = false;
 		indigo_update_property(device, AGENT_ABORT_PROCESS_PROPERTY, NULL);
+		indigo_filter_notify(device);
 		return INDIGO_OK;
 	} else if (indigo_property_match(AGENT_GUIDER_DITHERING_STRATEGY_PROPERTY, property)) {
 // -------------------------------------------------------------------------------- AGENT_DITHERING_STRATEGY
@@ -170,6 +170,7 @@
 #define MAX_SEQUENCE_SIZE				128
 
 #define BUSY_TIMEOUT 5
+#define IMAGE_TIMEOUT 60
 #define AF_MOVE_LIMIT_HFD 20
 #define AF_MOVE_LIMIT_RMS 40
 #define AF_MOVE_LIMIT_UCURVE 10
@@ -330,8 +331,15 @@ static void unpark_mount(indigo_device *device) {
 	}
 }
 
-static void solver_precise_goto(indigo_device *device) {
+static char *first_related_solver_agent(indigo_device *device) {
 	char *related_agent_name = indigo_filter_first_related_agent_2(device, "Astrometry Agent", "ASTAP Agent");
+	if (related_agent_name == NULL)
+		related_agent_name = indigo_filter_first_related_agent(device, "Native Solver Agent");
+	return related_agent_name;
+}
+
+static void solver_precise_goto(indigo_device *device) {
+	char *related_agent_name = first_related_solver_agent(device);
 	if (related_agent_name) {
 		char *names[] = { AGENT_PLATESOLVER_GOTO_SETTINGS_RA_ITEM_NAME, AGENT_PLATESOLVER_GOTO_SETTINGS_DEC_ITEM_NAME };
 		double values[] = { DEVICE_PRIVATE_DATA->solver_goto_ra, DEVICE_PRIVATE_DATA->solver_goto_dec };
@@ -342,14 +350,14 @@ static void solver_precise_goto(indigo_device *device) {
 }
 
 static void disable_solver(indigo_device *device) {
-	char *related_agent_name = indigo_filter_first_related_agent_2(device, "Astrometry Agent", "ASTAP Agent");
+	char *related_agent_name = first_related_solver_agent(device);
 	if (related_agent_name) {
 		indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, related_agent_name, AGENT_PLATESOLVER_SOLVE_IMAGES_PROPERTY_NAME, AGENT_PLATESOLVER_SOLVE_IMAGES_DISABLED_ITEM_NAME, true);
 	}
 }
 
 static void abort_solver(indigo_device *device) {
-	char *related_agent_name = indigo_filter_first_related_agent_2(device, "Astrometry Agent", "ASTAP Agent");
+	char *related_agent_name = first_related_solver_agent(device);
 	if (related_agent_name) {
 		indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, related_agent_name, AGENT_ABORT_PROCESS_PROPERTY_NAME, AGENT_ABORT_PROCESS_ITEM_NAME, true);
 	}
@@ -420,8 +428,7 @@ static void select_subframe(indigo_device *device) {
 				frame_width += GRID;
 			if (frame_height - selection_y < AGENT_IMAGER_SELECTION_RADIUS_ITEM->number.value)
 				frame_height += GRID;
-			int size = sizeof(indigo_property) + device_ccd_frame_property->count * sizeof(indigo_item);
-			DEVICE_PRIVATE_DATA->saved_frame = indigo_safe_malloc_copy(size, agent_ccd_frame_property);
+			DEVICE_PRIVATE_DATA->saved_frame = indigo_copy_property(NULL, agent_ccd_frame_property);
 			strcpy(DEVICE_PRIVATE_DATA->saved_frame->device, device_ccd_frame_property->device);
 			char *names[] = { CCD_FRAME_LEFT_ITEM_NAME, CCD_FRAME_TOP_ITEM_NAME, CCD_FRAME_WIDTH_ITEM_NAME, CCD_FRAME_HEIGHT_ITEM_NAME };
 			double values[] = { frame_left * DEVICE_PRIVATE_DATA->bin_x, frame_top * DEVICE_PRIVATE_DATA->bin_y,  frame_width * DEVICE_PRIVATE_DATA->bin_x, frame_height * DEVICE_PRIVATE_DATA->bin_y };
@@ -430,6 +437,52 @@ static void select_subframe(indigo_device *device) {
 	}
 }
 
+typedef struct {
+	indigo_property *property;
+	int index;
+	double value;
+	bool abortable;
+} progress_condition;
+
+static bool pause_released(indigo_device *device, void *data) {
+	return AGENT_PAUSE_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE;
+}
+
+static bool process_started(indigo_device *device, void *data) {
+	indigo_property *property = data;
+	return FILTER_DEVICE_CONTEXT->property_removed || property->state == INDIGO_BUSY_STATE || AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE || AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE;
+}
+
+static bool move_started(indigo_device *device, void *data) {
+	indigo_property *property = data;
+	return FILTER_DEVICE_CONTEXT->property_removed || property->state == INDIGO_BUSY_STATE || AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE;
+}
+
+static bool process_progress(indigo_device *device, void *data) {
+	progress_condition *condition = data;
+	return FILTER_DEVICE_CONTEXT->property_removed || condition->property->state != INDIGO_BUSY_STATE || (condition->abortable && AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) || condition->property->items[condition->index].number.value != condition->value;
+}
+
+static void wait_for_pause_released(indigo_device *device) {
+	while (!indigo_filter_wait(device, pause_released, NULL, 1))
+		;
+}
+
+static bool image_processed(indigo_device *device, void *data) {
+	indigo_property *property = data;
+	return FILTER_DEVICE_CONTEXT->property_removed || property->state != INDIGO_BUSY_STATE || AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE;
+}
+
+static void wait_for_image(indigo_device *device) {
+	// with asynchronous image pipeline CCD_EXPOSURE becomes OK before CCD_IMAGE and CCD_IMAGE_FILE are updated
+	static char *names[] = { CCD_IMAGE_PROPERTY_NAME, CCD_IMAGE_FILE_PROPERTY_NAME };
+	for (int i = 0; i < 2; i++) {
+		indigo_property *agent_property;
+		if (indigo_filter_cached_property(device, INDIGO_FILTER_CCD_INDEX, names[i], NULL, &agent_property) && !indigo_filter_wait(device, image_processed, agent_property, IMAGE_TIMEOUT))
+			INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s didn't become OK in %d second(s)", names[i], IMAGE_TIMEOUT);
+	}
+}
+
 static void restore_subframe(indigo_device *device) {
 	if (DEVICE_PRIVATE_DATA->saved_frame) {
 		indigo_change_property(FILTER_DEVICE_CONTEXT->client, DEVICE_PRIVATE_DATA->saved_frame);
@@ -476,8 +529,7 @@ static indigo_property_state _capture_raw_frame(indigo_device *device, uint8_t *
 	for (int exposure_attempt = 0; exposure_attempt < 3; exposure_attempt++) {
 		if (FILTER_DEVICE_CONTEXT->property_removed)
 			return INDIGO_ALERT_STATE;
-		while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-			indigo_usleep(200000);
+		wait_for_pause_released(device);
 		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
 			return INDIGO_ALERT_STATE;
 		if (DEVICE_PRIVATE_DATA->use_aux_1) {
@@ -486,11 +538,10 @@ static indigo_property_state _capture_raw_frame(indigo_device *device, uint8_t *
 		} else {
 			indigo_change_number_property_1(FILTER_DEVICE_CONTEXT->client, device_exposure_property->device, CCD_EXPOSURE_PROPERTY_NAME, CCD_EXPOSURE_ITEM_NAME, AGENT_IMAGER_BATCH_EXPOSURE_ITEM->number.target);
 		}
-		for (int i = 0; i < BUSY_TIMEOUT * 1000 && !FILTER_DEVICE_CONTEXT->property_removed && (state = agent_exposure_property->state) != INDIGO_BUSY_STATE && AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE && AGENT_PAUSE_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE; i++)
-			indigo_usleep(1000);
+		indigo_filter_wait(device, process_started, agent_exposure_property, BUSY_TIMEOUT);
+		state = agent_exposure_property->state;
 		if (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-			while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-				indigo_usleep(200000);
+			wait_for_pause_released(device);
 			if (AGENT_PAUSE_PROCESS_ITEM->sw.value) {
 				exposure_attempt--;
 				continue;
@@ -513,15 +564,10 @@ static indigo_property_state _capture_raw_frame(indigo_device *device, uint8_t *
 				AGENT_IMAGER_STATS_EXPOSURE_ITEM->number.value = reported_exposure_time = agent_exposure_property->items[0].number.value;
 				indigo_update_property(device, AGENT_IMAGER_STATS_PROPERTY, NULL);
 			}
-			if (reported_exposure_time > 1) {
-				indigo_usleep(200000);
-			} else {
-				indigo_usleep(10000);
-			}
+			indigo_filter_wait(device, process_progress, &(progress_condition){ agent_exposure_property, 0, reported_exposure_time, true }, 1);
 		}
 		if (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-			while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-				indigo_usleep(200000);
+			wait_for_pause_released(device);
 			if (AGENT_PAUSE_PROCESS_ITEM->sw.value) {
 				exposure_attempt--;
 				continue;
@@ -540,6 +586,7 @@ static indigo_property_state _capture_raw_frame(indigo_device *device, uint8_t *
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "Exposure failed");
 		return INDIGO_ALERT_STATE;
 	}
+	wait_for_image(device);
 
 	indigo_raw_header *header = (indigo_raw_header *)(DEVICE_PRIVATE_DATA->last_image);
 	if (header == NULL || (header->signature != INDIGO_RAW_MONO8 && header->signature != INDIGO_RAW_MONO16 && header->signature != INDIGO_RAW_RGB24 && header->signature != INDIGO_RAW_RGB48)) {
@@ -592,7 +639,9 @@ static indigo_property_state _capture_raw_frame(indigo_device *device, uint8_t *
 					(indigo_star_detection *)&DEVICE_PRIVATE_DATA->stars,
 					&star_count
 				);
-				AGENT_IMAGER_STARS_PROPERTY->count = star_count + 1;
+				// labels of previously detected stars are released before the items are reused
+				AGENT_IMAGER_STARS_PROPERTY = indigo_resize_property(AGENT_IMAGER_STARS_PROPERTY, 1);
+				AGENT_IMAGER_STARS_PROPERTY = indigo_resize_property(AGENT_IMAGER_STARS_PROPERTY, star_count + 1);
 				for (int i = 0; i < star_count; i++) {
 					char name[8];
 					char label[INDIGO_NAME_SIZE];
@@ -847,8 +896,7 @@ static bool exposure_batch(indigo_device *device) {
 					allow_abort_by_mount_agent(device, false);
 				}
 			}
-			while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-				indigo_usleep(200000);
+			wait_for_pause_released(device);
 			if (pausedOnTTT) {
 				allow_abort_by_mount_agent(device, true);
 			}
@@ -860,11 +908,10 @@ static bool exposure_batch(indigo_device *device) {
 			} else {
 				indigo_change_number_property_1(FILTER_DEVICE_CONTEXT->client, device_exposure_property->device, CCD_EXPOSURE_PROPERTY_NAME, CCD_EXPOSURE_ITEM_NAME, exposure_time);
 			}
-			for (int i = 0; i < BUSY_TIMEOUT * 1000 && !FILTER_DEVICE_CONTEXT->property_removed && (state = agent_exposure_property->state) != INDIGO_BUSY_STATE && AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE && AGENT_PAUSE_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE; i++)
-				indigo_usleep(1000);
+			indigo_filter_wait(device, process_started, agent_exposure_property, BUSY_TIMEOUT);
+			state = agent_exposure_property->state;
 			if (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-				while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-					indigo_usleep(200000);
+				wait_for_pause_released(device);
 				if (AGENT_PAUSE_PROCESS_ITEM->sw.value) {
 					exposure_attempt--;
 					continue;
@@ -881,19 +928,16 @@ static bool exposure_batch(indigo_device *device) {
 			AGENT_IMAGER_STATS_EXPOSURE_ITEM->number.value = reported_exposure_time;
 			indigo_update_property(device, AGENT_IMAGER_STATS_PROPERTY, NULL);
 			while (!FILTER_DEVICE_CONTEXT->property_removed && (state = agent_exposure_property->state) == INDIGO_BUSY_STATE) {
+				if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
+					return false;
 				if (reported_exposure_time != agent_exposure_property->items[0].number.value) {
 					AGENT_IMAGER_STATS_EXPOSURE_ITEM->number.value = reported_exposure_time = agent_exposure_property->items[0].number.value;
 					indigo_update_property(device, AGENT_IMAGER_STATS_PROPERTY, NULL);
 				}
-				if (reported_exposure_time > 1) {
-					indigo_usleep(200000);
-				} else {
-					indigo_usleep(10000);
-				}
+				indigo_filter_wait(device, process_progress, &(progress_condition){ agent_exposure_property, 0, reported_exposure_time, true }, 1);
 			}
 			if (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-				while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-					indigo_usleep(200000);
+				wait_for_pause_released(device);
 				if (AGENT_PAUSE_PROCESS_ITEM->sw.value) {
 					exposure_attempt--;
 					continue;
@@ -912,6 +956,7 @@ static bool exposure_batch(indigo_device *device) {
 			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Exposure failed");
 			return false;
 		}
+		wait_for_image(device);
 		check_breakpoint(device, AGENT_IMAGER_BREAKPOINT_POST_CAPTURE_ITEM);
 		bool is_controlled_instance = false;
 		if (!AGENT_IMAGER_RESUME_CONDITION_BARRIER_ITEM->sw.value) {
@@ -944,8 +989,7 @@ static bool exposure_batch(indigo_device *device) {
 				AGENT_IMAGER_STATS_PHASE_ITEM->number.value = INDIGO_IMAGER_PHASE_WAITING;
 				indigo_update_property(device, AGENT_IMAGER_STATS_PROPERTY, NULL);
 				while (reported_delay_time > 0) {
-					while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-						indigo_usleep(200000);
+					wait_for_pause_released(device);
 					if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
 						return false;
 					if (reported_delay_time < floor(AGENT_IMAGER_STATS_DELAY_ITEM->number.value)) {
@@ -1047,8 +1091,8 @@ static bool streaming_batch(indigo_device *device) {
 	double values[] = { AGENT_IMAGER_BATCH_COUNT_ITEM->number.target, AGENT_IMAGER_BATCH_EXPOSURE_ITEM->number.target };
 	indigo_change_number_property(FILTER_DEVICE_CONTEXT->client, ccd_name, CCD_STREAMING_PROPERTY_NAME, 2, names, values);
 	FILTER_DEVICE_CONTEXT->property_removed = false;
-	for (int i = 0; i < BUSY_TIMEOUT * 1000 && !FILTER_DEVICE_CONTEXT->property_removed && (state = agent_streaming_property->state) != INDIGO_BUSY_STATE && AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE && AGENT_PAUSE_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE; i++)
-		indigo_usleep(1000);
+	indigo_filter_wait(device, process_started, agent_streaming_property, BUSY_TIMEOUT);
+	state = agent_streaming_property->state;
 	if (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE || AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
 		return false;
 	if (state != INDIGO_BUSY_STATE) {
@@ -1056,7 +1100,7 @@ static bool streaming_batch(indigo_device *device) {
 		return false;
 	}
 	while (!FILTER_DEVICE_CONTEXT->property_removed && (state = agent_streaming_property->state) == INDIGO_BUSY_STATE) {
-		indigo_usleep(20000);
+		indigo_filter_wait(device, process_progress, &(progress_condition){ agent_streaming_property, count_index, AGENT_IMAGER_STATS_FRAME_ITEM->number.value }, 1);
 		int count = agent_streaming_property->items[count_index].number.value;
 		if (count != AGENT_IMAGER_STATS_FRAME_ITEM->number.value) {
 			AGENT_IMAGER_STATS_FRAME_ITEM->number.value = count;
@@ -1120,8 +1164,8 @@ static bool move_focuser(indigo_device *device, char *focuser_name, bool moving_
 	}
 	indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, focuser_name, FOCUSER_DIRECTION_PROPERTY_NAME, moving_out ? FOCUSER_DIRECTION_MOVE_OUTWARD_ITEM_NAME : FOCUSER_DIRECTION_MOVE_INWARD_ITEM_NAME, true);
 	indigo_change_number_property_1(FILTER_DEVICE_CONTEXT->client, focuser_name, FOCUSER_STEPS_PROPERTY_NAME, FOCUSER_STEPS_ITEM_NAME, steps);
-	for (int i = 0; i < BUSY_TIMEOUT * 1000 && !FILTER_DEVICE_CONTEXT->property_removed && (state = agent_steps_property->state) != INDIGO_BUSY_STATE && AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE; i++)
-		indigo_usleep(1000);
+	indigo_filter_wait(device, move_started, agent_steps_property, BUSY_TIMEOUT);
+	state = agent_steps_property->state;
 	if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
 		SET_BACKLASH_IF_OVERSHOOT(DEVICE_PRIVATE_DATA->saved_backlash);
 		return false;
@@ -1132,7 +1176,7 @@ static bool move_focuser(indigo_device *device, char *focuser_name, bool moving_
 		return false;
 	}
 	while (!FILTER_DEVICE_CONTEXT->property_removed && (state = agent_steps_property->state) == INDIGO_BUSY_STATE) {
-		indigo_usleep(200000);
+		indigo_filter_wait(device, process_progress, &(progress_condition){ agent_steps_property, 0, agent_steps_property->items[0].number.value }, 1);
 	}
 	if (state != INDIGO_OK_STATE) {
 		if (AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE)
@@ -1186,8 +1230,7 @@ static bool autofocus_overshoot(indigo_device *device, uint8_t **saturation_mask
 	double  min_est = 1e10, max_est = 0;
 	while (repeat) {
 		if (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-			while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-				indigo_usleep(200000);
+			wait_for_pause_released(device);
 			continue;
 		}
 		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
@@ -1444,8 +1487,7 @@ static bool autofocus_ucurve(indigo_device *device) {
 	double focus_pos[MAX_UCURVE_SAMPLES] = {0};
 	while (repeat) {
 		if (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-			while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-				indigo_usleep(200000);
+			wait_for_pause_released(device);
 			continue;
 		}
 		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
@@ -1816,8 +1858,7 @@ static bool autofocus_backlash(indigo_device *device, uint8_t **saturation_mask)
 	bool repeat = true;
 	while (repeat) {
 		if (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-			while (AGENT_PAUSE_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-				indigo_usleep(200000);
+			wait_for_pause_released(device);
 			continue;
 		}
 		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
@@ -2389,7 +2430,7 @@ static void sequence_process(indigo_device *device) {
 		indigo_safe_free(sequence_text);
 		return;
 	}
-	if (solver_needed && indigo_filter_first_related_agent_2(device, "Astrometry Agent", "ASTAP Agent") == NULL) {
+	if (solver_needed && first_related_solver_agent(device) == NULL) {
 		AGENT_IMAGER_START_PREVIEW_ITEM->sw.value =
 		AGENT_IMAGER_START_EXPOSURE_ITEM->sw.value =
 		AGENT_IMAGER_START_STREAMING_ITEM->sw.value =
@@ -2641,8 +2682,8 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		FILTER_FOCUSER_LIST_PROPERTY->hidden = false;
 		FILTER_RELATED_AGENT_LIST_PROPERTY->hidden = false;
 		FILTER_AUX_1_LIST_PROPERTY->hidden = false;
-		strcpy(FILTER_AUX_1_LIST_PROPERTY->label, "External shutter list");
-		strcpy(FILTER_AUX_1_LIST_PROPERTY->items->label, "No external shutter");
+		indigo_set_label(FILTER_AUX_1_LIST_PROPERTY, "External shutter list");
+		indigo_set_label(FILTER_AUX_1_LIST_PROPERTY->items, "No external shutter");
 		FILTER_DEVICE_CONTEXT->validate_device = validate_device;
 		// -------------------------------------------------------------------------------- Batch properties
 		AGENT_IMAGER_BATCH_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_IMAGER_BATCH_PROPERTY_NAME, "Agent", "Batch settings", INDIGO_OK_STATE, INDIGO_RW_PERM, 5);
@@ -2653,7 +2694,7 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		indigo_init_number_item(AGENT_IMAGER_BATCH_DELAY_ITEM, AGENT_IMAGER_BATCH_DELAY_ITEM_NAME, "Delay after each exposure (s)", 0, 0xFFFF, 1, 0);
 		indigo_init_number_item(AGENT_IMAGER_BATCH_FRAMES_TO_SKIP_BEFORE_DITHER_ITEM, AGENT_IMAGER_BATCH_FRAMES_TO_SKIP_BEFORE_DITHER_ITEM_NAME, "Frames to skip before dither", -1, 1000, 1, 0);
 		indigo_init_number_item(AGENT_IMAGER_BATCH_PAUSE_AFTER_TRANSIT_ITEM, AGENT_IMAGER_BATCH_PAUSE_AFTER_TRANSIT_ITEM_NAME, "Pause after transit (h)", -2, 2, 1, 0);
-		strcpy(AGENT_IMAGER_BATCH_PAUSE_AFTER_TRANSIT_ITEM->number.format, "%12.3m");
+		indigo_set_number_format(AGENT_IMAGER_BATCH_PAUSE_AFTER_TRANSIT_ITEM, "%12.3m");
 		// -------------------------------------------------------------------------------- Focus properties
 		AGENT_IMAGER_FOCUS_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_IMAGER_FOCUS_PROPERTY_NAME, "Agent", "Autofocus settings", INDIGO_OK_STATE, INDIGO_RW_PERM, 10);
 		if (AGENT_IMAGER_FOCUS_PROPERTY == NULL)
@@ -3062,6 +3103,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 			AGENT_PAUSE_PROCESS_PROPERTY->state = INDIGO_ALERT_STATE;
 		}
 		indigo_update_property(device, AGENT_PAUSE_PROCESS_PROPERTY, NULL);
+		indigo_filter_notify(device);
 		return INDIGO_OK;
 	} else if (indigo_property_match(AGENT_ABORT_PROCESS_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- AGENT_ABORT_PROCESS
@@ -3077,6 +3119,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		}
 		AGENT_ABORT_PROCESS_ITEM->sw.value = false;
 		indigo_update_property(device, AGENT_ABORT_PROCESS_PROPERTY, NULL);
+		indigo_filter_notify(device);
 		return INDIGO_OK;
 	} else if (indigo_property_match(AGENT_PROCESS_FEATURES_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- AGENT_PROCESS_FEATURES
@@ -3239,8 +3282,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		if (AGENT_IMAGER_RESUME_CONDITION_BARRIER_ITEM->sw.value) {
 			// On related imager agents duplicate AGENT_IMAGER_BREAKPOINT_PROPERTY
 			indigo_property *related_agents_property = FILTER_DEVICE_CONTEXT->filter_related_agent_list_property;
-			indigo_property *clone = indigo_init_switch_property(NULL, AGENT_IMAGER_BREAKPOINT_PROPERTY->device, AGENT_IMAGER_BREAKPOINT_PROPERTY->name, NULL, NULL, 0, 0, 0, AGENT_IMAGER_BREAKPOINT_PROPERTY->count);
-			memcpy(clone, AGENT_IMAGER_BREAKPOINT_PROPERTY, sizeof(indigo_property) + AGENT_IMAGER_BREAKPOINT_PROPERTY->count * sizeof(indigo_item));
+			indigo_property *clone = indigo_copy_property(NULL, AGENT_IMAGER_BREAKPOINT_PROPERTY);
 			for (int i = 0; i < related_agents_property->count; i++) {
 				indigo_item *item = related_agents_property->items + i;
 				if (item->sw.value && !strncmp(item->name, "Imager Agent", 12)) {
@@ -3425,7 +3467,7 @@ static void snoop_wheel_changes(indigo_client *client, indigo_property *property
 			indigo_property *agent_wheel_filter_property = CLIENT_PRIVATE_DATA->agent_wheel_filter_property;
 			agent_wheel_filter_property->count = property->count;
 			for (int i = 0; i < property->count; i++)
-				strcpy(agent_wheel_filter_property->items[i].label, property->items[i].text.value);
+				indigo_set_string(&agent_wheel_filter_property->items[i].label, property->items[i].text.value);
 			indigo_delete_property(FILTER_CLIENT_CONTEXT->device, agent_wheel_filter_property, NULL);
 			agent_wheel_filter_property->hidden = false;
 			indigo_define_property(FILTER_CLIENT_CONTEXT->device, agent_wheel_filter_property, NULL);
@@ -3454,6 +3496,11 @@ static void snoop_solver_process_state(indigo_client *client, indigo_property *p
 			CLIENT_PRIVATE_DATA->related_solver_process_state = property->state;
 			return;
 		}
+		related_agent_name = indigo_filter_first_related_agent(FILTER_CLIENT_CONTEXT->device, "Native Solver Agent");
+		if (related_agent_name && !strcmp(property->device, related_agent_name)) {
+			CLIENT_PRIVATE_DATA->related_solver_process_state = property->state;
+			return;
+		}
 	}
 }
 
@@ -3516,8 +3563,7 @@ static indigo_result agent_update_property(indigo_client *client, indigo_device
 	if (device == FILTER_CLIENT_CONTEXT->device) {
 		if (property->state == INDIGO_OK_STATE && !strcmp(property->name, FILTER_RELATED_AGENT_LIST_PROPERTY_NAME)) {
 			AGENT_IMAGER_BARRIER_STATE_PROPERTY->count = 0;
-			indigo_property *clone = indigo_init_switch_property(NULL, AGENT_IMAGER_BREAKPOINT_PROPERTY->device, AGENT_IMAGER_BREAKPOINT_PROPERTY->name, NULL, NULL, 0, 0, 0, AGENT_IMAGER_BREAKPOINT_PROPERTY->count);
-			memcpy(clone, AGENT_IMAGER_BREAKPOINT_PROPERTY, sizeof(indigo_property) + AGENT_IMAGER_BREAKPOINT_PROPERTY->count * sizeof(indigo_item));
+			indigo_property *clone = indigo_copy_property(NULL, AGENT_IMAGER_BREAKPOINT_PROPERTY);
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = property->items + i;
 				if (item->sw.value && !strncmp(item->name, "Imager Agent", 12)) {
@@ -3592,7 +3638,7 @@ static indigo_result agent_update_property(indigo_client *client, indigo_device
 			indigo_property *agent_wheel_filter_property = CLIENT_PRIVATE_DATA->agent_wheel_filter_property;
 			agent_wheel_filter_property->count = property->count;
 			for (int i = 0; i < property->count; i++)
-				strcpy(agent_wheel_filter_property->items[i].label, property->items[i].text.value);
+				indigo_set_string(&agent_wheel_filter_property->items[i].label, property->items[i].text.value);
 			agent_wheel_filter_property->hidden = false;
 			indigo_delete_property(FILTER_CLIENT_CONTEXT->device, agent_wheel_filter_property, NULL);
 			indigo_define_property(FILTER_CLIENT_CONTEXT->device, agent_wheel_filter_property, NULL);
@@ -714,6 +714,14 @@ static void abort_process(indigo_device *device) {
 	indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_MOUNT_INDEX], MOUNT_ABORT_MOTION_PROPERTY_NAME, MOUNT_ABORT_MOTION_ITEM_NAME, true);
 }
 
+static bool slew_started(indigo_device *device, void *data) {
+	return DEVICE_PRIVATE_DATA->mount_eq_coordinates_state == INDIGO_BUSY_STATE || AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE;
+}
+
+static bool slew_finished(indigo_device *device, void *data) {
+	return DEVICE_PRIVATE_DATA->mount_eq_coordinates_state != INDIGO_BUSY_STATE || AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE;
+}
+
 static void mount_control(indigo_device *device, char *operation) {
 	FILTER_DEVICE_CONTEXT->running_process = true;
 	char *device_name = FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_MOUNT_INDEX];
@@ -724,27 +732,11 @@ static void mount_control(indigo_device *device, char *operation) {
 	const char *names[] = { MOUNT_EQUATORIAL_COORDINATES_RA_ITEM_NAME, MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM_NAME };
 	double values[] = { AGENT_MOUNT_TARGET_COORDINATES_RA_ITEM->number.target, AGENT_MOUNT_TARGET_COORDINATES_DEC_ITEM->number.target };
 	indigo_change_number_property(FILTER_DEVICE_CONTEXT->client, device_name, MOUNT_EQUATORIAL_COORDINATES_PROPERTY_NAME, 2, names, values);
-	for (int i = 0; i < 3000; i++) {
-		if (DEVICE_PRIVATE_DATA->mount_eq_coordinates_state == INDIGO_BUSY_STATE) {
-			break;
-		}
-		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-			break;
-		}
-		indigo_usleep(1000);
-	}
+	indigo_filter_wait(device, slew_started, NULL, 3);
 	if (AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE && DEVICE_PRIVATE_DATA->mount_eq_coordinates_state != INDIGO_BUSY_STATE) {
 		indigo_debug("MOUNT_EQUATORIAL_COORDINATES didn't become BUSY in 3s");
 	}
-	for (int i = 0; i < 60000; i++) {
-		if (DEVICE_PRIVATE_DATA->mount_eq_coordinates_state != INDIGO_BUSY_STATE) {
-			break;
-		}
-		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
-			break;
-		}
-		indigo_usleep(1000);
-	}
+	indigo_filter_wait(device, slew_finished, NULL, 60);
 	if (AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE && DEVICE_PRIVATE_DATA->mount_eq_coordinates_state != INDIGO_OK_STATE) {
 		indigo_error("MOUNT_EQUATORIAL_COORDINATES didn't become OK in 60s");
 	}
@@ -891,6 +883,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		}
 		AGENT_ABORT_PROCESS_ITEM->sw.value = false;
 		indigo_update_property(device, AGENT_ABORT_PROCESS_PROPERTY, NULL);
+		indigo_filter_notify(device);
 		return INDIGO_OK;
 	} else if (indigo_property_match(AGENT_PROCESS_FEATURES_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- AGENT_PROCESS_FEATURES
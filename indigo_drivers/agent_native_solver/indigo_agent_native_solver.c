@@ -0,0 +1,901 @@
+// Copyright (c) 2024 CloudMakers, s. r. o.
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 initial in-process solver using bundled Hipparcos catalog
+
+/** INDIGO native plate solver agent
+ \file indigo_agent_native_solver.c
+ */
+
+#define DRIVER_VERSION 0x0001
+#define DRIVER_NAME	"indigo_agent_native_solver"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include <indigo/indigo_driver_xml.h>
+#include <indigo/indigo_ccd_driver.h>
+#include <indigo/indigo_filter.h>
+#include <indigo/indigo_align.h>
+#include <indigo/indigo_raw_utils.h>
+#include <indigo/indigo_fits.h>
+#include <indigo/indigo_platesolver.h>
+#include <indigo/indigocat/indigocat_star.h>
+
+#include "indigo_agent_native_solver.h"
+
+#define NATIVE_DEVICE_PRIVATE_DATA				((native_private_data *)device->private_data)
+
+#define MAX_IMAGE_STARS				100
+#define MATCH_STARS						20
+#define MIN_MATCHED_STARS			5
+#define BLIND_MATCHED_STARS		8
+#define STAR_RADIUS						8
+#define TRIANGLE_TOLERANCE		0.006
+#define SCALE_TOLERANCE				1.15
+#define MIN_TRIANGLE_SIDE			20
+#define ZONE_COUNT						180
+
+typedef struct {
+	platesolver_private_data platesolver;
+	bool abort_requested;
+} native_private_data;
+
+// -------------------------------------------------------------------------------- catalog index
+
+typedef struct {
+	double v[3];
+	float mag;
+} catalog_star;
+
+static catalog_star *catalog = NULL;
+static int catalog_zone[ZONE_COUNT + 1];
+static pthread_mutex_t catalog_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int catalog_zone_of(double dec) {
+	int zone = (int)floor(dec + 90);
+	return zone < 0 ? 0 : zone >= ZONE_COUNT ? ZONE_COUNT - 1 : zone;
+}
+
+static void unit_vector(double ra, double dec, double *v) {
+	double cos_dec = cos(dec);
+	v[0] = cos_dec * cos(ra);
+	v[1] = cos_dec * sin(ra);
+	v[2] = sin(dec);
+}
+
+static int catalog_mag_comparator(const void *a, const void *b) {
+	float mag_a = ((catalog_star *)a)->mag;
+	float mag_b = ((catalog_star *)b)->mag;
+	return mag_a < mag_b ? -1 : mag_a > mag_b ? 1 : 0;
+}
+
+// stars are bucketed into 1° declination zones, each zone sorted by magnitude
+
+void indigo_native_solver_build_index() {
+	pthread_mutex_lock(&catalog_mutex);
+	if (catalog == NULL) {
+		int count[ZONE_COUNT] = { 0 };
+		int size = 0;
+		for (indigocat_star_entry *entry = indigocat_get_star_data(); entry->hip; entry++) {
+			count[catalog_zone_of(entry->dec)]++;
+			size++;
+		}
+		catalog_zone[0] = 0;
+		for (int i = 0; i < ZONE_COUNT; i++) {
+			catalog_zone[i + 1] = catalog_zone[i] + count[i];
+			count[i] = catalog_zone[i];
+		}
+		catalog_star *stars = indigo_safe_malloc(size * sizeof(catalog_star));
+		for (indigocat_star_entry *entry = indigocat_get_star_data(); entry->hip; entry++) {
+			catalog_star *star = stars + count[catalog_zone_of(entry->dec)]++;
+			unit_vector(entry->ra * M_PI / 12, entry->dec * M_PI / 180, star->v);
+			star->mag = entry->mag;
+		}
+		for (int i = 0; i < ZONE_COUNT; i++)
+			qsort(stars + catalog_zone[i], catalog_zone[i + 1] - catalog_zone[i], sizeof(catalog_star), catalog_mag_comparator);
+		catalog = stars;
+		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Catalog index with %d stars created", size);
+	}
+	pthread_mutex_unlock(&catalog_mutex);
+}
+
+void indigo_native_solver_release_index() {
+	pthread_mutex_lock(&catalog_mutex);
+	indigo_safe_free(catalog);
+	catalog = NULL;
+	pthread_mutex_unlock(&catalog_mutex);
+}
+
+static int catalog_cone(const double *center, double radius, catalog_star **result, int max) {
+	double dec = asin(center[2]) * 180 / M_PI;
+	double cos_radius = cos(radius * M_PI / 180);
+	int first = catalog_zone_of(dec - radius), last = catalog_zone_of(dec + radius);
+	int count = 0;
+	for (int zone = first; zone <= last; zone++) {
+		for (catalog_star *star = catalog + catalog_zone[zone], *end = catalog + catalog_zone[zone + 1]; star < end; star++) {
+			if (star->v[0] * center[0] + star->v[1] * center[1] + star->v[2] * center[2] >= cos_radius) {
+				result[count++] = star;
+				if (count == max)
+					return count;
+			}
+		}
+	}
+	return count;
+}
+
+static int catalog_ptr_mag_comparator(const void *a, const void *b) {
+	return catalog_mag_comparator(*(catalog_star **)a, *(catalog_star **)b);
+}
+
+// -------------------------------------------------------------------------------- gnomonic projection
+
+typedef struct {
+	double center[3];
+	double east[3];
+	double north[3];
+} tangent_plane;
+
+static void tangent_plane_init(tangent_plane *plane, double ra, double dec) {
+	unit_vector(ra, dec, plane->center);
+	plane->east[0] = -sin(ra);
+	plane->east[1] = cos(ra);
+	plane->east[2] = 0;
+	plane->north[0] = -sin(dec) * cos(ra);
+	plane->north[1] = -sin(dec) * sin(ra);
+	plane->north[2] = cos(dec);
+}
+
+static bool tangent_plane_project(tangent_plane *plane, const double *v, double *xi, double *eta) {
+	double d = v[0] * plane->center[0] + v[1] * plane->center[1] + v[2] * plane->center[2];
+	if (d <= 0)
+		return false;
+	*xi = (v[0] * plane->east[0] + v[1] * plane->east[1]) / d;
+	*eta = (v[0] * plane->north[0] + v[1] * plane->north[1] + v[2] * plane->north[2]) / d;
+	return true;
+}
+
+static void tangent_plane_unproject(tangent_plane *plane, double xi, double eta, double *ra, double *dec) {
+	double v[3];
+	for (int i = 0; i < 3; i++)
+		v[i] = plane->center[i] + xi * plane->east[i] + eta * plane->north[i];
+	*ra = atan2(v[1], v[0]);
+	if (*ra < 0)
+		*ra += 2 * M_PI;
+	*dec = atan2(v[2], sqrt(v[0] * v[0] + v[1] * v[1]));
+}
+
+// -------------------------------------------------------------------------------- triangle hashing
+
+typedef struct {
+	float r1, r2;
+	float a;
+	unsigned char v[3];
+	signed char orientation;
+} triangle;
+
+static int triangle_comparator(const void *a, const void *b) {
+	float r1_a = ((triangle *)a)->r1;
+	float r1_b = ((triangle *)b)->r1;
+	return r1_a < r1_b ? -1 : r1_a > r1_b ? 1 : 0;
+}
+
+// triangles are described by ratios of the shorter sides to the longest one, vertices are ordered by the opposite side length
+
+static int build_triangles(const double *x, const double *y, int count, double min_side, triangle *triangles) {
+	int size = 0;
+	for (int i = 0; i < count; i++) {
+		for (int j = i + 1; j < count; j++) {
+			for (int k = j + 1; k < count; k++) {
+				int vertex[3] = { i, j, k };
+				double side[3] = { hypot(x[j] - x[k], y[j] - y[k]), hypot(x[i] - x[k], y[i] - y[k]), hypot(x[i] - x[j], y[i] - y[j]) };
+				for (int m = 0; m < 2; m++) {
+					for (int n = 0; n < 2 - m; n++) {
+						if (side[n] < side[n + 1]) {
+							double s = side[n]; side[n] = side[n + 1]; side[n + 1] = s;
+							int v = vertex[n]; vertex[n] = vertex[n + 1]; vertex[n + 1] = v;
+						}
+					}
+				}
+				if (side[0] < min_side || side[2] < 0.1 * side[0])
+					continue;
+				triangle *t = triangles + size++;
+				t->a = side[0];
+				t->r1 = side[1] / side[0];
+				t->r2 = side[2] / side[0];
+				t->v[0] = vertex[0];
+				t->v[1] = vertex[1];
+				t->v[2] = vertex[2];
+				double cross = (x[vertex[1]] - x[vertex[0]]) * (y[vertex[2]] - y[vertex[0]]) - (y[vertex[1]] - y[vertex[0]]) * (x[vertex[2]] - x[vertex[0]]);
+				t->orientation = cross >= 0 ? 1 : -1;
+			}
+		}
+	}
+	qsort(triangles, size, sizeof(triangle), triangle_comparator);
+	return size;
+}
+
+// -------------------------------------------------------------------------------- transformation fitting
+
+typedef struct {
+	double x, y;
+	double xi, eta;
+	catalog_star *star;
+} star_pair;
+
+typedef struct {
+	bool mirrored;
+	double a, b;
+	double tx, ty;
+} similarity;
+
+static void similarity_apply(similarity *s, double x, double y, double *xi, double *eta) {
+	if (s->mirrored)
+		y = -y;
+	*xi = s->a * x - s->b * y + s->tx;
+	*eta = s->b * x + s->a * y + s->ty;
+}
+
+static bool similarity_fit(star_pair *pairs, int count, bool mirrored, similarity *s) {
+	double mx = 0, my = 0, mxi = 0, meta = 0;
+	double sign = mirrored ? -1 : 1;
+	for (int i = 0; i < count; i++) {
+		mx += pairs[i].x;
+		my += sign * pairs[i].y;
+		mxi += pairs[i].xi;
+		meta += pairs[i].eta;
+	}
+	mx /= count; my /= count; mxi /= count; meta /= count;
+	double sa = 0, sb = 0, norm = 0;
+	for (int i = 0; i < count; i++) {
+		double x = pairs[i].x - mx, y = sign * pairs[i].y - my;
+		double xi = pairs[i].xi - mxi, eta = pairs[i].eta - meta;
+		sa += xi * x + eta * y;
+		sb += eta * x - xi * y;
+		norm += x * x + y * y;
+	}
+	if (norm == 0)
+		return false;
+	s->mirrored = mirrored;
+	s->a = sa / norm;
+	s->b = sb / norm;
+	s->tx = mxi - (s->a * mx - s->b * my);
+	s->ty = meta - (s->b * mx + s->a * my);
+	return true;
+}
+
+// xi = cd[0][0] * x + cd[0][1] * y + cd[0][2], eta = cd[1][0] * x + cd[1][1] * y + cd[1][2]
+
+static bool affine_fit(star_pair *pairs, int count, double cd[2][3]) {
+	double m[3][3] = { { 0 } }, r[2][3] = { { 0 } };
+	for (int i = 0; i < count; i++) {
+		double p[3] = { pairs[i].x, pairs[i].y, 1 };
+		for (int j = 0; j < 3; j++) {
+			for (int k = 0; k < 3; k++)
+				m[j][k] += p[j] * p[k];
+			r[0][j] += p[j] * pairs[i].xi;
+			r[1][j] += p[j] * pairs[i].eta;
+		}
+	}
+	double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+	if (fabs(det) < 1e-12)
+		return false;
+	double inv[3][3] = {
+		{ (m[1][1] * m[2][2] - m[1][2] * m[2][1]) / det, (m[0][2] * m[2][1] - m[0][1] * m[2][2]) / det, (m[0][1] * m[1][2] - m[0][2] * m[1][1]) / det },
+		{ (m[1][2] * m[2][0] - m[1][0] * m[2][2]) / det, (m[0][0] * m[2][2] - m[0][2] * m[2][0]) / det, (m[0][2] * m[1][0] - m[0][0] * m[1][2]) / det },
+		{ (m[1][0] * m[2][1] - m[1][1] * m[2][0]) / det, (m[0][1] * m[2][0] - m[0][0] * m[2][1]) / det, (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / det }
+	};
+	for (int i = 0; i < 2; i++)
+		for (int j = 0; j < 3; j++)
+			cd[i][j] = inv[j][0] * r[i][0] + inv[j][1] * r[i][1] + inv[j][2] * r[i][2];
+	return true;
+}
+
+// -------------------------------------------------------------------------------- solver
+
+typedef struct {
+	int image, catalog, votes;
+} vote;
+
+static int vote_comparator(const void *a, const void *b) {
+	return ((vote *)b)->votes - ((vote *)a)->votes;
+}
+
+static double elapsed_time(struct timeval *start) {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1000000.0;
+}
+
+// match all image stars against projected catalog stars with given transformation
+
+static int match_stars(double *x, double *y, int count, catalog_star **stars, double *xi, double *eta, int catalog_count, double cd[2][3], double tolerance, star_pair *pairs) {
+	int matched = 0;
+	for (int i = 0; i < count; i++) {
+		double sx = cd[0][0] * x[i] + cd[0][1] * y[i] + cd[0][2];
+		double sy = cd[1][0] * x[i] + cd[1][1] * y[i] + cd[1][2];
+		int best = -1;
+		double best_distance = tolerance * tolerance;
+		for (int j = 0; j < catalog_count; j++) {
+			double d = (xi[j] - sx) * (xi[j] - sx) + (eta[j] - sy) * (eta[j] - sy);
+			if (d < best_distance) {
+				best_distance = d;
+				best = j;
+			}
+		}
+		if (best >= 0) {
+			pairs[matched].x = x[i];
+			pairs[matched].y = y[i];
+			pairs[matched].xi = xi[best];
+			pairs[matched].eta = eta[best];
+			pairs[matched].star = stars[best];
+			matched++;
+		}
+	}
+	return matched;
+}
+
+typedef struct {
+	int width, height;
+	double *x, *y;
+	int count;
+	triangle *triangles;
+	int triangle_count;
+	catalog_star **cone;
+	double *xi, *eta;
+	triangle *catalog_triangles;
+	star_pair *pairs;
+} solver_context;
+
+// match all stars within the field, refit transformation and move tangent point to the frame center
+
+static int refine_solution(solver_context *context, tangent_plane *plane, double cd[2][3], double pixel_tolerance) {
+	double half_diagonal = hypot(context->width, context->height) / 2;
+	int matched = 0, in_frame = 0;
+	for (int iteration = 0; iteration < 3; iteration++) {
+		double ra, dec, center[3];
+		tangent_plane_unproject(plane, cd[0][2], cd[1][2], &ra, &dec);
+		unit_vector(ra, dec, center);
+		double scale = sqrt(fabs(cd[0][0] * cd[1][1] - cd[0][1] * cd[1][0]));
+		int cone_count = catalog_cone(center, 1.05 * half_diagonal * scale * 180 / M_PI, context->cone, catalog_zone[ZONE_COUNT]);
+		int projected = 0;
+		for (int i = 0; i < cone_count; i++) {
+			if (tangent_plane_project(plane, context->cone[i]->v, context->xi + projected, context->eta + projected))
+				context->cone[projected++] = context->cone[i];
+		}
+		matched = match_stars(context->x, context->y, context->count, context->cone, context->xi, context->eta, projected, cd, pixel_tolerance * scale, context->pairs);
+		if (matched < MIN_MATCHED_STARS || !affine_fit(context->pairs, matched, cd))
+			return 0;
+		tangent_plane_unproject(plane, cd[0][2], cd[1][2], &ra, &dec);
+		tangent_plane_init(plane, ra, dec);
+		for (int i = 0; i < matched; i++)
+			tangent_plane_project(plane, context->pairs[i].star->v, &context->pairs[i].xi, &context->pairs[i].eta);
+		affine_fit(context->pairs, matched, cd);
+		// count catalog stars expected within the frame
+		double det = cd[0][0] * cd[1][1] - cd[0][1] * cd[1][0];
+		in_frame = 0;
+		for (int i = 0; i < projected; i++) {
+			double xi, eta;
+			if (!tangent_plane_project(plane, context->cone[i]->v, &xi, &eta))
+				continue;
+			xi -= cd[0][2];
+			eta -= cd[1][2];
+			double x = (cd[1][1] * xi - cd[0][1] * eta) / det;
+			double y = (cd[0][0] * eta - cd[1][0] * xi) / det;
+			if (fabs(x) < context->width / 2.0 && fabs(y) < context->height / 2.0)
+				in_frame++;
+		}
+	}
+	// most of the bright catalog stars within the frame have to be matched
+	if (matched < (in_frame < context->count ? in_frame : context->count) / 2)
+		return 0;
+	// real optics are close to conformal, skewed fit means the pairs were matched by chance
+	double column_1 = hypot(cd[0][0], cd[1][0]), column_2 = hypot(cd[0][1], cd[1][1]);
+	if (fabs(column_1 / column_2 - 1) > 0.02 || fabs(cd[0][0] * cd[0][1] + cd[1][0] * cd[1][1]) / (column_1 * column_2) > 0.02)
+		return 0;
+	// few matches are accepted only if they fit tightly
+	double scale = sqrt(fabs(cd[0][0] * cd[1][1] - cd[0][1] * cd[1][0]));
+	double rms = 0;
+	for (int i = 0; i < matched; i++) {
+		star_pair *pair = context->pairs + i;
+		double dx = cd[0][0] * pair->x + cd[0][1] * pair->y + cd[0][2] - pair->xi;
+		double dy = cd[1][0] * pair->x + cd[1][1] * pair->y + cd[1][2] - pair->eta;
+		rms += dx * dx + dy * dy;
+	}
+	rms = sqrt(rms / matched) / scale;
+	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%d of %d stars matched, rms %.2f px", matched, in_frame, rms);
+	if (rms > pixel_tolerance / 2 || (matched < 2 * MIN_MATCHED_STARS && rms > 1.5))
+		return 0;
+	return matched;
+}
+
+static bool try_field(solver_context *context, indigo_native_solver_hints *hints, tangent_plane *plane, double field_radius, double scale, indigo_native_solver_solution *solution) {
+	int votes[2][MATCH_STARS][MATCH_STARS];
+	int cone_count = catalog_cone(plane->center, field_radius, context->cone, catalog_zone[ZONE_COUNT]);
+	if (cone_count < 4)
+		return false;
+	qsort(context->cone, cone_count, sizeof(catalog_star *), catalog_ptr_mag_comparator);
+	double xi[MATCH_STARS], eta[MATCH_STARS];
+	int count = 0;
+	for (int i = 0; i < cone_count && count < MATCH_STARS; i++) {
+		if (tangent_plane_project(plane, context->cone[i]->v, xi + count, eta + count))
+			count++;
+	}
+	int catalog_triangle_count = build_triangles(xi, eta, count, 0, context->catalog_triangles);
+	memset(votes, 0, sizeof(votes));
+	for (int i = 0; i < catalog_triangle_count; i++) {
+		triangle *c = context->catalog_triangles + i;
+		int low = 0, high = context->triangle_count;
+		while (low < high) {
+			int mid = (low + high) / 2;
+			if (context->triangles[mid].r1 < c->r1 - TRIANGLE_TOLERANCE)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		for (int j = low; j < context->triangle_count && context->triangles[j].r1 <= c->r1 + TRIANGLE_TOLERANCE; j++) {
+			triangle *t = context->triangles + j;
+			if (fabs(t->r2 - c->r2) > TRIANGLE_TOLERANCE)
+				continue;
+			if (scale > 0) {
+				double ratio = c->a / (t->a * scale);
+				if (ratio > SCALE_TOLERANCE || ratio < 1 / SCALE_TOLERANCE)
+					continue;
+			}
+			int mirrored = t->orientation != c->orientation;
+			for (int k = 0; k < 3; k++)
+				votes[mirrored][t->v[k]][c->v[k]]++;
+		}
+	}
+	for (int mirrored = 0; mirrored < 2; mirrored++) {
+		// parity 1 is mirrored image to sky mapping with top-down row order
+		if (hints->parity != 0 && hints->parity != (mirrored ? 1 : -1))
+			continue;
+		vote candidates[MATCH_STARS * MATCH_STARS];
+		int candidate_count = 0;
+		for (int i = 0; i < MATCH_STARS; i++) {
+			for (int j = 0; j < MATCH_STARS; j++) {
+				if (votes[mirrored][i][j] >= 2) {
+					candidates[candidate_count].image = i;
+					candidates[candidate_count].catalog = j;
+					candidates[candidate_count].votes = votes[mirrored][i][j];
+					candidate_count++;
+				}
+			}
+		}
+		if (candidate_count < 3)
+			continue;
+		qsort(candidates, candidate_count, sizeof(vote), vote_comparator);
+		bool image_used[MATCH_STARS] = { false }, catalog_used[MATCH_STARS] = { false };
+		star_pair pairs[MATCH_STARS];
+		int pair_count = 0;
+		for (int i = 0; i < candidate_count; i++) {
+			vote *v = candidates + i;
+			if (image_used[v->image] || catalog_used[v->catalog])
+				continue;
+			image_used[v->image] = catalog_used[v->catalog] = true;
+			pairs[pair_count].x = context->x[v->image];
+			pairs[pair_count].y = context->y[v->image];
+			pairs[pair_count].xi = xi[v->catalog];
+			pairs[pair_count].eta = eta[v->catalog];
+			pair_count++;
+		}
+		// drop the worst pair until the fit is consistent, candidate is rejected if the fit fails
+		similarity s = { 0 };
+		bool fitted = false;
+		double pixel_tolerance = fmax(3, 0.005 * hypot(context->width, context->height));
+		while (pair_count >= 3 && (fitted = similarity_fit(pairs, pair_count, mirrored, &s))) {
+			double tolerance = pixel_tolerance * hypot(s.a, s.b);
+			int worst = -1;
+			double worst_distance = tolerance;
+			for (int i = 0; i < pair_count; i++) {
+				double xi, eta;
+				similarity_apply(&s, pairs[i].x, pairs[i].y, &xi, &eta);
+				double d = hypot(xi - pairs[i].xi, eta - pairs[i].eta);
+				if (d > worst_distance) {
+					worst_distance = d;
+					worst = i;
+				}
+			}
+			if (worst < 0)
+				break;
+			pairs[worst] = pairs[--pair_count];
+		}
+		if (!fitted || pair_count < 3)
+			continue;
+		if (scale > 0) {
+			double ratio = hypot(s.a, s.b) / scale;
+			if (ratio > SCALE_TOLERANCE || ratio < 1 / SCALE_TOLERANCE)
+				continue;
+		}
+		double sign = mirrored ? -1 : 1;
+		double cd[2][3] = { { s.a, -s.b * sign, s.tx }, { s.b, s.a * sign, s.ty } };
+		tangent_plane refined = *plane;
+		int matched = refine_solution(context, &refined, cd, pixel_tolerance);
+		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Candidate with %d pairs, %d stars matched", pair_count, matched);
+		// whole sky search has too many chances for a random match, even with known scale
+		if (matched >= (hints->radius > 0 ? MIN_MATCHED_STARS : BLIND_MATCHED_STARS)) {
+			tangent_plane_unproject(&refined, cd[0][2], cd[1][2], &solution->ra, &solution->dec);
+			solution->ra *= 180 / M_PI;
+			solution->dec *= 180 / M_PI;
+			for (int i = 0; i < 2; i++)
+				for (int j = 0; j < 2; j++)
+					solution->cd[i][j] = cd[i][j] * 180 / M_PI;
+			solution->matched = matched;
+			return true;
+		}
+	}
+	return false;
+}
+
+typedef struct {
+	double v[3];
+	double distance;
+} field_center;
+
+static double angular_distance(const double *a, const double *b) {
+	double d = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	return acos(d > 1 ? 1 : d < -1 ? -1 : d) * 180 / M_PI;
+}
+
+static int field_center_comparator(const void *a, const void *b) {
+	double distance_a = ((field_center *)a)->distance;
+	double distance_b = ((field_center *)b)->distance;
+	return distance_a < distance_b ? -1 : distance_a > distance_b ? 1 : 0;
+}
+
+// returns field centers covering the search area ordered by distance from the hint
+
+static int field_centers(indigo_native_solver_hints *hints, double step, field_center **centers) {
+	double radius = hints->radius > 0 ? hints->radius : 180;
+	int size = 1, count = 0;
+	for (double dec = -90 + step / 2; dec < 90; dec += step)
+		size += (int)ceil(360 * cos(dec * M_PI / 180) / step);
+	field_center *result = indigo_safe_malloc(size * sizeof(field_center));
+	unit_vector(hints->ra * M_PI / 180, hints->dec * M_PI / 180, result[count++].v);
+	if (radius > step / 2) {
+		for (double dec = -90 + step / 2; dec < 90; dec += step) {
+			int n = (int)ceil(360 * cos(dec * M_PI / 180) / step);
+			for (int i = 0; i < n; i++) {
+				field_center *center = result + count;
+				unit_vector(2 * M_PI * i / n, dec * M_PI / 180, center->v);
+				center->distance = angular_distance(center->v, result[0].v);
+				if (center->distance <= radius + step)
+					count++;
+			}
+		}
+		qsort(result + 1, count - 1, sizeof(field_center), field_center_comparator);
+	}
+	*centers = result;
+	return count;
+}
+
+bool indigo_native_solver_solve(indigo_star_detection *stars, int star_count, int width, int height, indigo_native_solver_hints *hints, indigo_native_solver_solution *solution) {
+	static double field_radii[] = { 1.5, 2.5, 4, 6, 9, 13, 20, 30, 0 };
+	struct timeval start;
+	gettimeofday(&start, NULL);
+	solver_context context = { width, height };
+	context.count = star_count < MAX_IMAGE_STARS ? star_count : MAX_IMAGE_STARS;
+	context.x = indigo_safe_malloc(2 * context.count * sizeof(double));
+	context.y = context.x + context.count;
+	for (int i = 0; i < context.count; i++) {
+		context.x[i] = stars[i].x - width / 2.0;
+		context.y[i] = stars[i].y - height / 2.0;
+	}
+	int match_count = context.count < MATCH_STARS ? context.count : MATCH_STARS;
+	int max_triangles = MATCH_STARS * (MATCH_STARS - 1) * (MATCH_STARS - 2) / 6;
+	context.triangles = indigo_safe_malloc(2 * max_triangles * sizeof(triangle));
+	context.catalog_triangles = context.triangles + max_triangles;
+	context.triangle_count = build_triangles(context.x, context.y, match_count, MIN_TRIANGLE_SIDE, context.triangles);
+	context.cone = indigo_safe_malloc(catalog_zone[ZONE_COUNT] * sizeof(catalog_star *));
+	context.xi = indigo_safe_malloc(2 * catalog_zone[ZONE_COUNT] * sizeof(double));
+	context.eta = context.xi + catalog_zone[ZONE_COUNT];
+	context.pairs = indigo_safe_malloc(context.count * sizeof(star_pair));
+	double half_diagonal = hypot(width, height) / 2;
+	bool solved = false;
+	for (int i = 0; !solved && field_radii[i]; i++) {
+		double scale = hints->scale * M_PI / 180;
+		double field_radius = field_radii[i];
+		if (scale > 0) {
+			field_radius = half_diagonal * hints->scale;
+			if (i > 0)
+				break;
+		}
+		field_center *centers;
+		int center_count = field_centers(hints, field_radius / 2, &centers);
+		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Searching %d fields with radius %g°", center_count, field_radius);
+		for (int j = 0; !solved && j < center_count; j++) {
+			if (*hints->abort_requested || (hints->time_limit > 0 && elapsed_time(&start) > hints->time_limit))
+				break;
+			tangent_plane plane;
+			tangent_plane_init(&plane, atan2(centers[j].v[1], centers[j].v[0]), asin(centers[j].v[2]));
+			solved = try_field(&context, hints, &plane, field_radius, scale, solution);
+		}
+		indigo_safe_free(centers);
+	}
+	indigo_safe_free(context.x);
+	indigo_safe_free(context.triangles);
+	indigo_safe_free(context.cone);
+	indigo_safe_free(context.xi);
+	indigo_safe_free(context.pairs);
+	return solved;
+}
+
+// -------------------------------------------------------------------------------- image decoding
+
+static void *decode_image(void *image, unsigned long size, indigo_raw_type *type, int *width, int *height, void **buffer) {
+	*buffer = NULL;
+	if (size > sizeof(indigo_raw_header) && !strncmp("RAW", (const char *)image, 3)) {
+		indigo_raw_header *header = (indigo_raw_header *)image;
+		*type = header->signature;
+		*width = header->width;
+		*height = header->height;
+		return (char *)image + sizeof(indigo_raw_header);
+	}
+	if (size > FITS_RECORD_SIZE && !strncmp("SIMPLE", (const char *)image, 6)) {
+		int bitpix = 0, naxis1 = 0, naxis2 = 0;
+		double bzero = 0;
+		const char *header = (const char *)image;
+		const char *end = header + size;
+		while (strncmp(header, "END ", 4)) {
+			if (header + 80 > end)
+				return NULL;
+			if (!strncmp(header, "BITPIX  =", 9))
+				bitpix = atoi(header + 10);
+			else if (!strncmp(header, "NAXIS1  =", 9))
+				naxis1 = atoi(header + 10);
+			else if (!strncmp(header, "NAXIS2  =", 9))
+				naxis2 = atoi(header + 10);
+			else if (!strncmp(header, "BZERO   =", 9))
+				bzero = atof(header + 10);
+			header += 80;
+		}
+		unsigned long offset = ((header - (const char *)image) / FITS_RECORD_SIZE + 1) * FITS_RECORD_SIZE;
+		unsigned long pixels = (unsigned long)naxis1 * naxis2;
+		if (naxis1 <= 0 || naxis2 <= 0)
+			return NULL;
+		if (bitpix == 8 && offset + pixels <= size) {
+			*type = INDIGO_RAW_MONO8;
+			*width = naxis1;
+			*height = naxis2;
+			return (char *)image + offset;
+		}
+		if (bitpix == 16 && offset + 2 * pixels <= size) {
+			uint8_t *in = (uint8_t *)image + offset;
+			uint16_t *out = *buffer = indigo_safe_malloc(2 * pixels);
+			for (unsigned long i = 0; i < pixels; i++, in += 2) {
+				int value = (int16_t)(in[0] << 8 | in[1]) + (int)bzero;
+				out[i] = value < 0 ? 0 : value > 0xFFFF ? 0xFFFF : value;
+			}
+			*type = INDIGO_RAW_MONO16;
+			*width = naxis1;
+			*height = naxis2;
+			return *buffer;
+		}
+	}
+	return NULL;
+}
+
+// -------------------------------------------------------------------------------- plate solver callbacks
+
+#define native_save_config indigo_platesolver_save_config
+
+static void native_abort(indigo_device *device) {
+	NATIVE_DEVICE_PRIVATE_DATA->abort_requested = true;
+}
+
+static bool native_solve(indigo_device *device, void *image, unsigned long image_size) {
+	if (pthread_mutex_trylock(&DEVICE_CONTEXT->config_mutex) == 0) {
+		char *message = NULL;
+		NATIVE_DEVICE_PRIVATE_DATA->abort_requested = false;
+		INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed = true;
+		AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_BUSY_STATE;
+		AGENT_PLATESOLVER_WCS_RA_ITEM->number.value = 0;
+		AGENT_PLATESOLVER_WCS_DEC_ITEM->number.value = 0;
+		AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = 0;
+		AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = 0;
+		AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.value = 0;
+		AGENT_PLATESOLVER_WCS_ANGLE_ITEM->number.value = 0;
+		AGENT_PLATESOLVER_WCS_INDEX_ITEM->number.value = 0;
+		AGENT_PLATESOLVER_WCS_PARITY_ITEM->number.value = 0;
+		AGENT_PLATESOLVER_WCS_STATE_ITEM->number.value = INDIGO_SOLVER_STATE_SOLVING;
+		indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, NULL);
+		struct timeval start;
+		gettimeofday(&start, NULL);
+		indigo_raw_type type;
+		int width = 0, height = 0;
+		void *buffer = NULL;
+		void *data = image ? decode_image(image, image_size, &type, &width, &height, &buffer) : NULL;
+		if (data == NULL) {
+			message = "Unsupported image format";
+			goto cleanup;
+		}
+		int stars_max = AGENT_PLATESOLVER_HINTS_DEPTH_ITEM->number.value > 0 ? (int)AGENT_PLATESOLVER_HINTS_DEPTH_ITEM->number.value : 50;
+		if (stars_max > MAX_IMAGE_STARS)
+			stars_max = MAX_IMAGE_STARS;
+		indigo_star_detection stars[MAX_IMAGE_STARS];
+		int star_count = 0;
+		indigo_find_stars_precise(type, data, STAR_RADIUS, width, height, stars_max, stars, &star_count);
+		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%d stars detected in %dx%d frame", star_count, width, height);
+		if (star_count < MIN_MATCHED_STARS) {
+			message = "Not enough stars detected";
+			goto cleanup;
+		}
+		indigo_native_solver_hints hints = { 0 };
+		hints.radius = AGENT_PLATESOLVER_HINTS_RADIUS_ITEM->number.value;
+		hints.ra = AGENT_PLATESOLVER_HINTS_RA_ITEM->number.value;
+		hints.dec = AGENT_PLATESOLVER_HINTS_DEC_ITEM->number.value;
+		if (AGENT_PLATESOLVER_HINTS_EPOCH_ITEM->number.value == 0)
+			indigo_jnow_to_j2k(&hints.ra, &hints.dec);
+		hints.ra *= 15;
+		if (AGENT_PLATESOLVER_HINTS_SCALE_ITEM->number.value > 0)
+			hints.scale = AGENT_PLATESOLVER_HINTS_SCALE_ITEM->number.value;
+		else if (AGENT_PLATESOLVER_HINTS_SCALE_ITEM->number.value < 0 && INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pixel_scale > 0)
+			hints.scale = INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pixel_scale;
+		hints.parity = (int)AGENT_PLATESOLVER_HINTS_PARITY_ITEM->number.value;
+		hints.time_limit = AGENT_PLATESOLVER_HINTS_CPU_LIMIT_ITEM->number.value;
+		hints.abort_requested = &NATIVE_DEVICE_PRIVATE_DATA->abort_requested;
+		indigo_native_solver_solution solution;
+		if (!indigo_native_solver_solve(stars, star_count, width, height, &hints, &solution)) {
+			message = NATIVE_DEVICE_PRIVATE_DATA->abort_requested ? "Aborted" : "No solution found";
+			goto cleanup;
+		}
+		double ra = solution.ra / 15, dec = solution.dec;
+		if (AGENT_PLATESOLVER_HINTS_EPOCH_ITEM->number.target == 0) {
+			indigo_j2k_to_jnow(&ra, &dec);
+			AGENT_PLATESOLVER_WCS_EPOCH_ITEM->number.value = 0;
+		} else {
+			AGENT_PLATESOLVER_WCS_EPOCH_ITEM->number.value = 2000;
+		}
+		AGENT_PLATESOLVER_WCS_RA_ITEM->number.value = ra;
+		AGENT_PLATESOLVER_WCS_DEC_ITEM->number.value = dec;
+		double cd11 = solution.cd[0][0], cd12 = solution.cd[0][1], cd21 = solution.cd[1][0], cd22 = solution.cd[1][1];
+		double det = cd11 * cd22 - cd12 * cd21;
+		double crota1 = det < 0 ? atan2(-cd21, -cd11) : atan2(cd21, cd11);
+		double crota2 = atan2(-cd12, cd22);
+		double angle = -atan2(sin(crota1) + sin(crota2), cos(crota1) + cos(crota2)) * 180 / M_PI;
+		AGENT_PLATESOLVER_WCS_ANGLE_ITEM->number.value = angle < 0 ? angle + 360 : angle;
+		AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.value = sqrt(fabs(det));
+		AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = width * AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.value;
+		AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = height * AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.value;
+		AGENT_PLATESOLVER_WCS_PARITY_ITEM->number.value = det >= 0 ? -1 : 1;
+		INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed = false;
+		indigo_send_message(device, "Solved in %gs, %d stars matched", elapsed_time(&start), solution.matched);
+	cleanup:
+		indigo_safe_free(buffer);
+		AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed ? INDIGO_ALERT_STATE : INDIGO_OK_STATE;
+		indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, message);
+		pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
+		return !INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed;
+	}
+	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Solver is busy");
+	return false;
+}
+
+// -------------------------------------------------------------------------------- INDIGO agent device implementation
+
+static indigo_result agent_enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property);
+
+static indigo_result agent_device_attach(indigo_device *device) {
+	assert(device != NULL);
+	if (indigo_platesolver_device_attach(device, DRIVER_NAME, DRIVER_VERSION, 0) == INDIGO_OK) {
+		AGENT_PLATESOLVER_USE_INDEX_PROPERTY->rule = INDIGO_ONE_OF_MANY_RULE;
+		indigo_init_switch_item(AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count++, "HIP", "Bundled Hipparcos catalog (FOV > 3°)", true);
+		AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.min = AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value = 0;
+		// --------------------------------------------------------------------------------
+		NATIVE_DEVICE_PRIVATE_DATA->platesolver.save_config = native_save_config;
+		NATIVE_DEVICE_PRIVATE_DATA->platesolver.solve = native_solve;
+		NATIVE_DEVICE_PRIVATE_DATA->platesolver.abort = native_abort;
+		indigo_load_properties(device, false);
+		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
+		return agent_enumerate_properties(device, NULL, NULL);
+	}
+	return INDIGO_FAILED;
+}
+
+static indigo_result agent_enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property) {
+	if (client != NULL && client == FILTER_DEVICE_CONTEXT->client)
+		return INDIGO_OK;
+	return indigo_platesolver_enumerate_properties(device, client, property);
+}
+
+static indigo_result agent_change_property(indigo_device *device, indigo_client *client, indigo_property *property) {
+	assert(device != NULL);
+	assert(DEVICE_CONTEXT != NULL);
+	assert(property != NULL);
+	if (client == FILTER_DEVICE_CONTEXT->client)
+		return INDIGO_OK;
+	return indigo_platesolver_change_property(device, client, property);
+}
+
+static indigo_result agent_device_detach(indigo_device *device) {
+	assert(device != NULL);
+	return indigo_platesolver_device_detach(device);
+}
+
+// -------------------------------------------------------------------------------- Initialization
+
+static indigo_device *agent_device = NULL;
+static indigo_client *agent_client = NULL;
+
+indigo_result indigo_agent_native_solver(indigo_driver_action action, indigo_driver_info *info) {
+	static indigo_device agent_device_template = INDIGO_DEVICE_INITIALIZER(
+		NATIVE_SOLVER_AGENT_NAME,
+		agent_device_attach,
+		agent_enumerate_properties,
+		agent_change_property,
+		NULL,
+		agent_device_detach
+	);
+
+	static indigo_client agent_client_template = {
+		NATIVE_SOLVER_AGENT_NAME, false, NULL, INDIGO_OK, INDIGO_VERSION_CURRENT, NULL,
+		indigo_platesolver_client_attach,
+		indigo_platesolver_define_property,
+		indigo_platesolver_update_property,
+		indigo_platesolver_delete_property,
+		NULL,
+		indigo_platesolver_client_detach
+	};
+
+	static indigo_driver_action last_action = INDIGO_DRIVER_SHUTDOWN;
+
+	SET_DRIVER_INFO(info, NATIVE_SOLVER_AGENT_NAME, __FUNCTION__, DRIVER_VERSION, false, last_action);
+
+	if (action == last_action)
+		return INDIGO_OK;
+
+	switch(action) {
+		case INDIGO_DRIVER_INIT:
+			last_action = action;
+			indigo_native_solver_build_index();
+			void *private_data = indigo_safe_malloc(sizeof(native_private_data));
+			agent_device = indigo_safe_malloc_copy(sizeof(indigo_device), &agent_device_template);
+			agent_device->private_data = private_data;
+			indigo_attach_device(agent_device);
+			agent_client = indigo_safe_malloc_copy(sizeof(indigo_client), &agent_client_template);
+			agent_client->client_context = agent_device->device_context;
+			indigo_attach_client(agent_client);
+			break;
+
+		case INDIGO_DRIVER_SHUTDOWN:
+			last_action = action;
+			if (agent_client != NULL) {
+				indigo_detach_client(agent_client);
+				free(agent_client);
+				agent_client = NULL;
+			}
+			if (agent_device != NULL) {
+				indigo_detach_device(agent_device);
+				free(agent_device);
+				agent_device = NULL;
+			}
+			indigo_native_solver_release_index();
+			break;
+
+		case INDIGO_DRIVER_INFO:
+			break;
+	}
+	return INDIGO_OK;
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2024 CloudMakers, s. r. o.
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 initial in-process solver using bundled Hipparcos catalog
+
+/** INDIGO native plate solver agent
+ \file indigo_agent_native_solver.h
+ */
+
+#ifndef agent_native_solver_h
+#define agent_native_solver_h
+
+#include <indigo/indigo_agent.h>
+#include <indigo/indigo_raw_utils.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NATIVE_SOLVER_AGENT_NAME	"Native Solver Agent"
+
+/** Create native plate solver agent instance
+ */
+
+extern indigo_result indigo_agent_native_solver(indigo_driver_action action, indigo_driver_info *info);
+
+/** Solver hints, position and radius in degrees (J2000), scale in degrees per pixel, zero if not known
+ */
+typedef struct {
+	double ra, dec;
+	double radius;
+	double scale;
+	int parity;
+	double time_limit;
+	bool *abort_requested;
+} indigo_native_solver_hints;
+
+/** Solver solution, field center in degrees (J2000), CD matrix and number of matched stars
+ */
+typedef struct {
+	double ra, dec;
+	double cd[2][2];
+	int matched;
+} indigo_native_solver_solution;
+
+/** Build catalog index used by indigo_native_solver_solve(), it is built by the agent on attach
+ */
+extern void indigo_native_solver_build_index(void);
+
+/** Release catalog index
+ */
+extern void indigo_native_solver_release_index(void);
+
+/** Solve field with stars detected by indigo_find_stars_precise()
+ */
+extern bool indigo_native_solver_solve(indigo_star_detection *stars, int star_count, int width, int height, indigo_native_solver_hints *hints, indigo_native_solver_solution *solution);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* agent_native_solver_h */
+
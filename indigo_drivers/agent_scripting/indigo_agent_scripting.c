@@ -472,7 +472,7 @@ static duk_ret_t define_text_property(duk_context *ctx) {
 				indigo_copy_value(item->text.value, duk_to_string(ctx, -1));
 				duk_get_prop_string(ctx, 5, key);
 				duk_get_prop_string(ctx, -1, "label");
-				indigo_copy_value(item->label, duk_to_string(ctx, -1));
+				indigo_set_label(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // label
 				duk_pop(ctx); // item defs
 				duk_pop_2(ctx); // item
@@ -510,10 +510,10 @@ static duk_ret_t define_number_property(duk_context *ctx) {
 				item->number.value = duk_to_number(ctx, -1);;
 				duk_get_prop_string(ctx, 5, key);
 				duk_get_prop_string(ctx, -1, "label");
-				indigo_copy_value(item->label, duk_to_string(ctx, -1));
+				indigo_set_label(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // label
 				duk_get_prop_string(ctx, -1, "format");
-				indigo_copy_value(item->number.format, duk_to_string(ctx, -1));
+				indigo_set_number_format(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // format
 				duk_get_prop_string(ctx, -1, "min");
 				item->number.min = duk_to_number(ctx, -1);
@@ -561,7 +561,7 @@ static duk_ret_t define_switch_property(duk_context *ctx) {
 				item->number.value = duk_to_boolean(ctx, -1);;
 				duk_get_prop_string(ctx, 5, key);
 				duk_get_prop_string(ctx, -1, "label");
-				indigo_copy_value(item->label, duk_to_string(ctx, -1));
+				indigo_set_label(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // label
 				duk_pop(ctx); // item defs
 				duk_pop_2(ctx); // item
@@ -598,7 +598,7 @@ static duk_ret_t define_light_property(duk_context *ctx) {
 				item->light.value = require_state(ctx, -1);;
 				duk_get_prop_string(ctx, 5, key);
 				duk_get_prop_string(ctx, -1, "label");
-				indigo_copy_value(item->label, duk_to_string(ctx, -1));
+				indigo_set_label(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // label
 				duk_pop(ctx); // item defs
 				duk_pop_2(ctx); // item
@@ -1102,15 +1102,9 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 				indigo_delete_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 				indigo_delete_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 				indigo_delete_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
-				int count = AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->count;
-				if (i + 1 < count) {
-					memmove(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + i, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + i + 1, sizeof(indigo_item) * (count - i - 1));
-					memmove(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + (i + 1), AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 1));
-					memmove(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + (i + 1), AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 1));
-				}
-				AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->count--;
-				AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->count--;
-				AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->count--;
+				indigo_remove_item(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, i);
+				indigo_remove_item(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, i + 1);
+				indigo_remove_item(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, i + 1);
 				AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->state = INDIGO_OK_STATE;
 				indigo_define_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 				indigo_define_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
@@ -1142,16 +1136,16 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 				script_property->state = INDIGO_OK_STATE;
 				if (strcmp(script_property->label, script_property->items[0].text.value)) {
 					indigo_delete_property(device, script_property, NULL);
-					indigo_copy_value(script_property->label, script_property->items[0].text.value);
+					indigo_set_label(script_property, script_property->items[0].text.value);
 					for (int j = 0; j < AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->count; j++) {
 						indigo_item *item = AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + j;
 						if (!strcmp(script_property->name, item->name)) {
 							indigo_delete_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 							indigo_delete_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 							indigo_delete_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
-							strcpy(item->label, script_property->label);
-							strcpy(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
-							strcpy(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
+							indigo_set_label(item, script_property->label);
+							indigo_set_string(&AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
+							indigo_set_string(&AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
 							indigo_property_sort_items(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, 0);
 							indigo_property_sort_items(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, 1);
 							indigo_property_sort_items(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, 1);
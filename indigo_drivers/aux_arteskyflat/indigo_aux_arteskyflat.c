@@ -88,7 +88,7 @@ static indigo_result aux_attach(indigo_device *device) {
 		if (AUX_LIGHT_INTENSITY_PROPERTY == NULL)
 			return INDIGO_FAILED;
 		indigo_init_number_item(AUX_LIGHT_INTENSITY_ITEM, AUX_LIGHT_INTENSITY_ITEM_NAME, "Intensity", 0, 255, 1, 0);
-		strcpy(AUX_LIGHT_INTENSITY_ITEM->number.format, "%g");
+		indigo_set_number_format(AUX_LIGHT_INTENSITY_ITEM, "%g");
 		// -------------------------------------------------------------------------------- DEVICE_PORT, DEVICE_PORTS
 		DEVICE_PORT_PROPERTY->hidden = false;
 		DEVICE_PORTS_PROPERTY->hidden = false;
@@ -129,6 +129,7 @@ static void aux_connection_handler(indigo_device *device) {
 		for (int i = 0; i < 2; i++) {
 			PRIVATE_DATA->handle = indigo_open_serial(DEVICE_PORT_ITEM->text.value);
 			if (PRIVATE_DATA->handle > 0) {
+				indigo_attach_reader(PRIVATE_DATA->handle, 0);
 				INDIGO_DRIVER_LOG(DRIVER_NAME, "Connected on %s", DEVICE_PORT_ITEM->text.value);
 				sprintf(command, ">B%03d", (int)(AUX_LIGHT_INTENSITY_ITEM->number.value));
 				if (artesky_command(PRIVATE_DATA->handle, command, response) && *response == '*') {
@@ -137,7 +138,7 @@ static void aux_connection_handler(indigo_device *device) {
 					break;
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Handshake failed");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			}
@@ -155,7 +156,7 @@ static void aux_connection_handler(indigo_device *device) {
 		indigo_delete_property(device, AUX_LIGHT_SWITCH_PROPERTY, NULL);
 		indigo_delete_property(device, AUX_LIGHT_INTENSITY_PROPERTY, NULL);
 		artesky_command(PRIVATE_DATA->handle, ">D000", response);
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
 		CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
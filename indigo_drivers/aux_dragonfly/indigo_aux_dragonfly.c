@@ -159,7 +159,7 @@ static int lunatico_init_properties(indigo_device *device) {
 	DEVICE_PORT_PROPERTY->hidden = false;
 	DEVICE_PORT_PROPERTY->state = INDIGO_OK_STATE;
 	indigo_copy_value(DEVICE_PORT_ITEM->text.value, "udp://dragonfly");
-	indigo_copy_value(DEVICE_PORT_ITEM->label, "Devce URL");
+	indigo_set_label(DEVICE_PORT_ITEM, "Devce URL");
 	// --------------------------------------------------------------------------------
 	INFO_PROPERTY->count = 6;
 	// -------------------------------------------------------------------------------- OUTLET_NAMES
@@ -458,23 +458,23 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 			indigo_delete_property(device, AUX_GPIO_OUTLET_PROPERTY, NULL);
 			indigo_delete_property(device, AUX_OUTLET_PULSE_LENGTHS_PROPERTY, NULL);
 		}
-		snprintf(AUX_GPIO_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_GPIO_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_GPIO_OUTLET_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_GPIO_OUTLET_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_4_ITEM->text.value);
-		snprintf(AUX_GPIO_OUTLET_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_5_ITEM->text.value);
-		snprintf(AUX_GPIO_OUTLET_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_6_ITEM->text.value);
-		snprintf(AUX_GPIO_OUTLET_7_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_7_ITEM->text.value);
-		snprintf(AUX_GPIO_OUTLET_8_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_8_ITEM->text.value);
-
-		snprintf(AUX_OUTLET_PULSE_LENGTHS_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_OUTLET_PULSE_LENGTHS_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_OUTLET_PULSE_LENGTHS_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_OUTLET_PULSE_LENGTHS_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_4_ITEM->text.value);
-		snprintf(AUX_OUTLET_PULSE_LENGTHS_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_5_ITEM->text.value);
-		snprintf(AUX_OUTLET_PULSE_LENGTHS_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_6_ITEM->text.value);
-		snprintf(AUX_OUTLET_PULSE_LENGTHS_7_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_7_ITEM->text.value);
-		snprintf(AUX_OUTLET_PULSE_LENGTHS_8_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_8_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_OUTLET_1_ITEM, AUX_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_OUTLET_2_ITEM, AUX_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_OUTLET_3_ITEM, AUX_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_OUTLET_4_ITEM, AUX_OUTLET_NAME_4_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_OUTLET_5_ITEM, AUX_OUTLET_NAME_5_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_OUTLET_6_ITEM, AUX_OUTLET_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_OUTLET_7_ITEM, AUX_OUTLET_NAME_7_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_OUTLET_8_ITEM, AUX_OUTLET_NAME_8_ITEM->text.value);
+
+		indigo_set_label(AUX_OUTLET_PULSE_LENGTHS_1_ITEM, AUX_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_OUTLET_PULSE_LENGTHS_2_ITEM, AUX_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_OUTLET_PULSE_LENGTHS_3_ITEM, AUX_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_OUTLET_PULSE_LENGTHS_4_ITEM, AUX_OUTLET_NAME_4_ITEM->text.value);
+		indigo_set_label(AUX_OUTLET_PULSE_LENGTHS_5_ITEM, AUX_OUTLET_NAME_5_ITEM->text.value);
+		indigo_set_label(AUX_OUTLET_PULSE_LENGTHS_6_ITEM, AUX_OUTLET_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_OUTLET_PULSE_LENGTHS_7_ITEM, AUX_OUTLET_NAME_7_ITEM->text.value);
+		indigo_set_label(AUX_OUTLET_PULSE_LENGTHS_8_ITEM, AUX_OUTLET_NAME_8_ITEM->text.value);
 
 		AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 		if (DEVICE_CONNECTED) {
@@ -508,14 +508,14 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 		if (DEVICE_CONNECTED) {
 			indigo_delete_property(device, AUX_GPIO_SENSORS_PROPERTY, NULL);
 		}
-		snprintf(AUX_GPIO_SENSOR_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_SENSOR_NAME_1_ITEM->text.value);
-		snprintf(AUX_GPIO_SENSOR_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_SENSOR_NAME_2_ITEM->text.value);
-		snprintf(AUX_GPIO_SENSOR_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_SENSOR_NAME_3_ITEM->text.value);
-		snprintf(AUX_GPIO_SENSOR_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_SENSOR_NAME_4_ITEM->text.value);
-		snprintf(AUX_GPIO_SENSOR_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_SENSOR_NAME_5_ITEM->text.value);
-		snprintf(AUX_GPIO_SENSOR_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_SENSOR_NAME_6_ITEM->text.value);
-		snprintf(AUX_GPIO_SENSOR_7_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_SENSOR_NAME_7_ITEM->text.value);
-		snprintf(AUX_GPIO_SENSOR_8_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_SENSOR_NAME_8_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_SENSOR_1_ITEM, AUX_SENSOR_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_SENSOR_2_ITEM, AUX_SENSOR_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_SENSOR_3_ITEM, AUX_SENSOR_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_SENSOR_4_ITEM, AUX_SENSOR_NAME_4_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_SENSOR_5_ITEM, AUX_SENSOR_NAME_5_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_SENSOR_6_ITEM, AUX_SENSOR_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_SENSOR_7_ITEM, AUX_SENSOR_NAME_7_ITEM->text.value);
+		indigo_set_label(AUX_GPIO_SENSOR_8_ITEM, AUX_SENSOR_NAME_8_ITEM->text.value);
 		AUX_SENSOR_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 		if (DEVICE_CONNECTED) {
 			indigo_define_property(device, AUX_GPIO_SENSORS_PROPERTY, NULL);
@@ -73,6 +73,7 @@ static bool fbc_command(int handle, char *command, char *response, int resp_len)
 	if(response) {
 		indigo_usleep(20000);
 		tcflush(handle, TCIOFLUSH);
+		indigo_flush_reader(handle);
 	}
 
 	int result = indigo_write(handle, command, strlen(command));
@@ -140,7 +141,7 @@ static indigo_result aux_attach(indigo_device *device) {
 		if (AUX_LIGHT_INTENSITY_PROPERTY == NULL)
 			return INDIGO_FAILED;
 		indigo_init_number_item(AUX_LIGHT_INTENSITY_ITEM, AUX_LIGHT_INTENSITY_ITEM_NAME, "Intensity (%)", 0, 100, 1, 50);
-		strcpy(AUX_LIGHT_INTENSITY_ITEM->number.format, "%g");
+		indigo_set_number_format(AUX_LIGHT_INTENSITY_ITEM, "%g");
 		// -------------------------------------------------------------------------------- AUX_LIGHT_IMPULSE
 		AUX_LIGHT_IMPULSE_PROPERTY = indigo_init_number_property(NULL, device->name, AUX_LIGHT_IMPULSE_PROPERTY_NAME, AUX_MAIN_GROUP, "Light impulse", INDIGO_OK_STATE, INDIGO_RW_PERM, 1);
 		if (AUX_LIGHT_IMPULSE_PROPERTY == NULL)
@@ -209,14 +210,14 @@ static void aux_connection_handler(indigo_device *device) {
 						if (strcmp("P SerialMode", response)) {
 							INDIGO_DRIVER_ERROR(DRIVER_NAME, "FBC is not in SerialMode. Turn all knobs to 0 and powercycle the device.");
 							indigo_send_message(device, "FBC is not in SerialMode. Turn all knobs to 0 and powercycle the device.");
-							close(PRIVATE_DATA->handle);
+							indigo_close_reader(PRIVATE_DATA->handle);
 							PRIVATE_DATA->handle = 0;
 							break;
 						}
 					}
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Handshake failed");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			}
@@ -260,7 +261,7 @@ static void aux_connection_handler(indigo_device *device) {
 		fbc_command(PRIVATE_DATA->handle, ": E 0 #", NULL, 0);
 		fbc_command(PRIVATE_DATA->handle, ": F 0 #", NULL, 0);
 
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
 		CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
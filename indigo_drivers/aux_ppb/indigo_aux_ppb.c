@@ -114,6 +114,7 @@ typedef struct {
 
 static bool ppb_command(indigo_device *device, char *command, char *response, int max) {
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 	indigo_write(PRIVATE_DATA->handle, "\n", 1);
 	if (response != NULL) {
@@ -441,7 +442,7 @@ static void aux_connection_handler(indigo_device *device) {
 					}
 					if (attempt++ == 3) {
 						INDIGO_DRIVER_ERROR(DRIVER_NAME, "PPB not detected");
-						close(PRIVATE_DATA->handle);
+						indigo_close_reader(PRIVATE_DATA->handle);
 						PRIVATE_DATA->handle = 0;
 						break;
 					}
@@ -504,7 +505,7 @@ static void aux_connection_handler(indigo_device *device) {
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'PA' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -564,7 +565,7 @@ static void aux_connection_handler(indigo_device *device) {
 					ppb_command(device, "PL:0", response, sizeof(response));
 				}
 				INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -670,8 +671,8 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 	} else if (indigo_property_match_changeable(AUX_OUTLET_NAMES_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- X_AUX_OUTLET_NAMES
 		indigo_property_copy_values(AUX_OUTLET_NAMES_PROPERTY, property, false);
-		snprintf(AUX_HEATER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_1_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_2_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
 		AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 		if (IS_CONNECTED) {
 			indigo_delete_property(device, AUX_HEATER_OUTLET_PROPERTY, NULL);
@@ -73,6 +73,7 @@ static bool sqm_open(indigo_device *device) {
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to connect to %s", DEVICE_PORT_ITEM->text.value);
 		return false;
 	}
+	indigo_attach_reader(PRIVATE_DATA->handle, 0);
 	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Connected to %s", DEVICE_PORT_ITEM->text.value);
 	return true;
 }
@@ -91,7 +92,7 @@ static bool sqm_command(indigo_device *device, const char *command, char *respon
 
 static void sqm_close(indigo_device *device) {
 	if (PRIVATE_DATA->handle >= 0) {
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = -1;
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Disconnected");
 	}
@@ -179,9 +180,9 @@ static indigo_result aux_attach(indigo_device *device) {
 		if (AUX_INFO_PROPERTY == NULL)
 			return INDIGO_FAILED;
 		indigo_init_number_item(X_AUX_SENSOR_FREQUENCY_ITEM, "X_AUX_SENSOR_FREQUENCY", "SQM sensor frequency [Hz]", 0, 1000000000, 0, 0);
-		strcpy(X_AUX_SENSOR_FREQUENCY_ITEM->number.format, "%.0f");
+		indigo_set_number_format(X_AUX_SENSOR_FREQUENCY_ITEM, "%.0f");
 		indigo_init_number_item(X_AUX_SENSOR_COUNTS_ITEM, "X_AUX_SENSOR_COUNTS", "SQM sensor period [counts]", 0, 1000000000, 0, 0);
-		strcpy(X_AUX_SENSOR_COUNTS_ITEM->number.format, "%.0f");
+		indigo_set_number_format(X_AUX_SENSOR_COUNTS_ITEM, "%.0f");
 		indigo_init_number_item(X_AUX_SENSOR_PERIOD_ITEM, "X_AUX_SENSOR_PERIOD", "SQM sensor period [sec]", 0, 1000000000, 0, 0);
 
 		// -------------------------------------------------------------------------------- WEATHER
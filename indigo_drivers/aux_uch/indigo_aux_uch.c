@@ -98,6 +98,7 @@ typedef struct {
 
 static bool uch_command(indigo_device *device, char *command, char *response, int max) {
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 	indigo_write(PRIVATE_DATA->handle, "\n", 1);
 	if (response != NULL) {
@@ -288,7 +289,7 @@ static void aux_connection_handler(indigo_device *device) {
 					}
 					if (attempt++ == 3) {
 						INDIGO_DRIVER_ERROR(DRIVER_NAME, "UCH not detected");
-						close(PRIVATE_DATA->handle);
+						indigo_close_reader(PRIVATE_DATA->handle);
 						PRIVATE_DATA->handle = 0;
 						break;
 					}
@@ -312,12 +313,12 @@ static void aux_connection_handler(indigo_device *device) {
 					AUX_USB_PORT_6_ITEM->sw.value =  token[5] == '1';
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to parse 'PA' response");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'PA' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 
@@ -355,7 +356,7 @@ static void aux_connection_handler(indigo_device *device) {
 			if (PRIVATE_DATA->handle > 0) {
 				uch_command(device, "PL:0", response, sizeof(response));
 				INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -423,12 +424,12 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 	} else if (indigo_property_match_changeable(AUX_OUTLET_NAMES_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- X_AUX_OUTLET_NAMES
 		indigo_property_copy_values(AUX_OUTLET_NAMES_PROPERTY, property, false);
-		snprintf(AUX_USB_PORT_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_1_ITEM->text.value);
-		snprintf(AUX_USB_PORT_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_2_ITEM->text.value);
-		snprintf(AUX_USB_PORT_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_3_ITEM->text.value);
-		snprintf(AUX_USB_PORT_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_4_ITEM->text.value);
-		snprintf(AUX_USB_PORT_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_5_ITEM->text.value);
-		snprintf(AUX_USB_PORT_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_1_ITEM, AUX_USB_PORT_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_2_ITEM, AUX_USB_PORT_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_3_ITEM, AUX_USB_PORT_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_4_ITEM, AUX_USB_PORT_NAME_4_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_5_ITEM, AUX_USB_PORT_NAME_5_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_6_ITEM, AUX_USB_PORT_NAME_6_ITEM->text.value);
 		AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 		if (IS_CONNECTED) {
 			indigo_delete_property(device, AUX_USB_PORT_PROPERTY, NULL);
@@ -179,6 +179,7 @@ typedef struct {
 
 static bool upb_command(indigo_device *device, char *command, char *response, int max) {
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 	indigo_write(PRIVATE_DATA->handle, "\n", 1);
 	if (response != NULL) {
@@ -212,7 +213,7 @@ static void upb_open(indigo_device *device) {
 			}
 			if (attempt++ == 3) {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "UPB not detected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 				break;
 			}
@@ -885,12 +886,12 @@ static void aux_connection_handler(indigo_device *device) {
 					indigo_set_switch(AUX_DEW_CONTROL_PROPERTY, atoi(token) == 0 ? AUX_DEW_CONTROL_MANUAL_ITEM : AUX_DEW_CONTROL_AUTOMATIC_ITEM, true);
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to parse 'PA' response");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'PA' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -1009,7 +1010,7 @@ static void aux_connection_handler(indigo_device *device) {
 			if (PRIVATE_DATA->handle > 0) {
 				upb_command(device, "PL:0", response, sizeof(response));
 				INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -1167,39 +1168,39 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 	} else if (indigo_property_match_changeable(AUX_OUTLET_NAMES_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- X_AUX_OUTLET_NAMES
 		indigo_property_copy_values(AUX_OUTLET_NAMES_PROPERTY, property, false);
-		snprintf(AUX_POWER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_3_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_1_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_2_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_3_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_4_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_STATE_1_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_STATE_2_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_STATE_3_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_CURRENT_1_ITEM->label, INDIGO_NAME_SIZE, "%s current [A] ", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_CURRENT_2_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_CURRENT_3_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_CURRENT_4_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_CURRENT_1_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_CURRENT_2_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_CURRENT_3_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_USB_PORT_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_1_ITEM->text.value);
-		snprintf(AUX_USB_PORT_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_2_ITEM->text.value);
-		snprintf(AUX_USB_PORT_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_3_ITEM->text.value);
-		snprintf(AUX_USB_PORT_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_4_ITEM->text.value);
-		snprintf(AUX_USB_PORT_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_5_ITEM->text.value);
-		snprintf(AUX_USB_PORT_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_6_ITEM->text.value);
-		snprintf(AUX_USB_PORT_STATE_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_1_ITEM->text.value);
-		snprintf(AUX_USB_PORT_STATE_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_2_ITEM->text.value);
-		snprintf(AUX_USB_PORT_STATE_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_3_ITEM->text.value);
-		snprintf(AUX_USB_PORT_STATE_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_4_ITEM->text.value);
-		snprintf(AUX_USB_PORT_STATE_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_5_ITEM->text.value);
-		snprintf(AUX_USB_PORT_STATE_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_1_ITEM, AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_2_ITEM, AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_3_ITEM, AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_4_ITEM, AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_1_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_2_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_3_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_1_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_2_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_3_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_4_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_STATE_1_ITEM->label, "%s state", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_STATE_2_ITEM->label, "%s state", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_STATE_3_ITEM->label, "%s state", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_CURRENT_1_ITEM->label, "%s current [A] ", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_CURRENT_2_ITEM->label, "%s current [A]", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_CURRENT_3_ITEM->label, "%s current [A]", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_CURRENT_4_ITEM->label, "%s current [A]", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_CURRENT_1_ITEM->label, "%s current [A]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_CURRENT_2_ITEM->label, "%s current [A]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_CURRENT_3_ITEM->label, "%s current [A]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_1_ITEM, AUX_USB_PORT_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_2_ITEM, AUX_USB_PORT_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_3_ITEM, AUX_USB_PORT_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_4_ITEM, AUX_USB_PORT_NAME_4_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_5_ITEM, AUX_USB_PORT_NAME_5_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_6_ITEM, AUX_USB_PORT_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_STATE_1_ITEM, AUX_USB_PORT_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_STATE_2_ITEM, AUX_USB_PORT_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_STATE_3_ITEM, AUX_USB_PORT_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_STATE_4_ITEM, AUX_USB_PORT_NAME_4_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_STATE_5_ITEM, AUX_USB_PORT_NAME_5_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_STATE_6_ITEM, AUX_USB_PORT_NAME_6_ITEM->text.value);
 		AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 		if (IS_CONNECTED) {
 			indigo_delete_property(device, AUX_POWER_OUTLET_PROPERTY, NULL);
@@ -1422,12 +1423,12 @@ static void focuser_connection_handler(indigo_device *device) {
 					FOCUSER_BACKLASH_ITEM->number.value = FOCUSER_BACKLASH_ITEM->number.target = atoi(token);
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to parse 'SA' response");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'SA' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -1455,7 +1456,7 @@ static void focuser_connection_handler(indigo_device *device) {
 			if (PRIVATE_DATA->handle > 0) {
 				upb_command(device, "PL:0", response, sizeof(response));
 				INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -155,6 +155,7 @@ typedef struct {
 
 static bool upb_command(indigo_device *device, char *command, char *response, int max) {
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 	indigo_write(PRIVATE_DATA->handle, "\n", 1);
 	if (response != NULL) {
@@ -179,7 +180,7 @@ static void upb_open(indigo_device *device) {
 					PRIVATE_DATA->version = 3;
 					break;
 				} else {
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			}
@@ -596,7 +597,7 @@ static void aux_connection_handler(indigo_device *device) {
 			if (PRIVATE_DATA->handle > 0) {
 				upb_command(device, "PL:0", response, sizeof(response));
 				INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -722,32 +723,32 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 	} else if (indigo_property_match_changeable(AUX_OUTLET_NAMES_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- X_AUX_OUTLET_NAMES
 		indigo_property_copy_values(AUX_OUTLET_NAMES_PROPERTY, property, false);
-		snprintf(AUX_POWER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_5_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_6_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_7_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_7_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_8_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_8_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_9_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_9_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_3_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_1_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_2_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_3_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_4_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_5_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_5_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_STATE_6_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_6_ITEM->text.value);
-		snprintf(AUX_USB_PORT_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_1_ITEM->text.value);
-		snprintf(AUX_USB_PORT_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_2_ITEM->text.value);
-		snprintf(AUX_USB_PORT_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_3_ITEM->text.value);
-		snprintf(AUX_USB_PORT_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_4_ITEM->text.value);
-		snprintf(AUX_USB_PORT_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_5_ITEM->text.value);
-		snprintf(AUX_USB_PORT_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_6_ITEM->text.value);
-		snprintf(AUX_USB_PORT_7_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_6_ITEM->text.value);
-		snprintf(AUX_USB_PORT_8_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_1_ITEM, AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_2_ITEM, AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_3_ITEM, AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_4_ITEM, AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_5_ITEM, AUX_POWER_OUTLET_NAME_5_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_6_ITEM, AUX_POWER_OUTLET_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_7_ITEM, AUX_POWER_OUTLET_NAME_7_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_8_ITEM, AUX_POWER_OUTLET_NAME_8_ITEM->text.value);
+		indigo_set_label(AUX_POWER_OUTLET_9_ITEM, AUX_POWER_OUTLET_NAME_9_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_1_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_2_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_3_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_1_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_2_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_3_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_4_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_5_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_5_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_STATE_6_ITEM->label, "%s state", AUX_POWER_OUTLET_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_1_ITEM, AUX_USB_PORT_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_2_ITEM, AUX_USB_PORT_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_3_ITEM, AUX_USB_PORT_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_4_ITEM, AUX_USB_PORT_NAME_4_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_5_ITEM, AUX_USB_PORT_NAME_5_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_6_ITEM, AUX_USB_PORT_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_7_ITEM, AUX_USB_PORT_NAME_6_ITEM->text.value);
+		indigo_set_label(AUX_USB_PORT_8_ITEM, AUX_USB_PORT_NAME_6_ITEM->text.value);
 		AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 		if (IS_CONNECTED) {
 			indigo_delete_property(device, AUX_POWER_OUTLET_PROPERTY, NULL);
@@ -971,7 +972,7 @@ static void focuser_connection_handler(indigo_device *device) {
 			if (PRIVATE_DATA->handle > 0) {
 				upb_command(device, "PL:0", response, sizeof(response));
 				INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
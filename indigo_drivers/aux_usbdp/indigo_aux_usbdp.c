@@ -196,6 +196,7 @@ static bool usbdp_command(indigo_device *device, char *command, char *response,
 	/* Wait a bit before flushing as usb to serial caches data */
 	indigo_usleep(20000);
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 
 	if (response != NULL) {
@@ -664,13 +665,13 @@ static void aux_connection_handler(indigo_device *device) {
 					indigo_define_property(device, AUX_DEW_WARNING_PROPERTY, NULL);
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "USB_Dewpoint not detected");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 				indigo_update_property(device, INFO_PROPERTY, NULL);
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "USB_Dewpoint not detected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -683,12 +684,12 @@ static void aux_connection_handler(indigo_device *device) {
 
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to parse 'SGETAL' response");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'SGETAL' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 			indigo_set_timer(device, 0, aux_timer_callback, &PRIVATE_DATA->aux_timer);
@@ -730,7 +731,7 @@ static void aux_connection_handler(indigo_device *device) {
 				// maybe check responce if "DONE" ?
 			}
 			INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-			close(PRIVATE_DATA->handle);
+			indigo_close_reader(PRIVATE_DATA->handle);
 			PRIVATE_DATA->handle = 0;
 		}
 		CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
@@ -848,20 +849,20 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 	} else if (indigo_property_match_changeable(AUX_OUTLET_NAMES_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- X_AUX_OUTLET_NAMES
 		indigo_property_copy_values(AUX_OUTLET_NAMES_PROPERTY, property, false);
-		snprintf(AUX_HEATER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_3_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_STATE_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_STATE_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_HEATER_OUTLET_STATE_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-		snprintf(AUX_TEMPERATURE_SENSOR_1_ITEM->label, INDIGO_NAME_SIZE, "%s (°C)", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_TEMPERATURE_SENSOR_2_ITEM->label, INDIGO_NAME_SIZE, "%s (°C)", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_CALLIBRATION_SENSOR_1_ITEM->label, INDIGO_NAME_SIZE, "%s (°C)", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_CALLIBRATION_SENSOR_2_ITEM->label, INDIGO_NAME_SIZE, "%s (°C)", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_DEW_THRESHOLD_SENSOR_1_ITEM->label, INDIGO_NAME_SIZE, "%s (°C)", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_DEW_THRESHOLD_SENSOR_2_ITEM->label, INDIGO_NAME_SIZE, "%s (°C)", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-		snprintf(AUX_DEW_WARNING_SENSOR_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_DEW_WARNING_SENSOR_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_1_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_2_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_3_ITEM->label, "%s [%%]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_label(AUX_HEATER_OUTLET_STATE_1_ITEM, AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_HEATER_OUTLET_STATE_2_ITEM, AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_HEATER_OUTLET_STATE_3_ITEM, AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+		indigo_set_string_printf(&AUX_TEMPERATURE_SENSOR_1_ITEM->label, "%s (°C)", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_TEMPERATURE_SENSOR_2_ITEM->label, "%s (°C)", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_CALLIBRATION_SENSOR_1_ITEM->label, "%s (°C)", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_CALLIBRATION_SENSOR_2_ITEM->label, "%s (°C)", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_DEW_THRESHOLD_SENSOR_1_ITEM->label, "%s (°C)", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_DEW_THRESHOLD_SENSOR_2_ITEM->label, "%s (°C)", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_label(AUX_DEW_WARNING_SENSOR_1_ITEM, AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_label(AUX_DEW_WARNING_SENSOR_2_ITEM, AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
 		AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 		if (IS_CONNECTED) {
 			indigo_delete_property(device, AUX_HEATER_OUTLET_PROPERTY, NULL);
@@ -218,6 +218,7 @@ static bool wbplusv3_parse_status(char *status_line, wbplusv3_status_t *status)
 static bool wbplusv3_read_status(indigo_device *device, wbplusv3_status_t *wb_stat) {
 	char status[256] = {0};
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	int res = indigo_read_line(PRIVATE_DATA->handle, status, 256);
 	if (strncmp(status, DEVICE_ID, strlen(DEVICE_ID))) {   // first part of the message is cleared by tcflush();
 		res = indigo_read_line(PRIVATE_DATA->handle, status, 256);
@@ -235,6 +236,7 @@ static bool wbplusv3_read_status(indigo_device *device, wbplusv3_status_t *wb_st
 
 static bool wbplusv3_command(indigo_device *device, char *command) {
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 	int res = indigo_write(PRIVATE_DATA->handle, "\n", 1);
 	if (res < 0) {
@@ -473,12 +475,12 @@ static void aux_connection_handler(indigo_device *device) {
 					indigo_update_property(device, INFO_PROPERTY, NULL);
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Device is not WandererBox Plus V3");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Device is not WandererBox Plus V3");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -518,7 +520,7 @@ static void aux_connection_handler(indigo_device *device) {
 
 		if (PRIVATE_DATA->handle > 0) {
 			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Disconnected");
-			close(PRIVATE_DATA->handle);
+			indigo_close_reader(PRIVATE_DATA->handle);
 			PRIVATE_DATA->handle = 0;
 		}
 		CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
@@ -596,10 +598,10 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 	} else if (indigo_property_match_changeable(AUX_OUTLET_NAMES_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- X_AUX_OUTLET_NAMES
 		indigo_property_copy_values(AUX_OUTLET_NAMES_PROPERTY, property, false);
-		snprintf(AUX_HEATER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s (DC3) [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s (DC2)", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_VOLTAGE_1_ITEM->label, INDIGO_NAME_SIZE, "%s (DC2) [V]", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-		snprintf(AUX_POWER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s (DC4-DC6)", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+		indigo_set_string_printf(&AUX_HEATER_OUTLET_1_ITEM->label, "%s (DC3) [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_1_ITEM->label, "%s (DC2)", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_VOLTAGE_1_ITEM->label, "%s (DC2) [V]", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_string_printf(&AUX_POWER_OUTLET_2_ITEM->label, "%s (DC4-DC6)", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
 		
 		AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 		if (IS_CONNECTED) {
@@ -157,6 +157,7 @@ static bool wcv4ec_parse_status(char *status_line, wcv4ec_status_t *status) {
 static bool wcv4ec_read_status(indigo_device *device, wcv4ec_status_t *wc_stat) {
 	char status[256] = {0};
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	wc_stat->ready = false;
 	int res = indigo_read_line(PRIVATE_DATA->handle, status, 256);
 	if (strncmp(status, DEVICE_ID, strlen(DEVICE_ID))) {   // first part of the message is cleared by tcflush() or "done";
@@ -254,6 +255,7 @@ static void aux_timer_callback(indigo_device *device) {
 // -------------------------------------------------------------------------------- Low level communication routines
 static bool wcv4ec_command(indigo_device *device, char *command) {
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 	int res = indigo_write(PRIVATE_DATA->handle, "\n", 1);
 	if (res < 0) {
@@ -286,7 +288,7 @@ static indigo_result aux_attach(indigo_device *device) {
 		if (AUX_LIGHT_INTENSITY_PROPERTY == NULL)
 			return INDIGO_FAILED;
 		indigo_init_number_item(AUX_LIGHT_INTENSITY_ITEM, AUX_LIGHT_INTENSITY_ITEM_NAME, "Intensity", 0, 255, 1, 50);
-		strcpy(AUX_LIGHT_INTENSITY_ITEM->number.format, "%g");
+		indigo_set_number_format(AUX_LIGHT_INTENSITY_ITEM, "%g");
 		// -------------------------------------------------------------------------------- AUX_COVER
 		AUX_COVER_PROPERTY = indigo_init_switch_property(NULL, device->name, AUX_COVER_PROPERTY_NAME, AUX_MAIN_GROUP, "Cover (open/close)", INDIGO_IDLE_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 2);
 		if (AUX_COVER_PROPERTY == NULL)
@@ -369,12 +371,12 @@ static void aux_connection_handler(indigo_device *device) {
 					indigo_update_property(device, INFO_PROPERTY, NULL);
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Device is not WandererCover V4-EC");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Device is not WandererCover V4-EC");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -425,7 +427,7 @@ static void aux_connection_handler(indigo_device *device) {
 		indigo_update_property(device, INFO_PROPERTY, NULL);
 		wcv4ec_command(device, "9999"); // turn light off
 		wcv4ec_command(device, "2000"); // turn the heater off
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Disconnected");
 		CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
@@ -504,6 +506,7 @@ static void aux_detect_open_close_handler(indigo_device *device) {
 		PRIVATE_DATA->operation_running = true; // let the status callback set correct open/close when we are done
 		char status_line[128] = {0};
 		tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+		indigo_flush_reader(PRIVATE_DATA->handle);
 		do {
 			indigo_read_line(PRIVATE_DATA->handle, status_line, 128);
 		} while (strncmp(status_line, "OpenSet", strlen("OpenSet")) && strncmp(status_line, "CloseSet", strlen("CloseSet")));
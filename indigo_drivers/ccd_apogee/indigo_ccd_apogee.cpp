@@ -1087,8 +1087,8 @@ static indigo_result ethernet_attach(indigo_device *device) {
 		// -------------------------------------------------------------------------------- DEVICE_PORT
 		DEVICE_PORT_PROPERTY->hidden = false;
 		indigo_copy_value(DEVICE_PORT_ITEM->text.value, "192.168.0.255");
-		indigo_copy_value(DEVICE_PORT_PROPERTY->label, "Network");
-		indigo_copy_value(DEVICE_PORT_ITEM->label, "Broadcast address");
+		indigo_set_label(DEVICE_PORT_PROPERTY, "Network");
+		indigo_set_label(DEVICE_PORT_ITEM, "Broadcast address");
 		// -------------------------------------------------------------------------------- DEVICE_PORTS
 		DEVICE_PORTS_PROPERTY->hidden = true;
 		// --------------------------------------------------------------------------------
@@ -747,7 +747,7 @@ static indigo_result ccd_attach(indigo_device *device) {
 		indigo_copy_value(INFO_DEVICE_MODEL_ITEM->text.value, PRIVATE_DATA->info.Name);
 		char *sdk_version = ASIGetSDKVersion();
 		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->text.value, sdk_version);
-		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->label, "SDK version");
+		indigo_set_label(INFO_DEVICE_FW_REVISION_ITEM, "SDK version");
 
 		if (PRIVATE_DATA->serial_number[0] != '\0') {
 			INFO_PROPERTY->count = 8;
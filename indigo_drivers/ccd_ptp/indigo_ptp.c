@@ -1471,10 +1471,10 @@ bool ptp_update_property(indigo_device *device, ptp_property *property) {
 				for (int i = 0; i < property->count; i++) {
 					if (property->type == ptp_str_type) {
 						strcpy(str, property->value.sw_str.values[i]);
-						indigo_copy_value(property->property->items[i].label, str);
+						indigo_set_string(&property->property->items[i].label, str);
 					} else {
 						snprintf(str, INDIGO_NAME_SIZE, "%llx", property->value.sw.values[i]);
-						indigo_copy_value(property->property->items[i].label, PRIVATE_DATA->property_value_code_label(device, property->code, property->value.sw.values[i]));
+						indigo_set_string(&property->property->items[i].label, PRIVATE_DATA->property_value_code_label(device, property->code, property->value.sw.values[i]));
 					}
 					if (strncmp(property->property->items[i].name, str, INDIGO_NAME_SIZE)) {
 						indigo_copy_name(property->property->items[i].name, str);
@@ -1082,9 +1082,9 @@ static indigo_result ccd_change_property(indigo_device *device, indigo_client *c
 		GUIDER_IMAGE_DEC_OFFSET_ITEM->number.max = GUIDER_IMAGE_HEIGHT_ITEM->number.target;
 		CCD_INFO_WIDTH_ITEM->number.value = CCD_FRAME_WIDTH_ITEM->number.value = CCD_FRAME_WIDTH_ITEM->number.target = CCD_FRAME_WIDTH_ITEM->number.max = GUIDER_IMAGE_WIDTH_ITEM->number.target;
 		CCD_INFO_HEIGHT_ITEM->number.value = CCD_FRAME_HEIGHT_ITEM->number.value = CCD_FRAME_HEIGHT_ITEM->number.target = CCD_FRAME_HEIGHT_ITEM->number.max = GUIDER_IMAGE_HEIGHT_ITEM->number.target;
-		sprintf(CCD_MODE_ITEM[0].label, "RAW %dx%d", (int)CCD_INFO_WIDTH_ITEM->number.value, (int)CCD_INFO_HEIGHT_ITEM->number.value);
-		sprintf(CCD_MODE_ITEM[1].label, "RAW %dx%d", (int)CCD_INFO_WIDTH_ITEM->number.value / 2, (int)CCD_INFO_HEIGHT_ITEM->number.value / 2);
-		sprintf(CCD_MODE_ITEM[2].label, "RAW %dx%d", (int)CCD_INFO_WIDTH_ITEM->number.value / 4, (int)CCD_INFO_HEIGHT_ITEM->number.value / 4);
+		indigo_set_string_printf(&CCD_MODE_ITEM[0].label, "RAW %dx%d", (int)CCD_INFO_WIDTH_ITEM->number.value, (int)CCD_INFO_HEIGHT_ITEM->number.value);
+		indigo_set_string_printf(&CCD_MODE_ITEM[1].label, "RAW %dx%d", (int)CCD_INFO_WIDTH_ITEM->number.value / 2, (int)CCD_INFO_HEIGHT_ITEM->number.value / 2);
+		indigo_set_string_printf(&CCD_MODE_ITEM[2].label, "RAW %dx%d", (int)CCD_INFO_WIDTH_ITEM->number.value / 4, (int)CCD_INFO_HEIGHT_ITEM->number.value / 4);
 		if (IS_CONNECTED) {
 			indigo_delete_property(device, CCD_INFO_PROPERTY, NULL);
 			indigo_delete_property(device, CCD_FRAME_PROPERTY, NULL);
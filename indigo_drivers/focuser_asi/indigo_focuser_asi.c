@@ -252,7 +252,7 @@ static indigo_result focuser_attach(indigo_device *device) {
 		indigo_copy_value(INFO_DEVICE_MODEL_ITEM->text.value, PRIVATE_DATA->model);
 		char *sdk_version = EAFGetSDKVersion();
 		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->text.value, sdk_version);
-		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->label, "SDK version");
+		indigo_set_label(INFO_DEVICE_FW_REVISION_ITEM, "SDK version");
 
 
 		FOCUSER_LIMITS_PROPERTY->hidden = false;
@@ -290,7 +290,7 @@ static indigo_result focuser_attach(indigo_device *device) {
 		indigo_copy_value(INFO_DEVICE_MODEL_ITEM->text.value, PRIVATE_DATA->model);
 		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->text.value, PRIVATE_DATA->firmware_version);
 		indigo_copy_value(INFO_DEVICE_HW_REVISION_ITEM->text.value, PRIVATE_DATA->sdk_version);
-		indigo_copy_value(INFO_DEVICE_HW_REVISION_ITEM->label, "SDK version");
+		indigo_set_label(INFO_DEVICE_HW_REVISION_ITEM, "SDK version");
 
 		FOCUSER_LIMITS_PROPERTY->hidden = false;
 		FOCUSER_LIMITS_MAX_POSITION_ITEM->number.min = 0;
@@ -376,7 +376,7 @@ static indigo_result focuser_attach(indigo_device *device) {
 		FOCUSER_TEMPERATURE_BOARD_PROPERTY = indigo_init_number_property(NULL, device->name, FOCUSER_TEMPERATURE_BOARD_PROPERTY_NAME, FOCUSER_MAIN_GROUP, "Temperature 1 (Board)", INDIGO_OK_STATE, INDIGO_RO_PERM, 1);
 		FOCUSER_TEMPERATURE_BOARD_PROPERTY->hidden = false;
 		indigo_init_number_item(FOCUSER_TEMPERATURE_BOARD_ITEM, "Internal Temp.", "Temperature (°C)", -50, 50, 1, 0);
-		indigo_copy_value(FOCUSER_TEMPERATURE_PROPERTY->label, "Temperature 2 (Ambient)");
+		indigo_set_label(FOCUSER_TEMPERATURE_PROPERTY, "Temperature 2 (Ambient)");
 
 		return focuser_enumerate_properties(device, NULL, NULL);
 	}
@@ -846,8 +846,8 @@ static void focuser_connect_callback(indigo_device *device) {
 						/* Current mulipliers in AF 3 are in range 1-100 */
 						DSD_CURRENT_CONTROL_MOVE_ITEM->number.min = 1.0;
 						DSD_CURRENT_CONTROL_HOLD_ITEM->number.min = 1.0;
-						indigo_copy_value(DSD_CURRENT_CONTROL_MOVE_ITEM->label, "Move current multiplier (%)");
-						indigo_copy_value(DSD_CURRENT_CONTROL_HOLD_ITEM->label, "Hold current multiplier (%)");
+						indigo_set_label(DSD_CURRENT_CONTROL_MOVE_ITEM, "Move current multiplier (%)");
+						indigo_set_label(DSD_CURRENT_CONTROL_HOLD_ITEM, "Hold current multiplier (%)");
 					}
 
 					dsd_get_position(device, &position);
@@ -86,8 +86,8 @@ static indigo_result focuser_attach(indigo_device *device) {
 		FOCUSER_POSITION_PROPERTY->hidden = true;
 		// -------------------------------------------------------------------------------- FOCUSER_SPEED
 		FOCUSER_SPEED_ITEM->number.value = FOCUSER_SPEED_ITEM->number.max = 255;
-		indigo_copy_value(FOCUSER_SPEED_ITEM->label, "Power (0-255)");
-		indigo_copy_value(FOCUSER_SPEED_PROPERTY->label, "Power");
+		indigo_set_label(FOCUSER_SPEED_ITEM, "Power (0-255)");
+		indigo_set_label(FOCUSER_SPEED_PROPERTY, "Power");
 		// --------------------------------------------------------------------------------
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 		return focuser_enumerate_properties(device, NULL, NULL);
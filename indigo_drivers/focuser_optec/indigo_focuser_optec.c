@@ -56,6 +56,7 @@ static bool optec_open(indigo_device *device) {
 	char *name = DEVICE_PORT_ITEM->text.value;
 	PRIVATE_DATA->handle = indigo_open_serial_with_speed(name, 19200);
 	if (PRIVATE_DATA->handle >= 0) {
+		indigo_attach_reader(PRIVATE_DATA->handle, 0);
 		char reply;
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Connected to %s", name);
 		if (indigo_printf(PRIVATE_DATA->handle, "FMMODE") && indigo_scanf(PRIVATE_DATA->handle, "%c", &reply) == 1 && reply == '!') {
@@ -88,7 +89,7 @@ static bool optec_open(indigo_device *device) {
 			return true;
 		} else {
 			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to initialize");
-			close(PRIVATE_DATA->handle);
+			indigo_close_reader(PRIVATE_DATA->handle);
 			PRIVATE_DATA->handle = 0;
 		}
 	} else {
@@ -100,7 +101,7 @@ static bool optec_open(indigo_device *device) {
 static void optec_close(indigo_device *device) {
 	if (PRIVATE_DATA->handle > 0) {
 		indigo_printf(PRIVATE_DATA->handle, "FFMODE");
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected from %s", DEVICE_PORT_ITEM->text.value);
 	}
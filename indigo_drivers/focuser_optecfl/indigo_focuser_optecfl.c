@@ -139,6 +139,7 @@ static bool optecfl_open(indigo_device *device) {
 	if (PRIVATE_DATA->count == 0) {
 		PRIVATE_DATA->handle = indigo_open_serial_with_speed(name, 115200);
 		if (PRIVATE_DATA->handle > 0) {
+			indigo_attach_reader(PRIVATE_DATA->handle, 0);
 			INDIGO_DRIVER_LOG(DRIVER_NAME, "Connected to %s", name);
 		}
 	}
@@ -158,7 +159,7 @@ static bool optecfl_open(indigo_device *device) {
 				}
 			}
 		} else {
-			close(PRIVATE_DATA->handle);
+			indigo_close_reader(PRIVATE_DATA->handle);
 			PRIVATE_DATA->handle = 0;
 			PRIVATE_DATA->count = 0;
 		}
@@ -203,7 +204,7 @@ static void optecfl_close(indigo_device *device) {
 	if (PRIVATE_DATA->count > 1) {
 		PRIVATE_DATA->count--;
 	} else {
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected from %s", DEVICE_PORT_ITEM->text.value);
 	}
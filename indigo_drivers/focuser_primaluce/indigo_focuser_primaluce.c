@@ -374,6 +374,7 @@ static bool primaluce_open(indigo_device *device) {
 	char *name = DEVICE_PORT_ITEM->text.value;
 	PRIVATE_DATA->handle = indigo_open_serial_with_speed(name, 115200);
 	if (PRIVATE_DATA->handle >= 0) {
+		indigo_attach_reader(PRIVATE_DATA->handle, 0);
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Connected to %s", name);
 		char response[1024];
 		jsmntok_t tokens[128];
@@ -396,7 +397,7 @@ static bool primaluce_open(indigo_device *device) {
 		} else {
 			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Handshake failed");
 		}
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 	} else {
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to connect to %s", name);
@@ -406,7 +407,7 @@ static bool primaluce_open(indigo_device *device) {
 
 static void primaluce_close(indigo_device *device) {
 	if (PRIVATE_DATA->handle > 0) {
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 		indigo_copy_value(INFO_DEVICE_MODEL_ITEM->text.value, "N/A");
 		indigo_copy_value(INFO_DEVICE_SERIAL_NUM_ITEM->text.value, "N/A");
@@ -566,10 +567,10 @@ static indigo_result focuser_attach(indigo_device *device) {
 		DEVICE_PORTS_PROPERTY->hidden = false;
 		FOCUSER_POSITION_ITEM->number.min = 0;
 		FOCUSER_POSITION_ITEM->number.max = 1000000;
-		strcpy(FOCUSER_POSITION_ITEM->number.format, "%.0f");
+		indigo_set_number_format(FOCUSER_POSITION_ITEM, "%.0f");
 		FOCUSER_STEPS_ITEM->number.min = 0;
 		FOCUSER_STEPS_ITEM->number.max = 1000000;
-		strcpy(FOCUSER_STEPS_ITEM->number.format, "%.0f");
+		indigo_set_number_format(FOCUSER_STEPS_ITEM, "%.0f");
 #ifdef INDIGO_MACOS
 		for (int i = 0; i < DEVICE_PORTS_PROPERTY->count; i++) {
 			if (!strncmp(DEVICE_PORTS_PROPERTY->items[i].name, "/dev/cu.usbmodem", 16)) {
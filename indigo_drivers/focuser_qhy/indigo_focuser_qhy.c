@@ -709,7 +709,7 @@ static indigo_result focuser_attach(indigo_device *device) {
 		FOCUSER_SPEED_ITEM->number.max = 8;
 		FOCUSER_SPEED_ITEM->number.step = 1;
 		FOCUSER_SPEED_ITEM->number.value = FOCUSER_SPEED_ITEM->number.target = 1;
-		strncpy(FOCUSER_SPEED_ITEM->label, "Speed (1 = fastest, 8 = slowest)", INDIGO_NAME_SIZE);
+		indigo_set_label(FOCUSER_SPEED_ITEM, "Speed (1 = fastest, 8 = slowest)");
 
 		FOCUSER_POSITION_ITEM->number.min = 0;
 		FOCUSER_POSITION_ITEM->number.step = 10;
@@ -216,6 +216,7 @@ static bool steeldrive2_command(indigo_device *device, char *command, char *resp
 static void steeldrive2_connect(indigo_device *device) {
 	PRIVATE_DATA->handle = indigo_open_serial_with_speed(DEVICE_PORT_ITEM->text.value, 19200);
 	if (PRIVATE_DATA->handle > 0) {
+		indigo_attach_reader(PRIVATE_DATA->handle, 0);
 		PRIVATE_DATA->use_crc = false;
 		char response[256], *colon;
 		for (int i = 0; i < 3; i++) {
@@ -234,7 +235,7 @@ static void steeldrive2_connect(indigo_device *device) {
 			}
 			indigo_usleep(100000);
 		}
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 	}
 }
@@ -566,7 +567,7 @@ static void focuser_connection_handler(indigo_device *device) {
 			INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
 			if (--PRIVATE_DATA->count == 0) {
 				indigo_cancel_timer_sync(device, &PRIVATE_DATA->timer);
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -1056,7 +1057,7 @@ static void aux_connection_handler(indigo_device *device) {
 			INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
 			if (--PRIVATE_DATA->count == 0) {
 				indigo_cancel_timer_sync(device, &PRIVATE_DATA->timer);
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -95,8 +95,8 @@ static indigo_result gps_attach(indigo_device *device) {
 		SIMULATION_PROPERTY->hidden = true;
 		DEVICE_PORT_PROPERTY->hidden = false;
 		DEVICE_PORT_PROPERTY->state = INDIGO_OK_STATE;
-		strcpy(DEVICE_PORT_PROPERTY->label, "GPS daemon host");
-		strcpy(DEVICE_PORT_ITEM->label, "Hostname (host:port)");
+		indigo_set_label(DEVICE_PORT_PROPERTY, "GPS daemon host");
+		indigo_set_label(DEVICE_PORT_ITEM, "Hostname (host:port)");
 		strcpy(DEVICE_PORT_ITEM->text.value, "gpsd://localhost:2947");
 		DEVICE_PORTS_PROPERTY->hidden = true;
 		DEVICE_BAUDRATE_PROPERTY->hidden = true;
@@ -87,6 +87,7 @@ static bool gps_open(indigo_device *device) {
 		PRIVATE_DATA->handle = indigo_open_network_device(name, 9999, &proto);
 	}
 	if (PRIVATE_DATA->handle >= 0) {
+		indigo_attach_reader(PRIVATE_DATA->handle, 0);
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Connected to %s", name);
 		pthread_mutex_unlock(&PRIVATE_DATA->serial_mutex);
 		return true;
@@ -99,7 +100,7 @@ static bool gps_open(indigo_device *device) {
 
 static void gps_close(indigo_device *device) {
 	pthread_mutex_lock(&PRIVATE_DATA->serial_mutex);
-	close(PRIVATE_DATA->handle);
+	indigo_close_reader(PRIVATE_DATA->handle);
 	PRIVATE_DATA->handle = -1;
 	INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected from %s", DEVICE_PORT_ITEM->text.value);
 	pthread_mutex_unlock(&PRIVATE_DATA->serial_mutex);
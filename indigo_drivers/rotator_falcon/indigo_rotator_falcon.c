@@ -49,6 +49,7 @@ typedef struct {
 
 static bool falcon_command(indigo_device *device, char *command, char *response, int max) {
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 	indigo_write(PRIVATE_DATA->handle, "\n", 1);
 	if (response != NULL) {
@@ -70,14 +71,14 @@ static void rotator_connection_handler(indigo_device *device) {
 			if (falcon_command(device, "F#", response, sizeof(response)) && !strcmp(response, "FR_OK")) {
 				strcpy(INFO_DEVICE_MODEL_ITEM->text.value ,"Falcon Rotator");
 			} else {
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = indigo_open_serial_with_speed(DEVICE_PORT_ITEM->text.value, 115200);
 				if (PRIVATE_DATA->handle > 0) {
 					if (falcon_command(device, "F#", response, sizeof(response)) && !strncmp(response, "F2R_", 4)) {
 						strcpy(INFO_DEVICE_MODEL_ITEM->text.value, "Falcon Rotator v2");
 					} else {
 						INDIGO_DRIVER_ERROR(DRIVER_NAME, "Rotator not detected");
-						close(PRIVATE_DATA->handle);
+						indigo_close_reader(PRIVATE_DATA->handle);
 						PRIVATE_DATA->handle = 0;
 					}
 				}
@@ -88,21 +89,21 @@ static void rotator_connection_handler(indigo_device *device) {
 				strcpy(INFO_DEVICE_FW_REVISION_ITEM->text.value, response + 3);
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'FV' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
 		if (PRIVATE_DATA->handle > 0) {
 			if (!(falcon_command(device, "FH", response, sizeof(response)) && !strcmp(response, "FH:1"))) {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'FH' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
 		if (PRIVATE_DATA->handle > 0) {
 			if (!(falcon_command(device, "DR:0", response, sizeof(response)) && !strncmp(response, "DR:", 3))) {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'DR' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -125,7 +126,7 @@ static void rotator_connection_handler(indigo_device *device) {
 							indigo_set_switch(ROTATOR_DIRECTION_PROPERTY, ROTATOR_DIRECTION_REVERSED_ITEM, true);
 					} else {
 						INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to parse 'FA' response");
-						close(PRIVATE_DATA->handle);
+						indigo_close_reader(PRIVATE_DATA->handle);
 						PRIVATE_DATA->handle = 0;
 					}
 				} else if (!strncmp(response, "F2R:", 4)) {
@@ -144,13 +145,13 @@ static void rotator_connection_handler(indigo_device *device) {
 							indigo_set_switch(ROTATOR_DIRECTION_PROPERTY, ROTATOR_DIRECTION_REVERSED_ITEM, true);
 					} else {
 						INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to parse 'FA' response");
-						close(PRIVATE_DATA->handle);
+						indigo_close_reader(PRIVATE_DATA->handle);
 						PRIVATE_DATA->handle = 0;
 					}
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read 'FA' response");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -166,7 +167,7 @@ static void rotator_connection_handler(indigo_device *device) {
 		strcpy(INFO_DEVICE_FW_REVISION_ITEM->text.value, "undefined");
 		if (PRIVATE_DATA->handle > 0) {
 			INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-			close(PRIVATE_DATA->handle);
+			indigo_close_reader(PRIVATE_DATA->handle);
 			PRIVATE_DATA->handle = 0;
 		}
 		CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
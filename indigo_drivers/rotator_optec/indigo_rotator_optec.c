@@ -69,12 +69,14 @@ static bool optec_wakeup(indigo_device *device) {
 		if (indigo_select(PRIVATE_DATA->handle, 100000) > 0) {
 			if (indigo_scanf(PRIVATE_DATA->handle, "%c", &response) != 1 || response != '!') {
 				tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+				indigo_flush_reader(PRIVATE_DATA->handle);
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to wake up");
 				return false;
 			}
 		}
 	}
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	return true;
 }
 
@@ -87,11 +89,12 @@ static bool optec_open(indigo_device *device) {
 		if (optec_wakeup(device)) {
 			if (indigo_printf(PRIVATE_DATA->handle, "CCLINK") && indigo_scanf(PRIVATE_DATA->handle, "%c", &response) == 1 && response == '!') {
 				tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+				indigo_flush_reader(PRIVATE_DATA->handle);
 				return true;
 			}
 		}
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to initialize");
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 	} else {
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to connect to %s", name);
@@ -101,7 +104,7 @@ static bool optec_open(indigo_device *device) {
 
 static void optec_close(indigo_device *device) {
 	if (PRIVATE_DATA->handle > 0) {
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected from %s", DEVICE_PORT_ITEM->text.value);
 	}
@@ -182,12 +185,13 @@ static void rotator_connect_callback(indigo_device *device) {
 			}
 			indigo_define_property(device, X_HOME_PROPERTY, NULL);
 			indigo_define_property(device, X_RATE_PROPERTY, NULL);
-			if (indigo_printf(PRIVATE_DATA->handle, "CTxx%02d", (int)X_RATE_ITEM->number.target) && read(PRIVATE_DATA->handle, response, 15) == 1 && *response == '!')
+			if (indigo_printf(PRIVATE_DATA->handle, "CTxx%02d", (int)X_RATE_ITEM->number.target) && indigo_read(PRIVATE_DATA->handle, response, 1) == 1 && *response == '!')
 				X_RATE_PROPERTY->state = INDIGO_OK_STATE;
 			else
 				X_RATE_PROPERTY->state = INDIGO_ALERT_STATE;
 			INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> %s", PRIVATE_DATA->handle, response));
 			tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+			indigo_flush_reader(PRIVATE_DATA->handle);
 			optec_sleep(device);
 			indigo_define_property(device, X_ROTATE_PROPERTY, NULL);
 			CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
@@ -213,6 +217,7 @@ static void rotator_direction_callback(indigo_device *device) {
 	else
 		ROTATOR_DIRECTION_PROPERTY->state = INDIGO_ALERT_STATE;
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	optec_sleep(device);
 	indigo_update_property(device, ROTATOR_DIRECTION_PROPERTY, NULL);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -237,7 +242,9 @@ static void rotator_position_callback(indigo_device *device) {
 						break;
 					}
 					if (indigo_select(PRIVATE_DATA->handle, 10000) > 0) {
-						read(PRIVATE_DATA->handle, response + 1, 10);
+						// rest of the error message, byte by byte while available
+						for (int count = 1; count < 11 && indigo_read(PRIVATE_DATA->handle, response + count, 1) == 1 && indigo_select(PRIVATE_DATA->handle, 10000) > 0; count++)
+							;
 						INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> %s", PRIVATE_DATA->handle, response));
 					}
 				}
@@ -247,6 +254,7 @@ static void rotator_position_callback(indigo_device *device) {
 		}
 	}
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	optec_sleep(device);
 	indigo_update_property(device, ROTATOR_POSITION_PROPERTY, NULL);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -273,7 +281,9 @@ static void rotator_home_callback(indigo_device *device) {
 						break;
 					}
 					if (indigo_select(PRIVATE_DATA->handle, 10000) > 0) {
-						read(PRIVATE_DATA->handle, response + 1, 10);
+						// rest of the error message, byte by byte while available
+						for (int count = 1; count < 11 && indigo_read(PRIVATE_DATA->handle, response + count, 1) == 1 && indigo_select(PRIVATE_DATA->handle, 10000) > 0; count++)
+							;
 						INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> %s", PRIVATE_DATA->handle, response));
 					}
 				}
@@ -284,6 +294,7 @@ static void rotator_home_callback(indigo_device *device) {
 		}
 	}
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	optec_sleep(device);
 	indigo_update_property(device, ROTATOR_POSITION_PROPERTY, NULL);
 	indigo_update_property(device, X_HOME_PROPERTY, NULL);
@@ -293,12 +304,13 @@ static void rotator_home_callback(indigo_device *device) {
 static void rotator_rate_callback(indigo_device *device) {
 	char response[16] = { 0 };
 	pthread_mutex_lock(&PRIVATE_DATA->mutex);
-	if (optec_wakeup(device) && indigo_printf(PRIVATE_DATA->handle, "CTxx%02d", (int)X_RATE_ITEM->number.target) && read(PRIVATE_DATA->handle, response, 15) == 1 && *response == '!')
+	if (optec_wakeup(device) && indigo_printf(PRIVATE_DATA->handle, "CTxx%02d", (int)X_RATE_ITEM->number.target) && indigo_read(PRIVATE_DATA->handle, response, 1) == 1 && *response == '!')
 		X_RATE_PROPERTY->state = INDIGO_OK_STATE;
 	else
 		X_RATE_PROPERTY->state = INDIGO_ALERT_STATE;
 	INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> %s", PRIVATE_DATA->handle, response));
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	optec_sleep(device);
 	indigo_update_property(device, X_RATE_PROPERTY, NULL);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -308,12 +320,13 @@ static void rotator_rotate_callback(indigo_device *device) {
 	char response[16] = { 0 };
 	pthread_mutex_lock(&PRIVATE_DATA->mutex);
 	int value = X_ROTATE_ITEM->number.target > 0 ? (int)X_ROTATE_ITEM->number.target : 10 - (int)X_ROTATE_ITEM->number.target;
-	if (optec_wakeup(device) && indigo_printf(PRIVATE_DATA->handle, "CXxx%02d", value) && read(PRIVATE_DATA->handle, response, 15) == 1 && *response == '!')
+	if (optec_wakeup(device) && indigo_printf(PRIVATE_DATA->handle, "CXxx%02d", value) && indigo_read(PRIVATE_DATA->handle, response, 1) == 1 && *response == '!')
 		X_ROTATE_PROPERTY->state = INDIGO_OK_STATE;
 	else
 		X_ROTATE_PROPERTY->state = INDIGO_ALERT_STATE;
 	INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> %s", PRIVATE_DATA->handle, response));
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	optec_sleep(device);
 	X_ROTATE_ITEM->number.target = 0;
 	indigo_update_property(device, X_ROTATE_PROPERTY, NULL);
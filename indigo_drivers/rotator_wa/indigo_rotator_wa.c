@@ -141,6 +141,7 @@ bool wr_parse_status(char *response, wr_status_t *status) {
 
 static bool wa_command(indigo_device *device, char *command, char *response, int max) {
 	tcflush(PRIVATE_DATA->handle, TCIOFLUSH);
+	indigo_flush_reader(PRIVATE_DATA->handle);
 	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 	indigo_write(PRIVATE_DATA->handle, "\n", 1);
 	if (response != NULL) {
@@ -264,7 +265,7 @@ static void rotator_connection_handler(indigo_device *device) {
 						PRIVATE_DATA->steps_degree = 1199;
 					} else {
 						INDIGO_DRIVER_ERROR(DRIVER_NAME, "Rotator not detected");
-						close(PRIVATE_DATA->handle);
+						indigo_close_reader(PRIVATE_DATA->handle);
 						PRIVATE_DATA->handle = 0;
 					}
 					ROTATOR_POSITION_ITEM->number.value = ROTATOR_POSITION_ITEM->number.target = indigo_range360(status.position + ROTATOR_POSITION_OFFSET_ITEM->number.value);
@@ -283,12 +284,12 @@ static void rotator_connection_handler(indigo_device *device) {
 					indigo_define_property(device, X_SET_ZERO_POSITION_PROPERTY, NULL);
 				} else {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Rotator not detected");
-					close(PRIVATE_DATA->handle);
+					indigo_close_reader(PRIVATE_DATA->handle);
 					PRIVATE_DATA->handle = 0;
 				}
 			} else {
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Rotator not detected");
-				close(PRIVATE_DATA->handle);
+				indigo_close_reader(PRIVATE_DATA->handle);
 				PRIVATE_DATA->handle = 0;
 			}
 		}
@@ -307,7 +308,7 @@ static void rotator_connection_handler(indigo_device *device) {
 		indigo_update_property(device, INFO_PROPERTY, NULL);
 		if (PRIVATE_DATA->handle > 0) {
 			INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected");
-			close(PRIVATE_DATA->handle);
+			indigo_close_reader(PRIVATE_DATA->handle);
 			PRIVATE_DATA->handle = 0;
 		}
 		PRIVATE_DATA->current_position = 0;
@@ -474,8 +475,8 @@ static indigo_result rotator_attach(indigo_device *device) {
 		ROTATOR_BACKLASH_PROPERTY->hidden = false;
 		ROTATOR_BACKLASH_ITEM->number.min = 0;
 		ROTATOR_BACKLASH_ITEM->number.max = 5;
-		strncpy(ROTATOR_BACKLASH_ITEM->label, "Backlash [°]", INDIGO_VALUE_SIZE);
-		strncpy(ROTATOR_BACKLASH_ITEM->number.format, "%g", INDIGO_VALUE_SIZE);
+		indigo_set_label(ROTATOR_BACKLASH_ITEM, "Backlash [°]");
+		indigo_set_number_format(ROTATOR_BACKLASH_ITEM, "%g");
 		DEVICE_PORTS_PROPERTY->hidden = false;
 		DEVICE_PORT_PROPERTY->hidden = false;
 		INFO_PROPERTY->count = 6;
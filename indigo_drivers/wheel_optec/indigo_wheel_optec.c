@@ -56,7 +56,7 @@ static bool optec_open(indigo_device *device) {
 			return true;
 		}
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to initialize");
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 	} else {
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to connect to %s", name);
@@ -82,7 +82,7 @@ static void optec_goto(indigo_device *device) {
 static void optec_close(indigo_device *device) {
 	if (PRIVATE_DATA->handle > 0) {
 		indigo_printf(PRIVATE_DATA->handle, "WEXITS");
-		close(PRIVATE_DATA->handle);
+		indigo_close_reader(PRIVATE_DATA->handle);
 		PRIVATE_DATA->handle = 0;
 		INDIGO_DRIVER_LOG(DRIVER_NAME, "Disconnected from %s", DEVICE_PORT_ITEM->text.value);
 	}
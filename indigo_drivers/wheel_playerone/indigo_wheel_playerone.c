@@ -114,7 +114,7 @@ static indigo_result wheel_attach(indigo_device *device) {
 		INFO_PROPERTY->count = 6;
 		const char *sdk_version = POAGetPWSDKVer();
 		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->text.value, sdk_version);
-		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->label, "SDK version");
+		indigo_set_label(INFO_DEVICE_FW_REVISION_ITEM, "SDK version");
 		indigo_copy_value(INFO_DEVICE_MODEL_ITEM->text.value, PRIVATE_DATA->model);
 
 		// --------------------------------------------------------------------------------- POA_CUSTOM_SUFFIX
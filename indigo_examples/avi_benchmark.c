@@ -0,0 +1,133 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+
+// AVI writer benchmark. 10000 synthetic frames are written by gwavi writer and by a copy of the frame and index writing code
+// of the previous gwavi version (one write() per header field, frame data written directly, legacy idx1 index only).
+//
+// usage: avi_benchmark [frames] [frame size]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_io.h>
+#include <indigo/indigo_avi.h>
+
+#define FILE_NAME		"avi_benchmark.avi"
+#define FRAME_COUNT	10000
+#define FRAME_SIZE	(32 * 1024 + 1)
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// previous writer, stream headers are omitted as they are written once
+
+typedef struct {
+	int handle;
+	long marker;
+	unsigned int *offsets;
+	int offset_count;
+} legacy_avi;
+
+static bool write_int(int handle, uint32_t n) {
+	unsigned char buffer[4] = { n, n >> 8, n >> 16, n >> 24 };
+	return indigo_write(handle, (const char *)buffer, 4);
+}
+
+static bool legacy_open(legacy_avi *avi, int frame_count) {
+	avi->handle = open(FILE_NAME, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	avi->offsets = indigo_safe_malloc(frame_count * sizeof(unsigned int));
+	avi->offset_count = 0;
+	return avi->handle >= 0 && indigo_write(avi->handle, "RIFF", 4) && write_int(avi->handle, 0) && indigo_write(avi->handle, "AVI ", 4) && indigo_write(avi->handle, "LIST", 4) && (avi->marker = lseek(avi->handle, 0, SEEK_CUR)) != -1 && write_int(avi->handle, 0) && indigo_write(avi->handle, "movi", 4);
+}
+
+static bool legacy_add_frame(legacy_avi *avi, unsigned char *buffer, size_t len) {
+	char zero = 0;
+	size_t maxi_pad = len % 4;
+	if (maxi_pad > 0)
+		maxi_pad = 4 - maxi_pad;
+	avi->offsets[avi->offset_count++] = (unsigned int)(len + maxi_pad);
+	if (!indigo_write(avi->handle, "00dc", 4) || !write_int(avi->handle, (unsigned int)(len + maxi_pad)) || !indigo_write(avi->handle, (const char *)buffer, len))
+		return false;
+	for (size_t t = 0; t < maxi_pad; t++) {
+		if (!indigo_write(avi->handle, &zero, 1))
+			return false;
+	}
+	return true;
+}
+
+static bool legacy_close(legacy_avi *avi) {
+	int handle = avi->handle;
+	long t = lseek(handle, 0, SEEK_CUR), marker;
+	bool result = t != -1 && lseek(handle, avi->marker, SEEK_SET) != -1 && write_int(handle, (unsigned int)(t - avi->marker - 4)) && lseek(handle, t, SEEK_SET) != -1;
+	result = result && indigo_write(handle, "idx1", 4) && (marker = lseek(handle, 0, SEEK_CUR)) != -1 && write_int(handle, 0);
+	unsigned int offset = 4;
+	for (int i = 0; result && i < avi->offset_count; i++) {
+		result = indigo_write(handle, "00dc", 4) && write_int(handle, 0x10) && write_int(handle, offset) && write_int(handle, avi->offsets[i]);
+		offset += avi->offsets[i] + 8;
+	}
+	result = result && (t = lseek(handle, 0, SEEK_CUR)) != -1 && lseek(handle, marker, SEEK_SET) != -1 && write_int(handle, (unsigned int)(t - marker - 4));
+	result = result && lseek(handle, 4, SEEK_SET) != -1 && write_int(handle, (unsigned int)(t - 8));
+	close(handle);
+	free(avi->offsets);
+	return result;
+}
+
+static bool run_benchmark(bool legacy, int frame_count, size_t frame_size) {
+	unsigned char *frame = indigo_safe_malloc(frame_size);
+	legacy_avi avi = { 0 };
+	struct gwavi_t *gwavi = NULL;
+	double start = now();
+	bool ok = legacy ? legacy_open(&avi, frame_count) : (gwavi = gwavi_open(FILE_NAME, 640, 480, "MJPG", 10)) != NULL;
+	for (int i = 0; ok && i < frame_count; i++) {
+		// JPEG SOI marker and frame number
+		memset(frame, i, frame_size);
+		frame[0] = 0xFF;
+		frame[1] = 0xD8;
+		ok = legacy ? legacy_add_frame(&avi, frame, frame_size) : gwavi_add_frame(gwavi, frame, frame_size);
+	}
+	ok = (legacy ? legacy_close(&avi) : gwavi_close(gwavi)) && ok;
+	double time = now() - start;
+	unlink(FILE_NAME);
+	free(frame);
+	printf("%-8s %d frames of %zu bytes %.3f s, %.0f frames/s, %.1f MB/s %s\n", legacy ? "previous" : "gwavi", frame_count, frame_size, time, frame_count / time, frame_count * (double)frame_size / time / 1e6, ok ? "OK" : "FAILED");
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	int frame_count = argc > 1 ? atoi(argv[1]) : FRAME_COUNT;
+	size_t frame_size = argc > 2 ? atol(argv[2]) : FRAME_SIZE;
+	if (frame_count < 1 || frame_size < 256) {
+		fprintf(stderr, "usage: %s [frames] [frame size]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	bool ok = run_benchmark(true, frame_count, frame_size);
+	ok = run_benchmark(false, frame_count, frame_size) && ok;
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// AVI writer round trip test. Files with frames smaller and larger than the write buffer are written, read back and RIFF and
+// movi sizes, frame data, OpenDML (ix00) and legacy (idx1) indexes and frame count in the main header are checked.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_avi.h>
+
+#define FILE_NAME	"avi_test.avi"
+
+static uint32_t get_int(const unsigned char *pnt) {
+	return pnt[0] | pnt[1] << 8 | pnt[2] << 16 | (uint32_t)pnt[3] << 24;
+}
+
+static uint64_t get_long(const unsigned char *pnt) {
+	return get_int(pnt) | (uint64_t)get_int(pnt + 4) << 32;
+}
+
+static void fill_frame(unsigned char *frame, int index, size_t size) {
+	for (size_t i = 0; i < size; i++)
+		frame[i] = (unsigned char)(index * 31 + i);
+}
+
+static bool check_frame(const unsigned char *frame, int index, size_t size) {
+	for (size_t i = 0; i < size; i++)
+		if (frame[i] != (unsigned char)(index * 31 + i))
+			return false;
+	return true;
+}
+
+static bool check_movi(const unsigned char *data, long size, long start, long end, int frame_count, size_t frame_size) {
+	int frames = 0, indexed = 0;
+	for (long pos = start; pos + 8 <= end; ) {
+		uint32_t chunk_size = get_int(data + pos + 4);
+		if (pos + 8 + chunk_size > end)
+			return false;
+		if (!memcmp(data + pos, "00dc", 4)) {
+			if (chunk_size != frame_size || !check_frame(data + pos + 8, frames, frame_size))
+				return false;
+			frames++;
+		} else if (!memcmp(data + pos, "ix00", 4)) {
+			// entries point to frame data relative to base offset
+			indexed = get_int(data + pos + 12);
+			uint64_t base = get_long(data + pos + 20);
+			for (int i = 0; i < indexed; i++) {
+				uint64_t offset = base + get_int(data + pos + 32 + 8 * i);
+				if (offset + frame_size > size || get_int(data + pos + 36 + 8 * i) != frame_size || !check_frame(data + offset, i, frame_size))
+					return false;
+			}
+		}
+		pos += 8 + chunk_size + (chunk_size & 1);
+	}
+	return frames == frame_count && indexed == frame_count;
+}
+
+static bool check_file(int frame_count, size_t frame_size) {
+	FILE *file = fopen(FILE_NAME, "rb");
+	if (file == NULL)
+		return false;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	unsigned char *data = indigo_safe_malloc(size);
+	bool ok = fread(data, 1, size, file) == size;
+	fclose(file);
+	uint32_t riff_size = get_int(data + 4);
+	printf("%d frames of %zu bytes: RIFF size %u, file size %ld, ", frame_count, frame_size, riff_size, size);
+	ok = ok && !memcmp(data, "RIFF", 4) && riff_size == size - 8 && !memcmp(data + 8, "AVI ", 4);
+	bool header_ok = false, movi_ok = false, index_ok = false;
+	for (long pos = 12; ok && pos + 8 <= size; ) {
+		uint32_t chunk_size = get_int(data + pos + 4);
+		if (pos + 8 + chunk_size > size) {
+			ok = false;
+			break;
+		}
+		if (!memcmp(data + pos, "LIST", 4) && !memcmp(data + pos + 8, "hdrl", 4)) {
+			// dwTotalFrames of avih
+			header_ok = !memcmp(data + pos + 12, "avih", 4) && get_int(data + pos + 36) == frame_count;
+		} else if (!memcmp(data + pos, "LIST", 4) && !memcmp(data + pos + 8, "movi", 4)) {
+			movi_ok = check_movi(data, size, pos + 12, pos + 8 + chunk_size, frame_count, frame_size);
+			// idx1 offsets are relative to 'movi'
+			long movi = pos + 8;
+			long idx1 = pos + 8 + chunk_size;
+			if (idx1 + 8 <= size && !memcmp(data + idx1, "idx1", 4) && get_int(data + idx1 + 4) == 16 * frame_count) {
+				index_ok = true;
+				for (int i = 0; i < frame_count && index_ok; i++) {
+					long offset = movi + get_int(data + idx1 + 16 + 16 * i);
+					index_ok = offset + 8 + frame_size <= size && !memcmp(data + offset, "00dc", 4) && get_int(data + idx1 + 20 + 16 * i) == frame_size;
+				}
+			}
+		}
+		pos += 8 + chunk_size + (chunk_size & 1);
+	}
+	ok = ok && header_ok && movi_ok && index_ok;
+	printf("%s\n", ok ? "OK" : "FAILED");
+	free(data);
+	return ok;
+}
+
+static bool run_test(int frame_count, size_t frame_size) {
+	unsigned char *frame = indigo_safe_malloc(frame_size);
+	struct gwavi_t *gwavi = gwavi_open(FILE_NAME, 640, 480, "MJPG", 10);
+	bool ok = gwavi != NULL;
+	for (int i = 0; ok && i < frame_count; i++) {
+		fill_frame(frame, i, frame_size);
+		ok = gwavi_add_frame(gwavi, frame, frame_size);
+	}
+	ok = gwavi_close(gwavi) && ok;
+	free(frame);
+	ok = ok && check_file(frame_count, frame_size);
+	unlink(FILE_NAME);
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	// headers still in the write buffer
+	bool ok = run_test(10, 1001);
+	// headers flushed by frames
+	ok = run_test(100, 100001) && ok;
+	// frames larger than the write buffer are written directly
+	ok = run_test(3, GWAVI_BUFFER_SIZE + 1001) && ok;
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// Base64 codec check and benchmark. Random data of all lengths up to FUZZ_SIZE at random alignments are encoded and compared
+// with plain RFC 4648 encoder, decoded back (also with line breaks) and finally encode and decode throughput is measured.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_base64.h>
+
+#define FUZZ_SIZE			4096
+#define LINE_LENGTH		76
+#define BENCHMARK_SIZE	(64 * 1024 * 1024)
+#define BENCHMARK_COUNT	10
+
+static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long reference_encode(char *out, const unsigned char *in, long length) {
+	long j = 0;
+	for (long i = 0; i < length; i += 3) {
+		uint32_t n = in[i] << 16;
+		if (i + 1 < length)
+			n |= in[i + 1] << 8;
+		if (i + 2 < length)
+			n |= in[i + 2];
+		out[j++] = digits[n >> 18];
+		out[j++] = digits[(n >> 12) & 0x3F];
+		out[j++] = i + 1 < length ? digits[(n >> 6) & 0x3F] : '=';
+		out[j++] = i + 2 < length ? digits[n & 0x3F] : '=';
+	}
+	out[j] = 0;
+	return j;
+}
+
+static bool check_length(long length, unsigned char *data, char *expected, unsigned char *encoded, unsigned char *decoded) {
+	// SIMD kernels must not depend on alignment of either buffer
+	unsigned char *in = data + rand() % 32;
+	unsigned char *out = encoded + rand() % 32;
+	for (long i = 0; i < length; i++)
+		in[i] = rand();
+	long expected_length = reference_encode(expected, in, length);
+	long encoded_length = base64_encode(out, in, length);
+	if (encoded_length != expected_length || memcmp(out, expected, expected_length + 1)) {
+		printf("encoding of %ld bytes FAILED\n", length);
+		return false;
+	}
+	memset(decoded, 0, length);
+	if (base64_decode_fast(decoded, out, encoded_length) != length || memcmp(decoded, in, length)) {
+		printf("decoding of %ld bytes FAILED\n", length);
+		return false;
+	}
+	// legacy clients break lines
+	long wrapped_length = 0;
+	for (long i = 0; i < encoded_length; i++) {
+		if (i > 0 && i % LINE_LENGTH == 0)
+			encoded[wrapped_length++] = '\n';
+		encoded[wrapped_length++] = expected[i];
+	}
+	memset(decoded, 0, length);
+	if (base64_decode_fast_nl(decoded, encoded, wrapped_length) != length || memcmp(decoded, in, length)) {
+		printf("decoding of %ld bytes with line breaks FAILED\n", length);
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, const char * argv[]) {
+	srand(1);
+	unsigned char *data = indigo_safe_malloc(FUZZ_SIZE + 32);
+	char *expected = indigo_safe_malloc(FUZZ_SIZE * 2 + 32);
+	unsigned char *encoded = indigo_safe_malloc(FUZZ_SIZE * 2 + 32);
+	unsigned char *decoded = indigo_safe_malloc(FUZZ_SIZE + 32);
+	bool ok = true;
+	for (long length = 1; length <= FUZZ_SIZE && ok; length++) {
+		for (int i = 0; i < 4 && ok; i++)
+			ok = check_length(length, data, expected, encoded, decoded);
+	}
+	printf("round trip %s\n", ok ? "OK" : "FAILED");
+	free(data);
+	free(expected);
+	free(encoded);
+	free(decoded);
+	data = indigo_safe_malloc(BENCHMARK_SIZE);
+	encoded = indigo_safe_malloc(BENCHMARK_SIZE / 3 * 4 + 8);
+	decoded = indigo_safe_malloc(BENCHMARK_SIZE);
+	for (long i = 0; i < BENCHMARK_SIZE; i++)
+		data[i] = rand();
+	long length = base64_encode(encoded, data, BENCHMARK_SIZE);
+	double start = now();
+	for (int i = 0; i < BENCHMARK_COUNT; i++)
+		base64_encode(encoded, data, BENCHMARK_SIZE);
+	double encode_time = now() - start;
+	start = now();
+	for (int i = 0; i < BENCHMARK_COUNT; i++)
+		base64_decode_fast(decoded, encoded, length);
+	double decode_time = now() - start;
+	printf("encode %.0f MB/s, decode %.0f MB/s\n", BENCHMARK_SIZE / 1048576.0 * BENCHMARK_COUNT / encode_time, BENCHMARK_SIZE / 1048576.0 * BENCHMARK_COUNT / decode_time);
+	ok = ok && !memcmp(data, decoded, BENCHMARK_SIZE);
+	free(data);
+	free(encoded);
+	free(decoded);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
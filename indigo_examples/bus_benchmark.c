@@ -0,0 +1,134 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// Bus routing check and benchmark, change requests are routed to devices attached, detached and reattached in random order.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+
+#define DEVICE_COUNT	200
+#define PROXY_COUNT		5
+#define REQUEST_COUNT	1000000
+
+static int hits[DEVICE_COUNT];
+static indigo_device devices[DEVICE_COUNT];
+static bool attached[DEVICE_COUNT];
+
+static indigo_result change_property(indigo_device *device, indigo_client *client, indigo_property *property) {
+	hits[(long)device->device_context]++;
+	return INDIGO_OK;
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// reference rule, the same as with linear search over all devices
+static bool is_routed(const char *name, indigo_device *device) {
+	if (!strcmp(name, device->name))
+		return true;
+	if (*device->name == '@')
+		return indigo_use_host_suffix ? strstr(name, device->name) != NULL : true;
+	return false;
+}
+
+static bool check_request(const char *name) {
+	bool ok = true;
+	memset(hits, 0, sizeof(hits));
+	indigo_change_switch_property_1(NULL, name, "TEST", "ITEM", true);
+	for (int j = 0; j < DEVICE_COUNT; j++) {
+		int expected = attached[j] && is_routed(name, devices + j) ? 1 : 0;
+		if (hits[j] != expected) {
+			printf("request for '%s' delivered %d times to '%s'\n", name, hits[j], devices[j].name);
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+static bool check_routing(void) {
+	bool ok = true;
+	char name[INDIGO_NAME_SIZE];
+	for (int i = 0; i < DEVICE_COUNT; i++)
+		ok = check_request(devices[i].name) && ok;
+	for (int i = 0; i < PROXY_COUNT; i++) {
+		snprintf(name, sizeof(name), "Camera %s", devices[i].name);
+		ok = check_request(name) && ok;
+	}
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	indigo_start();
+	for (long i = 0; i < DEVICE_COUNT; i++) {
+		indigo_device device = INDIGO_DEVICE_INITIALIZER("", NULL, NULL, change_property, NULL, NULL);
+		devices[i] = device;
+		if (i < PROXY_COUNT)
+			sprintf(devices[i].name, "@ host %ld", i);
+		else
+			sprintf(devices[i].name, "Device %ld", i);
+		devices[i].device_context = (void *)i;
+		devices[i].is_remote = true;
+		indigo_attach_device(devices + i);
+		attached[i] = true;
+	}
+	srand(1);
+	bool ok = check_routing();
+	for (int round = 0; round < 20 && ok; round++) {
+		for (int i = 0; i < DEVICE_COUNT / 4; i++) {
+			int index = rand() % DEVICE_COUNT;
+			if (attached[index])
+				indigo_detach_device(devices + index);
+			else
+				indigo_attach_device(devices + index);
+			attached[index] = !attached[index];
+		}
+		ok = check_routing();
+	}
+	printf("routing %s\n", ok ? "OK" : "FAILED");
+	for (int i = PROXY_COUNT; i < DEVICE_COUNT; i++) {
+		if (!attached[i]) {
+			indigo_attach_device(devices + i);
+			attached[i] = true;
+		}
+	}
+	indigo_property *property = indigo_init_switch_property(NULL, devices[DEVICE_COUNT - 50].name, "TEST", NULL, NULL, INDIGO_IDLE_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 0);
+	double start = now();
+	for (int i = 0; i < REQUEST_COUNT; i++)
+		indigo_change_property(NULL, property);
+	double time = now() - start;
+	printf("%d devices, %.0f targeted change requests/s\n", DEVICE_COUNT, REQUEST_COUNT / time);
+	indigo_release_property(property);
+	for (int i = 0; i < DEVICE_COUNT; i++) {
+		if (attached[i])
+			indigo_detach_device(devices + i);
+	}
+	indigo_stop();
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
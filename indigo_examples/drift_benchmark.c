@@ -0,0 +1,108 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// Donuts drift (FFT correlation) check and benchmark. Synthetic star fields are rendered with known sub-pixel shifts, drift
+// computed from donuts digests is compared with the shift in both directions and digest and drift times are measured.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_raw_utils.h>
+
+#define STAR_COUNT			20
+#define TOLERANCE				0.15
+#define BENCHMARK_COUNT	20
+
+static const int sizes[][2] = { { 640, 480 }, { 1000, 750 }, { 1280, 960 }, { 3008, 2008 } };
+static const double shifts[][2] = { { 0, 0 }, { 1.7, -2.3 }, { -5, 3.5 }, { 12.25, -8.5 } };
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void render(uint16_t *image, int width, int height, double shift_x, double shift_y) {
+	// the same noise and star positions for each frame, only stars are shifted
+	srand(1);
+	for (int i = 0; i < width * height; i++)
+		image[i] = 1000 + rand() % 50;
+	for (int s = 0; s < STAR_COUNT; s++) {
+		double star_x = 50 + rand() % (width - 100) + shift_x;
+		double star_y = 50 + rand() % (height - 100) + shift_y;
+		for (int y = (int)star_y - 8; y <= (int)star_y + 8; y++) {
+			for (int x = (int)star_x - 8; x <= (int)star_x + 8; x++) {
+				double dx = x - star_x, dy = y - star_y;
+				image[y * width + x] += 20000 * exp(-(dx * dx + dy * dy) / 8);
+			}
+		}
+	}
+}
+
+static bool check_size(int width, int height) {
+	uint16_t *reference = indigo_safe_malloc(width * height * sizeof(uint16_t));
+	uint16_t *shifted = indigo_safe_malloc(width * height * sizeof(uint16_t));
+	indigo_frame_digest reference_digest = { 0 }, shifted_digest = { 0 };
+	render(reference, width, height, 0, 0);
+	indigo_donuts_frame_digest(INDIGO_RAW_MONO16, reference, width, height, 0, &reference_digest);
+	bool ok = true;
+	for (int i = 0; i < sizeof(shifts) / sizeof(shifts[0]); i++) {
+		double drift_x, drift_y, back_x, back_y;
+		render(shifted, width, height, shifts[i][0], shifts[i][1]);
+		indigo_donuts_frame_digest(INDIGO_RAW_MONO16, shifted, width, height, 0, &shifted_digest);
+		indigo_calculate_drift(&reference_digest, &shifted_digest, &drift_x, &drift_y);
+		indigo_calculate_drift(&shifted_digest, &reference_digest, &back_x, &back_y);
+		indigo_delete_frame_digest(&shifted_digest);
+		if (fabs(drift_x - shifts[i][0]) > TOLERANCE || fabs(drift_y - shifts[i][1]) > TOLERANCE || fabs(back_x + drift_x) > TOLERANCE || fabs(back_y + drift_y) > TOLERANCE) {
+			printf("%dx%d shift %.2f, %.2f: drift %.3f, %.3f back %.3f, %.3f FAILED\n", width, height, shifts[i][0], shifts[i][1], drift_x, drift_y, back_x, back_y);
+			ok = false;
+		}
+	}
+	double drift_x, drift_y;
+	double start = now();
+	for (int i = 0; i < BENCHMARK_COUNT; i++) {
+		indigo_donuts_frame_digest(INDIGO_RAW_MONO16, shifted, width, height, 0, &shifted_digest);
+		if (i < BENCHMARK_COUNT - 1)
+			indigo_delete_frame_digest(&shifted_digest);
+	}
+	double digest_time = (now() - start) / BENCHMARK_COUNT;
+	start = now();
+	for (int i = 0; i < BENCHMARK_COUNT * 10; i++)
+		indigo_calculate_drift(&reference_digest, &shifted_digest, &drift_x, &drift_y);
+	double drift_time = (now() - start) / (BENCHMARK_COUNT * 10);
+	printf("%4dx%-4d digest %6.0f us, drift %5.1f us, %s\n", width, height, digest_time * 1e6, drift_time * 1e6, ok ? "OK" : "FAILED");
+	indigo_delete_frame_digest(&shifted_digest);
+	indigo_delete_frame_digest(&reference_digest);
+	free(reference);
+	free(shifted);
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	bool ok = true;
+	for (int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+		ok = check_size(sizes[i][0], sizes[i][1]) && ok;
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
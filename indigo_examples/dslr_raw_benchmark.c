@@ -0,0 +1,189 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+
+// DSLR RAW decoding check and benchmark. Camera files given on the command line (or synthetic CFA DNG files, one 24 MP and one
+// with active area margins) are decoded the way indigo_process_dslr_image() used to do it (image info and pixels from separate
+// libraw contexts, plane copied to newly allocated FITS buffer) and by indigo_dslr_raw_decode() with single reusable context,
+// bayer planes, patterns and image info are compared and decoding times are reported per camera model.
+//
+// usage: dslr_raw_benchmark [file ...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_ccd_driver.h>
+#include <indigo/indigo_dslr_raw.h>
+
+#define REPEAT	5
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// minimal little endian DNG with 16-bit RGGB CFA strip, values longer than 4 bytes are stored behind IFD
+
+typedef struct {
+	unsigned char *buffer;
+	int entry_count;
+	long extra;
+} dng_writer;
+
+static void put_int(unsigned char *pnt, uint32_t value, int size) {
+	for (int i = 0; i < size; i++)
+		pnt[i] = value >> (8 * i);
+}
+
+static void add_entry(dng_writer *writer, uint16_t tag, uint16_t type, uint32_t count, const void *values) {
+	static const int type_size[] = { 0, 1, 1, 2, 4 };
+	unsigned char *entry = writer->buffer + 10 + 12 * writer->entry_count++;
+	int size = type_size[type] * count;
+	put_int(entry, tag, 2);
+	put_int(entry + 2, type, 2);
+	put_int(entry + 4, count, 4);
+	unsigned char *target = entry + 8;
+	if (size > 4) {
+		put_int(entry + 8, (uint32_t)writer->extra, 4);
+		target = writer->buffer + writer->extra;
+		writer->extra += size + (size & 1);
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		if (type == 3)
+			put_int(target + 2 * i, ((const uint16_t *)values)[i], 2);
+		else if (type == 4)
+			put_int(target + 4 * i, ((const uint32_t *)values)[i], 4);
+		else
+			target[i] = ((const uint8_t *)values)[i];
+	}
+}
+
+static void *create_dng(uint32_t width, uint32_t height, const uint32_t *active_area, size_t *size) {
+	int entry_count = active_area ? 19 : 18;
+	long data_offset = 8 + 2 + 12 * entry_count + 4 + 256;
+	*size = data_offset + width * height * 2;
+	dng_writer writer = { indigo_safe_malloc(*size), 0, 8 + 2 + 12 * entry_count + 4 };
+	memcpy(writer.buffer, "II*\0\10\0\0\0", 8);
+	put_int(writer.buffer + 8, entry_count, 2);
+	uint32_t zero = 0, offset = (uint32_t)data_offset, length = width * height * 2, white = 16383;
+	uint16_t pattern_dim[] = { 2, 2 }, bits16 = 16, one16 = 1, cfa16 = 32803;
+	uint8_t pattern[] = { 0, 1, 1, 2 }, version[] = { 1, 4, 0, 0 };
+	add_entry(&writer, 254, 4, 1, &zero);
+	add_entry(&writer, 256, 4, 1, &width);
+	add_entry(&writer, 257, 4, 1, &height);
+	add_entry(&writer, 258, 3, 1, &bits16);
+	add_entry(&writer, 259, 3, 1, &one16);
+	add_entry(&writer, 262, 3, 1, &cfa16);
+	add_entry(&writer, 271, 2, 6, "Canon");
+	add_entry(&writer, 272, 2, 11, "Test Model");
+	add_entry(&writer, 273, 4, 1, &offset);
+	add_entry(&writer, 277, 3, 1, &one16);
+	add_entry(&writer, 278, 4, 1, &height);
+	add_entry(&writer, 279, 4, 1, &length);
+	add_entry(&writer, 284, 3, 1, &one16);
+	add_entry(&writer, 33421, 3, 2, pattern_dim);
+	add_entry(&writer, 33422, 1, 4, pattern);
+	add_entry(&writer, 50706, 1, 4, version);
+	add_entry(&writer, 50708, 2, 17, "Canon Test Model");
+	add_entry(&writer, 50717, 4, 1, &white);
+	if (active_area)
+		add_entry(&writer, 50829, 4, 4, active_area);
+	uint16_t *data = (uint16_t *)(writer.buffer + data_offset);
+	for (uint32_t i = 0; i < width * height; i++)
+		data[i] = (uint16_t)((i * 2654435761u >> 16) & 0x3FFF);
+	return writer.buffer;
+}
+
+static void *load_file(const char *name, size_t *size) {
+	FILE *file = fopen(name, "rb");
+	if (file == NULL)
+		return NULL;
+	fseek(file, 0, SEEK_END);
+	*size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	void *buffer = indigo_safe_malloc(*size);
+	if (fread(buffer, 1, *size, file) != *size) {
+		free(buffer);
+		buffer = NULL;
+	}
+	fclose(file);
+	return buffer;
+}
+
+static bool run_test(const char *name, void *buffer, size_t size, libraw_data_t *context, void **image, size_t *image_size) {
+	indigo_dslr_raw_image_s previous = { 0 }, decoded = { 0 };
+	indigo_dslr_raw_image_info_s previous_info = { 0 }, decoded_info = { 0 };
+	double previous_time = 0, decode_time = 0;
+	bool ok = true;
+	for (int i = 0; ok && i < REPEAT; i++) {
+		double start = now();
+		ok = indigo_dslr_raw_image_info(buffer, size, &previous_info) == LIBRAW_SUCCESS && indigo_dslr_raw_process_image(buffer, size, &previous) == LIBRAW_SUCCESS;
+		void *fits = ok ? indigo_alloc_blob_buffer(previous.size + FITS_HEADER_SIZE) : NULL;
+		if (fits) {
+			memcpy((char *)fits + FITS_HEADER_SIZE, previous.data, previous.size);
+			free(fits);
+		}
+		previous_time += now() - start;
+		start = now();
+		ok = ok && indigo_dslr_raw_decode(context, buffer, size, image, image_size, FITS_HEADER_SIZE, &decoded, &decoded_info) == LIBRAW_SUCCESS;
+		decode_time += now() - start;
+		ok = ok && previous.width == decoded.width && previous.height == decoded.height && previous.size == decoded.size && !strcmp(previous.bayer_pattern, decoded.bayer_pattern);
+		ok = ok && decoded.data == (char *)*image + FITS_HEADER_SIZE && !memcmp(previous.data, decoded.data, previous.size) && !memcmp(&previous_info, &decoded_info, sizeof(previous_info));
+		indigo_safe_free(previous.data);
+		previous.data = NULL;
+	}
+	printf("%s: %s %s %dx%d %s, per frame contexts %.1f ms, reusable context %.1f ms %s\n", name, decoded_info.camera_make, decoded_info.camera_model, decoded.width, decoded.height, decoded.bayer_pattern, previous_time * 1000 / REPEAT, decode_time * 1000 / REPEAT, ok ? "OK" : "FAILED");
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	libraw_data_t *context = indigo_dslr_raw_init_context();
+	void *image = NULL;
+	size_t image_size = 0, size;
+	bool ok = context != NULL;
+	if (argc > 1) {
+		for (int i = 1; ok && i < argc; i++) {
+			void *buffer = load_file(argv[i], &size);
+			if (buffer == NULL) {
+				printf("%s can't be read FAILED\n", argv[i]);
+				ok = false;
+				break;
+			}
+			ok = run_test(argv[i], buffer, size, context, &image, &image_size);
+			free(buffer);
+		}
+	} else {
+		static const uint32_t active_area[] = { 9, 17, 709, 1017 };
+		void *buffer = create_dng(6000, 4000, NULL, &size);
+		ok = ok && run_test("synthetic 24 MP", buffer, size, context, &image, &image_size);
+		free(buffer);
+		buffer = create_dng(1024, 716, active_area, &size);
+		ok = ok && run_test("synthetic with margins", buffer, size, context, &image, &image_size);
+		free(buffer);
+	}
+	indigo_dslr_raw_release_context(context);
+	free(image);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// Filter agent property cache check and benchmark. Properties of a selected wheel are fed to the filter client callbacks
+// the same way the bus does it, the agent copies are checked and update and indigo_filter_cached_property() times are measured.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_filter.h>
+
+#define PROPERTY_COUNT	1000
+#define UPDATE_COUNT		200000
+#define LOOKUP_COUNT		1000000
+
+static indigo_property *properties[PROPERTY_COUNT];
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static indigo_result agent_attach(indigo_device *device) {
+	return indigo_filter_device_attach(device, "Benchmark", 0x0001, 0);
+}
+
+static indigo_device agent_device = INDIGO_DEVICE_INITIALIZER("Benchmark Agent", agent_attach, indigo_filter_enumerate_properties, indigo_filter_change_property, NULL, indigo_filter_device_detach);
+
+static indigo_client agent_client = {
+	"Benchmark Agent", false, NULL, INDIGO_OK, INDIGO_VERSION_CURRENT, NULL,
+	indigo_filter_client_attach,
+	indigo_filter_define_property,
+	indigo_filter_update_property,
+	indigo_filter_delete_property,
+	NULL,
+	indigo_filter_client_detach
+};
+
+static indigo_device wheel_device = INDIGO_DEVICE_INITIALIZER("Benchmark Wheel", NULL, NULL, NULL, NULL, NULL);
+
+static bool check_cache(int count) {
+	for (int i = 0; i < count; i++) {
+		indigo_property *device_property = NULL, *agent_property = NULL;
+		if (!indigo_filter_cached_property(&agent_device, INDIGO_FILTER_WHEEL_INDEX, properties[i]->name, &device_property, &agent_property))
+			return false;
+		if (strcmp(device_property->name, properties[i]->name) || strcmp(device_property->device, wheel_device.name))
+			return false;
+		// agent copy is renamed with interface prefix and owned by the agent device
+		if (strncmp(agent_property->name, "WHEEL_", 6) || strcmp(agent_property->name + 6, properties[i]->name) || strcmp(agent_property->device, agent_device.name))
+			return false;
+		if (agent_property->items[1].number.value != properties[i]->items[1].number.value || strcmp(agent_property->items[1].label, properties[i]->items[1].label))
+			return false;
+	}
+	return !indigo_filter_cached_property(&agent_device, INDIGO_FILTER_WHEEL_INDEX, "MISSING", NULL, NULL);
+}
+
+static bool run_benchmark(int count) {
+	for (int i = 0; i < count; i++)
+		indigo_filter_define_property(&agent_client, &wheel_device, properties[i], NULL);
+	bool ok = check_cache(count);
+	// delete and define again must leave no stale entry in either hash chain
+	for (int i = 0; i < count; i += 7)
+		indigo_filter_delete_property(&agent_client, &wheel_device, properties[i], NULL);
+	for (int i = 0; i < count && ok; i++)
+		ok = indigo_filter_cached_property(&agent_device, INDIGO_FILTER_WHEEL_INDEX, properties[i]->name, NULL, NULL) == (i % 7 != 0);
+	for (int i = 0; i < count; i += 7)
+		indigo_filter_define_property(&agent_client, &wheel_device, properties[i], NULL);
+	ok = ok && check_cache(count);
+	double start = now();
+	for (int i = 0; i < UPDATE_COUNT; i++) {
+		indigo_property *property = properties[i % count];
+		property->items[1].number.value = i;
+		indigo_filter_update_property(&agent_client, &wheel_device, property, NULL);
+	}
+	double update_time = now() - start;
+	ok = ok && check_cache(count);
+	start = now();
+	int found = 0;
+	for (int i = 0; i < LOOKUP_COUNT; i++)
+		found += indigo_filter_cached_property(&agent_device, INDIGO_FILTER_WHEEL_INDEX, properties[i % count]->name, NULL, NULL);
+	double lookup_time = now() - start;
+	ok = ok && found == LOOKUP_COUNT;
+	printf("%4d properties: update %.0f ns, cached property lookup %.0f ns, %s\n", count, update_time / UPDATE_COUNT * 1e9, lookup_time / LOOKUP_COUNT * 1e9, ok ? "OK" : "FAILED");
+	for (int i = 0; i < count; i++)
+		indigo_filter_delete_property(&agent_client, &wheel_device, properties[i], NULL);
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	indigo_start();
+	indigo_attach_device(&agent_device);
+	agent_client.client_context = agent_device.device_context;
+	indigo_attach_client(&agent_client);
+	// select the wheel without going through device list negotiation
+	strcpy(((indigo_filter_context *)agent_client.client_context)->device_name[INDIGO_FILTER_WHEEL_INDEX], wheel_device.name);
+	for (int i = 0; i < PROPERTY_COUNT; i++) {
+		char name[INDIGO_NAME_SIZE];
+		snprintf(name, sizeof(name), "PROPERTY_%04d", i);
+		properties[i] = indigo_init_number_property(NULL, wheel_device.name, name, "Benchmark", name, INDIGO_OK_STATE, INDIGO_RW_PERM, 2);
+		indigo_init_number_item(properties[i]->items, "A", "A", 0, UPDATE_COUNT, 1, 0);
+		indigo_init_number_item(properties[i]->items + 1, "B", name, 0, UPDATE_COUNT, 1, i);
+	}
+	bool ok = run_benchmark(10);
+	ok = run_benchmark(200) && ok;
+	ok = run_benchmark(PROPERTY_COUNT) && ok;
+	indigo_detach_client(&agent_client);
+	indigo_detach_device(&agent_device);
+	indigo_stop();
+	for (int i = 0; i < PROPERTY_COUNT; i++)
+		indigo_release_property(properties[i]);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
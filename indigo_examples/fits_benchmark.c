@@ -0,0 +1,168 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+
+// RAW to FITS conversion check and benchmark. 16-bit mono and 48-bit RGB INDIGO RAW frames are converted by indigo_raw_to_fits(),
+// samples are read back from the FITS data unit (big endian, BZERO offset, RGB planes) and compared with the RAW input, keywords
+// embedded after RAW data are looked up in the header and the conversion is timed against the per channel loops of the previous
+// implementation. Byte and channel order variants of indigo_raw_to_fits_data() are checked too.
+//
+// usage: fits_benchmark [width height]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_fits.h>
+
+#define WIDTH		6000
+#define HEIGHT	4000
+#define REPEAT	5
+
+#define EXTENSION	"SIMPLE=T;BAYERPAT='RGGB';"
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *create_raw(uint32_t signature, int width, int height, int components, int *size) {
+	// embedded keywords follow the data
+	*size = sizeof(indigo_raw_header) + width * height * components * 2 + strlen(EXTENSION);
+	char *raw = indigo_safe_malloc(*size);
+	memcpy(raw + *size - strlen(EXTENSION), EXTENSION, strlen(EXTENSION));
+	indigo_raw_header *header = (indigo_raw_header *)raw;
+	header->signature = signature;
+	header->width = width;
+	header->height = height;
+	uint16_t *data = (uint16_t *)(raw + sizeof(indigo_raw_header));
+	for (int i = 0; i < width * height * components; i++)
+		data[i] = (uint16_t)(i * 2654435761u >> 16);
+	return raw;
+}
+
+// FITS sample of given channel and pixel, converted back to unsigned value
+
+static uint16_t fits_sample(const char *fits, int pixel_count, int channel, int pixel) {
+	const unsigned char *sample = (const unsigned char *)fits + FITS_RECORD_SIZE + 2 * (channel * pixel_count + pixel);
+	return (uint16_t)(((sample[0] << 8) | sample[1]) + 32768);
+}
+
+static bool check_header(const char *fits, int fits_size, int components) {
+	bool ok = fits_size % FITS_RECORD_SIZE == 0 && !strncmp(fits, "SIMPLE  =", 9) && !strncmp(fits + 80, "BITPIX  =                   16", 30);
+	ok = ok && !strncmp(fits + 160, components == 3 ? "NAXIS   =                    3" : "NAXIS   =                    2", 30);
+	bool bzero = false, keyword = false;
+	for (int i = 0; ok && i < FITS_RECORD_SIZE; i += 80) {
+		bzero = bzero || !strncmp(fits + i, "BZERO   =                32768", 30);
+		keyword = keyword || !strncmp(fits + i, "BAYERPAT= 'RGGB' ", 17);
+	}
+	return ok && bzero && keyword;
+}
+
+// previous implementation, header area is filled with spaces, samples are converted channel by channel
+
+static void previous_raw_to_fits(const char *raw, char *fits, int image_size, int pixel_count, int components) {
+	memset(fits, ' ', image_size);
+	uint16_t *in = (uint16_t *)(raw + sizeof(indigo_raw_header));
+	uint16_t *out_ch0 = (uint16_t *)(fits + FITS_RECORD_SIZE);
+	uint16_t *out_ch1 = out_ch0 + pixel_count;
+	uint16_t *out_ch2 = out_ch1 + pixel_count;
+	for (int i = 0; i < pixel_count; i++) {
+		int value = *in++ - 32768;
+		*out_ch0++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
+		if (components == 3) {
+			value = *in++ - 32768;
+			*out_ch1++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
+			value = *in++ - 32768;
+			*out_ch2++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
+		}
+	}
+}
+
+static bool run_test(const char *name, uint32_t signature, int width, int height, int components) {
+	int raw_size, fits_size = 0;
+	int pixel_count = width * height;
+	char *raw = create_raw(signature, width, height, components, &raw_size);
+	const uint16_t *data = (const uint16_t *)(raw + sizeof(indigo_raw_header));
+	char *fits = NULL;
+	bool ok = indigo_raw_to_fits(raw, raw_size, &fits, &fits_size, NULL) == INDIGO_OK;
+	ok = ok && check_header(fits, fits_size, components);
+	for (int i = 0; ok && i < pixel_count; i++) {
+		for (int c = 0; ok && c < components; c++)
+			ok = fits_sample(fits, pixel_count, c, i) == data[i * components + c];
+	}
+	printf("%s %dx%d round trip %s\n", name, width, height, ok ? "OK" : "FAILED");
+	double time = now();
+	for (int i = 0; i < REPEAT; i++)
+		indigo_raw_to_fits(raw, raw_size, &fits, &fits_size, NULL);
+	time = (now() - time) / REPEAT;
+	char *previous = indigo_safe_malloc(fits_size);
+	double previous_time = now();
+	for (int i = 0; i < REPEAT; i++)
+		previous_raw_to_fits(raw, previous, fits_size, pixel_count, components);
+	previous_time = (now() - previous_time) / REPEAT;
+	ok = ok && !memcmp(fits + FITS_RECORD_SIZE, previous + FITS_RECORD_SIZE, pixel_count * components * 2);
+	printf("%s %dx%d previous %.1f ms, indigo_raw_to_fits %.1f ms, %.0f MB/s %s\n", name, width, height, previous_time * 1000, time * 1000, pixel_count * components * 2 / time / 1e6, ok ? "OK" : "FAILED");
+	free(previous);
+	free(fits);
+	free(raw);
+	return ok;
+}
+
+// big endian and BGR input must give the same data unit as little endian RGB
+
+static bool check_variants(void) {
+	uint16_t rgb[3 * 64], variant[3 * 64], expected[3 * 64], converted[3 * 64];
+	for (int i = 0; i < 3 * 64; i++)
+		rgb[i] = (uint16_t)(i * 997);
+	indigo_raw_to_fits_data(rgb, expected, 64, 2, 3, true, true);
+	bool ok = true;
+	for (int big_endian = 0; big_endian < 2; big_endian++) {
+		for (int bgr = 0; bgr < 2; bgr++) {
+			for (int i = 0; i < 64; i++) {
+				for (int c = 0; c < 3; c++) {
+					uint16_t value = rgb[3 * i + (bgr ? 2 - c : c)];
+					variant[3 * i + c] = big_endian ? (uint16_t)(value << 8 | value >> 8) : value;
+				}
+			}
+			indigo_raw_to_fits_data(variant, converted, 64, 2, 3, !big_endian, !bgr);
+			ok = ok && !memcmp(converted, expected, sizeof(expected));
+		}
+	}
+	printf("byte and channel order variants %s\n", ok ? "OK" : "FAILED");
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	int width = argc > 2 ? atoi(argv[1]) : WIDTH;
+	int height = argc > 2 ? atoi(argv[2]) : HEIGHT;
+	if (width < 1 || height < 1) {
+		fprintf(stderr, "usage: %s [width height]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	bool ok = check_variants();
+	ok = run_test("16-bit mono", INDIGO_RAW_MONO16, width, height, 1) && ok;
+	ok = run_test("48-bit RGB", INDIGO_RAW_RGB48, width, height, 3) && ok;
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
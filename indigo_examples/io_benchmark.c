@@ -0,0 +1,148 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// Serial line reader check and benchmark. LX200 style lines are written to a pty master and read from the slave opened
+// with indigo_open_serial() byte by byte (as indigo_read_line() used to) and with indigo_scanf(), then mixing of buffered
+// reads with indigo_read() and indigo_select() and invalidation of buffered input by indigo_close_reader() are checked.
+//
+// usage: io_benchmark [lines]
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_io.h>
+
+#define LINE_COUNT	20000
+
+static int master;
+static int line_count = LINE_COUNT;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *writer(void *arg) {
+	char line[64];
+	for (int i = 0; i < line_count; i++) {
+		int length = snprintf(line, sizeof(line), "%d#12:34:56#+45*12'34#\r\n", i);
+		if (!indigo_write(master, line, length))
+			break;
+	}
+	return NULL;
+}
+
+static int read_line_bytewise(int handle, char *buffer, int length) {
+	char c;
+	int total_bytes = 0;
+	while (total_bytes < length) {
+		if (read(handle, &c, 1) <= 0)
+			return -1;
+		if (c == '\n')
+			break;
+		if (c != '\r')
+			buffer[total_bytes++] = c;
+	}
+	buffer[total_bytes] = '\0';
+	return total_bytes;
+}
+
+static bool run_benchmark(int handle, bool bytewise) {
+	pthread_t thread;
+	pthread_create(&thread, NULL, writer, NULL);
+	char buffer[128];
+	int ok = 0, value;
+	double start = now();
+	for (int i = 0; i < line_count; i++) {
+		if (bytewise) {
+			if (read_line_bytewise(handle, buffer, sizeof(buffer)) > 0 && sscanf(buffer, "%d#", &value) == 1 && value == i)
+				ok++;
+		} else {
+			if (indigo_scanf(handle, "%d#", &value) == 1 && value == i)
+				ok++;
+		}
+	}
+	double time = now() - start;
+	pthread_join(thread, NULL);
+	printf("%-13s %d lines %.3f s, %.1f us/line %s\n", bytewise ? "byte by byte" : "indigo_scanf", line_count, time, time * 1e6 / line_count, ok == line_count ? "OK" : "FAILED");
+	return ok == line_count;
+}
+
+static bool check_mixed_reads(int handle) {
+	char buffer[16] = { 0 };
+	indigo_write(master, "first\r\nsecond\nthird", 19);
+	usleep(100000);
+	// first line fills input buffer with the rest
+	bool ok = indigo_read_line(handle, buffer, sizeof(buffer)) == 5 && !strcmp(buffer, "first");
+	ok = ok && indigo_select(handle, 0) > 0;
+	ok = ok && indigo_read(handle, buffer, 7) == 7 && !strncmp(buffer, "second\n", 7);
+	ok = ok && indigo_read(handle, buffer, 5) == 5 && !strncmp(buffer, "third", 5);
+	ok = ok && indigo_select(handle, 0) == 0;
+	printf("mixed reads %s\n", ok ? "OK" : "FAILED");
+	return ok;
+}
+
+static bool check_close(const char *name, int *handle) {
+	char buffer[16] = { 0 };
+	indigo_write(master, "old\nstale\n", 10);
+	usleep(100000);
+	bool ok = indigo_read_line(*handle, buffer, sizeof(buffer)) == 3 && !strcmp(buffer, "old");
+	// 'stale' is in the input buffer only, it must not be returned for the reopened handle
+	indigo_close_reader(*handle);
+	*handle = indigo_open_serial_with_speed(name, 115200);
+	indigo_write(master, "new\n", 4);
+	ok = ok && indigo_read_line(*handle, buffer, sizeof(buffer)) == 3 && !strcmp(buffer, "new");
+	printf("reopen %s\n", ok ? "OK" : "FAILED");
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	if (argc > 1)
+		line_count = atoi(argv[1]);
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) || unlockpt(master)) {
+		printf("pty FAILED\n");
+		return EXIT_FAILURE;
+	}
+	char name[128];
+	strncpy(name, ptsname(master), sizeof(name) - 1);
+	int handle = indigo_open_serial_with_speed(name, 115200);
+	if (handle < 0) {
+		printf("%s FAILED\n", name);
+		return EXIT_FAILURE;
+	}
+	bool ok = run_benchmark(handle, true);
+	ok = run_benchmark(handle, false) && ok;
+	ok = check_mixed_reads(handle) && ok;
+	ok = check_close(name, &handle) && ok;
+	indigo_close_reader(handle);
+	close(master);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
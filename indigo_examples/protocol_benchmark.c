@@ -0,0 +1,292 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// Wire protocol check and benchmark. Server and client run in separate processes connected by a socket pair, the same
+// number and BLOB updates and a long text change request are sent over XML and binary protocol and compared on the other side.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_xml.h>
+#include <indigo/indigo_driver_xml.h>
+#include <indigo/indigo_client_xml.h>
+#include <indigo/indigo_binary.h>
+
+#define NUMBER_COUNT	8
+#define UPDATE_COUNT	100000
+#define BLOB_COUNT		20
+#define BLOB_SIZE			(16 * 1024 * 1024)
+#define TEXT_SIZE			100000
+
+static bool use_binary;
+static int sockets[2];
+static int to_server[2];
+
+static unsigned char *blob;
+static char *text;
+
+static indigo_property *number_property;
+static indigo_property *blob_property;
+static indigo_property *text_property;
+
+static volatile long defined_count, update_count, blob_count, blob_bytes;
+static volatile double last_value;
+static volatile bool blob_ok = true;
+static volatile bool text_ok;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void signal_pipe(int *fds) {
+	char c = 1;
+	if (write(fds[1], &c, 1) != 1)
+		exit(EXIT_FAILURE);
+}
+
+static void wait_pipe(int *fds) {
+	char c;
+	if (read(fds[0], &c, 1) != 1)
+		exit(EXIT_FAILURE);
+}
+
+// server side device
+
+static indigo_result device_attach(indigo_device *device) {
+	number_property = indigo_init_number_property(NULL, device->name, "NUMBERS", "Main", "Numbers", INDIGO_OK_STATE, INDIGO_RW_PERM, NUMBER_COUNT);
+	for (int i = 0; i < NUMBER_COUNT; i++) {
+		char name[INDIGO_NAME_SIZE];
+		sprintf(name, "NUMBER_%d", i);
+		indigo_init_number_item(number_property->items + i, name, name, -1e9, 1e9, 1, 0);
+	}
+	blob_property = indigo_init_blob_property(NULL, device->name, "IMAGE", "Main", "Image", INDIGO_OK_STATE, 1);
+	indigo_init_blob_item(blob_property->items, "IMAGE", "Image");
+	text_property = indigo_init_text_property(NULL, device->name, "TEXT", "Main", "Text", INDIGO_OK_STATE, INDIGO_RW_PERM, 1);
+	indigo_init_text_item(text_property->items, "VALUE", "Value", "");
+	return INDIGO_OK;
+}
+
+static indigo_result device_enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property) {
+	indigo_define_property(device, number_property, NULL);
+	indigo_define_property(device, blob_property, NULL);
+	indigo_define_property(device, text_property, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result device_change_property(indigo_device *device, indigo_client *client, indigo_property *property) {
+	if (indigo_property_match(text_property, property)) {
+		indigo_property_copy_values(text_property, property, false);
+		text_ok = !strcmp(indigo_get_text_item_value(text_property->items), text);
+		signal_pipe(to_server);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result device_detach(indigo_device *device) {
+	indigo_delete_property(device, number_property, NULL);
+	indigo_delete_property(device, blob_property, NULL);
+	indigo_delete_property(device, text_property, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_device device = INDIGO_DEVICE_INITIALIZER("Benchmark", device_attach, device_enumerate_properties, device_change_property, NULL, device_detach);
+
+static void *server_thread(void *data) {
+	indigo_client *adapter;
+	if (use_binary) {
+		if (!indigo_binary_accept(sockets[0]))
+			exit(EXIT_FAILURE);
+		adapter = indigo_binary_device_adapter(sockets[0], sockets[0]);
+	} else {
+		adapter = indigo_xml_device_adapter(dup(sockets[0]), sockets[0]);
+	}
+	indigo_attach_client(adapter);
+	if (use_binary)
+		indigo_binary_parse(NULL, adapter);
+	else
+		indigo_xml_parse(NULL, adapter);
+	indigo_detach_client(adapter);
+	if (use_binary)
+		indigo_release_binary_device_adapter(adapter);
+	else
+		indigo_release_xml_device_adapter(adapter);
+	return NULL;
+}
+
+static void run_server(void) {
+	pthread_t thread;
+	indigo_start();
+	indigo_attach_device(&device);
+	pthread_create(&thread, NULL, server_thread, NULL);
+	wait_pipe(to_server);
+	for (int i = 1; i <= UPDATE_COUNT; i++) {
+		for (int j = 0; j < NUMBER_COUNT; j++)
+			number_property->items[j].number.value = i + j;
+		indigo_update_property(&device, number_property, NULL);
+	}
+	blob_property->items->blob.value = blob;
+	blob_property->items->blob.size = BLOB_SIZE;
+	strcpy(blob_property->items->blob.format, ".raw");
+	for (int i = 0; i < BLOB_COUNT; i++) {
+		wait_pipe(to_server);
+		indigo_update_property(&device, blob_property, NULL);
+	}
+	// the last signal comes from device_change_property()
+	wait_pipe(to_server);
+	blob_property->items->blob.value = NULL;
+	indigo_detach_device(&device);
+	pthread_join(thread, NULL);
+	indigo_stop();
+	exit(text_ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+// client side
+
+static indigo_result client_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	if (property->type == INDIGO_BLOB_VECTOR)
+		indigo_enable_blob(client, property, INDIGO_ENABLE_BLOB_ALSO);
+	defined_count++;
+	return INDIGO_OK;
+}
+
+static indigo_result client_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	if (!strcmp(property->name, "NUMBERS")) {
+		update_count++;
+		last_value = property->items[NUMBER_COUNT - 1].number.value;
+	} else if (!strcmp(property->name, "IMAGE") && property->state == INDIGO_OK_STATE) {
+		if (property->items->blob.size != BLOB_SIZE || memcmp(property->items->blob.value, blob, BLOB_SIZE))
+			blob_ok = false;
+		blob_bytes += property->items->blob.size;
+		blob_count++;
+	}
+	return INDIGO_OK;
+}
+
+static indigo_client client = {
+	"Benchmark", false, NULL, INDIGO_OK, INDIGO_VERSION_CURRENT, NULL,
+	NULL,
+	client_define_property,
+	client_update_property,
+	NULL,
+	NULL,
+	NULL
+};
+
+static void *client_thread(void *data) {
+	indigo_device *adapter;
+	if (use_binary) {
+		if (!indigo_binary_connect(sockets[1]))
+			exit(EXIT_FAILURE);
+		adapter = indigo_binary_client_adapter("server", "http://localhost:7624", sockets[1], sockets[1]);
+	} else {
+		adapter = indigo_xml_client_adapter("server", "http://localhost:7624", sockets[1], sockets[1]);
+	}
+	indigo_attach_device(adapter);
+	if (use_binary)
+		indigo_binary_parse(adapter, NULL);
+	else
+		indigo_xml_parse(adapter, NULL);
+	indigo_detach_device(adapter);
+	return NULL;
+}
+
+static void run_client(void) {
+	const char *protocol = use_binary ? "binary" : "xml";
+	pthread_t thread;
+	indigo_start();
+	indigo_attach_client(&client);
+	pthread_create(&thread, NULL, client_thread, NULL);
+	while (defined_count < 3)
+		usleep(1000);
+	// give enable BLOB request time to get to the server
+	usleep(200000);
+	signal_pipe(to_server);
+	while (update_count == 0)
+		usleep(10);
+	double start = now();
+	while (last_value != UPDATE_COUNT + NUMBER_COUNT - 1)
+		usleep(10);
+	double time = now() - start;
+	// updates queued behind slow link may be coalesced, the rate is measured until the last value is delivered
+	printf("%-6s %d number updates sent, %ld received, %.0f updates/s\n", protocol, UPDATE_COUNT, update_count, UPDATE_COUNT / time);
+	start = now();
+	for (int i = 1; i <= BLOB_COUNT; i++) {
+		signal_pipe(to_server);
+		while (blob_count < i)
+			usleep(10);
+	}
+	time = now() - start;
+	printf("%-6s %d BLOBs %s, %.1f MB/s\n", protocol, BLOB_COUNT, blob_ok ? "OK" : "FAILED", blob_bytes / 1048576.0 / time);
+	const char *names[] = { "VALUE" };
+	const char *values[] = { text };
+	indigo_change_text_property(&client, "Benchmark @ server", "TEXT", 1, names, values);
+	shutdown(sockets[1], SHUT_WR);
+	pthread_join(thread, NULL);
+	indigo_stop();
+	exit(blob_ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+static bool run_benchmark(bool binary) {
+	use_binary = binary;
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) || pipe(to_server))
+		return false;
+	fflush(stdout);
+	pid_t server = fork();
+	if (server == 0) {
+		close(sockets[1]);
+		run_server();
+	}
+	pid_t client = fork();
+	if (client == 0) {
+		close(sockets[0]);
+		run_client();
+	}
+	close(sockets[0]);
+	close(sockets[1]);
+	int server_status = EXIT_FAILURE, client_status = EXIT_FAILURE;
+	waitpid(client, &client_status, 0);
+	waitpid(server, &server_status, 0);
+	bool ok = WIFEXITED(client_status) && WEXITSTATUS(client_status) == EXIT_SUCCESS && WIFEXITED(server_status) && WEXITSTATUS(server_status) == EXIT_SUCCESS;
+	printf("%-6s %s\n", binary ? "binary" : "xml", ok ? "OK" : "FAILED");
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	blob = indigo_safe_malloc(BLOB_SIZE);
+	for (long i = 0; i < BLOB_SIZE; i++)
+		blob[i] = (unsigned char)(i * 7 + (i >> 11));
+	text = indigo_safe_malloc(TEXT_SIZE);
+	memset(text, 'x', TEXT_SIZE - 1);
+	bool ok = run_benchmark(false);
+	ok = run_benchmark(true) && ok;
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
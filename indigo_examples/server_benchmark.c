@@ -0,0 +1,310 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// Network server load test. Server with simulator drivers (and echo device) runs in a child process, N concurrent clients
+// send HTTP resource requests over keep-alive connections and XML change requests and p50/p99 round trip latencies are reported.
+//
+// usage: server_benchmark [-c clients] [-r requests] [-p port] [driver ...]
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_client.h>
+#include <indigo/indigo_server_tcp.h>
+
+#define CLIENT_COUNT		32
+#define REQUEST_COUNT		200
+#define PORT						7625
+#define RESOURCE_SIZE		4096
+#define BUFFER_SIZE			65536
+
+static const char *simulators[] = { "indigo_ccd_simulator", "indigo_mount_simulator", "indigo_dome_simulator", "indigo_gps_simulator", "indigo_rotator_simulator" };
+
+static int client_count = CLIENT_COUNT;
+static int request_count = REQUEST_COUNT;
+static int port = PORT;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// server side, echo device returns each text change in an update to all clients
+
+static indigo_property *echo_property;
+
+static indigo_result echo_attach(indigo_device *device) {
+	echo_property = indigo_init_text_property(NULL, device->name, "ECHO", "Main", "Echo", INDIGO_OK_STATE, INDIGO_RW_PERM, 1);
+	indigo_init_text_item(echo_property->items, "VALUE", "Value", "");
+	return INDIGO_OK;
+}
+
+static indigo_result echo_enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property) {
+	if (indigo_property_match(echo_property, property))
+		indigo_define_property(device, echo_property, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result echo_change_property(indigo_device *device, indigo_client *client, indigo_property *property) {
+	if (indigo_property_match(echo_property, property)) {
+		indigo_property_copy_values(echo_property, property, false);
+		indigo_update_property(device, echo_property, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result echo_detach(indigo_device *device) {
+	indigo_delete_property(device, echo_property, NULL);
+	indigo_release_property(echo_property);
+	return INDIGO_OK;
+}
+
+static indigo_device echo_device = INDIGO_DEVICE_INITIALIZER("Benchmark", echo_attach, echo_enumerate_properties, echo_change_property, NULL, echo_detach);
+
+static void run_server(const char **drivers, int driver_count) {
+	static unsigned char resource[RESOURCE_SIZE];
+	indigo_use_bonjour = false;
+	indigo_server_tcp_port = port;
+	indigo_start();
+	indigo_attach_device(&echo_device);
+	for (int i = 0; i < driver_count; i++) {
+		if (indigo_load_driver(drivers[i], true, NULL) != INDIGO_OK)
+			fprintf(stderr, "%s can't be loaded, continuing without it\n", drivers[i]);
+	}
+	indigo_server_add_resource("/benchmark", resource, RESOURCE_SIZE, "application/octet-stream");
+	indigo_server_start(NULL);
+	exit(EXIT_SUCCESS);
+}
+
+// client side
+
+typedef struct {
+	int id;
+	bool xml;
+	bool ok;
+	double *latencies;
+	char buffer[BUFFER_SIZE];
+	long length;
+} client_data;
+
+static int connect_server(void) {
+	struct sockaddr_in address = { 0 };
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	for (int retry = 0; retry < 500; retry++) {
+		int handle = socket(AF_INET, SOCK_STREAM, 0);
+		if (handle < 0)
+			return -1;
+		if (connect(handle, (struct sockaddr *)&address, sizeof(address)) == 0) {
+			int one = 1;
+			setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+			return handle;
+		}
+		close(handle);
+		usleep(10000);
+	}
+	return -1;
+}
+
+static bool send_string(int handle, const char *string) {
+	long length = strlen(string);
+	while (length > 0) {
+		long written = write(handle, string, length);
+		if (written <= 0)
+			return false;
+		string += written;
+		length -= written;
+	}
+	return true;
+}
+
+// reads until pattern is received, data before the end of pattern are consumed, the rest is kept in the buffer
+
+static bool receive_pattern(int handle, client_data *data, const char *pattern) {
+	long pattern_length = strlen(pattern);
+	while (true) {
+		char *found = memmem(data->buffer, data->length, pattern, pattern_length);
+		if (found) {
+			long consumed = found - data->buffer + pattern_length;
+			memmove(data->buffer, data->buffer + consumed, data->length - consumed);
+			data->length -= consumed;
+			return true;
+		}
+		// updates for other clients are skipped, only a possible prefix of the pattern is kept
+		if (data->length >= BUFFER_SIZE / 2) {
+			memmove(data->buffer, data->buffer + data->length - pattern_length, pattern_length);
+			data->length = pattern_length;
+		}
+		long count = read(handle, data->buffer + data->length, BUFFER_SIZE - data->length);
+		if (count <= 0)
+			return false;
+		data->length += count;
+	}
+}
+
+static bool receive_bytes(int handle, client_data *data, long size) {
+	while (data->length < size) {
+		long count = read(handle, data->buffer + data->length, BUFFER_SIZE - data->length);
+		if (count <= 0)
+			return false;
+		data->length += count;
+	}
+	memmove(data->buffer, data->buffer + size, data->length - size);
+	data->length -= size;
+	return true;
+}
+
+static void http_client(int handle, client_data *data) {
+	for (int i = 0; i < request_count; i++) {
+		double start = now();
+		if (!send_string(handle, "GET /benchmark HTTP/1.1\r\nHost: localhost\r\n\r\n") || !receive_pattern(handle, data, "Content-Length: ") || !receive_pattern(handle, data, "\r\n\r\n"))
+			return;
+		if (!receive_bytes(handle, data, RESOURCE_SIZE))
+			return;
+		data->latencies[i] = now() - start;
+	}
+	data->ok = true;
+}
+
+static void xml_client(int handle, client_data *data) {
+	char request[256], pattern[64];
+	if (!send_string(handle, "<getProperties version='2.0' device='Benchmark'/>\n") || !receive_pattern(handle, data, "</defTextVector>"))
+		return;
+	for (int i = 0; i < request_count; i++) {
+		// every client gets updates of all clients, the unique value identifies the response to this request
+		snprintf(pattern, sizeof(pattern), ">client %d request %d<", data->id, i);
+		snprintf(request, sizeof(request), "<newTextVector device='Benchmark' name='ECHO'><oneText name='VALUE'>client %d request %d</oneText></newTextVector>\n", data->id, i);
+		double start = now();
+		if (!send_string(handle, request) || !receive_pattern(handle, data, pattern))
+			return;
+		data->latencies[i] = now() - start;
+	}
+	data->ok = true;
+}
+
+static void *client_thread(client_data *data) {
+	int handle = connect_server();
+	if (handle < 0)
+		return NULL;
+	if (data->xml)
+		xml_client(handle, data);
+	else
+		http_client(handle, data);
+	close(handle);
+	return NULL;
+}
+
+static int compare_latencies(const void *a, const void *b) {
+	double difference = *(const double *)a - *(const double *)b;
+	return difference < 0 ? -1 : difference > 0;
+}
+
+static bool report(const char *name, client_data *data, bool xml) {
+	int count = 0;
+	bool ok = true;
+	double *latencies = indigo_safe_malloc(client_count * request_count * sizeof(double));
+	for (int i = 0; i < client_count; i++) {
+		if (data[i].xml != xml)
+			continue;
+		ok = ok && data[i].ok;
+		memcpy(latencies + count, data[i].latencies, request_count * sizeof(double));
+		count += request_count;
+	}
+	qsort(latencies, count, sizeof(double), compare_latencies);
+	printf("%-4s %d requests: p50 %.3f ms, p99 %.3f ms, max %.3f ms, %s\n", name, count, latencies[count / 2] * 1000, latencies[count * 99 / 100] * 1000, latencies[count - 1] * 1000, ok ? "OK" : "FAILED");
+	free(latencies);
+	return ok;
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	const char **drivers = simulators;
+	int driver_count = sizeof(simulators) / sizeof(simulators[0]);
+	int i = 1;
+	for (; i < argc - 1 && argv[i][0] == '-'; i += 2) {
+		if (!strcmp(argv[i], "-c"))
+			client_count = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-r"))
+			request_count = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-p"))
+			port = atoi(argv[i + 1]);
+	}
+	if (i < argc) {
+		drivers = argv + i;
+		driver_count = argc - i;
+	}
+	if (client_count < 2 || request_count < 1) {
+		fprintf(stderr, "usage: %s [-c clients] [-r requests] [-p port] [driver ...]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	fflush(stdout);
+	pid_t server = fork();
+	if (server == 0)
+		run_server(drivers, driver_count);
+	// wait for server and simulators to come up
+	int handle = connect_server();
+	if (handle < 0) {
+		kill(server, SIGKILL);
+		waitpid(server, NULL, 0);
+		printf("server FAILED\n");
+		return EXIT_FAILURE;
+	}
+	close(handle);
+	// half of the clients are HTTP, half XML
+	client_data *data = indigo_safe_malloc(client_count * sizeof(client_data));
+	pthread_t *threads = indigo_safe_malloc(client_count * sizeof(pthread_t));
+	double start = now();
+	for (i = 0; i < client_count; i++) {
+		data[i].id = i;
+		data[i].xml = i % 2;
+		data[i].latencies = indigo_safe_malloc(request_count * sizeof(double));
+		pthread_create(threads + i, NULL, (void *(*)(void *))client_thread, data + i);
+	}
+	for (i = 0; i < client_count; i++)
+		pthread_join(threads[i], NULL);
+	double time = now() - start;
+	printf("%d clients, %d requests each, %.2f s, %.0f requests/s\n", client_count, request_count, time, client_count * request_count / time);
+	bool ok = report("http", data, false);
+	ok = report("xml", data, true) && ok;
+	kill(server, SIGKILL);
+	waitpid(server, NULL, 0);
+	for (i = 0; i < client_count; i++)
+		free(data[i].latencies);
+	free(data);
+	free(threads);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
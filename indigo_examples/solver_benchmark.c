@@ -0,0 +1,186 @@
+// Copyright (c) 2026 agent <agent@local>
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// Native plate solver check and benchmark. Star fields are rendered from the bundled Hipparcos catalog the same way
+// as CCD simulator guider camera does it, solved with different hints and compared with the known field center.
+//
+// usage: solver_benchmark [blind]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_raw_utils.h>
+#include <indigo/indigocat/indigocat_star.h>
+
+#include "agent_native_solver/indigo_agent_native_solver.h"
+
+// star detection parameters used by the agent
+#define STAR_RADIUS		8
+#define MAX_IMAGE_STARS	100
+#define MIN_IMAGE_STARS	5
+
+#define FRAME_WIDTH		1280
+#define FRAME_HEIGHT	960
+#define FIELD_COUNT		40
+#define MAX_ERROR			60
+
+static int mags[] = { 760000, 305000, 122000, 49000, 20000, 7800, 3100, 1200, 500 };
+
+typedef struct {
+	double ra, dec;
+	double fov;
+	double angle;
+	bool flip;
+} field;
+
+static void render_field(uint16_t *image, field *f, unsigned seed) {
+	for (int i = 0; i < FRAME_WIDTH * FRAME_HEIGHT; i++)
+		image[i] = 1000 + rand_r(&seed) % 60;
+	double h2r = M_PI / 12, d2r = M_PI / 180;
+	double mount_ra = f->ra * h2r, mount_dec = f->dec * d2r;
+	double cos_mount_dec = cos(mount_dec), sin_mount_dec = sin(mount_dec);
+	double ppr = FRAME_HEIGHT / f->fov / d2r;
+	double ppr_cos = ppr * cos(f->angle * d2r), ppr_sin = ppr * sin(f->angle * d2r);
+	for (indigocat_star_entry *star_data = indigocat_get_star_data(); star_data->hip; star_data++) {
+		double ra = star_data->ra * h2r, dec = star_data->dec * d2r;
+		double cos_dec = cos(dec), sin_dec = sin(dec);
+		double cos_ra_ra = cos(ra - mount_ra);
+		double ccc_ss = cos_mount_dec * cos_dec * cos_ra_ra + sin_mount_dec * sin_dec;
+		if (ccc_ss < cos(f->fov * d2r * 2))
+			continue;
+		double sx = cos_dec * sin(ra - mount_ra) / ccc_ss;
+		double sy = (sin_mount_dec * cos_dec * cos_ra_ra - cos_mount_dec * sin_dec) / ccc_ss;
+		double x = ppr_cos * sx + ppr_sin * sy + FRAME_WIDTH / 2;
+		double y = ppr_cos * sy - ppr_sin * sx + FRAME_HEIGHT / 2;
+		if (f->flip)
+			x = FRAME_WIDTH - x;
+		// centroid noise up to 0.25px
+		x += (rand_r(&seed) % 100 - 50) / 200.0;
+		y += (rand_r(&seed) % 100 - 50) / 200.0;
+		if (x < 0 || x >= FRAME_WIDTH || y < 0 || y >= FRAME_HEIGHT)
+			continue;
+		double a = mags[(int)star_data->mag] / 30.0;
+		for (int j = -STAR_RADIUS; j <= STAR_RADIUS; j++) {
+			for (int i = -STAR_RADIUS; i <= STAR_RADIUS; i++) {
+				int px = (int)x + i, py = (int)y + j;
+				if (px < 0 || px >= FRAME_WIDTH || py < 0 || py >= FRAME_HEIGHT)
+					continue;
+				double d2 = (px - x) * (px - x) + (py - y) * (py - y);
+				double value = image[py * FRAME_WIDTH + px] + a * exp(-d2 / 4.5);
+				image[py * FRAME_WIDTH + px] = value > 65535 ? 65535 : value;
+			}
+		}
+	}
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// in degrees, arguments in radians
+
+static double angular_distance(double ra1, double dec1, double ra2, double dec2) {
+	double cos_distance = sin(dec1) * sin(dec2) + cos(dec1) * cos(dec2) * cos(ra1 - ra2);
+	return acos(cos_distance > 1 ? 1 : cos_distance) * 180 / M_PI;
+}
+
+enum { HINT_FULL, HINT_POSITION, HINT_SCALE, HINT_NONE, HINT_COUNT };
+static char *hint_names[] = { "position and scale", "position", "scale", "none (blind)" };
+
+int main(int argc, char **argv) {
+	// blind solves take seconds per field, they are included only on request
+	int modes = argc > 1 && !strcmp(argv[1], "blind") ? HINT_COUNT : HINT_NONE;
+	double start = now();
+	indigo_native_solver_build_index();
+	printf("catalog index built in %.1f ms\n", (now() - start) * 1000);
+	uint16_t *image = indigo_safe_malloc(FRAME_WIDTH * FRAME_HEIGHT * sizeof(uint16_t));
+	field fields[FIELD_COUNT];
+	unsigned seed = 1;
+	for (int i = 0; i < FIELD_COUNT; i++) {
+		fields[i].ra = (rand_r(&seed) % 24000) / 1000.0;
+		fields[i].dec = (rand_r(&seed) % 160000) / 1000.0 - 80;
+		fields[i].fov = 4 + (rand_r(&seed) % 8000) / 1000.0;
+		fields[i].angle = rand_r(&seed) % 360;
+		fields[i].flip = rand_r(&seed) % 2;
+	}
+	bool abort_requested = false;
+	int wrong = 0;
+	for (int mode = 0; mode < modes; mode++) {
+		int solved = 0, skipped = 0, unsolved = 0;
+		double total_time = 0, max_time = 0, max_error = 0;
+		for (int i = 0; i < FIELD_COUNT; i++) {
+			field *f = fields + i;
+			render_field(image, f, i);
+			indigo_star_detection stars[MAX_IMAGE_STARS];
+			int star_count = 0;
+			indigo_find_stars_precise(INDIGO_RAW_MONO16, image, STAR_RADIUS, FRAME_WIDTH, FRAME_HEIGHT, 50, stars, &star_count);
+			// agent rejects such frames, the catalog is too sparse for them
+			if (star_count < MIN_IMAGE_STARS) {
+				skipped++;
+				continue;
+			}
+			// position hint is off by 1.5° in RA and 1° in Dec, scale hint by 5%
+			indigo_native_solver_hints hints = { 0 };
+			hints.abort_requested = &abort_requested;
+			if (mode == HINT_FULL || mode == HINT_POSITION) {
+				hints.ra = f->ra * 15 + 1.5;
+				hints.dec = f->dec - 1;
+				hints.radius = 5;
+			}
+			if (mode == HINT_FULL || mode == HINT_SCALE)
+				hints.scale = f->fov / FRAME_HEIGHT * 1.05;
+			indigo_native_solver_solution solution;
+			double solve_start = now();
+			bool result = indigo_native_solver_solve(stars, star_count, FRAME_WIDTH, FRAME_HEIGHT, &hints, &solution);
+			double solve_time = now() - solve_start;
+			total_time += solve_time;
+			if (max_time < solve_time)
+				max_time = solve_time;
+			double error = 0;
+			if (result) {
+				error = angular_distance(solution.ra * M_PI / 180, solution.dec * M_PI / 180, f->ra * M_PI / 12, f->dec * M_PI / 180) * 3600;
+			}
+			if (!result) {
+				unsolved++;
+			} else if (error < MAX_ERROR) {
+				solved++;
+				if (max_error < error)
+					max_error = error;
+			} else {
+				printf("field %2d RA %6.3fh Dec %+6.2f° FOV %5.2f° solved %.2f° off\n", i, f->ra, f->dec, f->fov, error / 3600);
+				wrong++;
+			}
+		}
+		int count = FIELD_COUNT - skipped;
+		printf("hints %-18s solved %2d/%d, %d not solved, average %7.1f ms, max %7.1f ms, max error %4.1f\"\n", hint_names[mode], solved, count, unsolved, total_time / count * 1000, max_time * 1000, max_error);
+	}
+	indigo_native_solver_release_index();
+	free(image);
+	// wrong solution is an error, missing one is just a weak field
+	printf("%d wrong solutions %s\n", wrong, wrong ? "FAILED" : "OK");
+	return wrong ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -94,17 +94,37 @@ struct gwavi_stream_format_t {
 	unsigned int palette_count;
 };
 
+/* OpenDML (AVI 2.0) layout, each RIFF ('AVI ' and following 'AVIX') is limited to GWAVI_RIFF_SIZE bytes,
+ * has its own 'ix00' standard index and all of them are referenced from 'indx' super index in stream header.
+ * Legacy 'idx1' index covers the first RIFF only.
+ */
+
+#define GWAVI_RIFF_SIZE					(1024L * 1024 * 1024)
+#define GWAVI_SUPER_INDEX_SIZE	256
+#define GWAVI_BUFFER_SIZE				(4 * 1024 * 1024)
+
+struct gwavi_index_entry_t {
+	unsigned long long offset;
+	unsigned int size;
+	unsigned int duration;
+};
+
 struct gwavi_t {
 	int handle;
 	struct gwavi_header_t avi_header;
 	struct gwavi_stream_header_t stream_header;
 	struct gwavi_stream_format_t stream_format;
-	long marker;
-	int offsets_ptr;
-	int offsets_len;
-	long offsets_start;
-	unsigned int *offsets;
-	int offset_count;
+	unsigned char *buffer;
+	size_t buffered;
+	unsigned long long position;
+	unsigned long long riff_marker;
+	unsigned long long movi_marker;
+	unsigned int first_riff_frames;
+	struct gwavi_index_entry_t *entries;
+	int entry_count;
+	int entries_len;
+	struct gwavi_index_entry_t super_index[GWAVI_SUPER_INDEX_SIZE];
+	int super_index_count;
 };
 
 extern struct gwavi_t *gwavi_open(const char *filename, unsigned int width, unsigned int height, const char *fourcc, unsigned int fps);
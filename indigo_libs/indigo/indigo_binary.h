@@ -0,0 +1,84 @@
+// Copyright (c) 2024 CloudMakers, s. r. o.
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by Peter Polakovic <peter.polakovic@cloudmakers.eu>
+
+/** INDIGO binary wire protocol
+ \file indigo_binary.h
+
+ Compact protocol used between INDIGO peers. After the handshake (client sends INDIGO_BINARY_MAGIC, server echoes it) both sides exchange
+ frames prefixed by 32-bit little endian length. Device, property, item and group names are sent in full once and referenced by index later,
+ numbers are sent as raw IEEE doubles and BLOB payloads follow the frame unencoded.
+ */
+
+#ifndef indigo_binary_h
+#define indigo_binary_h
+
+#include <indigo/indigo_bus.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Handshake, the first byte is used by server to select the protocol.
+ */
+#define INDIGO_BINARY_MAGIC			"\x80IB1"
+#define INDIGO_BINARY_MAGIC_SIZE	4
+
+/** Try binary protocol for connections to remote INDIGO servers (XML is used if server doesn't support it).
+ */
+extern bool indigo_use_binary_protocol;
+
+/** Maximal total size of BLOB payloads in one frame received from the peer (1GB by default), connection is closed if it is exceeded.
+ */
+extern long indigo_binary_blob_size_limit;
+
+/** Offer binary protocol to the server, returns false if server doesn't accept it (connection must be reopened then).
+ */
+extern bool indigo_binary_connect(int handle);
+
+/** Accept binary protocol offered by the client.
+ */
+extern bool indigo_binary_accept(int handle);
+
+/** Binary wire protocol parser.
+ */
+extern void indigo_binary_parse(indigo_device *device, indigo_client *client);
+
+/** Create initialized instance of binary wire protocol client side adapter (used by server).
+ */
+extern indigo_client *indigo_binary_device_adapter(int input, int output);
+
+/** Release binary wire protocol client side adapter.
+ */
+extern void indigo_release_binary_device_adapter(indigo_client *client);
+
+/** Create initialized instance of binary wire protocol driver side adapter (used by client).
+ */
+extern indigo_device *indigo_binary_client_adapter(char *name, char *url_prefix, int input, int output);
+
+/** Release binary wire protocol driver side adapter.
+ */
+extern void indigo_release_binary_client_adapter(indigo_device *device);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* indigo_binary_h */
@@ -210,12 +210,20 @@ typedef enum {
 	INDIGO_LOG_TRACE
 } indigo_log_levels;
 
+/** Reference counted immutable BLOB buffer.
+ */
+typedef struct {
+	void *data;													///< buffer data
+	long size;													///< data size
+	int reference_count;								///< number of references
+} indigo_blob_buffer;
+
 /** Property item definition.
  */
 typedef struct {/* there is no .name =  because of g++ C99 bug affecting string initialier */
 	char name[INDIGO_NAME_SIZE];        ///< property wide unique item name
-	char label[INDIGO_VALUE_SIZE];      ///< item description in human readable form
-	char hints[INDIGO_VALUE_SIZE];			///< item GUI hints
+	const char *label;									///< item description in human readable form (interned string, use indigo_set_label())
+	const char *hints;									///< item GUI hints (interned string, use indigo_set_hints())
 	union {
 		/** Text property item specific fields.
 		 */
@@ -227,7 +235,7 @@ typedef struct {/* there is no .name =  because of g++ C99 bug affecting string
 		/** Number property item specific fields.
 		 */
 		struct {/* there is no .name =  because of g++ C99 bug affecting string initialier */
-			char format[INDIGO_VALUE_SIZE]; ///< item format (for number properties)
+			const char *format;							///< item format (for number properties, interned string, use indigo_set_number_format())
 			double min;                     ///< item min value (for number properties)
 			double max;                     ///< item max value (for number properties)
 			double step;                    ///< item increment value (for number properties)
@@ -251,6 +259,7 @@ typedef struct {/* there is no .name =  because of g++ C99 bug affecting string
 			char url[INDIGO_VALUE_SIZE];		///< item URL on source server
 			long size;                      ///< item size (for blob properties) in bytes
 			void *value;                    ///< item value (for blob properties)
+			indigo_blob_buffer *buffer;			///< immutable buffer holding value (optional, for blob properties)
 		} blob;
 	};
 } indigo_item;
@@ -261,8 +270,8 @@ typedef struct {
 	char device[INDIGO_NAME_SIZE];      ///< system wide unique device name
 	char name[INDIGO_NAME_SIZE];        ///< device wide unique property name
 	char group[INDIGO_NAME_SIZE];       ///< property group in human readable form (presented as a tab or a subtree in GUI
-	char label[INDIGO_VALUE_SIZE];      ///< property description in human readable form
-	char hints[INDIGO_VALUE_SIZE];			///< property GUI hints
+	const char *label;									///< property description in human readable form (interned string, use indigo_set_label())
+	const char *hints;									///< property GUI hints (interned string, use indigo_set_hints())
 	indigo_property_state state;        ///< property state
 	indigo_property_type type;          ///< property type
 	indigo_property_perm perm;          ///< property access permission
@@ -271,6 +280,7 @@ typedef struct {
 	short version;                      ///< property version INDIGO_VERSION_NONE, INDIGO_VERSION_LEGACY or INDIGO_VERSION_2_0
 	bool hidden;                        ///< property is hidden/unused by  driver (for optional properties)
 	bool defined;												///< property is defined
+	bool *changed;											///< items changed since previous update (set by bus for update_property callbacks only, NULL = all items)
 	int allocated_count;                ///< number of allocated property items
 	int count;                          ///< number of used property items
 	indigo_item items[];                ///< property items
@@ -362,6 +372,7 @@ typedef struct {
 	int output;													///< output handle
 	bool web_socket;										///< connection over WebSocket (RFC6455)
 	char url_prefix[INDIGO_NAME_SIZE];	///< server url prefix (for BLOB download)
+	void *output_queue;									///< outbound message queue (NULL for synchronous output)
 } indigo_adapter_context;
 
 /** BLOB entry type.
@@ -372,9 +383,23 @@ typedef struct {
 	void *content;            					///< BLOB content
 	long size;              						///< BLOB size
 	char format[INDIGO_NAME_SIZE];  		///< BLOB format, known file type suffix like ".fits" or ".jpeg"
+	indigo_blob_buffer *buffer;					///< buffer holding content
 	pthread_mutex_t mutext;							///< BLOB mutex
+	uint32_t id;												///< opaque id used in BLOB URLs
+	uint32_t generation;								///< content generation, incremented with each cached update
 } indigo_blob_entry;
 
+/** BLOB cache statistics.
+ */
+typedef struct {
+	int entries;												///< number of registered BLOB items
+	long memory;												///< bytes held by cached content
+	long budget;												///< memory budget (0 = unlimited)
+	long hits;													///< requests served from cache
+	long misses;												///< requests for unknown, evicted or outdated content
+	long evictions;											///< number of evicted entries
+} indigo_blob_cache_statistics;
+
 /** Last diagnostic messages.
  */
 extern char *indigo_last_message;
@@ -464,6 +489,14 @@ extern indigo_result indigo_define_property(indigo_device *device, indigo_proper
  */
 extern indigo_result indigo_update_property(indigo_device *device, indigo_property *property, const char *format, ...);
 
+/** Check if item was changed since previous update (to be used by wire protocol adapters in update_property callback).
+ */
+extern bool indigo_item_changed(indigo_property *property, indigo_item *item);
+
+/** Limit update rate of property, pending updates are coalesced and copy of the last value is sent when interval expires (0 = unlimited, empty device name matches any device, BLOB vectors are not limited).
+ */
+extern void indigo_set_update_rate(const char *device, const char *name, double rate);
+
 /** Broadcast property removal.
  */
 extern indigo_result indigo_delete_property(indigo_device *device, indigo_property *property, const char *format, ...);
@@ -516,6 +549,12 @@ extern indigo_property *indigo_copy_property(indigo_property *copy, indigo_prope
 /** Clear property.
  */
 extern indigo_property *indigo_clear_property(indigo_property *property);
+/** Replace items of "property" with copies of items of "other" (items must not be copied with memcpy, they hold references to interned strings).
+ */
+extern void indigo_copy_items(indigo_property *property, indigo_property *other);
+/** Remove item from property (not usable for BLOB vectors).
+ */
+extern void indigo_remove_item(indigo_property *property, int index);
 /** Allocate blob buffer (rounded up to 2880 bytes).
  */
 extern void *indigo_alloc_blob_buffer(long size);
@@ -531,6 +570,103 @@ extern indigo_blob_entry *indigo_validate_blob(indigo_item *item);
  */
 extern indigo_blob_entry *indigo_find_blob(indigo_property *other_property, indigo_item *other_item);
 
+/** Find BLOB entry by its opaque id.
+ */
+extern indigo_blob_entry *indigo_validate_blob_id(uint32_t id);
+
+/** Format BLOB path ("/blob/<id>" or "/blob/<id>-<generation>" if versioned) of item of BLOB property, item is registered if needed.
+ */
+extern char *indigo_blob_path(indigo_property *property, indigo_item *item, bool versioned, char *path, int size);
+
+/** Parse BLOB path and return BLOB entry and requested generation (0 for the latest one).
+ */
+extern indigo_blob_entry *indigo_parse_blob_path(const char *path, uint32_t *generation);
+
+/** Create BLOB buffer, buffer takes ownership of malloc-ed data.
+ */
+extern indigo_blob_buffer *indigo_create_blob_buffer(void *data, long size);
+
+/** Add reference to BLOB buffer.
+ */
+extern indigo_blob_buffer *indigo_retain_blob_buffer(indigo_blob_buffer *buffer);
+
+/** Remove reference from BLOB buffer, data are freed with the last reference.
+ */
+extern void indigo_release_blob_buffer(indigo_blob_buffer *buffer);
+
+/** Get reference to buffer holding BLOB item value, value without buffer is copied once and the copy is shared by all clients of the update (update_property callback only).
+ */
+extern indigo_blob_buffer *indigo_share_blob_value(indigo_item *item);
+
+/** Get reference to the cached content of BLOB entry for given generation (0 = any) or NULL.
+ */
+extern indigo_blob_buffer *indigo_retain_blob_content(indigo_blob_entry *entry, uint32_t generation, void **content, long *size);
+
+/** Replace content of BLOB entry, entry takes ownership of buffer reference (entry mutex must be locked).
+ */
+extern void indigo_set_blob_content(indigo_blob_entry *entry, indigo_blob_buffer *buffer, void *content, long size);
+
+/** Get BLOB cache statistics.
+ */
+extern void indigo_get_blob_cache_statistics(indigo_blob_cache_statistics *statistics);
+
+/** Defined since labels, hints and number formats are interned strings instead of char arrays, they must not be written directly.
+ Code supporting also older versions can use the accessor macros below with fallback like
+ #ifndef INDIGO_INTERNED_STRINGS
+ #define indigo_set_label(object, string) indigo_copy_value((object)->label, string)
+ #endif
+ */
+#define INDIGO_INTERNED_STRINGS
+
+/** Get reference to shared immutable copy of string (truncated to INDIGO_VALUE_SIZE - 1 characters), used for labels, hints and number formats.
+ Reference is owned by the caller, use indigo_set_string() or accessor macros below to assign it to item or property.
+ */
+extern const char *indigo_intern_string(const char *string);
+
+/** Get reference to shared immutable copy of formatted string.
+ */
+extern const char *indigo_intern_printf(const char *format, ...);
+
+/** Get another reference to interned string (other strings are returned unchanged).
+ */
+extern const char *indigo_retain_string(const char *string);
+
+/** Release reference to interned string, unreferenced strings are evicted immediately (other strings are ignored).
+ */
+extern void indigo_release_string(const char *string);
+
+/** Replace string field with interned copy of string and release the previous value.
+ */
+extern void indigo_set_string(const char **field, const char *string);
+
+/** Replace string field with interned copy of formatted string and release the previous value.
+ */
+extern void indigo_set_string_printf(const char **field, const char *format, ...);
+
+/** Get number of interned strings and memory used by them.
+ */
+extern void indigo_get_intern_statistics(int *count, long *size);
+
+/** Set label of item or property.
+ */
+#define indigo_set_label(object, string) indigo_set_string(&(object)->label, string)
+
+/** Set GUI hints of item or property.
+ */
+#define indigo_set_hints(object, string) indigo_set_string(&(object)->hints, string)
+
+/** Set format of number item.
+ */
+#define indigo_set_number_format(object, string) indigo_set_string(&(object)->number.format, string)
+
+/** Set label of item or property to formatted string (replaces snprintf() to label).
+ */
+#define indigo_set_label_printf(object, format, ...) indigo_set_string_printf(&(object)->label, format, __VA_ARGS__)
+
+/** Set GUI hints of item or property to formatted string (replaces snprintf() to hints).
+ */
+#define indigo_set_hints_printf(object, format, ...) indigo_set_string_printf(&(object)->hints, format, __VA_ARGS__)
+
 /** Initialize text item.
  */
 extern void indigo_init_text_item(indigo_item *item, const char *name, const char *label, const char *format, ...);
@@ -541,7 +677,7 @@ extern void indigo_init_text_item_raw(indigo_item *item, const char *name, const
  */
 extern void indigo_init_number_item(indigo_item *item, const char *name, const char *label, double min, double max, double step, double value);
 
-#define indigo_init_sexagesimal_number_item(item, name, label, min, max, step, value) { indigo_init_number_item(item, name, label, min, max, step, value); strcpy(item->number.format, "%12.9m"); }
+#define indigo_init_sexagesimal_number_item(item, name, label, min, max, step, value) { indigo_init_number_item(item, name, label, min, max, step, value); indigo_set_number_format(item, "%12.9m"); }
 
 /** Initialize switch item.
  */
@@ -557,6 +693,10 @@ extern void indigo_init_blob_item(indigo_item *item, const char *name, const cha
  */
 extern bool indigo_populate_http_blob_item(indigo_item *blob_item);
 
+/** Close idle keep-alive connections used to populate BLOB items from given server.
+ */
+extern void indigo_close_http_connections(const char *host, int port);
+
 /** upload BLOB item if url is given.
  */
 extern bool indigo_upload_http_blob_item(indigo_item *blob_item);
@@ -784,6 +924,10 @@ extern bool indigo_is_sandboxed;
  */
 extern bool indigo_use_blob_caching;
 
+/** Memory budget for cached BLOB content in bytes, least recently used content is evicted when exceeded (0 = unlimited)
+ */
+extern long indigo_blob_cache_budget;
+
 /** Proxy BLOB content
  */
 extern bool indigo_proxy_blob;
@@ -792,6 +936,10 @@ extern bool indigo_proxy_blob;
  */
 extern bool indigo_use_strict_locking;
 
+/** Send only changed items in updates to XML clients (binary protocol clients always get changed items only)
+ */
+extern bool indigo_use_delta_updates;
+
 /** Allocate, assert and zero
  */
 
@@ -509,6 +509,66 @@ extern "C" {
  */
 #define CCD_RBI_FLUSH_DISABLED_ITEM     (CCD_RBI_FLUSH_ENABLE_PROPERTY->items + 1)
 
+/** CCD_IMAGE_PIPELINE property pointer.
+ */
+#define CCD_IMAGE_PIPELINE_PROPERTY     (CCD_CONTEXT->ccd_image_pipeline_property)
+
+/** CCD_IMAGE_PIPELINE.ENABLED property item pointer.
+ */
+#define CCD_IMAGE_PIPELINE_ENABLED_ITEM     (CCD_IMAGE_PIPELINE_PROPERTY->items + 0)
+
+/** CCD_IMAGE_PIPELINE.DISABLED property item pointer.
+ */
+#define CCD_IMAGE_PIPELINE_DISABLED_ITEM    (CCD_IMAGE_PIPELINE_PROPERTY->items + 1)
+
+/** CCD_PREVIEW_TIMING property pointer, property is visible only with debug log level.
+ */
+#define CCD_PREVIEW_TIMING_PROPERTY     (CCD_CONTEXT->ccd_preview_timing_property)
+
+/** CCD_PREVIEW_TIMING.ESTIMATION property item pointer (stretch parameters estimation in ms).
+ */
+#define CCD_PREVIEW_TIMING_ESTIMATION_ITEM  (CCD_PREVIEW_TIMING_PROPERTY->items + 0)
+
+/** CCD_PREVIEW_TIMING.CONVERSION property item pointer (debayer and stretch in ms).
+ */
+#define CCD_PREVIEW_TIMING_CONVERSION_ITEM  (CCD_PREVIEW_TIMING_PROPERTY->items + 1)
+
+/** CCD_PREVIEW_TIMING.COMPRESSION property item pointer (JPEG compression in ms).
+ */
+#define CCD_PREVIEW_TIMING_COMPRESSION_ITEM (CCD_PREVIEW_TIMING_PROPERTY->items + 2)
+
+/** CCD_PREVIEW_TIMING.TOTAL property item pointer (whole conversion including histogram in ms).
+ */
+#define CCD_PREVIEW_TIMING_TOTAL_ITEM       (CCD_PREVIEW_TIMING_PROPERTY->items + 3)
+
+/** CCD_STREAMING_STATS property pointer.
+ */
+#define CCD_STREAMING_STATS_PROPERTY        (CCD_CONTEXT->ccd_streaming_stats_property)
+
+/** CCD_STREAMING_STATS.SAVED property item pointer (frames saved to the local video file).
+ */
+#define CCD_STREAMING_STATS_SAVED_ITEM      (CCD_STREAMING_STATS_PROPERTY->items + 0)
+
+/** CCD_STREAMING_STATS.DROPPED property item pointer (frames dropped because the video file writer couldn't keep up).
+ */
+#define CCD_STREAMING_STATS_DROPPED_ITEM    (CCD_STREAMING_STATS_PROPERTY->items + 1)
+
+/** CCD_IMAGE_COMPRESSION property pointer, it applies to FITS (tile compression) and XISF (zlib with byte shuffling) formats.
+ */
+#define CCD_IMAGE_COMPRESSION_PROPERTY      (CCD_CONTEXT->ccd_image_compression_property)
+
+/** CCD_IMAGE_COMPRESSION.NONE property item pointer.
+ */
+#define CCD_IMAGE_COMPRESSION_NONE_ITEM     (CCD_IMAGE_COMPRESSION_PROPERTY->items + 0)
+
+/** CCD_IMAGE_COMPRESSION.RICE property item pointer (RICE_1 for FITS, zlib for XISF).
+ */
+#define CCD_IMAGE_COMPRESSION_RICE_ITEM     (CCD_IMAGE_COMPRESSION_PROPERTY->items + 1)
+
+/** CCD_IMAGE_COMPRESSION.GZIP property item pointer (GZIP_2 for FITS, zlib for XISF).
+ */
+#define CCD_IMAGE_COMPRESSION_GZIP_ITEM     (CCD_IMAGE_COMPRESSION_PROPERTY->items + 2)
+
 
 /** CCD device context structure.
  */
@@ -522,6 +582,16 @@ typedef struct {
 	unsigned long preview_image_size;							///< preview image buffer size
 	void *preview_histogram;											///< preview histogram buffer
 	unsigned long preview_histogram_size;					///< preview histogram buffer size
+	void *conversion_buffer;											///< FITS conversion buffer
+	unsigned long conversion_buffer_size;					///< FITS conversion buffer size
+	void *compression_buffer;											///< compressed image buffer
+	unsigned long compression_buffer_size;				///< compressed image size
+	void *preview_buffer;													///< preview conversion scratch buffer
+	unsigned long preview_buffer_size;						///< preview conversion scratch buffer size
+	void *image_pipeline;													///< asynchronous image pipeline
+	void *dslr_raw_context;												///< reusable libraw context
+	void *dslr_raw_image;													///< decoded DSLR RAW image buffer
+	size_t dslr_raw_image_size;										///< decoded DSLR RAW image buffer size
 	void *video_stream;														///< video stream control structure
 	indigo_property *ccd_info_property;           ///< CCD_INFO property pointer
 	indigo_property *ccd_lens_property;						///< CCD_LENS property pointer
@@ -555,6 +625,10 @@ typedef struct {
 	indigo_property *ccd_jpeg_stretch_presets;				///< CCD_JPEG_STRETCH_PRESETS property pointer
 	indigo_property *ccd_rbi_flush_enable_property; ///< CCD_RBI_FLUSH_ENABLE property pointer
 	indigo_property *ccd_rbi_flush_property;			///< CCD_RBI_FLUSH property pointer
+	indigo_property *ccd_preview_timing_property;	///< CCD_PREVIEW_TIMING property pointer
+	indigo_property *ccd_image_pipeline_property;	///< CCD_IMAGE_PIPELINE property pointer
+	indigo_property *ccd_streaming_stats_property;	///< CCD_STREAMING_STATS property pointer
+	indigo_property *ccd_image_compression_property;	///< CCD_IMAGE_COMPRESSION property pointer
 } indigo_ccd_context;
 
 /** Suspend countdown.
@@ -588,10 +662,16 @@ extern indigo_result indigo_ccd_detach(indigo_device *device);
 extern void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, int frame_height, int bpp, const char *bayerpat, void **data_out, unsigned long *size_out, void **histogram_data, unsigned long *histogram_size, double B, double C);
 
 /** Process raw image in image buffer (starting on data + FITS_HEADER_SIZE offset).
+ If CCD_IMAGE_PIPELINE is enabled, image is copied to the device pipeline and processed asynchronously, data buffer can be reused immediately.
  */
 extern void indigo_process_image(indigo_device *device, void *data, int frame_width, int frame_height, int bpp, bool little_endian, bool byte_order_rgb, indigo_fits_keyword *keywords, bool streaming);
 
+/** Wait until all images passed to asynchronous pipeline are processed.
+ */
+extern void indigo_wait_for_image_pipeline(indigo_device *device);
+
 /** Process DSLR image in image buffer (starting on data).
+ If CCD_IMAGE_PIPELINE is enabled, camera RAW file converted to FITS, XISF or RAW is decoded asynchronously, data buffer can be reused immediately.
  */
 extern void indigo_process_dslr_image(indigo_device *device, void *data, int blobsize, const char *suffix, bool streaming);
 
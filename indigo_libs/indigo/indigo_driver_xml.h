@@ -33,10 +33,53 @@
 extern "C" {
 #endif
 
+/** Policy applied to BLOBs when client doesn't keep up with outbound queue.
+ */
+typedef enum {
+	INDIGO_XML_BLOB_DROP_OLDEST,	///< drop the oldest pending BLOB
+	INDIGO_XML_BLOB_BLOCK,				///< block the publisher until pending BLOB is sent (or timeout expires)
+	INDIGO_XML_BLOB_URL_ONLY			///< send BLOB URL instead of inline data (legacy clients get nothing)
+} indigo_xml_blob_policy;
+
+/** Outbound queue statistics.
+ */
+typedef struct {
+	int clients;								///< number of clients with outbound queue
+	long depth;									///< number of pending messages
+	long max_depth;							///< maximal number of pending messages for single client
+	long coalesced;							///< number of updates superseded by newer value
+	long dropped;								///< number of messages dropped
+	long dropped_blobs;					///< number of BLOBs dropped by policy
+} indigo_xml_queue_statistics;
+
+/** BLOB policy for clients falling behind.
+ */
+extern indigo_xml_blob_policy indigo_xml_blob_queue_policy;
+
+/** Maximal number of pending messages per client.
+ */
+extern int indigo_xml_queue_size;
+
+/** Maximal number of pending inline BLOBs per client.
+ */
+extern int indigo_xml_queue_blob_limit;
+
+/** Time in seconds publisher waits for a full queue before client is disconnected.
+ */
+extern double indigo_xml_queue_timeout;
+
 /** Create initialized instance of XML wire protocol client side adapter.
  */
 extern indigo_client *indigo_xml_device_adapter(int input, int ouput);
 
+/** Send formatted text to client in order with other outbound messages.
+ */
+extern bool indigo_xml_device_adapter_printf(indigo_client *client, const char *format, ...);
+
+/** Get outbound queue statistics.
+ */
+extern void indigo_get_xml_queue_statistics(indigo_xml_queue_statistics *statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -68,6 +68,20 @@ extern "C" {
 int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_raw_image_s *output_image);
 int indigo_dslr_raw_image_info(void *buffer, size_t buffer_size, indigo_dslr_raw_image_info_s *image_info);
 
+/** Allocate libraw context configured for bayered 16-bit output, the context can be reused for any number of images.
+ */
+libraw_data_t *indigo_dslr_raw_init_context(void);
+
+/** Release libraw context allocated by indigo_dslr_raw_init_context().
+ */
+void indigo_dslr_raw_release_context(libraw_data_t *context);
+
+/** Decode image info and bayer plane with single open of the buffer.
+ Plane is written to *image + offset, *image is reallocated if *image_size is smaller than plane size + 2 * offset.
+ output_image->data points to the plane, it is owned by *image and must not be freed. image_info can be NULL.
+ */
+int indigo_dslr_raw_decode(libraw_data_t *context, void *buffer, size_t buffer_size, void **image, size_t *image_size, size_t offset, indigo_dslr_raw_image_s *output_image, indigo_dslr_raw_image_info_s *image_info);
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,7 +35,7 @@ extern "C" {
 
 #define INDIGO_FILTER_LIST_COUNT							13
 #define INDIGO_FILTER_MAX_DEVICES							128
-#define INDIGO_FILTER_MAX_CACHED_PROPERTIES		256
+#define INDIGO_FILTER_CACHE_HASH_SIZE					256
 	
 #define INDIGO_FILTER_CCD_INDEX								0
 #define INDIGO_FILTER_WHEEL_INDEX							1
@@ -202,6 +202,17 @@ extern "C" {
 #define CCD_LENS_FOV_PIXEL_SCALE_HEIGHT_ITEM (CCD_LENS_FOV_PROPERTY->items+3)
 
 
+/** Cached property record, indexed by device and property name of device property and by property name of agent property.
+ */
+typedef struct indigo_filter_cache_entry {
+	struct indigo_filter_cache_entry *next_device;	///< next record in device property hash chain
+	struct indigo_filter_cache_entry *next_agent;		///< next record in agent property hash chain
+	uint32_t device_hash;
+	uint32_t agent_hash;
+	indigo_property *device_property;								///< copy of device property
+	indigo_property *agent_property;								///< agent property mirroring device property
+} indigo_filter_cache_entry;
+
 /** Filter device context structure.
  */
 typedef struct {
@@ -213,8 +224,10 @@ typedef struct {
 	indigo_property *filter_related_device_list_properties[INDIGO_FILTER_LIST_COUNT];
 	indigo_property *filter_related_agent_list_property;
 	indigo_property *filter_force_SYMMETRIC_relations_property;
-	indigo_property *device_property_cache[INDIGO_FILTER_MAX_CACHED_PROPERTIES];
-	indigo_property *agent_property_cache[INDIGO_FILTER_MAX_CACHED_PROPERTIES];
+	indigo_filter_cache_entry *device_property_cache[INDIGO_FILTER_CACHE_HASH_SIZE];
+	indigo_filter_cache_entry *agent_property_cache[INDIGO_FILTER_CACHE_HASH_SIZE];
+	pthread_mutex_t property_cache_mutex;
+	pthread_cond_t property_cache_cond;
 	indigo_property *connection_property_cache[INDIGO_FILTER_MAX_DEVICES];
 	bool running_process;
 	bool property_removed;
@@ -262,6 +275,13 @@ extern indigo_result indigo_filter_client_detach(indigo_client *client);
 /** Find remote cached properties.
  */
 extern bool indigo_filter_cached_property(indigo_device *device, int index, char *name, indigo_property **device_property, indigo_property **agent_property);
+/** Wait until condition is met, it is evaluated each time a cached property is updated or deleted, on indigo_filter_notify() or timeout (in seconds, 0 = no timeout).
+ Condition is called with the cache locked, it can read cached properties but must not call indigo_filter_cached_property() or any bus function. Returns the last value of the condition.
+ */
+extern bool indigo_filter_wait(indigo_device *device, bool (*condition)(indigo_device *device, void *data), void *data, double timeout);
+/** Wake up threads waiting in indigo_filter_wait() to reevaluate their condition (e.g. after abort or pause request).
+ */
+extern void indigo_filter_notify(indigo_device *device);
 /** Forward property change to a different device.
  */
 extern indigo_result indigo_filter_forward_change_property(indigo_client *client, indigo_property *property, char *device_name);
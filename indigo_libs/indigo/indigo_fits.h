@@ -47,6 +47,27 @@ typedef struct {
 	const char *comment;
 } indigo_fits_keyword;
 
+/** Convert RAW payload to FITS data unit in a single pass - 16 bit samples are offset by BZERO and stored as big endian,
+ RGB is split to planes (BGR input is reordered on the fly). Input and output may be the same buffer for monochrome images only.
+ */
+extern void indigo_raw_to_fits_data(const void *in, void *out, int pixel_count, int byte_per_pixel, int components, bool little_endian, bool byte_order_rgb);
+
+/** Tile compression algorithms (FITS tiled image convention).
+ */
+typedef enum {
+	INDIGO_FITS_RICE = 1,
+	INDIGO_FITS_GZIP_2
+} indigo_fits_compression;
+
+/** Convert FITS image (header followed by data unit as produced by indigo_raw_to_fits_data()) to tile compressed FITS with one tile per row,
+ tiles are compressed in parallel. Header cards except the mandatory ones are copied to the compressed image header, *out is reallocated.
+ */
+extern indigo_result indigo_compress_fits(const char *header, int header_size, const void *data, int width, int height, int byte_per_pixel, int components, indigo_fits_compression compression, char **out, unsigned long *out_size);
+
+/** Compress data with byte shuffling and zlib (XISF "zlib+sh" codec), blocks are compressed in parallel, *out is reallocated.
+ */
+extern indigo_result indigo_compress_shuffled(const void *data, unsigned long size, int item_size, char **out, unsigned long *out_size);
+
 extern indigo_result indigo_raw_to_fits(char *image, int in_size, char **fits, int *fits_size, indigo_fits_keyword *keywords);
 
 #ifdef __cplusplus
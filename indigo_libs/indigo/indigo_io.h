@@ -85,13 +85,38 @@ extern int indigo_close(int handle);
 #endif
 
 /** Read line.
+    On Linux and macOS, input of handles other than sockets is buffered (see indigo_attach_reader()), such handles must be closed by indigo_close_reader().
  */
 extern int indigo_read_line(int handle, char *buffer, int length);
 
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+/** Attach input buffer to handle, indigo_read(), indigo_read_line(), indigo_scanf() and indigo_select() will use it.
+    Buffer is attached to handles other than sockets by the first indigo_read_line() or indigo_scanf() anyway, so these handles must be read only by
+    these functions and input discarded by tcflush() must be discarded by indigo_flush_reader() as well. If timeout (in us) is positive, reads fail with ETIMEDOUT if no data arrive in time.
+ */
+extern bool indigo_attach_reader(int handle, long timeout);
+
+/** Discard input buffered for handle.
+ */
+extern void indigo_flush_reader(int handle);
+
+/** Detach input buffer from handle, must be called before handle is closed.
+ */
+extern void indigo_detach_reader(int handle);
+
+/** Detach input buffer from handle and close it.
+ */
+extern void indigo_close_reader(int handle);
+#endif
+
 /** Write buffer.
  */
 extern bool indigo_write(int handle, const char *buffer, long length);
 
+/** Write header and data buffers to handle with a single gathered write where available.
+ */
+extern bool indigo_writev(int handle, const char *header, long header_length, const char *data, long data_length);
+
 /** Write formatted.
  */
 
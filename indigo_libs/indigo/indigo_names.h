@@ -722,6 +722,70 @@
  */
 #define CCD_RBI_FLUSH_DISABLED_ITEM_NAME     "DISABLED"
 
+//------------------------------------------------------------------------
+/** CCD_IMAGE_PIPELINE property name.
+ */
+#define CCD_IMAGE_PIPELINE_PROPERTY_NAME          "CCD_IMAGE_PIPELINE"
+
+/** CCD_IMAGE_PIPELINE.ENABLED property item name.
+ */
+#define CCD_IMAGE_PIPELINE_ENABLED_ITEM_NAME      "ENABLED"
+
+/** CCD_IMAGE_PIPELINE.DISABLED property item name.
+ */
+#define CCD_IMAGE_PIPELINE_DISABLED_ITEM_NAME     "DISABLED"
+
+//------------------------------------------------------------------------
+/** CCD_PREVIEW_TIMING property name.
+ */
+#define CCD_PREVIEW_TIMING_PROPERTY_NAME          "CCD_PREVIEW_TIMING"
+
+/** CCD_PREVIEW_TIMING.ESTIMATION property item name.
+ */
+#define CCD_PREVIEW_TIMING_ESTIMATION_ITEM_NAME   "ESTIMATION"
+
+/** CCD_PREVIEW_TIMING.CONVERSION property item name.
+ */
+#define CCD_PREVIEW_TIMING_CONVERSION_ITEM_NAME   "CONVERSION"
+
+/** CCD_PREVIEW_TIMING.COMPRESSION property item name.
+ */
+#define CCD_PREVIEW_TIMING_COMPRESSION_ITEM_NAME  "COMPRESSION"
+
+/** CCD_PREVIEW_TIMING.TOTAL property item name.
+ */
+#define CCD_PREVIEW_TIMING_TOTAL_ITEM_NAME        "TOTAL"
+
+//------------------------------------------------------------------------
+/** CCD_STREAMING_STATS property name.
+ */
+#define CCD_STREAMING_STATS_PROPERTY_NAME         "CCD_STREAMING_STATS"
+
+/** CCD_STREAMING_STATS.SAVED property item name.
+ */
+#define CCD_STREAMING_STATS_SAVED_ITEM_NAME       "SAVED"
+
+/** CCD_STREAMING_STATS.DROPPED property item name.
+ */
+#define CCD_STREAMING_STATS_DROPPED_ITEM_NAME     "DROPPED"
+
+//------------------------------------------------------------------------
+/** CCD_IMAGE_COMPRESSION property name.
+ */
+#define CCD_IMAGE_COMPRESSION_PROPERTY_NAME       "CCD_IMAGE_COMPRESSION"
+
+/** CCD_IMAGE_COMPRESSION.NONE property item name.
+ */
+#define CCD_IMAGE_COMPRESSION_NONE_ITEM_NAME      "NONE"
+
+/** CCD_IMAGE_COMPRESSION.RICE property item name.
+ */
+#define CCD_IMAGE_COMPRESSION_RICE_ITEM_NAME      "RICE"
+
+/** CCD_IMAGE_COMPRESSION.GZIP property item name.
+ */
+#define CCD_IMAGE_COMPRESSION_GZIP_ITEM_NAME      "GZIP"
+
 //----------------------------------------------------------------------
 /** DSLR_PROGRAM property name.
  */
@@ -3032,6 +3096,42 @@ typedef enum {
 #define SERVER_BLOB_PROXY_DISABLED_ITEM_NAME					"DISABLED"
 #define SERVER_BLOB_PROXY_ENABLED_ITEM_NAME						"ENABLED"
 
+#define SERVER_BLOB_QUEUE_POLICY_PROPERTY_NAME				"BLOB_QUEUE_POLICY"
+#define SERVER_BLOB_QUEUE_DROP_OLDEST_ITEM_NAME				"DROP_OLDEST"
+#define SERVER_BLOB_QUEUE_BLOCK_ITEM_NAME							"BLOCK"
+#define SERVER_BLOB_QUEUE_URL_ONLY_ITEM_NAME					"URL_ONLY"
+
+#define SERVER_QUEUE_STATISTICS_PROPERTY_NAME					"QUEUE_STATISTICS"
+#define SERVER_QUEUE_CLIENTS_ITEM_NAME								"CLIENTS"
+#define SERVER_QUEUE_DEPTH_ITEM_NAME									"DEPTH"
+#define SERVER_QUEUE_MAX_DEPTH_ITEM_NAME							"MAX_DEPTH"
+#define SERVER_QUEUE_COALESCED_ITEM_NAME							"COALESCED"
+#define SERVER_QUEUE_DROPPED_ITEM_NAME								"DROPPED"
+#define SERVER_QUEUE_DROPPED_BLOBS_ITEM_NAME					"DROPPED_BLOBS"
+
+#define SERVER_BLOB_CACHE_STATISTICS_PROPERTY_NAME		"BLOB_CACHE_STATISTICS"
+#define SERVER_BLOB_CACHE_ENTRIES_ITEM_NAME						"ENTRIES"
+#define SERVER_BLOB_CACHE_MEMORY_ITEM_NAME						"MEMORY"
+#define SERVER_BLOB_CACHE_BUDGET_ITEM_NAME						"BUDGET"
+#define SERVER_BLOB_CACHE_HITS_ITEM_NAME							"HITS"
+#define SERVER_BLOB_CACHE_MISSES_ITEM_NAME						"MISSES"
+#define SERVER_BLOB_CACHE_EVICTIONS_ITEM_NAME					"EVICTIONS"
+
+#define SERVER_TIMER_STATISTICS_PROPERTY_NAME					"TIMER_STATISTICS"
+#define SERVER_TIMER_TIMERS_ITEM_NAME									"TIMERS"
+#define SERVER_TIMER_WORKERS_ITEM_NAME								"WORKERS"
+#define SERVER_TIMER_BUSY_WORKERS_ITEM_NAME						"BUSY_WORKERS"
+#define SERVER_TIMER_CALLBACKS_ITEM_NAME							"CALLBACKS"
+#define SERVER_TIMER_MAX_LATENESS_ITEM_NAME						"MAX_LATENESS"
+#define SERVER_TIMER_LATENESS_100US_ITEM_NAME					"LATENESS_100US"
+#define SERVER_TIMER_LATENESS_1MS_ITEM_NAME						"LATENESS_1MS"
+#define SERVER_TIMER_LATENESS_5MS_ITEM_NAME						"LATENESS_5MS"
+#define SERVER_TIMER_LATENESS_10MS_ITEM_NAME					"LATENESS_10MS"
+#define SERVER_TIMER_LATENESS_50MS_ITEM_NAME					"LATENESS_50MS"
+#define SERVER_TIMER_LATENESS_100MS_ITEM_NAME					"LATENESS_100MS"
+#define SERVER_TIMER_LATENESS_500MS_ITEM_NAME					"LATENESS_500MS"
+#define SERVER_TIMER_LATENESS_OVER_500MS_ITEM_NAME		"LATENESS_OVER_500MS"
+
 #define SERVER_FEATURES_PROPERTY_NAME									"FEATURES"
 #define SERVER_BONJOUR_ITEM_NAME											"BONJOUR"
 #define SERVER_CTRL_PANEL_ITEM_NAME										"CTRL_PANEL"
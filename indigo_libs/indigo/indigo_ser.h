@@ -23,18 +23,48 @@
 #define indigo_ser_h
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/time.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** SER writer, frames are copied to a ring of buffers and written by a background thread, frame is dropped if the ring is full.
+ */
 typedef struct {
 	int handle;
 	int count;
+	int dropped;
+	size_t frame_size;
+	int slot_count;
+	int head;
+	int pending;
+	bool running;
+	bool failed;
+	void *slots;
+	uint64_t *timestamps;
+	int timestamps_size;
+	pthread_t writer;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
 } indigo_ser;
 
+/** Create SER file, buffer is the first frame with indigo_raw_header.
+ */
 extern indigo_ser *indigo_ser_open(const char *filename, void *buffer);
+
+/** Add frame (with indigo_raw_header) timestamped with current time.
+ */
 extern bool indigo_ser_add_frame(indigo_ser *ser, void *buffer, size_t len);
+
+/** Add frame (with indigo_raw_header) with UTC timestamp taken at readout, returns false only if the file can't be written.
+ */
+extern bool indigo_ser_add_frame_with_timestamp(indigo_ser *ser, void *buffer, size_t len, struct timeval *timestamp);
+
+/** Write pending frames and timestamp trailer and close the file.
+ */
 extern bool indigo_ser_close(indigo_ser *ser);
 
 #ifdef __cplusplus
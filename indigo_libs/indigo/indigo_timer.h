@@ -45,21 +45,40 @@ typedef void (*indigo_timer_with_data_callback)(indigo_device *device, void *dat
 typedef struct indigo_timer {
 	indigo_device *device;                    ///< device associated with timer
 	void *callback;           								///< callback function pointer
-	bool canceled;                            ///< timer is canceled (darwin only)
-	bool scheduled;
-	bool callback_running;
-	double delay;
-	bool wake;
-	int timer_id;
-	pthread_cond_t cond;
-	pthread_mutex_t mutex;
-	pthread_mutex_t callback_mutex;
-	pthread_t thread;
+	bool canceled;                            ///< timer is canceled
+	bool scheduled;														///< timer is waiting in scheduler queue or rescheduled from callback
+	bool callback_running;										///< callback is executed by a worker
+	bool held;																///< timer is due, but callback of another timer of the same device is running
+	double delay;															///< delay in seconds
+	double due;																///< CLOCK_MONOTONIC time of next execution in seconds
+	int timer_id;															///< timer id (for logging)
+	int heap_index;														///< position in scheduler queue or -1
+	unsigned use_count;												///< incremented each time recycled timer is reused
+	pthread_t worker;													///< thread running callback
 	struct indigo_timer **reference;
 	struct indigo_timer *next;
 	void *data;
 } indigo_timer;
 
+/** Number of timer lateness histogram buckets.
+ */
+#define INDIGO_TIMER_LATENESS_BUCKETS		8
+
+/** Upper limits of timer lateness histogram buckets in seconds (the last bucket is unlimited).
+ */
+extern const double indigo_timer_lateness_limits[INDIGO_TIMER_LATENESS_BUCKETS - 1];
+
+/** Timer scheduler statistics.
+ */
+typedef struct {
+	int timers;																///< number of active timers
+	int workers;															///< number of worker threads
+	int busy_workers;													///< number of workers running callbacks
+	long callbacks;														///< number of executed callbacks
+	double max_lateness;											///< maximal lateness of callback execution in seconds
+	long lateness[INDIGO_TIMER_LATENESS_BUCKETS];	///< histogram of callback lateness
+} indigo_timer_statistics;
+
 /* fix timespec so that abs(tv_nsec) < 1s */
 #define SEC_NS    1000000000LL       /* 1 sec in nanoseconds */
 static inline void normalize_timespec(struct timespec *ts) {
@@ -112,6 +131,10 @@ extern bool indigo_cancel_timer_sync(indigo_device *device, indigo_timer **timer
  */
 extern void indigo_cancel_all_timers(indigo_device *device);
 
+/** Get timer scheduler statistics.
+ */
+extern void indigo_get_timer_statistics(indigo_timer_statistics *statistics);
+
 #ifdef __cplusplus
 }
 #endif
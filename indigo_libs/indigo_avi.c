@@ -46,169 +46,224 @@
 #include <string.h>
 #include <stdbool.h>
 #include <fcntl.h>
+#include <assert.h>
+#include <stdint.h>
 
 #include <indigo/indigo_bus.h>
 #include <indigo/indigo_io.h>
 #include <indigo/indigo_avi.h>
 
-static bool write_int(int handle, uint32_t n) {
-	unsigned char buffer[4];
-	buffer[0] = n;
-	buffer[1] = n >> 8;
-	buffer[2] = n >> 16;
-	buffer[3] = n >> 24;
-	return indigo_write(handle, (const char *)buffer, 4);
+#define HDRL_SIZE	(12 + 64 + 12 + 64 + 48 + 8 + 24 + 16 * GWAVI_SUPER_INDEX_SIZE + 12 + 8 + 248)
+
+static unsigned char *put_int(unsigned char *pnt, uint32_t n) {
+	pnt[0] = n;
+	pnt[1] = n >> 8;
+	pnt[2] = n >> 16;
+	pnt[3] = n >> 24;
+	return pnt + 4;
 }
 
-static bool write_short(int handle, uint16_t n) {
-	unsigned char buffer[2];
-	buffer[0] = n;
-	buffer[1] = n >> 8;
-	return indigo_write(handle, (const char *)buffer, 2);
+static unsigned char *put_long(unsigned char *pnt, uint64_t n) {
+	return put_int(put_int(pnt, (uint32_t)n), (uint32_t)(n >> 32));
 }
 
-static bool write_chars(int handle, const char *s) {
-	int count = (int)strlen(s);
-	return indigo_write(handle, s, count);
+static unsigned char *put_short(unsigned char *pnt, uint16_t n) {
+	pnt[0] = n;
+	pnt[1] = n >> 8;
+	return pnt + 2;
 }
 
-static bool write_chars_bin(int handle, const char *s, int count) {
-	return indigo_write(handle, s, count);
+static unsigned char *put_chars(unsigned char *pnt, const char *s) {
+	memcpy(pnt, s, 4);
+	return pnt + 4;
 }
 
-static bool tell(int handle, long *offset) {
-	return (*offset = lseek(handle, 0, SEEK_CUR)) != -1;
+static unsigned char *put_zeros(unsigned char *pnt, int count) {
+	memset(pnt, 0, count);
+	return pnt + count;
 }
 
-static bool seek(int handle, long offset) {
-	return lseek(handle, offset, SEEK_SET);
+/* hdrl LIST has fixed size, it is written on open and rewritten with final values on close */
+
+static void build_hdrl(struct gwavi_t *gwavi, unsigned char *hdrl) {
+	unsigned char *pnt = hdrl;
+	pnt = put_chars(pnt, "LIST");
+	pnt = put_int(pnt, HDRL_SIZE - 8);
+	pnt = put_chars(pnt, "hdrl");
+	struct gwavi_header_t *avi_header = &gwavi->avi_header;
+	pnt = put_chars(pnt, "avih");
+	pnt = put_int(pnt, 56);
+	pnt = put_int(pnt, avi_header->time_delay);
+	pnt = put_int(pnt, avi_header->data_rate);
+	pnt = put_int(pnt, avi_header->reserved);
+	pnt = put_int(pnt, avi_header->flags);
+	pnt = put_int(pnt, avi_header->number_of_frames);
+	pnt = put_int(pnt, avi_header->initial_frames);
+	pnt = put_int(pnt, avi_header->data_streams);
+	pnt = put_int(pnt, avi_header->buffer_size);
+	pnt = put_int(pnt, avi_header->width);
+	pnt = put_int(pnt, avi_header->height);
+	pnt = put_int(pnt, avi_header->time_scale);
+	pnt = put_int(pnt, avi_header->playback_data_rate);
+	pnt = put_int(pnt, avi_header->starting_time);
+	pnt = put_int(pnt, avi_header->data_length);
+	pnt = put_chars(pnt, "LIST");
+	pnt = put_int(pnt, 4 + 64 + 48 + 8 + 24 + 16 * GWAVI_SUPER_INDEX_SIZE);
+	pnt = put_chars(pnt, "strl");
+	struct gwavi_stream_header_t *stream_header = &gwavi->stream_header;
+	pnt = put_chars(pnt, "strh");
+	pnt = put_int(pnt, 56);
+	pnt = put_chars(pnt, stream_header->data_type);
+	pnt = put_chars(pnt, stream_header->codec);
+	pnt = put_int(pnt, stream_header->flags);
+	pnt = put_int(pnt, stream_header->priority);
+	pnt = put_int(pnt, stream_header->initial_frames);
+	pnt = put_int(pnt, stream_header->time_scale);
+	pnt = put_int(pnt, stream_header->data_rate);
+	pnt = put_int(pnt, stream_header->start_time);
+	pnt = put_int(pnt, stream_header->data_length);
+	pnt = put_int(pnt, stream_header->buffer_size);
+	pnt = put_int(pnt, stream_header->video_quality);
+	pnt = put_int(pnt, stream_header->sample_size);
+	pnt = put_zeros(pnt, 8);
+	struct gwavi_stream_format_t *stream_format = &gwavi->stream_format;
+	pnt = put_chars(pnt, "strf");
+	pnt = put_int(pnt, 40);
+	pnt = put_int(pnt, stream_format->header_size);
+	pnt = put_int(pnt, stream_format->width);
+	pnt = put_int(pnt, stream_format->height);
+	pnt = put_short(pnt, stream_format->num_planes);
+	pnt = put_short(pnt, stream_format->bits_per_pixel);
+	pnt = put_int(pnt, stream_format->compression_type);
+	pnt = put_int(pnt, stream_format->image_size);
+	pnt = put_int(pnt, stream_format->x_pels_per_meter);
+	pnt = put_int(pnt, stream_format->y_pels_per_meter);
+	pnt = put_int(pnt, stream_format->colors_used);
+	pnt = put_int(pnt, stream_format->colors_important);
+	/* super index (AVI_INDEX_OF_INDEXES), unused entries are left zero */
+	pnt = put_chars(pnt, "indx");
+	pnt = put_int(pnt, 24 + 16 * GWAVI_SUPER_INDEX_SIZE);
+	pnt = put_short(pnt, 4);
+	*pnt++ = 0;
+	*pnt++ = 0;
+	pnt = put_int(pnt, gwavi->super_index_count);
+	pnt = put_chars(pnt, "00dc");
+	pnt = put_zeros(pnt, 12);
+	for (int i = 0; i < GWAVI_SUPER_INDEX_SIZE; i++) {
+		struct gwavi_index_entry_t *entry = gwavi->super_index + i;
+		pnt = put_long(pnt, entry->offset);
+		pnt = put_int(pnt, entry->size);
+		pnt = put_int(pnt, entry->duration);
+	}
+	pnt = put_chars(pnt, "LIST");
+	pnt = put_int(pnt, 4 + 8 + 248);
+	pnt = put_chars(pnt, "odml");
+	pnt = put_chars(pnt, "dmlh");
+	pnt = put_int(pnt, 248);
+	pnt = put_int(pnt, gwavi->stream_header.data_length);
+	pnt = put_zeros(pnt, 244);
+	assert(pnt - hdrl == HDRL_SIZE);
 }
 
-static bool write_avi_header(int handle, struct gwavi_header_t *avi_header) {
-	long marker, t;
-	return
-		write_chars_bin(handle, "avih", 4) &&
-		tell(handle, &marker) &&
-		write_int(handle, 0) &&
-		write_int(handle, avi_header->time_delay) &&
-		write_int(handle, avi_header->data_rate) &&
-		write_int(handle, avi_header->reserved) &&
-		write_int(handle, avi_header->flags) &&
-		write_int(handle, avi_header->number_of_frames) &&
-		write_int(handle, avi_header->initial_frames) &&
-		write_int(handle, avi_header->data_streams) &&
-		write_int(handle, avi_header->buffer_size) &&
-		write_int(handle, avi_header->width) &&
-		write_int(handle, avi_header->height) &&
-		write_int(handle, avi_header->time_scale) &&
-		write_int(handle, avi_header->playback_data_rate) &&
-		write_int(handle, avi_header->starting_time) &&
-		write_int(handle, avi_header->data_length) &&
-		tell(handle, &t) &&
-		seek(handle, marker) &&
-		write_int(handle, (unsigned int)(t - marker - 4)) &&
-		seek(handle, t);
+static bool flush(struct gwavi_t *gwavi) {
+	if (gwavi->buffered == 0)
+		return true;
+	bool result = indigo_write(gwavi->handle, (const char *)gwavi->buffer, gwavi->buffered);
+	gwavi->buffered = 0;
+	return result;
 }
 
-static bool write_stream_header(int handle, struct gwavi_stream_header_t *stream_header) {
-	long marker, t;
-	return
-		write_chars_bin(handle, "strh", 4) &&
-		tell(handle, &marker) &&
-		write_int(handle, 0) &&
-		write_chars_bin(handle, stream_header->data_type, 4) &&
-		write_chars_bin(handle, stream_header->codec, 4) &&
-		write_int(handle, stream_header->flags) &&
-		write_int(handle, stream_header->priority) &&
-		write_int(handle, stream_header->initial_frames) &&
-		write_int(handle, stream_header->time_scale) &&
-		write_int(handle, stream_header->data_rate) &&
-		write_int(handle, stream_header->start_time) &&
-		write_int(handle, stream_header->data_length) &&
-		write_int(handle, stream_header->buffer_size) &&
-		write_int(handle, stream_header->video_quality) &&
-		write_int(handle, stream_header->sample_size) &&
-		write_int(handle, 0) &&
-		write_int(handle, 0) &&
-		tell(handle, &t) &&
-		seek(handle, marker) &&
-		write_int(handle, (unsigned int)(t - marker - 4)) &&
-		seek(handle, t);
+static bool write_bytes(struct gwavi_t *gwavi, const void *data, size_t len) {
+	if (gwavi->buffered + len > GWAVI_BUFFER_SIZE && !flush(gwavi))
+		return false;
+	gwavi->position += len;
+	if (len >= GWAVI_BUFFER_SIZE)
+		return indigo_write(gwavi->handle, data, len);
+	memcpy(gwavi->buffer + gwavi->buffered, data, len);
+	gwavi->buffered += len;
+	return true;
 }
 
-static bool write_stream_format(int handle, struct gwavi_stream_format_t *stream_format) {
-	long marker, t;
-	return
-		write_chars_bin(handle, "strf", 4) &&
-		tell(handle, &marker) &&
-		write_int(handle, 0) &&
-		write_int(handle, stream_format->header_size) &&
-		write_int(handle, stream_format->width) &&
-		write_int(handle, stream_format->height) &&
-		write_short(handle, stream_format->num_planes) &&
-		write_short(handle, stream_format->bits_per_pixel) &&
-		write_int(handle, stream_format->compression_type) &&
-		write_int(handle, stream_format->image_size) &&
-		write_int(handle, stream_format->x_pels_per_meter) &&
-		write_int(handle, stream_format->y_pels_per_meter) &&
-		write_int(handle, stream_format->colors_used) &&
-		write_int(handle, stream_format->colors_important) &&
-		tell(handle, &t) &&
-		seek(handle, marker) &&
-		write_int(handle, (unsigned int)(t - marker - 4)) &&
-		seek(handle, t);
+/* size fields are patched in the buffer if they were not flushed yet (flush would overwrite them), in the file otherwise */
+
+static bool patch_int(struct gwavi_t *gwavi, unsigned long long offset, uint32_t n) {
+	unsigned long long buffer_start = gwavi->position - gwavi->buffered;
+	if (offset >= buffer_start) {
+		put_int(gwavi->buffer + (offset - buffer_start), n);
+		return true;
+	}
+	unsigned char value[4];
+	put_int(value, n);
+	return pwrite(gwavi->handle, value, 4, offset) == 4;
 }
 
-static bool write_avi_header_chunk(struct gwavi_t *gwavi) {
-	long marker, sub_marker, t;
-	int handle = gwavi->handle;
-	return
-		write_chars_bin(handle, "LIST", 4) &&
-		tell(handle, &marker) &&
-		write_int(handle, 0) &&
-		write_chars_bin(handle, "hdrl", 4) &&
-		write_avi_header(handle, &gwavi->avi_header) &&
-		write_chars_bin(handle, "LIST", 4) &&
-		tell(handle, &sub_marker) &&
-		write_int(handle, 0) &&
-		write_chars_bin(handle, "strl", 4) &&
-		write_stream_header(handle, &gwavi->stream_header) &&
-		write_stream_format(handle, &gwavi->stream_format) &&
-		tell(handle, &t) &&
-		seek(handle, sub_marker) &&
-		write_int(handle, (unsigned int)(t - sub_marker - 4)) &&
-		seek(handle, t) &&
-		tell(handle, &t) &&
-		seek(handle, marker) &&
-		write_int(handle, (unsigned int)(t - marker - 4)) &&
-		seek(handle, t);
+static bool begin_riff(struct gwavi_t *gwavi, const char *type) {
+	unsigned char header[24], *pnt = header;
+	pnt = put_chars(pnt, "RIFF");
+	pnt = put_int(pnt, 0);
+	pnt = put_chars(pnt, type);
+	gwavi->riff_marker = gwavi->position + 4;
+	bool result = write_bytes(gwavi, header, pnt - header);
+	if (result && gwavi->super_index_count == 0) {
+		unsigned char hdrl[HDRL_SIZE];
+		build_hdrl(gwavi, hdrl);
+		result = write_bytes(gwavi, hdrl, HDRL_SIZE);
+	}
+	pnt = header;
+	pnt = put_chars(pnt, "LIST");
+	pnt = put_int(pnt, 0);
+	pnt = put_chars(pnt, "movi");
+	gwavi->movi_marker = gwavi->position + 4;
+	gwavi->entry_count = 0;
+	return result && write_bytes(gwavi, header, pnt - header);
 }
 
-static bool write_index(int handle, int count, unsigned int *offsets) {
-	long marker = 0, t;
-	unsigned int offset = 4;
-	bool result = (offsets != 0) &&
-		write_chars_bin(handle, "idx1", 4) &&
-		tell(handle, &marker) &&
-		write_int(handle, 0);
-	if (!result)
+static bool end_riff(struct gwavi_t *gwavi) {
+	if (gwavi->super_index_count == GWAVI_SUPER_INDEX_SIZE) {
+		INDIGO_ERROR(indigo_error("gwavi: super index is full"));
 		return false;
-	for (t = 0; t < count; t++) {
-		if ((offsets[t] & 0x80000000) == 0) {
-			result = write_chars(handle, "00dc");
-		} else {
-			result = write_chars(handle, "01wb");
-			offsets[t] &= 0x7fffffff;
+	}
+	/* standard index (AVI_INDEX_OF_CHUNKS) of this RIFF is the last chunk of movi */
+	unsigned long long base = gwavi->movi_marker;
+	unsigned int size = 24 + 8 * gwavi->entry_count;
+	unsigned char *index = indigo_safe_malloc(8 + size), *pnt = index;
+	pnt = put_chars(pnt, "ix00");
+	pnt = put_int(pnt, size);
+	pnt = put_short(pnt, 2);
+	*pnt++ = 0;
+	*pnt++ = 1;
+	pnt = put_int(pnt, gwavi->entry_count);
+	pnt = put_chars(pnt, "00dc");
+	pnt = put_long(pnt, base);
+	pnt = put_int(pnt, 0);
+	for (int i = 0; i < gwavi->entry_count; i++) {
+		pnt = put_int(pnt, (uint32_t)(gwavi->entries[i].offset - base));
+		pnt = put_int(pnt, gwavi->entries[i].size);
+	}
+	struct gwavi_index_entry_t *super_entry = gwavi->super_index + gwavi->super_index_count++;
+	super_entry->offset = gwavi->position;
+	super_entry->size = 8 + size;
+	super_entry->duration = gwavi->entry_count;
+	bool result = write_bytes(gwavi, index, 8 + size);
+	free(index);
+	result = result && patch_int(gwavi, gwavi->movi_marker, (uint32_t)(gwavi->position - gwavi->movi_marker - 4));
+	if (result && gwavi->super_index_count == 1) {
+		/* legacy index, offsets are relative to 'movi' */
+		gwavi->first_riff_frames = gwavi->entry_count;
+		unsigned char entry[16];
+		pnt = put_chars(entry, "idx1");
+		pnt = put_int(pnt, 16 * gwavi->entry_count);
+		result = write_bytes(gwavi, entry, pnt - entry);
+		for (int i = 0; result && i < gwavi->entry_count; i++) {
+			pnt = put_chars(entry, "00dc");
+			pnt = put_int(pnt, 0x10);
+			pnt = put_int(pnt, (uint32_t)(gwavi->entries[i].offset - 8 - gwavi->movi_marker - 4));
+			pnt = put_int(pnt, gwavi->entries[i].size);
+			result = write_bytes(gwavi, entry, pnt - entry);
 		}
-		result = result && write_int(handle, 0x10) && write_int(handle, offset) && write_int(handle, offsets[t]);
-		if (!result)
-			return false;
-		offset = offset + offsets[t] + 8;
 	}
-	result = tell(handle, &t) && seek(handle, marker) && write_int(handle, (unsigned int)(t - marker - 4)) && seek(handle, t);
-	return result;
+	return result && patch_int(gwavi, gwavi->riff_marker, (uint32_t)(gwavi->position - gwavi->riff_marker - 4));
 }
-
 /**
  * This is the first function you should call when using gwavi library.
  * It allocates memory for a gwavi_t structure and returns it and takes care of
@@ -279,26 +334,19 @@ struct gwavi_t *gwavi_open(const char *filename, unsigned int width, unsigned in
 	gwavi->stream_format.colors_important = 0;
 	gwavi->stream_format.palette = 0;
 	gwavi->stream_format.palette_count = 0;
-	if (!write_chars_bin(handle, "RIFF", 4) || !write_int(handle, 0))
-		goto failure;
-	if (!write_chars_bin(handle, "AVI ", 4) ||  !write_avi_header_chunk(gwavi))
-		goto failure;
-	if (!write_chars_bin(handle, "LIST", 4) || !tell(handle, &gwavi->marker) || !write_int(handle, 0) || !write_chars_bin(handle, "movi", 4))
-		goto failure;
-	gwavi->offsets_len = 1024;
-	if ((gwavi->offsets = (unsigned int *)malloc((size_t)gwavi->offsets_len * sizeof(unsigned int))) == NULL) {
-		INDIGO_ERROR(indigo_error("gwavi_open: could not allocate memory for gwavi offsets table"));
+	gwavi->buffer = indigo_safe_malloc(GWAVI_BUFFER_SIZE);
+	gwavi->entries_len = 1024;
+	gwavi->entries = indigo_safe_malloc(gwavi->entries_len * sizeof(struct gwavi_index_entry_t));
+	if (!begin_riff(gwavi, "AVI "))
 		goto failure;
-	}
-	gwavi->offsets_ptr = 0;
 	return gwavi;
 failure:
 	if (handle != -1) {
 		close(handle);
 	}
 	if (gwavi) {
-		if (gwavi->offsets)
-			free(gwavi->offsets);
+		indigo_safe_free(gwavi->buffer);
+		indigo_safe_free(gwavi->entries);
 		free(gwavi);
 	}
 	return NULL;
@@ -314,28 +362,41 @@ failure:
  * @return true on success, false on error.
  */
 bool gwavi_add_frame(struct gwavi_t *gwavi, unsigned char *buffer, size_t len) {
-	size_t maxi_pad;  /* if your frame is raggin, give it some paddin' */
-	size_t t;
-	char zero = 0;
 	if (!gwavi || !buffer || len < 256)
 		return false;
-	gwavi->offset_count++;
+	size_t pad = len & 1;
+	/* frame, ix00 and (in the first RIFF) idx1 must fit */
+	unsigned long long riff_size = gwavi->position - gwavi->riff_marker + 8 + len + pad + 32 + 8 * (gwavi->entry_count + 1);
+	if (gwavi->super_index_count == 0)
+		riff_size += 8 + 16 * (gwavi->entry_count + 1);
+	if (riff_size > GWAVI_RIFF_SIZE && gwavi->entry_count > 0) {
+		if (!end_riff(gwavi) || !begin_riff(gwavi, "AVIX"))
+			return false;
+	}
+	if (gwavi->entry_count == gwavi->entries_len) {
+		gwavi->entries_len += 1024;
+		gwavi->entries = indigo_safe_realloc(gwavi->entries, gwavi->entries_len * sizeof(struct gwavi_index_entry_t));
+	}
+	struct gwavi_index_entry_t *entry = gwavi->entries + gwavi->entry_count++;
+	/* OpenDML index points to frame data, not to chunk header */
+	entry->offset = gwavi->position + 8;
+	entry->size = (uint32_t)len;
 	gwavi->stream_header.data_length++;
-	maxi_pad = len % 4;
-	if (maxi_pad > 0)
-		maxi_pad = 4 - maxi_pad;
-	if (gwavi->offset_count >= gwavi->offsets_len) {
-		gwavi->offsets_len += 1024;
-		gwavi->offsets = (unsigned int *)realloc(gwavi->offsets, (size_t)gwavi->offsets_len * sizeof(unsigned int));
+	unsigned char header[8];
+	put_int(put_chars(header, "00dc"), (uint32_t)len);
+	if (gwavi->buffered + 8 + len + pad <= GWAVI_BUFFER_SIZE) {
+		memcpy(gwavi->buffer + gwavi->buffered, header, 8);
+		memcpy(gwavi->buffer + gwavi->buffered + 8, buffer, len);
+		if (pad)
+			gwavi->buffer[gwavi->buffered + 8 + len] = 0;
+		gwavi->buffered += 8 + len + pad;
+		gwavi->position += 8 + len + pad;
+		return true;
 	}
-	gwavi->offsets[gwavi->offsets_ptr++] = (unsigned int)(len + maxi_pad);
-	if (!write_chars_bin(gwavi->handle, "00dc", 4) || !write_int(gwavi->handle, (unsigned int)(len + maxi_pad)) || !indigo_write(gwavi->handle, (const char *)buffer, len))
+	if (!flush(gwavi) || !indigo_writev(gwavi->handle, (const char *)header, 8, (const char *)buffer, len))
 		return false;
-	for (t = 0; t < maxi_pad; t++) {
-		if (!indigo_write(gwavi->handle, &zero, 1))
-			return false;
-	}
-	return true;
+	gwavi->position += 8 + len;
+	return !pad || write_bytes(gwavi, "", 1);
 }
 
 /**
@@ -348,28 +409,18 @@ bool gwavi_add_frame(struct gwavi_t *gwavi, unsigned char *buffer, size_t len) {
  * @return 0 on success, -1 on error.
  */
 bool gwavi_close(struct gwavi_t *gwavi) {
-	long t;
 	if (!gwavi)
 		return false;
-	int handle = gwavi->handle;
-	if (!tell(handle, &t) || !seek(handle, gwavi->marker) || !write_int(handle, (unsigned int)(t - gwavi->marker - 4)))
-		goto failure;
-	if (!seek(handle, t) || !write_index(handle, gwavi->offset_count, gwavi->offsets))
-		goto failure;
-	free(gwavi->offsets);
-	gwavi->offsets = NULL;
-	gwavi->avi_header.number_of_frames = gwavi->stream_header.data_length;
-	if (!tell(handle, &t) || !seek(handle, 12) || !write_avi_header_chunk(gwavi) || !seek(handle, t))
-		goto failure;
-	if (!seek(handle, 4) || !write_int(handle, (unsigned int)(t - 8)))
-		goto failure;
-	close(handle);
-	free(gwavi);
-	return true;
-failure:
-	if (gwavi->offsets)
-		free(gwavi->offsets);
-	close(handle);
+	bool result = end_riff(gwavi) && flush(gwavi);
+	if (result) {
+		unsigned char hdrl[HDRL_SIZE];
+		gwavi->avi_header.number_of_frames = gwavi->first_riff_frames;
+		build_hdrl(gwavi, hdrl);
+		result = pwrite(gwavi->handle, hdrl, HDRL_SIZE, 12) == HDRL_SIZE;
+	}
+	close(gwavi->handle);
+	indigo_safe_free(gwavi->buffer);
+	indigo_safe_free(gwavi->entries);
 	free(gwavi);
-	return false;
+	return result;
 }
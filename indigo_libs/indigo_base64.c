@@ -24,6 +24,159 @@
 #include <indigo/indigo_base64.h>
 #include <indigo/indigo_base64_luts.h>
 #include <stdio.h>
+#include <pthread.h>
+
+// SIMD kernels process the bulk of the data, the scalar code below handles the tail.
+// Decoders don't validate input (like the scalar one) and always leave the last quadruple to the scalar code
+// because of padding, encoders never touch more than inlen input bytes and decoders never write behind the decoded data.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BASE64_X86
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#define BASE64_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef BASE64_X86
+
+__attribute__((target("ssse3"))) static long encode_ssse3(unsigned char *out, const unsigned char *in, long inlen) {
+	const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+	long done = 0;
+	for (; inlen - done >= 16; done += 12, out += 16) {
+		__m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + done)), shuffle);
+		__m128i hi = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+		__m128i lo = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+		__m128i indices = _mm_or_si128(hi, lo);
+		__m128i offset = _mm_sub_epi8(_mm_subs_epu8(indices, _mm_set1_epi8(51)), _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+		_mm_storeu_si128((__m128i *)out, _mm_add_epi8(indices, _mm_shuffle_epi8(lut, offset)));
+	}
+	return done;
+}
+
+__attribute__((target("avx2"))) static long encode_avx2(unsigned char *out, const unsigned char *in, long inlen) {
+	const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const __m256i lut = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0, 65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+	long done = 0;
+	for (; inlen - done >= 28; done += 24, out += 32) {
+		__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(in + done))), _mm_loadu_si128((const __m128i *)(in + done + 12)), 1);
+		v = _mm256_shuffle_epi8(v, shuffle);
+		__m256i hi = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+		__m256i lo = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+		__m256i indices = _mm256_or_si256(hi, lo);
+		__m256i offset = _mm256_sub_epi8(_mm256_subs_epu8(indices, _mm256_set1_epi8(51)), _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+		_mm256_storeu_si256((__m256i *)out, _mm256_add_epi8(indices, _mm256_shuffle_epi8(lut, offset)));
+	}
+	return done;
+}
+
+__attribute__((target("ssse3"))) static long decode_ssse3(unsigned char *out, const unsigned char *in, long inlen) {
+	const __m128i roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	long done = 0;
+	// 16 bytes are stored for 12 decoded, at least 2 quadruples (4+ bytes) must follow
+	for (; inlen - done >= 24; done += 16, out += 12) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(in + done));
+		__m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0f));
+		__m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+		v = _mm_add_epi8(v, _mm_shuffle_epi8(roll, _mm_add_epi8(slash, hi_nibbles)));
+		v = _mm_madd_epi16(_mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+		_mm_storeu_si128((__m128i *)out, _mm_shuffle_epi8(v, pack));
+	}
+	return done;
+}
+
+__attribute__((target("avx2"))) static long decode_avx2(unsigned char *out, const unsigned char *in, long inlen) {
+	const __m256i roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	const __m256i permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+	long done = 0;
+	// 32 bytes are stored for 24 decoded, at least 4 quadruples (10+ bytes) must follow
+	for (; inlen - done >= 48; done += 32, out += 24) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(in + done));
+		__m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0f));
+		__m256i slash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'));
+		v = _mm256_add_epi8(v, _mm256_shuffle_epi8(roll, _mm256_add_epi8(slash, hi_nibbles)));
+		v = _mm256_madd_epi16(_mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+		_mm256_storeu_si256((__m256i *)out, _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, pack), permute));
+	}
+	return done;
+}
+
+#endif
+
+#ifdef BASE64_NEON
+
+static long encode_neon(unsigned char *out, const unsigned char *in, long inlen) {
+	const uint8x16x4_t lut = vld1q_u8_x4((const uint8_t *)base64digits);
+	const uint8x16_t mask = vdupq_n_u8(0x3f);
+	long done = 0;
+	for (; inlen - done >= 48; done += 48, out += 64) {
+		uint8x16x3_t v = vld3q_u8(in + done);
+		uint8x16x4_t r;
+		r.val[0] = vshrq_n_u8(v.val[0], 2);
+		r.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(v.val[0], 4), vshrq_n_u8(v.val[1], 4)), mask);
+		r.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(v.val[1], 2), vshrq_n_u8(v.val[2], 6)), mask);
+		r.val[3] = vandq_u8(v.val[2], mask);
+		r.val[0] = vqtbl4q_u8(lut, r.val[0]);
+		r.val[1] = vqtbl4q_u8(lut, r.val[1]);
+		r.val[2] = vqtbl4q_u8(lut, r.val[2]);
+		r.val[3] = vqtbl4q_u8(lut, r.val[3]);
+		vst4q_u8(out, r);
+	}
+	return done;
+}
+
+static long decode_neon(unsigned char *out, const unsigned char *in, long inlen) {
+	static const uint8_t roll_table[16] = { 0, 16, 19, 4, 191, 191, 185, 185, 0, 0, 0, 0, 0, 0, 0, 0 };
+	const uint8x16_t roll = vld1q_u8(roll_table);
+	const uint8x16_t slash = vdupq_n_u8('/');
+	long done = 0;
+	for (; inlen - done >= 68; done += 64, out += 48) {
+		uint8x16x4_t v = vld4q_u8(in + done);
+		for (int i = 0; i < 4; i++) {
+			uint8x16_t index = vaddq_u8(vshrq_n_u8(v.val[i], 4), vceqq_u8(v.val[i], slash));
+			v.val[i] = vaddq_u8(v.val[i], vqtbl1q_u8(roll, index));
+		}
+		uint8x16x3_t r;
+		r.val[0] = vorrq_u8(vshlq_n_u8(v.val[0], 2), vshrq_n_u8(v.val[1], 4));
+		r.val[1] = vorrq_u8(vshlq_n_u8(v.val[1], 4), vshrq_n_u8(v.val[2], 2));
+		r.val[2] = vorrq_u8(vshlq_n_u8(v.val[2], 6), v.val[3]);
+		vst3q_u8(out, r);
+	}
+	return done;
+}
+
+#endif
+
+static long encode_none(unsigned char *out, const unsigned char *in, long inlen) {
+	return 0;
+}
+
+static long decode_none(unsigned char *out, const unsigned char *in, long inlen) {
+	return 0;
+}
+
+static long (*encode_kernel)(unsigned char *out, const unsigned char *in, long inlen) = encode_none;
+static long (*decode_kernel)(unsigned char *out, const unsigned char *in, long inlen) = decode_none;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+static void select_kernels(void) {
+#if defined(BASE64_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		encode_kernel = encode_avx2;
+		decode_kernel = decode_avx2;
+	} else if (__builtin_cpu_supports("ssse3")) {
+		encode_kernel = encode_ssse3;
+		decode_kernel = decode_ssse3;
+	}
+#elif defined(BASE64_NEON)
+	encode_kernel = encode_neon;
+	decode_kernel = decode_neon;
+#endif
+}
 
 /* out size should be at least 4*inlen/3 + 4.
  * returns length of out (without trailing NULL).
@@ -31,6 +184,11 @@
 long base64_encode(unsigned char *out, const unsigned char *in, long inlen) {
 	uint16_t* b64lut = (uint16_t*)base64lut;
 	long dlen = ((inlen+2)/3)*4; /* 4/3, rounded up */
+	pthread_once(&kernel_once, select_kernels);
+	long done = encode_kernel(out, in, inlen);
+	in += done;
+	out += done / 3 * 4;
+	inlen -= done;
 	uint16_t* wbuf = (uint16_t*)out;
 
 	for(; inlen > 2; inlen -= 3 ) {
@@ -60,7 +218,12 @@ long base64_encode(unsigned char *out, const unsigned char *in, long inlen) {
 
 /* base64 should not contain whitespaces.*/
 long base64_decode_fast(unsigned char* out, const unsigned char* in, long inlen) {
-	long outlen = 0;
+	pthread_once(&kernel_once, select_kernels);
+	long done = decode_kernel(out, in, inlen);
+	long outlen = done / 4 * 3;
+	in += done;
+	out += outlen;
+	inlen -= done;
 	uint8_t b1, b2, b3;
 	uint16_t s1, s2;
 	uint32_t n32;
@@ -89,7 +252,7 @@ long base64_decode_fast(unsigned char* out, const unsigned char* in, long inlen)
 		inp += 2;
 		out += 3;
 	}
-	outlen = (inlen / 4 - 1) * 3;
+	outlen += (inlen / 4 - 1) * 3;
 
 	s1 = rbase64lut[ inp[0] ];
 	s2 = rbase64lut[ inp[1] ];
@@ -123,12 +286,14 @@ long base64_decode_fast_nl(unsigned char* out, const unsigned char* in, long inl
 	uint8_t b1, b2, b3;
 	uint16_t s1, s2;
 	uint32_t n32;
-	int j;
-	long n = (inlen/4)-1;
-	uint16_t* inp = (uint16_t*)in;
+	uint16_t* inp;
+	const unsigned char* end = in + inlen;
 
-	for( j = 0; j < n; j++ ) {
+	/* line breaks don't count, group count is not known in advance */
+	while (end > in && end[-1] == '\n') end--;
+	for(;;) {
 		if (in[0] == '\n') in++;
+		if (end - in <= 4) break;
 		inp = (uint16_t*)in;
 
 		s1 = rbase64lut[ inp[0] ];
@@ -150,9 +315,8 @@ long base64_decode_fast_nl(unsigned char* out, const unsigned char* in, long inl
 
 		in += 4;
 		out += 3;
+		outlen += 3;
 	}
-	outlen = (inlen / 4 - 1) * 3;
-	if (in[0] == '\n') in++;
 	inp = (uint16_t*)in;
 
 	s1 = rbase64lut[ inp[0] ];
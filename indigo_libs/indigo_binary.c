@@ -0,0 +1,1511 @@
+// Copyright (c) 2024 CloudMakers, s. r. o.
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by Peter Polakovic <peter.polakovic@cloudmakers.eu>
+
+/** INDIGO binary wire protocol
+ \file indigo_binary.c
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <assert.h>
+#include <libgen.h>
+#include <sys/socket.h>
+
+#include <indigo/indigo_io.h>
+#include <indigo/indigo_version.h>
+#include <indigo/indigo_client.h>
+#include <indigo/indigo_xml.h>
+#include <indigo/indigo_driver_xml.h>
+#include <indigo/indigo_binary.h>
+
+#define FRAME_BUFFER_SIZE		1024
+#define INPUT_BUFFER_SIZE		262144
+#define MAX_FRAME_SIZE			(64L * 1024 * 1024)
+#define MAX_BLOB_SIZE				(1024L * 1024 * 1024)
+#define MAX_SYMBOLS					65536
+#define SYMBOL_BUCKETS			4096
+#define PROPERTY_BUCKETS		1024
+#define HANDSHAKE_TIMEOUT		5000000
+#define HASH_SEED						2166136261u
+
+// Frame is 32-bit little endian length followed by frame type and body, raw BLOB payloads follow the body. Strings are varint length,
+// bytes and terminating 0 (so they can be used in place), names are either varint (index << 1) or ((length << 1) | 1) followed by the name.
+
+typedef enum {
+	GET_PROPERTIES = 1,
+	NEW_PROPERTY,
+	ENABLE_BLOB,
+	DEFINE_PROPERTY,
+	UPDATE_PROPERTY,
+	DELETE_PROPERTY,
+	MESSAGE
+} frame_type;
+
+typedef enum {
+	BLOB_NONE,
+	BLOB_PATH,
+	BLOB_URL,
+	BLOB_INLINE
+} blob_kind;
+
+typedef struct symbol {
+	struct symbol *next;
+	uint32_t hash;
+	uint32_t id;
+	char name[];
+} symbol;
+
+typedef struct {
+	symbol *buckets[SYMBOL_BUCKETS];
+	uint32_t count;
+} symbol_table;
+
+typedef struct {
+	char **names;
+	uint32_t count;
+	uint32_t capacity;
+} name_table;
+
+typedef struct {
+	char *data;
+	long size;
+	indigo_blob_buffer *buffer;
+	bool borrowed;
+} frame_payload;
+
+typedef struct binary_frame {
+	struct binary_frame *next;
+	char *data;
+	long size;
+	long capacity;
+	bool defines;
+	bool blob;
+	int payload_count;
+	frame_payload payloads[];
+} binary_frame;
+
+typedef struct {
+	const unsigned char *pointer;
+	const unsigned char *end;
+	bool error;
+} frame_reader;
+
+typedef struct {
+	int handle;
+	char *buffer;
+	long start;
+	long end;
+	long capacity;
+} frame_input;
+
+// indigo_adapter_context must be the first member, device_context/client_context is used as indigo_adapter_context elsewhere
+
+typedef struct {
+	indigo_adapter_context adapter;
+	pthread_mutex_t encode_mutex;
+	symbol_table symbols;
+	pthread_mutex_t queue_mutex;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	pthread_t writer;
+	bool writer_started;
+	binary_frame *head, *tail;
+	int depth;
+	int blobs;
+	bool closed;
+} binary_context;
+
+typedef struct cached_property {
+	struct cached_property *next;
+	uint32_t hash;
+	indigo_property *property;
+} cached_property;
+
+typedef struct {
+	indigo_device *device;
+	indigo_client *client;
+	frame_input input;
+	name_table names;
+	cached_property *properties[PROPERTY_BUCKETS];
+	char device_name[INDIGO_NAME_SIZE];
+	char message[INDIGO_VALUE_SIZE];
+} parser_context;
+
+bool indigo_use_binary_protocol = true;
+long indigo_binary_blob_size_limit = MAX_BLOB_SIZE;
+
+extern char *indigo_client_name;
+
+static char empty_string[1] = "";
+
+static uint32_t hash_name(const char *name, uint32_t hash) {
+	while (*name)
+		hash = (hash ^ (unsigned char)*name++) * 16777619u;
+	return hash;
+}
+
+static void release_symbols(symbol_table *table) {
+	for (int i = 0; i < SYMBOL_BUCKETS; i++) {
+		symbol *entry = table->buckets[i];
+		while (entry) {
+			symbol *next = entry->next;
+			free(entry);
+			entry = next;
+		}
+		table->buckets[i] = NULL;
+	}
+	table->count = 0;
+}
+
+static void release_names(name_table *table) {
+	for (uint32_t i = 0; i < table->count; i++)
+		free(table->names[i]);
+	indigo_safe_free(table->names);
+	table->names = NULL;
+	table->count = table->capacity = 0;
+}
+
+// frame encoding
+
+static binary_frame *create_frame(frame_type type, int payloads) {
+	binary_frame *frame = indigo_safe_malloc(sizeof(binary_frame) + payloads * sizeof(frame_payload));
+	frame->data = indigo_safe_malloc(frame->capacity = FRAME_BUFFER_SIZE);
+	frame->size = 4;
+	frame->data[frame->size++] = type;
+	return frame;
+}
+
+static void release_frame(binary_frame *frame) {
+	for (int i = 0; i < frame->payload_count; i++) {
+		frame_payload *payload = frame->payloads + i;
+		if (payload->buffer)
+			indigo_release_blob_buffer(payload->buffer);
+		else if (!payload->borrowed)
+			indigo_safe_free(payload->data);
+	}
+	free(frame->data);
+	free(frame);
+}
+
+static inline void reserve(binary_frame *frame, long length) {
+	if (frame->size + length > frame->capacity) {
+		while (frame->size + length > frame->capacity)
+			frame->capacity *= 2;
+		frame->data = indigo_safe_realloc(frame->data, frame->capacity);
+	}
+}
+
+static inline void put_byte(binary_frame *frame, uint8_t value) {
+	reserve(frame, 1);
+	frame->data[frame->size++] = value;
+}
+
+static inline void put_varint(binary_frame *frame, uint64_t value) {
+	reserve(frame, 10);
+	while (value >= 0x80) {
+		frame->data[frame->size++] = (char)(value | 0x80);
+		value >>= 7;
+	}
+	frame->data[frame->size++] = (char)value;
+}
+
+static inline void put_double(binary_frame *frame, double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	reserve(frame, 8);
+	for (int i = 0; i < 8; i++) {
+		frame->data[frame->size++] = (char)bits;
+		bits >>= 8;
+	}
+}
+
+static inline void put_bytes(binary_frame *frame, const char *bytes, long length) {
+	reserve(frame, length + 1);
+	memcpy(frame->data + frame->size, bytes, length);
+	frame->size += length;
+	frame->data[frame->size++] = 0;
+}
+
+static void put_string(binary_frame *frame, const char *string) {
+	long length = strlen(string);
+	put_varint(frame, length);
+	put_bytes(frame, string, length);
+}
+
+static void put_message(binary_frame *frame, const char *message) {
+	if (message == NULL) {
+		put_varint(frame, 0);
+	} else {
+		long length = strlen(message);
+		put_varint(frame, length + 1);
+		put_bytes(frame, message, length);
+	}
+}
+
+static void put_name(binary_frame *frame, symbol_table *table, const char *name) {
+	uint32_t hash = hash_name(name, HASH_SEED);
+	symbol **bucket = table->buckets + hash % SYMBOL_BUCKETS;
+	for (symbol *entry = *bucket; entry; entry = entry->next) {
+		if (entry->hash == hash && !strcmp(entry->name, name)) {
+			put_varint(frame, (uint64_t)entry->id << 1);
+			return;
+		}
+	}
+	long length = strlen(name);
+	if (table->count < MAX_SYMBOLS) {
+		symbol *entry = indigo_safe_malloc(sizeof(symbol) + length + 1);
+		entry->hash = hash;
+		entry->id = table->count++;
+		memcpy(entry->name, name, length + 1);
+		entry->next = *bucket;
+		*bucket = entry;
+		frame->defines = true;
+	}
+	put_varint(frame, (uint64_t)length << 1 | 1);
+	put_bytes(frame, name, length);
+}
+
+static long put_payload(binary_frame *frame, indigo_item *item, bool borrow) {
+	frame_payload *payload = frame->payloads + frame->payload_count++;
+	if (item->blob.value == NULL || item->blob.size == 0)
+		return 0;
+	if (borrow) {
+		payload->data = item->blob.value;
+		payload->borrowed = true;
+	} else if (item->blob.buffer) {
+		payload->buffer = indigo_retain_blob_buffer(item->blob.buffer);
+		payload->data = item->blob.value;
+	} else {
+		indigo_blob_entry *entry;
+		if (indigo_use_blob_caching && (entry = indigo_validate_blob(item))) {
+			void *content;
+			long size;
+			indigo_blob_buffer *buffer = indigo_retain_blob_content(entry, 0, &content, &size);
+			if (buffer && size == item->blob.size) {
+				payload->buffer = buffer;
+				payload->data = content;
+				return payload->size = size;
+			}
+			if (buffer)
+				indigo_release_blob_buffer(buffer);
+		}
+		// value is copied once for all clients of this update
+		payload->buffer = indigo_share_blob_value(item);
+		payload->data = payload->buffer->data;
+	}
+	return payload->size = item->blob.size;
+}
+
+static void finish_frame(binary_frame *frame) {
+	uint32_t length = (uint32_t)(frame->size - 4);
+	for (int i = 0; i < 4; i++) {
+		frame->data[i] = (char)length;
+		length >>= 8;
+	}
+}
+
+static bool write_frame(int handle, binary_frame *frame) {
+	if (frame->payload_count == 0 || frame->payloads[0].size == 0) {
+		if (!indigo_write(handle, frame->data, frame->size))
+			return false;
+	} else if (!indigo_writev(handle, frame->data, frame->size, frame->payloads[0].data, frame->payloads[0].size)) {
+		return false;
+	}
+	for (int i = 1; i < frame->payload_count; i++) {
+		if (frame->payloads[i].size && !indigo_write(handle, frame->payloads[i].data, frame->payloads[i].size))
+			return false;
+	}
+	return true;
+}
+
+// frame decoding
+
+static inline uint8_t get_byte(frame_reader *reader) {
+	if (reader->pointer >= reader->end) {
+		reader->error = true;
+		return 0;
+	}
+	return *reader->pointer++;
+}
+
+static inline uint64_t get_varint(frame_reader *reader) {
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (reader->pointer >= reader->end)
+			break;
+		uint8_t byte = *reader->pointer++;
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			return value;
+	}
+	reader->error = true;
+	return 0;
+}
+
+static inline double get_double(frame_reader *reader) {
+	if (reader->end - reader->pointer < 8) {
+		reader->error = true;
+		return 0;
+	}
+	uint64_t bits = 0;
+	for (int i = 7; i >= 0; i--)
+		bits = bits << 8 | reader->pointer[i];
+	reader->pointer += 8;
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static char *get_bytes(frame_reader *reader, uint64_t length) {
+	if (reader->error || (uint64_t)(reader->end - reader->pointer) <= length || reader->pointer[length] != 0) {
+		reader->error = true;
+		return empty_string;
+	}
+	char *bytes = (char *)reader->pointer;
+	reader->pointer += length + 1;
+	return bytes;
+}
+
+static char *get_string(frame_reader *reader) {
+	return get_bytes(reader, get_varint(reader));
+}
+
+static char *get_message(frame_reader *reader) {
+	uint64_t length = get_varint(reader);
+	if (length == 0)
+		return NULL;
+	return get_bytes(reader, length - 1);
+}
+
+static char *get_name(frame_reader *reader, name_table *table) {
+	uint64_t value = get_varint(reader);
+	if (value & 1) {
+		char *name = get_bytes(reader, value >> 1);
+		if (!reader->error && table->count < MAX_SYMBOLS) {
+			if (table->count == table->capacity)
+				table->names = indigo_safe_realloc(table->names, (table->capacity = table->capacity ? 2 * table->capacity : 256) * sizeof(char *));
+			table->names[table->count++] = strdup(name);
+		}
+		return name;
+	}
+	if ((value >> 1) >= table->count) {
+		reader->error = true;
+		return empty_string;
+	}
+	return table->names[value >> 1];
+}
+
+static bool fill_input(frame_input *input, long length) {
+	if (input->end - input->start >= length)
+		return true;
+	if (input->start > 0) {
+		memmove(input->buffer, input->buffer + input->start, input->end - input->start);
+		input->end -= input->start;
+		input->start = 0;
+	}
+	if (length > input->capacity)
+		input->buffer = indigo_safe_realloc(input->buffer, input->capacity = length);
+	while (input->end < length) {
+		ssize_t count = read(input->handle, input->buffer + input->end, input->capacity - input->end);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count <= 0)
+			return false;
+		input->end += count;
+	}
+	return true;
+}
+
+// payload size is checked before anything is allocated for it, total size of payloads of one frame is limited
+
+static bool check_payload_size(uint64_t size, long *total) {
+	if (size > (uint64_t)(indigo_binary_blob_size_limit - *total)) {
+		indigo_error("Binary Parser: BLOB size %llu exceeds limit %ld", (unsigned long long)size, indigo_binary_blob_size_limit);
+		return false;
+	}
+	*total += (long)size;
+	return true;
+}
+
+// payload follows the frame, buffered part is copied and the rest is read directly to its destination
+
+static bool read_payload(frame_input *input, char *data, long size) {
+	long buffered = input->end - input->start;
+	if (buffered > size)
+		buffered = size;
+	memcpy(data, input->buffer + input->start, buffered);
+	input->start += buffered;
+	data += buffered;
+	size -= buffered;
+	while (size > 0) {
+		ssize_t count = read(input->handle, data, size);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count <= 0)
+			return false;
+		data += count;
+		size -= count;
+	}
+	return true;
+}
+
+static bool skip_payload(frame_input *input, long size) {
+	char data[4096];
+	while (size > 0) {
+		long length = size < (long)sizeof(data) ? size : (long)sizeof(data);
+		if (!read_payload(input, data, length))
+			return false;
+		size -= length;
+	}
+	return true;
+}
+
+// handshake
+
+bool indigo_binary_connect(int handle) {
+	char reply[INDIGO_BINARY_MAGIC_SIZE];
+	if (!indigo_write(handle, INDIGO_BINARY_MAGIC, INDIGO_BINARY_MAGIC_SIZE))
+		return false;
+	if (indigo_select(handle, HANDSHAKE_TIMEOUT) <= 0)
+		return false;
+	if (indigo_read(handle, reply, INDIGO_BINARY_MAGIC_SIZE) != INDIGO_BINARY_MAGIC_SIZE)
+		return false;
+	return memcmp(reply, INDIGO_BINARY_MAGIC, INDIGO_BINARY_MAGIC_SIZE) == 0;
+}
+
+bool indigo_binary_accept(int handle) {
+	char request[INDIGO_BINARY_MAGIC_SIZE];
+	if (indigo_read(handle, request, INDIGO_BINARY_MAGIC_SIZE) != INDIGO_BINARY_MAGIC_SIZE)
+		return false;
+	if (memcmp(request, INDIGO_BINARY_MAGIC, INDIGO_BINARY_MAGIC_SIZE))
+		return false;
+	return indigo_write(handle, INDIGO_BINARY_MAGIC, INDIGO_BINARY_MAGIC_SIZE);
+}
+
+// adapter context
+
+static binary_context *create_context(int input, int output) {
+	binary_context *context = indigo_safe_malloc(sizeof(binary_context));
+	context->adapter.input = input;
+	context->adapter.output = output;
+	pthread_mutex_init(&context->encode_mutex, NULL);
+	pthread_mutex_init(&context->queue_mutex, NULL);
+	pthread_cond_init(&context->not_empty, NULL);
+	pthread_cond_init(&context->not_full, NULL);
+	return context;
+}
+
+static void release_context(binary_context *context) {
+	release_symbols(&context->symbols);
+	pthread_cond_destroy(&context->not_full);
+	pthread_cond_destroy(&context->not_empty);
+	pthread_mutex_destroy(&context->queue_mutex);
+	pthread_mutex_destroy(&context->encode_mutex);
+	free(context);
+}
+
+static void discard_frames(binary_context *context) {
+	while (context->head) {
+		binary_frame *frame = context->head;
+		context->head = frame->next;
+		release_frame(frame);
+	}
+	context->tail = NULL;
+	context->depth = context->blobs = 0;
+}
+
+static void *writer_thread(indigo_client *client) {
+	binary_context *context = (binary_context *)client->client_context;
+	pthread_mutex_lock(&context->queue_mutex);
+	while (true) {
+		while (context->head == NULL && !context->closed)
+			pthread_cond_wait(&context->not_empty, &context->queue_mutex);
+		binary_frame *frame = context->head;
+		if (frame == NULL)
+			break;
+		if ((context->head = frame->next) == NULL)
+			context->tail = NULL;
+		context->depth--;
+		if (frame->blob)
+			context->blobs--;
+		pthread_cond_broadcast(&context->not_full);
+		pthread_mutex_unlock(&context->queue_mutex);
+		bool result = write_frame(context->adapter.output, frame);
+		release_frame(frame);
+		pthread_mutex_lock(&context->queue_mutex);
+		if (!result) {
+			context->closed = true;
+			discard_frames(context);
+			pthread_cond_broadcast(&context->not_full);
+			/* parser finishes the session */
+			shutdown(context->adapter.output, SHUT_RDWR);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&context->queue_mutex);
+	return NULL;
+}
+
+// called with encode_mutex locked, so frames are queued in the same order as symbols were assigned
+
+static void enqueue_frame(indigo_client *client, binary_frame *frame) {
+	binary_context *context = (binary_context *)client->client_context;
+	finish_frame(frame);
+	if (!context->writer_started) {
+		if (context->adapter.output > 0 && !write_frame(context->adapter.output, frame)) {
+			shutdown(context->adapter.output, SHUT_RDWR);
+			context->adapter.output = -1;
+		}
+		release_frame(frame);
+		return;
+	}
+	pthread_mutex_lock(&context->queue_mutex);
+	if (frame->blob && context->blobs >= indigo_xml_queue_blob_limit) {
+		// frames introducing new names must be delivered
+		for (binary_frame *previous = NULL, *pending = context->head; pending; previous = pending, pending = pending->next) {
+			if (pending->blob && !pending->defines) {
+				if (previous)
+					previous->next = pending->next;
+				else
+					context->head = pending->next;
+				if (context->tail == pending)
+					context->tail = previous;
+				context->depth--;
+				context->blobs--;
+				release_frame(pending);
+				break;
+			}
+		}
+	}
+	if (context->depth >= indigo_xml_queue_size && !context->closed) {
+		struct timespec end;
+		clock_gettime(CLOCK_REALTIME, &end);
+		end.tv_sec += (int)indigo_xml_queue_timeout;
+		end.tv_nsec += 1000000000L * (indigo_xml_queue_timeout - (int)indigo_xml_queue_timeout);
+		if (end.tv_nsec >= 1000000000L) {
+			end.tv_sec++;
+			end.tv_nsec -= 1000000000L;
+		}
+		while (context->depth >= indigo_xml_queue_size && !context->closed) {
+			if (pthread_cond_timedwait(&context->not_full, &context->queue_mutex, &end) == ETIMEDOUT)
+				break;
+		}
+		if (context->depth >= indigo_xml_queue_size && !context->closed) {
+			indigo_error("%s: outbound queue is full, closing connection", client->name);
+			context->closed = true;
+			discard_frames(context);
+			pthread_cond_broadcast(&context->not_empty);
+			shutdown(context->adapter.output, SHUT_RDWR);
+		}
+	}
+	if (context->closed) {
+		pthread_mutex_unlock(&context->queue_mutex);
+		release_frame(frame);
+		return;
+	}
+	if (context->tail)
+		context->tail->next = frame;
+	else
+		context->head = frame;
+	context->tail = frame;
+	context->depth++;
+	if (frame->blob)
+		context->blobs++;
+	pthread_cond_signal(&context->not_empty);
+	pthread_mutex_unlock(&context->queue_mutex);
+}
+
+// client side adapter (used by server)
+
+static bool accepts(indigo_client *client, indigo_device *device) {
+	if (!indigo_reshare_remote_devices && device->is_remote)
+		return false;
+	if (client->version == INDIGO_VERSION_NONE)
+		return false;
+	return ((binary_context *)client->client_context)->adapter.output > 0;
+}
+
+static indigo_result binary_device_adapter_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	assert(device != NULL);
+	assert(client != NULL);
+	assert(property != NULL);
+	if (!accepts(client, device))
+		return INDIGO_OK;
+	binary_context *context = (binary_context *)client->client_context;
+	pthread_mutex_lock(&context->encode_mutex);
+	binary_frame *frame = create_frame(DEFINE_PROPERTY, 0);
+	put_name(frame, &context->symbols, property->device);
+	put_name(frame, &context->symbols, property->name);
+	put_name(frame, &context->symbols, property->group);
+	put_string(frame, property->label);
+	put_string(frame, property->hints);
+	put_byte(frame, property->type);
+	put_byte(frame, property->perm);
+	put_byte(frame, property->state);
+	put_byte(frame, property->rule);
+	put_varint(frame, property->count);
+	for (int i = 0; i < property->count; i++) {
+		indigo_item *item = property->items + i;
+		put_name(frame, &context->symbols, item->name);
+		put_string(frame, item->label);
+		put_string(frame, item->hints);
+		switch (property->type) {
+			case INDIGO_TEXT_VECTOR:
+				put_string(frame, indigo_get_text_item_value(item));
+				break;
+			case INDIGO_NUMBER_VECTOR:
+				put_string(frame, item->number.format);
+				put_double(frame, item->number.min);
+				put_double(frame, item->number.max);
+				put_double(frame, item->number.step);
+				put_double(frame, item->number.value);
+				put_double(frame, item->number.target);
+				break;
+			case INDIGO_SWITCH_VECTOR:
+				put_byte(frame, item->sw.value);
+				break;
+			case INDIGO_LIGHT_VECTOR:
+				put_byte(frame, item->light.value);
+				break;
+			case INDIGO_BLOB_VECTOR:
+				if (property->perm == INDIGO_WO_PERM) {
+					if (item->blob.url[0] == 0 || indigo_proxy_blob) {
+						char path[INDIGO_NAME_SIZE];
+						put_byte(frame, BLOB_PATH);
+						put_string(frame, indigo_blob_path(property, item, false, path, sizeof(path)));
+					} else {
+						put_byte(frame, BLOB_URL);
+						put_string(frame, item->blob.url);
+					}
+				} else {
+					put_byte(frame, BLOB_NONE);
+				}
+				break;
+		}
+	}
+	put_message(frame, message);
+	enqueue_frame(client, frame);
+	pthread_mutex_unlock(&context->encode_mutex);
+	return INDIGO_OK;
+}
+
+static indigo_result binary_device_adapter_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	assert(device != NULL);
+	assert(client != NULL);
+	assert(property != NULL);
+	if (!accepts(client, device))
+		return INDIGO_OK;
+	indigo_enable_blob_mode mode = INDIGO_ENABLE_BLOB_NEVER;
+	if (property->type == INDIGO_BLOB_VECTOR) {
+		for (indigo_enable_blob_mode_record *record = client->enable_blob_mode_records; record; record = record->next) {
+			if ((*record->device == 0 || !strcmp(property->device, record->device)) && (*record->name == 0 || !strcmp(property->name, record->name))) {
+				mode = record->mode;
+				break;
+			}
+		}
+		if (mode == INDIGO_ENABLE_BLOB_NEVER)
+			return INDIGO_OK;
+	}
+	binary_context *context = (binary_context *)client->client_context;
+	int count = property->type == INDIGO_BLOB_VECTOR && property->state != INDIGO_OK_STATE ? 0 : property->count;
+	// client side merges items into cached property, so only items changed since previous update are sent
+	int changed = 0;
+	for (int i = 0; i < count; i++) {
+		if (indigo_item_changed(property, property->items + i))
+			changed++;
+	}
+	pthread_mutex_lock(&context->encode_mutex);
+	binary_frame *frame = create_frame(UPDATE_PROPERTY, property->type == INDIGO_BLOB_VECTOR ? count : 0);
+	put_name(frame, &context->symbols, property->device);
+	put_name(frame, &context->symbols, property->name);
+	put_byte(frame, property->type);
+	put_byte(frame, property->state);
+	put_varint(frame, changed);
+	for (int i = 0; i < count; i++) {
+		indigo_item *item = property->items + i;
+		if (!indigo_item_changed(property, item))
+			continue;
+		put_name(frame, &context->symbols, item->name);
+		switch (property->type) {
+			case INDIGO_TEXT_VECTOR:
+				put_string(frame, indigo_get_text_item_value(item));
+				break;
+			case INDIGO_NUMBER_VECTOR:
+				put_double(frame, item->number.value);
+				put_double(frame, item->number.target);
+				break;
+			case INDIGO_SWITCH_VECTOR:
+				put_byte(frame, item->sw.value);
+				break;
+			case INDIGO_LIGHT_VECTOR:
+				put_byte(frame, item->light.value);
+				break;
+			case INDIGO_BLOB_VECTOR:
+				if (mode == INDIGO_ENABLE_BLOB_URL) {
+					if (item->blob.value || indigo_proxy_blob) {
+						char path[INDIGO_NAME_SIZE], url[INDIGO_VALUE_SIZE];
+						snprintf(url, sizeof(url), "%s%s", indigo_blob_path(property, item, true, path, sizeof(path)), item->blob.format);
+						put_byte(frame, BLOB_PATH);
+						put_string(frame, url);
+					} else {
+						put_byte(frame, BLOB_URL);
+						put_string(frame, item->blob.url);
+					}
+				} else {
+					put_byte(frame, BLOB_INLINE);
+					put_string(frame, item->blob.format);
+					put_varint(frame, put_payload(frame, item, false));
+					frame->blob = true;
+				}
+				break;
+		}
+	}
+	put_message(frame, message);
+	enqueue_frame(client, frame);
+	pthread_mutex_unlock(&context->encode_mutex);
+	return INDIGO_OK;
+}
+
+static indigo_result binary_device_adapter_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	assert(device != NULL);
+	assert(client != NULL);
+	assert(property != NULL);
+	if (!accepts(client, device))
+		return INDIGO_OK;
+	binary_context *context = (binary_context *)client->client_context;
+	pthread_mutex_lock(&context->encode_mutex);
+	binary_frame *frame = create_frame(DELETE_PROPERTY, 0);
+	put_name(frame, &context->symbols, *property->name ? property->device : device->name);
+	put_name(frame, &context->symbols, property->name);
+	put_message(frame, message);
+	enqueue_frame(client, frame);
+	pthread_mutex_unlock(&context->encode_mutex);
+	return INDIGO_OK;
+}
+
+static indigo_result binary_device_adapter_send_message(indigo_client *client, indigo_device *device, const char *message) {
+	assert(client != NULL);
+	if (message == NULL || (device != NULL && !accepts(client, device)) || client->version == INDIGO_VERSION_NONE)
+		return INDIGO_OK;
+	binary_context *context = (binary_context *)client->client_context;
+	if (context->adapter.output <= 0)
+		return INDIGO_OK;
+	pthread_mutex_lock(&context->encode_mutex);
+	binary_frame *frame = create_frame(MESSAGE, 0);
+	put_name(frame, &context->symbols, device ? device->name : "");
+	put_message(frame, message);
+	enqueue_frame(client, frame);
+	pthread_mutex_unlock(&context->encode_mutex);
+	return INDIGO_OK;
+}
+
+indigo_client *indigo_binary_device_adapter(int input, int output) {
+	static indigo_client client_template = {
+		"Binary Driver Adapter", false, NULL, INDIGO_OK, INDIGO_VERSION_NONE, NULL,
+		NULL,
+		binary_device_adapter_define_property,
+		binary_device_adapter_update_property,
+		binary_device_adapter_delete_property,
+		binary_device_adapter_send_message,
+		NULL
+	};
+	indigo_client *client = indigo_safe_malloc_copy(sizeof(indigo_client), &client_template);
+	snprintf(client->name, sizeof(client->name), "Binary Driver Adapter #%d", input);
+	binary_context *context = create_context(input, output);
+	client->client_context = context;
+	client->is_remote = input == output;
+	if (pthread_create(&context->writer, NULL, (void * (*)(void*))writer_thread, client) == 0)
+		context->writer_started = true;
+	else
+		indigo_error("%s: failed to start writer thread, falling back to synchronous output", client->name);
+	return client;
+}
+
+void indigo_release_binary_device_adapter(indigo_client *client) {
+	assert(client != NULL);
+	assert(client->client_context != NULL);
+	binary_context *context = (binary_context *)client->client_context;
+	if (context->writer_started) {
+		pthread_mutex_lock(&context->queue_mutex);
+		context->closed = true;
+		discard_frames(context);
+		pthread_cond_broadcast(&context->not_empty);
+		pthread_cond_broadcast(&context->not_full);
+		pthread_mutex_unlock(&context->queue_mutex);
+		/* peer is gone, don't let the frame in flight block the join */
+		if (client->is_remote && context->adapter.output > 0)
+			shutdown(context->adapter.output, SHUT_RDWR);
+		pthread_join(context->writer, NULL);
+	}
+	indigo_enable_blob_mode_record *blob_record = client->enable_blob_mode_records;
+	while (blob_record) {
+		client->enable_blob_mode_records = blob_record->next;
+		free(blob_record);
+		blob_record = client->enable_blob_mode_records;
+	}
+	release_context(context);
+	free(client);
+}
+
+// driver side adapter (used by client), requests are written synchronously
+
+static void strip_host_suffix(char *device_name, const char *name) {
+	indigo_copy_name(device_name, name);
+	if (indigo_use_host_suffix) {
+		char *at = strrchr(device_name, '@');
+		if (at != NULL) {
+			while (at > device_name && at[-1] == ' ')
+				at--;
+			*at = 0;
+		}
+	}
+}
+
+static void send_request(binary_context *context, binary_frame *frame) {
+	finish_frame(frame);
+	if (context->adapter.output > 0 && !write_frame(context->adapter.output, frame)) {
+		/* parser finishes the session */
+		shutdown(context->adapter.output, SHUT_RDWR);
+		context->adapter.output = -1;
+	}
+	release_frame(frame);
+}
+
+static indigo_result binary_client_adapter_enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property) {
+	assert(device != NULL);
+	if (!indigo_reshare_remote_devices && client && client->is_remote)
+		return INDIGO_OK;
+	binary_context *context = (binary_context *)device->device_context;
+	if (context->adapter.output <= 0)
+		return INDIGO_OK;
+	char device_name[INDIGO_NAME_SIZE] = "";
+	const char *client_name = "";
+	if (property != NULL)
+		strip_host_suffix(device_name, property->device);
+	else if (indigo_client_name)
+		client_name = indigo_client_name;
+	else if (indigo_main_argv)
+		client_name = basename((char *)indigo_main_argv[0]);
+	pthread_mutex_lock(&context->encode_mutex);
+	binary_frame *frame = create_frame(GET_PROPERTIES, 0);
+	put_name(frame, &context->symbols, device_name);
+	put_name(frame, &context->symbols, property ? property->name : "");
+	put_string(frame, client_name);
+	send_request(context, frame);
+	pthread_mutex_unlock(&context->encode_mutex);
+	return INDIGO_OK;
+}
+
+static indigo_result binary_client_adapter_change_property(indigo_device *device, indigo_client *client, indigo_property *property) {
+	assert(device != NULL);
+	assert(property != NULL);
+	if (!indigo_reshare_remote_devices && client && client->is_remote)
+		return INDIGO_OK;
+	binary_context *context = (binary_context *)device->device_context;
+	if (context->adapter.output <= 0)
+		return INDIGO_OK;
+	char device_name[INDIGO_NAME_SIZE];
+	strip_host_suffix(device_name, property->device);
+	pthread_mutex_lock(&context->encode_mutex);
+	binary_frame *frame = create_frame(NEW_PROPERTY, property->type == INDIGO_BLOB_VECTOR ? property->count : 0);
+	put_name(frame, &context->symbols, device_name);
+	put_name(frame, &context->symbols, property->name);
+	put_varint(frame, property->access_token);
+	put_byte(frame, property->type);
+	put_varint(frame, property->count);
+	for (int i = 0; i < property->count; i++) {
+		indigo_item *item = property->items + i;
+		put_name(frame, &context->symbols, item->name);
+		switch (property->type) {
+			case INDIGO_TEXT_VECTOR:
+				put_string(frame, indigo_get_text_item_value(item));
+				break;
+			case INDIGO_NUMBER_VECTOR:
+				put_double(frame, item->number.value);
+				break;
+			case INDIGO_SWITCH_VECTOR:
+				put_byte(frame, item->sw.value);
+				break;
+			case INDIGO_BLOB_VECTOR:
+				put_string(frame, item->blob.format);
+				put_varint(frame, put_payload(frame, item, true));
+				break;
+			default:
+				break;
+		}
+	}
+	send_request(context, frame);
+	pthread_mutex_unlock(&context->encode_mutex);
+	return INDIGO_OK;
+}
+
+static indigo_result binary_client_adapter_enable_blob(indigo_device *device, indigo_client *client, indigo_property *property, indigo_enable_blob_mode mode) {
+	assert(device != NULL);
+	assert(property != NULL);
+	if (!indigo_reshare_remote_devices && client && client->is_remote)
+		return INDIGO_OK;
+	binary_context *context = (binary_context *)device->device_context;
+	if (context->adapter.output <= 0)
+		return INDIGO_OK;
+	char device_name[INDIGO_NAME_SIZE];
+	strip_host_suffix(device_name, property->device);
+	pthread_mutex_lock(&context->encode_mutex);
+	binary_frame *frame = create_frame(ENABLE_BLOB, 0);
+	put_name(frame, &context->symbols, device_name);
+	put_name(frame, &context->symbols, property->name);
+	put_byte(frame, mode);
+	send_request(context, frame);
+	pthread_mutex_unlock(&context->encode_mutex);
+	return INDIGO_OK;
+}
+
+static indigo_result binary_client_adapter_detach(indigo_device *device) {
+	assert(device != NULL);
+	return INDIGO_OK;
+}
+
+indigo_device *indigo_binary_client_adapter(char *name, char *url_prefix, int input, int output) {
+	static indigo_device device_template = INDIGO_DEVICE_INITIALIZER(
+		"Binary Client Adapter", NULL,
+		binary_client_adapter_enumerate_properties,
+		binary_client_adapter_change_property,
+		binary_client_adapter_enable_blob,
+		binary_client_adapter_detach
+	);
+	indigo_device *device = indigo_safe_malloc_copy(sizeof(indigo_device), &device_template);
+	sprintf(device->name, "@ %s", name);
+	device->is_remote = input == output; // is socket, otherwise is pipe
+	device->version = INDIGO_VERSION_CURRENT;
+	binary_context *context = create_context(input, output);
+	indigo_copy_name(context->adapter.url_prefix, url_prefix);
+	device->device_context = context;
+	return device;
+}
+
+void indigo_release_binary_client_adapter(indigo_device *device) {
+	assert(device != NULL);
+	if (device->device_context)
+		release_context((binary_context *)device->device_context);
+	free(device);
+}
+
+// parser, client side (device != NULL) handles definitions and updates, server side (client != NULL) handles requests
+
+static char *remote_device_name(parser_context *context, const char *name) {
+	if (indigo_use_host_suffix)
+		snprintf(context->device_name, INDIGO_NAME_SIZE, "%s %s", name, context->device->name);
+	else
+		indigo_copy_name(context->device_name, name);
+	return context->device_name;
+}
+
+static cached_property **find_property(parser_context *context, const char *device, const char *name, uint32_t hash) {
+	cached_property **entry = context->properties + hash % PROPERTY_BUCKETS;
+	while (*entry && ((*entry)->hash != hash || strcmp((*entry)->property->name, name) || strcmp((*entry)->property->device, device)))
+		entry = &(*entry)->next;
+	return entry;
+}
+
+static void release_cached_property(indigo_property *property) {
+	if (property->type == INDIGO_BLOB_VECTOR) {
+		for (int i = 0; i < property->count; i++) {
+			indigo_safe_free(property->items[i].blob.value);
+			property->items[i].blob.value = NULL;
+		}
+	}
+	indigo_release_property(property);
+}
+
+static indigo_item *find_item(indigo_property *property, int index, const char *name) {
+	if (index < property->count && !strcmp(property->items[index].name, name))
+		return property->items + index;
+	for (int i = 0; i < property->count; i++) {
+		if (!strcmp(property->items[i].name, name))
+			return property->items + i;
+	}
+	return NULL;
+}
+
+static bool parse_get_properties(parser_context *context, frame_reader *reader) {
+	indigo_client *client = context->client;
+	indigo_property property = { 0 };
+	indigo_copy_name(property.device, get_name(reader, &context->names));
+	indigo_copy_name(property.name, get_name(reader, &context->names));
+	char *client_name = get_string(reader);
+	if (reader->error)
+		return false;
+	if (*client_name)
+		indigo_copy_name(client->name, client_name);
+	property.version = client->version = INDIGO_VERSION_CURRENT;
+	indigo_enumerate_properties(client, &property);
+	return true;
+}
+
+static bool parse_new_property(parser_context *context, frame_reader *reader) {
+	char *device = get_name(reader, &context->names);
+	char *name = get_name(reader, &context->names);
+	indigo_token token = get_varint(reader);
+	indigo_property_type type = get_byte(reader);
+	uint64_t count = get_varint(reader);
+	if (reader->error || count > (uint64_t)(reader->end - reader->pointer))
+		return false;
+	indigo_property *property = indigo_safe_malloc(sizeof(indigo_property) + count * sizeof(indigo_item));
+	indigo_copy_name(property->device, device);
+	indigo_copy_name(property->name, name);
+	property->access_token = token;
+	property->type = type;
+	property->version = INDIGO_VERSION_CURRENT;
+	property->count = property->allocated_count = (int)count;
+	property->label = property->hints = "";
+	bool result = true;
+	long blob_total = 0;
+	for (int i = 0; i < property->count && result; i++) {
+		indigo_item *item = property->items + i;
+		indigo_copy_name(item->name, get_name(reader, &context->names));
+		item->label = item->hints = "";
+		switch (type) {
+			case INDIGO_TEXT_VECTOR:
+				indigo_set_text_item_value(item, get_string(reader));
+				break;
+			case INDIGO_NUMBER_VECTOR:
+				item->number.format = "%g";
+				item->number.value = get_double(reader);
+				break;
+			case INDIGO_SWITCH_VECTOR:
+				item->sw.value = get_byte(reader);
+				break;
+			case INDIGO_BLOB_VECTOR:
+				indigo_copy_name(item->blob.format, get_string(reader));
+				uint64_t size = get_varint(reader);
+				if (reader->error)
+					break;
+				if (!check_payload_size(size, &blob_total)) {
+					result = false;
+					break;
+				}
+				if ((item->blob.size = (long)size)) {
+					item->blob.value = indigo_safe_malloc(item->blob.size);
+					result = read_payload(&context->input, item->blob.value, item->blob.size);
+				}
+				break;
+			default:
+				reader->error = true;
+				break;
+		}
+		result = result && !reader->error;
+	}
+	if (result)
+		indigo_change_property(context->client, property);
+	for (int i = 0; i < property->count; i++) {
+		indigo_item *item = property->items + i;
+		if (type == INDIGO_TEXT_VECTOR)
+			indigo_safe_free(item->text.long_value);
+		else if (type == INDIGO_BLOB_VECTOR)
+			indigo_safe_free(item->blob.value);
+	}
+	free(property);
+	return result;
+}
+
+static bool parse_enable_blob(parser_context *context, frame_reader *reader) {
+	indigo_client *client = context->client;
+	indigo_property property = { 0 };
+	indigo_copy_name(property.device, get_name(reader, &context->names));
+	indigo_copy_name(property.name, get_name(reader, &context->names));
+	indigo_enable_blob_mode mode = get_byte(reader);
+	if (reader->error)
+		return false;
+	property.version = INDIGO_VERSION_CURRENT;
+	indigo_enable_blob_mode_record *record = client->enable_blob_mode_records;
+	indigo_enable_blob_mode_record *prev = NULL;
+	while (record) {
+		if (!strcmp(property.device, record->device) && (*record->name == 0 || !strcmp(property.name, record->name))) {
+			if (prev) {
+				prev->next = record->next;
+				free(record);
+				record = prev->next;
+			} else {
+				client->enable_blob_mode_records = record->next;
+				free(record);
+				record = client->enable_blob_mode_records;
+			}
+		} else {
+			prev = record;
+			record = record->next;
+		}
+	}
+	if (mode != INDIGO_ENABLE_BLOB_NEVER) {
+		record = indigo_safe_malloc(sizeof(indigo_enable_blob_mode_record));
+		indigo_copy_name(record->device, property.device);
+		indigo_copy_name(record->name, property.name);
+		record->mode = mode == INDIGO_ENABLE_BLOB_URL && indigo_use_blob_urls ? INDIGO_ENABLE_BLOB_URL : INDIGO_ENABLE_BLOB_ALSO;
+		record->next = client->enable_blob_mode_records;
+		client->enable_blob_mode_records = record;
+		indigo_enable_blob(client, &property, record->mode);
+	} else {
+		indigo_enable_blob(client, &property, INDIGO_ENABLE_BLOB_NEVER);
+	}
+	return true;
+}
+
+static bool parse_define_property(parser_context *context, frame_reader *reader) {
+	char *device = remote_device_name(context, get_name(reader, &context->names));
+	char *name = get_name(reader, &context->names);
+	char *group = get_name(reader, &context->names);
+	char *label = get_string(reader);
+	char *hints = get_string(reader);
+	indigo_property_type type = get_byte(reader);
+	indigo_property_perm perm = get_byte(reader);
+	indigo_property_state state = get_byte(reader);
+	indigo_rule rule = get_byte(reader);
+	uint64_t count = get_varint(reader);
+	if (reader->error || count > (uint64_t)(reader->end - reader->pointer))
+		return false;
+	indigo_property *property = NULL;
+	switch (type) {
+		case INDIGO_TEXT_VECTOR:
+			property = indigo_init_text_property(NULL, device, name, group, label, state, perm, (int)count);
+			break;
+		case INDIGO_NUMBER_VECTOR:
+			property = indigo_init_number_property(NULL, device, name, group, label, state, perm, (int)count);
+			break;
+		case INDIGO_SWITCH_VECTOR:
+			property = indigo_init_switch_property(NULL, device, name, group, label, state, perm, rule, (int)count);
+			break;
+		case INDIGO_LIGHT_VECTOR:
+			property = indigo_init_light_property(NULL, device, name, group, label, state, (int)count);
+			break;
+		case INDIGO_BLOB_VECTOR:
+			property = indigo_init_blob_property_p(NULL, device, name, group, label, state, perm, (int)count);
+			break;
+		default:
+			return false;
+	}
+	indigo_set_hints(property, hints);
+	for (int i = 0; i < property->count && !reader->error; i++) {
+		indigo_item *item = property->items + i;
+		indigo_copy_name(item->name, get_name(reader, &context->names));
+		indigo_set_label(item, get_string(reader));
+		indigo_set_hints(item, get_string(reader));
+		switch (type) {
+			case INDIGO_TEXT_VECTOR:
+				indigo_set_text_item_value(item, get_string(reader));
+				break;
+			case INDIGO_NUMBER_VECTOR:
+				indigo_set_number_format(item, get_string(reader));
+				item->number.min = get_double(reader);
+				item->number.max = get_double(reader);
+				item->number.step = get_double(reader);
+				item->number.value = get_double(reader);
+				item->number.target = get_double(reader);
+				break;
+			case INDIGO_SWITCH_VECTOR:
+				item->sw.value = get_byte(reader);
+				break;
+			case INDIGO_LIGHT_VECTOR:
+				item->light.value = get_byte(reader);
+				break;
+			case INDIGO_BLOB_VECTOR:
+				switch (get_byte(reader)) {
+					case BLOB_PATH:
+						snprintf(item->blob.url, INDIGO_VALUE_SIZE, "%s%s", ((indigo_adapter_context *)context->device->device_context)->url_prefix, get_string(reader));
+						break;
+					case BLOB_URL:
+						indigo_copy_value(item->blob.url, get_string(reader));
+						break;
+				}
+				break;
+		}
+	}
+	char *message = get_message(reader);
+	if (reader->error) {
+		release_cached_property(property);
+		return false;
+	}
+	uint32_t hash = hash_name(name, hash_name(device, HASH_SEED));
+	cached_property **entry = find_property(context, device, name, hash);
+	if (*entry) {
+		// same as XML parser, definition of known property is forwarded as is
+		release_cached_property(property);
+		property = (*entry)->property;
+	} else {
+		cached_property *new_entry = indigo_safe_malloc(sizeof(cached_property));
+		new_entry->hash = hash;
+		new_entry->property = property;
+		*entry = new_entry;
+	}
+	indigo_define_property(context->device, property, message);
+	return true;
+}
+
+static bool parse_update_property(parser_context *context, frame_reader *reader) {
+	char *device = remote_device_name(context, get_name(reader, &context->names));
+	char *name = get_name(reader, &context->names);
+	indigo_property_type type = get_byte(reader);
+	indigo_property_state state = get_byte(reader);
+	uint64_t count = get_varint(reader);
+	if (reader->error)
+		return false;
+	cached_property *entry = *find_property(context, device, name, hash_name(name, hash_name(device, HASH_SEED)));
+	indigo_property *property = entry && entry->property->type == type ? entry->property : NULL;
+	long blob_total = 0;
+	for (uint64_t i = 0; i < count && !reader->error; i++) {
+		indigo_item *item = NULL;
+		char *item_name = get_name(reader, &context->names);
+		if (property)
+			item = find_item(property, (int)i, item_name);
+		switch (type) {
+			case INDIGO_TEXT_VECTOR: {
+				char *value = get_string(reader);
+				if (item)
+					indigo_set_text_item_value(item, value);
+				break;
+			}
+			case INDIGO_NUMBER_VECTOR: {
+				double value = get_double(reader);
+				double target = get_double(reader);
+				if (item) {
+					item->number.value = value;
+					item->number.target = target;
+				}
+				break;
+			}
+			case INDIGO_SWITCH_VECTOR: {
+				bool value = get_byte(reader);
+				if (item)
+					item->sw.value = value;
+				break;
+			}
+			case INDIGO_LIGHT_VECTOR: {
+				indigo_property_state value = get_byte(reader);
+				if (item)
+					item->light.value = value;
+				break;
+			}
+			case INDIGO_BLOB_VECTOR: {
+				blob_kind kind = get_byte(reader);
+				if (kind == BLOB_INLINE) {
+					char *format = get_string(reader);
+					uint64_t size = get_varint(reader);
+					if (reader->error || !check_payload_size(size, &blob_total))
+						return false;
+					if (item) {
+						indigo_copy_name(item->blob.format, format);
+						item->blob.url[0] = 0;
+						if (property->perm == INDIGO_RO_PERM) {
+							if ((item->blob.size = size) == 0) {
+								indigo_safe_free(item->blob.value);
+								item->blob.value = NULL;
+								break;
+							}
+							item->blob.value = indigo_safe_realloc(item->blob.value, size);
+							if (!read_payload(&context->input, item->blob.value, size))
+								return false;
+							break;
+						}
+					}
+					if (!skip_payload(&context->input, size))
+						return false;
+				} else if (kind == BLOB_PATH || kind == BLOB_URL) {
+					char *url = get_string(reader);
+					if (item) {
+						if (kind == BLOB_PATH)
+							snprintf(item->blob.url, INDIGO_VALUE_SIZE, "%s%s", ((indigo_adapter_context *)context->device->device_context)->url_prefix, url);
+						else
+							indigo_copy_value(item->blob.url, url);
+						item->blob.format[0] = 0;
+						if (property->perm == INDIGO_RO_PERM) {
+							item->blob.size = 0;
+							indigo_safe_free(item->blob.value);
+							item->blob.value = NULL;
+							char *ext = strrchr(item->blob.url, '.');
+							if (ext)
+								indigo_copy_name(item->blob.format, ext);
+						}
+					}
+				}
+				break;
+			}
+			default:
+				return false;
+		}
+	}
+	char *message = get_message(reader);
+	if (reader->error)
+		return false;
+	if (property) {
+		property->state = state;
+		indigo_update_property(context->device, property, message);
+	}
+	return true;
+}
+
+static bool parse_delete_property(parser_context *context, frame_reader *reader) {
+	char *device = remote_device_name(context, get_name(reader, &context->names));
+	char *name = get_name(reader, &context->names);
+	char *message = get_message(reader);
+	if (reader->error)
+		return false;
+	if (*name) {
+		cached_property **entry = find_property(context, device, name, hash_name(name, hash_name(device, HASH_SEED)));
+		if (*entry) {
+			cached_property *removed = *entry;
+			*entry = removed->next;
+			indigo_delete_property(context->device, removed->property, message);
+			release_cached_property(removed->property);
+			free(removed);
+		}
+	} else {
+		for (int i = 0; i < PROPERTY_BUCKETS; i++) {
+			cached_property **entry = context->properties + i;
+			while (*entry) {
+				if (!strcmp((*entry)->property->device, device)) {
+					cached_property *removed = *entry;
+					*entry = removed->next;
+					indigo_delete_property(context->device, removed->property, message);
+					release_cached_property(removed->property);
+					free(removed);
+				} else {
+					entry = &(*entry)->next;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+static bool parse_message(parser_context *context, frame_reader *reader) {
+	char *device = get_name(reader, &context->names);
+	char *message = get_message(reader);
+	if (reader->error)
+		return false;
+	if (*device) {
+		if (indigo_use_host_suffix)
+			snprintf(context->message, INDIGO_VALUE_SIZE, "%s %s: %s", device, context->device->name, message ? message : "");
+		else
+			snprintf(context->message, INDIGO_VALUE_SIZE, "%s: %s", device, message ? message : "");
+		message = context->message;
+	}
+	indigo_send_message(context->device, message);
+	return true;
+}
+
+static void release_properties(parser_context *context) {
+	for (int i = 0; i < PROPERTY_BUCKETS; i++) {
+		while (context->properties[i]) {
+			indigo_device remote_device;
+			indigo_copy_name(remote_device.name, context->properties[i]->property->device);
+			remote_device.version = INDIGO_VERSION_CURRENT;
+			indigo_property *all_properties = indigo_init_text_property(NULL, remote_device.name, "", "", "", INDIGO_OK_STATE, INDIGO_RO_PERM, 0);
+			indigo_delete_property(&remote_device, all_properties, NULL);
+			indigo_release_property(all_properties);
+			for (int j = i; j < PROPERTY_BUCKETS; j++) {
+				cached_property **entry = context->properties + j;
+				while (*entry) {
+					if (!strcmp((*entry)->property->device, remote_device.name)) {
+						cached_property *removed = *entry;
+						*entry = removed->next;
+						release_cached_property(removed->property);
+						free(removed);
+					} else {
+						entry = &(*entry)->next;
+					}
+				}
+			}
+		}
+	}
+}
+
+void indigo_binary_parse(indigo_device *device, indigo_client *client) {
+	parser_context *context = indigo_safe_malloc(sizeof(parser_context));
+	context->device = device;
+	context->client = client;
+	context->input.buffer = indigo_safe_malloc(context->input.capacity = INPUT_BUFFER_SIZE);
+	if (device != NULL) {
+		context->input.handle = ((indigo_adapter_context *)device->device_context)->input;
+		device->enumerate_properties(device, client, NULL);
+	} else {
+		context->input.handle = ((indigo_adapter_context *)client->client_context)->input;
+	}
+	while (fill_input(&context->input, 4)) {
+		const unsigned char *header = (unsigned char *)context->input.buffer + context->input.start;
+		long length = header[0] | header[1] << 8 | header[2] << 16 | (long)header[3] << 24;
+		if (length < 1 || length > MAX_FRAME_SIZE) {
+			indigo_error("Binary Parser: invalid frame length %ld", length);
+			break;
+		}
+		if (!fill_input(&context->input, 4 + length))
+			break;
+		frame_reader reader = { (unsigned char *)context->input.buffer + context->input.start + 4, (unsigned char *)context->input.buffer + context->input.start + 4 + length, false };
+		// frame stays in place while payloads are read
+		context->input.start += 4 + length;
+		frame_type type = get_byte(&reader);
+		INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> // binary frame %d, %ld bytes", context->input.handle, type, length));
+		bool result = false;
+		if (client != NULL) {
+			switch (type) {
+				case GET_PROPERTIES:
+					result = parse_get_properties(context, &reader);
+					break;
+				case NEW_PROPERTY:
+					result = parse_new_property(context, &reader);
+					break;
+				case ENABLE_BLOB:
+					result = parse_enable_blob(context, &reader);
+					break;
+				default:
+					break;
+			}
+		} else {
+			switch (type) {
+				case DEFINE_PROPERTY:
+					result = parse_define_property(context, &reader);
+					break;
+				case UPDATE_PROPERTY:
+					result = parse_update_property(context, &reader);
+					break;
+				case DELETE_PROPERTY:
+					result = parse_delete_property(context, &reader);
+					break;
+				case MESSAGE:
+					result = parse_message(context, &reader);
+					break;
+				default:
+					break;
+			}
+		}
+		if (!result) {
+			indigo_error("Binary Parser: invalid frame %d", type);
+			break;
+		}
+	}
+	if (device != NULL)
+		release_properties(context);
+	release_names(&context->names);
+	free(context->input.buffer);
+	free(context);
+	INDIGO_TRACE_PARSER(indigo_trace("Binary Parser: parser finished"));
+}
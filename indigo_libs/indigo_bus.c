@@ -41,6 +41,7 @@
 #include <syslog.h>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <zlib.h>
 #endif
 #if defined(INDIGO_WINDOWS)
 #include <io.h>
@@ -53,16 +54,31 @@
 #include <indigo/indigo_names.h>
 #include <indigo/indigo_io.h>
 #include <indigo/indigo_token.h>
+#include <indigo/indigo_timer.h>
 
 #define MAX_DEVICES 256
 #define MAX_CLIENTS 256
-#define MAX_BLOBS	32
+#define BLOB_HASH_SIZE	256
+#define UPDATE_HASH_SIZE	256
 
 #define BUFFER_SIZE	1024
 
+#define ROUTING_TABLE_SIZE	(2 * MAX_DEVICES)
+#define ROUTING_TABLE_DELETED	((indigo_device *)-1)
+
 static indigo_device *devices[MAX_DEVICES];
 static indigo_client *clients[MAX_CLIENTS];
-static indigo_blob_entry *blobs[MAX_BLOBS];
+
+static int device_slots_used = 0;
+static int client_slots_used = 0;
+
+// Name indexed routing table (open addressing, linear probing) for local devices and list of "@ host" proxy devices.
+// Both are modified under device_mutex only, removed routes become tombstones (trailing ones are cleared back to empty slots).
+// Readers go without locking like with devices[], device itself is never freed by the bus.
+
+static indigo_device *routing_table[ROUTING_TABLE_SIZE];
+static indigo_device *proxy_devices[MAX_DEVICES];
+static int proxy_slots_used = 0;
 
 static pthread_mutex_t bus_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
 #define client_mutex bus_mutex
@@ -70,7 +86,70 @@ static pthread_mutex_t bus_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
 
 bool indigo_use_strict_locking = true;
 
+// BLOB registry, entries are indexed by item address and by opaque id used in URLs, entries with cached content are kept in LRU list.
+// Registry is modified under blob_mutex, LRU list, memory accounting and statistics are guarded by blob_lru_mutex (never held while acquiring other locks).
+
+typedef struct blob_record {
+	indigo_blob_entry entry;
+	struct blob_record *next_by_item;
+	struct blob_record *next_by_id;
+	struct blob_record *lru_previous;
+	struct blob_record *lru_next;
+	long accounted;
+} blob_record;
+
+static blob_record *blobs_by_item[BLOB_HASH_SIZE];
+static blob_record *blobs_by_id[BLOB_HASH_SIZE];
+static blob_record *blob_lru_head = NULL;
+static blob_record *blob_lru_tail = NULL;
+static uint32_t blob_id_seed = 0;
+static uint32_t blob_id_counter = 0;
+static indigo_blob_cache_statistics blob_statistics;
+
 static pthread_mutex_t blob_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t blob_lru_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t blob_buffer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Update records keep fingerprints of item values sent by the last update of local device property (to mark changed items) and rate limiter state.
+// Records are indexed by property address and guarded by update_mutex (never held while dispatching), record is not released while its update is flushed.
+// Pending update is a copy of the property taken by indigo_update_property(), the driver may change or release the property before it is flushed.
+
+typedef struct update_record {
+	indigo_property *property;
+	indigo_device *device;
+	int count;
+	uint64_t *fingerprints;
+	bool *changed;
+	bool valid;
+	indigo_property_state state;
+	unsigned rules_generation;
+	double interval;
+	double last_update;
+	bool pending;
+	indigo_property *snapshot;
+	bool scheduled;
+	bool flushing;
+	bool has_message;
+	char message[INDIGO_VALUE_SIZE];
+	struct update_record *next;
+} update_record;
+
+typedef struct update_rule {
+	char device[INDIGO_NAME_SIZE];
+	char name[INDIGO_NAME_SIZE];
+	double interval;
+	struct update_rule *next;
+} update_rule;
+
+static update_record *update_records[UPDATE_HASH_SIZE];
+static int update_record_count = 0;
+static update_rule *update_rules = NULL;
+static unsigned update_rules_generation = 1;
+
+static pthread_mutex_t update_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t update_cond = PTHREAD_COND_INITIALIZER;
+
+bool indigo_use_delta_updates = false;
 
 static bool is_started = false;
 
@@ -116,6 +195,7 @@ bool indigo_reshare_remote_devices = false;
 bool indigo_use_host_suffix = true;
 bool indigo_is_sandboxed = false;
 bool indigo_use_blob_caching = false;
+long indigo_blob_cache_budget = 1024L * 1048576L;
 bool indigo_proxy_blob = false;
 
 const char **indigo_main_argv = NULL;
@@ -410,7 +490,14 @@ indigo_result indigo_start() {
 	if (!is_started) {
 		memset(devices, 0, MAX_DEVICES * sizeof(indigo_device *));
 		memset(clients, 0, MAX_CLIENTS * sizeof(indigo_client *));
-		memset(blobs, 0, MAX_BLOBS * sizeof(indigo_property *));
+		memset(routing_table, 0, ROUTING_TABLE_SIZE * sizeof(indigo_device *));
+		memset(proxy_devices, 0, MAX_DEVICES * sizeof(indigo_device *));
+		device_slots_used = client_slots_used = proxy_slots_used = 0;
+		memset(blobs_by_item, 0, BLOB_HASH_SIZE * sizeof(blob_record *));
+		memset(blobs_by_id, 0, BLOB_HASH_SIZE * sizeof(blob_record *));
+		blob_lru_head = blob_lru_tail = NULL;
+		memset(&blob_statistics, 0, sizeof(blob_statistics));
+		blob_id_seed = (uint32_t)time(NULL);
 		memset(&INDIGO_ALL_PROPERTIES, 0, sizeof(INDIGO_ALL_PROPERTIES));
 		is_started = true;
 	}
@@ -424,23 +511,156 @@ indigo_result indigo_start() {
 	return INDIGO_OK;
 }
 
+static inline uint32_t name_hash(const char *name) {
+	uint32_t hash = 2166136261U;
+	while (*name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+static void add_route(indigo_device *device) {
+	if (*device->name == '@') {
+		for (int i = 0; i < MAX_DEVICES; i++) {
+			if (proxy_devices[i] == NULL) {
+				proxy_devices[i] = device;
+				if (i >= proxy_slots_used)
+					proxy_slots_used = i + 1;
+				return;
+			}
+		}
+	} else {
+		uint32_t index = name_hash(device->name) & (ROUTING_TABLE_SIZE - 1);
+		for (int i = 0; i < ROUTING_TABLE_SIZE; i++) {
+			indigo_device *entry = routing_table[index];
+			if (entry == NULL || entry == ROUTING_TABLE_DELETED) {
+				routing_table[index] = device;
+				return;
+			}
+			index = (index + 1) & (ROUTING_TABLE_SIZE - 1);
+		}
+	}
+}
+
+static void remove_route(indigo_device *device) {
+	// device name may be changed after attach, so don't trust the hash
+	for (int i = 0; i < proxy_slots_used; i++) {
+		if (proxy_devices[i] == device) {
+			proxy_devices[i] = NULL;
+			return;
+		}
+	}
+	for (int i = 0; i < ROUTING_TABLE_SIZE; i++) {
+		if (routing_table[i] == device) {
+			// trailing tombstones are cleared to keep probe sequences short
+			if (routing_table[(i + 1) & (ROUTING_TABLE_SIZE - 1)] == NULL) {
+				int index = i;
+				do {
+					routing_table[index] = NULL;
+					index = (index - 1) & (ROUTING_TABLE_SIZE - 1);
+				} while (routing_table[index] == ROUTING_TABLE_DELETED);
+			} else {
+				routing_table[i] = ROUTING_TABLE_DELETED;
+			}
+			return;
+		}
+	}
+}
+
+static indigo_device *find_route(const char *name) {
+	uint32_t index = name_hash(name) & (ROUTING_TABLE_SIZE - 1);
+	for (int i = 0; i < ROUTING_TABLE_SIZE; i++) {
+		indigo_device *entry = routing_table[index];
+		if (entry == NULL)
+			break;
+		if (entry != ROUTING_TABLE_DELETED && !strcmp(entry->name, name))
+			return entry;
+		index = (index + 1) & (ROUTING_TABLE_SIZE - 1);
+	}
+	return NULL;
+}
+
+typedef enum {
+	ROUTE_ENUMERATE,
+	ROUTE_CHANGE,
+	ROUTE_ENABLE_BLOB
+} route_request_type;
+
+static void dispatch_request(route_request_type type, indigo_device *device, indigo_client *client, indigo_property *property, indigo_enable_blob_mode mode) {
+	switch (type) {
+		case ROUTE_ENUMERATE:
+			if (device->enumerate_properties != NULL)
+				device->last_result = device->enumerate_properties(device, client, property);
+			break;
+		case ROUTE_CHANGE:
+			if (device->change_property != NULL) {
+				if (device->access_token != 0 && device->access_token != property->access_token && property->access_token != indigo_get_master_token()) {
+					indigo_send_message(device, "Device '%s' is protected or locked for exclusive access", device->name);
+					break;
+				}
+				device->last_result = device->change_property(device, client, property);
+			}
+			break;
+		case ROUTE_ENABLE_BLOB:
+			if (device->enable_blob != NULL)
+				device->last_result = device->enable_blob(device, client, property, mode);
+			break;
+	}
+}
+
+static void route_request(route_request_type type, indigo_client *client, indigo_property *property, indigo_enable_blob_mode mode) {
+	if (*property->device == 0) {
+		for (int i = 0; i < device_slots_used; i++) {
+			indigo_device *device = devices[i];
+			if (device != NULL)
+				dispatch_request(type, device, client, property, mode);
+		}
+		return;
+	}
+	// local devices are looked up by name, all matching entries are visited as names are not enforced to be unique
+	uint32_t index = name_hash(property->device) & (ROUTING_TABLE_SIZE - 1);
+	for (int i = 0; i < ROUTING_TABLE_SIZE; i++) {
+		indigo_device *device = routing_table[index];
+		if (device == NULL)
+			break;
+		if (device != ROUTING_TABLE_DELETED && !strcmp(property->device, device->name))
+			dispatch_request(type, device, client, property, mode);
+		index = (index + 1) & (ROUTING_TABLE_SIZE - 1);
+	}
+	for (int i = 0; i < proxy_slots_used; i++) {
+		indigo_device *device = proxy_devices[i];
+		if (device != NULL && (!indigo_use_host_suffix || strstr(property->device, device->name)))
+			dispatch_request(type, device, client, property, mode);
+	}
+}
+
 indigo_result indigo_attach_device(indigo_device *device) {
-	static int max_index = -1;
 	if ((!is_started) || (device == NULL))
 		return INDIGO_FAILED;
 	pthread_mutex_lock(&device_mutex);
 	INDIGO_DEBUG(indigo_trace_bus("B <- Attach device '%s'", device->name));
 	for (int i = 0; i < MAX_DEVICES; i++) {
 		if (devices[i] == NULL) {
-			if (i > max_index) {
-				max_index = i;
-				INDIGO_TRACE(indigo_trace("%d devices attached", max_index + 1));
+			if (i >= device_slots_used) {
+				device_slots_used = i + 1;
+				INDIGO_TRACE(indigo_trace("%d devices attached", device_slots_used));
 			}
 			devices[i] = device;
+			add_route(device);
 			pthread_mutex_unlock(&device_mutex);
+			char name[INDIGO_NAME_SIZE];
+			indigo_copy_name(name, device->name);
 			device->access_token = 0;
 			if (device->attach != NULL)
 				device->last_result = device->attach(device);
+			if (strcmp(name, device->name)) {
+				// attach() renamed the device, reindex it
+				pthread_mutex_lock(&device_mutex);
+				remove_route(device);
+				add_route(device);
+				pthread_mutex_unlock(&device_mutex);
+			}
 			if (!device->is_remote && device->change_property) {
 				indigo_property *property = indigo_init_switch_property(NULL, device->name, CONFIG_PROPERTY_NAME, NULL, NULL, INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, 1);
 				indigo_init_switch_item(property->items, CONFIG_LOAD_ITEM_NAME, NULL, true);
@@ -459,15 +679,14 @@ indigo_result indigo_attach_device(indigo_device *device) {
 }
 
 indigo_result indigo_attach_client(indigo_client *client) {
-	static int max_index = -1;
 	if ((!is_started) || (client == NULL))
 		return INDIGO_FAILED;
 	pthread_mutex_lock(&client_mutex);
 	for (int i = 0; i < MAX_CLIENTS; i++) {
 		if (clients[i] == NULL) {
-			if (i > max_index) {
-				max_index = i;
-				INDIGO_TRACE(indigo_trace("%d clients attached", max_index + 1));
+			if (i >= client_slots_used) {
+				client_slots_used = i + 1;
+				INDIGO_TRACE(indigo_trace("%d clients attached", client_slots_used));
 			}
 			clients[i] = client;
 			pthread_mutex_unlock(&client_mutex);
@@ -487,9 +706,10 @@ indigo_result indigo_detach_device(indigo_device *device) {
 		return INDIGO_FAILED;
 	pthread_mutex_lock(&device_mutex);
 	INDIGO_DEBUG(indigo_trace_bus("B <- Detach device '%s'", device->name));
-	for (int i = 0; i < MAX_DEVICES; i++) {
+	for (int i = 0; i < device_slots_used; i++) {
 		if (devices[i] == device) {
 			devices[i] = NULL;
+			remove_route(device);
 			pthread_mutex_unlock(&device_mutex);
 			if (device->detach != NULL) {
 				indigo_property *all_properties = indigo_init_text_property(NULL, device->name, "", "", "", INDIGO_OK_STATE, INDIGO_RO_PERM, 0);
@@ -509,7 +729,7 @@ indigo_result indigo_detach_client(indigo_client *client) {
 		return INDIGO_FAILED;
 	pthread_mutex_lock(&client_mutex);
 	INDIGO_DEBUG(indigo_trace_bus("B <- Detach client '%s'", client->name));
-	for (int i = 0; i < MAX_CLIENTS; i++) {
+	for (int i = 0; i < client_slots_used; i++) {
 		if (clients[i] == client) {
 			clients[i] = NULL;
 			pthread_mutex_unlock(&client_mutex);
@@ -528,17 +748,7 @@ indigo_result indigo_enumerate_properties(indigo_client *client, indigo_property
 	if (indigo_use_strict_locking)
 		pthread_mutex_lock(&device_mutex);
 	INDIGO_TRACE(indigo_trace_property("Enumerate", client, property, false, false));
-	for (int i = 0; i < MAX_DEVICES; i++) {
-		indigo_device *device = devices[i];
-		if (device != NULL && device->enumerate_properties != NULL) {
-			bool route = *property->device == 0;
-			route = route || !strcmp(property->device, device->name);
-			route = route || (indigo_use_host_suffix && *device->name == '@' && strstr(property->device, device->name));
-			route = route || (!indigo_use_host_suffix && *device->name == '@');
-			if (route)
-				device->last_result = device->enumerate_properties(device, client, property);
-		}
-	}
+	route_request(ROUTE_ENUMERATE, client, property, INDIGO_ENABLE_BLOB_ALSO);
 	if (indigo_use_strict_locking)
 		pthread_mutex_unlock(&device_mutex);
 	return INDIGO_OK;
@@ -550,22 +760,7 @@ indigo_result indigo_change_property(indigo_client *client, indigo_property *pro
 	if (indigo_use_strict_locking)
 		pthread_mutex_lock(&device_mutex);
 	INDIGO_TRACE(indigo_trace_property("Change", client, property, false, true));
-	for (int i = 0; i < MAX_DEVICES; i++) {
-		indigo_device *device = devices[i];
-		if (device != NULL && device->change_property != NULL) {
-			bool route = *property->device == 0;
-			route = route || !strcmp(property->device, device->name);
-			route = route || (indigo_use_host_suffix && *device->name == '@' && strstr(property->device, device->name));
-			route = route || (!indigo_use_host_suffix && *device->name == '@');
-			if (route) {
-				if (device->access_token != 0 && device->access_token != property->access_token && property->access_token != indigo_get_master_token()) {
-					indigo_send_message(device, "Device '%s' is protected or locked for exclusive access", device->name);
-					continue;
-				}
-				device->last_result = device->change_property(device, client, property);
-			}
-		}
-	}
+	route_request(ROUTE_CHANGE, client, property, INDIGO_ENABLE_BLOB_ALSO);
 	if (indigo_use_strict_locking)
 		pthread_mutex_unlock(&device_mutex);
 	return INDIGO_OK;
@@ -577,22 +772,365 @@ indigo_result indigo_enable_blob(indigo_client *client, indigo_property *propert
 	if (indigo_use_strict_locking)
 		pthread_mutex_lock(&device_mutex);
 	INDIGO_TRACE(indigo_trace_property("Enable BLOB mode", client, property, false, true));
-	for (int i = 0; i < MAX_DEVICES; i++) {
-		indigo_device *device = devices[i];
-		if (device != NULL && device->enable_blob != NULL) {
-			bool route = *property->device == 0;
-			route = route || !strcmp(property->device, device->name);
-			route = route || (indigo_use_host_suffix && *device->name == '@' && strstr(property->device, device->name));
-			route = route || (!indigo_use_host_suffix && *device->name == '@');
-			if (route)
-				device->last_result = device->enable_blob(device, client, property, mode);
-		}
-	}
+	route_request(ROUTE_ENABLE_BLOB, client, property, mode);
 	if (indigo_use_strict_locking)
 		pthread_mutex_unlock(&device_mutex);
 	return INDIGO_OK;
 }
 
+static inline unsigned blob_item_hash(indigo_item *item) {
+	return ((uint32_t)((uintptr_t)item / sizeof(indigo_item)) * 2654435761u) >> 24;
+}
+
+static inline unsigned blob_id_hash(uint32_t id) {
+	return (id * 2654435761u) >> 24;
+}
+
+static blob_record *find_blob_record(indigo_item *item) {
+	for (blob_record *record = blobs_by_item[blob_item_hash(item)]; record; record = record->next_by_item) {
+		if (record->entry.item == item)
+			return record;
+	}
+	return NULL;
+}
+
+static blob_record *register_blob_record(indigo_property *property, indigo_item *item) {
+	blob_record *record = find_blob_record(item);
+	if (record == NULL) {
+		record = indigo_safe_malloc(sizeof(blob_record));
+		memset(record, 0, sizeof(blob_record));
+		record->entry.item = item;
+		record->entry.property = property;
+		pthread_mutex_init(&record->entry.mutext, NULL);
+		// multiplication by odd constant is a bijection, so ids are unique, don't expose item addresses and differ between runs
+		do {
+			record->entry.id = (blob_id_seed + ++blob_id_counter) * 2654435761u;
+		} while (record->entry.id == 0);
+		unsigned hash = blob_item_hash(item);
+		record->next_by_item = blobs_by_item[hash];
+		blobs_by_item[hash] = record;
+		hash = blob_id_hash(record->entry.id);
+		record->next_by_id = blobs_by_id[hash];
+		blobs_by_id[hash] = record;
+		pthread_mutex_lock(&blob_lru_mutex);
+		blob_statistics.entries++;
+		pthread_mutex_unlock(&blob_lru_mutex);
+	}
+	return record;
+}
+
+static void unregister_blob_record(indigo_item *item) {
+	blob_record **link = blobs_by_item + blob_item_hash(item);
+	while (*link && (*link)->entry.item != item)
+		link = &(*link)->next_by_item;
+	blob_record *record = *link;
+	if (record == NULL)
+		return;
+	*link = record->next_by_item;
+	link = blobs_by_id + blob_id_hash(record->entry.id);
+	while (*link != record)
+		link = &(*link)->next_by_id;
+	*link = record->next_by_id;
+	pthread_mutex_lock(&record->entry.mutext);
+	indigo_set_blob_content(&record->entry, NULL, NULL, 0);
+	pthread_mutex_unlock(&record->entry.mutext);
+	pthread_mutex_destroy(&record->entry.mutext);
+	pthread_mutex_lock(&blob_lru_mutex);
+	blob_statistics.entries--;
+	pthread_mutex_unlock(&blob_lru_mutex);
+	free(record);
+}
+
+static void unlink_blob_lru(blob_record *record) {
+	if (record->lru_previous)
+		record->lru_previous->lru_next = record->lru_next;
+	else if (blob_lru_head == record)
+		blob_lru_head = record->lru_next;
+	else
+		return;
+	if (record->lru_next)
+		record->lru_next->lru_previous = record->lru_previous;
+	else
+		blob_lru_tail = record->lru_previous;
+	record->lru_previous = record->lru_next = NULL;
+}
+
+static void link_blob_lru(blob_record *record) {
+	record->lru_previous = NULL;
+	record->lru_next = blob_lru_head;
+	if (blob_lru_head)
+		blob_lru_head->lru_previous = record;
+	else
+		blob_lru_tail = record;
+	blob_lru_head = record;
+}
+
+static void evict_blobs(blob_record *keep) {
+	// called with blob_mutex locked, so victims can't be unregistered meanwhile
+	while (true) {
+		blob_record *victim = NULL;
+		pthread_mutex_lock(&blob_lru_mutex);
+		if (indigo_blob_cache_budget > 0 && blob_statistics.memory > indigo_blob_cache_budget) {
+			victim = blob_lru_tail;
+			if (victim == keep)
+				victim = victim->lru_previous;
+		}
+		pthread_mutex_unlock(&blob_lru_mutex);
+		if (victim == NULL)
+			break;
+		pthread_mutex_lock(&victim->entry.mutext);
+		bool evicted = victim->entry.buffer != NULL;
+		indigo_set_blob_content(&victim->entry, NULL, NULL, 0);
+		pthread_mutex_unlock(&victim->entry.mutext);
+		if (evicted) {
+			pthread_mutex_lock(&blob_lru_mutex);
+			blob_statistics.evictions++;
+			pthread_mutex_unlock(&blob_lru_mutex);
+			INDIGO_TRACE(indigo_trace("BLOB %s.%s.%s evicted", victim->entry.property->device, victim->entry.property->name, victim->entry.item->name));
+		}
+	}
+}
+
+static inline unsigned update_hash(indigo_property *property) {
+	return ((uint32_t)((uintptr_t)property / sizeof(void *)) * 2654435761u) >> 24;
+}
+
+static double monotonic_time() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static update_record *find_update_record(indigo_property *property) {
+	for (update_record *record = update_records[update_hash(property)]; record; record = record->next) {
+		if (record->property == property)
+			return record;
+	}
+	return NULL;
+}
+
+static void release_property_strings(indigo_property *property);
+
+// snapshot has no update or BLOB record, it can be released with update_mutex locked, strings retained by indigo_copy_property() are released
+
+static void release_snapshot(indigo_property *snapshot) {
+	if (snapshot->type == INDIGO_TEXT_VECTOR) {
+		for (int i = 0; i < snapshot->count; i++)
+			indigo_safe_free(snapshot->items[i].text.long_value);
+	}
+	release_property_strings(snapshot);
+	free(snapshot);
+}
+
+static void drop_pending_update(update_record *record) {
+	record->pending = false;
+	record->has_message = false;
+	if (record->snapshot) {
+		release_snapshot(record->snapshot);
+		record->snapshot = NULL;
+	}
+}
+
+static update_record *register_update_record(indigo_device *device, indigo_property *property) {
+	update_record *record = find_update_record(property);
+	if (record == NULL) {
+		record = indigo_safe_malloc(sizeof(update_record));
+		memset(record, 0, sizeof(update_record));
+		record->property = property;
+		unsigned hash = update_hash(property);
+		record->next = update_records[hash];
+		update_records[hash] = record;
+		update_record_count++;
+	}
+	record->device = device;
+	if (record->rules_generation != update_rules_generation) {
+		// rule for particular device takes precedence over rule for any device
+		record->rules_generation = update_rules_generation;
+		record->interval = 0;
+		for (update_rule *rule = update_rules; rule; rule = rule->next) {
+			if ((*rule->name == 0 || !strcmp(rule->name, property->name)) && (*rule->device == 0 || !strcmp(rule->device, property->device))) {
+				record->interval = rule->interval;
+				if (*rule->device)
+					break;
+			}
+		}
+	}
+	return record;
+}
+
+static void unregister_update_record(indigo_property *property) {
+	pthread_mutex_lock(&update_mutex);
+	update_record **link = update_records + update_hash(property);
+	while (*link && (*link)->property != property)
+		link = &(*link)->next;
+	update_record *record = *link;
+	if (record) {
+		*link = record->next;
+		update_record_count--;
+		while (record->flushing)
+			pthread_cond_wait(&update_cond, &update_mutex);
+		drop_pending_update(record);
+		indigo_safe_free(record->fingerprints);
+		indigo_safe_free(record->changed);
+		free(record);
+	}
+	pthread_mutex_unlock(&update_mutex);
+}
+
+static inline uint64_t fnv_hash(uint64_t hash, const void *data, size_t size) {
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ ((const unsigned char *)data)[i]) * 1099511628211ULL;
+	return hash;
+}
+
+static uint64_t item_fingerprint(indigo_property *property, indigo_item *item) {
+	uint64_t hash = 14695981039346656037ULL;
+	switch (property->type) {
+		case INDIGO_TEXT_VECTOR: {
+			char *value = indigo_get_text_item_value(item);
+			return fnv_hash(hash, value, strlen(value));
+		}
+		case INDIGO_NUMBER_VECTOR:
+			hash = fnv_hash(hash, &item->number.value, sizeof(double));
+			return fnv_hash(hash, &item->number.target, sizeof(double));
+		case INDIGO_SWITCH_VECTOR:
+			return fnv_hash(hash, &item->sw.value, sizeof(bool));
+		case INDIGO_LIGHT_VECTOR:
+			return fnv_hash(hash, &item->light.value, sizeof(indigo_property_state));
+		default:
+			return hash;
+	}
+}
+
+// called with update_mutex locked, remembers values to be sent and returns changed items (or NULL if all items have to be sent)
+
+static bool *mark_changed_items(update_record *record, indigo_property *property) {
+	if (property->type == INDIGO_BLOB_VECTOR || property->perm == INDIGO_WO_PERM) {
+		record->valid = false;
+		return NULL;
+	}
+	bool valid = record->valid && record->count == property->count;
+	if (record->count != property->count) {
+		record->count = property->count;
+		record->fingerprints = indigo_safe_realloc(record->fingerprints, record->count * sizeof(uint64_t) + 1);
+		record->changed = indigo_safe_realloc(record->changed, record->count * sizeof(bool) + 1);
+	}
+	for (int i = 0; i < property->count; i++) {
+		uint64_t fingerprint = item_fingerprint(property, property->items + i);
+		record->changed[i] = !valid || fingerprint != record->fingerprints[i];
+		record->fingerprints[i] = fingerprint;
+	}
+	record->valid = true;
+	return valid ? record->changed : NULL;
+}
+
+static void broadcast_update(indigo_device *device, indigo_property *property, const char *message, bool *changed) {
+	int count = property->count;
+	if (property->perm == INDIGO_WO_PERM)
+		property->count = 0;
+	INDIGO_TRACE(indigo_trace_property("Update", NULL, property, false, true));
+	if (indigo_use_blob_caching && property->type == INDIGO_BLOB_VECTOR && property->perm == INDIGO_RO_PERM && property->state == INDIGO_OK_STATE) {
+		pthread_mutex_lock(&blob_mutex);
+		for (int i = 0; i < property->count; i++) {
+			indigo_item *item = property->items + i;
+			blob_record *record = register_blob_record(property, item);
+			indigo_blob_entry *entry = &record->entry;
+			pthread_mutex_lock(&entry->mutext);
+			if (item->blob.size && item->blob.buffer) {
+				indigo_set_blob_content(entry, indigo_retain_blob_buffer(item->blob.buffer), item->blob.value, item->blob.size);
+				strcpy(entry->format, item->blob.format);
+			} else if (item->blob.size) {
+				// content shared with readers is never modified, reuse the buffer only if nobody else holds it
+				indigo_blob_buffer *buffer = entry->buffer;
+				pthread_mutex_lock(&blob_buffer_mutex);
+				bool exclusive = buffer && buffer->reference_count == 1;
+				pthread_mutex_unlock(&blob_buffer_mutex);
+				if (exclusive)
+					buffer->data = indigo_safe_realloc(buffer->data, buffer->size = item->blob.size);
+				else
+					buffer = indigo_create_blob_buffer(indigo_safe_malloc(item->blob.size), item->blob.size);
+				memcpy(buffer->data, item->blob.value, item->blob.size);
+				indigo_set_blob_content(entry, buffer, buffer->data, item->blob.size);
+				strcpy(entry->format, item->blob.format);
+			} else {
+				indigo_set_blob_content(entry, NULL, NULL, 0);
+			}
+			if (++entry->generation == 0)
+				entry->generation = 1;
+			pthread_mutex_unlock(&entry->mutext);
+			evict_blobs(record);
+		}
+		pthread_mutex_unlock(&blob_mutex);
+	}
+	// values shared by indigo_share_blob_value() are restored after all clients are served
+	indigo_item *blobs = NULL;
+	if (property->type == INDIGO_BLOB_VECTOR && property->count > 0)
+		blobs = indigo_safe_malloc_copy(property->count * sizeof(indigo_item), property->items);
+	property->changed = changed;
+	for (int i = 0; i < client_slots_used; i++) {
+		indigo_client *client = clients[i];
+		if (client != NULL && client->update_property != NULL)
+			client->last_result = client->update_property(client, device, property, message);
+	}
+	property->changed = NULL;
+	if (blobs) {
+		for (int i = 0; i < property->count; i++) {
+			indigo_item *item = property->items + i;
+			if (item->blob.buffer != blobs[i].blob.buffer) {
+				indigo_release_blob_buffer(item->blob.buffer);
+				item->blob.buffer = blobs[i].blob.buffer;
+				item->blob.value = blobs[i].blob.value;
+			}
+		}
+		free(blobs);
+	}
+	property->count = count;
+}
+
+static void flush_update(indigo_device *device, void *data) {
+	indigo_property *property = (indigo_property *)data;
+	if (indigo_use_strict_locking)
+		pthread_mutex_lock(&client_mutex);
+	pthread_mutex_lock(&update_mutex);
+	// property may be already released, record is found only if it is still alive
+	update_record *record = find_update_record(property);
+	if (record == NULL || !record->pending) {
+		if (record)
+			record->scheduled = false;
+		pthread_mutex_unlock(&update_mutex);
+		if (indigo_use_strict_locking)
+			pthread_mutex_unlock(&client_mutex);
+		return;
+	}
+	// live property belongs to the driver thread, only the snapshot taken by indigo_update_property() is sent
+	char message[INDIGO_VALUE_SIZE];
+	bool has_message = record->has_message;
+	if (has_message)
+		strcpy(message, record->message);
+	indigo_property *snapshot = record->snapshot;
+	record->snapshot = NULL;
+	record->scheduled = false;
+	record->pending = false;
+	record->has_message = false;
+	record->last_update = monotonic_time();
+	record->state = snapshot->state;
+	// record->changed may be rewritten by concurrent update while the snapshot is sent
+	bool *changed = mark_changed_items(record, snapshot);
+	if (changed)
+		changed = indigo_safe_malloc_copy(snapshot->count * sizeof(bool) + 1, changed);
+	record->flushing = true;
+	pthread_mutex_unlock(&update_mutex);
+	broadcast_update(record->device, snapshot, has_message ? message : NULL, changed);
+	pthread_mutex_lock(&update_mutex);
+	record->flushing = false;
+	pthread_cond_broadcast(&update_cond);
+	pthread_mutex_unlock(&update_mutex);
+	indigo_safe_free(changed);
+	release_snapshot(snapshot);
+	if (indigo_use_strict_locking)
+		pthread_mutex_unlock(&client_mutex);
+}
+
 indigo_result indigo_define_property(indigo_device *device, indigo_property *property, const char *format, ...) {
 	if ((!is_started) || (property == NULL))
 		return INDIGO_FAILED;
@@ -608,40 +1146,22 @@ indigo_result indigo_define_property(indigo_device *device, indigo_property *pro
 			vsnprintf(message, INDIGO_VALUE_SIZE, format, args);
 			va_end(args);
 		}
+		if (device != NULL && !device->is_remote) {
+			pthread_mutex_lock(&update_mutex);
+			update_record *record = register_update_record(device, property);
+			drop_pending_update(record);
+			record->state = property->state;
+			mark_changed_items(record, property);
+			pthread_mutex_unlock(&update_mutex);
+		}
 		if (indigo_use_blob_caching && property->type == INDIGO_BLOB_VECTOR && property->perm == INDIGO_WO_PERM) {
 			pthread_mutex_lock(&blob_mutex);
 			for (int i = 0; i < property->count; i++) {
-				indigo_item *item = property->items + i;
-				indigo_blob_entry *entry = NULL;
-				int free_index = -1;
-				for (int j = 0; j < MAX_BLOBS; j++) {
-					entry = blobs[j];
-					if (entry && entry->item == item) {
-						break;
-					}
-					if (entry == NULL && free_index == -1)
-						free_index = j;
-					entry = NULL;
-				}
-				if (entry == NULL && free_index >= 0) {
-					entry = indigo_safe_malloc(sizeof(indigo_blob_entry));
-					blobs[free_index] = entry;
-					memset(entry, 0, sizeof(indigo_blob_entry));
-					entry->item = item;
-					entry->property = property;
-					pthread_mutex_init(&entry->mutext, NULL);
-				}
-				if (entry == NULL) {
-					pthread_mutex_unlock(&blob_mutex);
-					if (indigo_use_strict_locking)
-						pthread_mutex_unlock(&client_mutex);
-					indigo_error("[%s:%d] Max BLOB count reached", __FUNCTION__, __LINE__);
-					return INDIGO_TOO_MANY_ELEMENTS;
-				}
+				register_blob_record(property, property->items + i);
 			}
 			pthread_mutex_unlock(&blob_mutex);
 		}
-		for (int i = 0; i < MAX_CLIENTS; i++) {
+		for (int i = 0; i < client_slots_used; i++) {
 			indigo_client *client = clients[i];
 			if (client != NULL && client->define_property != NULL)
 				client->last_result = client->define_property(client, device, property, format != NULL ? message : NULL);
@@ -659,73 +1179,77 @@ indigo_result indigo_update_property(indigo_device *device, indigo_property *pro
 		pthread_mutex_lock(&client_mutex);
 	if (!property->hidden) {
 		char message[INDIGO_VALUE_SIZE];
-		int count = property->count;
-		if (property->perm == INDIGO_WO_PERM)
-			property->count = 0;
-		INDIGO_TRACE(indigo_trace_property("Update", NULL, property, false, true));
 		if (format != NULL) {
 			va_list args;
 			va_start(args, format);
 			vsnprintf(message, INDIGO_VALUE_SIZE, format, args);
 			va_end(args);
 		}
-		if (indigo_use_blob_caching && property->type == INDIGO_BLOB_VECTOR && property->perm == INDIGO_RO_PERM && property->state == INDIGO_OK_STATE) {
-			pthread_mutex_lock(&blob_mutex);
-			for (int i = 0; i < property->count; i++) {
-				indigo_item *item = property->items + i;
-				indigo_blob_entry *entry = NULL;
-				int free_index = -1;
-				for (int j = 0; j < MAX_BLOBS; j++) {
-					entry = blobs[j];
-					if (entry && entry->item == item) {
-						break;
-					}
-					if (entry == NULL && free_index == -1)
-						free_index = j;
-					entry = NULL;
-				}
-				if (entry == NULL && free_index >= 0) {
-					entry = indigo_safe_malloc(sizeof(indigo_blob_entry));
-					blobs[free_index] = entry;
-					memset(entry, 0, sizeof(indigo_blob_entry));
-					entry->item = item;
-					entry->property = property;
-					pthread_mutex_init(&entry->mutext, NULL);
-				}
-				if (entry) {
-					pthread_mutex_lock(&entry->mutext);
-					if (item->blob.size) {
-						entry->content = indigo_safe_realloc(entry->content, entry->size = item->blob.size);
-						memcpy(entry->content, item->blob.value, entry->size);
-						strcpy(entry->format, item->blob.format);
-					} else if (entry->content) {
-						free(entry->content);
-						entry->size = 0;
-						entry->content = NULL;
-					}
-					pthread_mutex_unlock(&entry->mutext);
-				} else {
-					pthread_mutex_unlock(&blob_mutex);
-					if (indigo_use_strict_locking)
-						pthread_mutex_unlock(&client_mutex);
-					indigo_error("[%s:%d] Max BLOB count reached", __FUNCTION__, __LINE__);
-					return INDIGO_TOO_MANY_ELEMENTS;
+		bool *changed = NULL;
+		if (device != NULL && !device->is_remote) {
+			pthread_mutex_lock(&update_mutex);
+			update_record *record = register_update_record(device, property);
+			double now = monotonic_time();
+			// BLOB vectors are never delayed, BLOB cache and paths are bound to items of the live property
+			if (record->interval > 0 && property->type != INDIGO_BLOB_VECTOR && property->state == record->state && now < record->last_update + record->interval) {
+				// last value wins, pending update is sent by flush_update() when the interval expires, state changes are never delayed
+				record->pending = true;
+				if (record->snapshot)
+					release_snapshot(record->snapshot);
+				record->snapshot = indigo_copy_property(NULL, property);
+				if (format != NULL) {
+					strcpy(record->message, message);
+					record->has_message = true;
 				}
+				// timer is not bound to device (it may have no driver context), flush_update() checks that property still exists
+				if (!record->scheduled)
+					record->scheduled = indigo_set_timer_with_data(NULL, record->last_update + record->interval - now, flush_update, NULL, property);
+				pthread_mutex_unlock(&update_mutex);
+				if (indigo_use_strict_locking)
+					pthread_mutex_unlock(&client_mutex);
+				return INDIGO_OK;
 			}
-			pthread_mutex_unlock(&blob_mutex);
-		}
-		for (int i = 0; i < MAX_CLIENTS; i++) {
-			indigo_client *client = clients[i];
-			if (client != NULL && client->update_property != NULL)
-				client->last_result = client->update_property(client, device, property, format != NULL ? message : NULL);
+			drop_pending_update(record);
+			record->last_update = now;
+			record->state = property->state;
+			changed = mark_changed_items(record, property);
+			pthread_mutex_unlock(&update_mutex);
 		}
-		property->count = count;
+		broadcast_update(device, property, format != NULL ? message : NULL, changed);
 	}
 	if (indigo_use_strict_locking)
 		pthread_mutex_unlock(&client_mutex);
 	return INDIGO_OK;
 }
 
+bool indigo_item_changed(indigo_property *property, indigo_item *item) {
+	return property->changed == NULL || property->changed[item - property->items];
+}
+
+void indigo_set_update_rate(const char *device, const char *name, double rate) {
+	pthread_mutex_lock(&update_mutex);
+	update_rule **link = &update_rules;
+	while (*link && (strcmp((*link)->device, device ? device : "") || strcmp((*link)->name, name ? name : "")))
+		link = &(*link)->next;
+	update_rule *rule = *link;
+	if (rate > 0) {
+		if (rule == NULL) {
+			rule = indigo_safe_malloc(sizeof(update_rule));
+			memset(rule, 0, sizeof(update_rule));
+			indigo_copy_name(rule->device, device ? device : "");
+			indigo_copy_name(rule->name, name ? name : "");
+			*link = rule;
+		}
+		rule->interval = 1 / rate;
+	} else if (rule) {
+		*link = rule->next;
+		free(rule);
+	}
+	if (++update_rules_generation == 0)
+		update_rules_generation = 1;
+	pthread_mutex_unlock(&update_mutex);
+}
+
 indigo_result indigo_delete_property(indigo_device *device, indigo_property *property, const char *format, ...) {
 	if ((!is_started) || (property == NULL))
 		return INDIGO_FAILED;
@@ -734,6 +1258,19 @@ indigo_result indigo_delete_property(indigo_device *device, indigo_property *pro
 	if (!property->hidden) {
 		INDIGO_TRACE(indigo_trace_property("Remove", NULL, property, false, false));
 		property->defined = false;
+		if (update_record_count) {
+			// pending rate limited updates are dropped, property is sent in full when defined again
+			pthread_mutex_lock(&update_mutex);
+			for (int i = 0; i < UPDATE_HASH_SIZE; i++) {
+				for (update_record *record = update_records[i]; record; record = record->next) {
+					if (record->property == property || (*property->name == 0 && record->device == device)) {
+						drop_pending_update(record);
+						record->valid = false;
+					}
+				}
+			}
+			pthread_mutex_unlock(&update_mutex);
+		}
 		char message[INDIGO_VALUE_SIZE];
 		if (format != NULL) {
 			va_list args;
@@ -741,7 +1278,7 @@ indigo_result indigo_delete_property(indigo_device *device, indigo_property *pro
 			vsnprintf(message, INDIGO_VALUE_SIZE, format, args);
 			va_end(args);
 		}
-		for (int i = 0; i < MAX_CLIENTS; i++) {
+		for (int i = 0; i < client_slots_used; i++) {
 			indigo_client *client = clients[i];
 			if (client != NULL && client->delete_property != NULL)
 				client->last_result = client->delete_property(client, device, property, format != NULL ? message : NULL);
@@ -765,7 +1302,7 @@ indigo_result indigo_send_message(indigo_device *device, const char *format, ...
 		va_end(args);
 	}
 	INDIGO_DEBUG(indigo_trace_bus("B <- Sent message '%s'", message));
-	for (int i = 0; i < MAX_CLIENTS; i++) {
+	for (int i = 0; i < client_slots_used; i++) {
 		indigo_client *client = clients[i];
 		if (client != NULL && client->send_message != NULL)
 			client->last_result = client->send_message(client, device, format != NULL ? message : NULL);
@@ -779,7 +1316,7 @@ indigo_result indigo_stop() {
 	INDIGO_DEBUG(indigo_trace_bus("B <- Stop bus"));
 	if (is_started) {
 		pthread_mutex_lock(&client_mutex);
-		for (int i = 0; i < MAX_CLIENTS; i++) {
+		for (int i = 0; i < client_slots_used; i++) {
 			indigo_client *client = clients[i];
 			if (client != NULL && client->detach != NULL) {
 				clients[i] = NULL;
@@ -788,7 +1325,7 @@ indigo_result indigo_stop() {
 		}
 		pthread_mutex_unlock(&client_mutex);
 		pthread_mutex_lock(&device_mutex);
-		for (int i = 0; i < MAX_DEVICES; i++) {
+		for (int i = 0; i < device_slots_used; i++) {
 			indigo_device *device = devices[i];
 			if (device != NULL) {
 				indigo_error("INDIGO Bus: can't stop, '%s' is attached", device->name);
@@ -802,14 +1339,205 @@ indigo_result indigo_stop() {
 	return INDIGO_OK;
 }
 
+#define INTERN_HASH_SIZE	4096
+
+// Interned strings are reference counted, each label, hints and number format within property->count items holds one reference.
+// Records are found by content when interned and by address when retained or released, so literals and unknown pointers are ignored.
+// Unreferenced record is evicted immediately, properties must be copied with indigo_copy_property() and released with indigo_release_property().
+
+typedef struct intern_record {
+	struct intern_record *next_by_hash;
+	struct intern_record *next_by_address;
+	uint64_t hash;
+	int references;
+	char string[];
+} intern_record;
+
+static intern_record *interned_by_hash[INTERN_HASH_SIZE];
+static intern_record *interned_by_address[INTERN_HASH_SIZE];
+static pthread_mutex_t intern_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static inline unsigned intern_address_hash(const char *string) {
+	return (((uint32_t)((uintptr_t)string / sizeof(void *)) * 2654435761u) >> 20) % INTERN_HASH_SIZE;
+}
+
+static intern_record *find_interned(const char *string) {
+	for (intern_record *record = interned_by_address[intern_address_hash(string)]; record; record = record->next_by_address) {
+		if (record->string == string)
+			return record;
+	}
+	return NULL;
+}
+
+static void unlink_interned(intern_record *record) {
+	intern_record **link = interned_by_hash + (record->hash % INTERN_HASH_SIZE);
+	while (*link != record)
+		link = &(*link)->next_by_hash;
+	*link = record->next_by_hash;
+	link = interned_by_address + intern_address_hash(record->string);
+	while (*link != record)
+		link = &(*link)->next_by_address;
+	*link = record->next_by_address;
+}
+
+const char *indigo_intern_string(const char *string) {
+	if (string == NULL || *string == 0)
+		return "";
+	size_t length = strnlen(string, INDIGO_VALUE_SIZE - 1);
+	uint64_t hash = fnv_hash(14695981039346656037ULL, string, length);
+	pthread_mutex_lock(&intern_mutex);
+	intern_record *record = interned_by_hash[hash % INTERN_HASH_SIZE];
+	while (record && (record->hash != hash || strncmp(record->string, string, length) || record->string[length]))
+		record = record->next_by_hash;
+	if (record == NULL) {
+		record = indigo_safe_malloc(sizeof(intern_record) + length + 1);
+		record->hash = hash;
+		record->references = 0;
+		memcpy(record->string, string, length);
+		record->string[length] = 0;
+		record->next_by_hash = interned_by_hash[hash % INTERN_HASH_SIZE];
+		interned_by_hash[hash % INTERN_HASH_SIZE] = record;
+		unsigned address_hash = intern_address_hash(record->string);
+		record->next_by_address = interned_by_address[address_hash];
+		interned_by_address[address_hash] = record;
+	}
+	record->references++;
+	pthread_mutex_unlock(&intern_mutex);
+	return record->string;
+}
+
+const char *indigo_intern_printf(const char *format, ...) {
+	char string[INDIGO_VALUE_SIZE];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(string, INDIGO_VALUE_SIZE, format, args);
+	va_end(args);
+	return indigo_intern_string(string);
+}
+
+const char *indigo_retain_string(const char *string) {
+	if (string == NULL || *string == 0)
+		return string;
+	pthread_mutex_lock(&intern_mutex);
+	intern_record *record = find_interned(string);
+	if (record)
+		record->references++;
+	pthread_mutex_unlock(&intern_mutex);
+	return string;
+}
+
+void indigo_release_string(const char *string) {
+	if (string == NULL || *string == 0)
+		return;
+	pthread_mutex_lock(&intern_mutex);
+	intern_record *record = find_interned(string);
+	if (record && record->references > 0 && --record->references == 0) {
+		unlink_interned(record);
+		free(record);
+	}
+	pthread_mutex_unlock(&intern_mutex);
+}
+
+void indigo_set_string(const char **field, const char *string) {
+	const char *previous = *field;
+	*field = indigo_intern_string(string);
+	indigo_release_string(previous);
+}
+
+void indigo_set_string_printf(const char **field, const char *format, ...) {
+	char string[INDIGO_VALUE_SIZE];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(string, INDIGO_VALUE_SIZE, format, args);
+	va_end(args);
+	indigo_set_string(field, string);
+}
+
+void indigo_get_intern_statistics(int *count, long *size) {
+	*count = 0;
+	*size = 0;
+	pthread_mutex_lock(&intern_mutex);
+	for (int i = 0; i < INTERN_HASH_SIZE; i++) {
+		for (intern_record *record = interned_by_hash[i]; record; record = record->next_by_hash) {
+			(*count)++;
+			*size += sizeof(intern_record) + strlen(record->string) + 1;
+		}
+	}
+	pthread_mutex_unlock(&intern_mutex);
+}
+
+static void init_item_strings(indigo_property *property, int first) {
+	for (int i = first; i < property->count; i++) {
+		indigo_item *item = property->items + i;
+		item->label = item->hints = "";
+		if (property->type == INDIGO_NUMBER_VECTOR)
+			item->number.format = "%g";
+	}
+}
+
+static void retain_item_strings(indigo_property *property, int first) {
+	for (int i = first; i < property->count; i++) {
+		indigo_item *item = property->items + i;
+		indigo_retain_string(item->label);
+		indigo_retain_string(item->hints);
+		if (property->type == INDIGO_NUMBER_VECTOR)
+			indigo_retain_string(item->number.format);
+	}
+}
+
+static void release_item_strings(indigo_property *property, int first) {
+	for (int i = first; i < property->count; i++) {
+		indigo_item *item = property->items + i;
+		indigo_release_string(item->label);
+		indigo_release_string(item->hints);
+		if (property->type == INDIGO_NUMBER_VECTOR)
+			indigo_release_string(item->number.format);
+	}
+}
+
+// property strings and strings of all its items are released, items are dropped
+
+static void release_property_strings(indigo_property *property) {
+	release_item_strings(property, 0);
+	indigo_release_string(property->label);
+	indigo_release_string(property->hints);
+	property->label = property->hints = "";
+	property->count = 0;
+}
+
+void indigo_copy_items(indigo_property *property, indigo_property *other) {
+	assert(property->allocated_count >= other->count);
+	release_item_strings(property, 0);
+	property->count = other->count;
+	memcpy(property->items, other->items, other->count * sizeof(indigo_item));
+	retain_item_strings(property, 0);
+}
+
+void indigo_remove_item(indigo_property *property, int index) {
+	assert(index >= 0 && index < property->count);
+	indigo_item *item = property->items + index;
+	indigo_release_string(item->label);
+	indigo_release_string(item->hints);
+	if (property->type == INDIGO_NUMBER_VECTOR)
+		indigo_release_string(item->number.format);
+	else if (property->type == INDIGO_TEXT_VECTOR)
+		indigo_safe_free(item->text.long_value);
+	memmove(item, item + 1, (property->count - index - 1) * sizeof(indigo_item));
+	property->count--;
+	memset(property->items + property->count, 0, sizeof(indigo_item));
+}
+
 indigo_property *indigo_init_text_property(indigo_property *property, const char *device, const char *name, const char *group, const char *label, indigo_property_state state, indigo_property_perm perm, int count) {
 	assert(device != NULL);
 	assert(name != NULL);
 	int size = sizeof(indigo_property)+count*(sizeof(indigo_item));
+	// label may be the current label of reused property, it is interned before property strings are released
+	label = indigo_intern_string(label);
 	int allocated_count = count;
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		release_property_strings(property);
 		property = indigo_resize_property(property, count);
 		allocated_count = property->allocated_count;
 	}
@@ -817,13 +1545,15 @@ indigo_property *indigo_init_text_property(indigo_property *property, const char
 	indigo_copy_name(property->device, device);
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
-	indigo_copy_value(property->label, label ? label : "");
+	property->label = label;
 	property->type = INDIGO_TEXT_VECTOR;
 	property->state = state;
 	property->perm = perm;
 	property->version = INDIGO_VERSION_CURRENT;
 	property->count = count;
 	property->allocated_count = allocated_count;
+	property->hints = "";
+	init_item_strings(property, 0);
 	return property;
 }
 
@@ -831,10 +1561,12 @@ indigo_property *indigo_init_number_property(indigo_property *property, const ch
 	assert(device != NULL);
 	assert(name != NULL);
 	int size = sizeof(indigo_property) + count * sizeof(indigo_item);
+	label = indigo_intern_string(label);
 	int allocated_count = count;
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		release_property_strings(property);
 		property = indigo_resize_property(property, count);
 		allocated_count = property->allocated_count;
 	}
@@ -842,13 +1574,15 @@ indigo_property *indigo_init_number_property(indigo_property *property, const ch
 	indigo_copy_name(property->device, device);
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
-	indigo_copy_value(property->label, label ? label : "");
+	property->label = label;
 	property->type = INDIGO_NUMBER_VECTOR;
 	property->state = state;
 	property->perm = perm;
 	property->version = INDIGO_VERSION_CURRENT;
 	property->count = count;
 	property->allocated_count = allocated_count;
+	property->hints = "";
+	init_item_strings(property, 0);
 	return property;
 }
 
@@ -856,10 +1590,12 @@ indigo_property *indigo_init_switch_property(indigo_property *property, const ch
 	assert(device != NULL);
 	assert(name != NULL);
 	int size = sizeof(indigo_property) + count * sizeof(indigo_item);
+	label = indigo_intern_string(label);
 	int allocated_count = count;
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		release_property_strings(property);
 		property = indigo_resize_property(property, count);
 		allocated_count = property->allocated_count;
 	}
@@ -867,7 +1603,7 @@ indigo_property *indigo_init_switch_property(indigo_property *property, const ch
 	indigo_copy_name(property->device, device);
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
-	indigo_copy_value(property->label, label ? label : "");
+	property->label = label;
 	property->type = INDIGO_SWITCH_VECTOR;
 	property->state = state;
 	property->perm = perm;
@@ -875,6 +1611,8 @@ indigo_property *indigo_init_switch_property(indigo_property *property, const ch
 	property->version = INDIGO_VERSION_CURRENT;
 	property->count = count;
 	property->allocated_count = allocated_count;
+	property->hints = "";
+	init_item_strings(property, 0);
 	return property;
 }
 
@@ -882,10 +1620,12 @@ indigo_property *indigo_init_light_property(indigo_property *property, const cha
 	assert(device != NULL);
 	assert(name != NULL);
 	int size = sizeof(indigo_property) + count * sizeof(indigo_item);
+	label = indigo_intern_string(label);
 	int allocated_count = count;
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		release_property_strings(property);
 		property = indigo_resize_property(property, count);
 		allocated_count = property->allocated_count;
 	}
@@ -893,13 +1633,15 @@ indigo_property *indigo_init_light_property(indigo_property *property, const cha
 	indigo_copy_name(property->device, device);
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
-	indigo_copy_value(property->label, label ? label : "");
+	property->label = label;
 	property->type = INDIGO_LIGHT_VECTOR;
 	property->perm = INDIGO_RO_PERM;
 	property->state = state;
 	property->version = INDIGO_VERSION_CURRENT;
 	property->count = count;
 	property->allocated_count = allocated_count;
+	property->hints = "";
+	init_item_strings(property, 0);
 	return property;
 }
 
@@ -914,10 +1656,12 @@ indigo_property *indigo_init_blob_property_p(indigo_property *property, const ch
 		perm = INDIGO_RO_PERM;
 	}
 	int size = sizeof(indigo_property) + count * sizeof(indigo_item);
+	label = indigo_intern_string(label);
 	int allocated_count = count;
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		release_property_strings(property);
 		property = indigo_resize_property(property, count);
 		allocated_count = property->allocated_count;
 	}
@@ -925,13 +1669,15 @@ indigo_property *indigo_init_blob_property_p(indigo_property *property, const ch
 	indigo_copy_name(property->device, device);
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
-	indigo_copy_value(property->label, label ? label : "");
+	property->label = label;
 	property->type = INDIGO_BLOB_VECTOR;
 	property->perm = perm;
 	property->state = state;
 	property->version = INDIGO_VERSION_CURRENT;
 	property->count = count;
 	property->allocated_count = allocated_count;
+	property->hints = "";
+	init_item_strings(property, 0);
 	return property;
 }
 
@@ -940,23 +1686,38 @@ indigo_property *indigo_resize_property(indigo_property *property, int count) {
 	if (property->count == count)
 		return property;
 	if (count > property->allocated_count) {
+		if (update_record_count)
+			unregister_update_record(property);
 		property = indigo_safe_realloc(property, sizeof(indigo_property) + count * sizeof(indigo_item));
 		property->allocated_count = count;
 	}
 	assert(property != NULL);
-	if (count > property->count)
-		memset(property->items+property->count, 0, (count - property->count) * sizeof(indigo_item));
+	int first = property->count;
+	if (count < first)
+		release_item_strings(property, count);
 	property->count = count;
+	if (count > first) {
+		memset(property->items + first, 0, (count - first) * sizeof(indigo_item));
+		init_item_strings(property, first);
+	}
 	return property;
 }
 
 indigo_property *indigo_copy_property(indigo_property *copy, indigo_property *property) {
+	int allocated_count = property->allocated_count;
 	if (copy == NULL) {
-		copy = indigo_safe_malloc(sizeof(indigo_property) + property->allocated_count * sizeof(indigo_item));
+		copy = indigo_safe_malloc(sizeof(indigo_property) + allocated_count * sizeof(indigo_item));
 	} else {
+		release_property_strings(copy);
 		copy = indigo_resize_property(copy, property->count);
+		allocated_count = copy->allocated_count;
 	}
 	memcpy(copy, property, sizeof(indigo_property) + property->count * sizeof(indigo_item));
+	copy->allocated_count = allocated_count;
+	copy->changed = NULL;
+	indigo_retain_string(copy->label);
+	indigo_retain_string(copy->hints);
+	retain_item_strings(copy, 0);
 	if (copy->type == INDIGO_TEXT_VECTOR) {
 		for (int k = 0; k < copy->count; k++) {
 			indigo_item *item = copy->items + k;
@@ -970,9 +1731,11 @@ indigo_property *indigo_copy_property(indigo_property *copy, indigo_property *pr
 }
 
 indigo_property *indigo_clear_property(indigo_property *property) {
+	release_property_strings(property);
 	int allocated_count = property->allocated_count;
 	memset(property, 0, sizeof(indigo_property) + allocated_count * sizeof(indigo_item));
 	property->allocated_count = allocated_count;
+	property->label = property->hints = "";
 	return property;
 }
 
@@ -980,22 +1743,13 @@ indigo_property *indigo_clear_property(indigo_property *property) {
 void indigo_release_property(indigo_property *property) {
 	if (property == NULL)
 		return;
+	if (update_record_count)
+		unregister_update_record(property);
 	if (property->type == INDIGO_BLOB_VECTOR) {
 		pthread_mutex_lock(&blob_mutex);
 		for (int i = 0; i < property->count; i++) {
 			indigo_item *item = property->items + i;
-			for (int j = 0; j < MAX_BLOBS; j++) {
-				indigo_blob_entry *entry = blobs[j];
-				if (entry && entry->item == item) {
-					pthread_mutex_lock(&entry->mutext);
-					blobs[j] = NULL;
-					indigo_safe_free(entry->content);
-					pthread_mutex_unlock(&entry->mutext);
-					pthread_mutex_destroy(&entry->mutext);
-					indigo_safe_free(entry);
-					break;
-				}
-			}
+			unregister_blob_record(item);
 			if (property->perm == INDIGO_WO_PERM) {
 				indigo_safe_free(item->blob.value);
 			}
@@ -1005,39 +1759,173 @@ void indigo_release_property(indigo_property *property) {
 		for (int i = 0; i < property->count; i++)
 			indigo_safe_free(property->items[i].text.long_value);
 	}
+	release_property_strings(property);
 	free(property);
 }
 
 indigo_blob_entry *indigo_validate_blob(indigo_item *item) {
-	for (int j = 0; j < MAX_BLOBS; j++) {
-		indigo_blob_entry *entry = blobs[j];
-		if (entry && entry->item == item)
-			return entry;
-	}
-	return NULL;
+	pthread_mutex_lock(&blob_mutex);
+	blob_record *record = find_blob_record(item);
+	pthread_mutex_unlock(&blob_mutex);
+	return record ? &record->entry : NULL;
 }
 
 indigo_blob_entry *indigo_find_blob(indigo_property *other_property, indigo_item *other_item) {
 	assert(other_property != NULL);
 	assert(other_item != NULL);
-	for (int j = 0; j < MAX_BLOBS; j++) {
-		indigo_blob_entry *entry = blobs[j];
-		if (entry) {
-			indigo_property *property = entry->property;
-			indigo_item *item = entry->item;
-			if (!strncmp(property->device, other_property->device, INDIGO_NAME_SIZE) && !strncmp(property->name, other_property->name, INDIGO_NAME_SIZE) && !strncmp(item->name, other_item->name, INDIGO_NAME_SIZE))
-				return entry;
+	indigo_blob_entry *result = NULL;
+	pthread_mutex_lock(&blob_mutex);
+	for (int j = 0; j < BLOB_HASH_SIZE && result == NULL; j++) {
+		for (blob_record *record = blobs_by_item[j]; record; record = record->next_by_item) {
+			indigo_property *property = record->entry.property;
+			indigo_item *item = record->entry.item;
+			if (!strncmp(property->device, other_property->device, INDIGO_NAME_SIZE) && !strncmp(property->name, other_property->name, INDIGO_NAME_SIZE) && !strncmp(item->name, other_item->name, INDIGO_NAME_SIZE)) {
+				result = &record->entry;
+				break;
+			}
 		}
 	}
-	return NULL;
+	pthread_mutex_unlock(&blob_mutex);
+	return result;
+}
+
+indigo_blob_entry *indigo_validate_blob_id(uint32_t id) {
+	blob_record *record;
+	pthread_mutex_lock(&blob_mutex);
+	for (record = blobs_by_id[blob_id_hash(id)]; record; record = record->next_by_id) {
+		if (record->entry.id == id)
+			break;
+	}
+	pthread_mutex_unlock(&blob_mutex);
+	return record ? &record->entry : NULL;
+}
+
+char *indigo_blob_path(indigo_property *property, indigo_item *item, bool versioned, char *path, int size) {
+	// item is registered on demand, so the path can always be resolved by indigo_parse_blob_path()
+	pthread_mutex_lock(&blob_mutex);
+	blob_record *record = register_blob_record(property, item);
+	uint32_t id = record->entry.id;
+	uint32_t generation = record->entry.generation;
+	pthread_mutex_unlock(&blob_mutex);
+	if (versioned && generation)
+		snprintf(path, size, "/blob/%08x-%u", id, generation);
+	else
+		snprintf(path, size, "/blob/%08x", id);
+	return path;
+}
+
+indigo_blob_entry *indigo_parse_blob_path(const char *path, uint32_t *generation) {
+	unsigned id = 0, version = 0;
+	indigo_blob_entry *entry = NULL;
+	if (sscanf(path, "/blob/%x-%u", &id, &version) >= 1)
+		entry = indigo_validate_blob_id(id);
+	if (entry == NULL) {
+		pthread_mutex_lock(&blob_lru_mutex);
+		blob_statistics.misses++;
+		pthread_mutex_unlock(&blob_lru_mutex);
+	}
+	*generation = version;
+	return entry;
 }
 
+indigo_blob_buffer *indigo_create_blob_buffer(void *data, long size) {
+	indigo_blob_buffer *buffer = indigo_safe_malloc(sizeof(indigo_blob_buffer));
+	buffer->data = data;
+	buffer->size = size;
+	buffer->reference_count = 1;
+	return buffer;
+}
+
+indigo_blob_buffer *indigo_retain_blob_buffer(indigo_blob_buffer *buffer) {
+	assert(buffer != NULL);
+	pthread_mutex_lock(&blob_buffer_mutex);
+	buffer->reference_count++;
+	pthread_mutex_unlock(&blob_buffer_mutex);
+	return buffer;
+}
+
+void indigo_release_blob_buffer(indigo_blob_buffer *buffer) {
+	assert(buffer != NULL);
+	pthread_mutex_lock(&blob_buffer_mutex);
+	bool last = --buffer->reference_count == 0;
+	pthread_mutex_unlock(&blob_buffer_mutex);
+	if (last) {
+		indigo_safe_free(buffer->data);
+		free(buffer);
+	}
+}
+
+indigo_blob_buffer *indigo_share_blob_value(indigo_item *item) {
+	assert(item != NULL);
+	if (item->blob.buffer == NULL) {
+		// the reference owned by the item is released by broadcast_update()
+		item->blob.buffer = indigo_create_blob_buffer(indigo_safe_malloc_copy(item->blob.size, item->blob.value), item->blob.size);
+		item->blob.value = item->blob.buffer->data;
+	}
+	return indigo_retain_blob_buffer(item->blob.buffer);
+}
+
+indigo_blob_buffer *indigo_retain_blob_content(indigo_blob_entry *entry, uint32_t generation, void **content, long *size) {
+	assert(entry != NULL);
+	blob_record *record = (blob_record *)entry;
+	indigo_blob_buffer *buffer = NULL;
+	pthread_mutex_lock(&entry->mutext);
+	if (entry->buffer && (generation == 0 || generation == entry->generation)) {
+		buffer = indigo_retain_blob_buffer(entry->buffer);
+		*content = entry->content;
+		*size = entry->size;
+	}
+	pthread_mutex_lock(&blob_lru_mutex);
+	if (buffer) {
+		blob_statistics.hits++;
+		unlink_blob_lru(record);
+		link_blob_lru(record);
+	} else {
+		blob_statistics.misses++;
+	}
+	pthread_mutex_unlock(&blob_lru_mutex);
+	pthread_mutex_unlock(&entry->mutext);
+	return buffer;
+}
+
+void indigo_set_blob_content(indigo_blob_entry *entry, indigo_blob_buffer *buffer, void *content, long size) {
+	assert(entry != NULL);
+	blob_record *record = (blob_record *)entry;
+	indigo_blob_buffer *previous = entry->buffer != buffer ? entry->buffer : NULL;
+	entry->buffer = buffer;
+	entry->content = buffer ? content : NULL;
+	entry->size = buffer ? size : 0;
+	pthread_mutex_lock(&blob_lru_mutex);
+	unlink_blob_lru(record);
+	if (buffer)
+		link_blob_lru(record);
+	blob_statistics.memory += entry->size - record->accounted;
+	record->accounted = entry->size;
+	pthread_mutex_unlock(&blob_lru_mutex);
+	if (previous)
+		indigo_release_blob_buffer(previous);
+}
+
+void indigo_get_blob_cache_statistics(indigo_blob_cache_statistics *statistics) {
+	pthread_mutex_lock(&blob_lru_mutex);
+	*statistics = blob_statistics;
+	statistics->budget = indigo_blob_cache_budget;
+	pthread_mutex_unlock(&blob_lru_mutex);
+}
+
+// items are often reinitialized in place, references held by the previous label and hints are released
+
 void indigo_init_text_item(indigo_item *item, const char *name, const char *label, const char *format, ...) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *previous_label = item->label, *previous_hints = item->hints;
+	label = indigo_intern_string(label);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = label;
+	item->hints = "";
+	indigo_release_string(previous_label);
+	indigo_release_string(previous_hints);
 	va_list args;
 	va_start(args, format);
 	vsnprintf(item->text.value, INDIGO_VALUE_SIZE, format, args);
@@ -1047,19 +1935,29 @@ void indigo_init_text_item(indigo_item *item, const char *name, const char *labe
 void indigo_init_text_item_raw(indigo_item *item, const char *name, const char *label, const char *value) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *previous_label = item->label, *previous_hints = item->hints;
+	label = indigo_intern_string(label);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = label;
+	item->hints = "";
+	indigo_release_string(previous_label);
+	indigo_release_string(previous_hints);
 	indigo_set_text_item_value(item, value);
 }
 
 void indigo_init_number_item(indigo_item *item, const char *name, const char *label, double min, double max, double step, double value) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *previous_label = item->label, *previous_hints = item->hints;
+	label = indigo_intern_string(label);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
-	indigo_copy_value(item->number.format, "%g");
+	item->label = label;
+	item->hints = "";
+	indigo_release_string(previous_label);
+	indigo_release_string(previous_hints);
+	item->number.format = "%g";
 	item->number.min = min;
 	item->number.max = max;
 	item->number.step = step;
@@ -1069,27 +1967,42 @@ void indigo_init_number_item(indigo_item *item, const char *name, const char *la
 void indigo_init_switch_item(indigo_item *item, const char *name, const char *label, bool value) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *previous_label = item->label, *previous_hints = item->hints;
+	label = indigo_intern_string(label);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = label;
+	item->hints = "";
+	indigo_release_string(previous_label);
+	indigo_release_string(previous_hints);
 	item->sw.value = value;
 }
 
 void indigo_init_light_item(indigo_item *item, const char *name, const char *label, indigo_property_state value) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *previous_label = item->label, *previous_hints = item->hints;
+	label = indigo_intern_string(label);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = label;
+	item->hints = "";
+	indigo_release_string(previous_label);
+	indigo_release_string(previous_hints);
 	item->light.value = value;
 }
 
 void indigo_init_blob_item(indigo_item *item, const char *name, const char *label) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *previous_label = item->label, *previous_hints = item->hints;
+	label = indigo_intern_string(label);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = label;
+	item->hints = "";
+	indigo_release_string(previous_label);
+	indigo_release_string(previous_hints);
 }
 
 void *indigo_alloc_blob_buffer(long size) {
@@ -1101,131 +2014,328 @@ void *indigo_alloc_blob_buffer(long size) {
 	return indigo_safe_malloc(size);
 }
 
-bool indigo_populate_http_blob_item(indigo_item *blob_item) {
-	char *host = indigo_safe_malloc(BUFFER_SIZE);
-	int port = 80;
-	char *file = indigo_safe_malloc(BUFFER_SIZE);
-	char *request = indigo_safe_malloc(BUFFER_SIZE);
-	char *http_line = indigo_safe_malloc(BUFFER_SIZE);
-	char *http_response = indigo_safe_malloc(BUFFER_SIZE);
-	long content_len = 0;
-	long uncompressed_content_len = 0;
-	int http_result = 0;
-	char *image_type;
-	int socket = -1;
-	int res = false;
+// idle keep-alive connections to remote servers, BLOBs are fetched over them instead of opening new connection for every frame
 
-	if ((blob_item->blob.url[0] == '\0') || strcmp(blob_item->name, CCD_IMAGE_ITEM_NAME)) {
-		indigo_error("%s: url == \"\" or item != \"%s\"", __FUNCTION__, CCD_IMAGE_ITEM_NAME);
-		goto clean_return;
-	}
+#define HTTP_POOL_SIZE				8
+#define HTTP_IDLE_TIMEOUT			30
+#define HTTP_READ_SIZE				(128 * 1024)
 
-	sscanf(blob_item->blob.url, "http://%255[^:]:%5d/%256[^\n]", host, &port, file);
-	socket = indigo_open_tcp(host, port);
-	if (socket < 0)
-		goto clean_return;
+typedef struct {
+	char host[INDIGO_NAME_SIZE];
+	int port;
+	int socket;
+	time_t last_used;
+} http_connection;
 
-	INDIGO_TRACE(indigo_trace("%d <- // open for '%s:%d'", socket, host, port));
+static http_connection http_pool[HTTP_POOL_SIZE];
+static int http_pool_count = 0;
+static pthread_mutex_t http_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+static void close_http_socket(int socket) {
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-	snprintf(request, BUFFER_SIZE, "GET /%s HTTP/1.1\r\nAccept-Encoding: gzip\r\n\r\n", file);
-#else
-	snprintf(request, BUFFER_SIZE, "GET /%s HTTP/1.1\r\n\r\n", file);
+	shutdown(socket, SHUT_RDWR);
+	close(socket);
 #endif
-	INDIGO_TRACE(indigo_trace("%d <- %s", socket, request));
-	res = indigo_write(socket, request, strlen(request));
-	if (res == false)
-		goto clean_return;
+#if defined(INDIGO_WINDOWS)
+	shutdown(socket, SD_BOTH);
+	closesocket(socket);
+#endif
+}
 
-	res = indigo_read_line(socket, http_line, BUFFER_SIZE);
+static int acquire_http_connection(const char *host, int port, bool *reused) {
+	int socket = -1;
+	time_t now = time(NULL);
+	pthread_mutex_lock(&http_pool_mutex);
+	for (int i = http_pool_count - 1; i >= 0; i--) {
+		http_connection *connection = http_pool + i;
+		if (connection->port != port || strcmp(connection->host, host))
+			continue;
+		int candidate = connection->socket;
+		bool expired = now - connection->last_used > HTTP_IDLE_TIMEOUT;
+		http_pool[i] = http_pool[--http_pool_count];
+		// idle connection shouldn't be readable, if it is, server closed it or sent something unexpected
+		if (expired || indigo_select(candidate, 0) != 0) {
+			INDIGO_TRACE(indigo_trace("%d <- // close idle for '%s:%d'", candidate, host, port));
+			close_http_socket(candidate);
+			continue;
+		}
+		socket = candidate;
+		break;
+	}
+	pthread_mutex_unlock(&http_pool_mutex);
+	*reused = socket >= 0;
+	if (socket >= 0) {
+		INDIGO_TRACE(indigo_trace("%d <- // reuse for '%s:%d'", socket, host, port));
+		return socket;
+	}
+	socket = indigo_open_tcp(host, port);
+	if (socket >= 0) {
+		INDIGO_TRACE(indigo_trace("%d <- // open for '%s:%d'", socket, host, port));
+		/* On Raspberry Pi blob compression may take longer. Make sure we do not timeout prematurely */
+		struct timeval timeout;
+		timeout.tv_sec = 15;
+		timeout.tv_usec = 0;
+		setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout));
+	}
+	return socket;
+}
+
+static void release_http_connection(const char *host, int port, int socket) {
+	pthread_mutex_lock(&http_pool_mutex);
+	if (http_pool_count == HTTP_POOL_SIZE) {
+		int oldest = 0;
+		for (int i = 1; i < http_pool_count; i++)
+			if (http_pool[i].last_used < http_pool[oldest].last_used)
+				oldest = i;
+		close_http_socket(http_pool[oldest].socket);
+		http_pool[oldest] = http_pool[--http_pool_count];
+	}
+	http_connection *connection = http_pool + http_pool_count++;
+	indigo_copy_name(connection->host, host);
+	connection->port = port;
+	connection->socket = socket;
+	connection->last_used = time(NULL);
+	pthread_mutex_unlock(&http_pool_mutex);
+}
+
+void indigo_close_http_connections(const char *host, int port) {
+	pthread_mutex_lock(&http_pool_mutex);
+	for (int i = http_pool_count - 1; i >= 0; i--) {
+		if (http_pool[i].port == port && !strcmp(http_pool[i].host, host)) {
+			close_http_socket(http_pool[i].socket);
+			http_pool[i] = http_pool[--http_pool_count];
+		}
+	}
+	pthread_mutex_unlock(&http_pool_mutex);
+}
 
-	if (res < 0) {
-		res = false;
-		goto clean_return;
+// response body reader, handles both Content-Length and chunked transfer encoding
+
+typedef struct {
+	int socket;
+	bool chunked;
+	bool done;
+	long remaining;
+} http_body;
+
+static long read_http_body(http_body *body, char *buffer, long length) {
+	char line[64];
+	if (body->done)
+		return 0;
+	if (body->remaining == 0) {
+		if (!body->chunked) {
+			body->done = true;
+			return 0;
+		}
+		if (indigo_read_line(body->socket, line, sizeof(line)) < 0)
+			return -1;
+		body->remaining = strtol(line, NULL, 16);
+		if (body->remaining <= 0) {
+			// skip trailer
+			int res;
+			while ((res = indigo_read_line(body->socket, line, sizeof(line))) > 0)
+				;
+			if (res < 0)
+				return -1;
+			body->done = true;
+			return 0;
+		}
 	}
-	INDIGO_TRACE(indigo_trace("%d -> %s", socket, http_line));
+	if (length > body->remaining)
+		length = body->remaining;
+	if (indigo_read(body->socket, buffer, length) <= 0)
+		return -1;
+	body->remaining -= length;
+	if (body->remaining == 0 && body->chunked && indigo_read_line(body->socket, line, sizeof(line)) != 0)
+		return -1;
+	return length;
+}
 
-	int count = sscanf(http_line, "HTTP/1.1 %d %255[^\n]", &http_result, http_response);
-	if ((count != 2) || (http_result != 200)) {
-		goto clean_return;
+static bool read_http_blob(http_body *body, bool use_gzip, long size_hint, indigo_item *blob_item) {
+	long capacity = size_hint > 0 ? size_hint : HTTP_READ_SIZE;
+	long size = 0;
+	blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, capacity);
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	if (use_gzip) {
+		// compressed data are inflated directly to BLOB as they arrive
+		char *buffer = indigo_safe_malloc(HTTP_READ_SIZE);
+		z_stream stream = { 0 };
+		bool res = inflateInit2(&stream, MAX_WBITS + 16) == Z_OK;
+		bool eof = false;
+		int status = Z_OK;
+		while (res && status != Z_STREAM_END) {
+			if (stream.avail_in == 0 && !eof) {
+				long count = read_http_body(body, buffer, HTTP_READ_SIZE);
+				if (count < 0) {
+					res = false;
+					break;
+				}
+				eof = count == 0;
+				stream.next_in = (Bytef *)buffer;
+				stream.avail_in = (uInt)count;
+			}
+			stream.next_out = (Bytef *)blob_item->blob.value + size;
+			stream.avail_out = (uInt)(capacity - size);
+			status = inflate(&stream, Z_NO_FLUSH);
+			size = capacity - stream.avail_out;
+			if (status == Z_BUF_ERROR) {
+				if (stream.avail_out == 0) {
+					capacity *= 2;
+					blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, capacity);
+				} else if (eof) {
+					INDIGO_ERROR(indigo_error("%d -> // truncated gzip stream", body->socket));
+					res = false;
+				}
+			} else if (status != Z_OK && status != Z_STREAM_END) {
+				INDIGO_ERROR(indigo_error("%d -> // inflate failed (%d)", body->socket, status));
+				res = false;
+			}
+		}
+		inflateEnd(&stream);
+		// consume the rest of the body, so the connection can be reused
+		while (res && read_http_body(body, buffer, HTTP_READ_SIZE) > 0)
+			;
+		indigo_safe_free(buffer);
+		blob_item->blob.size = size;
+		return res && body->done;
 	}
-	
-	bool use_gzip = false;
+#endif
+	while (true) {
+		if (size == capacity) {
+			if (!body->chunked && body->remaining == 0)
+				break;
+			capacity *= 2;
+			blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, capacity);
+		}
+		long count = read_http_body(body, blob_item->blob.value + size, capacity - size);
+		if (count < 0)
+			return false;
+		if (count == 0)
+			break;
+		size += count;
+	}
+	blob_item->blob.size = size;
+	INDIGO_TRACE(indigo_trace("%d -> // %ld bytes", body->socket, size));
+	return true;
+}
 
-	/* On Raspberry Pi blob compression may take longer. Make sure we do not timeout prematurely */
-	struct timeval timeout;
-	timeout.tv_sec = 15;
-	timeout.tv_usec = 0;
-	setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout));
+// server may send 16-bit images with even and odd bytes in separate planes, they compress better
 
-	do {
-		res = indigo_read_line(socket, http_line, BUFFER_SIZE);
-		if (res < 0) {
-			res = false;
-			goto clean_return;
-		}
+static void unshuffle_bytes(unsigned char *data, long size) {
+	long half = size / 2;
+	unsigned char *planes = indigo_safe_malloc(2 * half);
+	memcpy(planes, data, 2 * half);
+	for (long i = 0; i < half; i++) {
+		data[2 * i] = planes[i];
+		data[2 * i + 1] = planes[half + i];
+	}
+	indigo_safe_free(planes);
+}
+
+static bool fetch_http_blob(int socket, const char *file, indigo_item *blob_item, bool *keep_alive) {
+	char request[BUFFER_SIZE];
+	char http_line[BUFFER_SIZE];
+	char http_response[BUFFER_SIZE];
+	int http_result = 0;
+	long content_len = -1;
+	long uncompressed_content_len = 0;
+	bool use_gzip = false;
+	bool use_shuffle = false;
+	http_body body = { socket, false, false, 0 };
+	*keep_alive = false;
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	snprintf(request, BUFFER_SIZE, "GET /%s HTTP/1.1\r\nConnection: keep-alive\r\nAccept-Encoding: gzip\r\nX-INDIGO-Accept: chunked, shuffle\r\n\r\n", file);
+#else
+	snprintf(request, BUFFER_SIZE, "GET /%s HTTP/1.1\r\nConnection: keep-alive\r\n\r\n", file);
+#endif
+	INDIGO_TRACE(indigo_trace("%d <- %s", socket, request));
+	if (!indigo_write(socket, request, strlen(request)))
+		return false;
+	if (indigo_read_line(socket, http_line, BUFFER_SIZE) <= 0)
+		return false;
+	INDIGO_TRACE(indigo_trace("%d -> %s", socket, http_line));
+	int minor_version = 0;
+	int count = sscanf(http_line, "HTTP/1.%d %d %255[^\n]", &minor_version, &http_result, http_response);
+	if (count != 3)
+		return false;
+	bool persistent = minor_version > 0;
+	int res;
+	while ((res = indigo_read_line(socket, http_line, BUFFER_SIZE)) > 0) {
 		INDIGO_TRACE(indigo_trace("%d -> %s", socket, http_line));
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
 		if (!strncasecmp(http_line, "Content-Encoding: gzip", 22)) {
 			use_gzip = true;
 			continue;
 		}
+		if (!strncasecmp(http_line, "X-Byte-Shuffle: 2", 17)) {
+			use_shuffle = true;
+			continue;
+		}
 #endif
+		if (!strncasecmp(http_line, "Transfer-Encoding: chunked", 26)) {
+			body.chunked = true;
+			continue;
+		}
+		if (!strncasecmp(http_line, "Connection: close", 17)) {
+			persistent = false;
+			continue;
+		}
+		if (!strncasecmp(http_line, "Connection: keep-alive", 22)) {
+			persistent = true;
+			continue;
+		}
 		if (sscanf(http_line, "Content-Length: %20ld[^\n]", &content_len) == 1)
 			continue;
 		if (sscanf(http_line, "X-Uncompressed-Content-Length: %20ld[^\n]", &uncompressed_content_len) == 1)
 			continue;
-	} while (http_line[0] != '\0');
+	}
+	if (res < 0 || http_result != 200)
+		return false;
+	if (!body.chunked) {
+		// without length, body is terminated by closing connection, it is not supported
+		if (content_len <= 0)
+			return false;
+		body.remaining = content_len;
+	}
+	const char *image_type = strrchr(file, '.');
+	if (image_type)
+		indigo_copy_name(blob_item->blob.format, image_type);
+	if (!read_http_blob(&body, use_gzip, use_gzip ? uncompressed_content_len : content_len, blob_item))
+		return false;
+	if (use_shuffle)
+		unshuffle_bytes(blob_item->blob.value, blob_item->blob.size);
+	*keep_alive = persistent;
+	return true;
+}
 
-	if (content_len) {
-		image_type = strrchr(file, '.');
-		if (image_type)
-			indigo_copy_name(blob_item->blob.format, image_type);
-#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-		if (use_gzip) {
-			blob_item->blob.size = uncompressed_content_len;
-			blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, blob_item->blob.size);
-			char *compressed_buffer = indigo_safe_malloc(content_len);
-			res = (indigo_read(socket, compressed_buffer, content_len) >= 0) ? true : false;
-			if (res) {
-				unsigned out_size = (unsigned)uncompressed_content_len;
-				indigo_decompress(compressed_buffer, (unsigned)content_len, blob_item->blob.value, &out_size);
-			}
-			free(compressed_buffer);
+bool indigo_populate_http_blob_item(indigo_item *blob_item) {
+	char host[BUFFER_SIZE];
+	char file[BUFFER_SIZE];
+	int port = 80;
+	if ((blob_item->blob.url[0] == '\0') || strcmp(blob_item->name, CCD_IMAGE_ITEM_NAME)) {
+		indigo_error("%s: url == \"\" or item != \"%s\"", __FUNCTION__, CCD_IMAGE_ITEM_NAME);
+		return false;
+	}
+	sscanf(blob_item->blob.url, "http://%255[^:]:%5d/%256[^\n]", host, &port, file);
+	bool reused = false;
+	bool keep_alive = false;
+	bool res = false;
+	// pooled connection may be closed by the server meanwhile, in such case request is repeated over a new one
+	for (int attempt = 0; attempt < 2 && !res; attempt++) {
+		int socket = acquire_http_connection(host, port, &reused);
+		if (socket < 0)
+			break;
+		res = fetch_http_blob(socket, file, blob_item, &keep_alive);
+		if (res && keep_alive) {
+			release_http_connection(host, port, socket);
 		} else {
-			blob_item->blob.size = content_len;
-			blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, blob_item->blob.size);
-			INDIGO_TRACE(indigo_trace("%d -> // %d bytes", socket, blob_item->blob.size));
-			res = (indigo_read(socket, blob_item->blob.value, blob_item->blob.size) >= 0) ? true : false;
+			if (!res)
+				INDIGO_TRACE(indigo_trace("%d -> // %s", socket, strerror(errno)));
+			close_http_socket(socket);
 		}
-#else
-		blob_item->blob.size = content_len;
-		blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, blob_item->blob.size);
-		INDIGO_TRACE(indigo_trace("%d -> // %d bytes", socket, blob_item->blob.size));
-		res = (indigo_read(socket, blob_item->blob.value, blob_item->blob.size) >= 0) ? true : false;
-#endif
-	} else {
-		res = false;
-	}
-
-clean_return:
-	if (!res || socket < 0)
-		INDIGO_TRACE(indigo_trace("%d -> // %s", socket, strerror(errno)));
-	if (socket >= 0) {
-#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-		shutdown(socket, SHUT_RDWR);
-		close(socket);
-#endif
-#if defined(INDIGO_WINDOWS)
-		shutdown(socket, SD_BOTH);
-		closesocket(socket);
-#endif
+		if (!reused)
+			break;
 	}
-	indigo_safe_free(host);
-	indigo_safe_free(file);
-	indigo_safe_free(request);
-	indigo_safe_free(http_line);
-	indigo_safe_free(http_response);
 	return res;
 }
 
@@ -1321,14 +2431,14 @@ clean_return:
 	return res;
 }
 
-static bool indigo_get_hint(char *hints, const char *key, char *value) {
+static bool indigo_get_hint(const char *hints, const char *key, char *value) {
 	bool is_key = true;
 	bool kv_more = true;
 	bool kv_end = false;
 	bool is_quoted = false;
 
 	int i = 0;
-	char *c = hints;
+	const char *c = hints;
 	char ckey[INDIGO_NAME_SIZE];
 	char cval[INDIGO_VALUE_SIZE];
 
@@ -1742,7 +2852,7 @@ int indigo_query_slave_devices(indigo_device *master, indigo_device **slaves, in
 	if (indigo_use_strict_locking)
 		pthread_mutex_lock(&device_mutex);
 	int count = 0;
-	for (int i = 0; i < MAX_DEVICES; i++) {
+	for (int i = 0; i < device_slots_used; i++) {
 		indigo_device *device = devices[i];
 		if (device && device != master && device->master_device == master) {
 			slaves[count] = device;
@@ -2019,24 +3129,21 @@ double indigo_pixel_scale(double focal_length_cm, double pixel_size_um) {
 
 bool indigo_device_name_exists(const char *name) {
 	pthread_mutex_lock(&device_mutex);
-	for(int slot = 0; slot < MAX_DEVICES; slot++) {
-		indigo_device *device = devices[slot];
-		if (device == NULL)
-			continue;
-		if (!strncmp(device->name, name, INDIGO_NAME_SIZE)) {
-			pthread_mutex_unlock(&device_mutex);
-			return true;
-		}
+	bool exists = find_route(name) != NULL;
+	for (int i = 0; !exists && i < proxy_slots_used; i++) {
+		indigo_device *device = proxy_devices[i];
+		if (device != NULL && !strncmp(device->name, name, INDIGO_NAME_SIZE))
+			exists = true;
 	}
 	pthread_mutex_unlock(&device_mutex);
-	return false;
+	return exists;
 }
 
 bool indigo_make_name_unique(char *name, const char *format, ...) {
 	bool used_suffix[MAX_DEVICES - 1] = { false };
 	bool is_duplicate = false;
 	pthread_mutex_lock(&device_mutex);
-	for(int slot = 0; slot < MAX_DEVICES; slot++) {
+	for(int slot = 0; slot < device_slots_used; slot++) {
 		indigo_device *device = devices[slot];
 		if (device == NULL)
 			continue;
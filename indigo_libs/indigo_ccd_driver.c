@@ -81,6 +81,8 @@ static double get_time_hd() {
 	return (double)(now.tv_sec) + now.tv_usec/1e6;
 }
 
+static void stop_image_pipeline(indigo_device *device);
+
 static void countdown_timer_callback(indigo_device *device) {
 	const double step = 0.25;
 	double now;
@@ -197,14 +199,14 @@ indigo_result indigo_ccd_attach(indigo_device *device, const char* driver_name,
 			if (CCD_EXPOSURE_PROPERTY == NULL)
 				return INDIGO_FAILED;
 			indigo_init_number_item(CCD_EXPOSURE_ITEM, CCD_EXPOSURE_ITEM_NAME, "Start exposure", 0, 10000, 1, 0);
-			strcpy(CCD_EXPOSURE_ITEM->number.format, "%g");
+			indigo_set_number_format(CCD_EXPOSURE_ITEM, "%g");
 			// -------------------------------------------------------------------------------- CCD_STREAMING
 			CCD_STREAMING_PROPERTY = indigo_init_number_property(NULL, device->name, CCD_STREAMING_PROPERTY_NAME, CCD_MAIN_GROUP, "Start streaming", INDIGO_OK_STATE, INDIGO_RW_PERM, 2);
 			if (CCD_STREAMING_PROPERTY == NULL)
 				return INDIGO_FAILED;
 			indigo_init_number_item(CCD_STREAMING_EXPOSURE_ITEM, CCD_STREAMING_EXPOSURE_ITEM_NAME, "Shutter time", 0, 10000, 1, 0);
 			indigo_init_number_item(CCD_STREAMING_COUNT_ITEM, CCD_STREAMING_COUNT_ITEM_NAME, "Frame count", -1, 100000, 1, -1);
-			strcpy(CCD_EXPOSURE_ITEM->number.format, "%g");
+			indigo_set_number_format(CCD_EXPOSURE_ITEM, "%g");
 			CCD_STREAMING_PROPERTY->hidden = true;
 			// -------------------------------------------------------------------------------- CCD_ABORT_EXPOSURE
 			CCD_ABORT_EXPOSURE_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_ABORT_EXPOSURE_PROPERTY_NAME, CCD_MAIN_GROUP, "Abort exposure", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_AT_MOST_ONE_RULE, 1);
@@ -356,6 +358,34 @@ indigo_result indigo_ccd_attach(indigo_device *device, const char* driver_name,
 			CCD_RBI_FLUSH_PROPERTY->hidden = true;
 			indigo_init_number_item(CCD_RBI_FLUSH_EXPOSURE_ITEM, CCD_RBI_FLUSH_EXPOSURE_ITEM_NAME, "NIR flood time (s)", 0, 16, 0, 1);
 			indigo_init_number_item(CCD_RBI_FLUSH_COUNT_ITEM, CCD_RBI_FLUSH_COUNT_ITEM_NAME, "Number of flushes", 1, 10, 1, 3);
+			// -------------------------------------------------------------------------------- CCD_IMAGE_PIPELINE
+			CCD_IMAGE_PIPELINE_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_IMAGE_PIPELINE_PROPERTY_NAME, CCD_ADVANCED_GROUP, "Asynchronous image processing", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 2);
+			if (CCD_IMAGE_PIPELINE_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_switch_item(CCD_IMAGE_PIPELINE_ENABLED_ITEM, CCD_IMAGE_PIPELINE_ENABLED_ITEM_NAME, "Enabled", false);
+			indigo_init_switch_item(CCD_IMAGE_PIPELINE_DISABLED_ITEM, CCD_IMAGE_PIPELINE_DISABLED_ITEM_NAME, "Disabled", true);
+			// -------------------------------------------------------------------------------- CCD_IMAGE_COMPRESSION
+			CCD_IMAGE_COMPRESSION_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_IMAGE_COMPRESSION_PROPERTY_NAME, CCD_IMAGE_GROUP, "FITS/XISF compression", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 3);
+			if (CCD_IMAGE_COMPRESSION_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_switch_item(CCD_IMAGE_COMPRESSION_NONE_ITEM, CCD_IMAGE_COMPRESSION_NONE_ITEM_NAME, "None", true);
+			indigo_init_switch_item(CCD_IMAGE_COMPRESSION_RICE_ITEM, CCD_IMAGE_COMPRESSION_RICE_ITEM_NAME, "Rice (FITS), zlib (XISF)", false);
+			indigo_init_switch_item(CCD_IMAGE_COMPRESSION_GZIP_ITEM, CCD_IMAGE_COMPRESSION_GZIP_ITEM_NAME, "GZIP (FITS), zlib (XISF)", false);
+			// -------------------------------------------------------------------------------- CCD_PREVIEW_TIMING
+			CCD_PREVIEW_TIMING_PROPERTY = indigo_init_number_property(NULL, device->name, CCD_PREVIEW_TIMING_PROPERTY_NAME, CCD_ADVANCED_GROUP, "Preview conversion timing", INDIGO_OK_STATE, INDIGO_RO_PERM, 4);
+			if (CCD_PREVIEW_TIMING_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			CCD_PREVIEW_TIMING_PROPERTY->hidden = indigo_get_log_level() < INDIGO_LOG_DEBUG;
+			indigo_init_number_item(CCD_PREVIEW_TIMING_ESTIMATION_ITEM, CCD_PREVIEW_TIMING_ESTIMATION_ITEM_NAME, "Stretch estimation (ms)", 0, 100000, 0, 0);
+			indigo_init_number_item(CCD_PREVIEW_TIMING_CONVERSION_ITEM, CCD_PREVIEW_TIMING_CONVERSION_ITEM_NAME, "Debayer and stretch (ms)", 0, 100000, 0, 0);
+			indigo_init_number_item(CCD_PREVIEW_TIMING_COMPRESSION_ITEM, CCD_PREVIEW_TIMING_COMPRESSION_ITEM_NAME, "JPEG compression (ms)", 0, 100000, 0, 0);
+			indigo_init_number_item(CCD_PREVIEW_TIMING_TOTAL_ITEM, CCD_PREVIEW_TIMING_TOTAL_ITEM_NAME, "Total (ms)", 0, 100000, 0, 0);
+			// -------------------------------------------------------------------------------- CCD_STREAMING_STATS
+			CCD_STREAMING_STATS_PROPERTY = indigo_init_number_property(NULL, device->name, CCD_STREAMING_STATS_PROPERTY_NAME, CCD_ADVANCED_GROUP, "Video file statistics", INDIGO_OK_STATE, INDIGO_RO_PERM, 2);
+			if (CCD_STREAMING_STATS_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_number_item(CCD_STREAMING_STATS_SAVED_ITEM, CCD_STREAMING_STATS_SAVED_ITEM_NAME, "Frames saved", 0, 0x7FFFFFFF, 0, 0);
+			indigo_init_number_item(CCD_STREAMING_STATS_DROPPED_ITEM, CCD_STREAMING_STATS_DROPPED_ITEM_NAME, "Frames dropped", 0, 0x7FFFFFFF, 0, 0);
 			// --------------------------------------------------------------------------------
 			CCD_CONTEXT->countdown_canceled = false;
 			CCD_CONTEXT->countdown_enabled = false;
@@ -435,6 +465,14 @@ indigo_result indigo_ccd_enumerate_properties(indigo_device *device, indigo_clie
 			indigo_define_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
 		if (indigo_property_match(CCD_RBI_FLUSH_PROPERTY, property))
 			indigo_define_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
+		if (indigo_property_match(CCD_IMAGE_PIPELINE_PROPERTY, property))
+			indigo_define_property(device, CCD_IMAGE_PIPELINE_PROPERTY, NULL);
+		if (indigo_property_match(CCD_PREVIEW_TIMING_PROPERTY, property))
+			indigo_define_property(device, CCD_PREVIEW_TIMING_PROPERTY, NULL);
+		if (indigo_property_match(CCD_STREAMING_STATS_PROPERTY, property))
+			indigo_define_property(device, CCD_STREAMING_STATS_PROPERTY, NULL);
+		if (indigo_property_match(CCD_IMAGE_COMPRESSION_PROPERTY, property))
+			indigo_define_property(device, CCD_IMAGE_COMPRESSION_PROPERTY, NULL);
 	}
 	return indigo_device_enumerate_properties(device, client, property);
 }
@@ -526,6 +564,10 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 			indigo_define_property(device, CCD_JPEG_STRETCH_PRESETS_PROPERTY, NULL);
 			indigo_define_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
 			indigo_define_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
+			indigo_define_property(device, CCD_IMAGE_PIPELINE_PROPERTY, NULL);
+			indigo_define_property(device, CCD_PREVIEW_TIMING_PROPERTY, NULL);
+			indigo_define_property(device, CCD_STREAMING_STATS_PROPERTY, NULL);
+			indigo_define_property(device, CCD_IMAGE_COMPRESSION_PROPERTY, NULL);
 			CCD_CONTEXT->countdown_enabled = true;
 			CCD_CONTEXT->countdown_endtime = 0;
 		} else {
@@ -570,6 +612,10 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 			indigo_delete_property(device, CCD_JPEG_STRETCH_PRESETS_PROPERTY, NULL);
 			indigo_delete_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
 			indigo_delete_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
+			indigo_delete_property(device, CCD_IMAGE_PIPELINE_PROPERTY, NULL);
+			indigo_delete_property(device, CCD_PREVIEW_TIMING_PROPERTY, NULL);
+			indigo_delete_property(device, CCD_STREAMING_STATS_PROPERTY, NULL);
+			indigo_delete_property(device, CCD_IMAGE_COMPRESSION_PROPERTY, NULL);
 		}
 	} else if (indigo_property_match_changeable(CONFIG_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- CONFIG
@@ -600,6 +646,8 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 			indigo_save_property(device, NULL, CCD_JPEG_STRETCH_PRESETS_PROPERTY);
 			indigo_save_property(device, NULL, CCD_RBI_FLUSH_ENABLE_PROPERTY);
 			indigo_save_property(device, NULL, CCD_RBI_FLUSH_PROPERTY);
+			indigo_save_property(device, NULL, CCD_IMAGE_PIPELINE_PROPERTY);
+			indigo_save_property(device, NULL, CCD_IMAGE_COMPRESSION_PROPERTY);
 		}
 	} else if (indigo_property_match_changeable(CCD_LENS_PROPERTY, property)) {
 		indigo_property_copy_values(CCD_LENS_PROPERTY, property, false);
@@ -816,8 +864,7 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 			indigo_item *item = CCD_FITS_HEADERS_PROPERTY->items + i;
 			if (!strcmp(item->name, CCD_REMOVE_FITS_HEADER_NAME_ITEM->text.value)) {
 				indigo_delete_property(device, CCD_FITS_HEADERS_PROPERTY, NULL);
-				memmove(item, item + 1, (CCD_FITS_HEADERS_PROPERTY->count - i - 1) * sizeof(indigo_item));
-				CCD_FITS_HEADERS_PROPERTY->count--;
+				indigo_remove_item(CCD_FITS_HEADERS_PROPERTY, i);
 				indigo_define_property(device, CCD_FITS_HEADERS_PROPERTY, NULL);
 				CCD_REMOVE_FITS_HEADER_PROPERTY->state = INDIGO_OK_STATE;
 				break;
@@ -910,6 +957,19 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 		CCD_RBI_FLUSH_PROPERTY->state = INDIGO_OK_STATE;
 		indigo_update_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
 		return INDIGO_OK;
+		// -------------------------------------------------------------------------------- CCD_IMAGE_PIPELINE
+	} else if (indigo_property_match_changeable(CCD_IMAGE_PIPELINE_PROPERTY, property)) {
+		// pipeline is started or stopped with the next frame, it is used by the driver readout thread only
+		indigo_property_copy_values(CCD_IMAGE_PIPELINE_PROPERTY, property, false);
+		CCD_IMAGE_PIPELINE_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_IMAGE_PIPELINE_PROPERTY, NULL);
+		return INDIGO_OK;
+		// -------------------------------------------------------------------------------- CCD_IMAGE_COMPRESSION
+	} else if (indigo_property_match_changeable(CCD_IMAGE_COMPRESSION_PROPERTY, property)) {
+		indigo_property_copy_values(CCD_IMAGE_COMPRESSION_PROPERTY, property, false);
+		CCD_IMAGE_COMPRESSION_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_IMAGE_COMPRESSION_PROPERTY, NULL);
+		return INDIGO_OK;
 		// --------------------------------------------------------------------------------
 	}
 	return indigo_device_change_property(device, client, property);
@@ -919,6 +979,7 @@ indigo_result indigo_ccd_detach(indigo_device *device) {
 	assert(device != NULL);
 	CCD_CONTEXT->countdown_canceled = true;
 	indigo_cancel_timer_sync(device, &CCD_CONTEXT->countdown_timer);
+	stop_image_pipeline(device);
 	indigo_release_property(CCD_INFO_PROPERTY);
 	indigo_release_property(CCD_LENS_PROPERTY);
 	indigo_release_property(CCD_UPLOAD_MODE_PROPERTY);
@@ -951,18 +1012,39 @@ indigo_result indigo_ccd_detach(indigo_device *device) {
 	indigo_release_property(CCD_JPEG_STRETCH_PRESETS_PROPERTY);
 	indigo_release_property(CCD_RBI_FLUSH_ENABLE_PROPERTY);
 	indigo_release_property(CCD_RBI_FLUSH_PROPERTY);
+	indigo_release_property(CCD_IMAGE_PIPELINE_PROPERTY);
+	indigo_release_property(CCD_PREVIEW_TIMING_PROPERTY);
+	indigo_release_property(CCD_STREAMING_STATS_PROPERTY);
+	indigo_release_property(CCD_IMAGE_COMPRESSION_PROPERTY);
 	if (CCD_CONTEXT->preview_image)
 		free(CCD_CONTEXT->preview_image);
+	indigo_safe_free(CCD_CONTEXT->conversion_buffer);
+	indigo_safe_free(CCD_CONTEXT->compression_buffer);
+	indigo_safe_free(CCD_CONTEXT->preview_buffer);
+	indigo_dslr_raw_release_context(CCD_CONTEXT->dslr_raw_context);
+	indigo_safe_free(CCD_CONTEXT->dslr_raw_image);
 	return indigo_device_detach(device);
 }
 
 #define STRECH_SAMPLE_SIZE	0x1FF
 
-void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, int frame_height, int bpp, const char *bayerpat, void **data_out, unsigned long *size_out, void **histogram_data, unsigned long *histogram_size, double B, double C) {
-	INDIGO_DEBUG(clock_t start = clock());
+static double preview_time(void) {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+static void raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, int frame_height, int bpp, const char *bayerpat, void **data_out, unsigned long *size_out, void **histogram_data, unsigned long *histogram_size, double B, double C, int quality) {
+	double start = preview_time();
+	double estimated = start, converted, compressed;
 	size_t size_in = frame_width * frame_height;
 	int sample_by = frame_width < STRECH_SAMPLE_SIZE ? 1 : frame_width / STRECH_SAMPLE_SIZE;
-	void *copy = indigo_safe_malloc(3 * size_in * bpp / 8);
+	// converted image has at most 3 bytes per pixel, buffer is reused for the next frames
+	if (CCD_CONTEXT->preview_buffer_size < 3 * size_in) {
+		indigo_safe_free(CCD_CONTEXT->preview_buffer);
+		CCD_CONTEXT->preview_buffer = indigo_safe_malloc(CCD_CONTEXT->preview_buffer_size = 3 * size_in);
+	}
+	void *copy = CCD_CONTEXT->preview_buffer;
 	unsigned char *mem = NULL;
 	unsigned long mem_size = 0;
 	unsigned long *histo[3] = { NULL, NULL, NULL }, totals[3] = { 0, 0, 0 };
@@ -975,7 +1057,6 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 	/* Jump here in case of a decmpression error */
 	if (setjmp(cinfo.jpeg_error)) {
 		jpeg_destroy_compress(&cinfo.pub);
-		indigo_safe_free(copy);
 		indigo_safe_free(histo[0]);
 		indigo_safe_free(histo[1]);
 		indigo_safe_free(histo[2]);
@@ -992,6 +1073,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 			if (!strcmp(bayerpat, "RGGB")) {
 				if (B != 0 && C != 0) {
 					indigo_compute_stretch_params_8_rggb((uint8_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+					estimated = preview_time();
 					indigo_stretch_8_rggb((uint8_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 				} else {
 					indigo_debayer_8_rggb((uint8_t *)(data_in), frame_width, frame_height, copy);
@@ -999,6 +1081,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 			} else if (!strcmp(bayerpat, "GBRG")) {
 				if (B != 0 && C != 0) {
 					indigo_compute_stretch_params_8_gbrg((uint8_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+					estimated = preview_time();
 					indigo_stretch_8_gbrg((uint8_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 				} else {
 					indigo_debayer_8_gbrg((uint8_t *)(data_in), frame_width, frame_height, copy);
@@ -1006,6 +1089,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 			} else if (!strcmp(bayerpat, "GRBG")) {
 				if (B != 0 && C != 0) {
 					indigo_compute_stretch_params_8_grbg((uint8_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+					estimated = preview_time();
 					indigo_stretch_8_grbg((uint8_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 				} else {
 					indigo_debayer_8_grbg((uint8_t *)(data_in), frame_width, frame_height, copy);
@@ -1013,6 +1097,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 			} else if (!strcmp(bayerpat, "BGGR")) {
 				if (B != 0 && C != 0) {
 					indigo_compute_stretch_params_8_bggr((uint8_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+					estimated = preview_time();
 					indigo_stretch_8_bggr((uint8_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 				} else {
 					indigo_debayer_8_bggr((uint8_t *)(data_in), frame_width, frame_height, copy);
@@ -1023,6 +1108,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 		} else {
 			if (B != 0 && C != 0) {
 				indigo_compute_stretch_params_8((uint8_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, B, C);
+				estimated = preview_time();
 				indigo_stretch_8((uint8_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights);
 			} else {
 				memcpy(copy, (uint8_t *)(data_in), size_in);
@@ -1033,44 +1119,52 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 		if (bayerpat) {
 			if (!strcmp(bayerpat, "RGGB")) {
 				indigo_compute_stretch_params_16_rggb((uint16_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+				estimated = preview_time();
 				indigo_stretch_16_rggb((uint16_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 			} else if (!strcmp(bayerpat, "GBRG")) {
 				indigo_compute_stretch_params_16_gbrg((uint16_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+				estimated = preview_time();
 				indigo_stretch_16_gbrg((uint16_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 			} else if (!strcmp(bayerpat, "GRBG")) {
 				indigo_compute_stretch_params_16_grbg((uint16_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+				estimated = preview_time();
 				indigo_stretch_16_grbg((uint16_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 			} else if (!strcmp(bayerpat, "BGGR")) {
 				indigo_compute_stretch_params_16_bggr((uint16_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+				estimated = preview_time();
 				indigo_stretch_16_bggr((uint16_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 			} else {
 				assert(false);
 			}
 		} else {
 			indigo_compute_stretch_params_16((uint16_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, B, C);
+			estimated = preview_time();
 			indigo_stretch_16((uint16_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights);
 			cinfo.pub.input_components = 1;
 		}
 	} else if (bpp == 24) {
 		if (B != 0 && C != 0) {
 			indigo_compute_stretch_params_24((uint8_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+			estimated = preview_time();
 			indigo_stretch_24((uint8_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 		} else {
 			memcpy(copy, data_in, 3 * frame_width * frame_height);
 		}
 	} else if (bpp == 48) {
 		indigo_compute_stretch_params_48((uint16_t *)(data_in), frame_width, frame_height, sample_by, shadows, midtones, highlights, histo, totals, B, C);
+		estimated = preview_time();
 		indigo_stretch_48((uint16_t *)(data_in), frame_width, frame_height, copy, shadows, midtones, highlights, totals);
 	} else {
 		assert(false);
 	}
+	converted = preview_time();
 	if (cinfo.pub.input_components == 1) {
 		cinfo.pub.in_color_space = JCS_GRAYSCALE;
 	} else {
 		cinfo.pub.in_color_space = JCS_RGB;
 	}
 	jpeg_set_defaults(&cinfo.pub);
-	jpeg_set_quality(&cinfo.pub, CCD_JPEG_SETTINGS_QUALITY_ITEM->number.target, true);
+	jpeg_set_quality(&cinfo.pub, quality, true);
 	JSAMPROW row_pointer[1];
 	jpeg_start_compress(&cinfo.pub, TRUE);
 	while (cinfo.pub.next_scanline < cinfo.pub.image_height) {
@@ -1081,7 +1175,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 	jpeg_destroy_compress(&cinfo.pub);
 	*data_out = mem;
 	*size_out = mem_size;
-	indigo_safe_free(copy);
+	compressed = preview_time();
 	if (histogram_data != NULL) {
 		uint8_t raw[128 * 256 * 3];
 		memset(raw, 0, sizeof(raw));
@@ -1150,7 +1244,103 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 	indigo_safe_free(histo[0]);
 	indigo_safe_free(histo[1]);
 	indigo_safe_free(histo[2]);
-	INDIGO_DEBUG(indigo_debug("RAW to preview conversion in %gs", (clock() - start) / (double)CLOCKS_PER_SEC));
+	double finished = preview_time();
+	if (!CCD_PREVIEW_TIMING_PROPERTY->hidden) {
+		CCD_PREVIEW_TIMING_ESTIMATION_ITEM->number.value = (estimated - start) * 1000;
+		CCD_PREVIEW_TIMING_CONVERSION_ITEM->number.value = (converted - estimated) * 1000;
+		CCD_PREVIEW_TIMING_COMPRESSION_ITEM->number.value = (compressed - converted) * 1000;
+		CCD_PREVIEW_TIMING_TOTAL_ITEM->number.value = (finished - start) * 1000;
+		indigo_update_property(device, CCD_PREVIEW_TIMING_PROPERTY, NULL);
+	}
+	INDIGO_DEBUG(indigo_debug("RAW to preview conversion in %gs (estimation %gs, conversion %gs, compression %gs)", finished - start, estimated - start, converted - estimated, compressed - converted));
+}
+
+void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, int frame_height, int bpp, const char *bayerpat, void **data_out, unsigned long *size_out, void **histogram_data, unsigned long *histogram_size, double B, double C) {
+	raw_to_jpeg(device, data_in, frame_width, frame_height, bpp, bayerpat, data_out, size_out, histogram_data, histogram_size, B, C, CCD_JPEG_SETTINGS_QUALITY_ITEM->number.target);
+}
+
+// Settings used by image processing are captured when the frame is handed over, so frames waiting in the image pipeline
+// are processed with the settings of their exposure.
+
+typedef struct {
+	bool streaming_exposure;
+	double exposure_time;
+	double streaming_exposure_time;
+	int horizontal_bin;
+	int vertical_bin;
+	double pixel_width;
+	double pixel_height;
+	bool light_frame, bias_frame, dark_frame, flat_frame, darkflat_frame;
+	char frame_type_label[INDIGO_VALUE_SIZE];
+	bool has_temperature;
+	double temperature;
+	double target_temperature;
+	bool has_gain, has_egain, has_offset, has_gamma, has_lens;
+	double gain, egain, offset, gamma;
+	double lens_aperture, lens_focal_length;
+	bool fits_format, xisf_format, raw_format, jpeg_format, tiff_format, jpeg_avi_format, raw_ser_format;
+	bool compression, rice_compression;
+	bool save_local, upload_client;
+	bool preview, preview_histogram;
+	int jpeg_quality;
+	double jpeg_background;
+	double jpeg_clipping_point;
+	char local_dir[INDIGO_VALUE_SIZE];
+	char local_prefix[INDIGO_VALUE_SIZE];
+	indigo_property *fits_headers;
+} image_settings;
+
+static void capture_image_settings(indigo_device *device, image_settings *settings, indigo_property *fits_headers) {
+	settings->streaming_exposure = CCD_STREAMING_PROPERTY->state == INDIGO_BUSY_STATE;
+	settings->exposure_time = CCD_EXPOSURE_ITEM->number.target;
+	settings->streaming_exposure_time = CCD_STREAMING_EXPOSURE_ITEM->number.target;
+	settings->horizontal_bin = CCD_BIN_HORIZONTAL_ITEM->number.value;
+	settings->vertical_bin = CCD_BIN_VERTICAL_ITEM->number.value;
+	settings->pixel_width = CCD_INFO_PIXEL_WIDTH_ITEM->number.value;
+	settings->pixel_height = CCD_INFO_PIXEL_HEIGHT_ITEM->number.value;
+	settings->light_frame = CCD_FRAME_TYPE_LIGHT_ITEM->sw.value;
+	settings->bias_frame = CCD_FRAME_TYPE_BIAS_ITEM->sw.value;
+	settings->dark_frame = CCD_FRAME_TYPE_DARK_ITEM->sw.value;
+	settings->flat_frame = CCD_FRAME_TYPE_FLAT_ITEM->sw.value;
+	settings->darkflat_frame = CCD_FRAME_TYPE_DARKFLAT_ITEM->sw.value;
+	*settings->frame_type_label = 0;
+	for (int i = 0; i < CCD_FRAME_TYPE_PROPERTY->count; i++) {
+		if (CCD_FRAME_TYPE_PROPERTY->items[i].sw.value)
+			strncat(settings->frame_type_label, CCD_FRAME_TYPE_PROPERTY->items[i].label, INDIGO_VALUE_SIZE - strlen(settings->frame_type_label) - 1);
+	}
+	settings->has_temperature = !CCD_TEMPERATURE_PROPERTY->hidden;
+	settings->temperature = CCD_TEMPERATURE_ITEM->number.value;
+	settings->target_temperature = CCD_TEMPERATURE_ITEM->number.target;
+	settings->has_gain = !CCD_GAIN_PROPERTY->hidden;
+	settings->gain = CCD_GAIN_ITEM->number.value;
+	settings->has_egain = !CCD_EGAIN_PROPERTY->hidden;
+	settings->egain = CCD_EGAIN_ITEM->number.value;
+	settings->has_offset = !CCD_OFFSET_PROPERTY->hidden;
+	settings->offset = CCD_OFFSET_ITEM->number.value;
+	settings->has_gamma = !CCD_GAMMA_PROPERTY->hidden;
+	settings->gamma = CCD_GAMMA_ITEM->number.value;
+	settings->has_lens = !CCD_LENS_PROPERTY->hidden;
+	settings->lens_aperture = CCD_LENS_APERTURE_ITEM->number.value;
+	settings->lens_focal_length = CCD_LENS_FOCAL_LENGTH_ITEM->number.value;
+	settings->fits_format = CCD_IMAGE_FORMAT_FITS_ITEM->sw.value;
+	settings->xisf_format = CCD_IMAGE_FORMAT_XISF_ITEM->sw.value;
+	settings->raw_format = CCD_IMAGE_FORMAT_RAW_ITEM->sw.value;
+	settings->jpeg_format = CCD_IMAGE_FORMAT_JPEG_ITEM->sw.value;
+	settings->tiff_format = CCD_IMAGE_FORMAT_TIFF_ITEM->sw.value;
+	settings->jpeg_avi_format = CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value;
+	settings->raw_ser_format = CCD_IMAGE_FORMAT_RAW_SER_ITEM->sw.value;
+	settings->compression = !CCD_IMAGE_COMPRESSION_NONE_ITEM->sw.value;
+	settings->rice_compression = CCD_IMAGE_COMPRESSION_RICE_ITEM->sw.value;
+	settings->save_local = CCD_UPLOAD_MODE_LOCAL_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value;
+	settings->upload_client = CCD_UPLOAD_MODE_CLIENT_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value;
+	settings->preview = CCD_PREVIEW_ENABLED_ITEM->sw.value || CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value;
+	settings->preview_histogram = CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value;
+	settings->jpeg_quality = CCD_JPEG_SETTINGS_QUALITY_ITEM->number.target;
+	settings->jpeg_background = CCD_JPEG_SETTINGS_TARGET_BACKGROUND_ITEM->number.target;
+	settings->jpeg_clipping_point = CCD_JPEG_SETTINGS_CLIPPING_POINT_ITEM->number.target;
+	indigo_copy_value(settings->local_dir, CCD_LOCAL_MODE_DIR_ITEM->text.value);
+	indigo_copy_value(settings->local_prefix, CCD_LOCAL_MODE_PREFIX_ITEM->text.value);
+	settings->fits_headers = fits_headers;
 }
 
 static void add_key(char **header, bool fits, char *format, ...) {
@@ -1159,9 +1349,11 @@ static void add_key(char **header, bool fits, char *format, ...) {
 	va_start(argList, format);
 	int length = vsnprintf(buffer, 80, format, argList);
 	va_end(argList);
+	if (length > 79)
+		length = 79;
 	indigo_fix_locale(buffer);
 	if (fits) {
-		buffer[length] = ' ';
+		memset(buffer + length, ' ', 80 - length);
 		length = 80;
 	} else {
 		buffer[length++] = '\n';
@@ -1170,7 +1362,7 @@ static void add_key(char **header, bool fits, char *format, ...) {
 	*header = buffer + length;
 }
 
-static void raw_to_tiff(indigo_device *device, void *data_in, int frame_width, int frame_height, int bpp, void **data_out, unsigned long *size_out, indigo_fits_keyword *keywords) {
+static void raw_to_tiff(indigo_device *device, image_settings *settings, void *data_in, int frame_width, int frame_height, int bpp, void **data_out, unsigned long *size_out, indigo_fits_keyword *keywords) {
 	indigo_tiff_memory_handle *memory_handle = indigo_safe_malloc(sizeof(indigo_tiff_memory_handle));
 	memory_handle->data = indigo_safe_malloc(memory_handle->size = 10240);
 	memory_handle->file_length = memory_handle->file_offset = 0;
@@ -1180,11 +1372,11 @@ static void raw_to_tiff(indigo_device *device, void *data_in, int frame_width, i
 	struct tm* tm_info;
 	char date_time_end[20];
 	time(&timer);
-	timer -= CCD_EXPOSURE_ITEM->number.target;
+	timer -= settings->exposure_time;
 	tm_info = gmtime(&timer);
 	strftime(date_time_end, 20, "%Y-%m-%dT%H:%M:%S", tm_info);
-	int horizontal_bin = CCD_BIN_HORIZONTAL_ITEM->number.value;
-	int vertical_bin = CCD_BIN_VERTICAL_ITEM->number.value;
+	int horizontal_bin = settings->horizontal_bin;
+	int vertical_bin = settings->vertical_bin;
 	char *fits_header = malloc(FITS_HEADER_SIZE);
 	char *next_key = fits_header;
 	add_key(&next_key, false, "SIMPLE  =                    T / file conforms to FITS standard");
@@ -1207,31 +1399,31 @@ static void raw_to_tiff(indigo_device *device, void *data_in, int frame_width, i
 	}
 	add_key(&next_key, false, "XBINNING= %20d / horizontal binning [pixels]", horizontal_bin);
 	add_key(&next_key, false, "YBINNING= %20d / vertical binning [pixels]", vertical_bin);
-	if (CCD_INFO_PIXEL_WIDTH_ITEM->number.value > 0 && CCD_INFO_PIXEL_HEIGHT_ITEM->number.value) {
-		add_key(&next_key, false, "XPIXSZ  = %20.2f / pixel width [microns]", CCD_INFO_PIXEL_WIDTH_ITEM->number.value * horizontal_bin);
-		add_key(&next_key, false, "YPIXSZ  = %20.2f / pixel height [microns]", CCD_INFO_PIXEL_HEIGHT_ITEM->number.value * vertical_bin);
+	if (settings->pixel_width > 0 && settings->pixel_height) {
+		add_key(&next_key, false, "XPIXSZ  = %20.2f / pixel width [microns]", settings->pixel_width * horizontal_bin);
+		add_key(&next_key, false, "YPIXSZ  = %20.2f / pixel height [microns]", settings->pixel_height * vertical_bin);
 	}
-	add_key(&next_key, false, "EXPTIME = %20.2f / exposure time [s]", CCD_EXPOSURE_ITEM->number.target);
-	if (!CCD_TEMPERATURE_PROPERTY->hidden)
-		add_key(&next_key, false, "CCD-TEMP= %20.2f / CCD temperature [C]", CCD_TEMPERATURE_ITEM->number.value);
-	if (CCD_FRAME_TYPE_LIGHT_ITEM->sw.value)
+	add_key(&next_key, false, "EXPTIME = %20.2f / exposure time [s]", settings->exposure_time);
+	if (settings->has_temperature)
+		add_key(&next_key, false, "CCD-TEMP= %20.2f / CCD temperature [C]", settings->temperature);
+	if (settings->light_frame)
 		add_key(&next_key, false, "IMAGETYP= 'Light'               / frame type");
-	else if (CCD_FRAME_TYPE_FLAT_ITEM->sw.value)
+	else if (settings->flat_frame)
 		add_key(&next_key, false, "IMAGETYP= 'Flat'                / frame type");
-	else if (CCD_FRAME_TYPE_BIAS_ITEM->sw.value)
+	else if (settings->bias_frame)
 		add_key(&next_key, false, "IMAGETYP= 'Bias'                / frame type");
-	else if (CCD_FRAME_TYPE_DARK_ITEM->sw.value)
+	else if (settings->dark_frame)
 		add_key(&next_key, false, "IMAGETYP= 'Dark'                / frame type");
-	else if (CCD_FRAME_TYPE_DARKFLAT_ITEM->sw.value)
+	else if (settings->darkflat_frame)
 		add_key(&next_key, false, "IMAGETYP= 'DarkFlat'            / frame type");
-	if (!CCD_GAIN_PROPERTY->hidden)
-		add_key(&next_key, false, "GAIN    = %20.2f / Sensor gain", CCD_GAIN_ITEM->number.value);
-	if (!CCD_EGAIN_PROPERTY->hidden && CCD_EGAIN_ITEM->number.value > 0)
-		add_key(&next_key, false, "EGAIN   = %20.4f / Electrons per A/D unit [e-/ADU]", CCD_EGAIN_ITEM->number.value);
-	if (!CCD_OFFSET_PROPERTY->hidden)
-		add_key(&next_key, false, "OFFSET  = %20.2f / Offset", CCD_OFFSET_ITEM->number.value);
-	if (!CCD_GAMMA_PROPERTY->hidden)
-		add_key(&next_key, false, "GAMMA   = %20.2f / Gamma", CCD_GAMMA_ITEM->number.value);
+	if (settings->has_gain)
+		add_key(&next_key, false, "GAIN    = %20.2f / Sensor gain", settings->gain);
+	if (settings->has_egain && settings->egain > 0)
+		add_key(&next_key, false, "EGAIN   = %20.4f / Electrons per A/D unit [e-/ADU]", settings->egain);
+	if (settings->has_offset)
+		add_key(&next_key, false, "OFFSET  = %20.2f / Offset", settings->offset);
+	if (settings->has_gamma)
+		add_key(&next_key, false, "GAMMA   = %20.2f / Gamma", settings->gamma);
 	add_key(&next_key, false, "DATE-OBS= '%s' / UTC date that FITS file was created", date_time_end);
 	add_key(&next_key, false, "INSTRUME= '%s'%*c / instrument name", device->name, (int)(19 - strlen(device->name)), ' ');
 	add_key(&next_key, false, "ROWORDER= 'TOP-DOWN'           / Image row order");
@@ -1246,17 +1438,17 @@ static void raw_to_tiff(indigo_device *device, void *data_in, int frame_width, i
 					add_key(&next_key, false, "%-8s= '%s'%*c / %s", keywords->name, keywords->string, (int)(18 - strlen(keywords->string)), ' ', keywords->comment);
 					if (!strcmp(keywords->name, "BAYERPAT")) {
 						if (!strcmp(keywords->string, "RGGB")) {
-							add_key(&next_key, true, "%-8s= %20d / %s", "XBAYROFF", 0, "X offset of Bayer array");
-							add_key(&next_key, true, "%-8s= %20d / %s", "YBAYROFF", 0, "Y offset of Bayer array");
+							add_key(&next_key, false, "%-8s= %20d / %s", "XBAYROFF", 0, "X offset of Bayer array");
+							add_key(&next_key, false, "%-8s= %20d / %s", "YBAYROFF", 0, "Y offset of Bayer array");
 						} else if (!strcmp(keywords->string, "GBRG")) {
-							add_key(&next_key, true, "%-8s= %20d / %s", "XBAYROFF", 0, "X offset of Bayer array");
-							add_key(&next_key, true, "%-8s= %20d / %s", "YBAYROFF", 1, "Y offset of Bayer array");
+							add_key(&next_key, false, "%-8s= %20d / %s", "XBAYROFF", 0, "X offset of Bayer array");
+							add_key(&next_key, false, "%-8s= %20d / %s", "YBAYROFF", 1, "Y offset of Bayer array");
 						} else if (!strcmp(keywords->string, "GRBG")) {
-							add_key(&next_key, true, "%-8s= %20d / %s", "XBAYROFF", 1, "X offset of Bayer array");
-							add_key(&next_key, true, "%-8s= %20d / %s", "YBAYROFF", 0, "Y offset of Bayer array");
+							add_key(&next_key, false, "%-8s= %20d / %s", "XBAYROFF", 1, "X offset of Bayer array");
+							add_key(&next_key, false, "%-8s= %20d / %s", "YBAYROFF", 0, "Y offset of Bayer array");
 						} else if (!strcmp(keywords->string, "BGGR")) {
-							add_key(&next_key, true, "%-8s= %20d / %s", "XBAYROFF", 1, "X offset of Bayer array");
-							add_key(&next_key, true, "%-8s= %20d / %s", "YBAYROFF", 1, "Y offset of Bayer array");
+							add_key(&next_key, false, "%-8s= %20d / %s", "XBAYROFF", 1, "X offset of Bayer array");
+							add_key(&next_key, false, "%-8s= %20d / %s", "YBAYROFF", 1, "Y offset of Bayer array");
 						}
 					}
 					break;
@@ -1267,8 +1459,8 @@ static void raw_to_tiff(indigo_device *device, void *data_in, int frame_width, i
 			keywords++;
 		}
 	}
-	for (int i = 0; i < CCD_FITS_HEADERS_PROPERTY->count; i++) {
-		indigo_item *item = CCD_FITS_HEADERS_PROPERTY->items + i;
+	for (int i = 0; i < settings->fits_headers->count; i++) {
+		indigo_item *item = settings->fits_headers->items + i;
 		if ((next_key - fits_header) < (FITS_HEADER_SIZE - 80))
 			add_key(&next_key, false, "%-8s= %s", item->name, item->text.value);
 	}
@@ -1318,9 +1510,10 @@ static void sanitise(char *buffer) {
 	}
 }
 
-static bool create_file_name(indigo_device *device, void *blob_value, long blob_size, char *dir, char *prefix, char *suffix, char *file_name) {
+static bool create_file_name(indigo_device *device, image_settings *settings, void *blob_value, long blob_size, char *suffix, char *file_name) {
 	char format[PATH_MAX], tmp[PATH_MAX];
-	strcpy(format, dir);
+	char *prefix = settings->local_prefix;
+	strcpy(format, settings->local_dir);
 	sanitise(prefix);
 	if (strchr(prefix, '%') == NULL) { // No %, INDI style
 		char *placeholder = strstr(prefix, "XXX");
@@ -1357,18 +1550,18 @@ static bool create_file_name(indigo_device *device, void *blob_value, long blob_
 			char e[16];
 			int digits = 0;
 			if (fs[1] == 'E') {
-				if (CCD_EXPOSURE_ITEM->number.target < 0.001)
+				if (settings->exposure_time < 0.001)
 					digits = 4;
-				else if (CCD_EXPOSURE_ITEM->number.target < 0.01)
+				else if (settings->exposure_time < 0.01)
 					digits = 3;
-				else if (CCD_EXPOSURE_ITEM->number.target < 0.1)
+				else if (settings->exposure_time < 0.1)
 					digits = 2;
-				else if (CCD_EXPOSURE_ITEM->number.target < 1)
+				else if (settings->exposure_time < 1)
 					digits = 1;
 			} else {
 				digits = fs[1] - '0';
 			}
-			sprintf(e, "%.*f", digits, CCD_EXPOSURE_ITEM->number.target);
+			sprintf(e, "%.*f", digits, settings->exposure_time);
 			strncpy(tmp, format, fs - format);
 			strcat(tmp, e);
 			if (fs[1] == 'E')
@@ -1378,18 +1571,14 @@ static bool create_file_name(indigo_device *device, void *blob_value, long blob_
 			strcpy(format, tmp);
 		} else if (fs[1] == 'T') { // %T - temperature
 			char t[16];
-			sprintf(t, "%.2f", CCD_TEMPERATURE_ITEM->number.value);
+			sprintf(t, "%.2f", settings->temperature);
 			strncpy(tmp, format, fs - format);
 			strcat(tmp, t);
 			strcat(tmp, fs + 2);
 			strcpy(format, tmp);
 		} else if (fs[1] == 'F') { // %F - frame type
 			strncpy(tmp, format, fs - format);
-			for(int i = 0; i < CCD_FRAME_TYPE_PROPERTY->count; i++) {
-				if (CCD_FRAME_TYPE_PROPERTY->items[i].sw.value) {
-					strcat(tmp, CCD_FRAME_TYPE_PROPERTY->items[i].label);
-				}
-			}
+			strcat(tmp, settings->frame_type_label);
 			strcat(tmp, fs + 2);
 			strcpy(format, tmp);
 		} else if ((fs[1] == 'D' || fs[1] == 'H') || ((fs[1] == '.' || fs[1] == '-') && (fs[2] == 'D' || fs[2] == 'H'))) { // %D, %.D, %-D - date, %H, %.H, %-H - time
@@ -1421,8 +1610,8 @@ static bool create_file_name(indigo_device *device, void *blob_value, long blob_
 		} else if (fs[1] == 'C') { // %C - colour filter, R G B Ha etc.
 			bool found = false;
 			strncpy(tmp, format, fs - format);
-			for (int i = 0; i < CCD_FITS_HEADERS_PROPERTY->count; i++) {
-				indigo_item *item = CCD_FITS_HEADERS_PROPERTY->items + i;
+			for (int i = 0; i < settings->fits_headers->count; i++) {
+				indigo_item *item = settings->fits_headers->items + i;
 				if (!strcmp(item->name, "FILTER") && item->text.value[0] == '\'') {
 					char filter[50];
 					strcpy(filter, item->text.value + 1);
@@ -1510,13 +1699,10 @@ int mkpath(const char *path) {
 	return 0;
 }
 
-void indigo_process_image(indigo_device *device, void *data, int frame_width, int frame_height, int bpp, bool little_endian, bool byte_order_rgb, indigo_fits_keyword *keywords, bool streaming) {
-	assert(device != NULL);
-	assert(data != NULL);
-
+static void process_image(indigo_device *device, image_settings *settings, void *data, int frame_width, int frame_height, int bpp, bool little_endian, bool byte_order_rgb, indigo_fits_keyword *keywords, bool streaming, struct timeval *timestamp) {
 	INDIGO_DEBUG(clock_t start = clock());
-	int horizontal_bin = CCD_BIN_HORIZONTAL_ITEM->number.value;
-	int vertical_bin = CCD_BIN_VERTICAL_ITEM->number.value;
+	int horizontal_bin = settings->horizontal_bin;
+	int vertical_bin = settings->vertical_bin;
 	int byte_per_pixel = bpp / 8;
 	int naxis = 2;
 	unsigned long size = frame_width * frame_height;
@@ -1528,32 +1714,37 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		byte_per_pixel = 2;
 		naxis = 3;
 	}
-	if (byte_per_pixel == 2 && !little_endian) {
-		uint16_t *raw = (uint16_t *)(data + FITS_HEADER_SIZE);
-		for (int i = 0; i < size; i++) {
-			uint16_t value = *raw;
-			*raw++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-		}
-	}
-	if (naxis == 3 && !byte_order_rgb) {
-		if (byte_per_pixel == 1) {
-			unsigned char *b8 = data + FITS_HEADER_SIZE;
-			for (int i = 0; i < size; i++) {
-				unsigned char b = *b8;
-				unsigned char r = *(b8 + 2);
-				*b8 = r;
-				*(b8 + 2) = b;
-				b8 += 3;
+	bool use_jpeg = settings->jpeg_format || settings->jpeg_avi_format || settings->preview;
+	// FITS conversion handles byte and channel order in the same pass, otherwise data are normalized here
+	if (use_jpeg || !settings->fits_format) {
+		if (byte_per_pixel == 2 && !little_endian) {
+			uint16_t *raw = (uint16_t *)(data + FITS_HEADER_SIZE);
+			unsigned long count = naxis == 3 ? 3 * size : size;
+			for (unsigned long i = 0; i < count; i++) {
+				uint16_t value = raw[i];
+				raw[i] = value << 8 | value >> 8;
 			}
-		} else if (byte_per_pixel == 2) {
-			unsigned char *b16 = data + FITS_HEADER_SIZE;
-			for (int i = 0; i < size; i++) {
-				unsigned char b = *b16;
-				unsigned char r = *(b16 + 2);
-				*b16 = r;
-				*(b16 + 2) = b;
-				b16 += 3;
+			little_endian = true;
+		}
+		if (naxis == 3 && !byte_order_rgb) {
+			if (byte_per_pixel == 1) {
+				unsigned char *b8 = data + FITS_HEADER_SIZE;
+				for (int i = 0; i < size; i++) {
+					unsigned char b = *b8;
+					*b8 = *(b8 + 2);
+					*(b8 + 2) = b;
+					b8 += 3;
+				}
+			} else if (byte_per_pixel == 2) {
+				uint16_t *b16 = (uint16_t *)(data + FITS_HEADER_SIZE);
+				for (int i = 0; i < size; i++) {
+					uint16_t b = *b16;
+					*b16 = *(b16 + 2);
+					*(b16 + 2) = b;
+					b16 += 3;
+				}
 			}
+			byte_order_rgb = true;
 		}
 	}
 	unsigned header_size = 0;
@@ -1573,11 +1764,11 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 			}
 		}
 	}
-	if (CCD_IMAGE_FORMAT_JPEG_ITEM->sw.value || CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value || CCD_PREVIEW_ENABLED_ITEM->sw.value || CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value) {
-		double B = CCD_JPEG_SETTINGS_TARGET_BACKGROUND_ITEM->number.target;
-		double C = CCD_JPEG_SETTINGS_CLIPPING_POINT_ITEM->number.target;
-		indigo_raw_to_jpeg(device, data + FITS_HEADER_SIZE, frame_width, frame_height, bpp, bayerpat, &jpeg_data, &jpeg_size,  CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value ? &histogram_data : NULL, CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value ? &histogram_size : NULL, B, C);
-		if (CCD_PREVIEW_ENABLED_ITEM->sw.value || CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value) {
+	if (use_jpeg) {
+		double B = settings->jpeg_background;
+		double C = settings->jpeg_clipping_point;
+		raw_to_jpeg(device, data + FITS_HEADER_SIZE, frame_width, frame_height, bpp, bayerpat, &jpeg_data, &jpeg_size,  settings->preview_histogram ? &histogram_data : NULL, settings->preview_histogram ? &histogram_size : NULL, B, C, settings->jpeg_quality);
+		if (settings->preview) {
 			CCD_PREVIEW_IMAGE_PROPERTY->state = INDIGO_BUSY_STATE;
 			indigo_update_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
 			if (jpeg_data) {
@@ -1597,7 +1788,7 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 				CCD_PREVIEW_IMAGE_PROPERTY->state = INDIGO_ALERT_STATE;
 			}
 			indigo_update_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
-			if (CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value) {
+			if (settings->preview_histogram) {
 				CCD_PREVIEW_HISTOGRAM_PROPERTY->state = INDIGO_BUSY_STATE;
 				indigo_update_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
 				if (histogram_data) {
@@ -1620,28 +1811,28 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 			}
 		}
 	}
-	if (CCD_IMAGE_FORMAT_FITS_ITEM->sw.value) {
+	bool compressed = false;
+	if (settings->fits_format) {
 		INDIGO_DEBUG(clock_t start = clock());
-		struct timeval tv;
+		struct timeval tv = *timestamp;
 		struct tm tm_info;
 		char date_time[20], date_time_end[25];
-		gettimeofday(&tv, NULL);
 		long millisec = lrint(tv.tv_usec/1000.0);
 		if (millisec >= 1000) {
 			millisec -= 1000;
 			tv.tv_sec++;
 		}
-		if (CCD_STREAMING_PROPERTY->state == INDIGO_BUSY_STATE) {
-			double secs = floor(CCD_STREAMING_EXPOSURE_ITEM->number.target);
-			millisec -= (long)((CCD_STREAMING_EXPOSURE_ITEM->number.target - secs) * 1000);
+		if (settings->streaming_exposure) {
+			double secs = floor(settings->streaming_exposure_time);
+			millisec -= (long)((settings->streaming_exposure_time - secs) * 1000);
 			if (millisec < 0) {
 				millisec += 1000;
 				tv.tv_sec--;
 			}
 			tv.tv_sec -= (int)secs;
 		} else {
-			double secs = floor(CCD_EXPOSURE_ITEM->number.target);
-			millisec -= (long)((CCD_EXPOSURE_ITEM->number.target - secs) * 1000);
+			double secs = floor(settings->exposure_time);
+			millisec -= (long)((settings->exposure_time - secs) * 1000);
 			if (millisec < 0) {
 				millisec += 1000;
 				tv.tv_sec--;
@@ -1652,7 +1843,6 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		strftime(date_time, sizeof(date_time), "%Y-%m-%dT%H:%M:%S", &tm_info);
 		snprintf(date_time_end, sizeof(date_time_end), "%s.%03ld", date_time, millisec);
 		char *header = data;
-		memset(header, ' ', FITS_HEADER_SIZE);
 		add_key(&header, true,  "SIMPLE  =                    T / file conforms to FITS standard");
 		if (bpp == 8 || bpp == 16) {
 			add_key(&header, true,  "BITPIX  = %20d / number of bits per data pixel", bpp);
@@ -1664,7 +1854,7 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 			add_key(&header, true,  "NAXIS   =                    %d / number of data axes", 3);
 			add_key(&header, true,  "NAXIS1  = %20d / length of data axis 1 [pixels]", frame_width);
 			add_key(&header, true,  "NAXIS2  = %20d / length of data axis 2 [pixels]", frame_height);
-			add_key(&header, true,  "NAXIS3  = %20d / length of data axis 3 [RGB]\n", 3);
+			add_key(&header, true,  "NAXIS3  = %20d / length of data axis 3 [RGB]", 3);
 		}
 		add_key(&header, true,  "EXTEND  =                    T / FITS dataset may contain extensions");
 		if (bpp == 16 || bpp == 48) {
@@ -1673,52 +1863,52 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		}
 		add_key(&header, true,  "XBINNING= %20d / horizontal binning [pixels]", horizontal_bin);
 		add_key(&header, true,  "YBINNING= %20d / vertical binning [pixels]", vertical_bin);
-		if (CCD_INFO_PIXEL_WIDTH_ITEM->number.value > 0 && CCD_INFO_PIXEL_HEIGHT_ITEM->number.value) {
-			add_key(&header, true,  "XPIXSZ  = %20.2f / pixel width [microns]", CCD_INFO_PIXEL_WIDTH_ITEM->number.value * horizontal_bin);
-			add_key(&header, true,  "YPIXSZ  = %20.2f / pixel height [microns]", CCD_INFO_PIXEL_HEIGHT_ITEM->number.value * vertical_bin);
+		if (settings->pixel_width > 0 && settings->pixel_height) {
+			add_key(&header, true,  "XPIXSZ  = %20.2f / pixel width [microns]", settings->pixel_width * horizontal_bin);
+			add_key(&header, true,  "YPIXSZ  = %20.2f / pixel height [microns]", settings->pixel_height * vertical_bin);
 		}
-		if (CCD_STREAMING_PROPERTY->state == INDIGO_BUSY_STATE) {
-			if (CCD_STREAMING_EXPOSURE_ITEM->number.target >= 1.0)
-				add_key(&header, true,  "EXPTIME = %20.2f / exposure time [s]", CCD_STREAMING_EXPOSURE_ITEM->number.target);
+		if (settings->streaming_exposure) {
+			if (settings->streaming_exposure_time >= 1.0)
+				add_key(&header, true,  "EXPTIME = %20.2f / exposure time [s]", settings->streaming_exposure_time);
 			else
-				add_key(&header, true,  "EXPTIME = %20.4f / exposure time [s]", CCD_STREAMING_EXPOSURE_ITEM->number.target);
+				add_key(&header, true,  "EXPTIME = %20.4f / exposure time [s]", settings->streaming_exposure_time);
 		} else {
-			if (CCD_EXPOSURE_ITEM->number.target >= 1.0)
-				add_key(&header, true,  "EXPTIME = %20.2f / exposure time [s]", CCD_EXPOSURE_ITEM->number.target);
+			if (settings->exposure_time >= 1.0)
+				add_key(&header, true,  "EXPTIME = %20.2f / exposure time [s]", settings->exposure_time);
 			else
-				add_key(&header, true,  "EXPTIME = %20.4f / exposure time [s]", CCD_EXPOSURE_ITEM->number.target);
+				add_key(&header, true,  "EXPTIME = %20.4f / exposure time [s]", settings->exposure_time);
 		}
-		if (!CCD_TEMPERATURE_PROPERTY->hidden)
-			add_key(&header, true,  "CCD-TEMP= %20.2f / CCD temperature [C]", CCD_TEMPERATURE_ITEM->number.value);
-		if (CCD_FRAME_TYPE_LIGHT_ITEM->sw.value)
+		if (settings->has_temperature)
+			add_key(&header, true,  "CCD-TEMP= %20.2f / CCD temperature [C]", settings->temperature);
+		if (settings->light_frame)
 			add_key(&header, true,  "IMAGETYP= 'Light'               / frame type");
-		else if (CCD_FRAME_TYPE_FLAT_ITEM->sw.value)
+		else if (settings->flat_frame)
 			add_key(&header, true,  "IMAGETYP= 'Flat'                / frame type");
-		else if (CCD_FRAME_TYPE_BIAS_ITEM->sw.value)
+		else if (settings->bias_frame)
 			add_key(&header, true,  "IMAGETYP= 'Bias'                / frame type");
-		else if (CCD_FRAME_TYPE_DARK_ITEM->sw.value)
+		else if (settings->dark_frame)
 			add_key(&header, true,  "IMAGETYP= 'Dark'                / frame type");
-		else if (CCD_FRAME_TYPE_DARKFLAT_ITEM->sw.value)
+		else if (settings->darkflat_frame)
 			add_key(&header, true,  "IMAGETYP= 'DarkFlat'            / frame type");
-		if (!CCD_GAIN_PROPERTY->hidden)
-			add_key(&header, true,  "GAIN    = %20.2f / Sensor gain", CCD_GAIN_ITEM->number.value);
-		if (!CCD_EGAIN_PROPERTY->hidden && CCD_EGAIN_ITEM->number.value > 0)
-			add_key(&header, true,  "EGAIN   = %20.4f / Electrons per A/D unit [e-/ADU]", CCD_EGAIN_ITEM->number.value);
-		if (!CCD_OFFSET_PROPERTY->hidden)
-			add_key(&header, true,  "OFFSET  = %20.2f / Offset", CCD_OFFSET_ITEM->number.value);
-		if (!CCD_GAMMA_PROPERTY->hidden)
-			add_key(&header, true,  "GAMMA   = %20.2f / Gamma", CCD_GAMMA_ITEM->number.value);
+		if (settings->has_gain)
+			add_key(&header, true,  "GAIN    = %20.2f / Sensor gain", settings->gain);
+		if (settings->has_egain && settings->egain > 0)
+			add_key(&header, true,  "EGAIN   = %20.4f / Electrons per A/D unit [e-/ADU]", settings->egain);
+		if (settings->has_offset)
+			add_key(&header, true,  "OFFSET  = %20.2f / Offset", settings->offset);
+		if (settings->has_gamma)
+			add_key(&header, true,  "GAMMA   = %20.2f / Gamma", settings->gamma);
 		add_key(&header, true,  "DATE-OBS= '%s' / UTC date that FITS file was created", date_time_end);
 		add_key(&header, true,  "INSTRUME= '%s'%*c / instrument name", device->name, (int)(19 - strlen(device->name)), ' ');
 		add_key(&header, true,  "ROWORDER= 'TOP-DOWN'           / Image row order");
 		add_key(&header, true,  "SWCREATE= 'INDIGO 2.0-%s'     / Capture software", INDIGO_BUILD);
-		if (!CCD_LENS_PROPERTY->hidden) {
+		if (settings->has_lens) {
 			// https://indico.esa.int/event/124/attachments/711/771/06_ESA-SSA-NEO-RS-0003_1_6_FITS_keyword_requirements_2014-08-01.pdf
 			// 5.4 Telescope information
-			if (CCD_LENS_APERTURE_ITEM->number.value > 0)
-				add_key(&header, true,  "APTDIA  = %20.2f / Aperture diameter (mm)", CCD_LENS_APERTURE_ITEM->number.value * 10);
-			if (CCD_LENS_FOCAL_LENGTH_ITEM->number.value > 0)
-				add_key(&header, true,  "FOCALLEN= %20.2f / Focal length (mm)", CCD_LENS_FOCAL_LENGTH_ITEM->number.value * 10);
+			if (settings->lens_aperture > 0)
+				add_key(&header, true,  "APTDIA  = %20.2f / Aperture diameter (mm)", settings->lens_aperture * 10);
+			if (settings->lens_focal_length > 0)
+				add_key(&header, true,  "FOCALLEN= %20.2f / Focal length (mm)", settings->lens_focal_length * 10);
 		}
 		if (keywords) {
 			while (keywords->type && (header - (char *)data) < (FITS_HEADER_SIZE - 80)) {
@@ -1754,8 +1944,8 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 				keywords++;
 			}
 		}
-		for (int i = 0; i < CCD_FITS_HEADERS_PROPERTY->count; i++) {
-			indigo_item *item = CCD_FITS_HEADERS_PROPERTY->items + i;
+		for (int i = 0; i < settings->fits_headers->count; i++) {
+			indigo_item *item = settings->fits_headers->items + i;
 			if ((header - (char *)data) < (FITS_HEADER_SIZE - 80))
 				add_key(&header, true, "%-8s= %s", item->name, item->text.value);
 		}
@@ -1763,45 +1953,20 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		header_size = (unsigned)(header - (char *)data);
 		if (header_size % FITS_LOGICAL_RECORD_LENGTH != 0) {
 			header_size = (header_size / FITS_LOGICAL_RECORD_LENGTH + 1) * FITS_LOGICAL_RECORD_LENGTH;
+			memset(header, ' ', data + header_size - (void *)header);
 		}
 		if (header_size < FITS_HEADER_SIZE) {
 			memmove(data + FITS_HEADER_SIZE - header_size, data, header_size);
 		}
-		if (byte_per_pixel == 2 && naxis == 2) {
-			uint16_t *raw = (uint16_t *)(data + FITS_HEADER_SIZE);
-			for (int i = 0; i < size; i++) {
-				int value = *raw - 32768;
-				*raw++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-			}
-		} else if (byte_per_pixel == 1 && naxis == 3) {
-			unsigned char *raw = indigo_safe_malloc(3 * size);
-			unsigned char *red = raw;
-			unsigned char *green = raw + size;
-			unsigned char *blue = raw + 2 * size;
-			unsigned char *tmp = data + FITS_HEADER_SIZE;
-			for (int i = 0; i < size; i++) {
-				*red++ = *tmp++;
-				*green++ = *tmp++;
-				*blue++ = *tmp++;
-			}
-			memcpy(data + FITS_HEADER_SIZE, raw, 3 * size);
-			free(raw);
-		} else if (byte_per_pixel == 2 && naxis == 3) {
-			uint16_t *raw = indigo_safe_malloc(6 * size);
-			uint16_t *red = raw;
-			uint16_t *green = raw + size;
-			uint16_t *blue = raw + 2 * size;
-			uint16_t *tmp = (uint16_t *)(data + FITS_HEADER_SIZE);
-			for (int i = 0; i < size; i++) {
-				int value = *tmp++ - 32768;
-				*red++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-				value = *tmp++ - 32768;
-				*green++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-				value = *tmp++ - 32768;
-				*blue++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-			}
-			memcpy(data + FITS_HEADER_SIZE, raw, 6 * size);
-			free(raw);
+		void *raw = data + FITS_HEADER_SIZE;
+		if (naxis == 3) {
+			// planes can't be split in place, interleaved data are copied to reusable buffer first
+			if (CCD_CONTEXT->conversion_buffer_size < blobsize)
+				CCD_CONTEXT->conversion_buffer = indigo_safe_realloc(CCD_CONTEXT->conversion_buffer, CCD_CONTEXT->conversion_buffer_size = blobsize);
+			memcpy(CCD_CONTEXT->conversion_buffer, raw, blobsize);
+			indigo_raw_to_fits_data(CCD_CONTEXT->conversion_buffer, raw, (int)size, byte_per_pixel, 3, little_endian, byte_order_rgb);
+		} else {
+			indigo_raw_to_fits_data(raw, raw, (int)size, byte_per_pixel, 1, little_endian, byte_order_rgb);
 		}
 		int mod2880 = blobsize % 2880;
 		if (mod2880) {
@@ -1812,42 +1977,62 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 			}
 		}
 		INDIGO_DEBUG(indigo_debug("RAW to FITS conversion in %gs", (clock() - start) / (double)CLOCKS_PER_SEC));
-	} else if (CCD_IMAGE_FORMAT_XISF_ITEM->sw.value) {
+		if (settings->compression) {
+			INDIGO_DEBUG(clock_t start = clock());
+			indigo_fits_compression compression = settings->rice_compression ? INDIGO_FITS_RICE : INDIGO_FITS_GZIP_2;
+			if (indigo_compress_fits(data + FITS_HEADER_SIZE - header_size, header_size, data + FITS_HEADER_SIZE, frame_width, frame_height, byte_per_pixel, naxis == 3 ? 3 : 1, compression, (char **)&CCD_CONTEXT->compression_buffer, &CCD_CONTEXT->compression_buffer_size) == INDIGO_OK) {
+				compressed = true;
+				INDIGO_DEBUG(indigo_debug("FITS compression %lu -> %lu in %gs", header_size + blobsize, CCD_CONTEXT->compression_buffer_size, (clock() - start) / (double)CLOCKS_PER_SEC));
+			} else {
+				indigo_error("FITS compression failed, sending uncompressed image");
+			}
+		}
+	} else if (settings->xisf_format) {
 		INDIGO_DEBUG(clock_t start = clock());
-		time_t timer;
+		time_t timer = timestamp->tv_sec;
 		struct tm* tm_info;
 		char date_time_end[21], date_time_start[21], fits_date_obs[21];
-		time(&timer);
 		tm_info = gmtime(&timer);
 		strftime(date_time_end, 21, "%Y-%m-%dT%H:%M:%SZ", tm_info);
-		timer -= CCD_EXPOSURE_ITEM->number.target;
+		timer -= settings->exposure_time;
 		tm_info = gmtime(&timer);
 		strftime(date_time_start, 21, "%Y-%m-%dT%H:%M:%SZ", tm_info);
 		strftime(fits_date_obs, 21, "%Y-%m-%dT%H:%M:%S", tm_info);
+		char compression[64] = "";
+		if (settings->compression) {
+			// byte shuffled zlib is the only codec from XISF spec available in the tree, data are kept uncompressed if they don't shrink
+			if (indigo_compress_shuffled(data + FITS_HEADER_SIZE, blobsize, byte_per_pixel, (char **)&CCD_CONTEXT->compression_buffer, &CCD_CONTEXT->compression_buffer_size) == INDIGO_OK && CCD_CONTEXT->compression_buffer_size < blobsize) {
+				if (byte_per_pixel == 1)
+					sprintf(compression, " compression='zlib:%lu'", blobsize);
+				else
+					sprintf(compression, " compression='zlib+sh:%lu:%d'", blobsize, byte_per_pixel);
+				memcpy(data + FITS_HEADER_SIZE, CCD_CONTEXT->compression_buffer, blobsize = CCD_CONTEXT->compression_buffer_size);
+			}
+		}
 		char *header = data;
 		strcpy(header, "XISF0100");
 		header += 16;
-		memset(header, 0, FITS_HEADER_SIZE);
+		memset(header, 0, FITS_HEADER_SIZE - 16);
 		// https://pixinsight.com/doc/docs/XISF-1.0-spec/XISF-1.0-spec.html
 		header += sprintf(header, "<?xml version='1.0' encoding='UTF-8'?><xisf xmlns='http://www.pixinsight.com/xisf' xmlns:xsi='http://www.w3.org/2001/XMLSchema-instance' version='1.0' xsi:schemaLocation='http://www.pixinsight.com/xisf http://pixinsight.com/xisf/xisf-1.0.xsd'>");
 		char *frame_type = "Light";
 		char b1[32], b2[32];
-		if (CCD_FRAME_TYPE_FLAT_ITEM->sw.value)
+		if (settings->flat_frame)
 			frame_type ="Flat";
-		else if (CCD_FRAME_TYPE_BIAS_ITEM->sw.value)
+		else if (settings->bias_frame)
 			frame_type ="Bias";
-		else if (CCD_FRAME_TYPE_DARK_ITEM->sw.value)
+		else if (settings->dark_frame)
 			frame_type ="Dark";
-		else if (CCD_FRAME_TYPE_DARKFLAT_ITEM->sw.value)
+		else if (settings->darkflat_frame)
 			frame_type ="DarkFlat";
 		if (naxis == 2 && byte_per_pixel == 1) {
-			header += sprintf(header, "<Image geometry='%d:%d:1' imageType='%s' sampleFormat='UInt8' colorSpace='Gray' location='attachment:%d:%lu'>", frame_width, frame_height, frame_type, FITS_HEADER_SIZE, blobsize);
+			header += sprintf(header, "<Image geometry='%d:%d:1' imageType='%s' sampleFormat='UInt8' colorSpace='Gray'%s location='attachment:%d:%lu'>", frame_width, frame_height, frame_type, compression, FITS_HEADER_SIZE, blobsize);
 		} else if (naxis == 2 && byte_per_pixel == 2) {
-			header += sprintf(header, "<Image geometry='%d:%d:1' imageType='%s' sampleFormat='UInt16' colorSpace='Gray' location='attachment:%d:%lu'>", frame_width, frame_height, frame_type, FITS_HEADER_SIZE, blobsize);
+			header += sprintf(header, "<Image geometry='%d:%d:1' imageType='%s' sampleFormat='UInt16' colorSpace='Gray'%s location='attachment:%d:%lu'>", frame_width, frame_height, frame_type, compression, FITS_HEADER_SIZE, blobsize);
 		} else if (naxis == 3 && byte_per_pixel == 1) {
-			header += sprintf(header, "<Image geometry='%d:%d:3' imageType='%s' pixelStorage='Normal' sampleFormat='UInt8' colorSpace='RGB' location='attachment:%d:%lu'>", frame_width, frame_height, frame_type, FITS_HEADER_SIZE, blobsize);
+			header += sprintf(header, "<Image geometry='%d:%d:3' imageType='%s' pixelStorage='Normal' sampleFormat='UInt8' colorSpace='RGB'%s location='attachment:%d:%lu'>", frame_width, frame_height, frame_type, compression, FITS_HEADER_SIZE, blobsize);
 		} else if (naxis == 3 && byte_per_pixel == 2) {
-			header += sprintf(header, "<Image geometry='%d:%d:3' imageType='%s' pixelStorage='Normal' sampleFormat='UInt16' colorSpace='RGB' location='attachment:%d:%lu'>", frame_width, frame_height, frame_type, FITS_HEADER_SIZE, blobsize);
+			header += sprintf(header, "<Image geometry='%d:%d:3' imageType='%s' pixelStorage='Normal' sampleFormat='UInt16' colorSpace='RGB'%s location='attachment:%d:%lu'>", frame_width, frame_height, frame_type, compression, FITS_HEADER_SIZE, blobsize);
 		}
 		header += sprintf(header, "<FITSKeyword name='IMAGETYP' value='%s' comment='Frame type'/>", frame_type);
 		header += sprintf(header, "<Property id='Observation:Time:Start' type='TimePoint' value='%s'/><Property id='Observation:Time:End' type='TimePoint' value='%s'/>", date_time_start ,date_time_end);
@@ -1856,42 +2041,42 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		header += sprintf(header, "<FITSKeyword name='INSTRUME' value='%s' comment='Instrument'/>", device->name);
 		header += sprintf(header, "<Property id='Instrument:Camera:XBinning' type='Int32' value='%d'/><Property id='Instrument:Camera:YBinning' type='Int32' value='%d'/>", horizontal_bin, vertical_bin);
 		header += sprintf(header, "<FITSKeyword name='XBINNING' value='%d' comment='Binning factor, X-axis'/><FITSKeyword name='YBINNING' value='%d' comment='Binning factor, Y-axis'/>", horizontal_bin, vertical_bin);
-		header += sprintf(header, "<Property id='Instrument:ExposureTime' type='Float32' value='%s'/>", indigo_dtoa(CCD_EXPOSURE_ITEM->number.target, b1));
-		if (CCD_EXPOSURE_ITEM->number.target >= 1.0)
-			header += sprintf(header, "<FITSKeyword name='EXPTIME'  value='%20.2f' comment='Exposure time in seconds'/>", CCD_EXPOSURE_ITEM->number.target);
+		header += sprintf(header, "<Property id='Instrument:ExposureTime' type='Float32' value='%s'/>", indigo_dtoa(settings->exposure_time, b1));
+		if (settings->exposure_time >= 1.0)
+			header += sprintf(header, "<FITSKeyword name='EXPTIME'  value='%20.2f' comment='Exposure time in seconds'/>", settings->exposure_time);
 		else
-			header += sprintf(header, "<FITSKeyword name='EXPTIME'  value='%20.4f' comment='Exposure time in seconds'/>", CCD_EXPOSURE_ITEM->number.target);
-		header += sprintf(header, "<Property id='Instrument:Sensor:XPixelSize' type='Float32' value='%s'/><Property id='Instrument:Sensor:YPixelSize' type='Float32' value='%s'/>", indigo_dtoa(CCD_INFO_PIXEL_WIDTH_ITEM->number.value * horizontal_bin, b1), indigo_dtoa(CCD_INFO_PIXEL_HEIGHT_ITEM->number.value * vertical_bin, b2));
-		header += sprintf(header, "<FITSKeyword name='XPIXSZ'  value='%20.2f' comment='Pixel horizontal width in microns'/><FITSKeyword name='YPIXSZ' value='%20.2f' comment='Pixel vertical width in microns'/>", CCD_INFO_PIXEL_WIDTH_ITEM->number.value * horizontal_bin, CCD_INFO_PIXEL_HEIGHT_ITEM->number.value * vertical_bin);
-
-		if (!CCD_TEMPERATURE_PROPERTY->hidden) {
-			header += sprintf(header, "<Property id='Instrument:Sensor:Temperature' type='Float32' value='%s'/><Property id='Instrument:Sensor:TargetTemperature' type='Float32' value='%s'/>", indigo_dtoa(CCD_TEMPERATURE_ITEM->number.value, b1), indigo_dtoa(CCD_TEMPERATURE_ITEM->number.target, b2));
-			header += sprintf(header, "<FITSKeyword name='CCD-TEMP' value='%20.2f' comment='CCD chip temperature in celsius'/>", CCD_TEMPERATURE_ITEM->number.value);
-		}
-		if (!CCD_GAIN_PROPERTY->hidden) {
-			header += sprintf(header, "<Property id='Instrument:Camera:Gain' type='Float32' value='%s'/>", indigo_dtoa(CCD_GAIN_ITEM->number.value, b1));
-			header += sprintf(header, "<FITSKeyword name='GAIN' value='%20.2f' comment='Gain'/>", CCD_GAIN_ITEM->number.value);
-		}
-		if (!CCD_OFFSET_PROPERTY->hidden) {
-			header += sprintf(header, "<Property id='Instrument:Camera:Offset' type='Float32' value='%s'/>", indigo_dtoa(CCD_OFFSET_ITEM->number.value, b1));
-			header += sprintf(header, "<FITSKeyword name='OFFSET' value='%20.2f' comment='Offset'/>", CCD_OFFSET_ITEM->number.value);
-		}
-		if (!CCD_GAMMA_PROPERTY->hidden) {
-			header += sprintf(header, "<Property id='Instrument:Camera:Gamma' type='Float32' value='%s'/>", indigo_dtoa(CCD_GAMMA_ITEM->number.value, b1));
-			header += sprintf(header, "<FITSKeyword name='GAMMA' value='%20.2f' comment='Gamma'/>", CCD_GAMMA_ITEM->number.value);
-		}
-		if (!CCD_LENS_PROPERTY->hidden) {
-			if (CCD_LENS_APERTURE_ITEM->number.value > 0) {
-				header += sprintf(header, "<Property id='Instrument:Camera:Aperture' type='Float32' value='%s'/>", indigo_dtoa(CCD_LENS_APERTURE_ITEM->number.value / 100, b1));
-				header += sprintf(header, "<FITSKeyword name='APTDIA' value='%20.2f' comment='Aperture diameter (mm)'/>", CCD_LENS_APERTURE_ITEM->number.value * 10);
+			header += sprintf(header, "<FITSKeyword name='EXPTIME'  value='%20.4f' comment='Exposure time in seconds'/>", settings->exposure_time);
+		header += sprintf(header, "<Property id='Instrument:Sensor:XPixelSize' type='Float32' value='%s'/><Property id='Instrument:Sensor:YPixelSize' type='Float32' value='%s'/>", indigo_dtoa(settings->pixel_width * horizontal_bin, b1), indigo_dtoa(settings->pixel_height * vertical_bin, b2));
+		header += sprintf(header, "<FITSKeyword name='XPIXSZ'  value='%20.2f' comment='Pixel horizontal width in microns'/><FITSKeyword name='YPIXSZ' value='%20.2f' comment='Pixel vertical width in microns'/>", settings->pixel_width * horizontal_bin, settings->pixel_height * vertical_bin);
+
+		if (settings->has_temperature) {
+			header += sprintf(header, "<Property id='Instrument:Sensor:Temperature' type='Float32' value='%s'/><Property id='Instrument:Sensor:TargetTemperature' type='Float32' value='%s'/>", indigo_dtoa(settings->temperature, b1), indigo_dtoa(settings->target_temperature, b2));
+			header += sprintf(header, "<FITSKeyword name='CCD-TEMP' value='%20.2f' comment='CCD chip temperature in celsius'/>", settings->temperature);
+		}
+		if (settings->has_gain) {
+			header += sprintf(header, "<Property id='Instrument:Camera:Gain' type='Float32' value='%s'/>", indigo_dtoa(settings->gain, b1));
+			header += sprintf(header, "<FITSKeyword name='GAIN' value='%20.2f' comment='Gain'/>", settings->gain);
+		}
+		if (settings->has_offset) {
+			header += sprintf(header, "<Property id='Instrument:Camera:Offset' type='Float32' value='%s'/>", indigo_dtoa(settings->offset, b1));
+			header += sprintf(header, "<FITSKeyword name='OFFSET' value='%20.2f' comment='Offset'/>", settings->offset);
+		}
+		if (settings->has_gamma) {
+			header += sprintf(header, "<Property id='Instrument:Camera:Gamma' type='Float32' value='%s'/>", indigo_dtoa(settings->gamma, b1));
+			header += sprintf(header, "<FITSKeyword name='GAMMA' value='%20.2f' comment='Gamma'/>", settings->gamma);
+		}
+		if (settings->has_lens) {
+			if (settings->lens_aperture > 0) {
+				header += sprintf(header, "<Property id='Instrument:Camera:Aperture' type='Float32' value='%s'/>", indigo_dtoa(settings->lens_aperture / 100, b1));
+				header += sprintf(header, "<FITSKeyword name='APTDIA' value='%20.2f' comment='Aperture diameter (mm)'/>", settings->lens_aperture * 10);
 			}
-			if (CCD_LENS_FOCAL_LENGTH_ITEM->number.value > 0) {
-				header += sprintf(header, "<Property id='Instrument:Camera:FocalLength' type='Float32' value='%s'/>", indigo_dtoa(CCD_LENS_FOCAL_LENGTH_ITEM->number.value / 100, b1));
-				header += sprintf(header, "<FITSKeyword name='FOCALLEN' value='%20.2f' comment='Focal length (mm)'/>", CCD_LENS_FOCAL_LENGTH_ITEM->number.value * 10);
+			if (settings->lens_focal_length > 0) {
+				header += sprintf(header, "<Property id='Instrument:Camera:FocalLength' type='Float32' value='%s'/>", indigo_dtoa(settings->lens_focal_length / 100, b1));
+				header += sprintf(header, "<FITSKeyword name='FOCALLEN' value='%20.2f' comment='Focal length (mm)'/>", settings->lens_focal_length * 10);
 			}
 		}
-		for (int i = 0; i < CCD_FITS_HEADERS_PROPERTY->count; i++) {
-			indigo_item *item = CCD_FITS_HEADERS_PROPERTY->items + i;
+		for (int i = 0; i < settings->fits_headers->count; i++) {
+			indigo_item *item = settings->fits_headers->items + i;
 			if (!strcmp(item->name, "FILTER")) {
 				header += sprintf(header, "<Property id='Instrument:Filter:Name' type='String' value=%s/>", item->text.value);
 				header += sprintf(header, "<FITSKeyword name='FILTER' value=%s comment='Name of the used filter'/>", item->text.value);
@@ -1921,7 +2106,7 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		header += sprintf(header, "<Property id='XISF:BlockAlignmentSize' type='UInt16' value='2880'/></Metadata></xisf>");
 		*(uint32_t *)(data + 8) = (uint32_t)(header - (char *)data) - 16;
 		INDIGO_DEBUG(indigo_debug("RAW to XISF conversion in %gs", (clock() - start) / (double)CLOCKS_PER_SEC));
-	} else if (CCD_IMAGE_FORMAT_RAW_ITEM->sw.value || CCD_IMAGE_FORMAT_RAW_SER_ITEM->sw.value) {
+	} else if (settings->raw_format || settings->raw_ser_format) {
 		indigo_raw_header *header = (indigo_raw_header *)(data + FITS_HEADER_SIZE - sizeof(indigo_raw_header));
 		if (naxis == 2 && byte_per_pixel == 1)
 			header->signature = INDIGO_RAW_MONO8;
@@ -1939,17 +2124,17 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 			blobsize += sprintf(appendix, "SIMPLE=T;BAYERPAT='%s';", bayerpat);
 		}
 		// use semicolon as separator to append other items later
-	} else if (CCD_IMAGE_FORMAT_JPEG_ITEM->sw.value || CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value) {
+	} else if (settings->jpeg_format || settings->jpeg_avi_format) {
 		if (jpeg_data && jpeg_size < blobsize + FITS_HEADER_SIZE) {
 			memcpy(data, jpeg_data, jpeg_size);
 			blobsize = jpeg_size;
 		} else {
 			indigo_error("JPEG Size > BLOB Size");
 		}
-	} else if (CCD_IMAGE_FORMAT_TIFF_ITEM->sw.value) {
+	} else if (settings->tiff_format) {
 		void *tiff_data = NULL;
 		unsigned long tiff_size = 0;
-		raw_to_tiff(device, data, frame_width, frame_height, bpp, &tiff_data, &tiff_size, keywords);
+		raw_to_tiff(device, settings, data, frame_width, frame_height, bpp, &tiff_data, &tiff_size, keywords);
 		if (tiff_data) {
 			if (tiff_size < blobsize + FITS_HEADER_SIZE) {
 				memcpy(data, tiff_data, tiff_size);
@@ -1962,44 +2147,47 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 	}
 	void *blob_value = NULL;
 	long blob_size = 0;
-	if (CCD_IMAGE_FORMAT_FITS_ITEM->sw.value) {
+	if (settings->fits_format && compressed) {
+		blob_value = CCD_CONTEXT->compression_buffer;
+		blob_size = CCD_CONTEXT->compression_buffer_size;
+	} else if (settings->fits_format) {
 		blob_value = data + FITS_HEADER_SIZE - header_size;
 		blob_size = header_size + blobsize;
-	} else if (CCD_IMAGE_FORMAT_XISF_ITEM->sw.value) {
+	} else if (settings->xisf_format) {
 		blob_value = data;
 		blob_size = FITS_HEADER_SIZE + blobsize;
-	} else if (CCD_IMAGE_FORMAT_RAW_ITEM->sw.value || CCD_IMAGE_FORMAT_RAW_SER_ITEM->sw.value) {
+	} else if (settings->raw_format || settings->raw_ser_format) {
 		blob_value = data + FITS_HEADER_SIZE - sizeof(indigo_raw_header);
 		blob_size = blobsize + sizeof(indigo_raw_header);
-	} else if (CCD_IMAGE_FORMAT_JPEG_ITEM->sw.value || CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value) {
+	} else if (settings->jpeg_format || settings->jpeg_avi_format) {
 		blob_value = data;
 		blob_size = blobsize;
-	} else if (CCD_IMAGE_FORMAT_TIFF_ITEM->sw.value) {
+	} else if (settings->tiff_format) {
 		blob_value = data;
 		blob_size = blobsize;
 	}
-	if (CCD_UPLOAD_MODE_LOCAL_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value) {
+	if (settings->save_local) {
 		char *suffix = "";
 		bool use_avi = false;
 		bool use_ser = false;
-		if (CCD_IMAGE_FORMAT_FITS_ITEM->sw.value) {
+		if (settings->fits_format) {
 			suffix = ".fits";
-		} else if (CCD_IMAGE_FORMAT_XISF_ITEM->sw.value) {
+		} else if (settings->xisf_format) {
 			suffix = ".xisf";
-		} else if (CCD_IMAGE_FORMAT_RAW_ITEM->sw.value) {
+		} else if (settings->raw_format) {
 			suffix = ".raw";
-		} else if (CCD_IMAGE_FORMAT_JPEG_ITEM->sw.value) {
+		} else if (settings->jpeg_format) {
 			suffix = ".jpeg";
-		} else if (CCD_IMAGE_FORMAT_TIFF_ITEM->sw.value) {
+		} else if (settings->tiff_format) {
 			suffix = ".tiff";
-		} else if (CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value) {
+		} else if (settings->jpeg_avi_format) {
 			if (streaming) {
 				suffix = ".avi";
 				use_avi = true;
 			} else {
 				suffix = ".jpeg";
 			}
-		} else if (CCD_IMAGE_FORMAT_RAW_SER_ITEM->sw.value) {
+		} else if (settings->raw_ser_format) {
 			if (streaming) {
 				suffix = ".ser";
 				use_ser = true;
@@ -2011,14 +2199,17 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		int handle = 0;
 		char file_name[INDIGO_VALUE_SIZE] = {0};
 		if (!(use_avi || use_ser) || CCD_CONTEXT->video_stream == NULL) {
-			if (indigo_is_sandboxed || !mkpath(CCD_LOCAL_MODE_DIR_ITEM->text.value)) {
-				if (create_file_name(device, blob_value, blob_size, CCD_LOCAL_MODE_DIR_ITEM->text.value, CCD_LOCAL_MODE_PREFIX_ITEM->text.value, suffix, file_name)) {
+			if (indigo_is_sandboxed || !mkpath(settings->local_dir)) {
+				if (create_file_name(device, settings, blob_value, blob_size, suffix, file_name)) {
 					indigo_copy_value(CCD_IMAGE_FILE_ITEM->text.value, file_name);
 					CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
 					if (use_avi) {
 						CCD_CONTEXT->video_stream = gwavi_open(file_name, frame_width, frame_height, "MJPG", 5);
 					} else if (use_ser) {
 						CCD_CONTEXT->video_stream = indigo_ser_open(file_name, data + FITS_HEADER_SIZE - sizeof(indigo_raw_header));
+						CCD_STREAMING_STATS_SAVED_ITEM->number.value = CCD_STREAMING_STATS_DROPPED_ITEM->number.value = 0;
+						CCD_STREAMING_STATS_PROPERTY->state = INDIGO_BUSY_STATE;
+						indigo_update_property(device, CCD_STREAMING_STATS_PROPERTY, NULL);
 					} else {
 						handle = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
 					}
@@ -2038,10 +2229,17 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 					message = strerror(errno);
 				}
 			} else if (use_ser) {
-				if (!indigo_ser_add_frame((indigo_ser *)(CCD_CONTEXT->video_stream), data + FITS_HEADER_SIZE - sizeof(indigo_raw_header), blobsize + sizeof(indigo_raw_header))) {
+				indigo_ser *ser = (indigo_ser *)(CCD_CONTEXT->video_stream);
+				if (!indigo_ser_add_frame_with_timestamp(ser, data + FITS_HEADER_SIZE - sizeof(indigo_raw_header), blobsize + sizeof(indigo_raw_header), timestamp)) {
 					CCD_IMAGE_FILE_PROPERTY->state = INDIGO_ALERT_STATE;
 					message = strerror(errno);
 				}
+				if (CCD_STREAMING_STATS_DROPPED_ITEM->number.value != ser->dropped) {
+					CCD_STREAMING_STATS_SAVED_ITEM->number.value = ser->count;
+					CCD_STREAMING_STATS_DROPPED_ITEM->number.value = ser->dropped;
+					CCD_STREAMING_STATS_PROPERTY->state = INDIGO_ALERT_STATE;
+					indigo_update_property(device, CCD_STREAMING_STATS_PROPERTY, "Video file writer can't keep up, frames are dropped");
+				}
 			}
 		} else if (handle > 0) {
 			if (!indigo_write(handle, blob_value, blob_size)) {
@@ -2059,19 +2257,19 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, message);
 		INDIGO_DEBUG(indigo_debug("Local save in %gs", (clock() - start) / (double)CLOCKS_PER_SEC));
 	}
-	if (CCD_UPLOAD_MODE_CLIENT_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value) {
+	if (settings->upload_client) {
 		*CCD_IMAGE_ITEM->blob.url = 0;
 		CCD_IMAGE_ITEM->blob.value = blob_value;
 		CCD_IMAGE_ITEM->blob.size = blob_size;
-		if (CCD_IMAGE_FORMAT_FITS_ITEM->sw.value)
+		if (settings->fits_format)
 			strcpy(CCD_IMAGE_ITEM->blob.format, ".fits");
-		else if (CCD_IMAGE_FORMAT_XISF_ITEM->sw.value)
+		else if (settings->xisf_format)
 			strcpy(CCD_IMAGE_ITEM->blob.format, ".xisf");
-		else if (CCD_IMAGE_FORMAT_RAW_ITEM->sw.value || CCD_IMAGE_FORMAT_RAW_SER_ITEM->sw.value)
+		else if (settings->raw_format || settings->raw_ser_format)
 			strcpy(CCD_IMAGE_ITEM->blob.format, ".raw");
-		else if (CCD_IMAGE_FORMAT_JPEG_ITEM->sw.value || CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value)
+		else if (settings->jpeg_format || settings->jpeg_avi_format)
 			strcpy(CCD_IMAGE_ITEM->blob.format, ".jpeg");
-		else if (CCD_IMAGE_FORMAT_TIFF_ITEM->sw.value)
+		else if (settings->tiff_format)
 			strcpy(CCD_IMAGE_ITEM->blob.format, ".tiff");
 		CCD_IMAGE_PROPERTY->state = INDIGO_OK_STATE;
 		indigo_update_property(device, CCD_IMAGE_PROPERTY, NULL);
@@ -2083,6 +2281,237 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		free(histogram_data);
 }
 
+// DSLR RAW files are decoded with reusable per device libraw context directly into reusable FITS_HEADER_SIZE-offset buffer.
+
+static void process_dslr_raw_image(indigo_device *device, image_settings *settings, void *data, int data_size, bool streaming, struct timeval *timestamp) {
+	indigo_dslr_raw_image_s output_image;
+	indigo_dslr_raw_image_info_s image_info;
+	int rc = LIBRAW_UNSPECIFIED_ERROR;
+	if (CCD_CONTEXT->dslr_raw_context == NULL)
+		CCD_CONTEXT->dslr_raw_context = indigo_dslr_raw_init_context();
+	if (CCD_CONTEXT->dslr_raw_context != NULL)
+		rc = indigo_dslr_raw_decode(CCD_CONTEXT->dslr_raw_context, data, data_size, &CCD_CONTEXT->dslr_raw_image, &CCD_CONTEXT->dslr_raw_image_size, FITS_HEADER_SIZE, &output_image, &image_info);
+	if (rc != LIBRAW_SUCCESS) {
+		INDIGO_ERROR(indigo_error("Selected source format cannot be converted"));
+		CCD_IMAGE_PROPERTY->state = INDIGO_ALERT_STATE;
+		indigo_update_property(device, CCD_IMAGE_PROPERTY, "Selected source format cannot be converted, please use camera RAW as a source");
+		return;
+	}
+	indigo_fits_keyword keywords[] = {
+		{ INDIGO_FITS_STRING, "BAYERPAT", .string = output_image.bayer_pattern, "Bayer color pattern" },
+		{ INDIGO_FITS_NUMBER, "ISOSPEED", .number = image_info.iso_speed, "ISO camera setting" },
+		{ 0 }, //Placeholder for trmerature
+		{ 0 }
+	};
+	int index = 2;
+	if (image_info.temperature > -273.15f) {
+		keywords[index++] = (indigo_fits_keyword) { INDIGO_FITS_NUMBER, "CCD-TEMP", .number = image_info.temperature, "CCD temperature [celcius]"};
+	}
+	process_image(device, settings, CCD_CONTEXT->dslr_raw_image, output_image.width, output_image.height, output_image.bits, true, true, keywords, streaming, timestamp);
+}
+
+// Asynchronous image pipeline, frames are copied to a ring of slots and processed in order by a worker thread.
+// Slot buffers are kept and reused, worker is started with the first frame and stopped when the pipeline is disabled.
+
+#define IMAGE_PIPELINE_DEPTH	4
+
+typedef struct {
+	void *data;
+	unsigned long data_size;
+	int frame_width;
+	int frame_height;
+	int bpp;
+	bool little_endian;
+	bool byte_order_rgb;
+	bool streaming;
+	int dslr_raw_size;
+	indigo_fits_keyword *keywords;
+	struct timeval timestamp;
+	image_settings settings;
+} image_pipeline_slot;
+
+typedef struct {
+	indigo_device *device;
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	bool running;
+	int head;
+	int count;
+	image_pipeline_slot slots[IMAGE_PIPELINE_DEPTH];
+} image_pipeline;
+
+static indigo_fits_keyword *copy_keywords(indigo_fits_keyword *keywords) {
+	if (keywords == NULL)
+		return NULL;
+	int count = 0;
+	size_t strings_size = 0;
+	for (indigo_fits_keyword *keyword = keywords; keyword->type; keyword++, count++) {
+		strings_size += strlen(keyword->name) + 1;
+		if (keyword->type == INDIGO_FITS_STRING)
+			strings_size += strlen(keyword->string) + 1;
+		if (keyword->comment)
+			strings_size += strlen(keyword->comment) + 1;
+	}
+	indigo_fits_keyword *copy = indigo_safe_malloc((count + 1) * sizeof(indigo_fits_keyword) + strings_size);
+	char *strings = (char *)(copy + count + 1);
+	for (int i = 0; i < count; i++) {
+		copy[i] = keywords[i];
+		copy[i].name = strcpy(strings, keywords[i].name);
+		strings += strlen(strings) + 1;
+		if (keywords[i].type == INDIGO_FITS_STRING) {
+			copy[i].string = strcpy(strings, keywords[i].string);
+			strings += strlen(strings) + 1;
+		}
+		if (keywords[i].comment) {
+			copy[i].comment = strcpy(strings, keywords[i].comment);
+			strings += strlen(strings) + 1;
+		}
+	}
+	return copy;
+}
+
+static void *image_pipeline_worker(image_pipeline *pipeline) {
+	indigo_device *device = pipeline->device;
+	pthread_mutex_lock(&pipeline->mutex);
+	while (true) {
+		while (pipeline->running && pipeline->count == 0)
+			pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+		if (pipeline->count == 0)
+			break;
+		image_pipeline_slot *slot = pipeline->slots + pipeline->head;
+		pthread_mutex_unlock(&pipeline->mutex);
+		if (slot->dslr_raw_size)
+			process_dslr_raw_image(device, &slot->settings, slot->data, slot->dslr_raw_size, slot->streaming, &slot->timestamp);
+		else
+			process_image(device, &slot->settings, slot->data, slot->frame_width, slot->frame_height, slot->bpp, slot->little_endian, slot->byte_order_rgb, slot->keywords, slot->streaming, &slot->timestamp);
+		indigo_safe_free(slot->keywords);
+		indigo_release_property(slot->settings.fits_headers);
+		pthread_mutex_lock(&pipeline->mutex);
+		pipeline->head = (pipeline->head + 1) % IMAGE_PIPELINE_DEPTH;
+		pipeline->count--;
+		pthread_cond_broadcast(&pipeline->cond);
+	}
+	pthread_mutex_unlock(&pipeline->mutex);
+	return NULL;
+}
+
+static image_pipeline *start_image_pipeline(indigo_device *device) {
+	image_pipeline *pipeline = indigo_safe_malloc(sizeof(image_pipeline));
+	pipeline->device = device;
+	pipeline->running = true;
+	pthread_mutex_init(&pipeline->mutex, NULL);
+	pthread_cond_init(&pipeline->cond, NULL);
+	if (pthread_create(&pipeline->thread, NULL, (void *(*)(void *))image_pipeline_worker, pipeline)) {
+		INDIGO_DRIVER_ERROR(device->name, "Failed to start image pipeline (%s)", strerror(errno));
+		pthread_cond_destroy(&pipeline->cond);
+		pthread_mutex_destroy(&pipeline->mutex);
+		free(pipeline);
+		return NULL;
+	}
+	return CCD_CONTEXT->image_pipeline = pipeline;
+}
+
+static void stop_image_pipeline(indigo_device *device) {
+	image_pipeline *pipeline = CCD_CONTEXT->image_pipeline;
+	if (pipeline == NULL)
+		return;
+	// pending frames are still processed
+	pthread_mutex_lock(&pipeline->mutex);
+	pipeline->running = false;
+	pthread_cond_broadcast(&pipeline->cond);
+	pthread_mutex_unlock(&pipeline->mutex);
+	pthread_join(pipeline->thread, NULL);
+	CCD_CONTEXT->image_pipeline = NULL;
+	for (int i = 0; i < IMAGE_PIPELINE_DEPTH; i++)
+		indigo_safe_free(pipeline->slots[i].data);
+	pthread_cond_destroy(&pipeline->cond);
+	pthread_mutex_destroy(&pipeline->mutex);
+	free(pipeline);
+}
+
+void indigo_wait_for_image_pipeline(indigo_device *device) {
+	image_pipeline *pipeline = CCD_CONTEXT->image_pipeline;
+	if (pipeline == NULL || pthread_equal(pthread_self(), pipeline->thread))
+		return;
+	pthread_mutex_lock(&pipeline->mutex);
+	while (pipeline->count > 0)
+		pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+	pthread_mutex_unlock(&pipeline->mutex);
+}
+
+static image_pipeline *current_image_pipeline(indigo_device *device) {
+	image_pipeline *pipeline = CCD_CONTEXT->image_pipeline;
+	if (CCD_IMAGE_PIPELINE_ENABLED_ITEM->sw.value) {
+		if (pipeline == NULL)
+			pipeline = start_image_pipeline(device);
+	} else if (pipeline != NULL) {
+		stop_image_pipeline(device);
+		pipeline = NULL;
+	}
+	return pipeline;
+}
+
+static image_pipeline_slot *acquire_image_pipeline_slot(indigo_device *device, image_pipeline *pipeline, bool streaming, struct timeval *timestamp, unsigned long data_size) {
+	// settings are captured before waiting for a free slot, FITS headers are copied as they can change any time
+	image_settings settings;
+	capture_image_settings(device, &settings, indigo_copy_property(NULL, CCD_FITS_HEADERS_PROPERTY));
+	pthread_mutex_lock(&pipeline->mutex);
+	if (pipeline->count == IMAGE_PIPELINE_DEPTH) {
+		// back-pressure, readout waits until the oldest frame is processed
+		pthread_mutex_unlock(&pipeline->mutex);
+		indigo_property *property = streaming ? CCD_STREAMING_PROPERTY : CCD_EXPOSURE_PROPERTY;
+		property->state = INDIGO_BUSY_STATE;
+		indigo_update_property(device, property, "Image processing can't keep up, waiting for free buffer");
+		pthread_mutex_lock(&pipeline->mutex);
+		while (pipeline->count == IMAGE_PIPELINE_DEPTH)
+			pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+	}
+	image_pipeline_slot *slot = pipeline->slots + (pipeline->head + pipeline->count) % IMAGE_PIPELINE_DEPTH;
+	pthread_mutex_unlock(&pipeline->mutex);
+	if (slot->data_size < data_size) {
+		indigo_safe_free(slot->data);
+		slot->data = indigo_safe_malloc(slot->data_size = data_size);
+	}
+	slot->streaming = streaming;
+	slot->timestamp = *timestamp;
+	slot->settings = settings;
+	return slot;
+}
+
+static void commit_image_pipeline_slot(image_pipeline *pipeline) {
+	pthread_mutex_lock(&pipeline->mutex);
+	pipeline->count++;
+	pthread_cond_broadcast(&pipeline->cond);
+	pthread_mutex_unlock(&pipeline->mutex);
+}
+
+void indigo_process_image(indigo_device *device, void *data, int frame_width, int frame_height, int bpp, bool little_endian, bool byte_order_rgb, indigo_fits_keyword *keywords, bool streaming) {
+	assert(device != NULL);
+	assert(data != NULL);
+	struct timeval timestamp;
+	gettimeofday(&timestamp, NULL);
+	image_pipeline *pipeline = current_image_pipeline(device);
+	if (pipeline == NULL) {
+		image_settings settings;
+		capture_image_settings(device, &settings, CCD_FITS_HEADERS_PROPERTY);
+		process_image(device, &settings, data, frame_width, frame_height, bpp, little_endian, byte_order_rgb, keywords, streaming, &timestamp);
+		return;
+	}
+	// conversion writes headers in front of and padding behind the pixel data
+	unsigned long pixels_size = (unsigned long)frame_width * frame_height * (bpp / 8);
+	image_pipeline_slot *slot = acquire_image_pipeline_slot(device, pipeline, streaming, &timestamp, pixels_size + 2 * FITS_HEADER_SIZE);
+	memcpy(slot->data + FITS_HEADER_SIZE, data + FITS_HEADER_SIZE, pixels_size);
+	slot->frame_width = frame_width;
+	slot->frame_height = frame_height;
+	slot->bpp = bpp;
+	slot->little_endian = little_endian;
+	slot->byte_order_rgb = byte_order_rgb;
+	slot->dslr_raw_size = 0;
+	slot->keywords = copy_keywords(keywords);
+	commit_image_pipeline_slot(pipeline);
+}
+
 void indigo_process_dslr_image(indigo_device *device, void *data, int data_size, const char *suffix, bool streaming) {
 	assert(device != NULL);
 	assert(data != NULL);
@@ -2093,6 +2522,8 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 		*pnt = tolower(*pnt);
 	if (!strcmp(standard_suffix, ".jpg"))
 		strcpy(standard_suffix, ".jpeg");
+	image_settings settings;
+	capture_image_settings(device, &settings, CCD_FITS_HEADERS_PROPERTY);
 	if (CCD_IMAGE_FORMAT_RAW_ITEM->sw.value && !strcmp(standard_suffix, ".jpeg")) {
 		void *image = NULL;
 		struct indigo_jpeg_decompress_struct cinfo;
@@ -2138,7 +2569,7 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 				char file_name[INDIGO_VALUE_SIZE] = {0};
 				char *message = NULL;
 				if (indigo_is_sandboxed || !mkpath(CCD_LOCAL_MODE_DIR_ITEM->text.value)) {
-					if (create_file_name(device, data, data_size, CCD_LOCAL_MODE_DIR_ITEM->text.value, CCD_LOCAL_MODE_PREFIX_ITEM->text.value, ".raw", file_name)) {
+					if (create_file_name(device, &settings, data, data_size, ".raw", file_name)) {
 						indigo_copy_value(CCD_IMAGE_FILE_ITEM->text.value, file_name);
 						CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
 						int handle = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
@@ -2179,36 +2610,19 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 			return;
 		}
 	} else if (CCD_IMAGE_FORMAT_FITS_ITEM->sw.value || CCD_IMAGE_FORMAT_XISF_ITEM->sw.value || CCD_IMAGE_FORMAT_RAW_ITEM->sw.value) {
-		void *image = NULL;
-		indigo_dslr_raw_image_s output_image = {0};
-		indigo_dslr_raw_image_info_s image_info;
-		int rc;
-		rc = indigo_dslr_raw_image_info((void *)data, data_size, &image_info);
-		if (rc == LIBRAW_SUCCESS) {
-			rc = indigo_dslr_raw_process_image((void *)data, data_size, &output_image);
-		}
-		if (rc != LIBRAW_SUCCESS) {
-			if (output_image.data != NULL) free(output_image.data);
-			INDIGO_ERROR(indigo_error("Selected source format cannot be converted"));
-			CCD_IMAGE_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, CCD_IMAGE_PROPERTY, "Selected source format cannot be converted, please use camera RAW as a source");
-			return;
+		struct timeval timestamp;
+		gettimeofday(&timestamp, NULL);
+		image_pipeline *pipeline = current_image_pipeline(device);
+		if (pipeline == NULL) {
+			process_dslr_raw_image(device, &settings, data, data_size, streaming, &timestamp);
+		} else {
+			// camera file is much smaller than decoded image, it is decoded by pipeline worker
+			image_pipeline_slot *slot = acquire_image_pipeline_slot(device, pipeline, streaming, &timestamp, data_size);
+			memcpy(slot->data, data, data_size);
+			slot->dslr_raw_size = data_size;
+			slot->keywords = NULL;
+			commit_image_pipeline_slot(pipeline);
 		}
-		indigo_fits_keyword keywords[] = {
-			{ INDIGO_FITS_STRING, "BAYERPAT", .string = output_image.bayer_pattern, "Bayer color pattern" },
-			{ INDIGO_FITS_NUMBER, "ISOSPEED", .number = image_info.iso_speed, "ISO camera setting" },
-			{ 0 }, //Placeholder for trmerature
-			{ 0 }
-		};
-		int index = 1;
-		if (image_info.temperature > -273.15f) {
-			keywords[index++] = (indigo_fits_keyword) { INDIGO_FITS_NUMBER, "CCD-TEMP", .number = image_info.temperature, "CCD temperature [celcius]"};
-		}
-		image = indigo_alloc_blob_buffer(output_image.size + FITS_HEADER_SIZE);
-		memcpy(image + FITS_HEADER_SIZE, output_image.data, output_image.size);
-		free(output_image.data);
-		indigo_process_image(device, image, output_image.width, output_image.height, output_image.bits, true, true, keywords, streaming);
-		free(image);
 		return;
 	}
 	if (CCD_UPLOAD_MODE_LOCAL_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value) {
@@ -2222,7 +2636,7 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 		}
 		if (!use_avi || CCD_CONTEXT->video_stream == NULL) {
 			if (indigo_is_sandboxed || !mkpath(CCD_LOCAL_MODE_DIR_ITEM->text.value)) {
-				if (create_file_name(device, data, data_size, CCD_LOCAL_MODE_DIR_ITEM->text.value, CCD_LOCAL_MODE_PREFIX_ITEM->text.value, standard_suffix, file_name)) {
+				if (create_file_name(device, &settings, data, data_size, standard_suffix, file_name)) {
 					indigo_copy_value(CCD_IMAGE_FILE_ITEM->text.value, file_name);
 					CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
 					if (use_avi) {
@@ -2307,6 +2721,7 @@ void indigo_process_dslr_preview_image(indigo_device *device, void *data, int bl
 }
 
 void indigo_finalize_video_stream(indigo_device *device) {
+	indigo_wait_for_image_pipeline(device);
 	if (CCD_CONTEXT->video_stream) {
 		if (CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value) {
 			gwavi_close((struct gwavi_t *)(CCD_CONTEXT->video_stream));
@@ -2314,9 +2729,13 @@ void indigo_finalize_video_stream(indigo_device *device) {
 			CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
 			indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
 		} else if (CCD_IMAGE_FORMAT_RAW_SER_ITEM->sw.value) {
-			indigo_ser_close((indigo_ser *)(CCD_CONTEXT->video_stream));
+			indigo_ser *ser = (indigo_ser *)(CCD_CONTEXT->video_stream);
+			CCD_STREAMING_STATS_SAVED_ITEM->number.value = ser->count;
+			CCD_STREAMING_STATS_DROPPED_ITEM->number.value = ser->dropped;
+			CCD_STREAMING_STATS_PROPERTY->state = ser->dropped ? INDIGO_ALERT_STATE : INDIGO_OK_STATE;
+			CCD_IMAGE_FILE_PROPERTY->state = indigo_ser_close(ser) ? INDIGO_OK_STATE : INDIGO_ALERT_STATE;
 			CCD_CONTEXT->video_stream = NULL;
-			CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
+			indigo_update_property(device, CCD_STREAMING_STATS_PROPERTY, NULL);
 			indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
 		}
 	}
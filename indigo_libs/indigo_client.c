@@ -55,6 +55,9 @@
 
 #include <indigo/indigo_client_xml.h>
 #include <indigo/indigo_client.h>
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+#include <indigo/indigo_binary.h>
+#endif
 
 char *indigo_client_name = NULL;
 
@@ -348,6 +351,7 @@ void indigo_service_name(const char *host, int port, char *name) {
 static void *server_thread(indigo_server_entry *server) {
 	INDIGO_LOG(indigo_log("Server %s:%d thread started", server->host, server->port));
 	pthread_detach(pthread_self());
+	bool binary_refused = false;
 	while (!server->shutdown) {
 		char text[INET_ADDRSTRLEN];
 		struct addrinfo hints = { 0 }, *address = NULL;
@@ -397,6 +401,20 @@ static void *server_thread(indigo_server_entry *server) {
 			strncpy(text, server->host, sizeof(text));
 		}
 		if (server->socket >= 0) {
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+			bool binary = false;
+			if (indigo_use_binary_protocol && !binary_refused) {
+				if (!indigo_binary_connect(server->socket)) {
+					// older server closes the connection, reconnect and use XML
+					INDIGO_LOG(indigo_log("Server %s:%d doesn't support binary protocol", server->host, server->port));
+					binary_refused = true;
+					close(server->socket);
+					server->socket = -1;
+					continue;
+				}
+				binary = true;
+			}
+#endif
 			server->last_error[0] = '\0';
 			if (*server->name == 0) {
 				indigo_service_name(server->host, server->port, server->name);
@@ -407,15 +425,26 @@ static void *server_thread(indigo_server_entry *server) {
 #if defined(INDIGO_WINDOWS)
 			indigo_send_message(server->protocol_adapter, "connected");
 #endif
-			server->protocol_adapter = indigo_xml_client_adapter(server->name, url, server->socket, server->socket);
-			indigo_attach_device(server->protocol_adapter);
-			indigo_xml_parse(server->protocol_adapter, NULL);
-			indigo_detach_device(server->protocol_adapter);
-			if (server->protocol_adapter) {
-				if (server->protocol_adapter->device_context) {
-					free(server->protocol_adapter->device_context);
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+			if (binary) {
+				server->protocol_adapter = indigo_binary_client_adapter(server->name, url, server->socket, server->socket);
+				indigo_attach_device(server->protocol_adapter);
+				indigo_binary_parse(server->protocol_adapter, NULL);
+				indigo_detach_device(server->protocol_adapter);
+				indigo_release_binary_client_adapter(server->protocol_adapter);
+			} else
+#endif
+			{
+				server->protocol_adapter = indigo_xml_client_adapter(server->name, url, server->socket, server->socket);
+				indigo_attach_device(server->protocol_adapter);
+				indigo_xml_parse(server->protocol_adapter, NULL);
+				indigo_detach_device(server->protocol_adapter);
+				if (server->protocol_adapter) {
+					if (server->protocol_adapter->device_context) {
+						free(server->protocol_adapter->device_context);
+					}
+					free(server->protocol_adapter);
 				}
-				free(server->protocol_adapter);
 			}
 			server->protocol_adapter = NULL;
 #if defined(INDIGO_WINDOWS)
@@ -423,6 +452,7 @@ static void *server_thread(indigo_server_entry *server) {
 #else
 			close(server->socket);
 #endif
+			indigo_close_http_connections(text, server->port);
 			INDIGO_LOG(indigo_log("Server %s:%d disconnected", server->host, server->port));
 #if defined(INDIGO_WINDOWS)
 			indigo_send_message(server->protocol_adapter, "disconnected");
@@ -488,7 +488,7 @@ indigo_result indigo_device_change_property(indigo_device *device, indigo_client
 			indigo_item *name_item = PROFILE_NAME_ITEM + i;
 			if (strlen(name_item->text.value) == 0)
 				sprintf(name_item->text.value, "Profile #%d", i);
-			indigo_copy_name(profile_item->label, name_item->text.value);
+			indigo_set_label(profile_item, name_item->text.value);
 		}
 		indigo_define_property(device, PROFILE_PROPERTY, NULL);
 		if (strcmp(client->name, CONFIG_READER)) {
@@ -178,8 +178,9 @@ static indigo_result json_define_property(indigo_client *client, indigo_device *
 			}
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = &property->items[i];
+				char path[INDIGO_NAME_SIZE];
 				if ((property->state == INDIGO_OK_STATE && item->blob.value) || indigo_proxy_blob) {
-					SPRINTF(pnt, "%s { \"name\": \"%s\", \"label\": \"%s\", \"value\": \"/blob/%p%s\" }", i > 0 ? "," : "", item->name, indigo_json_escape(item->label), item, item->blob.format);
+					SPRINTF(pnt, "%s { \"name\": \"%s\", \"label\": \"%s\", \"value\": \"%s%s\" }", i > 0 ? "," : "", item->name, indigo_json_escape(item->label), indigo_blob_path(property, item, false, path, sizeof(path)), item->blob.format);
 				} else if (property->state == INDIGO_OK_STATE && *item->blob.url) {
 					SPRINTF(pnt, "%s { \"name\": \"%s\", \"label\": \"%s\", \"value\": \"%s\" }", i > 0 ? "," : "", item->name, indigo_json_escape(item->label), item->blob.url);
 				} else {
@@ -296,8 +297,9 @@ static indigo_result json_update_property(indigo_client *client, indigo_device *
 			}
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = &property->items[i];
+				char path[INDIGO_NAME_SIZE];
 				if ((property->state == INDIGO_OK_STATE && item->blob.value) || indigo_proxy_blob) {
-					SPRINTF(pnt, "%s { \"name\": \"%s\", \"value\": \"/blob/%p%s\" }", i > 0 ? "," : "", item->name, item, item->blob.format);
+					SPRINTF(pnt, "%s { \"name\": \"%s\", \"value\": \"%s%s\" }", i > 0 ? "," : "", item->name, indigo_blob_path(property, item, true, path, sizeof(path)), item->blob.format);
 				} else if (property->state == INDIGO_OK_STATE && *item->blob.url) {
 					SPRINTF(pnt, "%s { \"name\": \"%s\", \"value\": \"%s\" }", i > 0 ? "," : "", item->name, item->blob.url);
 				} else {
@@ -42,8 +42,11 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <errno.h>
+#include <time.h>
 #include <pthread.h>
 #include <assert.h>
+#include <sys/socket.h>
 
 #include <indigo/indigo_xml.h>
 #include <indigo/indigo_io.h>
@@ -53,29 +56,474 @@
 
 #define RAW_BUF_SIZE 98304
 #define BASE64_BUF_SIZE 131072  /* BASE64_BUF_SIZE >= (RAW_BUF_SIZE + 2) / 3 * 4 */
-#define INDIGO_PRINTF(...) if (!indigo_printf(__VA_ARGS__)) goto failure
+#define LEGACY_RAW_BUF_SIZE 98280
+#define LEGACY_BASE64_BUF_SIZE 132860  /* LEGACY_BASE64_BUF_SIZE >= LEGACY_RAW_BUF_SIZE / 54 * 73 */
+#define TEXT_SEGMENT_SIZE 1024
+
+indigo_xml_blob_policy indigo_xml_blob_queue_policy = INDIGO_XML_BLOB_DROP_OLDEST;
+int indigo_xml_queue_size = 1024;
+int indigo_xml_queue_blob_limit = 2;
+double indigo_xml_queue_timeout = 5;
+
+// Outbound message is rendered to memory by the publishing thread without global lock, BLOB payload is shared by all clients and base64 encoded by the writer thread
+
+typedef struct xml_segment {
+	struct xml_segment *next;
+	char *data;
+	long size;
+	long capacity;
+	indigo_blob_buffer *buffer;
+	bool encode;
+	bool legacy;
+} xml_segment;
+
+typedef struct xml_scratch {
+	struct xml_scratch *next;
+	char data[];
+} xml_scratch;
+
+typedef struct xml_message {
+	struct xml_message *next;
+	xml_segment *head, *tail;
+	xml_scratch *scratch;
+	char device[INDIGO_NAME_SIZE];
+	char name[INDIGO_NAME_SIZE];
+	uint64_t items;
+	bool coalesce;
+	bool blob;
+} xml_message;
+
+typedef struct xml_queue {
+	struct xml_queue *next;
+	indigo_client *client;
+	pthread_mutex_t mutex;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	pthread_t writer;
+	xml_message *head, *tail;
+	int depth;
+	int blobs;
+	bool closed;
+	bool writing;
+	long max_depth;
+	long coalesced;
+	long dropped;
+	long dropped_blobs;
+} xml_queue;
+
+typedef enum {
+	BLOB_INLINE,
+	BLOB_URL,
+	BLOB_SKIP
+} blob_delivery;
 
 static pthread_mutex_t write_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t statistics_mutex = PTHREAD_MUTEX_INITIALIZER;
+static xml_queue *queues = NULL;
+static indigo_xml_queue_statistics released_statistics;
+
+// escaped strings live in message scratch until the message is rendered, escape(message, ) static buffers can't be used by concurrent publishers
+
+static char *scratch_alloc(xml_message *message, long size) {
+	xml_scratch *scratch = indigo_safe_malloc(sizeof(xml_scratch) + size);
+	scratch->next = message->scratch;
+	message->scratch = scratch;
+	return scratch->data;
+}
 
-static const char *message_attribute(const char *message) {
-	if (message) {
-		static char buffer[INDIGO_VALUE_SIZE];
-		snprintf(buffer, INDIGO_VALUE_SIZE, " message='%s'", indigo_xml_escape((char *)message));
+static void release_scratch(xml_message *message) {
+	while (message->scratch) {
+		xml_scratch *next = message->scratch->next;
+		free(message->scratch);
+		message->scratch = next;
+	}
+}
+
+static const char *escape(xml_message *message, const char *string) {
+	if (!strpbrk(string, "&<>\"'"))
+		return string;
+	char *buffer = scratch_alloc(message, 6 * strlen(string) + 1), *out = buffer;
+	for (const char *in = string; *in; in++) {
+		const char *entity;
+		switch (*in) {
+			case '&':
+				entity = "&amp;";
+				break;
+			case '<':
+				entity = "&lt;";
+				break;
+			case '>':
+				entity = "&gt;";
+				break;
+			case '"':
+				entity = "&quot;";
+				break;
+			case '\'':
+				entity = "&apos;";
+				break;
+			default:
+				*out++ = *in;
+				continue;
+		}
+		while (*entity)
+			*out++ = *entity++;
+	}
+	*out = 0;
+	return buffer;
+}
+
+static const char *message_attribute(xml_message *message, const char *text) {
+	if (text) {
+		const char *escaped = escape(message, text);
+		char *buffer = scratch_alloc(message, strlen(escaped) + 12);
+		sprintf(buffer, " message='%s'", escaped);
 		return buffer;
 	}
 	return "";
 }
 
-static const char *hints_attribute(const char *hints) {
+static const char *hints_attribute(xml_message *message, const char *hints) {
 	if (*hints) {
-		static char buffer[INDIGO_VALUE_SIZE];
-		snprintf(buffer, INDIGO_VALUE_SIZE, " hints='%s'", indigo_xml_escape((char *)hints));
+		const char *escaped = escape(message, hints);
+		char *buffer = scratch_alloc(message, strlen(escaped) + 10);
+		sprintf(buffer, " hints='%s'", escaped);
 		return buffer;
 	}
 	return "";
 }
 
-static indigo_result xml_device_adapter_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+static xml_message *create_message(indigo_property *property) {
+	xml_message *message = indigo_safe_malloc(sizeof(xml_message));
+	if (property) {
+		indigo_copy_name(message->device, property->device);
+		indigo_copy_name(message->name, property->name);
+	}
+	return message;
+}
+
+static void release_message(xml_message *message) {
+	release_scratch(message);
+	xml_segment *segment = message->head;
+	while (segment) {
+		xml_segment *next = segment->next;
+		if (segment->buffer)
+			indigo_release_blob_buffer(segment->buffer);
+		else
+			indigo_safe_free(segment->data);
+		free(segment);
+		segment = next;
+	}
+	free(message);
+}
+
+static xml_segment *append_segment(xml_message *message, bool encode) {
+	xml_segment *segment = indigo_safe_malloc(sizeof(xml_segment));
+	segment->encode = encode;
+	if (message->tail)
+		message->tail->next = segment;
+	else
+		message->head = segment;
+	message->tail = segment;
+	return segment;
+}
+
+static void message_printf(xml_message *message, const char *format, ...) {
+	xml_segment *segment = message->tail;
+	if (segment == NULL || segment->encode) {
+		segment = append_segment(message, false);
+		segment->data = indigo_safe_malloc(segment->capacity = TEXT_SEGMENT_SIZE);
+	}
+	while (true) {
+		long available = segment->capacity - segment->size;
+		va_list args;
+		va_start(args, format);
+		long length = vsnprintf(segment->data + segment->size, available, format, args);
+		va_end(args);
+		if (length < available) {
+			segment->size += length;
+			return;
+		}
+		segment->capacity = 2 * (segment->size + length + 1);
+		segment->data = indigo_safe_realloc(segment->data, segment->capacity);
+	}
+}
+
+static void message_blob(xml_message *message, indigo_item *item, bool legacy) {
+	xml_segment *segment = append_segment(message, true);
+	segment->legacy = legacy;
+	if (item->blob.value == NULL || item->blob.size == 0)
+		return;
+	if (item->blob.buffer) {
+		segment->buffer = indigo_retain_blob_buffer(item->blob.buffer);
+		segment->data = item->blob.value;
+		segment->size = item->blob.size;
+		return;
+	}
+	indigo_blob_entry *entry;
+	if (indigo_use_blob_caching && (entry = indigo_validate_blob(item))) {
+		void *content;
+		long size;
+		indigo_blob_buffer *buffer = indigo_retain_blob_content(entry, 0, &content, &size);
+		if (buffer && size == item->blob.size) {
+			segment->buffer = buffer;
+			segment->data = content;
+			segment->size = size;
+			return;
+		}
+		if (buffer)
+			indigo_release_blob_buffer(buffer);
+	}
+	// value is copied once for all clients of this update
+	segment->buffer = indigo_share_blob_value(item);
+	segment->data = segment->buffer->data;
+	segment->size = item->blob.size;
+}
+
+static bool write_message(int handle, xml_message *message, char **buffer) {
+	for (xml_segment *segment = message->head; segment; segment = segment->next) {
+		if (!segment->encode) {
+			if (!indigo_write(handle, segment->data, segment->size))
+				return false;
+			continue;
+		}
+		if (*buffer == NULL)
+			*buffer = indigo_safe_malloc(LEGACY_BASE64_BUF_SIZE);
+		unsigned char *data = (unsigned char *)segment->data;
+		long input_length = segment->size;
+		while (input_length) {
+			long enclen = 0;
+			long len;
+			if (segment->legacy) {
+				/* 54 raw = 72 encoded */
+				len = (LEGACY_RAW_BUF_SIZE < input_length) ? LEGACY_RAW_BUF_SIZE : input_length;
+				for (long i = 0; i < len; i += 54) {
+					enclen += base64_encode((unsigned char *)*buffer + enclen, data + i, (54 < len - i) ? 54 : len - i);
+					(*buffer)[enclen++] = '\n';
+				}
+			} else {
+				len = (RAW_BUF_SIZE < input_length) ? RAW_BUF_SIZE : input_length;
+				enclen = base64_encode((unsigned char *)*buffer, data, len);
+			}
+			if (!indigo_write(handle, *buffer, enclen))
+				return false;
+			input_length -= len;
+			data += len;
+		}
+	}
+	return true;
+}
+
+static void close_connection(indigo_adapter_context *client_context) {
+	pthread_mutex_lock(&write_mutex);
+	if (client_context->output > 0) {
+		if (client_context->output == client_context->input) {
+			close(client_context->input);
+		} else {
+			close(client_context->input);
+			close(client_context->output);
+		}
+		client_context->output = client_context->input = -1;
+	}
+	pthread_mutex_unlock(&write_mutex);
+}
+
+static void remove_message(xml_queue *queue, xml_message *previous, xml_message *message) {
+	if (previous)
+		previous->next = message->next;
+	else
+		queue->head = message->next;
+	if (queue->tail == message)
+		queue->tail = previous;
+	queue->depth--;
+	if (message->blob)
+		queue->blobs--;
+	release_message(message);
+}
+
+static void discard_messages(xml_queue *queue) {
+	while (queue->head)
+		remove_message(queue, NULL, queue->head);
+}
+
+static void *writer_thread(indigo_client *client) {
+	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
+	xml_queue *queue = (xml_queue *)client_context->output_queue;
+	char *buffer = NULL;
+	while (true) {
+		pthread_mutex_lock(&queue->mutex);
+		while (queue->head == NULL && !queue->closed)
+			pthread_cond_wait(&queue->not_empty, &queue->mutex);
+		xml_message *message = queue->head;
+		if (message == NULL) {
+			pthread_mutex_unlock(&queue->mutex);
+			break;
+		}
+		if ((queue->head = message->next) == NULL)
+			queue->tail = NULL;
+		queue->depth--;
+		if (message->blob)
+			queue->blobs--;
+		queue->writing = true;
+		pthread_cond_broadcast(&queue->not_full);
+		pthread_mutex_unlock(&queue->mutex);
+		int handle = client_context->output;
+		bool result = handle > 0 && write_message(handle, message, &buffer);
+		release_message(message);
+		if (!result) {
+			close_connection(client_context);
+			pthread_mutex_lock(&queue->mutex);
+			queue->closed = true;
+			queue->writing = false;
+			discard_messages(queue);
+			pthread_cond_broadcast(&queue->not_full);
+			pthread_mutex_unlock(&queue->mutex);
+			break;
+		}
+		pthread_mutex_lock(&queue->mutex);
+		queue->writing = false;
+		pthread_cond_broadcast(&queue->not_full);
+		pthread_mutex_unlock(&queue->mutex);
+	}
+	indigo_safe_free(buffer);
+	return NULL;
+}
+
+static void deadline(struct timespec *end, double timeout) {
+	clock_gettime(CLOCK_REALTIME, end);
+	end->tv_sec += (int)timeout;
+	end->tv_nsec += 1000000000L * (timeout - (int)timeout);
+	if (end->tv_nsec >= 1000000000L) {
+		end->tv_sec++;
+		end->tv_nsec -= 1000000000L;
+	}
+}
+
+// called with queue->mutex locked, returns false if writer didn't write everything in time
+
+static bool drain_queue(xml_queue *queue) {
+	struct timespec end;
+	deadline(&end, indigo_xml_queue_timeout);
+	while ((queue->head || queue->writing) && pthread_cond_timedwait(&queue->not_full, &queue->mutex, &end) != ETIMEDOUT)
+		;
+	return queue->head == NULL && !queue->writing;
+}
+
+// executable drivers exit without releasing the adapter, messages sent on shutdown are flushed at exit
+
+static void drain_queues_at_exit(void) {
+	pthread_mutex_lock(&statistics_mutex);
+	for (xml_queue *queue = queues; queue; queue = queue->next) {
+		pthread_mutex_lock(&queue->mutex);
+		drain_queue(queue);
+		pthread_mutex_unlock(&queue->mutex);
+	}
+	pthread_mutex_unlock(&statistics_mutex);
+}
+
+static void register_drain_at_exit(void) {
+	atexit(drain_queues_at_exit);
+}
+
+static void enqueue_message(indigo_client *client, xml_message *message) {
+	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
+	xml_queue *queue = (xml_queue *)client_context->output_queue;
+	release_scratch(message);
+	pthread_mutex_lock(&queue->mutex);
+	if (message->coalesce) {
+		// pending update is superseded only if the new one contains all its items (delta updates may not)
+		xml_message *previous = NULL, *pending = queue->head;
+		while (pending) {
+			xml_message *next = pending->next;
+			if (pending->coalesce && (pending->items & message->items) == pending->items && !strcmp(pending->name, message->name) && !strcmp(pending->device, message->device)) {
+				remove_message(queue, previous, pending);
+				queue->coalesced++;
+			} else {
+				previous = pending;
+			}
+			pending = next;
+		}
+	}
+	if (queue->depth >= indigo_xml_queue_size && !queue->closed) {
+		struct timespec end;
+		deadline(&end, indigo_xml_queue_timeout);
+		while (queue->depth >= indigo_xml_queue_size && !queue->closed) {
+			if (pthread_cond_timedwait(&queue->not_full, &queue->mutex, &end) == ETIMEDOUT)
+				break;
+		}
+		if (queue->depth >= indigo_xml_queue_size && !queue->closed) {
+			indigo_error("%s: outbound queue is full, closing connection", client->name);
+			queue->closed = true;
+			queue->dropped += queue->depth;
+			discard_messages(queue);
+			pthread_cond_broadcast(&queue->not_empty);
+			/* unblock writer thread waiting for slow peer */
+			shutdown(client_context->output, SHUT_RDWR);
+		}
+	}
+	if (queue->closed) {
+		queue->dropped++;
+		pthread_mutex_unlock(&queue->mutex);
+		release_message(message);
+		return;
+	}
+	if (queue->tail)
+		queue->tail->next = message;
+	else
+		queue->head = message;
+	queue->tail = message;
+	queue->depth++;
+	if (message->blob)
+		queue->blobs++;
+	if (queue->depth > queue->max_depth)
+		queue->max_depth = queue->depth;
+	pthread_cond_signal(&queue->not_empty);
+	pthread_mutex_unlock(&queue->mutex);
+}
+
+static blob_delivery blob_queue_policy(indigo_client *client) {
+	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
+	xml_queue *queue = (xml_queue *)client_context->output_queue;
+	blob_delivery delivery = BLOB_INLINE;
+	pthread_mutex_lock(&queue->mutex);
+	if (queue->blobs >= indigo_xml_queue_blob_limit) {
+		switch (indigo_xml_blob_queue_policy) {
+			case INDIGO_XML_BLOB_DROP_OLDEST:
+				for (xml_message *previous = NULL, *pending = queue->head; pending; previous = pending, pending = pending->next) {
+					if (pending->blob) {
+						remove_message(queue, previous, pending);
+						queue->dropped_blobs++;
+						break;
+					}
+				}
+				break;
+			case INDIGO_XML_BLOB_BLOCK: {
+				struct timespec end;
+				deadline(&end, indigo_xml_queue_timeout);
+				while (queue->blobs >= indigo_xml_queue_blob_limit && !queue->closed) {
+					if (pthread_cond_timedwait(&queue->not_full, &queue->mutex, &end) == ETIMEDOUT)
+						break;
+				}
+				if (queue->blobs >= indigo_xml_queue_blob_limit) {
+					queue->dropped_blobs++;
+					delivery = BLOB_SKIP;
+				}
+				break;
+			}
+			case INDIGO_XML_BLOB_URL_ONLY:
+				if (client->version >= INDIGO_VERSION_2_0 && indigo_use_blob_urls) {
+					delivery = BLOB_URL;
+				} else {
+					queue->dropped_blobs++;
+					delivery = BLOB_SKIP;
+				}
+				break;
+		}
+	}
+	pthread_mutex_unlock(&queue->mutex);
+	return delivery;
+}
+
+static indigo_result xml_device_adapter_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message_text) {
 	assert(device != NULL);
 	assert(client != NULL);
 	assert(property != NULL);
@@ -84,83 +532,71 @@ static indigo_result xml_device_adapter_define_property(indigo_client *client, i
 	if (client->version == INDIGO_VERSION_NONE)
 		return INDIGO_OK;
 	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
+	assert(client_context != NULL);
 	if (client_context->output <= 0)
 		return INDIGO_OK;
-	pthread_mutex_lock(&write_mutex);
-	assert(client_context != NULL);
-	int handle = client_context->output;
+	xml_message *message = create_message(property);
 	char b1[32], b2[32], b3[32], b4[32], b5[32];
 	switch (property->type) {
 	case INDIGO_TEXT_VECTOR:
-		INDIGO_PRINTF(handle, "<defTextVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_xml_escape(property->group), indigo_xml_escape(property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(property->hints), message_attribute(message));
+		message_printf(message, "<defTextVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", escape(message, property->device), indigo_property_name(client->version, property), escape(message, property->group), escape(message, property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(message, property->hints), message_attribute(message, message_text));
 		for (int i = 0; i < property->count; i++) {
 			indigo_item *item = &property->items[i];
-			INDIGO_PRINTF(handle, "<defText name='%s' label='%s'%s>%s</defText>\n", indigo_item_name(client->version, property, item), indigo_xml_escape(item->label), hints_attribute(item->hints), indigo_xml_escape(indigo_get_text_item_value(item)));
+			message_printf(message, "<defText name='%s' label='%s'%s>%s</defText>\n", indigo_item_name(client->version, property, item), escape(message, item->label), hints_attribute(message, item->hints), escape(message, indigo_get_text_item_value(item)));
 		}
-		INDIGO_PRINTF(handle, "</defTextVector>\n");
+		message_printf(message, "</defTextVector>\n");
 		break;
 	case INDIGO_NUMBER_VECTOR:
-		INDIGO_PRINTF(handle, "<defNumberVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_xml_escape(property->group), indigo_xml_escape(property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(property->hints), message_attribute(message));
+		message_printf(message, "<defNumberVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", escape(message, property->device), indigo_property_name(client->version, property), escape(message, property->group), escape(message, property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(message, property->hints), message_attribute(message, message_text));
 		for (int i = 0; i < property->count; i++) {
 			indigo_item *item = &property->items[i];
 			if (client->version >= INDIGO_VERSION_2_0 && property->perm != INDIGO_RO_PERM) {
-				INDIGO_PRINTF(handle, "<defNumber name='%s' label='%s' format='%s' min='%s' max='%s' step='%s' target='%s'>%s</defNumber>\n", indigo_item_name(client->version, property, item), indigo_xml_escape(item->label), item->number.format, indigo_dtoa(item->number.min, b1), indigo_dtoa(item->number.max, b2), indigo_dtoa(item->number.step, b3), indigo_dtoa(item->number.target, b4), indigo_dtoa(item->number.value, b5));
+				message_printf(message, "<defNumber name='%s' label='%s' format='%s' min='%s' max='%s' step='%s' target='%s'>%s</defNumber>\n", indigo_item_name(client->version, property, item), escape(message, item->label), item->number.format, indigo_dtoa(item->number.min, b1), indigo_dtoa(item->number.max, b2), indigo_dtoa(item->number.step, b3), indigo_dtoa(item->number.target, b4), indigo_dtoa(item->number.value, b5));
 			} else {
-				INDIGO_PRINTF(handle, "<defNumber name='%s' label='%s'%s format='%s' min='%s' max='%s' step='%s'>%s</defNumber>\n", indigo_item_name(client->version, property, item), indigo_xml_escape(item->label), hints_attribute(item->hints), item->number.format, indigo_dtoa(item->number.min, b1), indigo_dtoa(item->number.max, b2), indigo_dtoa(item->number.step, b3), indigo_dtoa(item->number.value, b4));
+				message_printf(message, "<defNumber name='%s' label='%s'%s format='%s' min='%s' max='%s' step='%s'>%s</defNumber>\n", indigo_item_name(client->version, property, item), escape(message, item->label), hints_attribute(message, item->hints), item->number.format, indigo_dtoa(item->number.min, b1), indigo_dtoa(item->number.max, b2), indigo_dtoa(item->number.step, b3), indigo_dtoa(item->number.value, b4));
 			}
 		}
-		INDIGO_PRINTF(handle, "</defNumberVector>\n");
+		message_printf(message, "</defNumberVector>\n");
 		break;
 	case INDIGO_SWITCH_VECTOR:
-		INDIGO_PRINTF(handle, "<defSwitchVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s' rule='%s'%s%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_xml_escape(property->group), indigo_xml_escape(property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], indigo_switch_rule_text[property->rule], hints_attribute(property->hints), message_attribute(message));
+		message_printf(message, "<defSwitchVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s' rule='%s'%s%s>\n", escape(message, property->device), indigo_property_name(client->version, property), escape(message, property->group), escape(message, property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], indigo_switch_rule_text[property->rule], hints_attribute(message, property->hints), message_attribute(message, message_text));
 		for (int i = 0; i < property->count; i++) {
 			indigo_item *item = &property->items[i];
-			INDIGO_PRINTF(handle, "<defSwitch name='%s' label='%s'%s>%s</defSwitch>\n", indigo_item_name(client->version, property, item), indigo_xml_escape(item->label), hints_attribute(item->hints), item->sw.value ? "On" : "Off");
+			message_printf(message, "<defSwitch name='%s' label='%s'%s>%s</defSwitch>\n", indigo_item_name(client->version, property, item), escape(message, item->label), hints_attribute(message, item->hints), item->sw.value ? "On" : "Off");
 		}
-		INDIGO_PRINTF(handle, "</defSwitchVector>\n");
+		message_printf(message, "</defSwitchVector>\n");
 		break;
 	case INDIGO_LIGHT_VECTOR:
-		INDIGO_PRINTF(handle, "<defLightVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_xml_escape(property->group), indigo_xml_escape(property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(property->hints), message_attribute(message));
+		message_printf(message, "<defLightVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", escape(message, property->device), indigo_property_name(client->version, property), escape(message, property->group), escape(message, property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(message, property->hints), message_attribute(message, message_text));
 		for (int i = 0; i < property->count; i++) {
 			indigo_item *item = &property->items[i];
-			INDIGO_PRINTF(handle, " <defLight name='%s' label='%s'%s>%s</defLight>\n", indigo_item_name(client->version, property, item), indigo_xml_escape(item->label), hints_attribute(item->hints), indigo_property_state_text[item->light.value]);
+			message_printf(message, " <defLight name='%s' label='%s'%s>%s</defLight>\n", indigo_item_name(client->version, property, item), escape(message, item->label), hints_attribute(message, item->hints), indigo_property_state_text[item->light.value]);
 		}
-		INDIGO_PRINTF(handle, "</defLightVector>\n");
+		message_printf(message, "</defLightVector>\n");
 		break;
 	case INDIGO_BLOB_VECTOR:
-		INDIGO_PRINTF(handle, "<defBLOBVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_xml_escape(property->group), indigo_xml_escape(property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(property->hints), message_attribute(message));
+		message_printf(message, "<defBLOBVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", escape(message, property->device), indigo_property_name(client->version, property), escape(message, property->group), escape(message, property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(message, property->hints), message_attribute(message, message_text));
 		for (int i = 0; i < property->count; i++) {
 			indigo_item *item = &property->items[i];
 			if (property->perm == INDIGO_WO_PERM && client->version >= INDIGO_VERSION_2_0) {
 				if (item->blob.url[0] == 0 || indigo_proxy_blob) {
-					INDIGO_PRINTF(handle, "<defBLOB name='%s' path='/blob/%p' label='%s'%s/>\n", indigo_item_name(client->version, property, item), item, indigo_xml_escape(item->label), hints_attribute(item->hints));
+					char path[INDIGO_NAME_SIZE];
+					message_printf(message, "<defBLOB name='%s' path='%s' label='%s'%s/>\n", indigo_item_name(client->version, property, item), indigo_blob_path(property, item, false, path, sizeof(path)), escape(message, item->label), hints_attribute(message, item->hints));
 				} else {
-					INDIGO_PRINTF(handle, "<defBLOB name='%s' url='%s' label='%s'%s/>\n", indigo_item_name(client->version, property, item), item->blob.url, indigo_xml_escape(item->label), hints_attribute(item->hints));
+					message_printf(message, "<defBLOB name='%s' url='%s' label='%s'%s/>\n", indigo_item_name(client->version, property, item), item->blob.url, escape(message, item->label), hints_attribute(message, item->hints));
 				}
 			} else {
-				INDIGO_PRINTF(handle, "<defBLOB name='%s' label='%s'%s/>\n", indigo_item_name(client->version, property, item), indigo_xml_escape(item->label), hints_attribute(item->hints));
+				message_printf(message, "<defBLOB name='%s' label='%s'%s/>\n", indigo_item_name(client->version, property, item), escape(message, item->label), hints_attribute(message, item->hints));
 			}
 		}
-		INDIGO_PRINTF(handle, "</defBLOBVector>\n");
+		message_printf(message, "</defBLOBVector>\n");
 		break;
 	}
-	pthread_mutex_unlock(&write_mutex);
-	return INDIGO_OK;
-failure:
-	if (client_context->output == client_context->input) {
-		close(client_context->input);
-	} else {
-		close(client_context->input);
-		close(client_context->output);
-	}
-	client_context->output = client_context->input = -1;
-	pthread_mutex_unlock(&write_mutex);
+	enqueue_message(client, message);
 	return INDIGO_OK;
 }
 
-static indigo_result xml_device_adapter_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
-	FILE* fh;
-	int handle2;
+static indigo_result xml_device_adapter_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message_text) {
 	assert(device != NULL);
 	assert(client != NULL);
 	assert(property != NULL);
@@ -169,123 +605,115 @@ static indigo_result xml_device_adapter_update_property(indigo_client *client, i
 	if (client->version == INDIGO_VERSION_NONE)
 		return INDIGO_OK;
 	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
+	assert(client_context != NULL);
 	if (client_context->output <= 0)
 		return INDIGO_OK;
-	pthread_mutex_lock(&write_mutex);
-	assert(client_context != NULL);
-	int handle = client_context->output;
+	blob_delivery delivery = BLOB_INLINE;
+	indigo_enable_blob_mode mode = INDIGO_ENABLE_BLOB_NEVER;
+	if (property->type == INDIGO_BLOB_VECTOR) {
+		indigo_enable_blob_mode_record *record = client->enable_blob_mode_records;
+		while (record) {
+			if ((*record->device == 0 || !strcmp(property->device, record->device)) && (*record->name == 0 || !strcmp(property->name, record->name))) {
+				mode = record->mode;
+				break;
+			}
+			record = record->next;
+		}
+		if (mode == INDIGO_ENABLE_BLOB_NEVER)
+			return INDIGO_OK;
+		if (property->state == INDIGO_OK_STATE && (mode != INDIGO_ENABLE_BLOB_URL || client->version < INDIGO_VERSION_2_0)) {
+			delivery = blob_queue_policy(client);
+			if (delivery == BLOB_SKIP)
+				return INDIGO_OK;
+		}
+	}
+	xml_message *message = create_message(property);
+	message->coalesce = message_text == NULL && (property->type == INDIGO_NUMBER_VECTOR || property->type == INDIGO_SWITCH_VECTOR || property->type == INDIGO_LIGHT_VECTOR);
+	bool delta = indigo_use_delta_updates && property->changed != NULL;
+	message->items = ~(uint64_t)0;
+	if (delta) {
+		// the last bit stands for all items above 63
+		message->items = 0;
+		for (int i = 0; i < property->count; i++) {
+			if (indigo_item_changed(property, property->items + i))
+				message->items |= (uint64_t)1 << (i < 63 ? i : 63);
+		}
+	}
 	char b1[32], b2[32];
 	switch (property->type) {
 		case INDIGO_TEXT_VECTOR:
-			INDIGO_PRINTF(handle, "<setTextVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
+			message_printf(message, "<setTextVector device='%s' name='%s' state='%s'%s>\n", escape(message, property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message, message_text));
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = &property->items[i];
-				INDIGO_PRINTF(handle, "<oneText name='%s'>%s</oneText>\n", indigo_item_name(client->version, property, item), indigo_xml_escape(indigo_get_text_item_value(item)));
+				if (delta && !indigo_item_changed(property, item))
+					continue;
+				message_printf(message, "<oneText name='%s'>%s</oneText>\n", indigo_item_name(client->version, property, item), escape(message, indigo_get_text_item_value(item)));
 			}
-			INDIGO_PRINTF(handle, "</setTextVector>\n");
+			message_printf(message, "</setTextVector>\n");
 			break;
 		case INDIGO_NUMBER_VECTOR:
-			INDIGO_PRINTF(handle, "<setNumberVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
+			message_printf(message, "<setNumberVector device='%s' name='%s' state='%s'%s>\n", escape(message, property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message, message_text));
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = &property->items[i];
+				if (delta && !indigo_item_changed(property, item))
+					continue;
 				if (client->version >= INDIGO_VERSION_2_0 && property->perm != INDIGO_RO_PERM) {
-					INDIGO_PRINTF(handle, "<oneNumber name='%s' target='%s'>%s</oneNumber>\n", indigo_item_name(client->version, property, item), indigo_dtoa(item->number.target, b1), indigo_dtoa(item->number.value, b2));
+					message_printf(message, "<oneNumber name='%s' target='%s'>%s</oneNumber>\n", indigo_item_name(client->version, property, item), indigo_dtoa(item->number.target, b1), indigo_dtoa(item->number.value, b2));
 				} else {
-					INDIGO_PRINTF(handle, "<oneNumber name='%s'>%s</oneNumber>\n", indigo_item_name(client->version, property, item), indigo_dtoa(item->number.value, b1));
+					message_printf(message, "<oneNumber name='%s'>%s</oneNumber>\n", indigo_item_name(client->version, property, item), indigo_dtoa(item->number.value, b1));
 				}
 			}
-			INDIGO_PRINTF(handle, "</setNumberVector>\n");
+			message_printf(message, "</setNumberVector>\n");
 			break;
 		case INDIGO_SWITCH_VECTOR:
-			INDIGO_PRINTF(handle, "<setSwitchVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
+			message_printf(message, "<setSwitchVector device='%s' name='%s' state='%s'%s>\n", escape(message, property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message, message_text));
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = &property->items[i];
-				INDIGO_PRINTF(handle, "<oneSwitch name='%s'>%s</oneSwitch>\n", indigo_item_name(client->version, property, item), item->sw.value ? "On" : "Off");
+				if (delta && !indigo_item_changed(property, item))
+					continue;
+				message_printf(message, "<oneSwitch name='%s'>%s</oneSwitch>\n", indigo_item_name(client->version, property, item), item->sw.value ? "On" : "Off");
 			}
-			INDIGO_PRINTF(handle, "</setSwitchVector>\n");
+			message_printf(message, "</setSwitchVector>\n");
 			break;
 		case INDIGO_LIGHT_VECTOR:
-			INDIGO_PRINTF(handle, "<setLightVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
+			message_printf(message, "<setLightVector device='%s' name='%s' state='%s'%s>\n", escape(message, property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message, message_text));
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = &property->items[i];
-				INDIGO_PRINTF(handle, "<oneLight name='%s'>%s</oneLight>\n", indigo_item_name(client->version, property, item), indigo_property_state_text[item->light.value]);
+				if (delta && !indigo_item_changed(property, item))
+					continue;
+				message_printf(message, "<oneLight name='%s'>%s</oneLight>\n", indigo_item_name(client->version, property, item), indigo_property_state_text[item->light.value]);
 			}
-			INDIGO_PRINTF(handle, "</setLightVector>\n");
+			message_printf(message, "</setLightVector>\n");
 			break;
 		case INDIGO_BLOB_VECTOR: {
-			indigo_enable_blob_mode mode = INDIGO_ENABLE_BLOB_NEVER;
-			indigo_enable_blob_mode_record *record = client->enable_blob_mode_records;
-			while (record) {
-				if ((*record->device == 0 || !strcmp(property->device, record->device)) && (*record->name == 0 || !strcmp(property->name, record->name))) {
-					mode = record->mode;
-					break;
-				}
-				record = record->next;
-			}
-			if (mode != INDIGO_ENABLE_BLOB_NEVER) {
-				INDIGO_PRINTF(handle, "<setBLOBVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
-				if (property->state == INDIGO_OK_STATE) {
-					for (int i = 0; i < property->count; i++) {
-						indigo_item *item = &property->items[i];
-						if (mode == INDIGO_ENABLE_BLOB_URL && client->version >= INDIGO_VERSION_2_0) {
-							if (item->blob.value || indigo_proxy_blob) {
-								INDIGO_PRINTF(handle, "<oneBLOB name='%s' path='/blob/%p%s'/>\n", indigo_item_name(client->version, property, item), item, item->blob.format);
-							} else {
-								INDIGO_PRINTF(handle, "<oneBLOB name='%s' url='%s'/>\n", indigo_item_name(client->version, property, item), item->blob.url);
-							}
+			message_printf(message, "<setBLOBVector device='%s' name='%s' state='%s'%s>\n", escape(message, property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message, message_text));
+			if (property->state == INDIGO_OK_STATE) {
+				for (int i = 0; i < property->count; i++) {
+					indigo_item *item = &property->items[i];
+					if ((mode == INDIGO_ENABLE_BLOB_URL || delivery == BLOB_URL) && client->version >= INDIGO_VERSION_2_0) {
+						if (item->blob.value || indigo_proxy_blob) {
+							char path[INDIGO_NAME_SIZE];
+							message_printf(message, "<oneBLOB name='%s' path='%s%s'/>\n", indigo_item_name(client->version, property, item), indigo_blob_path(property, item, true, path, sizeof(path)), item->blob.format);
 						} else {
-							long input_length = item->blob.size;
-							unsigned char *data = item->blob.value;
-							INDIGO_PRINTF(handle, "<oneBLOB name='%s' format='%s' size='%ld'>\n", indigo_item_name(client->version, property, item), item->blob.format, item->blob.size);
-							handle2 = dup(handle);
-							fh = fdopen(handle2, "w");
-							if (client->version >= INDIGO_VERSION_2_0) {
-								while (input_length) {
-									char encoded_data[BASE64_BUF_SIZE + 1];
-									long len = (RAW_BUF_SIZE < input_length) ?  RAW_BUF_SIZE : input_length;
-									long enclen = base64_encode((unsigned char*)encoded_data, (unsigned char*)data, len);
-									fwrite(encoded_data, 1, enclen, fh);
-									input_length -= len;
-									data += len;
-								}
-							} else {
-								static char encoded_data[74];
-								while (input_length) {
-									/* 54 raw = 72 encoded */
-									long len = (54 < input_length) ?  54 : input_length;
-									long enclen = base64_encode((unsigned char*)encoded_data, (unsigned char*)data, len);
-									encoded_data[enclen] = '\n';
-									fwrite(encoded_data, 1, enclen, fh);
-									input_length -= len;
-									data += len;
-								}
-							}
-							fflush(fh);
-							fclose(fh);
-							INDIGO_PRINTF(handle, "</oneBLOB>\n");
+							message_printf(message, "<oneBLOB name='%s' url='%s'/>\n", indigo_item_name(client->version, property, item), item->blob.url);
 						}
+					} else {
+						message_printf(message, "<oneBLOB name='%s' format='%s' size='%ld'>\n", indigo_item_name(client->version, property, item), item->blob.format, item->blob.size);
+						message_blob(message, item, client->version < INDIGO_VERSION_2_0);
+						message_printf(message, "</oneBLOB>\n");
+						message->blob = true;
 					}
 				}
-				INDIGO_PRINTF(handle, "</setBLOBVector>\n");
 			}
+			message_printf(message, "</setBLOBVector>\n");
 			break;
 		}
 	}
-	pthread_mutex_unlock(&write_mutex);
-	return INDIGO_OK;
-failure:
-	if (client_context->output == client_context->input) {
-		close(client_context->input);
-	} else {
-		close(client_context->input);
-		close(client_context->output);
-	}
-	client_context->output = client_context->input = -1;
-	pthread_mutex_unlock(&write_mutex);
+	enqueue_message(client, message);
 	return INDIGO_OK;
 }
 
-static indigo_result xml_device_adapter_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+static indigo_result xml_device_adapter_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message_text) {
 	assert(device != NULL);
 	assert(client != NULL);
 	assert(property != NULL);
@@ -294,31 +722,20 @@ static indigo_result xml_device_adapter_delete_property(indigo_client *client, i
 	if (client->version == INDIGO_VERSION_NONE)
 		return INDIGO_OK;
 	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
+	assert(client_context != NULL);
 	if (client_context->output <= 0)
 		return INDIGO_OK;
-	pthread_mutex_lock(&write_mutex);
-	assert(client_context != NULL);
-	int handle = client_context->output;
+	xml_message *message = create_message(NULL);
 	if (*property->name) {
-		INDIGO_PRINTF(handle, "<delProperty device='%s' name='%s'%s/>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), message_attribute(message));
+		message_printf(message, "<delProperty device='%s' name='%s'%s/>\n", escape(message, property->device), indigo_property_name(client->version, property), message_attribute(message, message_text));
 	} else {
-		INDIGO_PRINTF(handle, "<delProperty device='%s'%s/>\n", device->name, message_attribute(message));
+		message_printf(message, "<delProperty device='%s'%s/>\n", device->name, message_attribute(message, message_text));
 	}
-	pthread_mutex_unlock(&write_mutex);
-	return INDIGO_OK;
-failure:
-	if (client_context->output == client_context->input) {
-		close(client_context->input);
-	} else {
-		close(client_context->input);
-		close(client_context->output);
-	}
-	client_context->output = client_context->input = -1;
-	pthread_mutex_unlock(&write_mutex);
+	enqueue_message(client, message);
 	return INDIGO_OK;
 }
 
-static indigo_result xml_device_adapter_send_message(indigo_client *client, indigo_device *device, const char *message) {
+static indigo_result xml_device_adapter_send_message(indigo_client *client, indigo_device *device, const char *message_text) {
 	assert(device != NULL);
 	assert(client != NULL);
 	if (!indigo_reshare_remote_devices && device->is_remote)
@@ -326,30 +743,58 @@ static indigo_result xml_device_adapter_send_message(indigo_client *client, indi
 	if (client->version == INDIGO_VERSION_NONE)
 		return INDIGO_OK;
 	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
-	if (client_context->output <= 0)
-		return INDIGO_OK;
-	pthread_mutex_lock(&write_mutex);
 	assert(client_context != NULL);
-	int handle = client_context->output;
-	if (message) {
-		if (device) {
-			INDIGO_PRINTF(handle, "<message device='%s'%s/>\n", device->name, message_attribute(message));
-		} else {
-			INDIGO_PRINTF(handle, "<message%s/>\n", message_attribute(message));
-		}
+	if (client_context->output <= 0 || message_text == NULL)
+		return INDIGO_OK;
+	xml_message *message = create_message(NULL);
+	if (device) {
+		message_printf(message, "<message device='%s'%s/>\n", device->name, message_attribute(message, message_text));
+	} else {
+		message_printf(message, "<message%s/>\n", message_attribute(message, message_text));
 	}
-	pthread_mutex_unlock(&write_mutex);
+	enqueue_message(client, message);
 	return INDIGO_OK;
-failure:
-	if (client_context->output == client_context->input) {
-		close(client_context->input);
+}
+
+bool indigo_xml_device_adapter_printf(indigo_client *client, const char *format, ...) {
+	assert(client != NULL);
+	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
+	assert(client_context != NULL);
+	char *buffer = indigo_alloc_large_buffer();
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(buffer, INDIGO_BUFFER_SIZE, format, args);
+	va_end(args);
+	bool result;
+	if (client_context->output_queue) {
+		xml_message *message = create_message(NULL);
+		message_printf(message, "%s", buffer);
+		enqueue_message(client, message);
+		result = true;
 	} else {
-		close(client_context->input);
-		close(client_context->output);
+		result = indigo_write(client_context->output, buffer, length);
 	}
-	client_context->output = client_context->input = -1;
-	pthread_mutex_unlock(&write_mutex);
-	return INDIGO_OK;
+	indigo_free_large_buffer(buffer);
+	return result;
+}
+
+void indigo_get_xml_queue_statistics(indigo_xml_queue_statistics *statistics) {
+	pthread_mutex_lock(&statistics_mutex);
+	*statistics = released_statistics;
+	statistics->clients = 0;
+	statistics->depth = 0;
+	for (xml_queue *queue = queues; queue; queue = queue->next) {
+		pthread_mutex_lock(&queue->mutex);
+		statistics->clients++;
+		statistics->depth += queue->depth;
+		if (queue->max_depth > statistics->max_depth)
+			statistics->max_depth = queue->max_depth;
+		statistics->coalesced += queue->coalesced;
+		statistics->dropped += queue->dropped;
+		statistics->dropped_blobs += queue->dropped_blobs;
+		pthread_mutex_unlock(&queue->mutex);
+	}
+	pthread_mutex_unlock(&statistics_mutex);
 }
 
 indigo_client *indigo_xml_device_adapter(int input, int ouput) {
@@ -369,12 +814,71 @@ indigo_client *indigo_xml_device_adapter(int input, int ouput) {
 	client_context->output = ouput;
 	client->client_context = client_context;
 	client->is_remote = input == ouput;
+	xml_queue *queue = indigo_safe_malloc(sizeof(xml_queue));
+	queue->client = client;
+	pthread_mutex_init(&queue->mutex, NULL);
+	pthread_cond_init(&queue->not_empty, NULL);
+	pthread_cond_init(&queue->not_full, NULL);
+	client_context->output_queue = queue;
+	if (pthread_create(&queue->writer, NULL, (void * (*)(void*))writer_thread, client) != 0) {
+		indigo_error("%s: failed to start writer thread, falling back to synchronous output", client->name);
+		pthread_cond_destroy(&queue->not_full);
+		pthread_cond_destroy(&queue->not_empty);
+		pthread_mutex_destroy(&queue->mutex);
+		free(queue);
+		client_context->output_queue = NULL;
+		return client;
+	}
+	static pthread_once_t drain_at_exit_once = PTHREAD_ONCE_INIT;
+	pthread_once(&drain_at_exit_once, register_drain_at_exit);
+	pthread_mutex_lock(&statistics_mutex);
+	queue->next = queues;
+	queues = queue;
+	pthread_mutex_unlock(&statistics_mutex);
 	return client;
 }
 
 void indigo_release_xml_device_adapter(indigo_client *client) {
 	assert(client != NULL);
 	assert(client->client_context != NULL);
+	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
+	xml_queue *queue = (xml_queue *)client_context->output_queue;
+	if (queue) {
+		// pending messages (e.g. final deleteProperty messages of executable driver) are flushed first, slow peer gets indigo_xml_queue_timeout
+		pthread_mutex_lock(&queue->mutex);
+		queue->closed = true;
+		pthread_cond_broadcast(&queue->not_empty);
+		bool flushed = drain_queue(queue);
+		if (!flushed) {
+			queue->dropped += queue->depth;
+			discard_messages(queue);
+		}
+		pthread_cond_broadcast(&queue->not_full);
+		pthread_mutex_unlock(&queue->mutex);
+		pthread_mutex_lock(&statistics_mutex);
+		for (xml_queue **previous = &queues; *previous; previous = &(*previous)->next) {
+			if (*previous == queue) {
+				*previous = queue->next;
+				break;
+			}
+		}
+		pthread_mutex_lock(&queue->mutex);
+		if (queue->max_depth > released_statistics.max_depth)
+			released_statistics.max_depth = queue->max_depth;
+		released_statistics.coalesced += queue->coalesced;
+		released_statistics.dropped += queue->dropped;
+		released_statistics.dropped_blobs += queue->dropped_blobs;
+		pthread_mutex_unlock(&queue->mutex);
+		pthread_mutex_unlock(&statistics_mutex);
+		/* peer doesn't read, don't let the message in flight block the join */
+		if (!flushed && client->is_remote && client_context->output > 0)
+			shutdown(client_context->output, SHUT_RDWR);
+		pthread_join(queue->writer, NULL);
+		pthread_cond_destroy(&queue->not_full);
+		pthread_cond_destroy(&queue->not_empty);
+		pthread_mutex_destroy(&queue->mutex);
+		free(queue);
+	}
 	indigo_enable_blob_mode_record *blob_record = client->enable_blob_mode_records;
 	while (blob_record) {
 		client->enable_blob_mode_records = blob_record->next;
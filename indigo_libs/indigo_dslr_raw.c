@@ -89,8 +89,7 @@ cleanup:
 	return rc;
 }
 
-static int image_bayered_data(libraw_data_t *raw_data, indigo_dslr_raw_image_s *outout_image, const bool binning) {
-	uint16_t *data;
+static int image_bayered_data(libraw_data_t *raw_data, indigo_dslr_raw_image_s *outout_image, const bool binning, uint16_t *data) {
 	uint16_t width, height, raw_width;
 	uint32_t npixels;
 	uint32_t offset;
@@ -115,15 +114,32 @@ static int image_bayered_data(libraw_data_t *raw_data, indigo_dslr_raw_image_s *
 		raw_data->rawdata.sizes.left_margin;
 	size = binning ? npixels / 4 * sizeof(uint16_t) : npixels * sizeof(uint16_t);
 
-	data = (uint16_t *)calloc(1, size);
-	if (!data) {
-		indigo_error("%s", strerror(errno));
-		return -errno;
+	if (data == NULL) {
+		data = (uint16_t *)calloc(1, size);
+		if (!data) {
+			indigo_error("%s", strerror(errno));
+			return -errno;
+		}
 	}
 	outout_image->width = binning ? width / 2 : width;
 	outout_image->height = binning ? height / 2 : height;
 	outout_image->size = size;
 
+	outout_image->data = data;
+	outout_image->colors = 1;
+
+	if (!binning) {
+		/* whole rows are copied, visible area is contiguous in each row of the raw image */
+		for (int row = 0; row < height; row++) {
+#ifdef FIT_FORMAT_AMATEUR_CCD
+			memcpy(data + row * width, raw_data->rawdata.raw_image + offset + raw_width * row, width * sizeof(uint16_t));
+#else
+			memcpy(data + row * width, raw_data->rawdata.raw_image + offset + raw_width * (height - 1 - row), width * sizeof(uint16_t));
+#endif
+		}
+		return 0;
+	}
+
 	int c = binning ? 2 : 1;
 #ifdef FIT_FORMAT_AMATEUR_CCD
 	for (int row = 0; row < height; row += c) {
@@ -144,31 +160,10 @@ static int image_bayered_data(libraw_data_t *raw_data, indigo_dslr_raw_image_s *
 		}
 	}
 
-	outout_image->data = data;
-	outout_image->colors = 1;
-
 	return 0;
 }
 
-int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_raw_image_s *outout_image) {
-	int rc;
-	libraw_data_t *raw_data;
-
-	outout_image->width = 0;
-	outout_image->height = 0;
-	outout_image->bits = 16;
-	outout_image->colors = 0;
-	outout_image->colors = false;
-	memset(outout_image->bayer_pattern, 0, sizeof(outout_image->bayer_pattern));
-	outout_image->size = 0;
-	outout_image->data = NULL;
-
-#if !defined(INDIGO_WINDOWS)
-	clock_t start = clock();
-#endif
-
-	raw_data = libraw_init(0);
-
+static void set_params(libraw_data_t *raw_data) {
 	/* These work fine for astro - change with caution */
 	/* Linear 16-bit output. */
 	raw_data->params.output_bps = 16;
@@ -188,6 +183,63 @@ int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_
 	raw_data->params.use_camera_wb = 1;
 	/* Output colorspace raw*/
 	raw_data->params.output_color = 0;
+}
+
+static void set_bayer_pattern(libraw_data_t *raw_data, indigo_dslr_raw_image_s *outout_image) {
+	outout_image->bayer_pattern[0] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 2, 2)];
+	outout_image->bayer_pattern[1] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 2, 3)];
+	outout_image->bayer_pattern[2] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 3, 2)];
+	outout_image->bayer_pattern[3] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 3, 3)];
+	outout_image->bayer_pattern[4] = 0;
+}
+
+static void get_image_info(libraw_data_t *raw_data, indigo_dslr_raw_image_info_s *image_info) {
+	strncpy(image_info->camera_make, raw_data->idata.make, sizeof(image_info->camera_make));
+	strncpy(image_info->camera_model, raw_data->idata.model, sizeof(image_info->camera_model));
+	strncpy(image_info->normalized_camera_make, raw_data->idata.normalized_make, sizeof(image_info->normalized_camera_make));
+	strncpy(image_info->normalized_camera_model, raw_data->idata.normalized_model, sizeof(image_info->normalized_camera_model));
+	strncpy(image_info->lens, raw_data->lens.Lens, sizeof(image_info->lens));
+	strncpy(image_info->lens_make, raw_data->lens.LensMake, sizeof(image_info->lens_make));
+	image_info->raw_height = raw_data->sizes.raw_height;
+	image_info->raw_width = raw_data->sizes.raw_width;
+	image_info->iheight = raw_data->sizes.iheight;
+	image_info->iwidth = raw_data->sizes.iwidth;
+	image_info->top_margin = raw_data->sizes.top_margin;
+	image_info->left_margin = raw_data->sizes.left_margin;
+	image_info->iso_speed = raw_data->other.iso_speed;
+	image_info->shutter = raw_data->other.shutter;
+	image_info->aperture = raw_data->other.aperture;
+	image_info->focal_len = raw_data->other.focal_len;
+	image_info->timestamp = raw_data->other.timestamp;
+	image_info->temperature = -273.15f;
+	if (raw_data->makernotes.common.SensorTemperature > -273.15f) {
+		 image_info->temperature = raw_data->makernotes.common.SensorTemperature;
+	} else if (raw_data->makernotes.common.CameraTemperature > -273.15f) {
+		 image_info->temperature = raw_data->makernotes.common.CameraTemperature;
+	}
+	strncpy(image_info->desc, raw_data->other.desc, sizeof(image_info->desc));
+	strncpy(image_info->artist, raw_data->other.artist, sizeof(image_info->artist));
+}
+
+int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_raw_image_s *outout_image) {
+	int rc;
+	libraw_data_t *raw_data;
+
+	outout_image->width = 0;
+	outout_image->height = 0;
+	outout_image->bits = 16;
+	outout_image->colors = 0;
+	outout_image->colors = false;
+	memset(outout_image->bayer_pattern, 0, sizeof(outout_image->bayer_pattern));
+	outout_image->size = 0;
+	outout_image->data = NULL;
+
+#if !defined(INDIGO_WINDOWS)
+	clock_t start = clock();
+#endif
+
+	raw_data = libraw_init(0);
+	set_params(raw_data);
 
 	rc = libraw_open_buffer(raw_data, buffer, buffer_size);
 	if (rc != LIBRAW_SUCCESS) {
@@ -201,10 +253,7 @@ int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_
 		goto cleanup;
 	}
 
-	outout_image->bayer_pattern[0] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 2, 2)];
-	outout_image->bayer_pattern[1] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 2, 3)];
-	outout_image->bayer_pattern[2] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 3, 2)];
-	outout_image->bayer_pattern[3] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 3, 3)];
+	set_bayer_pattern(raw_data, outout_image);
 
 	indigo_debug("Maker       : %s, Model      : %s", raw_data->idata.make, raw_data->idata.model);
 	indigo_debug("Norm Maker  : %s, Norm Model : %s", raw_data->idata.normalized_make, raw_data->idata.normalized_model);
@@ -215,7 +264,7 @@ int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_
 	indigo_debug("bayerpat    : %s, cdesc      : %s", outout_image->bayer_pattern, raw_data->idata.cdesc);
 
 	if (raw_data->params.user_qual > 20) {
-		rc = image_bayered_data(raw_data, outout_image, false);
+		rc = image_bayered_data(raw_data, outout_image, false, NULL);
 		if (rc) goto cleanup;
 		outout_image->debayered = false;
 	} else {
@@ -268,31 +317,7 @@ int indigo_dslr_raw_image_info(void *buffer, size_t buffer_size, indigo_dslr_raw
 		goto cleanup;
 	}
 
-	strncpy(image_info->camera_make, raw_data->idata.make, sizeof(image_info->camera_make));
-	strncpy(image_info->camera_model, raw_data->idata.model, sizeof(image_info->camera_model));
-	strncpy(image_info->normalized_camera_make, raw_data->idata.normalized_make, sizeof(image_info->normalized_camera_make));
-	strncpy(image_info->normalized_camera_model, raw_data->idata.normalized_model, sizeof(image_info->normalized_camera_model));
-	strncpy(image_info->lens, raw_data->lens.Lens, sizeof(image_info->lens));
-	strncpy(image_info->lens_make, raw_data->lens.LensMake, sizeof(image_info->lens_make));
-	image_info->raw_height = raw_data->sizes.raw_height;
-	image_info->raw_width = raw_data->sizes.raw_width;
-	image_info->iheight = raw_data->sizes.iheight;
-	image_info->iwidth = raw_data->sizes.iwidth;
-	image_info->top_margin = raw_data->sizes.top_margin;
-	image_info->left_margin = raw_data->sizes.left_margin;
-	image_info->iso_speed = raw_data->other.iso_speed;
-	image_info->shutter = raw_data->other.shutter;
-	image_info->aperture = raw_data->other.aperture;
-	image_info->focal_len = raw_data->other.focal_len;
-	image_info->timestamp = raw_data->other.timestamp;
-	image_info->temperature = -273.15f;
-	if (raw_data->makernotes.common.SensorTemperature > -273.15f) {
-		 image_info->temperature = raw_data->makernotes.common.SensorTemperature;
-	} else if (raw_data->makernotes.common.CameraTemperature > -273.15f) {
-		 image_info->temperature = raw_data->makernotes.common.CameraTemperature;
-	}
-	strncpy(image_info->desc, raw_data->other.desc, sizeof(image_info->desc));
-	strncpy(image_info->artist, raw_data->other.artist, sizeof(image_info->artist));
+	get_image_info(raw_data, image_info);
 
 #if !defined(INDIGO_WINDOWS)
 	indigo_debug(
@@ -308,3 +333,88 @@ cleanup:
 
 	return rc;
 }
+
+libraw_data_t *indigo_dslr_raw_init_context(void) {
+	libraw_data_t *raw_data = libraw_init(0);
+	if (raw_data == NULL) {
+		indigo_error("libraw_init failed");
+		return NULL;
+	}
+	set_params(raw_data);
+	return raw_data;
+}
+
+void indigo_dslr_raw_release_context(libraw_data_t *raw_data) {
+	if (raw_data)
+		libraw_close(raw_data);
+}
+
+int indigo_dslr_raw_decode(libraw_data_t *raw_data, void *buffer, size_t buffer_size, void **image, size_t *image_size, size_t offset, indigo_dslr_raw_image_s *outout_image, indigo_dslr_raw_image_info_s *image_info) {
+	int rc;
+
+	memset(outout_image, 0, sizeof(*outout_image));
+	outout_image->bits = 16;
+
+#if !defined(INDIGO_WINDOWS)
+	clock_t start = clock();
+#endif
+
+	/* context is recycled by open, parameters are kept */
+	rc = libraw_open_buffer(raw_data, buffer, buffer_size);
+	if (rc != LIBRAW_SUCCESS) {
+		indigo_error("[rc:%d] libraw_open_buffer failed: '%s'", rc, libraw_strerror(rc));
+		goto cleanup;
+	}
+
+	rc = libraw_unpack(raw_data);
+	if (rc != LIBRAW_SUCCESS) {
+		indigo_error( "[rc:%d] libraw_unpack failed: '%s'", rc, libraw_strerror(rc));
+		goto cleanup;
+	}
+
+	if (raw_data->rawdata.raw_image == NULL) {
+		indigo_error("%s %s is not a bayer sensor camera", raw_data->idata.make, raw_data->idata.model);
+		rc = LIBRAW_UNSPECIFIED_ERROR;
+		goto cleanup;
+	}
+
+	if (image_info)
+		get_image_info(raw_data, image_info);
+	set_bayer_pattern(raw_data, outout_image);
+
+	/* plane is written behind the reserved header and followed by the same amount of space for padding */
+	size_t size = (size_t)raw_data->sizes.iwidth * raw_data->sizes.iheight * sizeof(uint16_t) + 2 * offset;
+	if (*image_size < size) {
+		void *tmp = realloc(*image, size);
+		if (tmp == NULL) {
+			indigo_error("%s", strerror(errno));
+			rc = -errno;
+			goto cleanup;
+		}
+		*image = tmp;
+		*image_size = size;
+	}
+	rc = image_bayered_data(raw_data, outout_image, false, (uint16_t *)((char *)*image + offset));
+	if (rc)
+		goto cleanup;
+	outout_image->debayered = false;
+
+#if !defined(INDIGO_WINDOWS)
+	indigo_debug(
+		"libraw decoded %s %s in %g sec, input size: "
+		"%zu bytes, output size: %zu bytes, bayer pattern '%s', "
+		"dimension: %d x %d",
+		raw_data->idata.make, raw_data->idata.model,
+		(clock() - start) / (double)CLOCKS_PER_SEC,
+		buffer_size,
+		outout_image->size,
+		outout_image->bayer_pattern,
+		outout_image->width, outout_image->height
+	);
+#endif
+
+cleanup:
+	libraw_recycle(raw_data);
+
+	return rc;
+}
@@ -41,12 +41,109 @@ static char *property_name_prefix[INDIGO_FILTER_LIST_COUNT] = { "CCD_", "WHEEL_"
 static int property_name_prefix_len[INDIGO_FILTER_LIST_COUNT] = { 4, 6, 8, 8, 6, 7, 5, 4, 9, 6, 6, 6, 6 };
 static char *property_name_label[INDIGO_FILTER_LIST_COUNT] = { "CCD ", "Wheel ", "Focuser ", "Rotator ", "Mount ", "Guider ", "Dome ", "GPS ", "Joystick", "AUX #1 ", "AUX #2 ", "AUX #3 ", "AUX #4 " };
 
+#define CACHE_BUCKET(hash) ((hash) & (INDIGO_FILTER_CACHE_HASH_SIZE - 1))
+
+static uint32_t cache_hash(const char *device, const char *name) {
+	uint32_t hash = 2166136261U;
+	if (device) {
+		while (*device)
+			hash = (hash ^ (unsigned char)*device++) * 16777619U;
+		hash *= 16777619U;
+	}
+	while (*name)
+		hash = (hash ^ (unsigned char)*name++) * 16777619U;
+	return hash;
+}
+
+static indigo_filter_cache_entry *find_cached_device_property(indigo_filter_context *context, const char *device, const char *name) {
+	uint32_t hash = cache_hash(device, name);
+	for (indigo_filter_cache_entry *entry = context->device_property_cache[CACHE_BUCKET(hash)]; entry; entry = entry->next_device) {
+		if (entry->device_hash == hash && !strcmp(entry->device_property->name, name) && !strcmp(entry->device_property->device, device))
+			return entry;
+	}
+	return NULL;
+}
+
+static indigo_filter_cache_entry *find_cached_agent_property(indigo_filter_context *context, const char *name) {
+	uint32_t hash = cache_hash(NULL, name);
+	for (indigo_filter_cache_entry *entry = context->agent_property_cache[CACHE_BUCKET(hash)]; entry; entry = entry->next_agent) {
+		if (entry->agent_hash == hash && !strcmp(entry->agent_property->name, name))
+			return entry;
+	}
+	return NULL;
+}
+
+static void add_cached_property(indigo_filter_context *context, indigo_property *device_property, indigo_property *agent_property) {
+	indigo_filter_cache_entry *entry = indigo_safe_malloc(sizeof(indigo_filter_cache_entry));
+	entry->device_property = device_property;
+	entry->agent_property = agent_property;
+	entry->device_hash = cache_hash(device_property->device, device_property->name);
+	entry->agent_hash = cache_hash(NULL, agent_property->name);
+	indigo_filter_cache_entry **bucket = context->device_property_cache + CACHE_BUCKET(entry->device_hash);
+	entry->next_device = *bucket;
+	*bucket = entry;
+	bucket = context->agent_property_cache + CACHE_BUCKET(entry->agent_hash);
+	entry->next_agent = *bucket;
+	*bucket = entry;
+}
+
+// unlink records of given device property (or all properties of the device if name is NULL), returns list linked by next_device
+
+static indigo_filter_cache_entry *unlink_cached_properties(indigo_filter_context *context, const char *device, const char *name) {
+	indigo_filter_cache_entry *removed = NULL;
+	for (int i = 0; i < INDIGO_FILTER_CACHE_HASH_SIZE; i++) {
+		if (name)
+			i = CACHE_BUCKET(cache_hash(device, name));
+		indigo_filter_cache_entry **link = context->device_property_cache + i;
+		while (*link) {
+			indigo_filter_cache_entry *entry = *link;
+			if (!strcmp(entry->device_property->device, device) && (name == NULL || !strcmp(entry->device_property->name, name))) {
+				*link = entry->next_device;
+				indigo_filter_cache_entry **agent_link = context->agent_property_cache + CACHE_BUCKET(entry->agent_hash);
+				while (*agent_link != entry)
+					agent_link = &(*agent_link)->next_agent;
+				*agent_link = entry->next_agent;
+				entry->next_device = removed;
+				removed = entry;
+				if (name)
+					return removed;
+			} else {
+				link = &entry->next_device;
+			}
+		}
+		if (name)
+			break;
+	}
+	return removed;
+}
+
+static void release_cached_properties(indigo_device *device, indigo_filter_cache_entry *entry, const char *message) {
+	while (entry) {
+		indigo_filter_cache_entry *next = entry->next_device;
+		indigo_release_property(entry->device_property);
+		if (entry->agent_property) {
+			indigo_delete_property(device, entry->agent_property, message);
+			indigo_release_property(entry->agent_property);
+		}
+		free(entry);
+		entry = next;
+	}
+}
+
 indigo_result indigo_filter_device_attach(indigo_device *device, const char* driver_name, unsigned version, indigo_device_interface device_interface) {
 	assert(device != NULL);
 	if (FILTER_DEVICE_CONTEXT == NULL) {
 		device->device_context = indigo_safe_malloc(sizeof(indigo_filter_context));
 	}
 	FILTER_DEVICE_CONTEXT->device = device;
+	pthread_mutex_init(&FILTER_DEVICE_CONTEXT->property_cache_mutex, NULL);
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+#if defined(INDIGO_LINUX)
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+	pthread_cond_init(&FILTER_DEVICE_CONTEXT->property_cache_cond, &attr);
+	pthread_condattr_destroy(&attr);
 	if (FILTER_DEVICE_CONTEXT != NULL) {
 		if (indigo_device_attach(device, driver_name, version, INDIGO_INTERFACE_AGENT | device_interface) == INDIGO_OK) {
 			CONNECTION_PROPERTY->hidden = true;
@@ -252,10 +349,10 @@ indigo_result indigo_filter_device_attach(indigo_device *device, const char* dri
 			indigo_init_number_item(CCD_LENS_FOV_FOV_HEIGHT_ITEM, CCD_LENS_FOV_FOV_HEIGHT_ITEM_NAME, "FOV height (°)", 0, 180, 0, 0);
 			indigo_init_number_item(CCD_LENS_FOV_PIXEL_SCALE_WIDTH_ITEM, CCD_LENS_FOV_PIXEL_SCALE_WIDTH_ITEM_NAME, "Pixel scale width (°/px)", 0, 5, 0, 0);
 			indigo_init_number_item(CCD_LENS_FOV_PIXEL_SCALE_HEIGHT_ITEM, CCD_LENS_FOV_PIXEL_SCALE_HEIGHT_ITEM_NAME, "Pixel scale height (°/px)", 0, 5, 0, 0);
-			strcpy(CCD_LENS_FOV_FOV_WIDTH_ITEM->number.format, "%m");
-			strcpy(CCD_LENS_FOV_FOV_HEIGHT_ITEM->number.format, "%m");
-			strcpy(CCD_LENS_FOV_PIXEL_SCALE_WIDTH_ITEM->number.format, "%.10m");
-			strcpy(CCD_LENS_FOV_PIXEL_SCALE_HEIGHT_ITEM->number.format, "%.10m");
+			indigo_set_number_format(CCD_LENS_FOV_FOV_WIDTH_ITEM, "%m");
+			indigo_set_number_format(CCD_LENS_FOV_FOV_HEIGHT_ITEM, "%m");
+			indigo_set_number_format(CCD_LENS_FOV_PIXEL_SCALE_WIDTH_ITEM, "%.10m");
+			indigo_set_number_format(CCD_LENS_FOV_PIXEL_SCALE_HEIGHT_ITEM, "%.10m");
 			CCD_LENS_FOV_PROPERTY->hidden = true;
 			// --------------------------------------------------------------------------------
 			CONFIG_PROPERTY->hidden = true;
@@ -279,10 +376,28 @@ indigo_result indigo_filter_enumerate_properties(indigo_device *device, indigo_c
 	}
 	if (indigo_property_match(FILTER_DEVICE_CONTEXT->filter_related_agent_list_property, property))
 		indigo_define_property(device, FILTER_DEVICE_CONTEXT->filter_related_agent_list_property, NULL);
-	for (int i = 0; i < INDIGO_FILTER_MAX_CACHED_PROPERTIES; i++) {
-		indigo_property *cached_property = FILTER_DEVICE_CONTEXT->agent_property_cache[i];
-		if (cached_property && indigo_property_match(cached_property, property))
-			indigo_define_property(device, cached_property, NULL);
+	pthread_mutex_lock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	if (property && *property->name) {
+		indigo_filter_cache_entry *entry = find_cached_agent_property(FILTER_DEVICE_CONTEXT, property->name);
+		pthread_mutex_unlock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+		if (entry && indigo_property_match(entry->agent_property, property))
+			indigo_define_property(device, entry->agent_property, NULL);
+	} else {
+		int count = 0;
+		for (int i = 0; i < INDIGO_FILTER_CACHE_HASH_SIZE; i++)
+			for (indigo_filter_cache_entry *entry = FILTER_DEVICE_CONTEXT->agent_property_cache[i]; entry; entry = entry->next_agent)
+				count++;
+		indigo_property **agent_properties = indigo_safe_malloc((count + 1) * sizeof(indigo_property *));
+		count = 0;
+		for (int i = 0; i < INDIGO_FILTER_CACHE_HASH_SIZE; i++)
+			for (indigo_filter_cache_entry *entry = FILTER_DEVICE_CONTEXT->agent_property_cache[i]; entry; entry = entry->next_agent)
+				agent_properties[count++] = entry->agent_property;
+		pthread_mutex_unlock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+		for (int i = 0; i < count; i++) {
+			if (indigo_property_match(agent_properties[i], property))
+				indigo_define_property(device, agent_properties[i], NULL);
+		}
+		free(agent_properties);
 	}
 	if (indigo_property_match(FILTER_FORCE_SYMMETRIC_RELATIONS_PROPERTY, property)) {
 		FILTER_FORCE_SYMMETRIC_RELATIONS_PROPERTY->hidden = FILTER_RELATED_AGENT_LIST_PROPERTY->hidden;
@@ -414,20 +529,10 @@ static indigo_result update_device_list(indigo_device *device, indigo_client *cl
 		if (device_list->items[i].sw.value) {
 			device_list->items[i].sw.value = false;
 			strcpy(connection_property->device, device_list->items[i].name);
-			indigo_property **device_cache = FILTER_DEVICE_CONTEXT->device_property_cache;
-			indigo_property **agent_cache = FILTER_DEVICE_CONTEXT->agent_property_cache;
-			for (int i = 0; i < INDIGO_FILTER_MAX_CACHED_PROPERTIES; i++) {
-				indigo_property *device_property = device_cache[i];
-				if (device_property && !strcmp(connection_property->device, device_property->device)) {
-					indigo_safe_free(device_property);
-					device_cache[i] = NULL;
-					if (agent_cache[i]) {
-						indigo_delete_property(device, agent_cache[i], NULL);
-						indigo_release_property(agent_cache[i]);
-						agent_cache[i] = NULL;
-					}
-				}
-			}
+			pthread_mutex_lock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+			indigo_filter_cache_entry *removed = unlink_cached_properties(FILTER_DEVICE_CONTEXT, connection_property->device, NULL);
+			pthread_mutex_unlock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+			release_cached_properties(device, removed, NULL);
 			if (!CCD_LENS_FOV_PROPERTY->hidden) {
 				indigo_delete_property(device, CCD_LENS_FOV_PROPERTY, NULL);
 				CCD_LENS_FOV_PROPERTY->hidden = true;
@@ -544,17 +649,20 @@ indigo_result indigo_filter_change_property(indigo_device *device, indigo_client
 	if (indigo_property_match(FILTER_DEVICE_CONTEXT->filter_related_agent_list_property, property)) {
 		return update_related_agent_list(device, property);
 	}
-	indigo_property **agent_cache = FILTER_DEVICE_CONTEXT->agent_property_cache;
-	for (int i = 0; i < INDIGO_FILTER_MAX_CACHED_PROPERTIES; i++) {
-		if (agent_cache[i] && indigo_property_match_defined(agent_cache[i], property)) {
-			indigo_property *copy = indigo_copy_property(NULL, property);
-			strcpy(copy->device, FILTER_DEVICE_CONTEXT->device_property_cache[i]->device);
-			strcpy(copy->name, FILTER_DEVICE_CONTEXT->device_property_cache[i]->name);
-			copy->access_token = indigo_get_device_or_master_token(copy->device);
-			indigo_change_property(client, copy);
-			indigo_release_property(copy);
-			return INDIGO_OK;
-		}
+	indigo_property *copy = NULL;
+	pthread_mutex_lock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	indigo_filter_cache_entry *entry = find_cached_agent_property(FILTER_DEVICE_CONTEXT, property->name);
+	if (entry && indigo_property_match_defined(entry->agent_property, property)) {
+		copy = indigo_copy_property(NULL, property);
+		strcpy(copy->device, entry->device_property->device);
+		strcpy(copy->name, entry->device_property->name);
+	}
+	pthread_mutex_unlock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	if (copy) {
+		copy->access_token = indigo_get_device_or_master_token(copy->device);
+		indigo_change_property(client, copy);
+		indigo_release_property(copy);
+		return INDIGO_OK;
 	}
 	if (indigo_property_match(FILTER_FORCE_SYMMETRIC_RELATIONS_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- FILTER_FORCE_SYMMETRIC_RELATIONS
@@ -590,6 +698,8 @@ indigo_result indigo_filter_device_detach(indigo_device *device) {
 	}
 	indigo_release_property(CCD_LENS_FOV_PROPERTY);
 	indigo_release_property(FILTER_FORCE_SYMMETRIC_RELATIONS_PROPERTY);
+	pthread_mutex_destroy(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	pthread_cond_destroy(&FILTER_DEVICE_CONTEXT->property_cache_cond);
 	return indigo_device_detach(device);
 }
 
@@ -597,12 +707,8 @@ indigo_result indigo_filter_client_attach(indigo_client *client) {
 	assert(client != NULL);
 	assert (FILTER_CLIENT_CONTEXT != NULL);
 	FILTER_CLIENT_CONTEXT->client = client;
-	indigo_property **device_cache = FILTER_CLIENT_CONTEXT->device_property_cache;
-	indigo_property **agent_cache = FILTER_CLIENT_CONTEXT->device_property_cache;
-	for (int i = 0; i < INDIGO_FILTER_MAX_CACHED_PROPERTIES; i++) {
-		device_cache[i] = NULL;
-		agent_cache[i] = NULL;
-	}
+	memset(FILTER_CLIENT_CONTEXT->device_property_cache, 0, sizeof(FILTER_CLIENT_CONTEXT->device_property_cache));
+	memset(FILTER_CLIENT_CONTEXT->agent_property_cache, 0, sizeof(FILTER_CLIENT_CONTEXT->agent_property_cache));
 	indigo_property all_properties;
 	memset(&all_properties, 0, sizeof(all_properties));
 	indigo_enumerate_properties(client, &all_properties);
@@ -641,14 +747,8 @@ static void remove_from_list(indigo_device *device, indigo_property *device_list
 					*selected_name = 0;
 				device_list->state = INDIGO_ALERT_STATE;
 			}
-			int size = (device_list->count - i - 1) * sizeof(indigo_item);
-			if (size > 0) {
-				char buffer[size];
-				memcpy(buffer, device_list->items + i + 1, size);
-				memcpy(device_list->items + i, buffer, size);
-			}
 			indigo_delete_property(device, device_list, NULL);
-			device_list->count--;
+			indigo_remove_item(device_list, i);
 			indigo_define_property(device, device_list, NULL);
 			break;
 		}
@@ -719,8 +819,6 @@ indigo_result indigo_filter_define_property(indigo_client *client, indigo_device
 	if (device == FILTER_CLIENT_CONTEXT->device)
 		return INDIGO_OK;
 	device = FILTER_CLIENT_CONTEXT->device;
-	indigo_property **device_cache = FILTER_CLIENT_CONTEXT->device_property_cache;
-	indigo_property **agent_cache = FILTER_CLIENT_CONTEXT->agent_property_cache;
 	if (property->type == INDIGO_BLOB_VECTOR) {
 		indigo_enable_blob(client, property, INDIGO_ENABLE_BLOB_URL);
 	}
@@ -794,51 +892,35 @@ indigo_result indigo_filter_define_property(indigo_client *client, indigo_device
 				continue;
 			if (i == INDIGO_FILTER_CCD_INDEX)
 				update_ccd_lens_info(device, property);
-			bool found = false;
-			for (int j = 0; j < INDIGO_FILTER_MAX_CACHED_PROPERTIES; j++) {
-				if (indigo_property_match(device_cache[j], property)) {
-					found = true;
-					break;
-				}
-			}
-			if (!found) {
-				int free_index;
-				for (free_index = 0; free_index < INDIGO_FILTER_MAX_CACHED_PROPERTIES; free_index++) {
-					if (device_cache[free_index] == NULL) {
-						int size = sizeof(indigo_property) + property->count * sizeof(indigo_item);
-						device_cache[free_index] = indigo_safe_malloc_copy(size, property);
-						indigo_property *agent_property = indigo_copy_property(NULL, property);
-						strcpy(agent_property->device, device->name);
-						bool translate = strncmp(name_prefix, agent_property->name, name_prefix_length);
-						if (translate && !strcmp(name_prefix, "CCD_") && !strncmp(agent_property->name, "DSLR_", 5))
-							translate = false;
-						if (translate) {
-							strcpy(agent_property->name, name_prefix);
-							strcat(agent_property->name, property->name);
-							strcpy(agent_property->label, property_name_label[i]);
-							strcat(agent_property->label, property->label);
-						}
-						agent_cache[free_index] = agent_property;
-						indigo_define_property(device, agent_property, message);
-						break;
-					}
-				}
-				if (free_index == INDIGO_FILTER_MAX_CACHED_PROPERTIES) {
-					indigo_error("[%s:%d] Max cached properties count reached", __FUNCTION__, __LINE__);
+			indigo_property *agent_property = NULL;
+			pthread_mutex_lock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+			if (find_cached_device_property(FILTER_CLIENT_CONTEXT, property->device, property->name) == NULL) {
+				indigo_property *device_property = indigo_copy_property(NULL, property);
+				agent_property = indigo_copy_property(NULL, property);
+				strcpy(agent_property->device, device->name);
+				bool translate = strncmp(name_prefix, agent_property->name, name_prefix_length);
+				if (translate && !strcmp(name_prefix, "CCD_") && !strncmp(agent_property->name, "DSLR_", 5))
+					translate = false;
+				if (translate) {
+					strcpy(agent_property->name, name_prefix);
+					strcat(agent_property->name, property->name);
+					indigo_set_string_printf(&agent_property->label, "%s%s", property_name_label[i], property->label);
 				}
+				add_cached_property(FILTER_CLIENT_CONTEXT, device_property, agent_property);
 			}
+			pthread_mutex_unlock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+			if (agent_property)
+				indigo_define_property(device, agent_property, message);
 			return INDIGO_OK;
 		}
 	}
 	return INDIGO_OK;
 }
 
-indigo_result indigo_filter_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+static indigo_result update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
 	if (device == FILTER_CLIENT_CONTEXT->device)
 		return INDIGO_OK;
 	device = FILTER_CLIENT_CONTEXT->device;
-	indigo_property **device_cache = FILTER_CLIENT_CONTEXT->device_property_cache;
-	indigo_property **agent_cache = FILTER_CLIENT_CONTEXT->agent_property_cache;
 	for (int i = 0; i < INDIGO_FILTER_LIST_COUNT; i++) {
 		if (!strcmp(property->name, CONNECTION_PROPERTY_NAME) && property->state != INDIGO_BUSY_STATE) {
 			indigo_item *connected_device = indigo_get_item(property, CONNECTION_CONNECTED_ITEM_NAME);
@@ -895,87 +977,80 @@ indigo_result indigo_filter_update_property(indigo_client *client, indigo_device
 				continue;
 			if (i == INDIGO_FILTER_CCD_INDEX)
 				update_ccd_lens_info(device, property);
-			for (int i = 0; i < INDIGO_FILTER_MAX_CACHED_PROPERTIES; i++) {
-				indigo_property *agent_property = agent_cache[i];
-				indigo_property *device_property = device_cache[i];
-				if (indigo_property_match(device_property, property)) {
-					device_cache[i] = indigo_copy_property(device_property, property);
-					if (agent_property) {
-						if (agent_property->type == INDIGO_TEXT_VECTOR) {
-							for (int k = 0; k < agent_property->count; k++) {
-								indigo_set_text_item_value(agent_property->items + k, indigo_get_text_item_value(property->items + k));
-							}
-						} else {
-							memcpy(agent_property->items, property->items, property->count * sizeof(indigo_item));
-						}
-						agent_property->state = property->state;
-						indigo_update_property(device, agent_property, message);
-					}
-					return INDIGO_OK;
+			pthread_mutex_lock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+			indigo_filter_cache_entry *entry = find_cached_device_property(FILTER_CLIENT_CONTEXT, property->device, property->name);
+			if (entry == NULL || (property->type && entry->device_property->type != property->type)) {
+				pthread_mutex_unlock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+				continue;
+			}
+			entry->device_property = indigo_copy_property(entry->device_property, property);
+			indigo_property *agent_property = entry->agent_property;
+			if (agent_property->type == INDIGO_TEXT_VECTOR) {
+				for (int k = 0; k < agent_property->count; k++) {
+					indigo_set_text_item_value(agent_property->items + k, indigo_get_text_item_value(property->items + k));
 				}
+			} else {
+				indigo_copy_items(agent_property, property);
 			}
+			agent_property->state = property->state;
+			pthread_mutex_unlock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+			indigo_update_property(device, agent_property, message);
+			return INDIGO_OK;
 		}
 	}
 	return INDIGO_OK;
 }
 
-indigo_result indigo_filter_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+indigo_result indigo_filter_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	indigo_result result = update_property(client, device, property, message);
+	indigo_filter_notify(FILTER_CLIENT_CONTEXT->device);
+	return result;
+}
+
+static indigo_result delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
 	if (device == FILTER_CLIENT_CONTEXT->device)
 		return INDIGO_OK;
 	device = FILTER_CLIENT_CONTEXT->device;
-	indigo_property **device_cache = FILTER_CLIENT_CONTEXT->device_property_cache;
-	indigo_property **agent_cache = FILTER_CLIENT_CONTEXT->agent_property_cache;
 	if (*property->name) {
-		for (int i = 0; i < INDIGO_FILTER_MAX_CACHED_PROPERTIES; i++) {
-			if (indigo_property_match(device_cache[i], property)) {
-				// this is the list of "fragile" properties used by various filter agents
-				// if any of them is removed, any background process should abort asap
-				FILTER_CLIENT_CONTEXT->property_removed =
-					!strcmp(property->name, CCD_EXPOSURE_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_STREAMING_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_IMAGE_FORMAT_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_UPLOAD_MODE_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_TEMPERATURE_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_COOLER_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_MODE_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_LOCAL_MODE_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_GAIN_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_OFFSET_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_GAMMA_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_FRAME_TYPE_PROPERTY_NAME) ||
-					!strcmp(property->name, CCD_FRAME_PROPERTY_NAME) ||
-//					!strcmp(property->name, DSLR_APERTURE_PROPERTY_NAME) ||
-//					!strcmp(property->name, DSLR_SHUTTER_PROPERTY_NAME) ||
-//					!strcmp(property->name, DSLR_ISO_PROPERTY_NAME) ||
-					!strcmp(property->name, GUIDER_GUIDE_RA_PROPERTY_NAME) ||
-					!strcmp(property->name, GUIDER_GUIDE_DEC_PROPERTY_NAME) ||
-					!strcmp(property->name, FOCUSER_DIRECTION_PROPERTY_NAME) ||
-					!strcmp(property->name, FOCUSER_STEPS_PROPERTY_NAME) ||
-					!strcmp(property->name, WHEEL_SLOT_NAME_PROPERTY_NAME);
-				indigo_safe_free(device_cache[i]);
-				device_cache[i] = NULL;
-				if (agent_cache[i]) {
-					indigo_delete_property(device, agent_cache[i], NULL);
-					indigo_release_property(agent_cache[i]);
-					agent_cache[i] = NULL;
-				}
-				break;
-			}
+		pthread_mutex_lock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+		indigo_filter_cache_entry *removed = unlink_cached_properties(FILTER_CLIENT_CONTEXT, property->device, property->name);
+		pthread_mutex_unlock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+		if (removed) {
+			// this is the list of "fragile" properties used by various filter agents
+			// if any of them is removed, any background process should abort asap
+			FILTER_CLIENT_CONTEXT->property_removed =
+				!strcmp(property->name, CCD_EXPOSURE_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_STREAMING_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_IMAGE_FORMAT_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_UPLOAD_MODE_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_TEMPERATURE_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_COOLER_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_MODE_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_LOCAL_MODE_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_GAIN_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_OFFSET_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_GAMMA_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_FRAME_TYPE_PROPERTY_NAME) ||
+				!strcmp(property->name, CCD_FRAME_PROPERTY_NAME) ||
+//				!strcmp(property->name, DSLR_APERTURE_PROPERTY_NAME) ||
+//				!strcmp(property->name, DSLR_SHUTTER_PROPERTY_NAME) ||
+//				!strcmp(property->name, DSLR_ISO_PROPERTY_NAME) ||
+				!strcmp(property->name, GUIDER_GUIDE_RA_PROPERTY_NAME) ||
+				!strcmp(property->name, GUIDER_GUIDE_DEC_PROPERTY_NAME) ||
+				!strcmp(property->name, FOCUSER_DIRECTION_PROPERTY_NAME) ||
+				!strcmp(property->name, FOCUSER_STEPS_PROPERTY_NAME) ||
+				!strcmp(property->name, WHEEL_SLOT_NAME_PROPERTY_NAME);
+			release_cached_properties(device, removed, NULL);
 		}
 		if (!strcmp(property->name, CONNECTION_PROPERTY_NAME))
 			remove_cached_connection_property(device, property);
 	} else {
-		for (int i = 0; i < INDIGO_FILTER_MAX_CACHED_PROPERTIES; i++) {
-			if (device_cache[i] && !strcmp(device_cache[i]->device, property->device)) {
-				FILTER_CLIENT_CONTEXT->property_removed = true;
-				indigo_safe_free(device_cache[i]);
-				device_cache[i] = NULL;
-				if (agent_cache[i]) {
-					indigo_delete_property(device, agent_cache[i], message);
-					indigo_release_property(agent_cache[i]);
-					agent_cache[i] = NULL;
-				}
-			}
+		pthread_mutex_lock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+		indigo_filter_cache_entry *removed = unlink_cached_properties(FILTER_CLIENT_CONTEXT, property->device, NULL);
+		pthread_mutex_unlock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+		if (removed) {
+			FILTER_CLIENT_CONTEXT->property_removed = true;
+			release_cached_properties(device, removed, message);
 		}
 		remove_cached_connection_property(device, property);
 	}
@@ -989,6 +1064,12 @@ indigo_result indigo_filter_delete_property(indigo_client *client, indigo_device
 	return INDIGO_OK;
 }
 
+indigo_result indigo_filter_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	indigo_result result = delete_property(client, device, property, message);
+	indigo_filter_notify(FILTER_CLIENT_CONTEXT->device);
+	return result;
+}
+
 indigo_result indigo_filter_client_detach(indigo_client *client) {
 	for (int i = 0; i < INDIGO_FILTER_LIST_COUNT; i++) {
 		indigo_property *list = FILTER_CLIENT_CONTEXT->filter_device_list_properties[i];
@@ -1000,33 +1081,99 @@ indigo_result indigo_filter_client_detach(indigo_client *client) {
 			}
 		}
 	}
-	indigo_property **device_cache = FILTER_CLIENT_CONTEXT->device_property_cache;
-	indigo_property **agent_cache = FILTER_CLIENT_CONTEXT->agent_property_cache;
-	for (int i = 0; i < INDIGO_FILTER_MAX_CACHED_PROPERTIES; i++) {
-		if (device_cache[i])
-			indigo_safe_free(device_cache[i]);
-		if (agent_cache[i])
-			indigo_release_property(agent_cache[i]);
+	pthread_mutex_lock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
+	for (int i = 0; i < INDIGO_FILTER_CACHE_HASH_SIZE; i++) {
+		indigo_filter_cache_entry *entry = FILTER_CLIENT_CONTEXT->device_property_cache[i];
+		while (entry) {
+			indigo_filter_cache_entry *next = entry->next_device;
+			indigo_release_property(entry->device_property);
+			indigo_release_property(entry->agent_property);
+			free(entry);
+			entry = next;
+		}
+		FILTER_CLIENT_CONTEXT->device_property_cache[i] = NULL;
+		FILTER_CLIENT_CONTEXT->agent_property_cache[i] = NULL;
 	}
+	pthread_mutex_unlock(&FILTER_CLIENT_CONTEXT->property_cache_mutex);
 	return INDIGO_OK;
 }
 
 bool indigo_filter_cached_property(indigo_device *device, int index, char *name, indigo_property **device_property, indigo_property **agent_property) {
-	indigo_property **cache = FILTER_DEVICE_CONTEXT->device_property_cache;
-	char *device_name = FILTER_DEVICE_CONTEXT->device_name[index];
-	indigo_property *property;
-	for (int j = 0; j < INDIGO_FILTER_MAX_CACHED_PROPERTIES; j++) {
-		if ((property = cache[j])) {
-			if (!strcmp(property->device, device_name) && !strcmp(property->name, name)) {
-				if (device_property)
-					*device_property = cache[j];
-				if (agent_property)
-					*agent_property = FILTER_DEVICE_CONTEXT->agent_property_cache[j];
-				return true;
-			}
+	pthread_mutex_lock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	indigo_filter_cache_entry *entry = find_cached_device_property(FILTER_DEVICE_CONTEXT, FILTER_DEVICE_CONTEXT->device_name[index], name);
+	if (entry) {
+		if (device_property)
+			*device_property = entry->device_property;
+		if (agent_property)
+			*agent_property = entry->agent_property;
+	}
+	pthread_mutex_unlock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	return entry != NULL;
+}
+
+// on Linux the condition uses CLOCK_MONOTONIC, so wall clock adjustments (e.g. NTP or GPS time sync) don't shorten or extend the wait
+
+static int wait_until(indigo_device *device, struct timespec *end) {
+#if defined(INDIGO_MACOS)
+	struct timespec now, delay;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	delay.tv_sec = end->tv_sec - now.tv_sec;
+	delay.tv_nsec = end->tv_nsec - now.tv_nsec;
+	if (delay.tv_nsec < 0) {
+		delay.tv_sec--;
+		delay.tv_nsec += 1000000000L;
+	}
+	if (delay.tv_sec < 0)
+		return ETIMEDOUT;
+	return pthread_cond_timedwait_relative_np(&FILTER_DEVICE_CONTEXT->property_cache_cond, &FILTER_DEVICE_CONTEXT->property_cache_mutex, &delay);
+#elif defined(INDIGO_LINUX)
+	return pthread_cond_timedwait(&FILTER_DEVICE_CONTEXT->property_cache_cond, &FILTER_DEVICE_CONTEXT->property_cache_mutex, end);
+#else
+	struct timespec now, real_end;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	clock_gettime(CLOCK_REALTIME, &real_end);
+	real_end.tv_sec += end->tv_sec - now.tv_sec;
+	real_end.tv_nsec += end->tv_nsec - now.tv_nsec;
+	if (real_end.tv_nsec < 0) {
+		real_end.tv_sec--;
+		real_end.tv_nsec += 1000000000L;
+	} else if (real_end.tv_nsec >= 1000000000L) {
+		real_end.tv_sec++;
+		real_end.tv_nsec -= 1000000000L;
+	}
+	return pthread_cond_timedwait(&FILTER_DEVICE_CONTEXT->property_cache_cond, &FILTER_DEVICE_CONTEXT->property_cache_mutex, &real_end);
+#endif
+}
+
+bool indigo_filter_wait(indigo_device *device, bool (*condition)(indigo_device *device, void *data), void *data, double timeout) {
+	struct timespec end;
+	if (timeout > 0) {
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		end.tv_sec += (int)timeout;
+		end.tv_nsec += 1000000000L * (timeout - (int)timeout);
+		if (end.tv_nsec >= 1000000000L) {
+			end.tv_sec++;
+			end.tv_nsec -= 1000000000L;
 		}
 	}
-	return false;
+	pthread_mutex_lock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	bool result;
+	while (!(result = condition(device, data))) {
+		if (timeout <= 0) {
+			pthread_cond_wait(&FILTER_DEVICE_CONTEXT->property_cache_cond, &FILTER_DEVICE_CONTEXT->property_cache_mutex);
+		} else if (wait_until(device, &end) == ETIMEDOUT) {
+			result = condition(device, data);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	return result;
+}
+
+void indigo_filter_notify(indigo_device *device) {
+	pthread_mutex_lock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
+	pthread_cond_broadcast(&FILTER_DEVICE_CONTEXT->property_cache_cond);
+	pthread_mutex_unlock(&FILTER_DEVICE_CONTEXT->property_cache_mutex);
 }
 
 indigo_result indigo_filter_forward_change_property(indigo_client *client, indigo_property *property, char *device_name) {
@@ -23,6 +23,11 @@
 #include <math.h>
 #include <stdio.h>
 #include <errno.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
 
 #include <indigo/indigo_bus.h>
 #include <indigo/indigo_fits.h>
@@ -66,6 +71,443 @@ static int raw_read_keyword_value(const uint8_t *ptr8, char *keyword, char *valu
 	return 0;
 }
 
+// (value - 32768) is the same as flipping the most significant bit, for big endian input the swaps cancel out
+
+void indigo_raw_to_fits_data(const void *in, void *out, int pixel_count, int byte_per_pixel, int components, bool little_endian, bool byte_order_rgb) {
+	if (components == 1) {
+		if (byte_per_pixel == 2) {
+			const uint16_t *in16 = (const uint16_t *)in;
+			uint16_t *out16 = (uint16_t *)out;
+			if (little_endian) {
+				for (int i = 0; i < pixel_count; i++) {
+					uint16_t value = in16[i] ^ 0x8000;
+					out16[i] = value << 8 | value >> 8;
+				}
+			} else {
+				for (int i = 0; i < pixel_count; i++)
+					out16[i] = in16[i] ^ 0x0080;
+			}
+		} else if (in != out) {
+			memcpy(out, in, pixel_count);
+		}
+	} else if (byte_per_pixel == 2) {
+		const uint16_t *in16 = (const uint16_t *)in;
+		uint16_t *red = (uint16_t *)out, *green = red + pixel_count, *blue = green + pixel_count;
+		if (!byte_order_rgb) {
+			uint16_t *tmp = red;
+			red = blue;
+			blue = tmp;
+		}
+		uint16_t mask = little_endian ? 0x8000 : 0x0080;
+		for (int i = 0; i < pixel_count; i++) {
+			uint16_t r = *in16++ ^ mask, g = *in16++ ^ mask, b = *in16++ ^ mask;
+			if (little_endian) {
+				r = r << 8 | r >> 8;
+				g = g << 8 | g >> 8;
+				b = b << 8 | b >> 8;
+			}
+			red[i] = r;
+			green[i] = g;
+			blue[i] = b;
+		}
+	} else {
+		const uint8_t *in8 = (const uint8_t *)in;
+		uint8_t *red = (uint8_t *)out, *green = red + pixel_count, *blue = green + pixel_count;
+		if (!byte_order_rgb) {
+			uint8_t *tmp = red;
+			red = blue;
+			blue = tmp;
+		}
+		for (int i = 0; i < pixel_count; i++) {
+			red[i] = *in8++;
+			green[i] = *in8++;
+			blue[i] = *in8++;
+		}
+	}
+}
+
+// Compression jobs are distributed to worker threads by index, calling thread works as well
+
+#define COMPRESSION_MAX_WORKERS		16
+#define COMPRESSION_LEVEL					Z_BEST_SPEED
+#define COMPRESSION_BLOCK_SIZE		(1024 * 1024)
+#define COMPRESSION_TILE_ROWS			16
+#define RICE_BLOCK_SIZE						32
+
+typedef struct {
+	pthread_mutex_t mutex;
+	int next;
+	int count;
+	void (*worker)(void *context, int index);
+	void *context;
+} compression_jobs;
+
+static void *compression_worker(compression_jobs *jobs) {
+	while (true) {
+		pthread_mutex_lock(&jobs->mutex);
+		int index = jobs->next++;
+		pthread_mutex_unlock(&jobs->mutex);
+		if (index >= jobs->count)
+			break;
+		jobs->worker(jobs->context, index);
+	}
+	return NULL;
+}
+
+static void run_compression_jobs(void (*worker)(void *context, int index), void *context, int count) {
+	compression_jobs jobs = { PTHREAD_MUTEX_INITIALIZER, 0, count, worker, context };
+	int worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+	if (worker_count > count - 1)
+		worker_count = count - 1;
+	if (worker_count > COMPRESSION_MAX_WORKERS)
+		worker_count = COMPRESSION_MAX_WORKERS;
+	pthread_t workers[COMPRESSION_MAX_WORKERS];
+	int started = 0;
+	for (int i = 0; i < worker_count; i++) {
+		if (pthread_create(workers + started, NULL, (void *(*)(void *))compression_worker, &jobs) == 0)
+			started++;
+	}
+	compression_worker(&jobs);
+	for (int i = 0; i < started; i++)
+		pthread_join(workers[i], NULL);
+	pthread_mutex_destroy(&jobs.mutex);
+}
+
+// Rice coding as in FITS tiled image convention (fits_rcomp in cfitsio), differences are taken modulo sample size
+
+typedef struct {
+	unsigned char *pnt;
+	uint64_t buffer;
+	int bits;
+} bit_writer;
+
+static inline void put_bits(bit_writer *writer, uint32_t value, int count) {
+	writer->buffer = writer->buffer << count | (value & ((1ULL << count) - 1));
+	writer->bits += count;
+	while (writer->bits >= 8) {
+		writer->bits -= 8;
+		*writer->pnt++ = (unsigned char)(writer->buffer >> writer->bits);
+	}
+}
+
+static inline void put_unary(bit_writer *writer, uint32_t zeros) {
+	while (zeros >= 32) {
+		put_bits(writer, 0, 32);
+		zeros -= 32;
+	}
+	put_bits(writer, 1, zeros + 1);
+}
+
+static int rice_compress(const unsigned char *in, int count, int byte_per_pixel, unsigned char *out) {
+	int bbits = byte_per_pixel * 8, fsbits = byte_per_pixel == 2 ? 4 : 3, fsmax = byte_per_pixel == 2 ? 14 : 6;
+	uint32_t mask = byte_per_pixel == 2 ? 0xFFFF : 0xFF;
+	bit_writer writer = { out, 0, 0 };
+	uint32_t diff[RICE_BLOCK_SIZE];
+	int32_t last = byte_per_pixel == 2 ? in[0] << 8 | in[1] : in[0];
+	put_bits(&writer, last, bbits);
+	for (int i = 0; i < count; i += RICE_BLOCK_SIZE) {
+		int block = count - i < RICE_BLOCK_SIZE ? count - i : RICE_BLOCK_SIZE;
+		double sum = 0;
+		for (int j = 0; j < block; j++) {
+			int32_t next = byte_per_pixel == 2 ? in[2 * (i + j)] << 8 | in[2 * (i + j) + 1] : in[i + j];
+			int32_t delta = byte_per_pixel == 2 ? (int16_t)(next - last) : (int8_t)(next - last);
+			diff[j] = (delta < 0 ? ~(delta << 1) : delta << 1) & mask;
+			sum += diff[j];
+			last = next;
+		}
+		double average = (sum - block / 2 - 1) / block;
+		uint32_t psum = average < 0 ? 0 : ((uint32_t)average) >> 1;
+		int fs = 0;
+		for (; psum > 0; fs++)
+			psum >>= 1;
+		if (fs >= fsmax) {
+			put_bits(&writer, fsmax + 1, fsbits);
+			for (int j = 0; j < block; j++)
+				put_bits(&writer, diff[j], bbits);
+		} else if (fs == 0 && sum == 0) {
+			put_bits(&writer, 0, fsbits);
+		} else {
+			put_bits(&writer, fs + 1, fsbits);
+			for (int j = 0; j < block; j++) {
+				put_unary(&writer, diff[j] >> fs);
+				if (fs)
+					put_bits(&writer, diff[j], fs);
+			}
+		}
+	}
+	if (writer.bits)
+		*writer.pnt++ = writer.buffer << (8 - writer.bits);
+	return (int)(writer.pnt - out);
+}
+
+typedef struct {
+	const unsigned char *data;
+	int tile_size;
+	int tile_count;
+	int byte_per_pixel;
+	indigo_fits_compression compression;
+	unsigned long band_bound;
+	unsigned char **bands;
+	int *sizes;
+	bool failed;
+} fits_tiles;
+
+static void fits_tile_worker(fits_tiles *tiles, int band) {
+	int first = band * COMPRESSION_TILE_ROWS;
+	int last = first + COMPRESSION_TILE_ROWS < tiles->tile_count ? first + COMPRESSION_TILE_ROWS : tiles->tile_count;
+	unsigned long tile_bytes = (unsigned long)tiles->tile_size * tiles->byte_per_pixel;
+	unsigned char *out = tiles->bands[band] = indigo_safe_malloc(tiles->band_bound);
+	if (tiles->compression == INDIGO_FITS_RICE) {
+		for (int i = first; i < last; i++) {
+			tiles->sizes[i] = rice_compress(tiles->data + i * tile_bytes, tiles->tile_size, tiles->byte_per_pixel, out);
+			out += tiles->sizes[i];
+		}
+		return;
+	}
+	// GZIP_2 compresses tile with most significant bytes first
+	unsigned char *shuffled = tiles->byte_per_pixel == 2 ? indigo_safe_malloc(tile_bytes) : NULL;
+	z_stream stream = { 0 };
+	if (deflateInit2(&stream, COMPRESSION_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		tiles->failed = true;
+		indigo_safe_free(shuffled);
+		return;
+	}
+	unsigned char *end = tiles->bands[band] + tiles->band_bound;
+	for (int i = first; i < last; i++) {
+		const unsigned char *in = tiles->data + i * tile_bytes;
+		if (shuffled) {
+			for (int j = 0; j < tiles->tile_size; j++) {
+				shuffled[j] = in[2 * j];
+				shuffled[tiles->tile_size + j] = in[2 * j + 1];
+			}
+			in = shuffled;
+		}
+		deflateReset(&stream);
+		stream.next_in = (Bytef *)in;
+		stream.avail_in = (uInt)tile_bytes;
+		stream.next_out = out;
+		stream.avail_out = (uInt)(end - out);
+		if (deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+			tiles->failed = true;
+			break;
+		}
+		tiles->sizes[i] = (int)(stream.next_out - out);
+		out = stream.next_out;
+	}
+	deflateEnd(&stream);
+	indigo_safe_free(shuffled);
+}
+
+static char *fits_card(char *pnt, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(pnt, 81, format, args);
+	va_end(args);
+	if (length > 80)
+		length = 80;
+	memset(pnt + length, ' ', 80 - length);
+	return pnt + 80;
+}
+
+static bool is_mandatory_card(const char *card) {
+	static const char *mandatory[] = { "SIMPLE  ", "BITPIX  ", "NAXIS   ", "NAXIS1  ", "NAXIS2  ", "NAXIS3  ", "EXTEND  ", NULL };
+	for (int i = 0; mandatory[i]; i++) {
+		if (!strncmp(card, mandatory[i], 8))
+			return true;
+	}
+	return false;
+}
+
+static unsigned long fits_padded_size(unsigned long size) {
+	return (size + FITS_RECORD_SIZE - 1) / FITS_RECORD_SIZE * FITS_RECORD_SIZE;
+}
+
+indigo_result indigo_compress_fits(const char *header, int header_size, const void *data, int width, int height, int byte_per_pixel, int components, indigo_fits_compression compression, char **out, unsigned long *out_size) {
+	fits_tiles tiles = { data, width, height * components, byte_per_pixel, compression };
+	int band_count = (tiles.tile_count + COMPRESSION_TILE_ROWS - 1) / COMPRESSION_TILE_ROWS;
+	unsigned long tile_bound = (unsigned long)width * byte_per_pixel;
+	if (compression == INDIGO_FITS_RICE)
+		tile_bound += byte_per_pixel + width / RICE_BLOCK_SIZE + 2;
+	else
+		tile_bound = compressBound(tile_bound) + 18;
+	tiles.band_bound = tile_bound * COMPRESSION_TILE_ROWS;
+	tiles.bands = indigo_safe_malloc(band_count * sizeof(unsigned char *));
+	tiles.sizes = indigo_safe_malloc(tiles.tile_count * sizeof(int));
+	run_compression_jobs((void (*)(void *, int))fits_tile_worker, &tiles, band_count);
+	indigo_result result = INDIGO_OK;
+	if (tiles.failed) {
+		result = INDIGO_FAILED;
+	} else {
+		int card_count = 0, max_size = 0;
+		unsigned long heap_size = 0;
+		for (int i = 0; i < tiles.tile_count; i++) {
+			heap_size += tiles.sizes[i];
+			if (tiles.sizes[i] > max_size)
+				max_size = tiles.sizes[i];
+		}
+		for (int i = 0; i < header_size && strncmp(header + i, "END     ", 8); i += 80)
+			card_count++;
+		unsigned long table_size = 8UL * tiles.tile_count;
+		// header size is not known until mandatory cards are skipped, buffer is allocated for the worst case
+		unsigned long extension_header_size = fits_padded_size((card_count + 32) * 80);
+		char *buffer = *out = indigo_safe_realloc(*out, FITS_RECORD_SIZE + extension_header_size + fits_padded_size(table_size + heap_size));
+		memset(buffer, ' ', FITS_RECORD_SIZE + extension_header_size);
+		char *pnt = buffer;
+		pnt = fits_card(pnt, "SIMPLE  = %20c / file conforms to FITS standard", 'T');
+		pnt = fits_card(pnt, "BITPIX  = %20d / number of bits per data pixel", 8);
+		pnt = fits_card(pnt, "NAXIS   = %20d / number of data axes", 0);
+		pnt = fits_card(pnt, "EXTEND  = %20c / FITS dataset may contain extensions", 'T');
+		fits_card(pnt, "END");
+		pnt = buffer + FITS_RECORD_SIZE;
+		pnt = fits_card(pnt, "XTENSION= 'BINTABLE'           / binary table extension");
+		pnt = fits_card(pnt, "BITPIX  = %20d / 8-bit bytes", 8);
+		pnt = fits_card(pnt, "NAXIS   = %20d / 2-dimensional binary table", 2);
+		pnt = fits_card(pnt, "NAXIS1  = %20d / width of table in bytes", 8);
+		pnt = fits_card(pnt, "NAXIS2  = %20d / number of rows in table", tiles.tile_count);
+		pnt = fits_card(pnt, "PCOUNT  = %20lu / size of special data area", heap_size);
+		pnt = fits_card(pnt, "GCOUNT  = %20d / one data group (required keyword)", 1);
+		pnt = fits_card(pnt, "TFIELDS = %20d / number of fields in each row", 1);
+		pnt = fits_card(pnt, "TTYPE1  = 'COMPRESSED_DATA'    / label for field 1");
+		pnt = fits_card(pnt, "TFORM1  = '1PB(%d)'%*c / data format of field: variable length array", max_size, (int)(11 - snprintf(NULL, 0, "%d", max_size)), ' ');
+		pnt = fits_card(pnt, "ZIMAGE  = %20c / extension contains compressed image", 'T');
+		pnt = fits_card(pnt, "ZBITPIX = %20d / data type of original image", byte_per_pixel * 8);
+		pnt = fits_card(pnt, "ZNAXIS  = %20d / dimension of original image", components > 1 ? 3 : 2);
+		pnt = fits_card(pnt, "ZNAXIS1 = %20d / length of original image axis", width);
+		pnt = fits_card(pnt, "ZNAXIS2 = %20d / length of original image axis", height);
+		if (components > 1)
+			pnt = fits_card(pnt, "ZNAXIS3 = %20d / length of original image axis", components);
+		pnt = fits_card(pnt, "ZTILE1  = %20d / size of tiles to be compressed", width);
+		pnt = fits_card(pnt, "ZTILE2  = %20d / size of tiles to be compressed", 1);
+		if (components > 1)
+			pnt = fits_card(pnt, "ZTILE3  = %20d / size of tiles to be compressed", 1);
+		if (compression == INDIGO_FITS_RICE) {
+			pnt = fits_card(pnt, "ZCMPTYPE= 'RICE_1'             / compression algorithm");
+			pnt = fits_card(pnt, "ZNAME1  = 'BLOCKSIZE'          / compression block size");
+			pnt = fits_card(pnt, "ZVAL1   = %20d / pixels per block", RICE_BLOCK_SIZE);
+			pnt = fits_card(pnt, "ZNAME2  = 'BYTEPIX'            / bytes per pixel (1, 2, 4, or 8)");
+			pnt = fits_card(pnt, "ZVAL2   = %20d / bytes per pixel (1, 2, 4, or 8)", byte_per_pixel);
+		} else {
+			pnt = fits_card(pnt, "ZCMPTYPE= 'GZIP_2'             / compression algorithm");
+		}
+		for (int i = 0; i < card_count * 80; i += 80) {
+			if (!is_mandatory_card(header + i)) {
+				memcpy(pnt, header + i, 80);
+				pnt += 80;
+			}
+		}
+		pnt = fits_card(pnt, "END");
+		extension_header_size = fits_padded_size(pnt - buffer - FITS_RECORD_SIZE);
+		unsigned long size = FITS_RECORD_SIZE + extension_header_size + fits_padded_size(table_size + heap_size);
+		unsigned char *table = (unsigned char *)buffer + FITS_RECORD_SIZE + extension_header_size;
+		unsigned char *heap = table + table_size;
+		uint32_t offset = 0;
+		for (int i = 0; i < tiles.tile_count; i++) {
+			uint32_t descriptor[2] = { tiles.sizes[i], offset };
+			for (int j = 0; j < 8; j++)
+				*table++ = descriptor[j / 4] >> (24 - 8 * (j % 4));
+			offset += tiles.sizes[i];
+		}
+		for (int i = 0; i < band_count; i++) {
+			unsigned char *band = tiles.bands[i];
+			int last = (i + 1) * COMPRESSION_TILE_ROWS < tiles.tile_count ? (i + 1) * COMPRESSION_TILE_ROWS : tiles.tile_count;
+			for (int j = i * COMPRESSION_TILE_ROWS; j < last; j++) {
+				memcpy(heap, band, tiles.sizes[j]);
+				heap += tiles.sizes[j];
+				band += tiles.sizes[j];
+			}
+		}
+		memset(heap, 0, buffer + size - (char *)heap);
+		*out_size = size;
+	}
+	for (int i = 0; i < band_count; i++)
+		indigo_safe_free(tiles.bands[i]);
+	indigo_safe_free(tiles.bands);
+	indigo_safe_free(tiles.sizes);
+	return result;
+}
+
+// Blocks are compressed to raw deflate streams terminated by sync flush, so they can be concatenated into single zlib stream
+
+typedef struct {
+	const unsigned char *data;
+	unsigned long size;
+	int item_size;
+	int block_count;
+	unsigned char **blocks;
+	unsigned long *sizes;
+	uLong *checksums;
+	bool failed;
+} shuffled_blocks;
+
+static void shuffled_block_worker(shuffled_blocks *job, int block) {
+	unsigned long start = (unsigned long)block * COMPRESSION_BLOCK_SIZE;
+	unsigned long length = start + COMPRESSION_BLOCK_SIZE < job->size ? COMPRESSION_BLOCK_SIZE : job->size - start;
+	unsigned long count = job->size / job->item_size;
+	unsigned char *shuffled = indigo_safe_malloc(length);
+	for (unsigned long i = 0; i < length; i++) {
+		unsigned long k = start + i;
+		unsigned long byte = k / count;
+		shuffled[i] = byte < job->item_size ? job->data[(k % count) * job->item_size + byte] : job->data[k];
+	}
+	job->checksums[block] = adler32(adler32(0, NULL, 0), shuffled, (uInt)length);
+	z_stream stream = { 0 };
+	if (deflateInit2(&stream, COMPRESSION_LEVEL, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		job->failed = true;
+		free(shuffled);
+		return;
+	}
+	unsigned long bound = deflateBound(&stream, length) + 16;
+	job->blocks[block] = indigo_safe_malloc(bound);
+	stream.next_in = shuffled;
+	stream.avail_in = (uInt)length;
+	stream.next_out = job->blocks[block];
+	stream.avail_out = (uInt)bound;
+	int status = deflate(&stream, block == job->block_count - 1 ? Z_FINISH : Z_SYNC_FLUSH);
+	if (status != Z_STREAM_END && !(status == Z_OK && stream.avail_in == 0))
+		job->failed = true;
+	job->sizes[block] = bound - stream.avail_out;
+	deflateEnd(&stream);
+	free(shuffled);
+}
+
+indigo_result indigo_compress_shuffled(const void *data, unsigned long size, int item_size, char **out, unsigned long *out_size) {
+	shuffled_blocks job = { data, size, size < item_size ? 1 : item_size, (int)((size + COMPRESSION_BLOCK_SIZE - 1) / COMPRESSION_BLOCK_SIZE) };
+	if (job.block_count == 0)
+		return INDIGO_FAILED;
+	job.blocks = indigo_safe_malloc(job.block_count * sizeof(unsigned char *));
+	job.sizes = indigo_safe_malloc(job.block_count * sizeof(unsigned long));
+	job.checksums = indigo_safe_malloc(job.block_count * sizeof(uLong));
+	run_compression_jobs((void (*)(void *, int))shuffled_block_worker, &job, job.block_count);
+	indigo_result result = INDIGO_FAILED;
+	if (!job.failed) {
+		unsigned long compressed_size = 6;
+		for (int i = 0; i < job.block_count; i++)
+			compressed_size += job.sizes[i];
+		unsigned char *pnt = (unsigned char *)(*out = indigo_safe_realloc(*out, compressed_size));
+		*pnt++ = 0x78;
+		*pnt++ = 0x01;
+		uLong checksum = job.checksums[0];
+		for (int i = 0; i < job.block_count; i++) {
+			memcpy(pnt, job.blocks[i], job.sizes[i]);
+			pnt += job.sizes[i];
+			if (i > 0)
+				checksum = adler32_combine(checksum, job.checksums[i], i < job.block_count - 1 ? COMPRESSION_BLOCK_SIZE : size - (unsigned long)i * COMPRESSION_BLOCK_SIZE);
+		}
+		*pnt++ = checksum >> 24;
+		*pnt++ = checksum >> 16;
+		*pnt++ = checksum >> 8;
+		*pnt++ = checksum;
+		*out_size = compressed_size;
+		result = INDIGO_OK;
+	}
+	for (int i = 0; i < job.block_count; i++)
+		indigo_safe_free(job.blocks[i]);
+	indigo_safe_free(job.blocks);
+	indigo_safe_free(job.sizes);
+	indigo_safe_free(job.checksums);
+	return result;
+}
+
 indigo_result indigo_raw_to_fits(char *image, int in_size, char **fits, int *fits_size, indigo_fits_keyword *keywords) {
 	int byte_per_pixel = 0, components = 0;
 	int frame_width = 0, frame_height = 0;
@@ -116,7 +558,7 @@ indigo_result indigo_raw_to_fits(char *image, int in_size, char **fits, int *fit
 	}
 
 	char *p = buffer;
-	memset(buffer, ' ', image_size);
+	memset(buffer, ' ', FITS_RECORD_SIZE);
 
 	int t = sprintf(p, "SIMPLE  = %20c", 'T'); p[t] = ' ';
 	t = sprintf(p += 80, "BITPIX  = %20d", byte_per_pixel * 8); p[t] = ' ';
@@ -155,11 +597,11 @@ indigo_result indigo_raw_to_fits(char *image, int in_size, char **fits, int *fit
 	}
 
 	/* add embedded keywords to the fits header */
-	int extension_length = in_size - data_size - sizeof(indigo_raw_header);
+	int extension_length = in_size - data_size * components - sizeof(indigo_raw_header);
 	if (extension_length > 9) {
 		char *extension = indigo_safe_malloc(extension_length + 1);
 		char *extension_start = extension;
-		strncpy(extension, image + data_size, extension_length);
+		strncpy(extension, image + data_size * components, extension_length);
 		if (!strncmp(extension_start, "SIMPLE=T;", 9)) {
 			extension_start += 9;
 			extension_length -= 9;
@@ -183,48 +625,8 @@ indigo_result indigo_raw_to_fits(char *image, int in_size, char **fits, int *fit
 	t = sprintf(p += 80, "COMMENT   Converted from INDIGO RAW format. See www.indigo-astronomy.org"); p[t] = ' ';
 	t = sprintf(p += 80, "END"); p[t] = ' ';
 	p = buffer + FITS_RECORD_SIZE;
-	if (components == 1) {
-		// mono
-		if (byte_per_pixel == 2) {
-			// 16 bit RAW - swap endianness
-			uint16_t *in = (uint16_t *)image;
-			uint16_t *out = (uint16_t *)p;
-			for (int i = 0; i < pixel_count; i++) {
-				int value = *in++ - 32768;
-				*out++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-			}
-		} else {
-			// 8 bit RAW
-			memcpy(p, image, pixel_count);
-		}
-	} else {
-		// RGB
-		if (byte_per_pixel == 2) {
-			uint16_t *out_ch0 = (uint16_t *)p;
-			uint16_t *out_ch1 = (uint16_t *)p + pixel_count;
-			uint16_t *out_ch2 = (uint16_t *)p + 2 * pixel_count;
-			// 16 bit RGB - average and swap endianness
-			uint16_t *in = (uint16_t *)image;
-			for (int i = 0; i < pixel_count * 3; i++) {
-				int value =  *in++ - 32768;
-				*out_ch0++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-				value =  *in++ - 32768;
-				*out_ch1++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-				value =  *in++ - 32768;
-				*out_ch2++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-			}
-		} else {
-			uint8_t *out_ch0 = (uint8_t *)p;
-			uint8_t *out_ch1 = (uint8_t *)p + pixel_count;
-			uint8_t *out_ch2 = (uint8_t *)p + 2 * pixel_count;
-			uint8_t *in = (uint8_t *)image;
-			for (int i = 0; i < pixel_count; i++) {
-				*out_ch0++ = *in++;
-				*out_ch1++ = *in++;
-				*out_ch2++ = *in++;
-			}
-		}
-	}
+	indigo_raw_to_fits_data(image, p, pixel_count, byte_per_pixel, components, true, true);
+	memset(p + data_size * components, 0, image_size - FITS_RECORD_SIZE - data_size * components);
 	*fits = buffer;
 	*fits_size = image_size;
 	return INDIGO_OK;
@@ -37,6 +37,8 @@
 #include <termios.h>
 #include <netdb.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <zlib.h>
@@ -215,6 +217,8 @@ static int open_tty(const char *tty_name, const struct termios *options, struct
 		return -1;
 	}
 
+	// input buffered for previous handle with the same number is no longer valid
+	indigo_detach_reader(tty_fd);
 	return tty_fd;
 }
 
@@ -268,6 +272,8 @@ static int open_socket(const char *host, int port, int type) {
 		handle = -1;
 	}
 	freeaddrinfo(address_list);
+	if (handle >= 0)
+		indigo_detach_reader(handle);
 	return handle;
 }
 
@@ -365,9 +371,163 @@ int indigo_open_network_device(const char *url, int default_port, indigo_network
 	return -1;
 }
 
-int indigo_read(int handle, char *buffer, long length) {
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+
+#define READER_BUFFER_SIZE	4096
+
+typedef struct indigo_reader {
+	int handle;
+	long timeout;
+	int use_count;
+	bool detached;
+	int start, end;
+	struct indigo_reader *next;
+	char buffer[READER_BUFFER_SIZE];
+} indigo_reader;
+
+static indigo_reader *readers = NULL;
+static volatile int reader_count = 0;
+static pthread_mutex_t reader_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// reader is retained until release_reader(), so it can't be freed by concurrent indigo_detach_reader()
+
+static indigo_reader *find_reader(int handle) {
+	if (reader_count == 0)
+		return NULL;
+	pthread_mutex_lock(&reader_mutex);
+	indigo_reader *reader = readers;
+	while (reader != NULL && reader->handle != handle)
+		reader = reader->next;
+	if (reader != NULL)
+		reader->use_count++;
+	pthread_mutex_unlock(&reader_mutex);
+	return reader;
+}
+
+static void release_reader(indigo_reader *reader) {
+	if (reader == NULL)
+		return;
+	pthread_mutex_lock(&reader_mutex);
+	if (--reader->use_count == 0 && reader->detached)
+		free(reader);
+	pthread_mutex_unlock(&reader_mutex);
+}
+
+static bool wait_for_input(indigo_reader *reader) {
+	if (reader->timeout <= 0)
+		return true;
+	struct pollfd fd = { reader->handle, POLLIN, 0 };
+	int result;
+	do {
+		result = poll(&fd, 1, (int)((reader->timeout + 999) / 1000));
+	} while (result < 0 && errno == EINTR);
+	if (result == 0)
+		errno = ETIMEDOUT;
+	return result > 0;
+}
+
+static long fill_reader(indigo_reader *reader) {
+	if (reader->start == reader->end) {
+		reader->start = reader->end = 0;
+	} else if (reader->end == READER_BUFFER_SIZE) {
+		memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+		reader->end -= reader->start;
+		reader->start = 0;
+	}
+	if (!wait_for_input(reader))
+		return -1;
+	long bytes_read = read(reader->handle, reader->buffer + reader->end, READER_BUFFER_SIZE - reader->end);
+	if (bytes_read > 0)
+		reader->end += bytes_read;
+	return bytes_read;
+}
+
+// reader is created if needed and retained
+
+static indigo_reader *retain_reader(int handle, long timeout, bool set_timeout) {
+	pthread_mutex_lock(&reader_mutex);
+	indigo_reader *reader = readers;
+	while (reader != NULL && reader->handle != handle)
+		reader = reader->next;
+	if (reader == NULL) {
+		reader = indigo_safe_malloc(sizeof(indigo_reader));
+		reader->handle = handle;
+		reader->next = readers;
+		readers = reader;
+		reader_count++;
+		set_timeout = true;
+	}
+	if (set_timeout)
+		reader->timeout = timeout;
+	reader->use_count++;
+	pthread_mutex_unlock(&reader_mutex);
+	return reader;
+}
+
+bool indigo_attach_reader(int handle, long timeout) {
+	if (handle < 0)
+		return false;
+	release_reader(retain_reader(handle, timeout, true));
+	return true;
+}
+
+void indigo_detach_reader(int handle) {
+	pthread_mutex_lock(&reader_mutex);
+	for (indigo_reader **previous = &readers; *previous != NULL; previous = &(*previous)->next) {
+		indigo_reader *reader = *previous;
+		if (reader->handle == handle) {
+			*previous = reader->next;
+			reader_count--;
+			if (reader->use_count == 0)
+				free(reader);
+			else
+				reader->detached = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&reader_mutex);
+}
+
+void indigo_flush_reader(int handle) {
+	indigo_reader *reader = find_reader(handle);
+	if (reader != NULL) {
+		if (reader->start < reader->end)
+			INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> // %d bytes discarded", handle, reader->end - reader->start));
+		reader->start = reader->end = 0;
+		release_reader(reader);
+	}
+}
+
+void indigo_close_reader(int handle) {
+	indigo_detach_reader(handle);
+	close(handle);
+}
+
+#endif
+
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+static int read_buffer(int handle, indigo_reader *reader, char *buffer, long length) {
+#else
+static int read_buffer(int handle, char *buffer, long length) {
+#endif
 	long remains = length;
 	long total_bytes = 0;
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	if (reader != NULL) {
+		long buffered = reader->end - reader->start;
+		if (buffered > 0) {
+			if (buffered > remains)
+				buffered = remains;
+			memcpy(buffer, reader->buffer + reader->start, buffered);
+			reader->start += buffered;
+			if (buffered == remains)
+				return (int)buffered;
+			total_bytes = buffered;
+			buffer += buffered;
+			remains -= buffered;
+		}
+	}
+#endif
 	while (true) {
 #if defined(INDIGO_WINDOWS)
 		long bytes_read = recv(handle, buffer, remains, 0);
@@ -375,6 +535,8 @@ int indigo_read(int handle, char *buffer, long length) {
 			Sleep(500);
 			continue;
 		}
+#elif defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+		long bytes_read = (reader == NULL || wait_for_input(reader)) ? read(handle, buffer, remains) : -1;
 #else
 		long bytes_read = read(handle, buffer, remains);
 #endif
@@ -392,6 +554,17 @@ int indigo_read(int handle, char *buffer, long length) {
 	}
 }
 
+int indigo_read(int handle, char *buffer, long length) {
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	indigo_reader *reader = find_reader(handle);
+	int result = read_buffer(handle, reader, buffer, length);
+	release_reader(reader);
+	return result;
+#else
+	return read_buffer(handle, buffer, length);
+#endif
+}
+
 #if defined(INDIGO_WINDOWS)
 int indigo_recv(int handle, char *buffer, long length) {
 	while (true) {
@@ -409,9 +582,90 @@ int indigo_close(int handle) {
 }
 #endif
 
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+static int read_buffered_line(int handle, indigo_reader *reader, char *buffer, int length) {
+	char c = '\0';
+	long total_bytes = 0;
+	while (total_bytes < length) {
+		long bytes_read = 0;
+		if (reader->start == reader->end && (bytes_read = fill_reader(reader)) <= 0) {
+			if (bytes_read < 0 && errno == ETIMEDOUT) {
+				INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> // Timeout", handle));
+			} else {
+				errno = ECONNRESET;
+				INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> // Connection reset", handle));
+			}
+			return -1;
+		}
+		c = reader->buffer[reader->start++];
+		if (c == '\r')
+			;
+		else if (c != '\n')
+			buffer[total_bytes++] = c;
+		else
+			break;
+	}
+	buffer[total_bytes] = '\0';
+	INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> %s", handle, buffer));
+	return (int)total_bytes;
+}
+#endif
+
 int indigo_read_line(int handle, char *buffer, int length) {
 	char c = '\0';
 	long total_bytes = 0;
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	indigo_reader *reader = find_reader(handle);
+	// sockets are peeked and only the line itself is consumed, so poll/select and raw reads see the rest
+	while (reader == NULL && total_bytes < length) {
+		char *data = buffer + total_bytes;
+		long bytes_peeked = recv(handle, data, length - total_bytes, MSG_PEEK);
+		if (bytes_peeked < 0 && errno == EINTR)
+			continue;
+		if (bytes_peeked < 0 && errno == ENOTSOCK) {
+			// other handles get input buffer on first use, it is released by indigo_close_reader()
+			reader = retain_reader(handle, 0, false);
+			break;
+		}
+		if (bytes_peeked <= 0) {
+			errno = ECONNRESET;
+			INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> // Connection reset", handle));
+			return -1;
+		}
+		long count = 0, stored = total_bytes;
+		bool eol = false;
+		while (count < bytes_peeked && stored < length) {
+			c = data[count++];
+			if (c == '\n') {
+				eol = true;
+				break;
+			}
+			if (c != '\r')
+				stored++;
+		}
+		long bytes_read = recv(handle, data, count, 0);
+		if (bytes_read <= 0) {
+			errno = ECONNRESET;
+			INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> // Connection reset", handle));
+			return -1;
+		}
+		for (long i = 0; i < bytes_read; i++) {
+			c = data[i];
+			if (c != '\r' && c != '\n')
+				buffer[total_bytes++] = c;
+		}
+		if (eol && bytes_read == count)
+			break;
+	}
+	if (reader != NULL) {
+		int result = read_buffered_line(handle, reader, buffer, length);
+		release_reader(reader);
+		return result;
+	}
+	buffer[total_bytes] = '\0';
+	INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> %s", handle, buffer));
+	return (int)total_bytes;
+#else
 	while (total_bytes < length) {
 #if defined(INDIGO_WINDOWS)
 		long bytes_read = recv(handle, &c, 1, 0);
@@ -438,6 +692,7 @@ int indigo_read_line(int handle, char *buffer, int length) {
 	buffer[total_bytes] = '\0';
 	INDIGO_TRACE_PROTOCOL(indigo_trace("%d -> %s", handle, buffer));
 	return (int)total_bytes;
+#endif
 }
 
 bool indigo_write(int handle, const char *buffer, long length) {
@@ -460,6 +715,31 @@ bool indigo_write(int handle, const char *buffer, long length) {
 	}
 }
 
+bool indigo_writev(int handle, const char *header, long header_length, const char *data, long data_length) {
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	struct iovec iov[2] = { { (void *)header, header_length }, { (void *)data, data_length } };
+	int index = 0;
+	while (index < 2) {
+		long bytes_written = writev(handle, iov + index, 2 - index);
+		if (bytes_written < 0) {
+			INDIGO_ERROR(indigo_error("%d <- // %s", handle, strerror(errno)));
+			return false;
+		}
+		while (index < 2 && bytes_written >= (long)iov[index].iov_len) {
+			bytes_written -= iov[index].iov_len;
+			index++;
+		}
+		if (index < 2) {
+			iov[index].iov_base = (char *)iov[index].iov_base + bytes_written;
+			iov[index].iov_len -= bytes_written;
+		}
+	}
+	return true;
+#else
+	return indigo_write(handle, header, header_length) && indigo_write(handle, data, data_length);
+#endif
+}
+
 bool indigo_printf(int handle, const char *format, ...) {
 	if (strchr(format, '%')) {
 		char *buffer = indigo_alloc_large_buffer();
@@ -492,6 +772,15 @@ int indigo_scanf(int handle, const char *format, ...) {
 }
 
 int indigo_select(int handle, long usec) {
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	indigo_reader *reader = find_reader(handle);
+	if (reader != NULL) {
+		bool buffered = reader->start < reader->end;
+		release_reader(reader);
+		if (buffered)
+			return 1;
+	}
+#endif
 	struct timeval tv;
 	fd_set readout;
 	FD_ZERO(&readout);
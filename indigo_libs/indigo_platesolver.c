@@ -117,6 +117,14 @@ static bool abort_mount_move(indigo_device *device) {
 #define mount_sync(device, ra, dec, settle_time) mount_control(device, AGENT_MOUNT_START_SYNC_ITEM_NAME, ra, dec, settle_time)
 #define mount_slew(device, ra, dec, settle_time) mount_control(device, AGENT_MOUNT_START_SLEW_ITEM_NAME, ra, dec, settle_time)
 
+static bool mount_process_started(indigo_device *device, void *data) {
+	return INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested || INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state == INDIGO_BUSY_STATE || INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state == INDIGO_ALERT_STATE;
+}
+
+static bool mount_process_finished(indigo_device *device, void *data) {
+	return INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested || INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state != INDIGO_BUSY_STATE;
+}
+
 static bool mount_control(indigo_device *device, char *operation, double ra, double dec, double settle_time) {
 	ra = fmod(ra + 24, 24.0);
 	for (int i = 0; i < FILTER_RELATED_AGENT_LIST_PROPERTY->count; i++) {
@@ -128,28 +136,20 @@ static bool mount_control(indigo_device *device, char *operation, double ra, dou
 			INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state = INDIGO_IDLE_STATE;
 			indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, item->name, AGENT_START_PROCESS_PROPERTY_NAME, operation, true);
 			indigo_debug("'%s'.'TARGET_COORDINATES' requested RA=%g, DEC=%g", item->name, ra, dec);
-			for (int i = 0; i < 300; i++) { // wait 3s to become BUSY or ALERT
-				if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested) {
-					INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested = false;
-					abort_mount_move(device);
-					return false;
-				}
-				if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state == INDIGO_BUSY_STATE || INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state == INDIGO_ALERT_STATE)
-					break;
-				indigo_usleep(10000);
+			indigo_filter_wait(device, mount_process_started, NULL, 3);
+			if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested) {
+				INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested = false;
+				abort_mount_move(device);
+				return false;
 			}
 			if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state != INDIGO_BUSY_STATE) {
 				indigo_debug("AGENT_START_PROCESS didn't become BUSY in 3s");
 			}
-			for (int i = 0; i < 6000; i++) { // wait 60s to become not BUSY
-				if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested) {
-					INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested = false;
-					abort_mount_move(device);
-					return false;
-				}
-				if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state != INDIGO_BUSY_STATE)
-					break;
-				indigo_usleep(10000);
+			indigo_filter_wait(device, mount_process_finished, NULL, 60);
+			if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested) {
+				INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested = false;
+				abort_mount_move(device);
+				return false;
 			}
 			if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state != INDIGO_OK_STATE) {
 				indigo_error("AGENT_START_PROCESS didn't become OK in 60s");
@@ -312,6 +312,7 @@ static void process_failed(indigo_device *device, char *message) {
 
 static void abort_process(indigo_device *device) {
 	INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort_process_requested = true;
+	indigo_filter_notify(device);
 	abort_exposure(device);
 	INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->abort(device);
 	reset_pa_state(device, true);
@@ -680,10 +681,10 @@ indigo_result indigo_platesolver_device_attach(indigo_device *device, const char
 		indigo_init_number_item(AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM, AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM_NAME, "Downsample", 1, 16, 1, 2);
 		indigo_init_number_item(AGENT_PLATESOLVER_HINTS_DEPTH_ITEM, AGENT_PLATESOLVER_HINTS_DEPTH_ITEM_NAME, "Depth", 0, 1000, 5, 0);
 		indigo_init_number_item(AGENT_PLATESOLVER_HINTS_CPU_LIMIT_ITEM, AGENT_PLATESOLVER_HINTS_CPU_LIMIT_ITEM_NAME, "CPU Limit (seconds)", 0, 600, 10, 180);
-		strcpy(AGENT_PLATESOLVER_HINTS_RADIUS_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_HINTS_RA_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_HINTS_DEC_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_HINTS_SCALE_ITEM->number.format, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_HINTS_RADIUS_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_HINTS_RA_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_HINTS_DEC_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_HINTS_SCALE_ITEM, "%m");
 		// -------------------------------------------------------------------------------- WCS property
 		AGENT_PLATESOLVER_WCS_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_PLATESOLVER_WCS_PROPERTY_NAME, PLATESOLVER_MAIN_GROUP, "WCS solution", INDIGO_OK_STATE, INDIGO_RO_PERM, 10);
 		if (AGENT_PLATESOLVER_WCS_PROPERTY == NULL)
@@ -698,12 +699,12 @@ indigo_result indigo_platesolver_device_attach(indigo_device *device, const char
 		indigo_init_number_item(AGENT_PLATESOLVER_WCS_SCALE_ITEM, AGENT_PLATESOLVER_WCS_SCALE_ITEM_NAME, "Pixel scale (°/pixel)", 0, 1000, 0, 0);
 		indigo_init_number_item(AGENT_PLATESOLVER_WCS_PARITY_ITEM, AGENT_PLATESOLVER_WCS_PARITY_ITEM_NAME, "Parity (-1,1)", -1, 1, 0, 0);
 		indigo_init_number_item(AGENT_PLATESOLVER_WCS_INDEX_ITEM, AGENT_PLATESOLVER_WCS_INDEX_ITEM_NAME, "Used index file", 0, 10000, 0, 0);
-		strcpy(AGENT_PLATESOLVER_WCS_RA_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_WCS_DEC_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_WCS_ANGLE_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.format, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_WCS_RA_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_WCS_DEC_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_WCS_ANGLE_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_WCS_WIDTH_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_WCS_HEIGHT_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_WCS_SCALE_ITEM, "%m");
 		// -------------------------------------------------------------------------------- SYNC property /* OBSOLETED */
 		AGENT_PLATESOLVER_SYNC_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_PLATESOLVER_SYNC_PROPERTY_NAME, PLATESOLVER_MAIN_GROUP, "Sync mode (obsolete)", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 5);
 		if (AGENT_PLATESOLVER_SYNC_PROPERTY == NULL)
@@ -741,8 +742,8 @@ indigo_result indigo_platesolver_device_attach(indigo_device *device, const char
 		indigo_init_number_item(AGENT_PLATESOLVER_PA_SETTINGS_EXPOSURE_ITEM, AGENT_PLATESOLVER_PA_SETTINGS_EXPOSURE_ITEM_NAME, "Exposure time (s) (obsolete)", 0, 60, 1, 1);
 		indigo_init_number_item(AGENT_PLATESOLVER_PA_SETTINGS_HA_MOVE_ITEM, AGENT_PLATESOLVER_PA_SETTINGS_HA_MOVE_ITEM_NAME, "Hour angle move (°)", -50, 50, 5, 20);
 		indigo_init_number_item(AGENT_PLATESOLVER_PA_SETTINGS_COMPENSATE_REFRACTION_ITEM, AGENT_PLATESOLVER_PA_SETTINGS_COMPENSATE_REFRACTION_ITEM_NAME, "Compensate refraction (1=On, 0=Off)", 0, 1, 0, 0);
-		strcpy(AGENT_PLATESOLVER_PA_SETTINGS_HA_MOVE_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_SETTINGS_COMPENSATE_REFRACTION_ITEM->number.format, "%.0f");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_SETTINGS_HA_MOVE_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_SETTINGS_COMPENSATE_REFRACTION_ITEM, "%.0f");
 		// -------------------------------------------------------------------------------- POLAR_ALIGNMENT_ERROR property
 		AGENT_PLATESOLVER_PA_STATE_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_PLATESOLVER_PA_STATE_PROPERTY_NAME, PLATESOLVER_MAIN_GROUP, "Polar alignment state", INDIGO_OK_STATE, INDIGO_RO_PERM, 12);
 		if (AGENT_PLATESOLVER_PA_STATE_PROPERTY == NULL)
@@ -759,18 +760,18 @@ indigo_result indigo_platesolver_device_attach(indigo_device *device, const char
 		indigo_init_number_item(AGENT_PLATESOLVER_PA_STATE_ALT_CORRECTION_UP_ITEM, AGENT_PLATESOLVER_PA_STATE_ALT_CORRECTION_UP_ITEM_NAME, "Altitude correction (1=Up, 0=Down)", 0, 1, 0, 0);
 		indigo_init_number_item(AGENT_PLATESOLVER_PA_STATE_AZ_CORRECTION_CW_ITEM, AGENT_PLATESOLVER_PA_STATE_AZ_CORRECTION_CW_ITEM_NAME, "Azimuth correction (1=C.W., 0=C.C.W.)", 0, 1, 0, 0);
 		indigo_init_number_item(AGENT_PLATESOLVER_PA_STATE_POLAR_ERROR_ITEM, AGENT_PLATESOLVER_PA_STATE_POLAR_ERROR_ITEM_NAME, "Polar error (°)", -45, 45, 0, 0);
-		strcpy(AGENT_PLATESOLVER_PA_STATE_ITEM->number.format, "%.0f");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_DEC_DRIFT_2_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_DEC_DRIFT_3_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_TARGET_RA_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_TARGET_DEC_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_CURRENT_RA_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_CURRENT_DEC_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_AZ_ERROR_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_ALT_ERROR_ITEM->number.format, "%m");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_ALT_CORRECTION_UP_ITEM->number.format, "%.0f");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_AZ_CORRECTION_CW_ITEM->number.format, "%.0f");
-		strcpy(AGENT_PLATESOLVER_PA_STATE_POLAR_ERROR_ITEM->number.format, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_ITEM, "%.0f");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_DEC_DRIFT_2_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_DEC_DRIFT_3_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_TARGET_RA_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_TARGET_DEC_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_CURRENT_RA_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_CURRENT_DEC_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_AZ_ERROR_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_ALT_ERROR_ITEM, "%m");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_ALT_CORRECTION_UP_ITEM, "%.0f");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_AZ_CORRECTION_CW_ITEM, "%.0f");
+		indigo_set_number_format(AGENT_PLATESOLVER_PA_STATE_POLAR_ERROR_ITEM, "%m");
 		// -------------------------------------------------------------------------------- AGENT_PLATESOLVER_GOTO_SETTINGS
 		AGENT_PLATESOLVER_GOTO_SETTINGS_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_PLATESOLVER_GOTO_SETTINGS_PROPERTY_NAME, PLATESOLVER_MAIN_GROUP, "GOTO Settings", INDIGO_OK_STATE, INDIGO_RW_PERM, 2);
 		if (AGENT_PLATESOLVER_GOTO_SETTINGS_PROPERTY == NULL)
@@ -10,9 +10,11 @@
 //
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <stdio.h>
 #include <errno.h>
+#include <unistd.h>
 #include <sys/param.h>
 
 #include <indigo/indigo_bus.h>
@@ -272,76 +274,106 @@ static void tuckey_window(double (*data)[2], int len, double alpha) {
 }
 */
 
-static void _fft(const int n, const int offset, const int delta, const double (*x)[2], double (*X)[2], double (*_X)[2]);
-
-static void fft(const int n, const double (*x)[2], double (*X)[2]) {
-	double (*_X)[2] = indigo_safe_malloc(2 * n * sizeof(double));
-	_fft(n, 0, 1, x, X, _X);
-	free(_X);
+/* FFT plans (bit reversal table and twiddle factors) are cached per size and shared by all digests */
+
+typedef struct fft_plan {
+	int n;
+	int *bit_reverse;
+	double (*twiddle)[2];
+	struct fft_plan *next;
+} fft_plan;
+
+static fft_plan *fft_plans = NULL;
+static pthread_mutex_t fft_plans_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const fft_plan *get_fft_plan(const int n) {
+	pthread_mutex_lock(&fft_plans_mutex);
+	fft_plan *plan = fft_plans;
+	while (plan && plan->n != n)
+		plan = plan->next;
+	if (plan == NULL) {
+		plan = indigo_safe_malloc(sizeof(fft_plan));
+		plan->n = n;
+		plan->bit_reverse = indigo_safe_malloc(n * sizeof(int));
+		plan->twiddle = indigo_safe_malloc((n / 2 + 1) * 2 * sizeof(double));
+		int bits = 0;
+		while ((1 << bits) < n)
+			bits++;
+		for (int i = 0; i < n; i++) {
+			int r = 0;
+			for (int b = 0; b < bits; b++)
+				if (i & (1 << b))
+					r |= 1 << (bits - 1 - b);
+			plan->bit_reverse[i] = r;
+		}
+		for (int k = 0; k < n / 2; k++) {
+			plan->twiddle[k][RE] = cos(PI_2 * k / (double)n);
+			plan->twiddle[k][IM] = -sin(PI_2 * k / (double)n);
+		}
+		plan->next = fft_plans;
+		fft_plans = plan;
+	}
+	pthread_mutex_unlock(&fft_plans_mutex);
+	return plan;
 }
 
-static void _fft(const int n, const int offset, const int delta, const double (*x)[2], double (*X)[2], double (*_X)[2]) {
-	int n2 = n / 2;
-	int k;
-	double ccos, csin;
-	int k00, k01, k10, k11;
-	double tmp0, tmp1;
-	if (n != 2) {
-		_fft(n2, offset, 2 * delta, x, _X, X);
-		_fft(n2, offset + delta, 2 * delta, x, _X, X);
-		for (k = 0; k < n2; k++) {
-			k00 = offset + k * delta;
-			k01 = k00 + n2 * delta;
-			k10 = offset + 2 * k * delta;
-			k11 = k10 + delta;
-			ccos = cos(PI_2 * k / (double)n);
-			csin = sin(PI_2 * k / (double)n);
-			tmp0 = ccos * _X[k11][RE] + csin * _X[k11][IM];
-			tmp1 = ccos * _X[k11][IM] - csin * _X[k11][RE];
-			X[k01][RE] = _X[k10][RE] - tmp0;
-			X[k01][IM] = _X[k10][IM] - tmp1;
-			X[k00][RE] = _X[k10][RE] + tmp0;
-			X[k00][IM] = _X[k10][IM] + tmp1;
+/* in-place iterative radix-2 FFT, x and X can be the same buffer */
+
+static void fft_execute(const fft_plan *plan, const double (*x)[2], double (*X)[2], const bool inverse) {
+	const int n = plan->n;
+	if ((const void *)x != (void *)X)
+		memcpy(X, x, 2 * n * sizeof(double));
+	for (int i = 0; i < n; i++) {
+		int j = plan->bit_reverse[i];
+		if (i < j) {
+			double tmp0 = X[i][RE], tmp1 = X[i][IM];
+			X[i][RE] = X[j][RE];
+			X[i][IM] = X[j][IM];
+			X[j][RE] = tmp0;
+			X[j][IM] = tmp1;
+		}
+	}
+	for (int size = 2; size <= n; size *= 2) {
+		const int n2 = size / 2;
+		const int step = n / size;
+		for (int k = 0; k < n2; k++) {
+			const double ccos = plan->twiddle[k * step][RE];
+			const double csin = inverse ? -plan->twiddle[k * step][IM] : plan->twiddle[k * step][IM];
+			for (int k0 = k; k0 < n; k0 += size) {
+				const int k1 = k0 + n2;
+				const double tmp0 = ccos * X[k1][RE] - csin * X[k1][IM];
+				const double tmp1 = ccos * X[k1][IM] + csin * X[k1][RE];
+				X[k1][RE] = X[k0][RE] - tmp0;
+				X[k1][IM] = X[k0][IM] - tmp1;
+				X[k0][RE] += tmp0;
+				X[k0][IM] += tmp1;
+			}
 		}
-	} else {
-		k00 = offset;
-		k01 = k00 + delta;
-		X[k01][RE] = x[k00][RE] - x[k01][RE];
-		X[k01][IM] = x[k00][IM] - x[k01][IM];
-		X[k00][RE] = x[k00][RE] + x[k01][RE];
-		X[k00][IM] = x[k00][IM] + x[k01][IM];
 	}
 }
 
+static void fft(const int n, const double (*x)[2], double (*X)[2]) {
+	fft_execute(get_fft_plan(n), x, X, false);
+}
+
 static void ifft(const int n, const double (*X)[2], double (*x)[2]) {
-	int n2 = n / 2;
-	int i;
-	double tmp0, tmp1;
-	fft(n, X, x);
-	x[0][RE] = x[0][RE] / n;
-	x[0][IM] = x[0][IM] / n;
-	x[n2][RE] = x[n2][RE] / n;
-	x[n2][IM] = x[n2][IM] / n;
-	for (i = 1; i < n2; i++) {
-		tmp0 = x[i][RE] / n;
-		tmp1 = x[i][IM] / n;
-		x[i][RE] = x[n-i][RE] / n;
-		x[i][IM] = x[n-i][IM] / n;
-		x[n-i][RE] = tmp0;
-		x[n-i][IM] = tmp1;
+	fft_execute(get_fft_plan(n), X, x, true);
+	for (int i = 0; i < n; i++) {
+		x[i][RE] /= n;
+		x[i][IM] /= n;
 	}
 }
 
 static void corellate_fft(const int n, const double (*X1)[2], const double (*X2)[2], double (*c)[2]) {
 	int i;
-	double (*C)[2] = indigo_safe_malloc(2 * n * sizeof(double));
-	/* pointwise multiply X1 conjugate with X2 here, store in X1 */
+	/* pointwise multiply X1 conjugate with X2 here, store in c and transform it in place */
 	for (i = 0; i < n; i++) {
-		C[i][RE] = X1[i][RE] * X2[i][RE] + X1[i][IM] * X2[i][IM];
-		C[i][IM] = X1[i][IM] * X2[i][RE] - X1[i][RE] * X2[i][IM];
+		double re = X1[i][RE] * X2[i][RE] + X1[i][IM] * X2[i][IM];
+		double im = X1[i][IM] * X2[i][RE] - X1[i][RE] * X2[i][IM];
+		c[i][RE] = re;
+		c[i][IM] = im;
 	}
-	ifft(n, C, c);
-	free(C);
+	ifft(n, c, c);
 }
 
 static double find_distance(const int n, const double (*c)[2]) {
@@ -2153,83 +2185,233 @@ static int luminance_comparator(const void *item_1, const void *item_2) {
 	return 0;
 }
 
-/* With radius < 3, no precise star positins will be determined */
-indigo_result indigo_find_stars_precise(indigo_raw_type raw_type, const void *data, const uint16_t radius, const int width, const int height, const int stars_max, indigo_star_detection star_list[], int *stars_found) {
-	if (data == NULL || star_list == NULL || stars_found == NULL) return INDIGO_FAILED;
-
-	int  size = width * height;
-	uint16_t *buf = indigo_safe_malloc(size * sizeof(uint16_t));
-	int star_size = 100;
-	const int clip_edge = height >= FIND_STAR_EDGE_CLIPPING * 4 ? FIND_STAR_EDGE_CLIPPING : (height / 4);
-	int clip_width  = width - clip_edge;
-	int clip_height = height - clip_edge;
-	uint16_t max_luminance = 0;
+#define FIND_STARS_MAX_BANDS 16
+#define FIND_STARS_MIN_BAND_HEIGHT 128
+
+typedef struct {
+	int offset;
+	uint16_t value;
+} star_candidate;
+
+typedef struct {
+	indigo_raw_type raw_type;
+	const void *data;
+	uint16_t *buf;
+	int width;
+	int first_row, last_row;
+	uint64_t sum, sum_sq;
+	uint32_t threshold;
+	int clip_edge, clip_width, clip_height;
+	star_candidate *candidates;
+	int candidate_count, candidate_size;
+} find_stars_band;
+
+static uint16_t *find_stars_buffer = NULL;
+static size_t find_stars_buffer_size = 0;
+static pthread_mutex_t find_stars_buffer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* the luminance buffer is kept for the next call, concurrent callers get a private one */
+
+static uint16_t *get_find_stars_buffer(size_t size) {
+	uint16_t *buf = NULL;
+	pthread_mutex_lock(&find_stars_buffer_mutex);
+	if (find_stars_buffer && find_stars_buffer_size >= size) {
+		buf = find_stars_buffer;
+		find_stars_buffer = NULL;
+	}
+	pthread_mutex_unlock(&find_stars_buffer_mutex);
+	if (buf == NULL)
+		buf = indigo_safe_malloc(size);
+	return buf;
+}
 
-	uint8_t *data8 = (uint8_t *)data;
-	uint16_t *data16 = (uint16_t *)data;
-	double sum = 0;
-	double sum_sq = 0;
+static void release_find_stars_buffer(uint16_t *buf, size_t size) {
+	pthread_mutex_lock(&find_stars_buffer_mutex);
+	if (find_stars_buffer == NULL || find_stars_buffer_size < size) {
+		indigo_safe_free(find_stars_buffer);
+		find_stars_buffer = buf;
+		find_stars_buffer_size = size;
+		buf = NULL;
+	}
+	pthread_mutex_unlock(&find_stars_buffer_mutex);
+	indigo_safe_free(buf);
+}
 
-	switch (raw_type) {
+static void *find_stars_luminance_worker(find_stars_band *band) {
+	uint8_t *data8 = (uint8_t *)band->data;
+	uint16_t *data16 = (uint16_t *)band->data;
+	int first = band->first_row * band->width;
+	int last = band->last_row * band->width;
+	uint16_t *buf = band->buf;
+	uint64_t sum = 0, sum_sq = 0;
+	switch (band->raw_type) {
 		case INDIGO_RAW_MONO8: {
-			max_luminance = 0xFF;
-			for (int i = 0; i < size; i++) {
-				buf[i] = data8[i];
-				sum += buf[i];
-				sum_sq += buf[i] * buf[i];
+			for (int i = first; i < last; i++) {
+				uint32_t value = buf[i] = data8[i];
+				sum += value;
+				sum_sq += value * value;
 			}
 			break;
 		}
 		case INDIGO_RAW_MONO16: {
-			max_luminance = 0xFFFF;
-			for (int i = 0; i < size; i++) {
-				buf[i] = data16[i];
-				sum += buf[i];
-				sum_sq += buf[i] * buf[i];
+			for (int i = first; i < last; i++) {
+				uint64_t value = buf[i] = data16[i];
+				sum += value;
+				sum_sq += value * value;
 			}
 			break;
 		}
 		case INDIGO_RAW_RGB24: {
-			max_luminance = 0xFF;
-			for (int i = 0, j = 0; i < 3 * size; i++, j++) {
-				buf[j] = (data8[i] + data8[i + 1] + data8[i + 2]) / 3;
-				sum += buf[j];
-				sum_sq += buf[j] * buf[j];
-				i += 2;
+			for (int j = first; j < last; j++) {
+				int i = 3 * j;
+				uint32_t value = buf[j] = (data8[i] + data8[i + 1] + data8[i + 2]) / 3;
+				sum += value;
+				sum_sq += value * value;
 			}
 			break;
 		}
 		case INDIGO_RAW_RGBA32: {
-			max_luminance = 0xFF;
-			for (int i = 0, j = 0; i < 4 * size; i++, j++) {
-				buf[j] = (data8[i] + data8[i + 1] + data8[i + 2]) / 3;
-				sum += buf[j];
-				sum_sq += buf[j] * buf[j];
-				i += 3;
+			for (int j = first; j < last; j++) {
+				int i = 4 * j;
+				uint32_t value = buf[j] = (data8[i] + data8[i + 1] + data8[i + 2]) / 3;
+				sum += value;
+				sum_sq += value * value;
 			}
 			break;
 		}
 		case INDIGO_RAW_ABGR32: {
-			max_luminance = 0xFF;
-			for (int i = 0, j = 0; i < 4 * size; i++, j++) {
-				buf[j] = (data8[i + 1] + data8[i + 2] + data8[i + 3]) / 3;
-				sum += buf[j];
-				sum_sq += buf[j] * buf[j];
-				i += 3;
+			for (int j = first; j < last; j++) {
+				int i = 4 * j;
+				uint32_t value = buf[j] = (data8[i + 1] + data8[i + 2] + data8[i + 3]) / 3;
+				sum += value;
+				sum_sq += value * value;
 			}
 			break;
 		}
 		case INDIGO_RAW_RGB48: {
-			max_luminance = 0xFFFF;
-			for (int i = 0, j = 0; i < 3 * size; i++, j++) {
-				buf[j] = (data16[i] + data16[i + 1] + data16[i + 2]) / 3;
-				sum += buf[j];
-				sum_sq += buf[j] * buf[j];
-				i += 2;
+			for (int j = first; j < last; j++) {
+				int i = 3 * j;
+				uint64_t value = buf[j] = (data16[i] + data16[i + 1] + data16[i + 2]) / 3;
+				sum += value;
+				sum_sq += value * value;
 			}
 			break;
 		}
 	}
+	band->sum = sum;
+	band->sum_sq = sum_sq;
+	return NULL;
+}
+
+static void *find_stars_candidate_worker(find_stars_band *band) {
+	uint16_t *buf = band->buf;
+	int width = band->width;
+	uint32_t threshold = band->threshold;
+	int first_row = MAX(band->first_row, band->clip_edge);
+	int last_row = MIN(band->last_row, band->clip_height);
+	band->candidate_count = 0;
+	for (int j = first_row; j < last_row; j++) {
+		for (int i = band->clip_edge; i < band->clip_width; i++) {
+			int off = j * width + i;
+			if (
+			    buf[off] > threshold &&
+			    /* also check median of the neighbouring pixels to avoid hot pixels and lines */
+			    median3(buf[off - 1], buf[off], buf[off + 1]) > threshold &&
+			    median3(buf[off - width], buf[off], buf[off + width]) > threshold &&
+			    median3(buf[off - width - 1], buf[off], buf[off + width + 1]) > threshold &&
+			    median3(buf[off - width + 1], buf[off], buf[off + width - 1]) > threshold
+			) {
+				if (band->candidate_count == band->candidate_size) {
+					band->candidate_size = band->candidate_size ? 2 * band->candidate_size : 1024;
+					band->candidates = indigo_safe_realloc(band->candidates, band->candidate_size * sizeof(star_candidate));
+				}
+				band->candidates[band->candidate_count].offset = off;
+				band->candidates[band->candidate_count].value = buf[off];
+				band->candidate_count++;
+			}
+		}
+	}
+	return NULL;
+}
+
+static void run_find_stars_bands(void *(*worker)(find_stars_band *), find_stars_band *bands, int band_count) {
+	pthread_t threads[FIND_STARS_MAX_BANDS];
+	bool started[FIND_STARS_MAX_BANDS] = { false };
+	for (int i = 1; i < band_count; i++)
+		started[i] = pthread_create(threads + i, NULL, (void *(*)(void *))worker, bands + i) == 0;
+	worker(bands);
+	for (int i = 1; i < band_count; i++) {
+		if (started[i])
+			pthread_join(threads[i], NULL);
+		else
+			worker(bands + i);
+	}
+}
+
+static int star_candidate_comparator(const void *item_1, const void *item_2) {
+	const star_candidate *candidate_1 = item_1, *candidate_2 = item_2;
+	if (candidate_1->value != candidate_2->value)
+		return candidate_1->value > candidate_2->value ? -1 : 1;
+	return candidate_1->offset - candidate_2->offset;
+}
+
+/* With radius < 3, no precise star positins will be determined */
+indigo_result indigo_find_stars_precise(indigo_raw_type raw_type, const void *data, const uint16_t radius, const int width, const int height, const int stars_max, indigo_star_detection star_list[], int *stars_found) {
+	if (data == NULL || star_list == NULL || stars_found == NULL) return INDIGO_FAILED;
+
+	int  size = width * height;
+	uint16_t *buf = get_find_stars_buffer(size * sizeof(uint16_t));
+	int star_size = 100;
+	const int clip_edge = height >= FIND_STAR_EDGE_CLIPPING * 4 ? FIND_STAR_EDGE_CLIPPING : (height / 4);
+	int clip_width  = width - clip_edge;
+	int clip_height = height - clip_edge;
+	uint16_t max_luminance = 0;
+
+	switch (raw_type) {
+		case INDIGO_RAW_MONO8:
+		case INDIGO_RAW_RGB24:
+		case INDIGO_RAW_RGBA32:
+		case INDIGO_RAW_ABGR32:
+			max_luminance = 0xFF;
+			break;
+		case INDIGO_RAW_MONO16:
+		case INDIGO_RAW_RGB48:
+			max_luminance = 0xFFFF;
+			break;
+	}
+
+	/* The frame is processed in horizontal bands in parallel, first to get luminance and its statistics,
+	   then to collect all pixels which pass the star test. Clearing detected stars can only turn candidates
+	   down, so stars are then picked from the candidate list sorted by luminance instead of rescanning the frame.
+	*/
+	int band_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (band_count > height / FIND_STARS_MIN_BAND_HEIGHT)
+		band_count = height / FIND_STARS_MIN_BAND_HEIGHT;
+	if (band_count > FIND_STARS_MAX_BANDS)
+		band_count = FIND_STARS_MAX_BANDS;
+	if (band_count < 1)
+		band_count = 1;
+	find_stars_band bands[FIND_STARS_MAX_BANDS];
+	memset(bands, 0, sizeof(bands));
+	for (int i = 0; i < band_count; i++) {
+		bands[i].raw_type = raw_type;
+		bands[i].data = data;
+		bands[i].buf = buf;
+		bands[i].width = width;
+		bands[i].first_row = (int)((long)height * i / band_count);
+		bands[i].last_row = (int)((long)height * (i + 1) / band_count);
+		bands[i].clip_edge = clip_edge;
+		bands[i].clip_width = clip_width;
+		bands[i].clip_height = clip_height;
+	}
+	run_find_stars_bands(find_stars_luminance_worker, bands, band_count);
+	uint64_t sum_int = 0, sum_sq_int = 0;
+	for (int i = 0; i < band_count; i++) {
+		sum_int += bands[i].sum;
+		sum_sq_int += bands[i].sum_sq;
+	}
+	double sum = sum_int;
+	double sum_sq = sum_sq_int;
 
 	// Calculate mean
 	double mean = sum / size;
@@ -2247,6 +2429,23 @@ indigo_result indigo_find_stars_precise(indigo_raw_type raw_type, const void *da
 
 	int threshold_hist = threshold * 0.9;
 
+	for (int i = 0; i < band_count; i++)
+		bands[i].threshold = threshold;
+	run_find_stars_bands(find_stars_candidate_worker, bands, band_count);
+	int candidate_count = 0;
+	for (int i = 0; i < band_count; i++)
+		candidate_count += bands[i].candidate_count;
+	star_candidate *candidates = indigo_safe_malloc((candidate_count + 1) * sizeof(star_candidate));
+	candidate_count = 0;
+	for (int i = 0; i < band_count; i++) {
+		if (bands[i].candidate_count)
+			memcpy(candidates + candidate_count, bands[i].candidates, bands[i].candidate_count * sizeof(star_candidate));
+		candidate_count += bands[i].candidate_count;
+		indigo_safe_free(bands[i].candidates);
+	}
+	qsort(candidates, candidate_count, sizeof(star_candidate), star_candidate_comparator);
+	int next_candidate = 0;
+
 	int found = 0;
 	int width2 = width / 2;
 	int height2 = height / 2;
@@ -2262,21 +2461,20 @@ indigo_result indigo_find_stars_precise(indigo_raw_type raw_type, const void *da
 		star.luminance = 0;
 		star.oversaturated = 0;
 
-		for (int j = clip_edge; j < clip_height; j++) {
-			for (int i = clip_edge; i < clip_width; i++) {
-				int off = j * width + i;
-				if (
-				    buf[off] > lmax &&
-				    /* also check median of the neighbouring pixels to avoid hot pixels and lines */
-				    median3(buf[off - 1], buf[off], buf[off + 1]) > threshold &&
-				    median3(buf[off - width], buf[off], buf[off + width]) > threshold &&
-				    median3(buf[off - width - 1], buf[off], buf[off + width + 1]) > threshold &&
-				    median3(buf[off - width + 1], buf[off], buf[off + width - 1]) > threshold
-				) {
-					lmax = buf[off];
-					star.x = i;
-					star.y = j;
-				}
+		/* the first candidate not cleared (or turned down) by previously detected stars is the brightest one */
+		while (next_candidate < candidate_count) {
+			int off = candidates[next_candidate++].offset;
+			if (
+			    buf[off] > lmax &&
+			    median3(buf[off - 1], buf[off], buf[off + 1]) > threshold &&
+			    median3(buf[off - width], buf[off], buf[off + width]) > threshold &&
+			    median3(buf[off - width - 1], buf[off], buf[off + width + 1]) > threshold &&
+			    median3(buf[off - width + 1], buf[off], buf[off + width - 1]) > threshold
+			) {
+				lmax = buf[off];
+				star.x = off % width;
+				star.y = off / width;
+				break;
 			}
 		}
 		if (lmax > threshold) {
@@ -2390,7 +2588,8 @@ indigo_result indigo_find_stars_precise(indigo_raw_type raw_type, const void *da
 			break;
 		}
 	}
-	free(buf);
+	free(candidates);
+	release_find_stars_buffer(buf, size * sizeof(uint16_t));
 
 	qsort(star_list, found, sizeof(indigo_star_detection), luminance_comparator);
 
@@ -64,7 +64,7 @@ void indigo_rotator_load_calibration(indigo_device *device) {
 		char buffer[128];
 		indigo_read_line(handle, buffer, sizeof(buffer));
 		offset = atof(buffer);
-		close(handle);
+		indigo_close_reader(handle);
 		ROTATOR_POSITION_OFFSET_ITEM->number.value = ROTATOR_POSITION_OFFSET_ITEM->number.target = offset;
 		indigo_update_property(device, ROTATOR_POSITION_OFFSET_PROPERTY, NULL);
 	}
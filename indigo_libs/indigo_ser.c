@@ -23,6 +23,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -30,6 +32,14 @@
 #include <indigo/indigo_io.h>
 #include <indigo/indigo_ser.h>
 
+// frames are buffered in a ring of SER_RING_FRAMES frames, fewer for large frames to stay within SER_RING_MAX_SIZE (but at least SER_MIN_SLOTS frames)
+#define SER_RING_FRAMES		32
+#define SER_RING_MAX_SIZE	(64L * 1024 * 1024)
+#define SER_MIN_SLOTS		2
+
+// seconds between 0001-01-01 and 1970-01-01, SER time is in 100ns ticks
+#define SER_EPOCH_OFFSET	62135596800LL
+
 static bool write_int(int handle, uint32_t n) {
 	unsigned char buffer[4];
 	buffer[0] = n;
@@ -39,6 +49,34 @@ static bool write_int(int handle, uint32_t n) {
 	return indigo_write(handle, (const char *)buffer, 4);
 }
 
+static void *ser_writer(indigo_ser *ser) {
+	pthread_mutex_lock(&ser->mutex);
+	while (true) {
+		while (ser->running && ser->pending == 0)
+			pthread_cond_wait(&ser->cond, &ser->mutex);
+		if (ser->pending == 0)
+			break;
+		// write all consecutive pending slots at once
+		int head = ser->head;
+		int count = ser->pending;
+		if (head + count > ser->slot_count)
+			count = ser->slot_count - head;
+		bool failed = ser->failed;
+		pthread_mutex_unlock(&ser->mutex);
+		if (!failed && !indigo_write(ser->handle, (const char *)ser->slots + head * ser->frame_size, count * ser->frame_size)) {
+			INDIGO_ERROR(indigo_error("indigo_ser: failed to write frames (%s)", strerror(errno)));
+			failed = true;
+		}
+		pthread_mutex_lock(&ser->mutex);
+		ser->failed = failed;
+		ser->head = (head + count) % ser->slot_count;
+		ser->pending -= count;
+		pthread_cond_broadcast(&ser->cond);
+	}
+	pthread_mutex_unlock(&ser->mutex);
+	return NULL;
+}
+
 static bool write_long(int handle, uint64_t n) {
 	unsigned char buffer[8];
 	buffer[0] = n;
@@ -63,12 +101,13 @@ indigo_ser *indigo_ser_open(const char *filename, void *buffer) {
 		INDIGO_ERROR(indigo_error("indigo_ser: could not allocate memory for indigo_ser structure"));
 		goto failure;
 	}
+	memset(ser, 0, sizeof(indigo_ser));
 	ser->handle = handle;
-	ser->count = 0;
 	int result = indigo_write(handle, "LUCAM-RECORDER", 14); // 0
 	result = result && write_int(handle, 0); // 14
 	indigo_raw_header *header = (indigo_raw_header *)buffer;
 	int bits_per_pixel = 8;
+	int channels = 1;
 	switch (header->signature) {
 		case INDIGO_RAW_MONO8:
 			result = result && write_int(handle, 0); // 18
@@ -79,10 +118,12 @@ indigo_ser *indigo_ser_open(const char *filename, void *buffer) {
 			break;
 		case INDIGO_RAW_RGB24:
 			result = result && write_int(handle, 101); // 18
+			channels = 3;
 			break;
 		case INDIGO_RAW_RGB48:
 			result = result && write_int(handle, 101); // 18
 			bits_per_pixel = 16;
+			channels = 3;
 			break;
 	}
 	result = result && write_int(handle, false); // 22
@@ -95,12 +136,36 @@ indigo_ser *indigo_ser_open(const char *filename, void *buffer) {
 	result = result && indigo_write(handle, zero, 40); // 82
 	result = result && indigo_write(handle, zero, 40); // 122
 	tzset();
-	long time_utc = (time(NULL) + 62135600400L) * 10000000L;
+	long time_utc = (time(NULL) + SER_EPOCH_OFFSET) * 10000000L;
 	long timezone_diff =  (timezone - daylight ? 3600 : 0) * 10000000L;
 	result = result && write_long(handle, time_utc); // 162
 	result = result && write_long(handle, time_utc + timezone_diff); // 170
 	if (!result)
 		goto failure;
+	ser->frame_size = (size_t)header->width * header->height * channels * (bits_per_pixel / 8);
+	ser->slot_count = SER_RING_FRAMES;
+	if (ser->slot_count * ser->frame_size > SER_RING_MAX_SIZE)
+		ser->slot_count = (int)(SER_RING_MAX_SIZE / ser->frame_size);
+	if (ser->slot_count < SER_MIN_SLOTS)
+		ser->slot_count = SER_MIN_SLOTS;
+	// slots are always written before they are read, no need to clear them
+	if ((ser->slots = malloc(ser->slot_count * ser->frame_size)) == NULL) {
+		INDIGO_ERROR(indigo_error("indigo_ser: could not allocate memory for frame ring"));
+		goto failure;
+	}
+	ser->timestamps_size = 1024;
+	ser->timestamps = indigo_safe_malloc(ser->timestamps_size * sizeof(uint64_t));
+	ser->running = true;
+	pthread_mutex_init(&ser->mutex, NULL);
+	pthread_cond_init(&ser->cond, NULL);
+	if (pthread_create(&ser->writer, NULL, (void *(*)(void *))ser_writer, ser)) {
+		INDIGO_ERROR(indigo_error("indigo_ser: failed to start writer thread"));
+		pthread_cond_destroy(&ser->cond);
+		pthread_mutex_destroy(&ser->mutex);
+		indigo_safe_free(ser->slots);
+		indigo_safe_free(ser->timestamps);
+		goto failure;
+	}
 	return ser;
 failure:
 	if (handle != -1) {
@@ -111,16 +176,70 @@ failure:
 }
 
 bool indigo_ser_add_frame(indigo_ser *ser, void *buffer, size_t len) {
-	ser->count++;
-	return indigo_write(ser->handle, buffer + 12, len - 12);
+	struct timeval timestamp;
+	gettimeofday(&timestamp, NULL);
+	return indigo_ser_add_frame_with_timestamp(ser, buffer, len, &timestamp);
+}
+
+bool indigo_ser_add_frame_with_timestamp(indigo_ser *ser, void *buffer, size_t len, struct timeval *timestamp) {
+	len -= sizeof(indigo_raw_header);
+	if (len != ser->frame_size) {
+		INDIGO_ERROR(indigo_error("indigo_ser: frame size changed from %zu to %zu", ser->frame_size, len));
+		return false;
+	}
+	pthread_mutex_lock(&ser->mutex);
+	if (ser->failed) {
+		pthread_mutex_unlock(&ser->mutex);
+		return false;
+	}
+	if (ser->pending == ser->slot_count) {
+		// don't block readout, frame is dropped
+		ser->dropped++;
+		pthread_mutex_unlock(&ser->mutex);
+		return true;
+	}
+	int slot = (ser->head + ser->pending) % ser->slot_count;
+	pthread_mutex_unlock(&ser->mutex);
+	// slot is not touched by writer until pending is incremented
+	memcpy((char *)ser->slots + slot * ser->frame_size, (char *)buffer + sizeof(indigo_raw_header), len);
+	if (ser->count == ser->timestamps_size) {
+		ser->timestamps_size *= 2;
+		ser->timestamps = indigo_safe_realloc(ser->timestamps, ser->timestamps_size * sizeof(uint64_t));
+	}
+	ser->timestamps[ser->count++] = (timestamp->tv_sec + SER_EPOCH_OFFSET) * 10000000LL + timestamp->tv_usec * 10LL;
+	pthread_mutex_lock(&ser->mutex);
+	ser->pending++;
+	pthread_cond_broadcast(&ser->cond);
+	pthread_mutex_unlock(&ser->mutex);
+	return true;
 }
 
 bool indigo_ser_close(indigo_ser *ser) {
+	pthread_mutex_lock(&ser->mutex);
+	ser->running = false;
+	pthread_cond_broadcast(&ser->cond);
+	pthread_mutex_unlock(&ser->mutex);
+	pthread_join(ser->writer, NULL);
 	int handle = ser->handle;
-	if (lseek(handle, 38, SEEK_SET) && write_int(handle, ser->count)) {
-		close(handle);
-		free(ser);
-		return true;
+	bool result = !ser->failed;
+	// timestamps trailer follows the frames
+	if (result && ser->count > 0) {
+		unsigned char *trailer = (unsigned char *)ser->timestamps;
+		for (int i = 0; i < ser->count; i++) {
+			uint64_t n = ser->timestamps[i];
+			for (int j = 0; j < 8; j++)
+				trailer[8 * i + j] = n >> (8 * j);
+		}
+		result = indigo_write(handle, (const char *)trailer, 8L * ser->count);
 	}
-	return false;
+	result = result && lseek(handle, 38, SEEK_SET) == 38 && write_int(handle, ser->count);
+	if (ser->dropped)
+		INDIGO_LOG(indigo_log("indigo_ser: %d frames written, %d dropped", ser->count, ser->dropped));
+	close(handle);
+	pthread_cond_destroy(&ser->cond);
+	pthread_mutex_destroy(&ser->mutex);
+	indigo_safe_free(ser->slots);
+	indigo_safe_free(ser->timestamps);
+	free(ser);
+	return result;
 }
@@ -40,9 +40,11 @@
 #include <sys/time.h>
 #include <sys/stat.h>
 #include <netinet/in.h>
+#include <zlib.h>
 
 #ifdef INDIGO_LINUX
 #include <netinet/tcp.h>
+#include <sys/epoll.h>
 #endif
 
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
@@ -55,6 +57,7 @@
 #include <indigo/indigo_driver_xml.h>
 #include <indigo/indigo_driver_json.h>
 #include <indigo/indigo_client_xml.h>
+#include <indigo/indigo_binary.h>
 #include <indigo/indigo_base64.h>
 #include <indigo/indigo_io.h>
 
@@ -73,6 +76,7 @@ static int server_socket;
 static bool startup_initiated = true;
 static bool shutdown_initiated = false;
 static int client_count = 0;
+static pthread_mutex_t client_count_mutex = PTHREAD_MUTEX_INITIALIZER;
 static indigo_server_tcp_callback server_callback;
 
 int indigo_server_tcp_port = 7624;
@@ -95,19 +99,528 @@ static struct resource {
 
 #define BUFFER_SIZE	1024
 
-static void start_worker_thread(int *client_socket) {
-	int socket = *client_socket;
-	INDIGO_TRACE(indigo_trace("%d <- // Worker thread started", socket));
-	server_callback(++client_count);
-	int res = 0;
-	char c;
+static void update_client_count(int delta) {
+	pthread_mutex_lock(&client_count_mutex);
+	int count = client_count += delta;
+	pthread_mutex_unlock(&client_count_mutex);
+	server_callback(count);
+}
+
+// BLOB compression - content is split to blocks deflated independently by parallel workers (like pigz -i) and concatenated
+// to a single gzip member, blocks are sent as soon as they are ready
+
+#define GZIP_BLOCK_SIZE				(1024 * 1024)
+#define GZIP_MAX_WORKERS			16
+#define GZIP_SAMPLE_SIZE			(256 * 1024)
+#define GZIP_MIN_GAIN					0.1
+#define GZIP_FRAMING_SIZE			18
+
+typedef struct {
+	const unsigned char *in;
+	long in_size;
+	unsigned char *out;
+	long out_size;
+	uLong crc;
+	bool done;
+} gzip_block;
+
+typedef struct {
+	gzip_block *blocks;
+	int block_count;
+	int next_block;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+} gzip_job;
+
+static void deflate_block(gzip_block *block, bool last) {
+	z_stream stream = { 0 };
+	deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+	// sync flush marker needs few bytes over deflateBound()
+	long capacity = deflateBound(&stream, (uLong)block->in_size) + 16;
+	block->out = indigo_safe_malloc(capacity);
+	stream.next_in = (Bytef *)block->in;
+	stream.avail_in = (uInt)block->in_size;
+	stream.next_out = block->out;
+	stream.avail_out = (uInt)capacity;
+	// all but the last block end with sync flush on byte boundary and without final bit, so they can be concatenated
+	deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+	block->out_size = capacity - stream.avail_out;
+	deflateEnd(&stream);
+	block->crc = crc32(0, block->in, (uInt)block->in_size);
+}
+
+static void *gzip_worker(gzip_job *job) {
+	while (true) {
+		pthread_mutex_lock(&job->mutex);
+		int index = job->next_block++;
+		pthread_mutex_unlock(&job->mutex);
+		if (index >= job->block_count)
+			break;
+		deflate_block(job->blocks + index, index == job->block_count - 1);
+		pthread_mutex_lock(&job->mutex);
+		job->blocks[index].done = true;
+		pthread_cond_broadcast(&job->cond);
+		pthread_mutex_unlock(&job->mutex);
+	}
+	return NULL;
+}
+
+static bool is_loopback_client(int socket) {
+	struct sockaddr_storage address;
+	socklen_t length = sizeof(address);
+	if (getpeername(socket, (struct sockaddr *)&address, &length) < 0)
+		return false;
+	if (address.ss_family == AF_INET)
+		return (ntohl(((struct sockaddr_in *)&address)->sin_addr.s_addr) >> 24) == 127;
+	if (address.ss_family == AF_INET6) {
+		struct in6_addr *address6 = &((struct sockaddr_in6 *)&address)->sin6_addr;
+		return IN6_IS_ADDR_LOOPBACK(address6) || (IN6_IS_ADDR_V4MAPPED(address6) && address6->s6_addr[12] == 127);
+	}
+	return false;
+}
+
+static bool is_16bit_image(const char *format, const unsigned char *content, long size) {
+	if (!strcmp(format, ".raw") && size > sizeof(indigo_raw_header)) {
+		uint32_t signature = ((indigo_raw_header *)content)->signature;
+		return signature == INDIGO_RAW_MONO16 || signature == INDIGO_RAW_RGB48;
+	}
+	if (!strcmp(format, ".fits") && size > 2880) {
+		for (int i = 0; i < 2880; i += 80) {
+			if (!strncmp((const char *)content + i, "BITPIX  =", 9))
+				return atoi((const char *)content + i + 10) == 16;
+		}
+	}
+	return false;
+}
+
+// byte shuffle puts even and odd bytes of 16-bit pixels to separate planes, it compresses much better
+
+static unsigned char *shuffle_bytes(const unsigned char *content, long size) {
+	unsigned char *result = indigo_safe_malloc(size);
+	long half = size / 2;
+	for (long i = 0; i < half; i++) {
+		result[i] = content[2 * i];
+		result[half + i] = content[2 * i + 1];
+	}
+	if (size & 1)
+		result[size - 1] = content[size - 1];
+	return result;
+}
+
+// compression doesn't pay for local clients or for noisy data, it is estimated from a sample in the middle of the content,
+// only the sample is shuffled, so the whole content is copied only if it is going to be compressed
+
+static bool is_compression_useful(int socket, const unsigned char *content, long size, bool shuffle) {
+	if (is_loopback_client(socket)) {
+		INDIGO_TRACE(indigo_trace("%d <- // Compression skipped for local client", socket));
+		return false;
+	}
+	long sample_size = size < GZIP_SAMPLE_SIZE ? size : GZIP_SAMPLE_SIZE;
+	const unsigned char *sample_content = content + ((size - sample_size) / 2 & ~1L);
+	unsigned char *shuffled = shuffle ? shuffle_bytes(sample_content, sample_size) : NULL;
+	gzip_block sample = { shuffled ? shuffled : sample_content, sample_size };
+	deflate_block(&sample, true);
+	bool useful = sample.out_size < (1 - GZIP_MIN_GAIN) * sample_size;
+	indigo_safe_free(sample.out);
+	indigo_safe_free(shuffled);
+	if (!useful)
+		INDIGO_TRACE(indigo_trace("%d <- // Compression skipped for incompressible content", socket));
+	return useful;
+}
+
+static bool write_chunk(int socket, const void *data, long size) {
+	char header[32];
+	int length = snprintf(header, sizeof(header), "%lx\r\n", size);
+	return indigo_writev(socket, header, length, (const char *)data, size) && indigo_write(socket, "\r\n", 2);
+}
+
+static bool send_compressed_blob(int socket, char *response, int length, const unsigned char *content, long size, bool chunked) {
+	static const unsigned char gzip_header[10] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 0xff };
+	int block_count = (int)((size + GZIP_BLOCK_SIZE - 1) / GZIP_BLOCK_SIZE);
+	gzip_job job = { indigo_safe_malloc(block_count * sizeof(gzip_block)), block_count, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+	for (int i = 0; i < block_count; i++) {
+		job.blocks[i].in = content + (long)i * GZIP_BLOCK_SIZE;
+		job.blocks[i].in_size = i < block_count - 1 ? GZIP_BLOCK_SIZE : size - (long)i * GZIP_BLOCK_SIZE;
+	}
+	int worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (worker_count > block_count)
+		worker_count = block_count;
+	if (worker_count > GZIP_MAX_WORKERS)
+		worker_count = GZIP_MAX_WORKERS;
+	pthread_t workers[GZIP_MAX_WORKERS];
+	int started = 0;
+	for (int i = 0; i < worker_count; i++) {
+		if (pthread_create(workers + started, NULL, (void *(*)(void *))gzip_worker, &job) == 0)
+			started++;
+	}
+	if (started == 0)
+		gzip_worker(&job);
+	bool result = true;
+	uLong crc = crc32(0, NULL, 0);
+	long compressed_size = 0;
+	if (chunked) {
+		length += snprintf(response + length, BUFFER_SIZE - length, "Transfer-Encoding: chunked\r\n\r\n");
+		result = indigo_write(socket, response, length) && write_chunk(socket, gzip_header, sizeof(gzip_header));
+	}
+	for (int i = 0; result && i < block_count; i++) {
+		gzip_block *block = job.blocks + i;
+		pthread_mutex_lock(&job.mutex);
+		while (!block->done)
+			pthread_cond_wait(&job.cond, &job.mutex);
+		pthread_mutex_unlock(&job.mutex);
+		crc = crc32_combine(crc, block->crc, block->in_size);
+		compressed_size += block->out_size;
+		if (chunked) {
+			result = write_chunk(socket, block->out, block->out_size);
+			indigo_safe_free(block->out);
+			block->out = NULL;
+		}
+	}
+	if (!result) {
+		// stop workers, remaining blocks are not needed
+		pthread_mutex_lock(&job.mutex);
+		job.next_block = block_count;
+		pthread_mutex_unlock(&job.mutex);
+	}
+	unsigned char gzip_trailer[8];
+	for (int i = 0; i < 4; i++) {
+		gzip_trailer[i] = (crc >> (8 * i)) & 0xFF;
+		gzip_trailer[4 + i] = (size >> (8 * i)) & 0xFF;
+	}
+	if (chunked) {
+		result = result && write_chunk(socket, gzip_trailer, sizeof(gzip_trailer)) && indigo_write(socket, "0\r\n\r\n", 5);
+	} else {
+		length += snprintf(response + length, BUFFER_SIZE - length, "Content-Length: %ld\r\n\r\n", compressed_size + GZIP_FRAMING_SIZE);
+		result = indigo_writev(socket, response, length, (const char *)gzip_header, sizeof(gzip_header));
+		for (int i = 0; result && i < block_count; i++)
+			result = indigo_write(socket, (const char *)job.blocks[i].out, job.blocks[i].out_size);
+		result = result && indigo_write(socket, (const char *)gzip_trailer, sizeof(gzip_trailer));
+	}
+	for (int i = 0; i < started; i++)
+		pthread_join(workers[i], NULL);
+	for (int i = 0; i < block_count; i++)
+		indigo_safe_free(job.blocks[i].out);
+	indigo_safe_free(job.blocks);
+	pthread_mutex_destroy(&job.mutex);
+	pthread_cond_destroy(&job.cond);
+	if (result)
+		INDIGO_TRACE(indigo_trace("%d <- // %ld bytes compressed to %ld bytes in %d blocks", socket, size, compressed_size + GZIP_FRAMING_SIZE, block_count));
+	return result;
+}
+
+static bool handle_http_request(int socket) {
+	char request[BUFFER_SIZE];
+	char header[BUFFER_SIZE];
 	void *free_on_exit = NULL;
 	pthread_mutex_t *unlock_at_exit = NULL;
+	indigo_blob_buffer *release_at_exit = NULL;
+	bool keep_alive = true;
+	if (indigo_read_line(socket, request, BUFFER_SIZE) < 0)
+		return false;
+	if (!strncmp(request, "GET /", 5)) {
+		char *path = request + 4;
+		char *space = strchr(path, ' ');
+		if (space)
+			*space = 0;
+		char *params = strchr(path, '?');
+		if (params)
+			*params++ = 0;
+		char websocket_key[256] = "";
+		bool use_gzip = false;
+		bool use_chunked = false;
+		bool use_shuffle = false;
+		bool use_imagebytes = false;
+		while (indigo_read_line(socket, header, BUFFER_SIZE) > 0) {
+			if (!strncasecmp(header, "Sec-WebSocket-Key: ", 19))
+				strncpy(websocket_key, header + 19, sizeof(websocket_key));
+			if (!strcasecmp(header, "Connection: close"))
+				keep_alive = false;
+			if (!strncasecmp(header, "Accept-Encoding:", 16)) {
+				if (strstr(header + 16, "gzip"))
+					use_gzip = true;
+			}
+			if (!strncasecmp(header, "X-INDIGO-Accept:", 16)) {
+				use_chunked = strstr(header + 16, "chunked") != NULL;
+				use_shuffle = strstr(header + 16, "shuffle") != NULL;
+			}
+			if (!strncasecmp(header, "Accept:", 7)) {
+				if (strstr(header + 7, "application/imagebytes"))
+					use_imagebytes = true;
+			}
+		}
+		if (!strcmp(path, "/")) {
+			if (*websocket_key) {
+				unsigned char shaHash[SHA1_SIZE];
+				memset(shaHash, 0, sizeof(shaHash));
+				strcat(websocket_key, "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+				sha1(shaHash, websocket_key, strlen(websocket_key));
+				INDIGO_PRINTF(socket, "HTTP/1.1 101 Switching Protocols\r\n");
+				INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
+				INDIGO_PRINTF(socket, "Upgrade: websocket\r\n");
+				INDIGO_PRINTF(socket, "Connection: upgrade\r\n");
+				base64_encode((unsigned char *)websocket_key, shaHash, 20);
+				INDIGO_PRINTF(socket, "Sec-WebSocket-Accept: %s\r\n", websocket_key);
+				INDIGO_PRINTF(socket, "\r\n");
+				INDIGO_TRACE(indigo_trace("%d <- // Protocol switched to JSON-over-WebSockets", socket));
+				// adapter closes its handle, socket itself is closed by the caller
+				int handle = dup(socket);
+				indigo_client *protocol_adapter = indigo_json_device_adapter(handle, handle, true);
+				assert(protocol_adapter != NULL);
+				indigo_attach_client(protocol_adapter);
+				indigo_json_parse(NULL, protocol_adapter);
+				indigo_detach_client(protocol_adapter);
+				indigo_release_json_device_adapter(protocol_adapter);
+			} else {
+				INDIGO_PRINTF(socket, "HTTP/1.1 301 OK\r\n");
+				INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
+				INDIGO_PRINTF(socket, "Location: /mng.html\r\n");
+				INDIGO_PRINTF(socket, "Content-type: text/html\r\n");
+				INDIGO_PRINTF(socket, "\r\n");
+				INDIGO_PRINTF(socket, "<a href='/mng.html'>INDIGO Server Manager</a>");
+			}
+			keep_alive = false;
+		} else if (!strncmp(path, "/blob/", 6)) {
+			indigo_blob_entry *entry;
+			uint32_t generation;
+			if ((entry = indigo_parse_blob_path(path, &generation))) {
+				// generation only makes URLs of subsequent images distinct, lagging client fetching replaced generation gets the latest content
+				pthread_mutex_lock(unlock_at_exit = &entry->mutext);
+				if (entry->size == 0) {
+					assert(entry->content == NULL);
+					indigo_item item_copy = *entry->item;
+					item_copy.blob.size = 0;
+					item_copy.blob.value = NULL;
+					item_copy.blob.buffer = NULL;
+					if (indigo_populate_http_blob_item(&item_copy)) {
+						indigo_set_blob_content(entry, indigo_create_blob_buffer(item_copy.blob.value, item_copy.blob.size), item_copy.blob.value, item_copy.blob.size);
+					} else {
+						indigo_error("%d <- // Failed to populate BLOB", socket);
+					}
+				}
+				char working_format[INDIGO_NAME_SIZE];
+				strcpy(working_format, entry->format);
+				pthread_mutex_unlock(&entry->mutext);
+				unlock_at_exit = NULL;
+				// content is immutable, it is sent without copying and without holding the entry lock
+				void *content = NULL;
+				long working_size = 0;
+				release_at_exit = indigo_retain_blob_content(entry, 0, &content, &working_size);
+				char response[BUFFER_SIZE];
+				int length = 0;
+				if (content) {
+					void *working_copy = content;
+					bool use_compression = indigo_use_blob_buffering && use_gzip && indigo_use_blob_compression && working_size > 0 && strcmp(working_format, ".jpeg");
+					use_shuffle = use_shuffle && use_compression && is_16bit_image(working_format, content, working_size);
+					use_compression = use_compression && is_compression_useful(socket, content, working_size, use_shuffle);
+					use_shuffle = use_shuffle && use_compression;
+					if (use_shuffle)
+						working_copy = free_on_exit = shuffle_bytes(content, working_size);
+					length += snprintf(response + length, BUFFER_SIZE - length, "HTTP/1.1 200 OK\r\n");
+					if (use_compression) {
+						length += snprintf(response + length, BUFFER_SIZE - length, "Content-Encoding: gzip\r\n");
+						length += snprintf(response + length, BUFFER_SIZE - length, "X-Uncompressed-Content-Length: %ld\r\n", working_size);
+						if (use_shuffle)
+							length += snprintf(response + length, BUFFER_SIZE - length, "X-Byte-Shuffle: 2\r\n");
+					}
+					length += snprintf(response + length, BUFFER_SIZE - length, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
+					if (!strcmp(working_format, ".jpeg")) {
+						length += snprintf(response + length, BUFFER_SIZE - length, "Content-Type: image/jpeg\r\n");
+					} else {
+						length += snprintf(response + length, BUFFER_SIZE - length, "Content-Type: application/octet-stream\r\n");
+						length += snprintf(response + length, BUFFER_SIZE - length, "Content-Disposition: attachment; filename=\"%08x%s\"\r\n", entry->id, working_format);
+					}
+					if (keep_alive)
+						length += snprintf(response + length, BUFFER_SIZE - length, "Connection: keep-alive\r\n");
+					bool sent;
+					if (use_compression) {
+						sent = send_compressed_blob(socket, response, length, working_copy, working_size, use_chunked);
+					} else {
+						length += snprintf(response + length, BUFFER_SIZE - length, "Content-Length: %ld\r\n\r\n", working_size);
+						sent = indigo_writev(socket, response, length, content, working_size);
+						if (sent)
+							INDIGO_TRACE(indigo_trace("%d <- // %ld bytes", socket, working_size));
+					}
+					if (!sent) {
+						indigo_error("%d <- // %s", socket, strerror(errno));
+						goto failure;
+					}
+					if (free_on_exit) {
+						free(free_on_exit);
+						free_on_exit = NULL;
+					}
+					indigo_release_blob_buffer(release_at_exit);
+					release_at_exit = NULL;
+				} else {
+					INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
+					INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
+					INDIGO_PRINTF(socket, "\r\n");
+					INDIGO_PRINTF(socket, "BLOB content not available!\r\n");
+					INDIGO_TRACE(indigo_trace("%d <- // BLOB content not available", socket));
+					goto failure;
+				}
+			} else {
+				INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
+				INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
+				INDIGO_PRINTF(socket, "\r\n");
+				INDIGO_PRINTF(socket, "BLOB not found!\r\n");
+				INDIGO_TRACE(indigo_trace("%d <- // BLOB not found", socket));
+				goto failure;
+			}
+		} else {
+			pthread_mutex_lock(&resource_list_mutex);
+			struct resource *resource = resources;
+			while (resource) {
+				if (!strncmp(resource->path, path, strlen(resource->path)))
+					break;
+				resource = resource->next;
+			}
+			pthread_mutex_unlock(&resource_list_mutex);
+			if (resource == NULL) {
+				INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
+				INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
+				INDIGO_PRINTF(socket, "\r\n");
+				INDIGO_PRINTF(socket, "%s not found!\r\n", path);
+				INDIGO_TRACE(indigo_trace("%d <- // %s not found", socket, path));
+				goto failure;
+			} else if (resource->handler) {
+				keep_alive = resource->handler(socket, use_imagebytes ? "GET/IMAGEBYTES" : (use_gzip ? "GET/GZIP" : "GET"), path, params);
+			} else if (resource->data) {
+				INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
+				INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
+				INDIGO_PRINTF(socket, "Content-Type: %s\r\n", resource->content_type);
+				INDIGO_PRINTF(socket, "Content-Length: %d\r\n", resource->length);
+				INDIGO_PRINTF(socket, "Content-Encoding: gzip\r\n");
+				INDIGO_PRINTF(socket, "\r\n");
+				indigo_write(socket, (const char *)resource->data, resource->length);
+				INDIGO_TRACE(indigo_trace("%d <- // %d bytes", socket, resource->length));
+			} else if (resource->file_name) {
+				char file_name[256];
+				struct stat file_stat;
+				int handle;
+				if (*resource->file_name == '/') {
+					strcpy(file_name, resource->file_name);
+				} else {
+					sprintf(file_name, "%s/%s", getenv("HOME"), resource->file_name);
+				}
+				if (stat(file_name, &file_stat) < 0 || (handle = open(file_name, O_RDONLY)) < 0) {
+					INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
+					INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
+					INDIGO_PRINTF(socket, "\r\n");
+					INDIGO_PRINTF(socket, "%s not found (%s)\r\n", file_name, strerror(errno));
+					INDIGO_TRACE(indigo_trace("%d <- // Failed to stat/open file (%s, %s)", socket, file_name, strerror(errno)));
+					goto failure;
+				} else {
+					const char *base_name = strrchr(file_name, '/');
+					base_name = base_name ? base_name + 1 : file_name;
+					INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
+					INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
+					INDIGO_PRINTF(socket, "Content-Type: %s\r\n", resource->content_type);
+					INDIGO_PRINTF(socket, "Content-Disposition: attachment; filename=%s\r\n", base_name);
+					INDIGO_PRINTF(socket, "Content-Length: %d\r\n", file_stat.st_size);
+					INDIGO_PRINTF(socket, "\r\n");
+					long remaining = file_stat.st_size;
+					char buffer[128 * 1024];
+					while (remaining > 0) {
+						long count = read(handle, buffer, remaining < sizeof(buffer) ? remaining : sizeof(buffer));
+						if (count < 0) {
+							INDIGO_TRACE(indigo_trace("%d -> // %s", socket, strerror(errno)));
+							break;
+						}
+						if (indigo_write(socket, buffer, count)) {
+							INDIGO_TRACE(indigo_trace("%d <- // %ld bytes", socket, count));
+						} else {
+							INDIGO_TRACE(indigo_trace("%d <- // %s", socket, strerror(errno)));
+							goto failure;
+						}
+						remaining -= count;
+					}
+					close(handle);
+				}
+			}
+		}
+	} else if (!strncmp(request, "PUT /", 5)) {
+		char *path = request + 4;
+		char *space = strchr(path, ' ');
+		if (space)
+			*space = 0;
+		if (!strncmp(path, "/blob/", 6)) {
+			indigo_blob_entry *entry;
+			uint32_t generation;
+			if ((entry = indigo_parse_blob_path(path, &generation))) {
+				int content_length = 0;
+				char header[BUFFER_SIZE];
+				while (indigo_read_line(socket, header, INDIGO_BUFFER_SIZE) > 0) {
+					if (!strncasecmp(header, "Content-Length:", 15)) {
+						content_length = atoi(header + 15);
+					}
+				}
+				void *content = free_on_exit = malloc(content_length);
+				if (content) {
+					if (!indigo_read(socket, content, content_length))
+						goto failure;
+					free_on_exit = NULL;
+					pthread_mutex_lock(&entry->mutext);
+					indigo_set_blob_content(entry, indigo_create_blob_buffer(content, content_length), content, content_length);
+					pthread_mutex_unlock(&entry->mutext);
+					INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
+					INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
+					INDIGO_PRINTF(socket, "Content-Length: 0\r\n");
+					INDIGO_PRINTF(socket, "\r\n");
+				} else {
+					INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
+					INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
+					INDIGO_PRINTF(socket, "\r\n");
+					INDIGO_PRINTF(socket, "Out of buffer memory!\r\n");
+					INDIGO_TRACE(indigo_trace("%d <- // Out of buffer memory", socket));
+					goto failure;
+				}
+			} else {
+				INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
+				INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
+				INDIGO_PRINTF(socket, "\r\n");
+				INDIGO_PRINTF(socket, "BLOB not found!\r\n");
+				INDIGO_TRACE(indigo_trace("%d <- // BLOB not found", socket));
+				goto failure;
+			}
+		} else {
+			pthread_mutex_lock(&resource_list_mutex);
+			struct resource *resource = resources;
+			while (resource) {
+				if (!strncmp(resource->path, path, strlen(resource->path)))
+					break;
+				resource = resource->next;
+			}
+			pthread_mutex_unlock(&resource_list_mutex);
+			if (resource == NULL) {
+				INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
+				INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
+				INDIGO_PRINTF(socket, "\r\n");
+				INDIGO_PRINTF(socket, "%s not found!\r\n", path);
+				INDIGO_TRACE(indigo_trace("%d <- // %s not found", socket, path));
+				goto failure;
+			} else if (resource->handler) {
+				keep_alive = resource->handler(socket, "PUT", path, NULL);
+			}
+		}
+	}
+	return keep_alive;
+failure:
+	if (free_on_exit)
+		free(free_on_exit);
+	if (unlock_at_exit)
+		pthread_mutex_unlock(unlock_at_exit);
+	if (release_at_exit)
+		indigo_release_blob_buffer(release_at_exit);
+	return false;
+}
 
+static void serve_connection(int socket) {
+	char c;
 	if (recv(socket, &c, 1, MSG_PEEK) == 1) {
 		if (c == '<') {
 			INDIGO_TRACE(indigo_trace("%d <- // Protocol switched to XML", socket));
-			indigo_client *protocol_adapter = indigo_xml_device_adapter(socket, socket);
+			// parser closes its input handle when finished, but the writer keeps using the socket until the adapter is released
+			indigo_client *protocol_adapter = indigo_xml_device_adapter(dup(socket), socket);
 			assert(protocol_adapter != NULL);
 			indigo_attach_client(protocol_adapter);
 			indigo_xml_parse(NULL, protocol_adapter);
@@ -115,311 +628,433 @@ static void start_worker_thread(int *client_socket) {
 			indigo_release_xml_device_adapter(protocol_adapter);
 		} else if (c == '{') {
 			INDIGO_TRACE(indigo_trace("%d <- // Protocol switched to JSON", socket));
-			indigo_client *protocol_adapter = indigo_json_device_adapter(socket, socket, false);
+			// adapter closes its handle, socket itself is closed below
+			int handle = dup(socket);
+			indigo_client *protocol_adapter = indigo_json_device_adapter(handle, handle, false);
 			assert(protocol_adapter != NULL);
 			indigo_attach_client(protocol_adapter);
 			indigo_json_parse(NULL, protocol_adapter);
 			indigo_detach_client(protocol_adapter);
 			indigo_release_json_device_adapter(protocol_adapter);
-		} else if (c == 'G' || c == 'P') {
-			char request[BUFFER_SIZE];
-			char header[BUFFER_SIZE];
-			while ((res = indigo_read_line(socket, request, BUFFER_SIZE)) >= 0) {
-				bool keep_alive = true;
-				if (!strncmp(request, "GET /", 5)) {
-					char *path = request + 4;
-					char *space = strchr(path, ' ');
-					if (space)
-						*space = 0;
-					char *params = strchr(path, '?');
-					if (params)
-						*params++ = 0;
-					char websocket_key[256] = "";
-					bool use_gzip = false;
-					bool use_imagebytes = false;
-					while (indigo_read_line(socket, header, BUFFER_SIZE) > 0) {
-						if (!strncasecmp(header, "Sec-WebSocket-Key: ", 19))
-							strncpy(websocket_key, header + 19, sizeof(websocket_key));
-						if (!strcasecmp(header, "Connection: close"))
-							keep_alive = false;
-						if (!strncasecmp(header, "Accept-Encoding:", 16)) {
-							if (strstr(header + 16, "gzip"))
-								use_gzip = true;
-						}
-						if (!strncasecmp(header, "Accept:", 7)) {
-							if (strstr(header + 7, "application/imagebytes"))
-								use_imagebytes = true;
-						}
-					}
-					if (!strcmp(path, "/")) {
-						if (*websocket_key) {
-							unsigned char shaHash[SHA1_SIZE];
-							memset(shaHash, 0, sizeof(shaHash));
-							strcat(websocket_key, "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
-							sha1(shaHash, websocket_key, strlen(websocket_key));
-							INDIGO_PRINTF(socket, "HTTP/1.1 101 Switching Protocols\r\n");
-							INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
-							INDIGO_PRINTF(socket, "Upgrade: websocket\r\n");
-							INDIGO_PRINTF(socket, "Connection: upgrade\r\n");
-							base64_encode((unsigned char *)websocket_key, shaHash, 20);
-							INDIGO_PRINTF(socket, "Sec-WebSocket-Accept: %s\r\n", websocket_key);
-							INDIGO_PRINTF(socket, "\r\n");
-							INDIGO_TRACE(indigo_trace("%d <- // Protocol switched to JSON-over-WebSockets", socket));
-							indigo_client *protocol_adapter = indigo_json_device_adapter(socket, socket, true);
-							assert(protocol_adapter != NULL);
-							indigo_attach_client(protocol_adapter);
-							indigo_json_parse(NULL, protocol_adapter);
-							indigo_detach_client(protocol_adapter);
-							indigo_release_json_device_adapter(protocol_adapter);
-						} else {
-							INDIGO_PRINTF(socket, "HTTP/1.1 301 OK\r\n");
-							INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
-							INDIGO_PRINTF(socket, "Location: /mng.html\r\n");
-							INDIGO_PRINTF(socket, "Content-type: text/html\r\n");
-							INDIGO_PRINTF(socket, "\r\n");
-							INDIGO_PRINTF(socket, "<a href='/mng.html'>INDIGO Server Manager</a>");
-						}
-						keep_alive = false;
-					} else if (!strncmp(path, "/blob/", 6)) {
-						indigo_item *item;
-						indigo_blob_entry *entry;
-						if (sscanf(path, "/blob/%p.", &item) && (entry = indigo_validate_blob(item))) {
-							pthread_mutex_lock(unlock_at_exit = &entry->mutext);
-							long working_size = entry->size;
-							if (working_size == 0) {
-								assert(entry->content == NULL);
-								indigo_item item_copy = *item;
-								item_copy.blob.size = 0;
-								item_copy.blob.value = NULL;
-								if (indigo_populate_http_blob_item(&item_copy)) {
-									working_size = entry->size = item_copy.blob.size;
-									entry->content = item_copy.blob.value;
-								} else {
-									indigo_error("%d <- // Failed to populate BLOB", socket);
-								}
-							}
-							void *working_copy = indigo_use_blob_buffering ? (free_on_exit = malloc(working_size)) : entry->content;
-							if (working_copy) {
-								char working_format[INDIGO_NAME_SIZE];
-								strcpy(working_format, entry->format);
-								INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
-								if (indigo_use_blob_buffering) {
-									if (use_gzip && indigo_use_blob_compression && strcmp(entry->format, ".jpeg")) {
-										unsigned compressed_size = (unsigned)working_size;
-										indigo_compress("image", entry->content, (unsigned)working_size, working_copy, &compressed_size);
-										INDIGO_PRINTF(socket, "Content-Encoding: gzip\r\n");
-										INDIGO_PRINTF(socket, "X-Uncompressed-Content-Length: %ld\r\n", working_size);
-										working_size = compressed_size;
-									} else {
-										memcpy(working_copy, entry->content, working_size);
-									}
-									pthread_mutex_unlock(&entry->mutext);
-									unlock_at_exit = NULL;
-								}
-								INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
-								if (!strcmp(entry->format, ".jpeg")) {
-									INDIGO_PRINTF(socket, "Content-Type: image/jpeg\r\n");
-								} else {
-									INDIGO_PRINTF(socket, "Content-Type: application/octet-stream\r\n");
-									INDIGO_PRINTF(socket, "Content-Disposition: attachment; filename=\"%p%s\"\r\n", item, working_format);
-								}
-								if (keep_alive)
-									INDIGO_PRINTF(socket, "Connection: keep-alive\r\n");
-								INDIGO_PRINTF(socket, "Content-Length: %ld\r\n", working_size);
-								INDIGO_PRINTF(socket, "\r\n");
-								if (indigo_write(socket, working_copy, working_size)) {
-									INDIGO_TRACE(indigo_trace("%d <- // %ld bytes", socket, working_size));
-								} else {
-									indigo_error("%d <- // %s", socket, strerror(errno));
-									goto failure;
-								}
-								if (indigo_use_blob_buffering) {
-									free(working_copy);
-									free_on_exit = NULL;
-								} else {
-									pthread_mutex_unlock(&entry->mutext);
-									unlock_at_exit = NULL;
-								}
-							} else {
-								pthread_mutex_unlock(&entry->mutext);
-								unlock_at_exit = NULL;
-								INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
-								INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
-								INDIGO_PRINTF(socket, "\r\n");
-								INDIGO_PRINTF(socket, "Out of buffer memory!\r\n");
-								INDIGO_TRACE(indigo_trace("%d <- // Out of buffer memory", socket));
-								goto failure;
-							}
-						} else {
-							INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
-							INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
-							INDIGO_PRINTF(socket, "\r\n");
-							INDIGO_PRINTF(socket, "BLOB not found!\r\n");
-							INDIGO_TRACE(indigo_trace("%d <- // BLOB not found", socket));
-							goto failure;
-						}
-					} else {
-						pthread_mutex_lock(&resource_list_mutex);
-						struct resource *resource = resources;
-						while (resource) {
-							if (!strncmp(resource->path, path, strlen(resource->path)))
-								break;
-							resource = resource->next;
-						}
-						pthread_mutex_unlock(&resource_list_mutex);
-						if (resource == NULL) {
-							INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
-							INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
-							INDIGO_PRINTF(socket, "\r\n");
-							INDIGO_PRINTF(socket, "%s not found!\r\n", path);
-							INDIGO_TRACE(indigo_trace("%d <- // %s not found", socket, path));
-							goto failure;
-						} else if (resource->handler) {
-							keep_alive = resource->handler(socket, use_imagebytes ? "GET/IMAGEBYTES" : (use_gzip ? "GET/GZIP" : "GET"), path, params);
-						} else if (resource->data) {
-							INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
-							INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
-							INDIGO_PRINTF(socket, "Content-Type: %s\r\n", resource->content_type);
-							INDIGO_PRINTF(socket, "Content-Length: %d\r\n", resource->length);
-							INDIGO_PRINTF(socket, "Content-Encoding: gzip\r\n");
-							INDIGO_PRINTF(socket, "\r\n");
-							indigo_write(socket, (const char *)resource->data, resource->length);
-							INDIGO_TRACE(indigo_trace("%d <- // %d bytes", socket, resource->length));
-						} else if (resource->file_name) {
-							char file_name[256];
-							struct stat file_stat;
-							int handle;
-							if (*resource->file_name == '/') {
-								strcpy(file_name, resource->file_name);
-							} else {
-								sprintf(file_name, "%s/%s", getenv("HOME"), resource->file_name);
-							}
-							if (stat(file_name, &file_stat) < 0 || (handle = open(file_name, O_RDONLY)) < 0) {
-								INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
-								INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
-								INDIGO_PRINTF(socket, "\r\n");
-								INDIGO_PRINTF(socket, "%s not found (%s)\r\n", file_name, strerror(errno));
-								INDIGO_TRACE(indigo_trace("%d <- // Failed to stat/open file (%s, %s)", socket, file_name, strerror(errno)));
-								goto failure;
-							} else {
-								const char *base_name = strrchr(file_name, '/');
-								base_name = base_name ? base_name + 1 : file_name;
-								INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
-								INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
-								INDIGO_PRINTF(socket, "Content-Type: %s\r\n", resource->content_type);
-								INDIGO_PRINTF(socket, "Content-Disposition: attachment; filename=%s\r\n", base_name);
-								INDIGO_PRINTF(socket, "Content-Length: %d\r\n", file_stat.st_size);
-								INDIGO_PRINTF(socket, "\r\n");
-								long remaining = file_stat.st_size;
-								char buffer[128 * 1024];
-								while (remaining > 0) {
-									long count = read(handle, buffer, remaining < sizeof(buffer) ? remaining : sizeof(buffer));
-									if (count < 0) {
-										INDIGO_TRACE(indigo_trace("%d -> // %s", socket, strerror(errno)));
-										break;
-									}
-									if (indigo_write(socket, buffer, count)) {
-										INDIGO_TRACE(indigo_trace("%d <- // %ld bytes", socket, count));
-									} else {
-										INDIGO_TRACE(indigo_trace("%d <- // %s", socket, strerror(errno)));
-										goto failure;
-									}
-									remaining -= count;
-								}
-								close(handle);
-							}
-						}
-					}
-				} else if (!strncmp(request, "PUT /", 5)) {
-					char *path = request + 4;
-					char *space = strchr(path, ' ');
-					if (space)
-						*space = 0;
-					if (!strncmp(path, "/blob/", 6)) {
-						indigo_item *item;
-						indigo_blob_entry *entry;
-						if (sscanf(path, "/blob/%p.", &item) && (entry = indigo_validate_blob(item))) {
-							int content_length = 0;
-							char header[BUFFER_SIZE];
-							while (indigo_read_line(socket, header, INDIGO_BUFFER_SIZE) > 0) {
-								if (!strncasecmp(header, "Content-Length:", 15)) {
-									content_length = atoi(header + 15);
-								}
-							}
-							pthread_mutex_lock(unlock_at_exit = &entry->mutext);
-							entry->content = indigo_safe_realloc(entry->content, entry->size = content_length);
-							if (entry->content) {
-								if (!indigo_read(socket, entry->content, content_length))
-									goto failure;
-								pthread_mutex_unlock(&entry->mutext);
-								unlock_at_exit = NULL;
-								INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
-								INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
-								INDIGO_PRINTF(socket, "Content-Length: 0\r\n");
-								INDIGO_PRINTF(socket, "\r\n");
-							} else {
-								INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
-								INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
-								INDIGO_PRINTF(socket, "\r\n");
-								INDIGO_PRINTF(socket, "Out of buffer memory!\r\n");
-								INDIGO_TRACE(indigo_trace("%d <- // Out of buffer memory", socket));
-								goto failure;
-							}
-						} else {
-							INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
-							INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
-							INDIGO_PRINTF(socket, "\r\n");
-							INDIGO_PRINTF(socket, "BLOB not found!\r\n");
-							INDIGO_TRACE(indigo_trace("%d <- // BLOB not found", socket));
-							goto failure;
-						}
-					} else {
-						pthread_mutex_lock(&resource_list_mutex);
-						struct resource *resource = resources;
-						while (resource) {
-							if (!strncmp(resource->path, path, strlen(resource->path)))
-								break;
-							resource = resource->next;
-						}
-						pthread_mutex_unlock(&resource_list_mutex);
-						if (resource == NULL) {
-							INDIGO_PRINTF(socket, "HTTP/1.1 404 Not found\r\n");
-							INDIGO_PRINTF(socket, "Content-Type: text/plain\r\n");
-							INDIGO_PRINTF(socket, "\r\n");
-							INDIGO_PRINTF(socket, "%s not found!\r\n", path);
-							INDIGO_TRACE(indigo_trace("%d <- // %s not found", socket, path));
-							goto failure;
-						} else if (resource->handler) {
-							keep_alive = resource->handler(socket, "PUT", path, NULL);
-						}
-					}
-				}
-				if (!keep_alive) {
-					break;
-				}
+		} else if (c == INDIGO_BINARY_MAGIC[0]) {
+			if (indigo_binary_accept(socket)) {
+				INDIGO_TRACE(indigo_trace("%d <- // Protocol switched to binary", socket));
+				indigo_client *protocol_adapter = indigo_binary_device_adapter(socket, socket);
+				assert(protocol_adapter != NULL);
+				indigo_attach_client(protocol_adapter);
+				indigo_binary_parse(NULL, protocol_adapter);
+				indigo_detach_client(protocol_adapter);
+				indigo_release_binary_device_adapter(protocol_adapter);
+			} else {
+				INDIGO_TRACE(indigo_trace("%d -> // Unrecognised protocol", socket));
 			}
+		} else if (c == 'G' || c == 'P') {
+			while (handle_http_request(socket))
+				;
 		} else {
 			INDIGO_TRACE(indigo_trace("%d -> // Unrecognised protocol", socket));
 		}
 	}
-failure:
 	shutdown(socket, SHUT_RDWR);
 	indigo_usleep(ONE_SECOND_DELAY); // ???
 	close(socket);
-	server_callback(--client_count);
+}
+
+#ifndef INDIGO_LINUX
+
+static void start_worker_thread(int *client_socket) {
+	int socket = *client_socket;
 	free(client_socket);
-	if (free_on_exit)
-		free(free_on_exit);
-	if (unlock_at_exit)
-		pthread_mutex_unlock(unlock_at_exit);
+	INDIGO_TRACE(indigo_trace("%d <- // Worker thread started", socket));
+	update_client_count(1);
+	serve_connection(socket);
+	update_client_count(-1);
 	INDIGO_TRACE(indigo_trace("%d <- // Worker thread finished", socket));
 }
 
+#endif
+
+static void configure_client_socket(int client_socket) {
+	struct timeval timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_usec = 0;
+	if (setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout)) < 0)
+		indigo_error("Can't set recv() timeout (%s)", strerror(errno));
+	timeout.tv_sec = 5;
+	if (setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO, (char *)&timeout, sizeof(timeout)) < 0)
+		indigo_error("Can't set send() timeout (%s)", strerror(errno));
+}
+
+#ifdef INDIGO_LINUX
+
+// Connections are watched by epoll reactor running in indigo_server_start() thread. Reactor only peeks at incoming data,
+// complete HTTP requests are handed to a fixed pool of request workers and kept-alive connections return to the reactor,
+// so idle web clients don't hold any thread. Requests which may transfer a lot of data to or from slow client (BLOBs, files,
+// handlers and PUT bodies) get their own transfer threads, so they can't starve the pool. XML, JSON and WebSocket sessions
+// run in their own threads.
+
+#define REQUEST_WORKERS		8
+#define MAX_TRANSFERS			64
+#define MAX_SESSIONS			256
+#define PEEK_SIZE					(4 * BUFFER_SIZE)
+#define MAX_EVENTS				64
+#define LINGER_TIME				1.0
+
+typedef struct connection {
+	int socket;
+	bool busy;
+	double close_at;
+	struct connection *next;
+} connection;
+
+static int epoll_handle = -1;
+static int wake_pipe[2] = { -1, -1 };
+static bool reactor_running = false;
+static int session_count = 0;
+static int transfer_count = 0;
+static connection *connections = NULL;
+static connection *request_queue_head = NULL;
+static connection *request_queue_tail = NULL;
+static connection *closing_connections = NULL;
+static pthread_mutex_t connection_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t request_cond = PTHREAD_COND_INITIALIZER;
+
+static double reactor_time(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void wake_reactor(void) {
+	char c = 0;
+	if (wake_pipe[1] >= 0 && write(wake_pipe[1], &c, 1) < 0 && errno != EAGAIN)
+		indigo_error("Can't wake reactor (%s)", strerror(errno));
+}
+
+static void unlink_connection(connection *c) {
+	connection **link = &connections;
+	while (*link && *link != c)
+		link = &(*link)->next;
+	if (*link)
+		*link = c->next;
+}
+
+// called with connection_mutex locked
+
+static void release_connection(connection *c, bool linger) {
+	unlink_connection(c);
+	if (linger && reactor_running) {
+		// give client time to read the rest of response like the thread per connection server did
+		shutdown(c->socket, SHUT_RDWR);
+		c->close_at = reactor_time() + LINGER_TIME;
+		c->next = closing_connections;
+		if (closing_connections == NULL)
+			wake_reactor();
+		closing_connections = c;
+	} else {
+		INDIGO_TRACE(indigo_trace("%d <- // Connection closed", c->socket));
+		close(c->socket);
+		free(c);
+		pthread_mutex_unlock(&connection_mutex);
+		update_client_count(-1);
+		pthread_mutex_lock(&connection_mutex);
+	}
+}
+
+static void arm_connection(connection *c, int operation) {
+	struct epoll_event event;
+	event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+	event.data.ptr = c;
+	c->busy = false;
+	if (epoll_ctl(epoll_handle, operation, c->socket, &event) < 0) {
+		indigo_error("%d <- // Can't watch connection (%s)", c->socket, strerror(errno));
+		release_connection(c, false);
+	}
+}
+
+// called with connection_mutex locked
+
+static void finish_request(connection *c, bool keep_alive) {
+	c->next = connections;
+	connections = c;
+	if (keep_alive && reactor_running)
+		arm_connection(c, EPOLL_CTL_MOD);
+	else
+		release_connection(c, true);
+}
+
+static void *request_worker(void *arg) {
+	pthread_mutex_lock(&connection_mutex);
+	while (true) {
+		while (request_queue_head == NULL)
+			pthread_cond_wait(&request_cond, &connection_mutex);
+		connection *c = request_queue_head;
+		if ((request_queue_head = c->next) == NULL)
+			request_queue_tail = NULL;
+		pthread_mutex_unlock(&connection_mutex);
+		bool keep_alive = handle_http_request(c->socket);
+		pthread_mutex_lock(&connection_mutex);
+		finish_request(c, keep_alive);
+	}
+	return NULL;
+}
+
+static void transfer_thread(connection *c) {
+	bool keep_alive = handle_http_request(c->socket);
+	pthread_mutex_lock(&connection_mutex);
+	transfer_count--;
+	finish_request(c, keep_alive);
+	pthread_mutex_unlock(&connection_mutex);
+}
+
+static bool is_large_transfer(const char *request) {
+	if (!strncmp(request, "PUT /", 5))
+		return true;
+	if (strncmp(request, "GET /", 5))
+		return false;
+	const char *path = request + 4;
+	if (!strncmp(path, "/blob/", 6))
+		return true;
+	// only static resources are known to be small
+	bool result = false;
+	pthread_mutex_lock(&resource_list_mutex);
+	for (struct resource *resource = resources; resource; resource = resource->next) {
+		if (!strncmp(resource->path, path, strlen(resource->path))) {
+			result = resource->data == NULL;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&resource_list_mutex);
+	return result;
+}
+
+static void session_thread(int *client_socket) {
+	int socket = *client_socket;
+	free(client_socket);
+	INDIGO_TRACE(indigo_trace("%d <- // Session thread started", socket));
+	serve_connection(socket);
+	pthread_mutex_lock(&connection_mutex);
+	session_count--;
+	pthread_mutex_unlock(&connection_mutex);
+	update_client_count(-1);
+	INDIGO_TRACE(indigo_trace("%d <- // Session thread finished", socket));
+}
+
+static bool is_websocket_upgrade(const char *header) {
+	for (const char *line = header; line; line = strchr(line, '\n')) {
+		while (*line == '\r' || *line == '\n')
+			line++;
+		if (!strncasecmp(line, "Upgrade:", 8)) {
+			line += 8;
+			while (*line == ' ')
+				line++;
+			return !strncasecmp(line, "websocket", 9);
+		}
+	}
+	return false;
+}
+
+// called with connection_mutex locked
+
+static void dispatch_connection(connection *c, uint32_t events) {
+	char buffer[PEEK_SIZE + 1];
+	long count = recv(c->socket, buffer, PEEK_SIZE, MSG_PEEK | MSG_DONTWAIT);
+	if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		arm_connection(c, EPOLL_CTL_MOD);
+		return;
+	}
+	if (count <= 0) {
+		release_connection(c, false);
+		return;
+	}
+	buffer[count] = 0;
+	char first = buffer[0];
+	if (first == '<' || first == '{' || first == INDIGO_BINARY_MAGIC[0] || (first == 'G' && is_websocket_upgrade(buffer))) {
+		if (session_count >= MAX_SESSIONS) {
+			indigo_error("%d <- // Too many sessions", c->socket);
+			release_connection(c, false);
+			return;
+		}
+		epoll_ctl(epoll_handle, EPOLL_CTL_DEL, c->socket, NULL);
+		int *pointer = indigo_safe_malloc(sizeof(int));
+		*pointer = c->socket;
+		unlink_connection(c);
+		free(c);
+		session_count++;
+		if (!indigo_async((void *(*)(void *))&session_thread, pointer)) {
+			indigo_error("Can't create session thread for connection (%s)", strerror(errno));
+			session_count--;
+			close(*pointer);
+			free(pointer);
+			pthread_mutex_unlock(&connection_mutex);
+			update_client_count(-1);
+			pthread_mutex_lock(&connection_mutex);
+		}
+	} else if (first == 'G' || first == 'P') {
+		if (strstr(buffer, "\r\n\r\n") == NULL && strstr(buffer, "\n\n") == NULL && count < PEEK_SIZE) {
+			// incomplete header, wait for the rest unless client already hung up
+			if (events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+				release_connection(c, false);
+			else
+				arm_connection(c, EPOLL_CTL_MOD);
+			return;
+		}
+		unlink_connection(c);
+		c->busy = true;
+		c->next = NULL;
+		if (transfer_count < MAX_TRANSFERS && is_large_transfer(buffer)) {
+			transfer_count++;
+			if (indigo_async((void *(*)(void *))&transfer_thread, c))
+				return;
+			indigo_error("Can't create transfer thread for connection (%s)", strerror(errno));
+			transfer_count--;
+		}
+		if (request_queue_tail)
+			request_queue_tail->next = c;
+		else
+			request_queue_head = c;
+		request_queue_tail = c;
+		pthread_cond_signal(&request_cond);
+	} else {
+		INDIGO_TRACE(indigo_trace("%d -> // Unrecognised protocol", c->socket));
+		release_connection(c, true);
+	}
+}
+
+static void accept_connections(void) {
+	while (true) {
+		struct sockaddr_in client_name;
+		unsigned int name_len = sizeof(client_name);
+		int client_socket = accept(server_socket, (struct sockaddr *)&client_name, &name_len);
+		if (client_socket == -1) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && !shutdown_initiated)
+				indigo_error("Can't accept connection (%s)", strerror(errno));
+			return;
+		}
+		configure_client_socket(client_socket);
+		INDIGO_TRACE(indigo_trace("%d <- // Connection accepted", client_socket));
+		update_client_count(1);
+		connection *c = indigo_safe_malloc(sizeof(connection));
+		c->socket = client_socket;
+		pthread_mutex_lock(&connection_mutex);
+		c->next = connections;
+		connections = c;
+		arm_connection(c, EPOLL_CTL_ADD);
+		pthread_mutex_unlock(&connection_mutex);
+	}
+}
+
+static void close_lingering_connections(bool all) {
+	double now = reactor_time();
+	connection **link = &closing_connections;
+	while (*link) {
+		connection *c = *link;
+		if (all || c->close_at <= now) {
+			*link = c->next;
+			INDIGO_TRACE(indigo_trace("%d <- // Connection closed", c->socket));
+			close(c->socket);
+			free(c);
+			pthread_mutex_unlock(&connection_mutex);
+			update_client_count(-1);
+			pthread_mutex_lock(&connection_mutex);
+			link = &closing_connections;
+		} else {
+			link = &c->next;
+		}
+	}
+}
+
+static bool run_reactor(void) {
+	static bool workers_started = false;
+	struct epoll_event event;
+	if (wake_pipe[0] < 0 && pipe(wake_pipe) < 0) {
+		indigo_error("Can't create reactor pipe (%s)", strerror(errno));
+		return false;
+	}
+	fcntl(wake_pipe[0], F_SETFL, O_NONBLOCK);
+	fcntl(wake_pipe[1], F_SETFL, O_NONBLOCK);
+	fcntl(server_socket, F_SETFL, fcntl(server_socket, F_GETFL, 0) | O_NONBLOCK);
+	if ((epoll_handle = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+		indigo_error("Can't create epoll (%s)", strerror(errno));
+		return false;
+	}
+	event.events = EPOLLIN;
+	event.data.ptr = &server_socket;
+	epoll_ctl(epoll_handle, EPOLL_CTL_ADD, server_socket, &event);
+	event.events = EPOLLIN;
+	event.data.ptr = wake_pipe;
+	epoll_ctl(epoll_handle, EPOLL_CTL_ADD, wake_pipe[0], &event);
+	pthread_mutex_lock(&connection_mutex);
+	reactor_running = true;
+	if (!workers_started) {
+		for (int i = 0; i < REQUEST_WORKERS; i++) {
+			pthread_t thread;
+			if (pthread_create(&thread, NULL, request_worker, NULL) == 0)
+				pthread_detach(thread);
+			else
+				indigo_error("Can't create request worker (%s)", strerror(errno));
+		}
+		workers_started = true;
+	}
+	pthread_mutex_unlock(&connection_mutex);
+	struct epoll_event events[MAX_EVENTS];
+	while (!shutdown_initiated) {
+		pthread_mutex_lock(&connection_mutex);
+		int timeout = closing_connections ? 100 : -1;
+		pthread_mutex_unlock(&connection_mutex);
+		int count = epoll_wait(epoll_handle, events, MAX_EVENTS, timeout);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+			indigo_error("Can't wait for events (%s)", strerror(errno));
+			break;
+		}
+		for (int i = 0; i < count && !shutdown_initiated; i++) {
+			if (events[i].data.ptr == &server_socket) {
+				accept_connections();
+			} else if (events[i].data.ptr == wake_pipe) {
+				char buffer[64];
+				while (read(wake_pipe[0], buffer, sizeof(buffer)) > 0)
+					;
+			} else {
+				pthread_mutex_lock(&connection_mutex);
+				dispatch_connection(events[i].data.ptr, events[i].events);
+				pthread_mutex_unlock(&connection_mutex);
+			}
+		}
+		pthread_mutex_lock(&connection_mutex);
+		close_lingering_connections(false);
+		pthread_mutex_unlock(&connection_mutex);
+	}
+	pthread_mutex_lock(&connection_mutex);
+	reactor_running = false;
+	connection **link = &connections;
+	while (*link) {
+		connection *c = *link;
+		if (c->busy) {
+			link = &c->next;
+		} else {
+			release_connection(c, false);
+			link = &connections;
+		}
+	}
+	close_lingering_connections(true);
+	close(epoll_handle);
+	epoll_handle = -1;
+	pthread_mutex_unlock(&connection_mutex);
+	return true;
+}
+
+#endif /* INDIGO_LINUX */
+
 void indigo_server_shutdown() {
 	if (!shutdown_initiated) {
 		shutdown_initiated = true;
 		shutdown(server_socket, SHUT_RDWR);
 		close(server_socket);
+#ifdef INDIGO_LINUX
+		wake_reactor();
+#endif
 	}
 }
 
@@ -525,7 +1160,6 @@ indigo_result indigo_server_start(indigo_server_tcp_callback callback) {
 	startup_initiated = true;
 	shutdown_initiated = false;
 	server_callback = callback ? callback : default_server_callback;
-	int client_socket;
 	server_socket = socket(PF_INET, SOCK_STREAM, 0);
 	if (server_socket == -1) {
 		indigo_error("Can't open server socket (%s)", strerror(errno));
@@ -536,8 +1170,6 @@ indigo_result indigo_server_start(indigo_server_tcp_callback callback) {
 		indigo_error("Can't setsockopt for server socket (%s)", strerror(errno));
 		return INDIGO_CANT_START_SERVER;
 	}
-	struct sockaddr_in client_name;
-	unsigned int name_len = sizeof(client_name);
 	struct sockaddr_in server_address;
 	server_address.sin_family = AF_INET;
 	server_address.sin_port = htons(indigo_server_tcp_port);
@@ -571,27 +1203,29 @@ indigo_result indigo_server_start(indigo_server_tcp_callback callback) {
 	server_callback(0);
 	startup_initiated = false;
 	signal(SIGPIPE, SIG_IGN);
+#ifdef INDIGO_LINUX
+	if (!run_reactor()) {
+		close(server_socket);
+		return INDIGO_CANT_START_SERVER;
+	}
+#else
 	while (1) {
-		client_socket = accept(server_socket, (struct sockaddr *)&client_name, &name_len);
+		struct sockaddr_in client_name;
+		unsigned int name_len = sizeof(client_name);
+		int client_socket = accept(server_socket, (struct sockaddr *)&client_name, &name_len);
 		if (client_socket == -1) {
 			if (shutdown_initiated)
 				break;
 			indigo_error("Can't accept connection (%s)", strerror(errno));
 		} else {
-			struct timeval timeout;
-			timeout.tv_sec = 0;
-			timeout.tv_usec = 0;
-			if (setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout)) < 0)
-				indigo_error("Can't set recv() timeout (%s)", strerror(errno));
-			timeout.tv_sec = 5;
-			if (setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO, (char *)&timeout, sizeof(timeout)) < 0)
-				indigo_error("Can't set send() timeout (%s)", strerror(errno));
+			configure_client_socket(client_socket);
 			int *pointer = indigo_safe_malloc(sizeof(int));
 			*pointer = client_socket;
 			if (!indigo_async((void *(*)(void *))&start_worker_thread, pointer))
 				indigo_error("Can't create worker thread for connection (%s)", strerror(errno));
 		}
 	}
+#endif
 	shutdown_initiated = false;
 	server_callback(0);
 	return INDIGO_OK;
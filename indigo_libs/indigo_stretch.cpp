@@ -26,7 +26,11 @@
 #include <indigo/indigo_stretch.h>
 
 #include <vector>
+#include <deque>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <algorithm>
 #include <math.h>
 #include <unistd.h>
@@ -35,6 +39,86 @@
 #define MIN_SIZE_TO_PARALLELIZE 0x3FFFF
 //#define HISTOGRAM_AWB
 
+// Frames are split into bands of rows processed by a pool of workers started on first use and shared by all devices.
+// Caller takes bands as well, so nested or concurrent conversions always make progress.
+
+struct parallel_job {
+	const std::function<void(int, int)> *body;
+	int count;
+	int band;
+	int next;
+	int finished;
+};
+
+struct parallel_pool {
+	std::mutex mutex;
+	std::condition_variable work;
+	std::condition_variable done;
+	std::deque<parallel_job *> jobs;
+	int size;
+};
+
+static parallel_pool *pool = NULL;
+static std::once_flag pool_once;
+
+static void run_parallel_job(parallel_job *job, std::unique_lock<std::mutex> &lock) {
+	while (job->next < job->count) {
+		const int start = job->next;
+		const int end = std::min(start + job->band, job->count);
+		job->next = end;
+		if (end == job->count) {
+			pool->jobs.erase(std::find(pool->jobs.begin(), pool->jobs.end(), job));
+		}
+		lock.unlock();
+		(*job->body)(start, end);
+		lock.lock();
+		job->finished += end - start;
+		if (job->finished == job->count) {
+			pool->done.notify_all();
+		}
+	}
+}
+
+static void parallel_worker() {
+	std::unique_lock<std::mutex> lock(pool->mutex);
+	while (true) {
+		pool->work.wait(lock, [] { return !pool->jobs.empty(); });
+		run_parallel_job(pool->jobs.front(), lock);
+	}
+}
+
+static void start_parallel_pool() {
+	// never released, workers may be still waiting when static destructors run
+	pool = new parallel_pool();
+	int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	pool->size = (max_threads > 0) ? max_threads : INDIGO_DEFAULT_THREADS;
+	for (int i = 1; i < pool->size; i++) {
+		std::thread(parallel_worker).detach();
+	}
+}
+
+// count - number of rows
+// size - number of pixels, small frames are processed on the calling thread
+// body - called for [start, end) ranges of rows
+
+static void parallel_rows(int count, int size, const std::function<void(int, int)> &body) {
+	if (size < MIN_SIZE_TO_PARALLELIZE || count < 2) {
+		body(0, count);
+		return;
+	}
+	std::call_once(pool_once, start_parallel_pool);
+	if (pool->size < 2) {
+		body(0, count);
+		return;
+	}
+	parallel_job job = { &body, count, std::max(1, count / (4 * pool->size)), 0, 0 };
+	std::unique_lock<std::mutex> lock(pool->mutex);
+	pool->jobs.push_back(&job);
+	pool->work.notify_all();
+	run_parallel_job(&job, lock);
+	pool->done.wait(lock, [&] { return job.finished == job.count; });
+}
+
 // raw - raw pixels, any unsigned int
 // index - offset of the current pixel in raw
 // row, column - row, column of the current pixel (to skip line + to detect edges of the frame)
@@ -155,6 +239,119 @@ template <typename T> static inline void debayer(T *raw, int index, int row, int
 	}
 }
 
+// raw - raw pixels, any unsigned int
+// index - offset of the current pixel in raw, the pixel must not be on the edge of the frame
+// width - width of the frame
+// phase - offsets combined with parity of the current pixel row and column as in debayer()
+// red, gree, blue - debayered pixel as an mean value of 2 or 4 pixels
+
+template <typename T, int phase> static inline void debayer_interior(T *raw, int index, int width, float &red, float &green, float &blue) {
+	switch (phase) {
+		case 0x00:
+			red = raw[index];
+			green = (raw[index + 1] + raw[index - 1] + raw[index + width] + raw[index - width]) / 4.0f;
+			blue = (raw[index - width - 1] + raw[index - width + 1] + raw[index + width - 1] + raw[index + width + 1]) / 4.0f;
+			break;
+		case 0x10:
+			red = (raw[index - 1] + raw[index + 1]) / 2.0f;
+			green = raw[index];
+			blue = (raw[index - width] + raw[index + width]) / 2.0f;
+			break;
+		case 0x01:
+			red = (raw[index - width] + raw[index + width]) / 2.0f;
+			green = raw[index];
+			blue = (raw[index - 1] + raw[index + 1]) / 2.0f;
+			break;
+		case 0x11:
+			red = (raw[index - width - 1] + raw[index - width + 1] + raw[index + width - 1] + raw[index + width + 1]) / 4.0f;
+			green = (raw[index + 1] + raw[index - 1] + raw[index + width] + raw[index - width]) / 4.0f;
+			blue = raw[index];
+			break;
+	}
+}
+
+// interior columns of inner row, phase is known in compile time and alternates with column parity
+
+template <typename T, int phase, typename F> static inline void debayer_row_interior(T *raw, int row, int width, F &store) {
+	int index = row * width + 1;
+	int column = 1;
+	float red, green, blue;
+	for (; column + 1 < width - 1; column += 2, index += 2) {
+		debayer_interior<T, phase ^ 0x10>(raw, index, width, red, green, blue);
+		store(index, red, green, blue);
+		debayer_interior<T, phase>(raw, index + 1, width, red, green, blue);
+		store(index + 1, red, green, blue);
+	}
+	if (column < width - 1) {
+		debayer_interior<T, phase ^ 0x10>(raw, index, width, red, green, blue);
+		store(index, red, green, blue);
+	}
+}
+
+// debayer one row, store(index, red, green, blue) is called for each pixel
+
+template <typename T, typename F> static inline void debayer_row(T *raw, int row, int width, int height, int offsets, F &store) {
+	int index = row * width;
+	float red = 0, green = 0, blue = 0;
+	if (row == 0 || row == height - 1 || width < 3) {
+		for (int column_index = 0; column_index < width; column_index++) {
+			debayer(raw, index, row, column_index, width, height, offsets, red, green, blue);
+			store(index, red, green, blue);
+			index++;
+		}
+		return;
+	}
+	debayer(raw, index, row, 0, width, height, offsets, red, green, blue);
+	store(index, red, green, blue);
+	switch (offsets ^ (row & 1)) {
+		case 0x00:
+			debayer_row_interior<T, 0x00>(raw, row, width, store);
+			break;
+		case 0x01:
+			debayer_row_interior<T, 0x01>(raw, row, width, store);
+			break;
+		case 0x10:
+			debayer_row_interior<T, 0x10>(raw, row, width, store);
+			break;
+		case 0x11:
+			debayer_row_interior<T, 0x11>(raw, row, width, store);
+			break;
+	}
+	index += width - 1;
+	debayer(raw, index, row, width - 1, width, height, offsets, red, green, blue);
+	store(index, red, green, blue);
+}
+
+// debayer rows [start, end), on x86 the whole call tree is also compiled for AVX2 and selected at run time like base64 kernels
+
+template <typename T, typename F> __attribute__((flatten)) static void debayer_rows_generic(T *raw, int start, int end, int width, int height, int offsets, F &store) {
+	for (int row_index = start; row_index < end; row_index++) {
+		debayer_row(raw, row_index, width, height, offsets, store);
+	}
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+template <typename T, typename F> __attribute__((flatten, target("avx2"))) static void debayer_rows_avx2(T *raw, int start, int end, int width, int height, int offsets, F &store) {
+	for (int row_index = start; row_index < end; row_index++) {
+		debayer_row(raw, row_index, width, height, offsets, store);
+	}
+}
+
+static const bool use_avx2 = __builtin_cpu_supports("avx2");
+
+#endif
+
+template <typename T, typename F> static inline void debayer_rows(T *raw, int start, int end, int width, int height, int offsets, F &store) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	if (use_avx2) {
+		debayer_rows_avx2(raw, start, end, width, height, offsets, store);
+		return;
+	}
+#endif
+	debayer_rows_generic(raw, start, end, width, height, offsets, store);
+}
+
 // buffer - pixels, 8 or 16 bit unsigned int
 // width, height - width, height of the frame
 // sample_columns_by, sample_rows_by - to subsample buffer
@@ -261,29 +458,28 @@ template <typename T> void indigo_stretch(T *input_buffer, int step, int width,
 	const float k2 = ((2 * midtones) - 1) * hs_range_factor / max_input;
 	const float k1_k2 = k1 / k2;
 	const float midtones_k2 = midtones / k2;
-	if (size < MIN_SIZE_TO_PARALLELIZE) {
-		for (int i = 0; i < size; i++) {
-			output_buffer[i * step] = stretch(input_buffer[i * step] / coef, native_shadows, native_highlights, k1_k2, midtones_k2);
-		}
-	} else {
-		int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
-		max_threads = (max_threads > 0) ? max_threads : INDIGO_DEFAULT_THREADS;
-		std::thread threads[max_threads];
-		for (int rank = 0; rank < max_threads; rank++) {
-			const int chunk = ceil(size / (double)max_threads);
-			threads[rank] = std::thread([=]() {
-				const int start = chunk * rank;
-				int end = start + chunk;
-				end = (end > size) ? size : end;
-				for (int i = start; i < end; i++) {
-					output_buffer[i * step] = stretch(input_buffer[i * step] / coef, native_shadows, native_highlights, k1_k2, midtones_k2);
-				}
-			});
-		}
-		for (int rank = 0; rank < max_threads; rank++) {
-			threads[rank].join();
+	// input values are integers, for larger frames it is cheaper to stretch each possible value just once
+	const int range = (int)max_input + 1;
+	std::vector<uint8_t> lut;
+	if (size > range) {
+		lut.resize(range);
+		for (int value = 0; value < range; value++) {
+			lut[value] = stretch(value / coef, native_shadows, native_highlights, k1_k2, midtones_k2);
 		}
 	}
+	parallel_rows(height, size, [&](int start, int end) {
+		const int last = end * width;
+		if (lut.empty()) {
+			for (int i = start * width; i < last; i++) {
+				output_buffer[i * step] = stretch(input_buffer[i * step] / coef, native_shadows, native_highlights, k1_k2, midtones_k2);
+			}
+		} else {
+			const uint8_t *table = lut.data();
+			for (int i = start * width; i < last; i++) {
+				output_buffer[i * step] = table[input_buffer[i * step]];
+			}
+		}
+	});
 }
 
 #ifdef HISTOGRAM_AWB
@@ -322,47 +518,15 @@ template <typename T> void indigo_debayer_stretch(T *input_buffer, int width, in
 	const float k2 = ((2 * midtones[reference]) - 1) * hs_range_factor / max_input;
 	const float k1_k2 = k1 / k2;
 	const float midtones_k2 = midtones[1] / k2;
-	if (size < MIN_SIZE_TO_PARALLELIZE) {
-		int input_index = 0;
-		for (int row_index = 0; row_index < height; row_index++) {
-			for (int column_index = 0; column_index < width; column_index++) {
-				float red = 0, green = 0, blue = 0;
-				int output_index = input_index * 3;
-				debayer(input_buffer, input_index, row_index, column_index, width, height, offsets, red, green, blue);
-				output_buffer[output_index] = stretch(red / redCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
-				output_buffer[output_index + 1] = stretch(green / greenCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
-				output_buffer[output_index + 2] = stretch(blue / blueCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
-				input_index++;
-			}
-		}
-	} else {
-		int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
-		max_threads = (max_threads > 0) ? max_threads : INDIGO_DEFAULT_THREADS;
-		std::thread threads[max_threads];
-		for (int rank = 0; rank < max_threads; rank++) {
-			const int chunk = ceil(height / (double)max_threads);
-			threads[rank] = std::thread([=]() {
-				const int start = chunk * rank;
-				int end = start + chunk;
-				end = (end > height) ? height : end;
-				int input_index = start * width;
-				for (int row_index = start; row_index < end; row_index++) {
-					for (int column_index = 0; column_index < width; column_index++) {
-						float red = 0, green = 0, blue = 0;
-						int output_index = input_index * 3;
-						debayer(input_buffer, input_index, row_index, column_index, width, height, offsets, red, green, blue);
-						output_buffer[output_index] = stretch(red / redCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
-						output_buffer[output_index + 1] = stretch(green / greenCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
-						output_buffer[output_index + 2] = stretch(blue / blueCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
-						input_index++;
-					}
-				}
-			});
-		}
-		for (int rank = 0; rank < max_threads; rank++) {
-			threads[rank].join();
-		}
-	}
+	auto store = [&](int index, float red, float green, float blue) {
+		uint8_t *output = output_buffer + index * 3;
+		output[0] = stretch(red / redCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
+		output[1] = stretch(green / greenCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
+		output[2] = stretch(blue / blueCoef, native_shadows, native_highlights, k1_k2, midtones_k2);
+	};
+	parallel_rows(height, size, [&](int start, int end) {
+		debayer_rows(input_buffer, start, end, width, height, offsets, store);
+	});
 }
 
 #else  // unlincked stretch AWB
@@ -398,94 +562,30 @@ template <typename T> void indigo_debayer_stretch(T *input_buffer, int width, in
 	const float blue_k2 = ((2 * midtones[2]) - 1) * blue_hs_range_factor / max_input;
 	const float blue_k1_k2 = blue_k1 / blue_k2;
 	const float blue_midtones_k2 = midtones[2] / blue_k2;
-	if (size < MIN_SIZE_TO_PARALLELIZE) {
-		int input_index = 0;
-		for (int row_index = 0; row_index < height; row_index++) {
-			for (int column_index = 0; column_index < width; column_index++) {
-				float red = 0, green = 0, blue = 0;
-				int output_index = input_index * 3;
-				debayer(input_buffer, input_index, row_index, column_index, width, height, offsets, red, green, blue);
-				output_buffer[output_index] = stretch(red, red_native_shadows, red_native_highlights, red_k1_k2, red_midtones_k2);
-				output_buffer[output_index + 1] = stretch(green, green_native_shadows, green_native_highlights, green_k1_k2, green_midtones_k2);
-				output_buffer[output_index + 2] = stretch(blue, blue_native_shadows, blue_native_highlights, blue_k1_k2, blue_midtones_k2);
-				input_index++;
-			}
-		}
-	} else {
-		int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
-		max_threads = (max_threads > 0) ? max_threads : INDIGO_DEFAULT_THREADS;
-		std::thread threads[max_threads];
-		for (int rank = 0; rank < max_threads; rank++) {
-			const int chunk = ceil(height / (double)max_threads);
-			threads[rank] = std::thread([=]() {
-				const int start = chunk * rank;
-				int end = start + chunk;
-				end = (end > height) ? height : end;
-				int input_index = start * width;
-				for (int row_index = start; row_index < end; row_index++) {
-					for (int column_index = 0; column_index < width; column_index++) {
-						float red = 0, green = 0, blue = 0;
-						int output_index = input_index * 3;
-						debayer(input_buffer, input_index, row_index, column_index, width, height, offsets, red, green, blue);
-						output_buffer[output_index] = stretch(red, red_native_shadows, red_native_highlights, red_k1_k2, red_midtones_k2);
-						output_buffer[output_index + 1] = stretch(green, green_native_shadows, green_native_highlights, green_k1_k2, green_midtones_k2);
-						output_buffer[output_index + 2] = stretch(blue, blue_native_shadows, blue_native_highlights, blue_k1_k2, blue_midtones_k2);
-						input_index++;
-					}
-				}
-			});
-		}
-		for (int rank = 0; rank < max_threads; rank++) {
-			threads[rank].join();
-		}
-	}
+	auto store = [&](int index, float red, float green, float blue) {
+		uint8_t *output = output_buffer + index * 3;
+		output[0] = stretch(red, red_native_shadows, red_native_highlights, red_k1_k2, red_midtones_k2);
+		output[1] = stretch(green, green_native_shadows, green_native_highlights, green_k1_k2, green_midtones_k2);
+		output[2] = stretch(blue, blue_native_shadows, blue_native_highlights, blue_k1_k2, blue_midtones_k2);
+	};
+	parallel_rows(height, size, [&](int start, int end) {
+		debayer_rows(input_buffer, start, end, width, height, offsets, store);
+	});
 }
 
 #endif // HISTOGRAM_AWB
 
 template <typename T> void indigo_debayer(T *input_buffer, int width, int height, int offsets, uint8_t *output_buffer) {
 	const int size = width * height;
-	if (size < MIN_SIZE_TO_PARALLELIZE) {
-		int input_index = 0;
-		for (int row_index = 0; row_index < height; row_index++) {
-			for (int column_index = 0; column_index < width; column_index++) {
-				float red = 0, green = 0, blue = 0;
-				int output_index = input_index * 3;
-				debayer(input_buffer, input_index, row_index, column_index, width, height, offsets, red, green, blue);
-				output_buffer[output_index] = red;
-				output_buffer[output_index + 1] = green;
-				output_buffer[output_index + 2] = blue;
-				input_index++;
-			}
-		}
-	} else {
-		int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
-		max_threads = (max_threads > 0) ? max_threads : INDIGO_DEFAULT_THREADS;
-		std::thread threads[max_threads];
-		for (int rank = 0; rank < max_threads; rank++) {
-			const int chunk = ceil(height / (double)max_threads);
-			threads[rank] = std::thread([=]() {
-				const int start = chunk * rank;
-				int end = start + chunk;
-				end = (end > height) ? height : end;
-				int input_index = start * width;
-				for (int row_index = start; row_index < end; row_index++) {
-					for (int column_index = 0; column_index < width; column_index++) {
-						float red = 0, green = 0, blue = 0;
-						int output_index = input_index * 3;
-						debayer(input_buffer, input_index, row_index, column_index, width, height, offsets, red, green, blue);
-						output_buffer[output_index] = red;
-						output_buffer[output_index + 1] = green;
-						output_buffer[output_index + 2] = blue;
-						input_index++;
-					}
-				}
-			});
-		}
-		for (int rank = 0; rank < max_threads; rank++) {
-			threads[rank].join();
-		}
-	}
+	auto store = [&](int index, float red, float green, float blue) {
+		uint8_t *output = output_buffer + index * 3;
+		output[0] = red;
+		output[1] = green;
+		output[2] = blue;
+	};
+	parallel_rows(height, size, [&](int start, int end) {
+		debayer_rows(input_buffer, start, end, width, height, offsets, store);
+	});
 }
 
 extern "C" void indigo_compute_stretch_params_8(const uint8_t *buffer, int width, int height, int sample_by, double *shadows, double *midtones, double *highlights, unsigned long **histogram, float B, float C) {
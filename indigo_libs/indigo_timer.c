@@ -28,110 +28,299 @@
 #include <pthread.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <string.h>
 
 #include <indigo/indigo_timer.h>
 
 #include <indigo/indigo_driver.h>
 
 
-//#ifdef __MACH__ /* Mac OSX prior Sierra is missing clock_gettime() */
-//#include <mach/clock.h>
-//#include <mach/mach.h>
-//void utc_time(struct timespec *ts) {
-//	clock_serv_t cclock;
-//	mach_timespec_t mts;
-//	host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &cclock);
-//	clock_get_time(cclock, &mts);
-//	mach_port_deallocate(mach_task_self(), cclock);
-//	ts->tv_sec = mts.tv_sec;
-//	ts->tv_nsec = mts.tv_nsec;
-//}
-//#endif
-
-#define utc_time(ts) clock_gettime(CLOCK_REALTIME, ts)
+// Timers are kept in a min-heap ordered by CLOCK_MONOTONIC due time and executed by a pool of workers.
+// One idle worker (the leader) sleeps until the earliest due time, when it takes a timer, it hands leadership over
+// to an idle follower (or starts a new worker) and runs the callback. So there is a thread per running callback, not per timer.
+// Timer is either queued or running, never both, so callbacks of the same timer never overlap.
+// Callbacks of the same device are serialized too, due timer of a device with running callback is held back until the callback returns.
 
 #define NANO	1000000000L
 
-int timer_count = 0;
-indigo_timer *free_timer = NULL;
+#define MIN_WORKERS						4
+#define WORKER_IDLE_TIMEOUT		30
+
+const double indigo_timer_lateness_limits[INDIGO_TIMER_LATENESS_BUCKETS - 1] = { 0.0001, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5 };
+
+static pthread_mutex_t timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t leader_cond;
+static pthread_cond_t follower_cond;
+static pthread_cond_t finished_cond;
+static pthread_once_t scheduler_once = PTHREAD_ONCE_INIT;
+
+static indigo_timer **heap = NULL;
+static int heap_size = 0;
+static int heap_capacity = 0;
+static indigo_timer **held = NULL;
+static int held_size = 0;
+static int held_capacity = 0;
+static bool leader_present = false;
+static int idle_workers = 0;
+static int starting_workers = 0;
+static int timer_count = 0;
+static indigo_timer *free_timer = NULL;
+static indigo_timer_statistics statistics;
+
+static void init_scheduler(void) {
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+#if defined(INDIGO_LINUX)
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+	pthread_cond_init(&leader_cond, &attr);
+	pthread_cond_init(&follower_cond, &attr);
+	pthread_cond_init(&finished_cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+static inline double monotonic_time(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (double)ts.tv_nsec / NANO;
+}
+
+static int wait_until(pthread_cond_t *cond, double time) {
+#if defined(INDIGO_MACOS)
+	double delay = time - monotonic_time();
+	if (delay < 0)
+		delay = 0;
+	struct timespec ts = { (time_t)delay, (long)(NANO * (delay - (time_t)delay)) };
+	return pthread_cond_timedwait_relative_np(cond, &timer_mutex, &ts);
+#elif defined(INDIGO_LINUX)
+	struct timespec ts = { (time_t)time, (long)(NANO * (time - (time_t)time)) };
+	normalize_timespec(&ts);
+	return pthread_cond_timedwait(cond, &timer_mutex, &ts);
+#else
+	struct timespec ts;
+	double delay = time - monotonic_time();
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += (time_t)delay;
+	ts.tv_nsec += (long)(NANO * (delay - (time_t)delay));
+	normalize_timespec(&ts);
+	return pthread_cond_timedwait(cond, &timer_mutex, &ts);
+#endif
+}
+
+static inline void heap_set(int index, indigo_timer *timer) {
+	heap[index] = timer;
+	timer->heap_index = index;
+}
 
-pthread_mutex_t free_timer_mutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_mutex_t cancel_timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static void heap_up(int index) {
+	indigo_timer *timer = heap[index];
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+		if (heap[parent]->due <= timer->due)
+			break;
+		heap_set(index, heap[parent]);
+		index = parent;
+	}
+	heap_set(index, timer);
+}
 
-static void *timer_func(indigo_timer *timer) {
-	pthread_detach(pthread_self());
+static void heap_down(int index) {
+	indigo_timer *timer = heap[index];
 	while (true) {
-		while (timer->scheduled) {
-			INDIGO_TRACE(indigo_trace("timer #%d - sleep for %gs (%p)", timer->timer_id, timer->delay, timer->reference));
-			if (timer->delay > 0) {
-				struct timespec end;
-				utc_time(&end);
-				end.tv_sec += (int)timer->delay;
-				end.tv_nsec += NANO * (timer->delay - (int)timer->delay);
-				normalize_timespec(&end);
-				while (!timer->canceled) {
-					pthread_mutex_lock(&timer->mutex);
-					int rc = pthread_cond_timedwait(&timer->cond, &timer->mutex, &end);
-					pthread_mutex_unlock(&timer->mutex);
-					if (rc == ETIMEDOUT)
-						break;
-				}
-			}
+		int child = 2 * index + 1;
+		if (child >= heap_size)
+			break;
+		if (child + 1 < heap_size && heap[child + 1]->due < heap[child]->due)
+			child++;
+		if (timer->due <= heap[child]->due)
+			break;
+		heap_set(index, heap[child]);
+		index = child;
+	}
+	heap_set(index, timer);
+}
 
-			timer->scheduled = false;
-			if (!timer->canceled) {
-				pthread_mutex_lock(&timer->callback_mutex);
-				timer->callback_running = true;
-				INDIGO_TRACE(indigo_trace("timer #%d - callback %p started (%p)", timer->timer_id, timer->callback, timer->reference));
-				if (timer->data)
-					((indigo_timer_with_data_callback)timer->callback)(timer->device, timer->data);
-				else
-					((indigo_timer_callback)timer->callback)(timer->device);
-				timer->callback_running = false;
-				if (!timer->scheduled && timer->reference)
-					*timer->reference = NULL;
-				INDIGO_TRACE(indigo_trace("timer #%d - callback %p finished (%p)", timer->timer_id, timer->callback, timer->reference));
-				pthread_mutex_unlock(&timer->callback_mutex);
-			} else {
-				if (timer->reference)
-					*timer->reference = NULL;
-				INDIGO_TRACE(indigo_trace("timer #%d - canceled", timer->timer_id));
-			}
+static void heap_remove(indigo_timer *timer) {
+	int index = timer->heap_index;
+	timer->heap_index = -1;
+	if (index != --heap_size) {
+		indigo_timer *last = heap[heap_size];
+		heap_set(index, last);
+		heap_down(index);
+		heap_up(last->heap_index);
+	}
+}
+
+static bool device_busy(indigo_device *device) {
+	if (device == NULL)
+		return false;
+	for (indigo_timer *timer = DEVICE_CONTEXT->timers; timer; timer = timer->next) {
+		if (timer->callback_running)
+			return true;
+	}
+	return false;
+}
+
+static void hold_timer(indigo_timer *timer) {
+	if (held_size == held_capacity) {
+		held_capacity = held_capacity ? 2 * held_capacity : 16;
+		held = indigo_safe_realloc(held, held_capacity * sizeof(indigo_timer *));
+	}
+	held[held_size++] = timer;
+	timer->held = true;
+}
+
+static void unhold_timer(indigo_timer *timer) {
+	for (int i = 0; i < held_size; i++) {
+		if (held[i] == timer) {
+			held[i] = held[--held_size];
+			break;
 		}
+	}
+	timer->held = false;
+}
 
-		INDIGO_TRACE(indigo_trace("timer #%d - done", timer->timer_id));
+static void *worker_func(void *arg);
 
-		pthread_mutex_lock(&cancel_timer_mutex);
-		indigo_device *device = timer->device;
-		if (device != NULL) {
-			if (DEVICE_CONTEXT->timers == timer) {
-				DEVICE_CONTEXT->timers = timer->next;
+static void start_worker(void) {
+	pthread_t thread;
+	if (pthread_create(&thread, NULL, worker_func, NULL) == 0) {
+		pthread_detach(thread);
+		statistics.workers++;
+		starting_workers++;
+	} else {
+		indigo_error("Failed to start timer worker (%s)", strerror(errno));
+	}
+}
+
+static void queue_timer(indigo_timer *timer) {
+	if (heap_size == heap_capacity) {
+		heap_capacity = heap_capacity ? 2 * heap_capacity : 64;
+		heap = indigo_safe_realloc(heap, heap_capacity * sizeof(indigo_timer *));
+	}
+	heap_size++;
+	heap_set(heap_size - 1, timer);
+	heap_up(heap_size - 1);
+	if (leader_present) {
+		if (timer->heap_index == 0)
+			pthread_cond_signal(&leader_cond);
+	} else if (idle_workers > 0) {
+		pthread_cond_signal(&follower_cond);
+	} else if (starting_workers == 0) {
+		start_worker();
+	}
+}
+
+static void schedule_timer(indigo_timer *timer) {
+	timer->due = monotonic_time() + (timer->delay > 0 ? timer->delay : 0);
+	timer->scheduled = true;
+	queue_timer(timer);
+}
+
+// held timers of the device are queued again with their original due time
+
+static void release_held_timers(indigo_device *device) {
+	for (int i = 0; i < held_size; ) {
+		indigo_timer *timer = held[i];
+		if (timer->device == device) {
+			unhold_timer(timer);
+			queue_timer(timer);
+		} else {
+			i++;
+		}
+	}
+}
+
+static void release_timer(indigo_timer *timer) {
+	indigo_device *device = timer->device;
+	if (device != NULL) {
+		indigo_timer **link = &DEVICE_CONTEXT->timers;
+		while (*link != NULL && *link != timer)
+			link = &(*link)->next;
+		if (*link != NULL)
+			*link = timer->next;
+	}
+	timer->next = free_timer;
+	free_timer = timer;
+	statistics.timers--;
+	INDIGO_TRACE(indigo_trace("timer #%d - released", timer->timer_id));
+}
+
+static void run_timer(indigo_timer *timer) {
+	double lateness = monotonic_time() - timer->due;
+	int bucket = 0;
+	while (bucket < INDIGO_TIMER_LATENESS_BUCKETS - 1 && lateness >= indigo_timer_lateness_limits[bucket])
+		bucket++;
+	statistics.lateness[bucket]++;
+	if (lateness > statistics.max_lateness)
+		statistics.max_lateness = lateness;
+	statistics.callbacks++;
+	statistics.busy_workers++;
+	timer->scheduled = false;
+	timer->callback_running = true;
+	timer->worker = pthread_self();
+	pthread_mutex_unlock(&timer_mutex);
+	INDIGO_TRACE(indigo_trace("timer #%d - callback %p started %.1fms late (%p)", timer->timer_id, timer->callback, lateness * 1000, timer->reference));
+	if (timer->data)
+		((indigo_timer_with_data_callback)timer->callback)(timer->device, timer->data);
+	else
+		((indigo_timer_callback)timer->callback)(timer->device);
+	INDIGO_TRACE(indigo_trace("timer #%d - callback %p finished (%p)", timer->timer_id, timer->callback, timer->reference));
+	pthread_mutex_lock(&timer_mutex);
+	statistics.busy_workers--;
+	timer->callback_running = false;
+	indigo_device *device = timer->device;
+	if (timer->scheduled && !timer->canceled) {
+		INDIGO_TRACE(indigo_trace("timer #%d - sleep for %gs (%p)", timer->timer_id, timer->delay, timer->reference));
+		schedule_timer(timer);
+	} else {
+		if (timer->reference)
+			*timer->reference = NULL;
+		release_timer(timer);
+	}
+	if (device != NULL)
+		release_held_timers(device);
+	pthread_cond_broadcast(&finished_cond);
+}
+
+static void *worker_func(void *arg) {
+	pthread_mutex_lock(&timer_mutex);
+	starting_workers--;
+	while (true) {
+		if (leader_present) {
+			idle_workers++;
+			int rc = wait_until(&follower_cond, monotonic_time() + WORKER_IDLE_TIMEOUT);
+			idle_workers--;
+			if (rc == ETIMEDOUT && leader_present && statistics.workers > MIN_WORKERS)
+				break;
+			continue;
+		}
+		leader_present = true;
+		indigo_timer *timer = NULL;
+		while (timer == NULL) {
+			if (heap_size == 0) {
+				pthread_cond_wait(&leader_cond, &timer_mutex);
+			} else if (heap[0]->due > monotonic_time()) {
+				wait_until(&leader_cond, heap[0]->due);
 			} else {
-				indigo_timer *previous = DEVICE_CONTEXT->timers;
-				while (previous->next != NULL) {
-					if (previous->next == timer) {
-						previous->next = timer->next;
-						break;
-					}
-					previous = previous->next;
+				timer = heap[0];
+				heap_remove(timer);
+				if (device_busy(timer->device)) {
+					INDIGO_TRACE(indigo_trace("timer #%d - held until running callback of the same device returns", timer->timer_id));
+					hold_timer(timer);
+					timer = NULL;
 				}
 			}
 		}
-		pthread_mutex_unlock(&cancel_timer_mutex);
-
-		pthread_mutex_lock(&free_timer_mutex);
-		timer->next = free_timer;
-		free_timer = timer;
-		timer->wake = false;
-		pthread_mutex_unlock(&free_timer_mutex);
-
-		INDIGO_TRACE(indigo_trace("timer #%d - released", timer->timer_id));
-		
-		pthread_mutex_lock(&timer->mutex);
-		while (!timer->wake)
-			pthread_cond_wait(&timer->cond, &timer->mutex);
-		pthread_mutex_unlock(&timer->mutex);
+		leader_present = false;
+		if (idle_workers > 0)
+			pthread_cond_signal(&follower_cond);
+		else if (starting_workers == 0)
+			start_worker();
+		run_timer(timer);
 	}
+	statistics.workers--;
+	pthread_mutex_unlock(&timer_mutex);
 	return NULL;
 }
 
@@ -158,47 +347,30 @@ bool indigo_set_timer_with_data(indigo_device *device, double delay, indigo_time
 			delay = 0;
 		}
 	}
-	pthread_mutex_lock(&free_timer_mutex);
+	pthread_once(&scheduler_once, init_scheduler);
+	pthread_mutex_lock(&timer_mutex);
 	if (free_timer != NULL) {
 		t = free_timer;
-		INDIGO_TRACE(indigo_trace("timer #%d - reusing (%p)", t->timer_id, t));
 		free_timer = free_timer->next;
-		t->wake = true;
-		t->callback_running = false;
-		t->canceled = false;
-		t->scheduled = true;
-		t->delay = delay;
-		if ((t->device = device) != NULL) {
-			t->next = DEVICE_CONTEXT->timers;
-			DEVICE_CONTEXT->timers = t;
-		} else {
-			t->next = NULL;
-		}
-		t->callback = callback;
-		t->data = data;
-		pthread_mutex_lock(&t->mutex);
-		pthread_cond_signal(&t->cond);
-		pthread_mutex_unlock(&t->mutex);
+		INDIGO_TRACE(indigo_trace("timer #%d - reusing (%p)", t->timer_id, t));
 	} else {
 		t = indigo_safe_malloc(sizeof(indigo_timer));
 		t->timer_id = timer_count++;
 		INDIGO_TRACE(indigo_trace("timer #%d - allocating (%p)", t->timer_id, t));
-		pthread_mutex_init(&t->mutex, NULL);
-		pthread_mutex_init(&t->callback_mutex, NULL);
-		pthread_cond_init(&t->cond, NULL);
-		t->canceled = false;
-		t->callback_running = false;
-		t->scheduled = true;
-		if ((t->device = device) != NULL) {
-			t->next = DEVICE_CONTEXT->timers;
-			DEVICE_CONTEXT->timers = t;
-		} else {
-			t->next = NULL;
-		}
-		t->delay = delay;
-		t->callback = callback;
-		t->data = data;
-		pthread_create(&t->thread, NULL, (void * (*)(void*))timer_func, t);
+	}
+	t->use_count++;
+	t->canceled = false;
+	t->callback_running = false;
+	t->held = false;
+	t->heap_index = -1;
+	t->delay = delay;
+	t->callback = callback;
+	t->data = data;
+	if ((t->device = device) != NULL) {
+		t->next = DEVICE_CONTEXT->timers;
+		DEVICE_CONTEXT->timers = t;
+	} else {
+		t->next = NULL;
 	}
 	if (timer) {
 		t->reference = timer;
@@ -206,7 +378,10 @@ bool indigo_set_timer_with_data(indigo_device *device, double delay, indigo_time
 	} else {
 		t->reference = NULL;
 	}
-	pthread_mutex_unlock(&free_timer_mutex);
+	statistics.timers++;
+	INDIGO_TRACE(indigo_trace("timer #%d - sleep for %gs (%p)", t->timer_id, t->delay, t->reference));
+	schedule_timer(t);
+	pthread_mutex_unlock(&timer_mutex);
 	return true;
 }
 
@@ -220,24 +395,34 @@ bool indigo_reschedule_timer(indigo_device *device, double delay, indigo_timer *
 		return false;
 	}
 }
-	
+
 bool indigo_reschedule_timer_with_callback(indigo_device *device, double delay, indigo_timer_callback callback, indigo_timer **timer) {
 	bool result = false;
-	pthread_mutex_lock(&cancel_timer_mutex);
-	if (*timer != NULL && (*timer)->canceled == false) {
-		if (*timer != *(*timer)->reference) {
-			indigo_error("timer #%d - attempt to reschedule timer with outdated reference!", (*timer)->timer_id);
+	pthread_mutex_lock(&timer_mutex);
+	indigo_timer *t = *timer;
+	if (t != NULL && t->canceled == false) {
+		if (t->reference == NULL || t != *t->reference || (t->heap_index < 0 && !t->held && !t->callback_running)) {
+			indigo_error("timer #%d - attempt to reschedule timer with outdated reference!", t->timer_id);
 		} else {
-			INDIGO_TRACE(indigo_trace("timer #%d - rescheduled for %gs", (*timer)->timer_id, (*timer)->delay));
-			(*timer)->delay = delay;
-			(*timer)->scheduled = true;
-			(*timer)->callback = callback;
+			INDIGO_TRACE(indigo_trace("timer #%d - rescheduled for %gs", t->timer_id, delay));
+			t->delay = delay;
+			t->callback = callback;
+			if (t->heap_index >= 0 || t->held) {
+				// waiting timer is re-armed, running one is queued again when its callback returns
+				if (t->held)
+					unhold_timer(t);
+				else
+					heap_remove(t);
+				schedule_timer(t);
+			} else {
+				t->scheduled = true;
+			}
 			result = true;
 		}
 	} else {
 		indigo_error("Attempt to reschedule timer without reference or canceled timer!");
 	}
-	pthread_mutex_unlock(&cancel_timer_mutex);
+	pthread_mutex_unlock(&timer_mutex);
 	return result;
 }
 
@@ -245,69 +430,81 @@ bool indigo_reschedule_timer_with_callback(indigo_device *device, double delay,
 
 bool indigo_cancel_timer(indigo_device *device, indigo_timer **timer) {
 	bool result = false;
-	pthread_mutex_lock(&cancel_timer_mutex);
-	if (*timer != NULL) {
-		if (*timer != *(*timer)->reference) {
-			indigo_error("timer #%d - attempt to cancel timer with outdated reference!", (*timer)->timer_id);
+	pthread_mutex_lock(&timer_mutex);
+	indigo_timer *t = *timer;
+	if (t != NULL) {
+		if (t->reference == NULL || t != *t->reference) {
+			indigo_error("timer #%d - attempt to cancel timer with outdated reference!", t->timer_id);
 		} else {
-			INDIGO_TRACE(indigo_trace("timer #%d - cancel requested", (*timer)->timer_id));
-			(*timer)->canceled = true;
-			(*timer)->scheduled = false;
-			(*timer)->reference = NULL; // as far as it is cancel and forget we can't clear reference by timer_func
-			pthread_mutex_lock(&(*timer)->mutex);
-			pthread_cond_signal(&(*timer)->cond);
-			pthread_mutex_unlock(&(*timer)->mutex);
+			INDIGO_TRACE(indigo_trace("timer #%d - cancel requested", t->timer_id));
+			t->canceled = true;
+			t->scheduled = false;
+			t->reference = NULL; // as far as it is cancel and forget we can't clear reference by worker
+			if (t->heap_index >= 0 || t->held) {
+				if (t->held)
+					unhold_timer(t);
+				else
+					heap_remove(t);
+				release_timer(t);
+			}
 			*timer = NULL;
 			result = true;
 		}
 	}
-	pthread_mutex_unlock(&cancel_timer_mutex);
+	pthread_mutex_unlock(&timer_mutex);
 	return result;
 }
 
 bool indigo_cancel_timer_sync(indigo_device *device, indigo_timer **timer) {
-	bool must_wait = false;
-	indigo_timer *timer_buffer = NULL;
-	pthread_mutex_lock(&cancel_timer_mutex);
-	if (*timer != NULL) {
-		if ((*timer)->reference != NULL && *timer != *(*timer)->reference) {
+	bool result = false;
+	pthread_mutex_lock(&timer_mutex);
+	indigo_timer *t = *timer;
+	if (t != NULL) {
+		if (t->reference != NULL && t != *t->reference) {
 			indigo_error("Attempt to cancel timer with outdated reference!");
 		} else {
-			INDIGO_TRACE(indigo_trace("timer #%d - cancel requested", (*timer)->timer_id));
-			(*timer)->canceled = true;
-			(*timer)->scheduled = false;
-      timer_buffer = *timer;
-      must_wait = true;
-			pthread_mutex_lock(&(*timer)->mutex);
-			pthread_cond_signal(&(*timer)->cond);
-			pthread_mutex_unlock(&(*timer)->mutex);
-			/* Save a local copy of the timer instance as *timer can be set
-			 to NULL by *timer_func() after cancel_timer_mutex is released */
+			INDIGO_TRACE(indigo_trace("timer #%d - cancel requested", t->timer_id));
+			t->canceled = true;
+			t->scheduled = false;
+			if (t->heap_index >= 0 || t->held) {
+				if (t->held)
+					unhold_timer(t);
+				else
+					heap_remove(t);
+				if (t->reference)
+					*t->reference = NULL;
+				release_timer(t);
+			} else if (t->callback_running && !pthread_equal(t->worker, pthread_self())) {
+				INDIGO_TRACE(indigo_trace("timer #%d - waiting to finish", t->timer_id));
+				unsigned use_count = t->use_count;
+				while (t->callback_running && t->use_count == use_count)
+					pthread_cond_wait(&finished_cond, &timer_mutex);
+			}
+			*timer = NULL;
+			result = true;
 		}
 	}
-	pthread_mutex_unlock(&cancel_timer_mutex);
-	/* if must_wait == true then timer_buffer != NULL (see above) */
-	if (must_wait) {
-		INDIGO_TRACE(indigo_trace("timer #%d - waiting to finish", timer_buffer->timer_id));
-		/* just wait for the callback to finish */
-		pthread_mutex_lock(&(timer_buffer)->callback_mutex);
-		pthread_mutex_unlock(&(timer_buffer)->callback_mutex);
-		*timer = NULL;
-	}
-	/* if must_wait == true timer is canceled else it was not running */
-	return must_wait;
+	pthread_mutex_unlock(&timer_mutex);
+	/* if result == true timer is canceled else it was not running */
+	return result;
 }
 
 void indigo_cancel_all_timers(indigo_device *device) {
 	indigo_timer *timer;
 	while (true) {
-		pthread_mutex_lock(&cancel_timer_mutex);
+		pthread_mutex_lock(&timer_mutex);
 		timer = DEVICE_CONTEXT->timers;
 		if (timer)
 			DEVICE_CONTEXT->timers = timer->next;
-		pthread_mutex_unlock(&cancel_timer_mutex);
+		pthread_mutex_unlock(&timer_mutex);
 		if (timer == NULL)
 			break;
 		indigo_cancel_timer_sync(device, &timer);
 	}
 }
+
+void indigo_get_timer_statistics(indigo_timer_statistics *result) {
+	pthread_mutex_lock(&timer_mutex);
+	*result = statistics;
+	pthread_mutex_unlock(&timer_mutex);
+}
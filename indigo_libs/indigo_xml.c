@@ -51,6 +51,7 @@
 #include <indigo/indigo_io.h>
 #include <indigo/indigo_version.h>
 #include <indigo/indigo_names.h>
+#include <indigo/indigo_driver_xml.h>
 
 #define BUFFER_SIZE 524288  /* BUFFER_SIZE % 4 == 0, inportant for base64 */
 
@@ -224,8 +225,7 @@ static void *get_properties_handler(parser_state state, parser_context *context,
 				version = INDIGO_VERSION_2_0;
 			if (version > client->version) {
 				assert(client->client_context != NULL);
-				int handle = ((indigo_adapter_context *)(client->client_context))->output;
-				indigo_printf(handle, "<switchProtocol version='%d.%d'/>\n", (version >> 8) & 0xFF, version & 0xFF);
+				indigo_xml_device_adapter_printf(client, "<switchProtocol version='%d.%d'/>\n", (version >> 8) & 0xFF, version & 0xFF);
 				client->version = version;
 			}
 		} else if (!strcmp(name, "device")) {
@@ -596,7 +596,7 @@ static void *set_one_number_vector_handler(parser_state state, parser_context *c
 		} else if (!strcmp(name, "step")) {
 			property->items[property->count - 1].number.step = indigo_atod(value);
 		} else if (!strcmp(name, "format")) {
-			indigo_copy_name(property->items[property->count - 1].number.format, value);
+			indigo_set_string(&property->items[property->count - 1].number.format, value);
 		}
 	} else if (state == TEXT) {
 		property->items[property->count - 1].number.value = indigo_atod(value);
@@ -809,8 +809,8 @@ static void def_property(parser_context *context, indigo_property *other, char *
 		switch (other->type) {
 			case INDIGO_TEXT_VECTOR:
 				property = indigo_init_text_property(property, other->device, other->name, other->group, other->label, other->state, other->perm, other->count);
-				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
-				indigo_copy_value(property->hints, other->hints);
+				indigo_copy_items(property, other);
+				indigo_set_hints(property, other->hints);
 				for (int i = 0; i < property->count; i++) {
 					indigo_item *property_item = property->items + i;
 					indigo_item *other_item = other->items + i;
@@ -821,23 +821,23 @@ static void def_property(parser_context *context, indigo_property *other, char *
 				break;
 			case INDIGO_NUMBER_VECTOR:
 				property = indigo_init_number_property(property, other->device, other->name, other->group, other->label, other->state, other->perm, other->count);
-				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
-				indigo_copy_value(property->hints, other->hints);
+				indigo_copy_items(property, other);
+				indigo_set_hints(property, other->hints);
 				break;
 			case INDIGO_SWITCH_VECTOR:
 				property = indigo_init_switch_property(property, other->device, other->name, other->group, other->label, other->state, other->perm, other->rule, other->count);
-				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
-				indigo_copy_value(property->hints, other->hints);
+				indigo_copy_items(property, other);
+				indigo_set_hints(property, other->hints);
 				break;
 			case INDIGO_LIGHT_VECTOR:
 				property = indigo_init_light_property(property, other->device, other->name, other->group, other->label, other->state, other->count);
-				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
-				indigo_copy_value(property->hints, other->hints);
+				indigo_copy_items(property, other);
+				indigo_set_hints(property, other->hints);
 				break;
 			case INDIGO_BLOB_VECTOR:
 				property = indigo_init_blob_property_p(property, other->device, other->name, other->group, other->label, other->state, other->perm, other->count);
-				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
-				indigo_copy_value(property->hints, other->hints);
+				indigo_copy_items(property, other);
+				indigo_set_hints(property, other->hints);
 				for (int i = 0; i < property->count; i++) {
 					indigo_item *item = property->items + i;
 					item->blob.value = NULL;
@@ -860,9 +860,9 @@ static void *def_text_handler(parser_state state, parser_context *context, char
 		if (!strcmp(name, "name")) {
 			indigo_copy_item_name(device->version, property, property->items + property->count - 1, value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count - 1].label, value);
+			indigo_set_string(&property->items[property->count - 1].label, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count - 1].hints, value);
+			indigo_set_string(&property->items[property->count - 1].hints, value);
 		}
 	} else if (state == TEXT) {
 		indigo_set_text_item_value(property->items + property->count - 1, value);
@@ -892,9 +892,9 @@ static void *def_text_vector_handler(parser_state state, parser_context *context
 		} else if (!strcmp(name, "group")) {
 			strncpy(property->group, value,INDIGO_NAME_SIZE);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->label, value);
+			indigo_set_label(property, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->hints, value);
+			indigo_set_hints(property, value);
 		} else if (!strcmp(name, "state")) {
 			property->state = parse_state(device->version, value);
 		} else if (!strcmp(name, "perm")) {
@@ -920,9 +920,9 @@ static void *def_number_handler(parser_state state, parser_context *context, cha
 		} else if (!strcmp(name, "target")) {
 			property->items[property->count - 1].number.target = indigo_atod(value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count - 1].label, value);
+			indigo_set_string(&property->items[property->count - 1].label, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count - 1].hints, value);
+			indigo_set_string(&property->items[property->count - 1].hints, value);
 		} else if (!strcmp(name, "min")) {
 			property->items[property->count - 1].number.min = indigo_atod(value);
 		} else if (!strcmp(name, "max")) {
@@ -930,7 +930,7 @@ static void *def_number_handler(parser_state state, parser_context *context, cha
 		} else if (!strcmp(name, "step")) {
 			property->items[property->count - 1].number.step = indigo_atod(value);
 		} else if (!strcmp(name, "format")) {
-			indigo_copy_name(property->items[property->count - 1].number.format, value);
+			indigo_set_string(&property->items[property->count - 1].number.format, value);
 		}
 	} else if (state == TEXT) {
 		property->items[property->count - 1].number.value = indigo_atod(value);
@@ -960,9 +960,9 @@ static void *def_number_vector_handler(parser_state state, parser_context *conte
 		} else if (!strcmp(name, "group")) {
 			strncpy(property->group, value,INDIGO_NAME_SIZE);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->label, value);
+			indigo_set_label(property, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->hints, value);
+			indigo_set_hints(property, value);
 		} else if (!strcmp(name, "state")) {
 			property->state = parse_state(device->version, value);
 		} else if (!strcmp(name, "perm")) {
@@ -986,9 +986,9 @@ static void *def_switch_handler(parser_state state, parser_context *context, cha
 		if (!strcmp(name, "name")) {
 			indigo_copy_item_name(device->version, property, property->items + property->count - 1, value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count - 1].label, value);
+			indigo_set_string(&property->items[property->count - 1].label, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count - 1].hints, value);
+			indigo_set_string(&property->items[property->count - 1].hints, value);
 		}
 	} else if (state == TEXT) {
 		property->items[property->count - 1].sw.value = !strcmp(value, "On");
@@ -1018,9 +1018,9 @@ static void *def_switch_vector_handler(parser_state state, parser_context *conte
 		} else if (!strcmp(name, "group")) {
 			strncpy(property->group, value,INDIGO_NAME_SIZE);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->label, value);
+			indigo_set_label(property, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->hints, value);
+			indigo_set_hints(property, value);
 		} else if (!strcmp(name, "state")) {
 			property->state = parse_state(device->version, value);
 		} else if (!strcmp(name, "perm")) {
@@ -1046,9 +1046,9 @@ static void *def_light_handler(parser_state state, parser_context *context, char
 		if (!strcmp(name, "name")) {
 			indigo_copy_item_name(device->version, property, property->items + property->count - 1, value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count - 1].label, value);
+			indigo_set_string(&property->items[property->count - 1].label, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count - 1].hints, value);
+			indigo_set_string(&property->items[property->count - 1].hints, value);
 		}
 	} else if (state == TEXT) {
 		property->items[property->count - 1].light.value = parse_state(INDIGO_VERSION_CURRENT, value);
@@ -1078,9 +1078,9 @@ static void *def_light_vector_handler(parser_state state, parser_context *contex
 		} else if (!strcmp(name, "group")) {
 			strncpy(property->group, value,INDIGO_NAME_SIZE);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->label, value);
+			indigo_set_label(property, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->hints, value);
+			indigo_set_hints(property, value);
 		} else if (!strcmp(name, "state")) {
 			property->state = parse_state(device->version, value);
 		} else if (!strcmp(name, "message")) {
@@ -1102,9 +1102,9 @@ static void *def_blob_handler(parser_state state, parser_context *context, char
 		if (!strcmp(name, "name")) {
 			indigo_copy_item_name(device->version, property, property->items + property->count - 1, value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count - 1].label, value);
+			indigo_set_string(&property->items[property->count - 1].label, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count - 1].hints, value);
+			indigo_set_string(&property->items[property->count - 1].hints, value);
 		} else if (!strcmp(name, "path")) {
 			snprintf(property->items[property->count - 1].blob.url, INDIGO_VALUE_SIZE, "%s%s", ((indigo_adapter_context *)context->device->device_context)->url_prefix, value);
 		} else if (!strcmp(name, "url")) {
@@ -1136,9 +1136,9 @@ static void *def_blob_vector_handler(parser_state state, parser_context *context
 		} else if (!strcmp(name, "group")) {
 			strncpy(property->group, value,INDIGO_NAME_SIZE);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->label, value);
+			indigo_set_label(property, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->hints, value);
+			indigo_set_hints(property, value);
 		} else if (!strcmp(name, "state")) {
 			property->state = parse_state(device->version, value);
 		} else if (!strcmp(name, "perm")) {
@@ -1725,6 +1725,7 @@ exit_loop:
 	indigo_safe_free(blob_buffer);
 	indigo_safe_free(name_buffer);
 	indigo_safe_free(message);
+	indigo_clear_property(context->property);
 	indigo_safe_free(context->property);
 	indigo_safe_free(context->properties);
 	pthread_mutex_unlock(&context->mutex);
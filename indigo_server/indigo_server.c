@@ -48,6 +48,8 @@
 #include <indigo/indigo_driver.h>
 #include <indigo/indigo_client.h>
 #include <indigo/indigo_xml.h>
+#include <indigo/indigo_driver_xml.h>
+#include <indigo/indigo_binary.h>
 #include <indigo/indigo_token.h>
 #include <indigo/indigo_align.h>
 #include <indigo/indigocat/indigocat_star.h>
@@ -153,6 +155,7 @@
 #include "aux_geoptikflat/indigo_aux_geoptikflat.h"
 #include "ccd_svb/indigo_ccd_svb.h"
 #include "agent_astap/indigo_agent_astap.h"
+#include "agent_native_solver/indigo_agent_native_solver.h"
 #include "rotator_optec/indigo_rotator_optec.h"
 #include "mount_starbook/indigo_mount_starbook.h"
 #include "ccd_playerone/indigo_ccd_playerone.h"
@@ -204,6 +207,7 @@ driver_entry_point static_drivers[] = {
 	indigo_agent_alpaca,
 	indigo_agent_astrometry,
 	indigo_agent_astap,
+	indigo_agent_native_solver,
 	indigo_agent_auxiliary,
 	indigo_agent_guider,
 	indigo_agent_imager,
@@ -368,6 +372,11 @@ static indigo_property *restart_property;
 static indigo_property *log_level_property;
 static indigo_property *blob_buffering_property;
 static indigo_property *blob_proxy_property;
+static indigo_property *blob_queue_policy_property;
+static indigo_property *queue_statistics_property;
+static indigo_property *blob_cache_statistics_property;
+static indigo_property *timer_statistics_property;
+static indigo_timer *queue_statistics_timer;
 static indigo_property *server_features_property;
 
 #ifdef RPI_MANAGEMENT
@@ -424,6 +433,37 @@ static bool runLoop = true;
 #define SERVER_BLOB_PROXY_DISABLED_ITEM						(SERVER_BLOB_PROXY_PROPERTY->items + 0)
 #define SERVER_BLOB_PROXY_ENABLED_ITEM						(SERVER_BLOB_PROXY_PROPERTY->items + 1)
 
+#define SERVER_BLOB_QUEUE_POLICY_PROPERTY					blob_queue_policy_property
+#define SERVER_BLOB_QUEUE_DROP_OLDEST_ITEM				(SERVER_BLOB_QUEUE_POLICY_PROPERTY->items + 0)
+#define SERVER_BLOB_QUEUE_BLOCK_ITEM							(SERVER_BLOB_QUEUE_POLICY_PROPERTY->items + 1)
+#define SERVER_BLOB_QUEUE_URL_ONLY_ITEM						(SERVER_BLOB_QUEUE_POLICY_PROPERTY->items + 2)
+
+#define SERVER_QUEUE_STATISTICS_PROPERTY					queue_statistics_property
+#define SERVER_QUEUE_CLIENTS_ITEM									(SERVER_QUEUE_STATISTICS_PROPERTY->items + 0)
+#define SERVER_QUEUE_DEPTH_ITEM										(SERVER_QUEUE_STATISTICS_PROPERTY->items + 1)
+#define SERVER_QUEUE_MAX_DEPTH_ITEM								(SERVER_QUEUE_STATISTICS_PROPERTY->items + 2)
+#define SERVER_QUEUE_COALESCED_ITEM								(SERVER_QUEUE_STATISTICS_PROPERTY->items + 3)
+#define SERVER_QUEUE_DROPPED_ITEM									(SERVER_QUEUE_STATISTICS_PROPERTY->items + 4)
+#define SERVER_QUEUE_DROPPED_BLOBS_ITEM						(SERVER_QUEUE_STATISTICS_PROPERTY->items + 5)
+
+#define SERVER_BLOB_CACHE_STATISTICS_PROPERTY			blob_cache_statistics_property
+#define SERVER_BLOB_CACHE_ENTRIES_ITEM						(SERVER_BLOB_CACHE_STATISTICS_PROPERTY->items + 0)
+#define SERVER_BLOB_CACHE_MEMORY_ITEM							(SERVER_BLOB_CACHE_STATISTICS_PROPERTY->items + 1)
+#define SERVER_BLOB_CACHE_BUDGET_ITEM							(SERVER_BLOB_CACHE_STATISTICS_PROPERTY->items + 2)
+#define SERVER_BLOB_CACHE_HITS_ITEM								(SERVER_BLOB_CACHE_STATISTICS_PROPERTY->items + 3)
+#define SERVER_BLOB_CACHE_MISSES_ITEM							(SERVER_BLOB_CACHE_STATISTICS_PROPERTY->items + 4)
+#define SERVER_BLOB_CACHE_EVICTIONS_ITEM					(SERVER_BLOB_CACHE_STATISTICS_PROPERTY->items + 5)
+
+#define SERVER_TIMER_STATISTICS_PROPERTY					timer_statistics_property
+#define SERVER_TIMER_TIMERS_ITEM									(SERVER_TIMER_STATISTICS_PROPERTY->items + 0)
+#define SERVER_TIMER_WORKERS_ITEM									(SERVER_TIMER_STATISTICS_PROPERTY->items + 1)
+#define SERVER_TIMER_BUSY_WORKERS_ITEM						(SERVER_TIMER_STATISTICS_PROPERTY->items + 2)
+#define SERVER_TIMER_CALLBACKS_ITEM								(SERVER_TIMER_STATISTICS_PROPERTY->items + 3)
+#define SERVER_TIMER_MAX_LATENESS_ITEM						(SERVER_TIMER_STATISTICS_PROPERTY->items + 4)
+#define SERVER_TIMER_LATENESS_ITEM								(SERVER_TIMER_STATISTICS_PROPERTY->items + 5)
+
+#define QUEUE_STATISTICS_INTERVAL									5
+
 #define SERVER_FEATURES_PROPERTY									server_features_property
 #define SERVER_BONJOUR_ITEM												(SERVER_FEATURES_PROPERTY->items + 0)
 #define SERVER_CTRL_PANEL_ITEM										(SERVER_FEATURES_PROPERTY->items + 1)
@@ -826,7 +866,7 @@ static void check_versions(indigo_device *device) {
 					}
 				}
 				indigo_init_switch_item(SERVER_INSTALL_PROPERTY->items + i, versions[ii], versions[ii], versions[ii] == line);
-				sprintf(SERVER_INSTALL_PROPERTY->items[i].hints,"warn_on_set:\"Install INDIGO %s and reboot host computer?\";", versions[ii]);
+				indigo_set_string_printf(&SERVER_INSTALL_PROPERTY->items[i].hints, "warn_on_set:\"Install INDIGO %s and reboot host computer?\";", versions[ii]);
 				SERVER_INSTALL_PROPERTY->count++;
 				versions[ii] = NULL;
 			}
@@ -927,6 +967,49 @@ static void update_wifi_setings(indigo_device *device) {
 
 #endif
 
+static void update_queue_statistics(indigo_device *device) {
+	indigo_xml_queue_statistics statistics;
+	indigo_get_xml_queue_statistics(&statistics);
+	if (SERVER_QUEUE_CLIENTS_ITEM->number.value != statistics.clients || SERVER_QUEUE_DEPTH_ITEM->number.value != statistics.depth || SERVER_QUEUE_MAX_DEPTH_ITEM->number.value != statistics.max_depth || SERVER_QUEUE_COALESCED_ITEM->number.value != statistics.coalesced || SERVER_QUEUE_DROPPED_ITEM->number.value != statistics.dropped || SERVER_QUEUE_DROPPED_BLOBS_ITEM->number.value != statistics.dropped_blobs) {
+		SERVER_QUEUE_CLIENTS_ITEM->number.value = statistics.clients;
+		SERVER_QUEUE_DEPTH_ITEM->number.value = statistics.depth;
+		SERVER_QUEUE_MAX_DEPTH_ITEM->number.value = statistics.max_depth;
+		SERVER_QUEUE_COALESCED_ITEM->number.value = statistics.coalesced;
+		SERVER_QUEUE_DROPPED_ITEM->number.value = statistics.dropped;
+		SERVER_QUEUE_DROPPED_BLOBS_ITEM->number.value = statistics.dropped_blobs;
+		indigo_update_property(&server_device, SERVER_QUEUE_STATISTICS_PROPERTY, NULL);
+	}
+	indigo_blob_cache_statistics cache;
+	indigo_get_blob_cache_statistics(&cache);
+	double memory = round(cache.memory / 1048576.0), budget = round(cache.budget / 1048576.0);
+	if (SERVER_BLOB_CACHE_ENTRIES_ITEM->number.value != cache.entries || SERVER_BLOB_CACHE_MEMORY_ITEM->number.value != memory || SERVER_BLOB_CACHE_BUDGET_ITEM->number.value != budget || SERVER_BLOB_CACHE_HITS_ITEM->number.value != cache.hits || SERVER_BLOB_CACHE_MISSES_ITEM->number.value != cache.misses || SERVER_BLOB_CACHE_EVICTIONS_ITEM->number.value != cache.evictions) {
+		SERVER_BLOB_CACHE_ENTRIES_ITEM->number.value = cache.entries;
+		SERVER_BLOB_CACHE_MEMORY_ITEM->number.value = memory;
+		SERVER_BLOB_CACHE_BUDGET_ITEM->number.value = budget;
+		SERVER_BLOB_CACHE_HITS_ITEM->number.value = cache.hits;
+		SERVER_BLOB_CACHE_MISSES_ITEM->number.value = cache.misses;
+		SERVER_BLOB_CACHE_EVICTIONS_ITEM->number.value = cache.evictions;
+		indigo_update_property(&server_device, SERVER_BLOB_CACHE_STATISTICS_PROPERTY, NULL);
+	}
+	indigo_timer_statistics timers;
+	indigo_get_timer_statistics(&timers);
+	// executed callbacks and on-time buckets grow with every callback, they are refreshed only together with a meaningful change
+	bool changed = SERVER_TIMER_TIMERS_ITEM->number.value != timers.timers || SERVER_TIMER_WORKERS_ITEM->number.value != timers.workers || SERVER_TIMER_MAX_LATENESS_ITEM->number.value != timers.max_lateness * 1000;
+	for (int i = 2; !changed && i < INDIGO_TIMER_LATENESS_BUCKETS; i++)
+		changed = SERVER_TIMER_LATENESS_ITEM[i].number.value != timers.lateness[i];
+	if (changed) {
+		SERVER_TIMER_TIMERS_ITEM->number.value = timers.timers;
+		SERVER_TIMER_WORKERS_ITEM->number.value = timers.workers;
+		SERVER_TIMER_BUSY_WORKERS_ITEM->number.value = timers.busy_workers;
+		SERVER_TIMER_CALLBACKS_ITEM->number.value = timers.callbacks;
+		SERVER_TIMER_MAX_LATENESS_ITEM->number.value = timers.max_lateness * 1000;
+		for (int i = 0; i < INDIGO_TIMER_LATENESS_BUCKETS; i++)
+			SERVER_TIMER_LATENESS_ITEM[i].number.value = timers.lateness[i];
+		indigo_update_property(&server_device, SERVER_TIMER_STATISTICS_PROPERTY, NULL);
+	}
+	indigo_reschedule_timer(NULL, QUEUE_STATISTICS_INTERVAL, &queue_statistics_timer);
+}
+
 static indigo_result attach(indigo_device *device) {
 	assert(device != NULL);
 	char hostname[INDIGO_NAME_SIZE];
@@ -971,7 +1054,7 @@ static indigo_result attach(indigo_device *device) {
 	indigo_init_text_item(SERVER_UNLOAD_ITEM,SERVER_UNLOAD_ITEM_NAME, "Unload driver", "");
 	SERVER_RESTART_PROPERTY = indigo_init_switch_property(NULL, server_device.name, SERVER_RESTART_PROPERTY_NAME, MAIN_GROUP, "Restart", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, 1);
 	indigo_init_switch_item(SERVER_RESTART_ITEM, SERVER_RESTART_ITEM_NAME, "Restart server", false);
-	strcpy(SERVER_RESTART_ITEM->hints,"warn_on_set:\"Restart INDIGO Server?\";");
+	indigo_set_hints(SERVER_RESTART_ITEM, "warn_on_set:\"Restart INDIGO Server?\";");
 	SERVER_LOG_LEVEL_PROPERTY = indigo_init_switch_property(NULL, device->name, SERVER_LOG_LEVEL_PROPERTY_NAME, MAIN_GROUP, "Log level", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 5);
 	indigo_init_switch_item(SERVER_LOG_LEVEL_ERROR_ITEM, SERVER_LOG_LEVEL_ERROR_ITEM_NAME, "Error", false);
 	indigo_init_switch_item(SERVER_LOG_LEVEL_INFO_ITEM, SERVER_LOG_LEVEL_INFO_ITEM_NAME, "Info", false);
@@ -985,6 +1068,39 @@ static indigo_result attach(indigo_device *device) {
 	SERVER_BLOB_PROXY_PROPERTY = indigo_init_switch_property(NULL, device->name, SERVER_BLOB_PROXY_PROPERTY_NAME, MAIN_GROUP, "BLOB proxy", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 2);
 	indigo_init_switch_item(SERVER_BLOB_PROXY_DISABLED_ITEM, SERVER_BLOB_PROXY_DISABLED_ITEM_NAME, "Disabled", !indigo_proxy_blob);
 	indigo_init_switch_item(SERVER_BLOB_PROXY_ENABLED_ITEM, SERVER_BLOB_PROXY_ENABLED_ITEM_NAME, "Enabled", indigo_proxy_blob);
+	SERVER_BLOB_QUEUE_POLICY_PROPERTY = indigo_init_switch_property(NULL, device->name, SERVER_BLOB_QUEUE_POLICY_PROPERTY_NAME, MAIN_GROUP, "BLOB policy for slow clients", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 3);
+	indigo_init_switch_item(SERVER_BLOB_QUEUE_DROP_OLDEST_ITEM, SERVER_BLOB_QUEUE_DROP_OLDEST_ITEM_NAME, "Drop oldest", indigo_xml_blob_queue_policy == INDIGO_XML_BLOB_DROP_OLDEST);
+	indigo_init_switch_item(SERVER_BLOB_QUEUE_BLOCK_ITEM, SERVER_BLOB_QUEUE_BLOCK_ITEM_NAME, "Block", indigo_xml_blob_queue_policy == INDIGO_XML_BLOB_BLOCK);
+	indigo_init_switch_item(SERVER_BLOB_QUEUE_URL_ONLY_ITEM, SERVER_BLOB_QUEUE_URL_ONLY_ITEM_NAME, "URL only", indigo_xml_blob_queue_policy == INDIGO_XML_BLOB_URL_ONLY);
+	SERVER_QUEUE_STATISTICS_PROPERTY = indigo_init_number_property(NULL, device->name, SERVER_QUEUE_STATISTICS_PROPERTY_NAME, MAIN_GROUP, "Outbound queues", INDIGO_OK_STATE, INDIGO_RO_PERM, 6);
+	indigo_init_number_item(SERVER_QUEUE_CLIENTS_ITEM, SERVER_QUEUE_CLIENTS_ITEM_NAME, "Clients", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_QUEUE_DEPTH_ITEM, SERVER_QUEUE_DEPTH_ITEM_NAME, "Pending messages", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_QUEUE_MAX_DEPTH_ITEM, SERVER_QUEUE_MAX_DEPTH_ITEM_NAME, "Maximal queue depth", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_QUEUE_COALESCED_ITEM, SERVER_QUEUE_COALESCED_ITEM_NAME, "Coalesced updates", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_QUEUE_DROPPED_ITEM, SERVER_QUEUE_DROPPED_ITEM_NAME, "Dropped messages", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_QUEUE_DROPPED_BLOBS_ITEM, SERVER_QUEUE_DROPPED_BLOBS_ITEM_NAME, "Dropped BLOBs", 0, 1e9, 1, 0);
+	SERVER_BLOB_CACHE_STATISTICS_PROPERTY = indigo_init_number_property(NULL, device->name, SERVER_BLOB_CACHE_STATISTICS_PROPERTY_NAME, MAIN_GROUP, "BLOB cache", INDIGO_OK_STATE, INDIGO_RO_PERM, 6);
+	indigo_init_number_item(SERVER_BLOB_CACHE_ENTRIES_ITEM, SERVER_BLOB_CACHE_ENTRIES_ITEM_NAME, "Entries", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_BLOB_CACHE_MEMORY_ITEM, SERVER_BLOB_CACHE_MEMORY_ITEM_NAME, "Memory used (MB)", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_BLOB_CACHE_BUDGET_ITEM, SERVER_BLOB_CACHE_BUDGET_ITEM_NAME, "Memory budget (MB)", 0, 1e9, 1, round(indigo_blob_cache_budget / 1048576.0));
+	indigo_init_number_item(SERVER_BLOB_CACHE_HITS_ITEM, SERVER_BLOB_CACHE_HITS_ITEM_NAME, "Hits", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_BLOB_CACHE_MISSES_ITEM, SERVER_BLOB_CACHE_MISSES_ITEM_NAME, "Misses", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_BLOB_CACHE_EVICTIONS_ITEM, SERVER_BLOB_CACHE_EVICTIONS_ITEM_NAME, "Evictions", 0, 1e12, 1, 0);
+	SERVER_TIMER_STATISTICS_PROPERTY = indigo_init_number_property(NULL, device->name, SERVER_TIMER_STATISTICS_PROPERTY_NAME, MAIN_GROUP, "Timers", INDIGO_OK_STATE, INDIGO_RO_PERM, 5 + INDIGO_TIMER_LATENESS_BUCKETS);
+	indigo_init_number_item(SERVER_TIMER_TIMERS_ITEM, SERVER_TIMER_TIMERS_ITEM_NAME, "Active timers", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_WORKERS_ITEM, SERVER_TIMER_WORKERS_ITEM_NAME, "Worker threads", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_BUSY_WORKERS_ITEM, SERVER_TIMER_BUSY_WORKERS_ITEM_NAME, "Running callbacks", 0, 1e9, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_CALLBACKS_ITEM, SERVER_TIMER_CALLBACKS_ITEM_NAME, "Executed callbacks", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_MAX_LATENESS_ITEM, SERVER_TIMER_MAX_LATENESS_ITEM_NAME, "Maximal lateness (ms)", 0, 1e9, 0, 0);
+	indigo_init_number_item(SERVER_TIMER_LATENESS_ITEM + 0, SERVER_TIMER_LATENESS_100US_ITEM_NAME, "Late < 0.1ms", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_LATENESS_ITEM + 1, SERVER_TIMER_LATENESS_1MS_ITEM_NAME, "Late < 1ms", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_LATENESS_ITEM + 2, SERVER_TIMER_LATENESS_5MS_ITEM_NAME, "Late < 5ms", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_LATENESS_ITEM + 3, SERVER_TIMER_LATENESS_10MS_ITEM_NAME, "Late < 10ms", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_LATENESS_ITEM + 4, SERVER_TIMER_LATENESS_50MS_ITEM_NAME, "Late < 50ms", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_LATENESS_ITEM + 5, SERVER_TIMER_LATENESS_100MS_ITEM_NAME, "Late < 100ms", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_LATENESS_ITEM + 6, SERVER_TIMER_LATENESS_500MS_ITEM_NAME, "Late < 500ms", 0, 1e12, 1, 0);
+	indigo_init_number_item(SERVER_TIMER_LATENESS_ITEM + 7, SERVER_TIMER_LATENESS_OVER_500MS_ITEM_NAME, "Late >= 500ms", 0, 1e12, 1, 0);
+	indigo_set_timer(NULL, QUEUE_STATISTICS_INTERVAL, update_queue_statistics, &queue_statistics_timer);
 	SERVER_FEATURES_PROPERTY = indigo_init_switch_property(NULL, device->name, SERVER_FEATURES_PROPERTY_NAME, MAIN_GROUP, "Features", INDIGO_OK_STATE, INDIGO_RO_PERM, INDIGO_ONE_OF_MANY_RULE, 3);
 	indigo_init_switch_item(SERVER_BONJOUR_ITEM, SERVER_BONJOUR_ITEM_NAME, "Bonjour", indigo_use_bonjour);
 	indigo_init_switch_item(SERVER_CTRL_PANEL_ITEM, SERVER_CTRL_PANEL_ITEM_NAME, "Control panel / Server manager", use_ctrl_panel);
@@ -994,20 +1110,20 @@ static indigo_result attach(indigo_device *device) {
 		SERVER_WIFI_AP_PROPERTY = indigo_init_text_property(NULL, server_device.name, SERVER_WIFI_AP_PROPERTY_NAME, MAIN_GROUP, "Configure access point WiFi mode", INDIGO_OK_STATE, INDIGO_RW_PERM, 2);
 		indigo_init_text_item(SERVER_WIFI_AP_SSID_ITEM, SERVER_WIFI_AP_SSID_ITEM_NAME, "Network name", "");
 		indigo_init_text_item(SERVER_WIFI_AP_PASSWORD_ITEM, SERVER_WIFI_AP_PASSWORD_ITEM_NAME, "Password", "");
-		strcpy(SERVER_WIFI_AP_PROPERTY->hints,"warn_on_change:\"Changing WiFi settings will disconnect all devices connected over WiFi. Continue?\";");
+		indigo_set_hints(SERVER_WIFI_AP_PROPERTY, "warn_on_change:\"Changing WiFi settings will disconnect all devices connected over WiFi. Continue?\";");
 
 		SERVER_WIFI_INFRASTRUCTURE_PROPERTY = indigo_init_text_property(NULL, server_device.name, SERVER_WIFI_INFRASTRUCTURE_PROPERTY_NAME, MAIN_GROUP, "Configure infrastructure WiFi mode", INDIGO_OK_STATE, INDIGO_RW_PERM, 2);
 		indigo_init_text_item(SERVER_WIFI_INFRASTRUCTURE_SSID_ITEM, SERVER_WIFI_INFRASTRUCTURE_SSID_ITEM_NAME, "SSID", "");
 		indigo_init_text_item(SERVER_WIFI_INFRASTRUCTURE_PASSWORD_ITEM, SERVER_WIFI_INFRASTRUCTURE_PASSWORD_ITEM_NAME, "Password", "");
-		strcpy(SERVER_WIFI_INFRASTRUCTURE_PROPERTY->hints,"warn_on_change:\"Changing WiFi settings will disconnect all devices connected over WiFi. Continue?\";");
+		indigo_set_hints(SERVER_WIFI_INFRASTRUCTURE_PROPERTY, "warn_on_change:\"Changing WiFi settings will disconnect all devices connected over WiFi. Continue?\";");
 
 		SERVER_WIFI_CHANNEL_PROPERTY = indigo_init_number_property(NULL, server_device.name, SERVER_WIFI_CHANNEL_PROPERTY_NAME, MAIN_GROUP, "WiFi server channel", INDIGO_OK_STATE, INDIGO_RW_PERM, 1);
 		indigo_init_number_item(SERVER_WIFI_CHANNEL_ITEM, SERVER_WIFI_CHANNEL_ITEM_NAME, "Channel (0 = auto 2.4GHz, [0-14] = 2.4G, [>36] = 5G)", 0, 160, 1, 0);
-		strcpy(SERVER_WIFI_CHANNEL_PROPERTY->hints,"warn_on_change:\"Available WiFi channels depend on country regulations!\nChanging WiFi channel will disconnect all devices connected over WiFi. Continue?\";");
+		indigo_set_hints(SERVER_WIFI_CHANNEL_PROPERTY, "warn_on_change:\"Available WiFi channels depend on country regulations!\nChanging WiFi channel will disconnect all devices connected over WiFi. Continue?\";");
 
 		SERVER_WIFI_COUNTRY_CODE_PROPERTY = indigo_init_text_property(NULL, server_device.name, SERVER_WIFI_COUNTRY_CODE_PROPERTY_NAME, MAIN_GROUP, "Configure WiFi country code", INDIGO_OK_STATE, INDIGO_RW_PERM, 1);
 		indigo_init_text_item(SERVER_WIFI_COUNTRY_CODE_ITEM, SERVER_WIFI_COUNTRY_CODE_ITEM_NAME, "Two letter country code", "");
-		strcpy(SERVER_WIFI_COUNTRY_CODE_PROPERTY->hints, "warn_on_change:\"Country code affects the available WiFi channels.\nChanging the country code will reset WiFi settings to defaults. Continue?\";");
+		indigo_set_hints(SERVER_WIFI_COUNTRY_CODE_PROPERTY, "warn_on_change:\"Country code affects the available WiFi channels.\nChanging the country code will reset WiFi settings to defaults. Continue?\";");
 
 		update_wifi_setings(device);
 
@@ -1028,10 +1144,10 @@ static indigo_result attach(indigo_device *device) {
 		indigo_init_text_item(SERVER_HOST_TIME_ITEM, SERVER_HOST_TIME_ITEM_NAME, "Host time", "");
 		SERVER_SHUTDOWN_PROPERTY = indigo_init_switch_property(NULL, server_device.name, SERVER_SHUTDOWN_PROPERTY_NAME, MAIN_GROUP, "Shutdown host computer", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, 1);
 		indigo_init_switch_item(SERVER_SHUTDOWN_ITEM, SERVER_SHUTDOWN_ITEM_NAME, "Shutdown", false);
-		strcpy(SERVER_SHUTDOWN_ITEM->hints,"warn_on_set:\"Shutdown host computer?\";");
+		indigo_set_hints(SERVER_SHUTDOWN_ITEM, "warn_on_set:\"Shutdown host computer?\";");
 		SERVER_REBOOT_PROPERTY = indigo_init_switch_property(NULL, server_device.name, SERVER_REBOOT_PROPERTY_NAME, MAIN_GROUP, "Reboot host computer", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, 1);
 		indigo_init_switch_item(SERVER_REBOOT_ITEM, SERVER_REBOOT_ITEM_NAME, "Reboot", false);
-		strcpy(SERVER_REBOOT_ITEM->hints,"warn_on_set:\"Reboot host computer?\";");
+		indigo_set_hints(SERVER_REBOOT_ITEM, "warn_on_set:\"Reboot host computer?\";");
 		indigo_async((void *(*)(void *))check_versions, device);
 	}
 #endif /* RPI_MANAGEMENT */
@@ -1073,6 +1189,10 @@ static indigo_result enumerate_properties(indigo_device *device, indigo_client *
 	indigo_define_property(device, SERVER_LOG_LEVEL_PROPERTY, NULL);
 	indigo_define_property(device, SERVER_BLOB_BUFFERING_PROPERTY, NULL);
 	indigo_define_property(device, SERVER_BLOB_PROXY_PROPERTY, NULL);
+	indigo_define_property(device, SERVER_BLOB_QUEUE_POLICY_PROPERTY, NULL);
+	indigo_define_property(device, SERVER_QUEUE_STATISTICS_PROPERTY, NULL);
+	indigo_define_property(device, SERVER_BLOB_CACHE_STATISTICS_PROPERTY, NULL);
+	indigo_define_property(device, SERVER_TIMER_STATISTICS_PROPERTY, NULL);
 	indigo_define_property(device, SERVER_FEATURES_PROPERTY, NULL);
 #ifdef RPI_MANAGEMENT
 	if (use_rpi_management) {
@@ -1305,6 +1425,18 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 		SERVER_BLOB_PROXY_PROPERTY->state = INDIGO_OK_STATE;
 		indigo_update_property(device, SERVER_BLOB_PROXY_PROPERTY, NULL);
 		return INDIGO_OK;
+	} else if (indigo_property_match(SERVER_BLOB_QUEUE_POLICY_PROPERTY, property)) {
+		// -------------------------------------------------------------------------------- SERVER_BLOB_QUEUE_POLICY
+		indigo_property_copy_values(SERVER_BLOB_QUEUE_POLICY_PROPERTY, property, false);
+		if (SERVER_BLOB_QUEUE_BLOCK_ITEM->sw.value)
+			indigo_xml_blob_queue_policy = INDIGO_XML_BLOB_BLOCK;
+		else if (SERVER_BLOB_QUEUE_URL_ONLY_ITEM->sw.value)
+			indigo_xml_blob_queue_policy = INDIGO_XML_BLOB_URL_ONLY;
+		else
+			indigo_xml_blob_queue_policy = INDIGO_XML_BLOB_DROP_OLDEST;
+		SERVER_BLOB_QUEUE_POLICY_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, SERVER_BLOB_QUEUE_POLICY_PROPERTY, NULL);
+		return INDIGO_OK;
 #ifdef RPI_MANAGEMENT
 	} else if (indigo_property_match(SERVER_WIFI_COUNTRY_CODE_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- WIFI_COUNTRY_CODE
@@ -1382,6 +1514,7 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 
 static indigo_result detach(indigo_device *device) {
 	assert(device != NULL);
+	indigo_cancel_timer_sync(NULL, &queue_statistics_timer);
 	indigo_delete_property(device, SERVER_INFO_PROPERTY, NULL);
 	indigo_delete_property(device, SERVER_DRIVERS_PROPERTY, NULL);
 	if (SERVER_SERVERS_PROPERTY->count > 0)
@@ -1392,6 +1525,10 @@ static indigo_result detach(indigo_device *device) {
 	indigo_delete_property(device, SERVER_LOG_LEVEL_PROPERTY, NULL);
 	indigo_delete_property(device, SERVER_BLOB_BUFFERING_PROPERTY, NULL);
 	indigo_delete_property(device, SERVER_BLOB_PROXY_PROPERTY, NULL);
+	indigo_delete_property(device, SERVER_BLOB_QUEUE_POLICY_PROPERTY, NULL);
+	indigo_delete_property(device, SERVER_QUEUE_STATISTICS_PROPERTY, NULL);
+	indigo_delete_property(device, SERVER_BLOB_CACHE_STATISTICS_PROPERTY, NULL);
+	indigo_delete_property(device, SERVER_TIMER_STATISTICS_PROPERTY, NULL);
 	indigo_delete_property(device, SERVER_FEATURES_PROPERTY, NULL);
 #ifdef RPI_MANAGEMENT
 	if (use_rpi_management) {
@@ -1415,6 +1552,10 @@ static indigo_result detach(indigo_device *device) {
 	indigo_release_property(SERVER_LOG_LEVEL_PROPERTY);
 	indigo_release_property(SERVER_BLOB_BUFFERING_PROPERTY);
 	indigo_release_property(SERVER_BLOB_PROXY_PROPERTY);
+	indigo_release_property(SERVER_BLOB_QUEUE_POLICY_PROPERTY);
+	indigo_release_property(SERVER_QUEUE_STATISTICS_PROPERTY);
+	indigo_release_property(SERVER_BLOB_CACHE_STATISTICS_PROPERTY);
+	indigo_release_property(SERVER_TIMER_STATISTICS_PROPERTY);
 	indigo_release_property(SERVER_FEATURES_PROPERTY);
 #ifdef RPI_MANAGEMENT
 	indigo_release_property(SERVER_WIFI_COUNTRY_CODE_PROPERTY);
@@ -1552,6 +1693,8 @@ static void server_main() {
 			use_web_apps = false;
 		} else if (!strcmp(server_argv[i], "-u-") || !strcmp(server_argv[i], "--disable-blob-urls")) {
 			indigo_use_blob_urls = false;
+		} else if (!strcmp(server_argv[i], "-B-") || !strcmp(server_argv[i], "--disable-binary-protocol")) {
+			indigo_use_binary_protocol = false;
 		} else if (!strcmp(server_argv[i], "-d-") || !strcmp(server_argv[i], "--disable-blob-buffering")) {
 			indigo_use_blob_buffering = false;
 			indigo_use_blob_compression = false;
@@ -1559,6 +1702,36 @@ static void server_main() {
 			indigo_use_blob_compression = true;
 		} else if (!strcmp(server_argv[i], "-x") || !strcmp(server_argv[i], "--enable-blob-proxy")) {
 			indigo_proxy_blob = true;
+		} else if ((!strcmp(server_argv[i], "-q") || !strcmp(server_argv[i], "--blob-queue-policy")) && i < server_argc - 1) {
+			if (!strcmp(server_argv[i + 1], "block"))
+				indigo_xml_blob_queue_policy = INDIGO_XML_BLOB_BLOCK;
+			else if (!strcmp(server_argv[i + 1], "url"))
+				indigo_xml_blob_queue_policy = INDIGO_XML_BLOB_URL_ONLY;
+			else
+				indigo_xml_blob_queue_policy = INDIGO_XML_BLOB_DROP_OLDEST;
+			i++;
+		} else if ((!strcmp(server_argv[i], "-m") || !strcmp(server_argv[i], "--blob-cache-budget")) && i < server_argc - 1) {
+			indigo_blob_cache_budget = atol(server_argv[i + 1]) * 1048576L;
+			i++;
+		} else if (!strcmp(server_argv[i], "-D") || !strcmp(server_argv[i], "--enable-delta-updates")) {
+			indigo_use_delta_updates = true;
+		} else if ((!strcmp(server_argv[i], "-R") || !strcmp(server_argv[i], "--update-rate")) && i < server_argc - 1) {
+			char device[INDIGO_NAME_SIZE] = "", name[INDIGO_NAME_SIZE];
+			indigo_copy_name(name, server_argv[i + 1]);
+			char *rate = strchr(name, '=');
+			if (rate) {
+				*rate++ = 0;
+				char *dot = strrchr(name, '.');
+				if (dot) {
+					*dot = 0;
+					indigo_copy_name(device, name);
+					memmove(name, dot + 1, strlen(dot + 1) + 1);
+				}
+				indigo_set_update_rate(device, name, atof(rate));
+			} else {
+				indigo_error("Invalid update rate '%s'", server_argv[i + 1]);
+			}
+			i++;
 #ifdef RPI_MANAGEMENT
 		} else if (!strcmp(server_argv[i], "-f") || !strcmp(server_argv[i], "--enable-rpi-management")) {
 			FILE *output = popen("which s_rpi_ctrl.sh", "r");
@@ -1827,6 +2000,7 @@ int main(int argc, const char * argv[]) {
 			       "       -b- | --disable-bonjour\n"
 			       "       -u- | --disable-blob-urls\n"
 			       "       -d- | --disable-blob-buffering\n"
+			       "       -B- | --disable-binary-protocol       (use XML for remote servers)\n"
 			       "       -C  | --enable-blob-compression\n"
 			       "       -w- | --disable-web-apps\n"
 			       "       -c- | --disable-control-panel\n"
@@ -1839,6 +2013,10 @@ int main(int argc, const char * argv[]) {
 			       "       -vvv| --enable-trace\n"
 			       "       -r  | --remote-server host[:port]     (default port: 7624)\n"
 			       "       -x  | --enable-blob-proxy\n"
+			       "       -q  | --blob-queue-policy drop|block|url (default: drop)\n"
+			       "       -m  | --blob-cache-budget MB          (default: 1024, 0 = unlimited)\n"
+			       "       -D  | --enable-delta-updates          (send only changed items to XML clients)\n"
+			       "       -R  | --update-rate [device.]property=max_updates_per_second\n"
 			       "       -i  | --indi-driver driver_executable\n"
 			);
 			return 0;